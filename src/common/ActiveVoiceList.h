@@ -0,0 +1,97 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_ACTIVEVOICELIST_H
+#define SURGE_SRC_COMMON_ACTIVEVOICELIST_H
+
+#include <array>
+#include <cassert>
+#include "globals.h"
+
+class SurgeVoice;
+
+/*
+ * The playing voices of one scene, in the order they started. The voices themselves live
+ * in SurgeSynthesizer::voices_array; this is just a fixed capacity array of pointers into
+ * it, so starting and freeing a voice never allocates and walking the list is a walk over
+ * contiguous memory.
+ *
+ * erase keeps the remaining voices in order (oldest first), since voice stealing and the
+ * polyphony limit rely on that. With at most MAX_VOICES pointers, shifting the tail down is
+ * cheaper than the cache miss a list node used to cost.
+ *
+ * The interface is the subset of std::list the synth used, so iteration code is unchanged.
+ */
+struct ActiveVoiceList
+{
+    typedef SurgeVoice **iterator;
+    typedef SurgeVoice *const *const_iterator;
+
+    iterator begin() { return voices.data(); }
+    iterator end() { return voices.data() + count; }
+    const_iterator begin() const { return voices.data(); }
+    const_iterator end() const { return voices.data() + count; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    static constexpr size_t capacity() { return MAX_VOICES; }
+
+    SurgeVoice *front() const
+    {
+        assert(count > 0);
+        return voices[0];
+    }
+
+    SurgeVoice *back() const
+    {
+        assert(count > 0);
+        return voices[count - 1];
+    }
+
+    void push_back(SurgeVoice *v)
+    {
+        // There are only MAX_VOICES voices per scene to hand out, so this can never fill up
+        assert(count < MAX_VOICES);
+        if (count < MAX_VOICES)
+            voices[count++] = v;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        auto idx = pos - voices.data();
+        assert(idx >= 0 && idx < count);
+
+        for (auto i = idx; i < count - 1; ++i)
+            voices[i] = voices[i + 1];
+
+        count--;
+        return voices.data() + idx;
+    }
+
+    void clear() { count = 0; }
+
+  private:
+    std::array<SurgeVoice *, MAX_VOICES> voices{};
+    size_t count{0};
+};
+
+#endif // SURGE_SRC_COMMON_ACTIVEVOICELIST_H
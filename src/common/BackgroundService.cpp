@@ -0,0 +1,127 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "BackgroundService.h"
+#include <chrono>
+
+namespace Surge
+{
+namespace Threading
+{
+BackgroundService::BackgroundService()
+{
+    serviceThread = std::thread([this]() { serviceLoop(); });
+}
+
+BackgroundService::~BackgroundService()
+{
+    keepRunning = false;
+    sleepCV.notify_all();
+
+    if (serviceThread.joinable())
+        serviceThread.join();
+}
+
+void BackgroundService::add(Client &c)
+{
+    std::lock_guard<std::mutex> g(listMutex);
+
+    c.next = clients;
+    clients = &c;
+}
+
+void BackgroundService::remove(Client &c)
+{
+    std::unique_lock<std::mutex> lk(listMutex);
+
+    for (auto **p = &clients; *p; p = &((*p)->next))
+    {
+        if (*p == &c)
+        {
+            *p = c.next;
+            break;
+        }
+    }
+
+    c.next = nullptr;
+    runningCV.wait(lk, [this, &c]() { return running != &c; });
+}
+
+void BackgroundService::request(Client &c)
+{
+    c.requested.store(true, std::memory_order_release);
+    anyRequested.store(true, std::memory_order_release);
+    sleepCV.notify_one();
+}
+
+void BackgroundService::serviceLoop()
+{
+    while (keepRunning)
+    {
+        {
+            /*
+             * The audio thread can't take this lock, so a notify can race the wait. Time
+             * out periodically so a lost wakeup only costs us a few milliseconds.
+             */
+            std::unique_lock<std::mutex> lk(sleepMutex);
+            sleepCV.wait_for(lk, std::chrono::milliseconds(20), [this]() {
+                return anyRequested.load(std::memory_order_acquire) || !keepRunning;
+            });
+        }
+
+        if (!anyRequested.exchange(false, std::memory_order_acq_rel))
+            continue;
+
+        // clients can come and go while one runs, so find each one afresh under the lock
+        while (keepRunning)
+        {
+            Client *c{nullptr};
+
+            {
+                std::lock_guard<std::mutex> g(listMutex);
+
+                for (c = clients; c; c = c->next)
+                {
+                    if (c->requested.exchange(false, std::memory_order_acq_rel))
+                        break;
+                }
+
+                running = c;
+            }
+
+            if (!c)
+                break;
+
+            c->fn(c->ctx);
+
+            {
+                std::lock_guard<std::mutex> g(listMutex);
+                running = nullptr;
+            }
+
+            runningCV.notify_all();
+        }
+    }
+}
+
+} // namespace Threading
+} // namespace Surge
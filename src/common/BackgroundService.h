@@ -0,0 +1,90 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_BACKGROUNDSERVICE_H
+#define SURGE_SRC_COMMON_BACKGROUNDSERVICE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Surge
+{
+namespace Threading
+{
+/*
+ * One thread which does non realtime work on behalf of things the audio thread owns, shared by
+ * everything using a SurgeStorage so that none of them need a thread of their own.
+ *
+ * A client is registered with add and then asks for service with request, from any thread
+ * including the audio thread, where all that happens is an atomic store and a notify. The
+ * service thread calls the client's function once for however many requests arrived since its
+ * last call. Clients are an intrusive list, so nothing allocates when one is added.
+ *
+ * Clients are called one at a time and remove waits for a call which is in progress, so once
+ * remove returns the client and whatever its context points at can go away.
+ */
+struct BackgroundService
+{
+    struct Client
+    {
+        typedef void (*service_t)(void *ctx);
+
+        service_t fn{nullptr};
+        void *ctx{nullptr};
+
+      private:
+        friend struct BackgroundService;
+        std::atomic<bool> requested{false};
+        Client *next{nullptr};
+    };
+
+    BackgroundService();
+    ~BackgroundService();
+
+    // Any thread but the audio thread
+    void add(Client &c);
+    void remove(Client &c);
+
+    // Any thread
+    void request(Client &c);
+
+  private:
+    void serviceLoop();
+
+    // guards the list and running, and is never held while a client runs
+    std::mutex listMutex;
+    std::condition_variable runningCV;
+    Client *clients{nullptr};
+    Client *running{nullptr};
+
+    std::atomic<bool> anyRequested{false};
+    std::atomic<bool> keepRunning{true};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCV;
+    std::thread serviceThread;
+};
+} // namespace Threading
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_BACKGROUNDSERVICE_H
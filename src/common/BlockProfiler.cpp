@@ -0,0 +1,147 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "BlockProfiler.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_X64))
+#include <intrin.h>
+#define SURGE_PROFILER_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SURGE_PROFILER_HAS_TSC 1
+#endif
+
+namespace Surge
+{
+namespace Profiling
+{
+// how much each new block moves the smoothed load, and how fast the peak hold falls
+static constexpr float loadSmoothing = 0.02f;
+static constexpr float peakFalloff = 0.998f;
+
+uint64_t BlockProfiler::now()
+{
+#if SURGE_PROFILER_HAS_TSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+void BlockProfiler::setEnabled(bool e)
+{
+    if (e && !isEnabled())
+    {
+        for (int i = 0; i < n_profile_sections; ++i)
+        {
+            load[i].store(0.f, std::memory_order_relaxed);
+            peak[i].store(0.f, std::memory_order_relaxed);
+        }
+        totalLoad.store(0.f, std::memory_order_relaxed);
+        blocks.store(0, std::memory_order_relaxed);
+        lastTopSection.store(-1, std::memory_order_relaxed);
+        lastTopLoad.store(0.f, std::memory_order_relaxed);
+    }
+
+    enabled.store(e, std::memory_order_relaxed);
+}
+
+void BlockProfiler::beginBlock()
+{
+    for (auto &a : accumulated)
+        a.store(0, std::memory_order_relaxed);
+}
+
+void BlockProfiler::endBlock(uint64_t blockTicks, double wallSeconds, double deadlineSeconds)
+{
+#if SURGE_PROFILER_HAS_TSC
+    // The TSC rate isn't something we can ask for portably, so learn it against the wall clock
+    if (wallSeconds > 0.0 && blockTicks > 0)
+    {
+        auto tps = blockTicks / wallSeconds;
+        ticksPerSecond = (ticksPerSecond == 0.0) ? tps : 0.99 * ticksPerSecond + 0.01 * tps;
+    }
+#else
+    ticksPerSecond = 1e9;
+#endif
+
+    if (ticksPerSecond <= 0.0 || deadlineSeconds <= 0.0)
+        return;
+
+    auto toLoad = [&](uint64_t ticks) { return (float)(ticks / ticksPerSecond / deadlineSeconds); };
+
+    int top = -1;
+    float topLoad = 0.f;
+
+    for (int i = 0; i < n_profile_sections; ++i)
+    {
+        auto l = toLoad(accumulated[i].load(std::memory_order_relaxed));
+        auto sl = load[i].load(std::memory_order_relaxed);
+
+        if (l > topLoad)
+        {
+            top = i;
+            topLoad = l;
+        }
+
+        load[i].store(sl + loadSmoothing * (l - sl), std::memory_order_relaxed);
+        peak[i].store(std::max(l, peak[i].load(std::memory_order_relaxed) * peakFalloff),
+                      std::memory_order_relaxed);
+    }
+
+    lastTopSection.store(top, std::memory_order_relaxed);
+    lastTopLoad.store(topLoad, std::memory_order_relaxed);
+
+    auto t = toLoad(blockTicks);
+    auto st = totalLoad.load(std::memory_order_relaxed);
+    totalLoad.store(st + loadSmoothing * (t - st), std::memory_order_relaxed);
+    blocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string BlockProfiler::sectionName(int section)
+{
+    if (section >= ps_fx_first && section < ps_output)
+        return fxslot_shortoscname[section - ps_fx_first];
+
+    switch (section)
+    {
+    case ps_modulation:
+        return "modulation";
+    case ps_voices:
+        return "voices";
+    case ps_filters:
+        return "filters";
+    case ps_halfband:
+        return "halfband";
+    case ps_output:
+        return "output";
+    }
+
+    return "unknown";
+}
+
+} // namespace Profiling
+} // namespace Surge
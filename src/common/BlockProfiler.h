@@ -0,0 +1,126 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_BLOCKPROFILER_H
+#define SURGE_SRC_COMMON_BLOCKPROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "SurgeStorage.h"
+
+namespace Surge
+{
+namespace Profiling
+{
+enum ProfileSection
+{
+    ps_modulation = 0,
+    ps_voices,
+    ps_filters,
+    ps_halfband, // the scene halfband and lowcut
+    ps_fx_first,
+    ps_output = ps_fx_first + n_fx_slots,
+
+    n_profile_sections
+};
+
+/*
+ * A per-block breakdown of where SurgeSynthesizer::process spends its time.
+ *
+ * The audio thread brackets each part of the block with a Scope, which reads the TSC on x86
+ * (and a steady clock elsewhere), so a timer costs a couple of dozen cycles. Scopes may be
+ * used from the render pool threads too; the tick counts are accumulated atomically, which
+ * means a section which runs on several threads at once reports its total CPU time.
+ *
+ * At the end of the block the counts are converted to a fraction of the block's deadline and
+ * published as smoothed and peak-held loads in relaxed atomics, so the GUI, OSC and the
+ * python bindings can read them from any thread at any time without a lock.
+ *
+ * Profiling is off by default; when it is off a Scope doesn't even read the clock.
+ */
+struct BlockProfiler
+{
+    static uint64_t now();
+
+    struct Scope
+    {
+        Scope(BlockProfiler &p, int section)
+            : profiler(p), section(section), running(p.isEnabled())
+        {
+            if (running)
+                start = now();
+        }
+        ~Scope()
+        {
+            if (running)
+                profiler.add(section, now() - start);
+        }
+
+        BlockProfiler &profiler;
+        int section;
+        bool running;
+        uint64_t start{0};
+    };
+
+    void setEnabled(bool e);
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // audio thread. blockTicks and wallSeconds both cover the whole of process()
+    void beginBlock();
+    void endBlock(uint64_t blockTicks, double wallSeconds, double deadlineSeconds);
+
+    void add(int section, uint64_t ticks)
+    {
+        accumulated[section].fetch_add(ticks, std::memory_order_relaxed);
+    }
+
+    // any thread
+    float getLoad(int section) const { return load[section].load(std::memory_order_relaxed); }
+    float getPeak(int section) const { return peak[section].load(std::memory_order_relaxed); }
+    float getTotalLoad() const { return totalLoad.load(std::memory_order_relaxed); }
+    uint64_t getBlocksProfiled() const { return blocks.load(std::memory_order_relaxed); }
+
+    // the section which cost the most in the last block alone, unsmoothed, or -1 if none did
+    int getLastBlockTopSection() const { return lastTopSection.load(std::memory_order_relaxed); }
+    float getLastBlockTopLoad() const { return lastTopLoad.load(std::memory_order_relaxed); }
+
+    // a short, OSC-address friendly name like "voices" or "fx/send/1"
+    static std::string sectionName(int section);
+
+  private:
+    std::atomic<bool> enabled{false};
+    std::atomic<uint64_t> accumulated[n_profile_sections]{};
+
+    std::atomic<float> load[n_profile_sections]{}, peak[n_profile_sections]{};
+    std::atomic<float> totalLoad{0.f};
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<int> lastTopSection{-1};
+    std::atomic<float> lastTopLoad{0.f};
+
+    double ticksPerSecond{0.0};
+};
+} // namespace Profiling
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_BLOCKPROFILER_H
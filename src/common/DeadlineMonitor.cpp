@@ -0,0 +1,174 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "DeadlineMonitor.h"
+#include "BlockProfiler.h"
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace Surge
+{
+namespace Profiling
+{
+// how often the logger looks for new misses
+static constexpr int logIntervalMs = 250;
+
+std::string DeadlineMiss::describe() const
+{
+    using namespace std::chrono;
+
+    auto t = system_clock::to_time_t(when);
+    auto lt = *std::localtime(&t);
+    auto ms = duration_cast<milliseconds>(when.time_since_epoch()).count() % 1000;
+
+    std::ostringstream oss;
+    oss << std::put_time(&lt, "%F %T") << "." << std::setw(3) << std::setfill('0') << ms
+        << std::setfill(' ') << " miss " << sequence << " block " << block << ": "
+        << std::fixed << std::setprecision(2) << load << " of deadline, " << voices
+        << " voices";
+
+    if (topSection >= 0)
+        oss << ", mostly " << BlockProfiler::sectionName(topSection) << " (" << topLoad << ")";
+
+    for (int i = 0; i < n_fx_slots; ++i)
+    {
+        if (fxTypes[i] > fxt_off && fxTypes[i] < n_fx_types)
+            oss << ", " << fxslot_shortnames[i] << " " << fx_type_shortnames[fxTypes[i]];
+    }
+
+    if (events & SurgeStorage::be_patchLoad)
+        oss << ", patch load";
+    if (events & SurgeStorage::be_wavetableLoad)
+        oss << ", wavetable load";
+    if (events & SurgeStorage::be_formulaError)
+        oss << ", formula error";
+
+    return oss.str();
+}
+
+DeadlineMonitor::~DeadlineMonitor() { setLogFile(""); }
+
+void DeadlineMonitor::report(DeadlineMiss &miss)
+{
+    miss.sequence = missCount.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    std::unique_lock<std::mutex> g(historyMutex, std::try_to_lock);
+
+    if (!g.owns_lock())
+        return;
+
+    history[historyCount % historySize] = miss;
+    historyCount++;
+}
+
+std::vector<DeadlineMiss> DeadlineMonitor::getHistory() const
+{
+    std::lock_guard<std::mutex> g(historyMutex);
+
+    std::vector<DeadlineMiss> res;
+    auto first = historyCount > historySize ? historyCount - historySize : 0;
+
+    for (auto i = first; i < historyCount; ++i)
+        res.push_back(history[i % historySize]);
+
+    return res;
+}
+
+void DeadlineMonitor::clear()
+{
+    // the logger takes the history lock while it holds its own, so never the other way round
+    {
+        std::lock_guard<std::mutex> g(historyMutex);
+        historyCount = 0;
+        missCount.store(0, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> g(logMutex);
+    lastLogged = 0;
+}
+
+bool DeadlineMonitor::setLogFile(const std::string &path)
+{
+    if (logThread)
+    {
+        {
+            std::lock_guard<std::mutex> g(logMutex);
+            logStop = true;
+        }
+        logCV.notify_all();
+        logThread->join();
+        logThread.reset();
+    }
+
+    std::lock_guard<std::mutex> g(logMutex);
+    logPath = path;
+    logStop = false;
+
+    if (path.empty())
+        return true;
+
+    // check we can write there now, rather than fail quietly later
+    if (!std::ofstream(path, std::ios::app))
+    {
+        logPath.clear();
+        return false;
+    }
+
+    lastLogged = getMissCount();
+    logThread = std::make_unique<std::thread>([this]() { logLoop(); });
+    return true;
+}
+
+std::string DeadlineMonitor::getLogFile() const
+{
+    std::lock_guard<std::mutex> g(logMutex);
+    return logPath;
+}
+
+void DeadlineMonitor::logLoop()
+{
+    std::unique_lock<std::mutex> g(logMutex);
+
+    while (!logStop)
+    {
+        logCV.wait_for(g, std::chrono::milliseconds(logIntervalMs));
+
+        auto misses = getHistory();
+        std::ofstream ofs;
+
+        for (const auto &m : misses)
+        {
+            if (m.sequence <= lastLogged)
+                continue;
+
+            if (!ofs.is_open())
+                ofs.open(logPath, std::ios::app);
+
+            ofs << m.describe() << "\n";
+            lastLogged = m.sequence;
+        }
+    }
+}
+} // namespace Profiling
+} // namespace Surge
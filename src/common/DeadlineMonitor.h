@@ -0,0 +1,115 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_DEADLINEMONITOR_H
+#define SURGE_SRC_COMMON_DEADLINEMONITOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SurgeStorage.h"
+
+namespace Surge
+{
+namespace Profiling
+{
+/*
+ * One block which ran past its threshold, and what the engine was doing at the time.
+ */
+struct DeadlineMiss
+{
+    uint64_t sequence{0}; // the nth miss since the monitor was last cleared, from 1
+    uint64_t block{0};    // which block, counting from when the engine started
+    std::chrono::system_clock::time_point when;
+
+    float load{0.f}; // process() time over the block's deadline
+    int voices{0};
+    int fxTypes[n_fx_slots]{};
+    uint32_t events{0}; // SurgeStorage::BlockEvent flags noted since the previous block
+
+    // from the block profiler, if it was running; -1 otherwise
+    int topSection{-1};
+    float topLoad{0.f};
+
+    // one line, for the log and the GUI
+    std::string describe() const;
+};
+
+/*
+ * Keeps the last few blocks which took longer than a given fraction of their deadline, so a
+ * glitch in a live set can be explained after the fact.
+ *
+ * The audio thread reports a miss with try_lock, so it never waits on a reader; if a reader
+ * happens to hold the history at that moment the miss is still counted but not kept. Optionally
+ * a logger thread appends each miss to a file as it comes in.
+ */
+struct DeadlineMonitor
+{
+    static constexpr size_t historySize = 64;
+    static constexpr float defaultThreshold = 0.9f;
+
+    ~DeadlineMonitor();
+
+    void setThreshold(float t) { threshold.store(t, std::memory_order_relaxed); }
+    float getThreshold() const { return threshold.load(std::memory_order_relaxed); }
+
+    // audio thread
+    bool isLate(float load) const { return load >= threshold.load(std::memory_order_relaxed); }
+    void report(DeadlineMiss &miss);
+
+    // any thread
+    uint64_t getMissCount() const { return missCount.load(std::memory_order_relaxed); }
+    std::vector<DeadlineMiss> getHistory() const; // oldest first
+    void clear();
+
+    // an empty path stops logging. returns false if the file can't be opened
+    bool setLogFile(const std::string &path);
+    std::string getLogFile() const;
+
+  private:
+    void logLoop();
+
+    std::atomic<float> threshold{defaultThreshold};
+    std::atomic<uint64_t> missCount{0};
+
+    mutable std::mutex historyMutex;
+    DeadlineMiss history[historySize];
+    size_t historyCount{0};
+
+    mutable std::mutex logMutex;
+    std::condition_variable logCV;
+    std::unique_ptr<std::thread> logThread;
+    std::string logPath;
+    bool logStop{false};
+    uint64_t lastLogged{0};
+};
+} // namespace Profiling
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_DEADLINEMONITOR_H
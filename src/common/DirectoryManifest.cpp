@@ -0,0 +1,191 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "DirectoryManifest.h"
+#include <chrono>
+#include <fstream>
+
+namespace Surge
+{
+namespace Storage
+{
+static int64_t modTimeOf(const fs::path &p)
+{
+    auto t = fs::last_write_time(p);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+const DirectoryManifest::Entry &
+DirectoryManifest::list(const fs::path &dir, const std::function<bool(std::string)> &filter)
+{
+    auto key = path_to_string(dir);
+    auto mt = modTimeOf(dir);
+    auto &e = entries[key];
+
+    if (e.modTime == mt && mt != 0)
+    {
+        e.visited = true;
+        directoriesReused++;
+        return e;
+    }
+
+    e.modTime = mt;
+    e.subdirs.clear();
+    e.files.clear();
+
+    for (auto &d : fs::directory_iterator(dir))
+    {
+        auto name = path_to_string(d.path().filename());
+
+        if (fs::is_directory(d))
+        {
+            e.subdirs.push_back(name);
+        }
+        else if (filter(path_to_string(d.path().extension())))
+        {
+            e.files.push_back(name);
+        }
+    }
+
+    e.visited = true;
+    dirty = true;
+    directoriesRead++;
+
+    return e;
+}
+
+void DirectoryManifest::markVisitedUnder(const fs::path &dir)
+{
+    auto root = path_to_string(dir);
+
+    for (auto &[key, e] : entries)
+    {
+        if (key.compare(0, root.size(), root) != 0)
+            continue;
+
+        if (key.size() == root.size() || key[root.size()] == '/' || key[root.size()] == '\\')
+            e.visited = true;
+    }
+}
+
+void DirectoryManifest::pruneUnvisited()
+{
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (!it->second.visited)
+        {
+            it = entries.erase(it);
+            dirty = true;
+        }
+        else
+        {
+            it->second.visited = false;
+            ++it;
+        }
+    }
+}
+
+/*
+ * The format is one line per record:
+ *
+ *   D <modtime> <path>   starts a directory
+ *   S <name>             a subdirectory of it
+ *   F <name>             a file in it
+ *
+ * Names run to the end of the line, so spaces are fine.
+ */
+bool DirectoryManifest::load(const fs::path &from)
+{
+    std::ifstream in(from, std::ios::binary);
+
+    if (!in)
+        return false;
+
+    entries.clear();
+
+    Entry *current = nullptr;
+    std::string line;
+
+    while (std::getline(in, line))
+    {
+        if (line.size() < 3 || line[1] != ' ')
+            continue;
+
+        auto rest = line.substr(2);
+
+        switch (line[0])
+        {
+        case 'D':
+        {
+            auto sp = rest.find(' ');
+
+            if (sp == std::string::npos)
+            {
+                current = nullptr;
+                break;
+            }
+
+            current = &entries[rest.substr(sp + 1)];
+            current->modTime = std::strtoll(rest.substr(0, sp).c_str(), nullptr, 10);
+            break;
+        }
+        case 'S':
+            if (current)
+                current->subdirs.push_back(rest);
+            break;
+        case 'F':
+            if (current)
+                current->files.push_back(rest);
+            break;
+        default:
+            break;
+        }
+    }
+
+    dirty = false;
+    return true;
+}
+
+bool DirectoryManifest::save(const fs::path &to)
+{
+    std::ofstream out(to, std::ios::binary | std::ios::trunc);
+
+    if (!out)
+        return false;
+
+    for (const auto &[path, e] : entries)
+    {
+        out << "D " << e.modTime << " " << path << "\n";
+
+        for (const auto &s : e.subdirs)
+            out << "S " << s << "\n";
+
+        for (const auto &f : e.files)
+            out << "F " << f << "\n";
+    }
+
+    dirty = false;
+    return (bool)out;
+}
+
+} // namespace Storage
+} // namespace Surge
@@ -0,0 +1,83 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_DIRECTORYMANIFEST_H
+#define SURGE_SRC_COMMON_DIRECTORYMANIFEST_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "filesystem/import.h"
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * A record of what was in each directory of a library (its subdirectories and the files
+ * which passed the filter) along with the directory's modification time. Adding, removing or
+ * renaming anything in a directory bumps its time, so a directory whose time hasn't moved
+ * can be listed from the manifest without reading it from the disk. Persisted with save and
+ * load, this lets a startup scan of a large library only walk the subtrees which changed.
+ *
+ * A manifest is built with one filter in mind (.fxp for patches, say). Don't share one
+ * between scans which look for different kinds of file.
+ */
+struct DirectoryManifest
+{
+    struct Entry
+    {
+        int64_t modTime{0};
+        std::vector<std::string> subdirs, files; // names relative to the directory
+        bool visited{false};
+    };
+
+    /*
+     * List a directory, from the manifest if it's unchanged since we last looked and from
+     * the disk otherwise. Throws fs::filesystem_error like directory_iterator would.
+     */
+    const Entry &list(const fs::path &dir, const std::function<bool(std::string)> &filter);
+
+    // forget directories which weren't listed since the last prune, so deleted trees don't linger
+    void pruneUnvisited();
+    // count a directory and everything below it as listed, for a tree we know is unchanged
+    void markVisitedUnder(const fs::path &dir);
+
+    bool load(const fs::path &from);
+    bool save(const fs::path &to);
+    bool isDirty() const { return dirty; }
+
+    int getDirectoriesRead() const { return directoriesRead; }
+    int getDirectoriesReused() const { return directoriesReused; }
+
+  private:
+    std::unordered_map<std::string, Entry> entries;
+    bool dirty{false};
+    int directoriesRead{0}, directoriesReused{0};
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_DIRECTORYMANIFEST_H
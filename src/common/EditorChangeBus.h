@@ -0,0 +1,90 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_EDITORCHANGEBUS_H
+#define SURGE_SRC_COMMON_EDITORCHANGEBUS_H
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * How the engine tells an open editor what changed since it last looked, so the editor's idle
+ * can visit only that and slow down when nothing does. Whoever changes something the editor
+ * shows (the audio thread, a host automation thread, the MIDI path) marks its group, and a
+ * parameter change also marks the range of parameter indices it landed in. The editor takes
+ * and clears everything at once. Marking is a relaxed fetch_or, so it is fine anywhere.
+ *
+ * The existing synth -> editor variables (the refresh queues, midiNoteEvents, vu_peak and so on)
+ * still carry what changed; the bus only says which of them are worth looking at.
+ */
+struct EditorChangeBus
+{
+    enum Group : uint64_t
+    {
+        ch_parameters = 1 << 0,  // the parameter and controller refresh queues
+        ch_controllers = 1 << 1, // macro values moved by MIDI
+        ch_midiKeys = 1 << 2,
+        ch_midiCC = 1 << 3, // pitch bend, mod wheel and sustain for the virtual keyboard
+        ch_meters = 1 << 4, // there is signal for the VU meters to show
+        ch_voices = 1 << 5, // the playing voice count
+    };
+
+    // groups take the low byte and parameter ranges the rest, so one exchange takes both
+    static constexpr int group_bits = 8;
+    static constexpr int n_ranges = 64 - group_bits;
+
+    struct Changes
+    {
+        uint64_t bits{0};
+
+        bool any() const { return bits != 0; }
+        bool has(uint64_t g) const { return (bits & g) != 0; }
+        bool hasParameterInRange(int index, int nParams) const
+        {
+            return (bits & rangeBit(index, nParams)) != 0;
+        }
+    };
+
+    static uint64_t rangeBit(int index, int nParams)
+    {
+        int r = 0;
+        if (index > 0 && nParams > 0)
+            r = (int)((int64_t)index * n_ranges / nParams);
+        if (r >= n_ranges)
+            r = n_ranges - 1;
+        return (uint64_t)1 << (group_bits + r);
+    }
+
+    void mark(uint64_t g) { bits.fetch_or(g, std::memory_order_release); }
+    void markParameter(int index, int nParams)
+    {
+        bits.fetch_or(ch_parameters | rangeBit(index, nParams), std::memory_order_release);
+    }
+
+    Changes take() { return {bits.exchange(0, std::memory_order_acquire)}; }
+    bool pending() const { return bits.load(std::memory_order_relaxed) != 0; }
+
+  private:
+    std::atomic<uint64_t> bits{0};
+};
+
+#endif // SURGE_SRC_COMMON_EDITORCHANGEBUS_H
@@ -0,0 +1,382 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "EngineServer.h"
+#include "SurgeSynthesizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Surge
+{
+namespace EngineServer
+{
+#if WINDOWS
+static std::string mappingName(const std::string &name) { return "Local\\" + name; }
+#else
+static std::string mappingName(const std::string &name) { return "/" + name; }
+#endif
+
+std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::map(std::unique_ptr<SharedMemoryRegion> r,
+                                                            bool create)
+{
+#if WINDOWS
+    HANDLE h;
+
+    if (create)
+        h = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                               (DWORD)((uint64_t)r->size() >> 32), (DWORD)r->size(),
+                               mappingName(r->name).c_str());
+    else
+        h = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mappingName(r->name).c_str());
+
+    if (!h)
+        return nullptr;
+
+    if (create && GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        CloseHandle(h);
+        return nullptr;
+    }
+
+    r->handle = h;
+    r->mem = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, r->size());
+#else
+    auto fd = shm_open(mappingName(r->name).c_str(), create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR,
+                       0600);
+
+    if (fd < 0)
+        return nullptr;
+
+    // the region owns the name from here, so a failure below still unlinks it
+    r->owner = create;
+
+    if (create && ftruncate(fd, (off_t)r->size()) != 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    auto m = mmap(nullptr, r->size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    r->mem = (m == MAP_FAILED) ? nullptr : m;
+#endif
+
+    if (!r->mem)
+        return nullptr;
+
+    return r;
+}
+
+std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::create(const std::string &name,
+                                                               size_t size)
+{
+    auto r = std::unique_ptr<SharedMemoryRegion>(new SharedMemoryRegion());
+    r->name = name;
+    r->sz = size;
+    return map(std::move(r), true);
+}
+
+std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::open(const std::string &name, size_t size)
+{
+    auto r = std::unique_ptr<SharedMemoryRegion>(new SharedMemoryRegion());
+    r->name = name;
+    r->sz = size;
+    return map(std::move(r), false);
+}
+
+std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::local(size_t size)
+{
+    auto r = std::unique_ptr<SharedMemoryRegion>(new SharedMemoryRegion());
+    r->sz = size;
+    r->isLocal = true;
+    r->mem = ::operator new(size, std::align_val_t{64});
+    return r;
+}
+
+SharedMemoryRegion::~SharedMemoryRegion()
+{
+    if (isLocal)
+    {
+        ::operator delete(mem, std::align_val_t{64});
+        return;
+    }
+
+#if WINDOWS
+    if (mem)
+        UnmapViewOfFile(mem);
+    if (handle)
+        CloseHandle((HANDLE)handle);
+#else
+    if (mem)
+        munmap(mem, sz);
+    if (owner)
+        shm_unlink(mappingName(name).c_str());
+#endif
+}
+
+LinkClient::LinkClient(SharedMemoryRegion &region)
+{
+    auto *l = static_cast<LinkLayout *>(region.data());
+
+    if (region.size() >= sizeof(LinkLayout) && l->magic == LinkLayout::magicValue &&
+        l->version == LinkLayout::layoutVersion && l->blockSize == BLOCK_SIZE)
+    {
+        layout = l;
+    }
+
+    pending.tempo = 120.0;
+    pending.timeSigNumerator = 4;
+    pending.timeSigDenominator = 4;
+}
+
+bool LinkClient::pushEvent(const LinkEvent &e)
+{
+    if (pending.nEvents >= LinkLayout::maxEventsPerBlock)
+        return false;
+
+    pending.events[pending.nEvents++] = e;
+    return true;
+}
+
+void LinkClient::setTransport(double tempo, double ppqPos, int tsNum, int tsDen)
+{
+    pending.tempo = tempo;
+    pending.ppqPos = ppqPos;
+    pending.timeSigNumerator = tsNum;
+    pending.timeSigDenominator = tsDen;
+}
+
+bool LinkClient::exchangeBlock(const float *inL, const float *inR, float *outL, float *outR)
+{
+    if (!layout)
+    {
+        std::fill(outL, outL + BLOCK_SIZE, 0.f);
+        std::fill(outR, outR + BLOCK_SIZE, 0.f);
+        return false;
+    }
+
+    bool sent = false;
+    auto w = layout->requestsWritten.load(std::memory_order_relaxed);
+
+    if (w - layout->requestsTaken.load(std::memory_order_acquire) < LinkLayout::slots)
+    {
+        auto &r = layout->requests[w % LinkLayout::slots];
+
+        r.tempo = pending.tempo;
+        r.ppqPos = pending.ppqPos;
+        r.timeSigNumerator = pending.timeSigNumerator;
+        r.timeSigDenominator = pending.timeSigDenominator;
+        r.nEvents = pending.nEvents;
+        std::copy(pending.events, pending.events + pending.nEvents, r.events);
+
+        const float *in[N_INPUTS] = {inL, inR};
+
+        for (int c = 0; c < N_INPUTS; ++c)
+        {
+            if (in[c])
+                memcpy(r.input[c], in[c], BLOCK_SIZE * sizeof(float));
+            else
+                memset(r.input[c], 0, BLOCK_SIZE * sizeof(float));
+        }
+
+        layout->requestsWritten.store(w + 1, std::memory_order_release);
+        pending.nEvents = 0;
+        sent = true;
+    }
+
+    auto t = layout->repliesTaken.load(std::memory_order_relaxed);
+
+    if (layout->repliesWritten.load(std::memory_order_acquire) != t)
+    {
+        auto &r = layout->replies[t % LinkLayout::slots];
+
+        memcpy(outL, r.output[0], BLOCK_SIZE * sizeof(float));
+        memcpy(outR, r.output[1], BLOCK_SIZE * sizeof(float));
+        layout->repliesTaken.store(t + 1, std::memory_order_release);
+    }
+    else
+    {
+        std::fill(outL, outL + BLOCK_SIZE, 0.f);
+        std::fill(outR, outR + BLOCK_SIZE, 0.f);
+        nUnderruns++;
+    }
+
+    return sent;
+}
+
+EngineServer::EngineServer(int renderThreads) : pool(std::max(renderThreads - 1, 0)) {}
+
+EngineServer::~EngineServer() = default;
+
+int EngineServer::addEngine(std::shared_ptr<SurgeSynthesizer> synth,
+                            std::unique_ptr<SharedMemoryRegion> region)
+{
+    if (!synth || !region || region->size() < sizeof(LinkLayout))
+        return -1;
+
+    auto *l = new (region->data()) LinkLayout();
+    l->magic = LinkLayout::magicValue;
+    l->version = LinkLayout::layoutVersion;
+    l->blockSize = BLOCK_SIZE;
+    l->samplerate = (uint32_t)synth->storage.samplerate;
+    l->requestsWritten = 0;
+    l->requestsTaken = 0;
+    l->repliesWritten = 0;
+    l->repliesTaken = 0;
+
+    auto e = std::make_unique<Engine>();
+    e->id = nextId++;
+    e->synth = std::move(synth);
+    e->region = std::move(region);
+    e->layout = l;
+    engines.push_back(std::move(e));
+    due.reserve(engines.size());
+
+    return engines.back()->id;
+}
+
+void EngineServer::removeEngine(int id)
+{
+    engines.erase(std::remove_if(engines.begin(), engines.end(),
+                                 [id](const auto &e) { return e->id == id; }),
+                  engines.end());
+}
+
+int EngineServer::renderPending()
+{
+    due.clear();
+
+    for (auto &e : engines)
+    {
+        auto *l = e->layout;
+        bool requested = l->requestsWritten.load(std::memory_order_acquire) !=
+                         l->requestsTaken.load(std::memory_order_relaxed);
+        bool room = l->repliesWritten.load(std::memory_order_relaxed) -
+                        l->repliesTaken.load(std::memory_order_acquire) <
+                    LinkLayout::slots;
+
+        if (requested && room)
+            due.push_back(e.get());
+    }
+
+    if (!due.empty())
+        pool.runAll((int)due.size(), &EngineServer::renderOne, this);
+
+    return (int)due.size();
+}
+
+void EngineServer::renderOne(void *ctx, int index)
+{
+    auto *e = static_cast<EngineServer *>(ctx)->due[index];
+    auto *l = e->layout;
+    auto *synth = e->synth.get();
+
+    auto taken = l->requestsTaken.load(std::memory_order_relaxed);
+    const auto &req = l->requests[taken % LinkLayout::slots];
+
+    synth->time_data.tempo = req.tempo;
+    synth->time_data.ppqPos = req.ppqPos;
+    synth->time_data.timeSigNumerator = req.timeSigNumerator;
+    synth->time_data.timeSigDenominator = req.timeSigDenominator;
+    synth->resetStateFromTimeData();
+
+    auto nEvents = std::min(req.nEvents, LinkLayout::maxEventsPerBlock);
+
+    for (uint32_t i = 0; i < nEvents; ++i)
+    {
+        synth->eventOffsetInBlock = std::clamp(req.events[i].offset, 0, BLOCK_SIZE - 1);
+        applyEvent(synth, req.events[i]);
+    }
+    synth->eventOffsetInBlock = 0;
+
+    memcpy(synth->input, req.input, sizeof(synth->input));
+    synth->process_input = true;
+    synth->process();
+
+    auto written = l->repliesWritten.load(std::memory_order_relaxed);
+    memcpy(l->replies[written % LinkLayout::slots].output, synth->output, sizeof(synth->output));
+
+    l->repliesWritten.store(written + 1, std::memory_order_release);
+    l->requestsTaken.store(taken + 1, std::memory_order_release);
+}
+
+void EngineServer::applyEvent(SurgeSynthesizer *synth, const LinkEvent &e)
+{
+    if (e.type == LinkEvent::PARAM01)
+    {
+        SurgeSynthesizer::ID id;
+
+        if (synth->fromSynthSideId(e.param, id))
+            synth->setParameter01(id, e.value, true);
+
+        return;
+    }
+
+    int status = e.midi[0] & 0xF0;
+    int ch = e.midi[0] & 0x0F;
+    int d1 = e.midi[1] & 0x7F, d2 = e.midi[2] & 0x7F;
+
+    if (!synth->receivesMidiChannel(ch) && status != 0x80)
+        return;
+
+    switch (status)
+    {
+    case 0x90:
+        if (d2 != 0)
+            synth->playNote(ch, d1, d2, 0, -1);
+        else
+            synth->releaseNote(ch, d1, d2, -1);
+        break;
+    case 0x80:
+        synth->releaseNote(ch, d1, d2);
+        break;
+    case 0xA0:
+        synth->polyAftertouch(ch, d1, d2);
+        break;
+    case 0xB0:
+        synth->channelController(ch, d1, d2);
+        break;
+    case 0xC0:
+        synth->programChange(ch, d1);
+        break;
+    case 0xD0:
+        synth->channelAftertouch(ch, d1);
+        break;
+    case 0xE0:
+        synth->pitchBend(ch, (d1 | (d2 << 7)) - 8192);
+        break;
+    default:
+        break;
+    }
+}
+} // namespace EngineServer
+} // namespace Surge
@@ -0,0 +1,198 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_ENGINESERVER_H
+#define SURGE_SRC_COMMON_ENGINESERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "globals.h"
+#include "RenderWorkerPool.h"
+
+class SurgeSynthesizer;
+
+namespace Surge
+{
+namespace EngineServer
+{
+/*
+ * A named block of memory which another process can map too. The creating side owns the name
+ * and removes it when it goes away; the opening side just unmaps. local() is plain process
+ * memory with the same interface, for when both ends live in one process.
+ */
+struct SharedMemoryRegion
+{
+    static std::unique_ptr<SharedMemoryRegion> create(const std::string &name, size_t size);
+    static std::unique_ptr<SharedMemoryRegion> open(const std::string &name, size_t size);
+    static std::unique_ptr<SharedMemoryRegion> local(size_t size);
+
+    ~SharedMemoryRegion();
+
+    void *data() const { return mem; }
+    size_t size() const { return sz; }
+
+  private:
+    SharedMemoryRegion() = default;
+    static std::unique_ptr<SharedMemoryRegion> map(std::unique_ptr<SharedMemoryRegion> r,
+                                                   bool create);
+
+    void *mem{nullptr};
+    size_t sz{0};
+    std::string name;
+    bool owner{false}, isLocal{false};
+    void *handle{nullptr}; // the mapping, on Windows
+};
+
+/*
+ * One event for the engine, applied at the start of the block it was sent with. MIDI is the
+ * raw bytes of a channel message; PARAM01 sets a parameter by synth side id.
+ */
+struct LinkEvent
+{
+    enum Type : uint32_t
+    {
+        MIDI = 0,
+        PARAM01,
+    };
+    uint32_t type{MIDI};
+    int32_t offset{0}; // sample within the block
+    uint8_t midi[4]{};
+    int32_t param{0};
+    float value{0.f};
+};
+
+/*
+ * The layout of a link in the shared region. There are two single producer single consumer
+ * rings of blocks: requests (events, input and transport) from the plugin shell to the server
+ * and replies (output) back. Each side only ever advances its own counter, so nothing waits
+ * and nothing locks, and a slot is only reused once the other side has moved past it.
+ *
+ * The shell sends block n and collects whatever reply is ready, which is block n - 1 when
+ * the server keeps up; so a link adds one block of latency.
+ */
+struct LinkLayout
+{
+    static constexpr uint32_t magicValue = 0x53584c4b;
+    static constexpr uint32_t layoutVersion = 1;
+    static constexpr uint32_t slots = 4;
+    static constexpr uint32_t maxEventsPerBlock = 256;
+
+    // the counters have to work from two address spaces
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+    struct Request
+    {
+        double tempo, ppqPos;
+        int32_t timeSigNumerator, timeSigDenominator;
+        uint32_t nEvents;
+        LinkEvent events[maxEventsPerBlock];
+        float input alignas(16)[N_INPUTS][BLOCK_SIZE];
+    };
+
+    struct Reply
+    {
+        float output alignas(16)[N_OUTPUTS][BLOCK_SIZE];
+    };
+
+    uint32_t magic, version, blockSize, samplerate;
+    std::atomic<uint32_t> requestsWritten, requestsTaken, repliesWritten, repliesTaken;
+    Request requests[slots];
+    Reply replies[slots];
+};
+
+/*
+ * The shell's end of a link. Events collect for the next block; exchangeBlock then sends that
+ * block and fills the output with the next reply, or silence if the server is behind.
+ * Everything here is meant for the shell's audio thread and neither allocates nor blocks.
+ */
+struct LinkClient
+{
+    // region has to hold a LinkLayout which a server has initialized; see EngineServer
+    explicit LinkClient(SharedMemoryRegion &region);
+
+    bool valid() const { return layout != nullptr; }
+
+    bool pushEvent(const LinkEvent &e);
+    void setTransport(double tempo, double ppqPos, int tsNum = 4, int tsDen = 4);
+
+    /*
+     * Returns false if the request ring is full, in which case this block's events stay
+     * queued for the next try and the output is silence. Input may be null.
+     */
+    bool exchangeBlock(const float *inL, const float *inR, float *outL, float *outR);
+
+    uint64_t underruns() const { return nUnderruns; }
+
+  private:
+    LinkLayout *layout{nullptr};
+    LinkLayout::Request pending{};
+    uint64_t nUnderruns{0};
+};
+
+/*
+ * Hosts many engines in one process, each behind a link. Since they are all in the same
+ * process they share everything SharedStorageCore shares (tables, directory scans and built
+ * wavetables) rather than each sandboxed plugin building its own, and one pool renders every
+ * engine with a request waiting, instead of each plugin instance competing for cores.
+ *
+ * addEngine, removeEngine and renderPending must be called from one thread.
+ */
+struct EngineServer
+{
+    explicit EngineServer(int renderThreads);
+    ~EngineServer();
+
+    // Initializes a link in the region and returns its id, or -1 if the region is too small
+    int addEngine(std::shared_ptr<SurgeSynthesizer> synth,
+                  std::unique_ptr<SharedMemoryRegion> region);
+    void removeEngine(int id);
+
+    static size_t regionSize() { return sizeof(LinkLayout); }
+
+    // Renders one block for every engine with a request waiting. Returns how many it rendered.
+    int renderPending();
+
+  private:
+    struct Engine
+    {
+        int id;
+        std::shared_ptr<SurgeSynthesizer> synth;
+        std::unique_ptr<SharedMemoryRegion> region;
+        LinkLayout *layout;
+    };
+
+    static void renderOne(void *ctx, int index);
+    static void applyEvent(SurgeSynthesizer *synth, const LinkEvent &e);
+
+    std::vector<std::unique_ptr<Engine>> engines;
+    std::vector<Engine *> due;
+    Surge::Threading::RenderWorkerPool pool;
+    int nextId{0};
+};
+} // namespace EngineServer
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_ENGINESERVER_H
@@ -35,6 +35,62 @@ std::unordered_map<int, std::vector<FxUserPreset::Preset>> FxUserPreset::getPres
     return scannedPresets;
 }
 
+bool FxUserPreset::readPresetFile(SurgeStorage *storage, const fs::path &file, bool isFactory,
+                                  const fs::path &factoryDir, Preset &preset)
+{
+    preset.file = path_to_string(file);
+
+    TiXmlDocument d;
+    int t;
+
+    if (!d.LoadFile(file))
+        return false;
+
+    auto r = TINYXML_SAFE_TO_ELEMENT(d.FirstChild("single-fx"));
+
+    if (!r)
+        return false;
+
+    preset.streamingVersion = ff_revision;
+    int sv;
+    if (r->QueryIntAttribute("streaming_version", &sv) == TIXML_SUCCESS)
+    {
+        preset.streamingVersion = sv;
+    }
+
+    auto s = TINYXML_SAFE_TO_ELEMENT(r->FirstChild("snapshot"));
+
+    if (!s)
+        return false;
+
+    if (s->QueryIntAttribute("type", &t) != TIXML_SUCCESS)
+        return false;
+
+    preset.type = t;
+    preset.isFactory = isFactory;
+
+    fs::path rpath;
+
+    if (isFactory)
+        rpath = file.lexically_relative(factoryDir).parent_path();
+    else
+        rpath = file.lexically_relative(storage->userFXPath).parent_path();
+
+    auto startCatPath = rpath.begin();
+    if (*(startCatPath) == fx_type_shortnames[t])
+    {
+        startCatPath++;
+    }
+
+    while (startCatPath != rpath.end())
+    {
+        preset.subPath /= *startCatPath;
+        startCatPath++;
+    }
+
+    return readFromXMLSnapshot(preset, s);
+}
+
 void FxUserPreset::doPresetRescan(SurgeStorage *storage, bool forceRescan)
 {
     if (haveScannedPresets && !forceRescan)
@@ -53,6 +109,8 @@ void FxUserPreset::doPresetRescan(SurgeStorage *storage, bool forceRescan)
     workStack.emplace_back(fs::path(ud), false);
     workStack.emplace_back(fd, true);
 
+    auto isPreset = [](const std::string &ext) { return ext == ".srgfx"; };
+
     try
     {
         while (!workStack.empty())
@@ -61,16 +119,15 @@ void FxUserPreset::doPresetRescan(SurgeStorage *storage, bool forceRescan)
             workStack.pop_front();
             if (fs::is_directory(top.first))
             {
-                for (auto &d : fs::directory_iterator(top.first))
+                auto &listing = manifest.list(top.first, isPreset);
+
+                for (auto &sd : listing.subdirs)
+                {
+                    workStack.emplace_back(top.first / fs::path(sd), top.second);
+                }
+                for (auto &fn : listing.files)
                 {
-                    if (fs::is_directory(d))
-                    {
-                        workStack.emplace_back(d, top.second);
-                    }
-                    else if (path_to_string(d.path().extension()) == ".srgfx")
-                    {
-                        sfxfiles.emplace_back(d.path(), top.second);
-                    }
+                    sfxfiles.emplace_back(top.first / fs::path(fn), top.second);
                 }
             }
         }
@@ -84,74 +141,47 @@ void FxUserPreset::doPresetRescan(SurgeStorage *storage, bool forceRescan)
             storage->reportError(oss.str(), "FileSystem Error");
     }
 
-    for (const auto &f : sfxfiles)
-    {
-        {
-            Preset preset;
-            preset.file = path_to_string(f.first);
-
-            TiXmlDocument d;
-            int t;
-
-            if (!d.LoadFile(f.first))
-                goto badPreset;
-
-            auto r = TINYXML_SAFE_TO_ELEMENT(d.FirstChild("single-fx"));
-
-            if (!r)
-                goto badPreset;
-
-            preset.streamingVersion = ff_revision;
-            int sv;
-            if (r->QueryIntAttribute("streaming_version", &sv) == TIXML_SUCCESS)
-            {
-                preset.streamingVersion = sv;
-            }
-
-            auto s = TINYXML_SAFE_TO_ELEMENT(r->FirstChild("snapshot"));
-
-            if (!s)
-                goto badPreset;
-
-            if (s->QueryIntAttribute("type", &t) != TIXML_SUCCESS)
-                goto badPreset;
-
-            preset.type = t;
-            preset.isFactory = f.second;
-
-            fs::path rpath;
-
-            if (f.second)
-                rpath = f.first.lexically_relative(fd).parent_path();
-            else
-                rpath = f.first.lexically_relative(storage->userFXPath).parent_path();
+    manifest.pruneUnvisited();
 
-            auto startCatPath = rpath.begin();
-            if (*(startCatPath) == fx_type_shortnames[t])
-            {
-                startCatPath++;
-            }
+    // only files which are new or have changed since the last scan get parsed again
+    std::unordered_map<std::string, ParsedFile> stillThere;
 
-            while (startCatPath != rpath.end())
-            {
-                preset.subPath /= *startCatPath;
-                startCatPath++;
-            }
+    for (const auto &f : sfxfiles)
+    {
+        auto key = path_to_string(f.first);
+        std::error_code ec;
+        auto modified = fs::last_write_time(f.first, ec);
+        auto fileSize = ec ? 0 : fs::file_size(f.first, ec);
 
-            if (!readFromXMLSnapshot(preset, s))
-                goto badPreset;
+        auto prior = parsedFiles.find(key);
+        ParsedFile pf;
 
-            if (scannedPresets.find(preset.type) == scannedPresets.end())
-            {
-                scannedPresets[preset.type] = std::vector<Preset>();
-            }
+        if (!ec && prior != parsedFiles.end() && prior->second.modified == modified &&
+            prior->second.fileSize == fileSize && prior->second.isFactory == f.second)
+        {
+            pf = std::move(prior->second);
+        }
+        else
+        {
+            pf.modified = modified;
+            pf.fileSize = fileSize;
+            pf.isFactory = f.second;
+            pf.valid = readPresetFile(storage, f.first, f.second, fd, pf.preset);
+        }
 
-            scannedPresets[preset.type].push_back(preset);
+        if (pf.valid)
+        {
+            scannedPresets[pf.preset.type].push_back(pf.preset);
         }
 
-    badPreset:;
+        if (!ec)
+        {
+            stillThere[key] = std::move(pf);
+        }
     }
 
+    parsedFiles = std::move(stillThere);
+
     for (auto &a : scannedPresets)
     {
         std::sort(a.second.begin(), a.second.end(), [](const Preset &a, const Preset &b) {
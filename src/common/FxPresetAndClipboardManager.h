@@ -24,6 +24,7 @@
 #define SURGE_SRC_COMMON_FXPRESETANDCLIPBOARDMANAGER_H
 
 #include "SurgeStorage.h"
+#include "DirectoryManifest.h"
 
 #include <vector>
 #include <unordered_map>
@@ -75,6 +76,25 @@ struct FxUserPreset
     void saveFxIn(SurgeStorage *s, FxStorage *fxdata, const std::string &fn);
 
     void loadPresetOnto(const Preset &p, SurgeStorage *s, FxStorage *fxbuffer);
+
+  private:
+    bool readPresetFile(SurgeStorage *storage, const fs::path &file, bool isFactory,
+                        const fs::path &factoryDir, Preset &preset);
+
+    /*
+     * A rescan lists directories through the manifest and keeps each file's parse keyed by
+     * path, modification time and size, so after saving one preset in a library of thousands
+     * only the new file is read. Files which failed to parse are remembered too.
+     */
+    DirectoryManifest manifest;
+    struct ParsedFile
+    {
+        fs::file_time_type modified{};
+        std::uintmax_t fileSize{0};
+        bool isFactory{false}, valid{false};
+        Preset preset;
+    };
+    std::unordered_map<std::string, ParsedFile> parsedFiles;
 };
 } // namespace Storage
 
@@ -0,0 +1,117 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "LargeBuffers.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if LINUX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Surge
+{
+namespace Memory
+{
+static std::atomic<size_t> hugeBytes{0};
+
+#if LINUX
+// the tail past the last whole huge page is left in ordinary pages, not rounded up to another
+static size_t mappedSize(size_t bytes)
+{
+    static const size_t pageBytes = (size_t)sysconf(_SC_PAGESIZE);
+    return (bytes + pageBytes - 1) & ~(pageBytes - 1);
+}
+
+static void *mapHugeAligned(size_t bytes)
+{
+    // mmap only promises page alignment, so map a huge page extra and trim to an aligned run
+    auto mapped = mappedSize(bytes) + hugePageBytes;
+    auto *m = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (m == MAP_FAILED)
+        return nullptr;
+
+    auto start = (uintptr_t)m;
+    auto aligned = (start + hugePageBytes - 1) & ~(uintptr_t)(hugePageBytes - 1);
+    auto end = start + mapped;
+    auto alignedEnd = aligned + mappedSize(bytes);
+
+    if (aligned > start)
+        munmap(m, aligned - start);
+    if (end > alignedEnd)
+        munmap((void *)alignedEnd, end - alignedEnd);
+
+    // only a hint; without transparent huge pages this is still ordinary anonymous memory
+    madvise((void *)aligned, alignedEnd - aligned, MADV_HUGEPAGE);
+
+    return (void *)aligned;
+}
+#endif
+
+void *allocateLargeBuffer(size_t bytes)
+{
+#if LINUX
+    /*
+     * No falling back to the heap if the mapping fails: freeLargeBuffer tells the two apart
+     * by size alone. A heap block this big would be an mmap inside malloc anyway.
+     */
+    if (bytes >= hugePageBytes)
+    {
+        auto *p = mapHugeAligned(bytes);
+
+        if (!p)
+            throw std::bad_alloc();
+
+        hugeBytes += mappedSize(bytes);
+        return p;
+    }
+#endif
+
+    auto *p = ::operator new(bytes, std::align_val_t{64});
+    memset(p, 0, bytes);
+    return p;
+}
+
+void freeLargeBuffer(void *p, size_t bytes)
+{
+    if (!p)
+        return;
+
+#if LINUX
+    if (bytes >= hugePageBytes)
+    {
+        munmap(p, mappedSize(bytes));
+        hugeBytes -= mappedSize(bytes);
+        return;
+    }
+#endif
+
+    ::operator delete(p, std::align_val_t{64});
+}
+
+size_t largeBufferHugePageBytes() { return hugeBytes; }
+} // namespace Memory
+} // namespace Surge
@@ -0,0 +1,85 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_LARGEBUFFERS_H
+#define SURGE_SRC_COMMON_LARGEBUFFERS_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace Surge
+{
+namespace Memory
+{
+/*
+ * Allocation for the big, long lived blocks the engine reads from every sample: wavetable
+ * mipmaps and the voice array. Blocks of at least hugePageBytes come straight from the OS,
+ * aligned to a huge page, and on Linux are marked for transparent huge pages, so playing
+ * through a large wavetable walks a handful of TLB entries instead of hundreds. Smaller
+ * blocks, and everything on platforms without that, come from the regular heap.
+ *
+ * Memory comes back zeroed. The OS backed blocks are not touched until first written, so
+ * the pages land on the NUMA node of whichever thread fills them, which for wavetables is
+ * the thread building the mipmaps and for voices the one constructing the engine.
+ *
+ * Free with the same size it was allocated with.
+ */
+static constexpr size_t hugePageBytes = 2 * 1024 * 1024;
+
+void *allocateLargeBuffer(size_t bytes);
+void freeLargeBuffer(void *p, size_t bytes);
+
+// How many bytes are currently held in huge page backed blocks, across the process
+size_t largeBufferHugePageBytes();
+
+template <typename T> struct LargeArrayDeleter
+{
+    size_t count{0};
+
+    void operator()(T *p) const
+    {
+        for (size_t i = 0; i < count; ++i)
+            p[i].~T();
+
+        freeLargeBuffer(p, count * sizeof(T));
+    }
+};
+
+template <typename T> using LargeArray = std::unique_ptr<T[], LargeArrayDeleter<T>>;
+
+// n default constructed Ts in one large buffer
+template <typename T> LargeArray<T> makeLargeArray(size_t n)
+{
+    static_assert(alignof(T) <= 64, "large buffers are only 64 byte aligned");
+
+    auto *p = static_cast<T *>(allocateLargeBuffer(n * sizeof(T)));
+
+    for (size_t i = 0; i < n; ++i)
+        new (p + i) T();
+
+    return LargeArray<T>(p, LargeArrayDeleter<T>{n});
+}
+} // namespace Memory
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_LARGEBUFFERS_H
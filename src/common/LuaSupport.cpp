@@ -199,6 +199,60 @@ bool Surge::LuaSupport::loadSurgePrelude(lua_State *s)
 
 std::string Surge::LuaSupport::getSurgePrelude() { return LuaSources::surge_prelude; }
 
+#if HAS_LUA
+// hooks have no user data, and a lua_State only ever runs on one thread at a time
+static thread_local Surge::LuaSupport::ScopedEvaluationBudget *activeBudget{nullptr};
+
+static void evaluationBudgetHook(lua_State *L, lua_Debug *)
+{
+    auto b = activeBudget;
+    if (!b)
+        return;
+
+    b->instructionsRun += Surge::LuaSupport::ScopedEvaluationBudget::hookInterval;
+
+    if (!b->wasExceeded)
+    {
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - b->start);
+        b->wasExceeded =
+            b->instructionsRun > b->maxInstructions || elapsed.count() > b->maxSeconds;
+    }
+
+    // keep raising once we are over, in case the script catches the error with its own pcall
+    if (b->wasExceeded)
+        luaL_error(L, "Script exceeded its evaluation budget and was stopped.");
+}
+#endif
+
+Surge::LuaSupport::ScopedEvaluationBudget::ScopedEvaluationBudget(lua_State *L, double maxSeconds,
+                                                                  int64_t maxInstructions)
+    : L(L), maxSeconds(maxSeconds), maxInstructions(maxInstructions),
+      start(std::chrono::steady_clock::now())
+{
+#if HAS_LUA
+    if (!L)
+        return;
+
+    outer = activeBudget;
+    activeBudget = this;
+    lua_sethook(L, evaluationBudgetHook, LUA_MASKCOUNT, hookInterval);
+#endif
+}
+
+Surge::LuaSupport::ScopedEvaluationBudget::~ScopedEvaluationBudget()
+{
+#if HAS_LUA
+    if (!L)
+        return;
+
+    lua_sethook(L, nullptr, 0, 0);
+    activeBudget = outer;
+
+    if (outer && outer->L)
+        lua_sethook(outer->L, evaluationBudgetHook, LUA_MASKCOUNT, hookInterval);
+#endif
+}
+
 Surge::LuaSupport::SGLD::~SGLD()
 {
     if (L)
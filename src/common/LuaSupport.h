@@ -29,6 +29,8 @@
 #ifndef SURGE_SRC_COMMON_LUASUPPORT_H
 #define SURGE_SRC_COMMON_LUASUPPORT_H
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -95,6 +97,41 @@ bool loadSurgePrelude(lua_State *s);
  */
 std::string getSurgePrelude();
 
+/*
+ * Put one of these on your stack around a lua_pcall into user code to bound how long that
+ * code can run. A count hook fires every hookInterval VM instructions and, once either the
+ * wall clock or the instruction budget is spent, raises a lua error so the pcall fails and
+ * the caller handles it like any other script error. Check exceeded() to tell the two
+ * apart. Nothing here locks, sleeps or allocates, so it is fine on the audio thread.
+ *
+ * LuaJIT does not run hooks inside compiled traces, so this reliably stops scripts which
+ * run away in the interpreter but can miss a loop which the JIT has already compiled.
+ */
+struct ScopedEvaluationBudget
+{
+    static constexpr int hookInterval{1000};
+    static constexpr int64_t defaultMaxInstructions{50000000};
+
+    ScopedEvaluationBudget(lua_State *L, double maxSeconds,
+                           int64_t maxInstructions = defaultMaxInstructions);
+    ~ScopedEvaluationBudget();
+
+    bool exceeded() const { return wasExceeded; }
+    // the instruction count doesn't depend on how busy the machine is, unlike the clock
+    bool exceededInstructions() const { return wasExceeded && instructionsRun > maxInstructions; }
+    double elapsedSeconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    lua_State *L;
+    double maxSeconds;
+    int64_t maxInstructions, instructionsRun{0};
+    std::chrono::steady_clock::time_point start;
+    bool wasExceeded{false};
+    ScopedEvaluationBudget *outer{nullptr};
+};
+
 /*
  * A little leak debugger. Make this on your stack and if you exit the
  * block with a different stack than you start, it complains for you
@@ -0,0 +1,99 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "MemoryFootprint.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace Surge
+{
+namespace Profiling
+{
+size_t MemoryFootprint::total() const
+{
+    size_t res = 0;
+    for (const auto &s : subsystems)
+        if (!s.shared)
+            res += s.bytes;
+    return res;
+}
+
+std::string MemoryFootprint::formatBytes(size_t bytes)
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+
+    if (bytes >= 1024 * 1024)
+        oss << bytes / (1024.0 * 1024.0) << " MB";
+    else if (bytes >= 1024)
+        oss << bytes / 1024.0 << " KB";
+    else
+        oss << bytes << " bytes";
+
+    return oss.str();
+}
+
+std::string MemoryFootprint::describe() const
+{
+    size_t w = 5;
+    for (const auto &s : subsystems)
+        w = std::max(w, s.name.size());
+
+    std::ostringstream oss;
+    for (const auto &s : subsystems)
+    {
+        oss << std::left << std::setw(w + 2) << s.name << std::right << std::setw(10)
+            << formatBytes(s.bytes);
+        if (s.shared)
+            oss << "  (shared)";
+        if (!s.detail.empty())
+            oss << "  " << s.detail;
+        oss << "\n";
+    }
+    oss << std::left << std::setw(w + 2) << "total" << std::right << std::setw(10)
+        << formatBytes(total()) << "\n";
+
+    return oss.str();
+}
+
+std::string MemoryFootprint::summary(size_t largest) const
+{
+    auto ordered = subsystems;
+    ordered.erase(std::remove_if(ordered.begin(), ordered.end(),
+                                 [](const Subsystem &s) { return s.shared || s.bytes == 0; }),
+                  ordered.end());
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const Subsystem &a, const Subsystem &b) { return a.bytes > b.bytes; });
+
+    std::ostringstream oss;
+    oss << formatBytes(total());
+
+    for (size_t i = 0; i < std::min(largest, ordered.size()); ++i)
+        oss << (i == 0 ? " (" : ", ") << ordered[i].name << " " << formatBytes(ordered[i].bytes);
+    if (!ordered.empty() && largest > 0)
+        oss << ")";
+
+    return oss.str();
+}
+} // namespace Profiling
+} // namespace Surge
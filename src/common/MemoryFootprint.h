@@ -0,0 +1,69 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_MEMORYFOOTPRINT_H
+#define SURGE_SRC_COMMON_MEMORYFOOTPRINT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Surge
+{
+namespace Profiling
+{
+/*
+ * What one engine holds, subsystem by subsystem, from SurgeSynthesizer::getMemoryFootprint.
+ * Sizes are what the engine owns, not what the allocator charges for it. Things every
+ * instance in the process shares, like built wavetables another oscillator also uses, are
+ * listed with shared set and left out of total(), since they don't go away with this one.
+ */
+struct MemoryFootprint
+{
+    struct Subsystem
+    {
+        std::string name;
+        size_t bytes{0};
+        std::string detail;
+        bool shared{false};
+    };
+    std::vector<Subsystem> subsystems;
+
+    void add(const std::string &name, size_t bytes, const std::string &detail = "",
+             bool shared = false)
+    {
+        subsystems.push_back({name, bytes, detail, shared});
+    }
+
+    size_t total() const;
+
+    // one line per subsystem and a total, for logs, the CLI and the like
+    std::string describe() const;
+    // the total and the largest few subsystems on a single line
+    std::string summary(size_t largest = 3) const;
+
+    static std::string formatBytes(size_t bytes);
+};
+} // namespace Profiling
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_MEMORYFOOTPRINT_H
@@ -23,6 +23,13 @@
 #ifndef SURGE_SRC_COMMON_MEMORYPOOL_H
 #define SURGE_SRC_COMMON_MEMORYPOOL_H
 
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
 namespace Surge
 {
 namespace Memory
@@ -39,31 +46,80 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
     {
         for (size_t i = 0; i < position; ++i)
             delete pool[i];
+
+        T *t;
+        while (takeFromReserve(t))
+            delete t;
+        while (takeReturned(t))
+            delete t;
+        for (auto *h : scrubbedHeld)
+            delete h;
     }
+
+    /*
+     * A scrubber puts an item back in the state a fresh one starts in (clearing a delay line,
+     * say). With one set, getItem only hands out scrubbed items: items coming back are
+     * scrubbed by replenishReserve off the audio thread while the pool has spare, and the
+     * odd one which had to go straight back into the pool is scrubbed as it is handed out.
+     */
+    void setScrubber(std::function<void(T *)> s)
+    {
+        scrubber = std::move(s);
+
+        for (size_t i = 0; i < position; ++i)
+        {
+            scrubber(pool[i]);
+            dirty[i] = false;
+        }
+    }
+
     template <typename... Args> T *getItem(Args &&...args)
     {
+        if (position <= reserveLowWater)
+        {
+            T *t;
+            while (position < reserveLowWater + growBy && takeFromReserve(t))
+            {
+                pool[position] = t;
+                position++;
+            }
+        }
+
         if (position == 0)
         {
             refreshPool(std::forward<Args>(args)...);
         }
         auto q = pool[position - 1];
+        bool wasDirty = dirty[position - 1];
         pool[position - 1] = nullptr; // just to flag bugs
         position--;
+
+        if (position <= reserveLowWater)
+            reserveWanted.store(true, std::memory_order_relaxed);
+
+        if (wasDirty)
+            scrubber(q);
+
         return q;
     }
     void returnItem(T *t)
     {
+        if (scrubber && position >= reserveLowWater + growBy && pushReturned(t))
+            return;
+
         pool[position] = t;
+        dirty[position] = static_cast<bool>(scrubber);
         position++;
     }
     template <typename... Args> void refreshPool(Args &&...args)
     {
-        // In an ideal world, this grow would be off thread.
-        // For XT 1 leave it here and have a reasonable prealloc
+        // Pools with a replenisher only get here when the reserve is dry too; see
+        // replenishReserve. Otherwise keep a reasonable prealloc.
         assert(position < (growBy + capacity));
         for (size_t i = 0; i < growBy; ++i)
         {
-            pool[position] = new T(std::forward<Args>(args)...);
+            pool[position] = makeItem(std::forward<Args>(args)...);
+            dirty[position] = false;
             position++;
         }
     }
@@ -72,7 +128,8 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
     {
         while (position < upTo)
         {
-            pool[position] = new T(std::forward<Args>(args)...);
+            pool[position] = makeItem(std::forward<Args>(args)...);
+            dirty[position] = false;
             position++;
         }
     }
@@ -84,10 +141,68 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
             delete pool[position - 1];
             pool[position - 1] = nullptr;
             position--;
+            allocated.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        reserveWanted.store(false, std::memory_order_relaxed);
+        T *t;
+        while (takeFromReserve(t))
+        {
+            delete t;
+            allocated.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * The reserve lets a background thread do the grow. Once getItem finds the pool at or
+     * under the low-water mark it pulls items from the reserve and asks for more, and whoever
+     * owns the pool calls replenishReserve off the audio thread to top the reserve back up.
+     * The reserve is a single producer (replenishReserve) single consumer (everything else)
+     * ring, so neither side takes a lock. getItem only allocates if the pool and the reserve
+     * are both dry. Scrubbed items which came back are offered before any new ones are made.
+     * Returns how many items it made.
+     */
+    template <typename... Args> size_t replenishReserve(Args &&...args)
+    {
+        T *t;
+        while (takeReturned(t))
+        {
+            scrubber(t);
+            scrubbedHeld.push_back(t);
+        }
+
+        while (!scrubbedHeld.empty() && pushReserve(scrubbedHeld.back()))
+            scrubbedHeld.pop_back();
+
+        if (!reserveWanted.exchange(false, std::memory_order_relaxed))
+            return 0;
+
+        size_t added = 0;
+
+        while (reserveHasRoom())
+        {
+            pushReserve(makeItem(std::forward<Args>(args)...));
+            added++;
         }
+
+        return added;
+    }
+
+    size_t reserveCount() const
+    {
+        auto h = reserveHead.load(std::memory_order_acquire);
+        auto t = reserveTail.load(std::memory_order_acquire);
+        return (t + reserve.size() - h) % reserve.size();
     }
 
+    // every item this pool has made and not yet deleted, whether pooled, reserved or lent out
+    size_t allocatedCount() const { return allocated.load(std::memory_order_relaxed); }
+
+    static constexpr size_t reserveLowWater = growBy;
+    static constexpr size_t reserveHighWater = 4 * growBy;
+
     std::array<T *, capacity> pool;
+    std::array<bool, capacity> dirty{};
 
     /*
      * Position is the location of the next *free* slot. That is
@@ -95,6 +210,82 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
      * position -1. position == 0 is a sentinel to rebuild.
      */
     size_t position{0};
+
+  private:
+    template <typename... Args> T *makeItem(Args &&...args)
+    {
+        auto t = new T(std::forward<Args>(args)...);
+        allocated.fetch_add(1, std::memory_order_relaxed);
+        if (scrubber)
+            scrubber(t);
+        return t;
+    }
+
+    bool reserveHasRoom() const
+    {
+        auto tail = reserveTail.load(std::memory_order_relaxed);
+        return (tail + 1) % reserve.size() != reserveHead.load(std::memory_order_acquire);
+    }
+
+    bool pushReserve(T *t)
+    {
+        if (!reserveHasRoom())
+            return false;
+
+        auto tail = reserveTail.load(std::memory_order_relaxed);
+        reserve[tail] = t;
+        reserveTail.store((tail + 1) % reserve.size(), std::memory_order_release);
+        return true;
+    }
+
+    // the returned ring has the audio thread as its producer and replenishReserve as consumer
+    bool pushReturned(T *t)
+    {
+        auto tail = returnedTail.load(std::memory_order_relaxed);
+        auto next = (tail + 1) % returned.size();
+
+        if (next == returnedHead.load(std::memory_order_acquire))
+            return false;
+
+        returned[tail] = t;
+        returnedTail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool takeReturned(T *&t)
+    {
+        auto head = returnedHead.load(std::memory_order_relaxed);
+
+        if (head == returnedTail.load(std::memory_order_acquire))
+            return false;
+
+        t = returned[head];
+        returnedHead.store((head + 1) % returned.size(), std::memory_order_release);
+        return true;
+    }
+
+    bool takeFromReserve(T *&t)
+    {
+        auto head = reserveHead.load(std::memory_order_relaxed);
+
+        if (head == reserveTail.load(std::memory_order_acquire))
+            return false;
+
+        t = reserve[head];
+        reserveHead.store((head + 1) % reserve.size(), std::memory_order_release);
+        return true;
+    }
+
+    // one slot stays empty to tell a full ring from an empty one
+    std::array<T *, reserveHighWater + 1> reserve{};
+    std::atomic<size_t> reserveHead{0}, reserveTail{0};
+    std::atomic<bool> reserveWanted{false};
+
+    std::function<void(T *)> scrubber;
+    std::array<T *, capacity + 1> returned{};
+    std::atomic<size_t> returnedHead{0}, returnedTail{0};
+    std::vector<T *> scrubbedHeld; // only touched by replenishReserve
+    std::atomic<size_t> allocated{0};
 };
 } // namespace Memory
 } // namespace Surge
@@ -639,6 +639,13 @@ class RandomModulationSource : public ModulationSource
         return 2; // bipolar can't support lognormal obvs
     }
 
+    void seed(uint32_t s)
+    {
+        gen.seed(s);
+        dis.reset();
+        norm.reset();
+    }
+
     float get_output(int which) override { return output[which]; }
 
     virtual void attack() override
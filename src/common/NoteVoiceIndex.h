@@ -0,0 +1,290 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_NOTEVOICEINDEX_H
+#define SURGE_SRC_COMMON_NOTEVOICEINDEX_H
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include "SurgeStorage.h"
+
+/*
+ * One bit per voice slot of a scene, in as many 64 bit words as MAX_VOICES needs, which is a
+ * single word unless the build raises SURGE_COMPILE_MAX_VOICES.
+ */
+struct VoiceMask
+{
+    static constexpr int n_words = (MAX_VOICES + 63) / 64;
+
+    VoiceMask() = default;
+    // the first 64 slots, so a mask can be written as a plain integer
+    VoiceMask(uint64_t low) { words[0] = low; }
+
+    static VoiceMask bit(int slot)
+    {
+        VoiceMask r;
+        r.words[slot >> 6] = (uint64_t)1 << (slot & 63);
+        return r;
+    }
+
+    VoiceMask &operator|=(const VoiceMask &o)
+    {
+        for (int i = 0; i < n_words; ++i)
+            words[i] |= o.words[i];
+        return *this;
+    }
+    VoiceMask &operator&=(const VoiceMask &o)
+    {
+        for (int i = 0; i < n_words; ++i)
+            words[i] &= o.words[i];
+        return *this;
+    }
+    VoiceMask operator|(VoiceMask o) const { return o |= *this; }
+    VoiceMask operator&(VoiceMask o) const { return o &= *this; }
+    VoiceMask operator~() const
+    {
+        VoiceMask r;
+        for (int i = 0; i < n_words; ++i)
+            r.words[i] = ~words[i];
+        return r;
+    }
+    bool operator==(const VoiceMask &o) const { return words == o.words; }
+    bool operator!=(const VoiceMask &o) const { return words != o.words; }
+    explicit operator bool() const
+    {
+        for (auto w : words)
+            if (w)
+                return true;
+        return false;
+    }
+
+    // calls f with each slot in the mask, lowest first
+    template <typename F> void forEachSlot(F &&f) const
+    {
+        for (int i = 0; i < n_words; ++i)
+            for (auto w = words[i]; w; w &= w - 1)
+                f(i * 64 + std::countr_zero(w));
+    }
+
+    std::array<uint64_t, n_words> words{};
+};
+
+/*
+ * Which voice slots (indices into SurgeSynthesizer::voices_array) are currently playing each
+ * (channel, key) and each host note id, as a VoiceMask per scene. Note events use this to find
+ * their voices without walking every voice of both scenes.
+ *
+ * The index is a superset: callers still confirm each candidate with matchesChannelKeyId,
+ * and slots whose channel or key is out of range are reported for every lookup. The synth
+ * must call set whenever a voice takes on a key, channel or note id and clear when it frees
+ * the voice. Note ids live in a small open addressing table with linear probing. It has
+ * twice as many buckets as there can be voices, so it never fills.
+ */
+struct NoteVoiceIndex
+{
+    typedef VoiceMask mask_t;
+    static constexpr int n_channels = 16, n_keys = 128;
+    static constexpr int n_buckets = 4 * MAX_VOICES;
+    static constexpr int32_t emptyId = -1;
+
+    NoteVoiceIndex() { reset(); }
+
+    void reset()
+    {
+        for (auto &sc : byChannelKey)
+            for (auto &ch : sc)
+                ch.fill({});
+        unkeyed.fill({});
+        bucketIds.fill(emptyId);
+        for (auto &b : bucketVoices)
+            b.fill({});
+        for (auto &sc : slots)
+            sc.fill({});
+    }
+
+    void set(int scene, int slot, int channel, int key, int32_t noteId)
+    {
+        clear(scene, slot);
+
+        auto bit = mask_t::bit(slot);
+        auto &s = slots[scene][slot];
+        s = {true, (int16_t)channel, (int16_t)key, noteId};
+
+        if (validChannelKey(channel, key))
+            byChannelKey[scene][channel][key] |= bit;
+        else
+            unkeyed[scene] |= bit;
+
+        if (noteId >= 0)
+        {
+            auto b = findBucket(noteId);
+            assert(b >= 0);
+            if (b >= 0)
+            {
+                bucketIds[b] = noteId;
+                bucketVoices[b][scene] |= bit;
+            }
+        }
+    }
+
+    void clear(int scene, int slot)
+    {
+        auto &s = slots[scene][slot];
+        if (!s.indexed)
+            return;
+
+        auto bit = mask_t::bit(slot);
+
+        if (validChannelKey(s.channel, s.key))
+            byChannelKey[scene][s.channel][s.key] &= ~bit;
+        else
+            unkeyed[scene] &= ~bit;
+
+        if (s.noteId >= 0)
+        {
+            auto b = findBucket(s.noteId);
+            if (b >= 0 && bucketIds[b] == s.noteId)
+            {
+                bucketVoices[b][scene] &= ~bit;
+
+                bool used = false;
+                for (auto m : bucketVoices[b])
+                    used = used || m;
+
+                if (!used)
+                    eraseBucket(b);
+            }
+        }
+
+        s = {};
+    }
+
+    /*
+     * The slots of a scene which may match (channel, key, noteId), with -1 as a wildcard
+     * in the same way as SurgeVoice::matchesChannelKeyId. Returns false if the query can't
+     * be narrowed, in which case the caller has to look at every voice.
+     */
+    bool candidates(int scene, int channel, int key, int32_t noteId, mask_t &result) const
+    {
+        if (noteId >= 0)
+        {
+            auto b = findBucket(noteId);
+            result = (b >= 0 && bucketIds[b] == noteId) ? bucketVoices[b][scene] : mask_t();
+
+            if (validChannelKey(channel, key))
+                result &= byChannelKey[scene][channel][key] | unkeyed[scene];
+
+            return true;
+        }
+
+        if (validChannelKey(channel, key))
+        {
+            result = byChannelKey[scene][channel][key] | unkeyed[scene];
+            return true;
+        }
+
+        return false;
+    }
+
+    // is any slot in any scene, other than the one given, playing this note id?
+    bool noteIdUsedElsewhere(int32_t noteId, int scene, int slot) const
+    {
+        auto b = findBucket(noteId);
+        if (b < 0 || bucketIds[b] != noteId)
+            return false;
+
+        for (int sc = 0; sc < n_scenes; ++sc)
+        {
+            auto m = bucketVoices[b][sc];
+            if (sc == scene)
+                m &= ~mask_t::bit(slot);
+            if (m)
+                return true;
+        }
+        return false;
+    }
+
+  private:
+    struct Slot
+    {
+        bool indexed{false};
+        int16_t channel{-1}, key{-1};
+        int32_t noteId{emptyId};
+    };
+
+    static bool validChannelKey(int channel, int key)
+    {
+        return channel >= 0 && channel < n_channels && key >= 0 && key < n_keys;
+    }
+
+    static int home(int32_t noteId)
+    {
+        return (int)(((uint32_t)noteId * 2654435761u) % n_buckets);
+    }
+
+    // the bucket holding noteId, or else the empty bucket where it would go
+    int findBucket(int32_t noteId) const
+    {
+        auto b = home(noteId);
+        for (int i = 0; i < n_buckets; ++i)
+        {
+            if (bucketIds[b] == noteId || bucketIds[b] == emptyId)
+                return b;
+            b = (b + 1) % n_buckets;
+        }
+        return -1;
+    }
+
+    // backward shift deletion, so lookups never need tombstones
+    void eraseBucket(int b)
+    {
+        auto hole = b;
+        auto next = (b + 1) % n_buckets;
+
+        while (bucketIds[next] != emptyId)
+        {
+            auto h = home(bucketIds[next]);
+            bool canMove = (hole <= next) ? (h <= hole || h > next) : (h <= hole && h > next);
+
+            if (canMove)
+            {
+                bucketIds[hole] = bucketIds[next];
+                bucketVoices[hole] = bucketVoices[next];
+                hole = next;
+            }
+            next = (next + 1) % n_buckets;
+        }
+
+        bucketIds[hole] = emptyId;
+        bucketVoices[hole].fill({});
+    }
+
+    std::array<std::array<std::array<mask_t, n_keys>, n_channels>, n_scenes> byChannelKey;
+    std::array<mask_t, n_scenes> unkeyed;
+    std::array<int32_t, n_buckets> bucketIds;
+    std::array<std::array<mask_t, n_scenes>, n_buckets> bucketVoices;
+    std::array<std::array<Slot, MAX_VOICES>, n_scenes> slots;
+};
+
+#endif // SURGE_SRC_COMMON_NOTEVOICEINDEX_H
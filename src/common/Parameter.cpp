@@ -278,7 +278,9 @@ bool Parameter::can_extend_range() const
     case ct_freq_shift:
     case ct_decibel_extendable:
     case ct_decibel_narrow_extendable:
+    case ct_distortion_drive:
     case ct_decibel_narrow_short_extendable:
+    case ct_waveshaper_drive:
     case ct_oscspread:
     case ct_oscspread_bipolar:
     case ct_osc_feedback:
@@ -368,6 +370,8 @@ bool Parameter::has_deformoptions() const
     case ct_noise_color:
     case ct_amplitude_ringmod:
     case ct_bonsai_bass_boost:
+    case ct_distortion_drive:
+    case ct_waveshaper_drive:
         return true;
     default:
         break;
@@ -392,8 +396,10 @@ bool Parameter::is_bipolar() const
     case ct_decibel_narrow:
     case ct_decibel_narrow_deactivatable:
     case ct_decibel_narrow_extendable:
+    case ct_distortion_drive:
     case ct_decibel_extra_narrow_deactivatable:
     case ct_decibel_narrow_short_extendable:
+    case ct_waveshaper_drive:
     case ct_decibel_extra_narrow:
     case ct_decibel_extendable:
     case ct_freq_mod:
@@ -448,6 +454,7 @@ bool Parameter::is_discrete_selection() const
     case ct_sineoscmode:
     case ct_wt2window:
     case ct_airwindows_fx:
+    case ct_convolution_ir:
     case ct_flangermode:
     case ct_fxlfowave:
     case ct_distortion_waveshape:
@@ -522,6 +529,7 @@ void Parameter::set_user_data(ParamUserData *ud)
         }
         break;
     case ct_airwindows_fx:
+    case ct_convolution_ir:
     case ct_filtertype:
     case ct_alias_wave:
     case ct_wstype:
@@ -745,7 +753,9 @@ void Parameter::set_type(int ctrltype)
     case ct_decibel_narrow:
     case ct_decibel_narrow_deactivatable:
     case ct_decibel_narrow_extendable:
+    case ct_distortion_drive:
     case ct_decibel_narrow_short_extendable:
+    case ct_waveshaper_drive:
         valtype = vt_float;
         val_min.f = -24;
         val_max.f = 24;
@@ -969,7 +979,7 @@ void Parameter::set_type(int ctrltype)
     case ct_polylimit:
         valtype = vt_int;
         val_min.i = 2;
-        val_max.i = 64;
+        val_max.i = MAX_VOICES;
         val_default.i = 16;
         break;
     case ct_scenesel:
@@ -1085,6 +1095,12 @@ void Parameter::set_type(int ctrltype)
         valtype = vt_int;
         val_default.i = 0;
         break;
+    case ct_vocoder_engine:
+        val_min.i = 0;
+        val_max.i = 1;
+        valtype = vt_int;
+        val_default.i = 0;
+        break;
     case ct_distortion_waveshape:
         val_min.i = 0;
         val_max.i = n_fxws - 1;
@@ -1225,6 +1241,13 @@ void Parameter::set_type(int ctrltype)
         valtype = vt_int;
         val_default.i = 0;
         break;
+    case ct_convolution_ir:
+        // the effect sets the real maximum from the impulse responses it finds; -1 is None
+        val_min.i = -1;
+        val_max.i = 0;
+        valtype = vt_int;
+        val_default.i = 0;
+        break;
     case ct_airwindows_param:
     case ct_airwindows_param_bipolar: // it's still 0 ... 1 - this is just a display thing
         val_min.f = 0;
@@ -1512,12 +1535,14 @@ void Parameter::set_type(int ctrltype)
         break;
 
     case ct_decibel_narrow_extendable:
+    case ct_distortion_drive:
         displayType = LinearWithScale;
         snprintf(displayInfo.unit, DISPLAYINFO_TXT_SIZE, "dB");
         displayInfo.extendFactor = 5;
         break;
 
     case ct_decibel_narrow_short_extendable:
+    case ct_waveshaper_drive:
         displayType = LinearWithScale;
         snprintf(displayInfo.unit, DISPLAYINFO_TXT_SIZE, "dB");
         displayInfo.extendFactor = 2;
@@ -1811,7 +1836,9 @@ void Parameter::bound_value(bool force_integer)
         case ct_decibel:
         case ct_decibel_narrow:
         case ct_decibel_narrow_extendable:
+        case ct_distortion_drive:
         case ct_decibel_narrow_short_extendable:
+        case ct_waveshaper_drive:
         case ct_decibel_extra_narrow:
         case ct_decibel_attenuation:
         case ct_decibel_attenuation_clipper:
@@ -2067,6 +2094,41 @@ void Parameter::set_storage_value(float f)
     }
 }
 
+ParameterState Parameter::get_state() const
+{
+    ParameterState s;
+    s.val = val;
+    s.temposync = temposync;
+    s.absolute = absolute;
+    s.deactivated = deactivated;
+    s.extend_range = extend_range;
+    s.porta_constrate = porta_constrate;
+    s.porta_gliss = porta_gliss;
+    s.porta_retrigger = porta_retrigger;
+    s.porta_curve = porta_curve;
+    s.deform_type = deform_type;
+    return s;
+}
+
+void Parameter::set_state(const ParameterState &s, bool includeValue)
+{
+    if (includeValue)
+    {
+        val = s.val;
+    }
+
+    temposync = s.temposync;
+    absolute = s.absolute;
+    deactivated = s.deactivated;
+    // after val, since narrowing the range may clamp the value
+    set_extend_range(s.extend_range);
+    porta_constrate = s.porta_constrate;
+    porta_gliss = s.porta_gliss;
+    porta_retrigger = s.porta_retrigger;
+    porta_curve = s.porta_curve;
+    deform_type = s.deform_type;
+}
+
 void Parameter::set_extend_range(bool er)
 {
     bool prior_extend = extend_range;
@@ -2208,8 +2270,10 @@ float Parameter::get_extended(float f) const
     case ct_bonsai_bass_boost:
         return 3.f * f;
     case ct_decibel_narrow_extendable:
+    case ct_distortion_drive:
         return 5.f * f;
     case ct_decibel_narrow_short_extendable:
+    case ct_waveshaper_drive:
         return 2.f * f;
     case ct_oscspread:
     case ct_oscspread_bipolar:
@@ -3955,8 +4019,12 @@ std::string Parameter::get_display(bool external, float ef) const
             }
         }
         break;
+        case ct_vocoder_engine:
+            txt = (i == 0) ? "Filter Bank" : "FFT";
+            break;
 
         case ct_airwindows_fx:
+        case ct_convolution_ir:
         {
             // These are all the ones with a ParameterDiscreteIndexRemapper
             auto pd = dynamic_cast<ParameterDiscreteIndexRemapper *>(user_data);
@@ -4247,7 +4315,9 @@ bool Parameter::can_setvalue_from_string() const
     case ct_decibel_narrow:
     case ct_decibel_narrow_deactivatable:
     case ct_decibel_narrow_extendable:
+    case ct_distortion_drive:
     case ct_decibel_narrow_short_extendable:
+    case ct_waveshaper_drive:
     case ct_decibel_extra_narrow:
     case ct_decibel_extra_narrow_deactivatable:
     case ct_decibel_attenuation:
@@ -207,6 +207,10 @@ enum ctrltypes
     ct_bonsai_sat_filter,
     ct_bonsai_sat_mode,
     ct_bonsai_noise_mode,
+    ct_convolution_ir,
+    ct_vocoder_engine,
+    ct_distortion_drive, // ct_decibel_narrow_extendable with oversampling options
+    ct_waveshaper_drive, // ct_decibel_narrow_short_extendable, likewise
 
     num_ctrltypes,
 };
@@ -355,6 +359,21 @@ struct ModulationDisplayInfoWindowStrings
     std::string dvalminus;
 };
 
+/*
+ * The part of a Parameter which changes as a patch is edited: its value and the per-parameter
+ * options streamed next to it. Names, ranges, layout and display info are fixed by the control
+ * type, so snapshots which cover many parameters (the clipboard, undo) keep these instead of
+ * whole Parameters, which are a few kilobytes each, mostly cold strings.
+ */
+struct ParameterState
+{
+    pdata val{};
+    bool temposync{}, absolute{}, deactivated{}, extend_range{};
+    bool porta_constrate{}, porta_gliss{}, porta_retrigger{};
+    int porta_curve{};
+    int deform_type{};
+};
+
 class SurgeStorage;
 
 class Parameter
@@ -465,6 +484,9 @@ class Parameter
     void set_error_message(std::string &errMsg, const std::string value, const std::string unit,
                            const ErrorMessageMode mode);
     void set_extend_range(bool er);
+    ParameterState get_state() const;
+    // includeValue false leaves val alone, for callers which route the value change elsewhere
+    void set_state(const ParameterState &s, bool includeValue = true);
     double get_freq_from_note_name(const std::string s, double defv);
 
     /*
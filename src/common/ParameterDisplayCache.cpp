@@ -0,0 +1,111 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "ParameterDisplayCache.h"
+#include "SurgeStorage.h"
+#include <cstring>
+
+namespace Surge
+{
+namespace Storage
+{
+ParameterDisplayCache::Key ParameterDisplayCache::keyFor(const Parameter *p, bool external,
+                                                         float f)
+{
+    Key k;
+    k.p = p;
+
+    if (external)
+        std::memcpy(&k.valueBits, &f, sizeof(k.valueBits));
+    else
+        k.valueBits = (uint32_t)p->val.i;
+
+    k.ctrltype = p->ctrltype;
+    k.deformType = p->deform_type;
+    k.portaCurve = p->porta_curve;
+    k.options = (p->temposync << 0) | (p->absolute << 1) | (p->deactivated << 2) |
+                (p->extend_range << 3) | (p->porta_constrate << 4) | (p->porta_gliss << 5) |
+                (p->porta_retrigger << 6) | (external << 7);
+
+    if (auto *s = p->storage)
+    {
+        k.controls = s->getPatch().controlsRevision;
+        k.tuning = s->tuningUpdates;
+        if (s->userDefaultsProvider)
+            k.defaults = s->userDefaultsProvider->revision();
+    }
+
+    return k;
+}
+
+const std::string &ParameterDisplayCache::lookup(const Parameter *p, bool external, float f)
+{
+    auto slot = (size_t)p->id * 2 + (external ? 1 : 0);
+    if (slot >= entries.size())
+        entries.resize(slot + 2);
+
+    auto &e = entries[slot];
+    auto k = keyFor(p, external, f);
+
+    if (e.key == k)
+    {
+        hits++;
+        return e.text;
+    }
+
+    misses++;
+    e.key = k;
+    e.text = p->get_display(external, f);
+    return e.text;
+}
+
+std::string ParameterDisplayCache::get(const Parameter *p, bool external, float f)
+{
+    if (!p || p->id < 0)
+        return "-";
+
+    std::lock_guard<std::mutex> g(lock);
+    return lookup(p, external, f);
+}
+
+void ParameterDisplayCache::getAll(const std::vector<const Parameter *> &params,
+                                   std::vector<std::string> &into)
+{
+    into.resize(params.size());
+
+    std::lock_guard<std::mutex> g(lock);
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        if (params[i] && params[i]->id >= 0)
+            into[i] = lookup(params[i], false, 0.f);
+        else
+            into[i] = "-";
+    }
+}
+
+void ParameterDisplayCache::clear()
+{
+    std::lock_guard<std::mutex> g(lock);
+    entries.clear();
+}
+} // namespace Storage
+} // namespace Surge
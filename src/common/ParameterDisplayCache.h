@@ -0,0 +1,98 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_PARAMETERDISPLAYCACHE_H
+#define SURGE_SRC_COMMON_PARAMETERDISPLAYCACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Parameter;
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * Hosts ask for the display text of every visible parameter on every refresh of their
+ * generic editor or automation lanes, and get_display is a fair amount of formatting work
+ * for what is almost always the same answer as last time. This keeps the last text per
+ * parameter, both for its current value and for the most recent value a host asked about,
+ * along with everything that text depended on: the value, the parameter's type and display
+ * options, the patch's control layout (which moves when a type parameter changes the others),
+ * the tuning and the user defaults which affect readouts.
+ *
+ * Called from the UI and host threads, never the audio thread, and takes a lock.
+ */
+struct ParameterDisplayCache
+{
+    // the text Parameter::get_display(external, f) would give, from the cache if we can
+    std::string get(const Parameter *p, bool external = false, float f = 0.f);
+
+    // the current value text for each parameter, taking the lock once for the lot
+    void getAll(const std::vector<const Parameter *> &params, std::vector<std::string> &into);
+
+    void clear();
+
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+
+  private:
+    struct Key
+    {
+        const Parameter *p{nullptr};
+        uint32_t valueBits{0};
+        int ctrltype{-1};
+        int deformType{0};
+        int portaCurve{0};
+        uint32_t options{0};
+        uint64_t controls{0}, tuning{0}, defaults{0};
+
+        bool operator==(const Key &o) const
+        {
+            return p == o.p && valueBits == o.valueBits && ctrltype == o.ctrltype &&
+                   deformType == o.deformType && portaCurve == o.portaCurve &&
+                   options == o.options && controls == o.controls && tuning == o.tuning &&
+                   defaults == o.defaults;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::string text;
+    };
+
+    static Key keyFor(const Parameter *p, bool external, float f);
+    const std::string &lookup(const Parameter *p, bool external, float f);
+
+    // two entries per parameter id, the current value and the last externally asked one
+    std::vector<Entry> entries;
+    std::mutex lock;
+    int hits{0}, misses{0};
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_PARAMETERDISPLAYCACHE_H
@@ -0,0 +1,126 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "PatchChunkCache.h"
+#include <cstring>
+
+namespace Surge
+{
+namespace Storage
+{
+bool PatchChunkCache::stat(const fs::path &path, fs::file_time_type &modified,
+                           std::uintmax_t &fileSize) const
+{
+    std::error_code ec;
+
+    modified = fs::last_write_time(path, ec);
+    if (ec)
+        return false;
+
+    fileSize = fs::file_size(path, ec);
+    return !ec;
+}
+
+bool PatchChunkCache::fetch(const fs::path &path, std::unique_ptr<char[]> &data, int &size)
+{
+    fs::file_time_type modified;
+    std::uintmax_t fileSize;
+
+    if (!stat(path, modified, fileSize))
+        return false;
+
+    auto key = path_to_string(path);
+    std::lock_guard<std::mutex> g(lock);
+
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if (it->path != key)
+            continue;
+
+        if (it->modified != modified || it->fileSize != fileSize)
+        {
+            // the file changed under us, so this copy is no use to anyone
+            entries.erase(it);
+            break;
+        }
+
+        entries.splice(entries.begin(), entries, it);
+
+        size = (int)it->chunk.size();
+        data.reset(new char[size]);
+        memcpy(data.get(), it->chunk.data(), size);
+        hits++;
+
+        return true;
+    }
+
+    misses++;
+    return false;
+}
+
+bool PatchChunkCache::contains(const fs::path &path)
+{
+    fs::file_time_type modified;
+    std::uintmax_t fileSize;
+
+    if (!stat(path, modified, fileSize))
+        return false;
+
+    auto key = path_to_string(path);
+    std::lock_guard<std::mutex> g(lock);
+
+    for (const auto &e : entries)
+    {
+        if (e.path == key)
+            return e.modified == modified && e.fileSize == fileSize;
+    }
+
+    return false;
+}
+
+void PatchChunkCache::store(const fs::path &path, const char *data, int size)
+{
+    Entry e;
+
+    if (capacity <= 0 || size <= 0 || !stat(path, e.modified, e.fileSize))
+        return;
+
+    e.path = path_to_string(path);
+    e.chunk.assign(data, data + size);
+
+    std::lock_guard<std::mutex> g(lock);
+
+    entries.remove_if([&e](const auto &q) { return q.path == e.path; });
+    entries.push_front(std::move(e));
+
+    while ((int)entries.size() > capacity)
+        entries.pop_back();
+}
+
+void PatchChunkCache::clear()
+{
+    std::lock_guard<std::mutex> g(lock);
+    entries.clear();
+}
+
+} // namespace Storage
+} // namespace Surge
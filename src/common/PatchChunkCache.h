@@ -0,0 +1,87 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_PATCHCHUNKCACHE_H
+#define SURGE_SRC_COMMON_PATCHCHUNKCACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "filesystem/import.h"
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * A small most-recently-used cache of FXP patch chunks, keyed by path and checked against the
+ * file's modification time and size, so flipping back and forth through a setlist or with
+ * jogPatch doesn't go back to the disk for patches we have just seen.
+ *
+ * What is cached is the chunk exactly as it sits in the file, not a parsed patch. Loading
+ * mutates the chunk in place (the header is byte swapped) so fetch always hands out a fresh
+ * copy. The cache is used from the UI and patch load threads, never the audio thread, and
+ * takes a lock.
+ */
+struct PatchChunkCache
+{
+    static constexpr int defaultCapacity = 32;
+
+    explicit PatchChunkCache(int capacity = defaultCapacity) : capacity(capacity) {}
+
+    /*
+     * If we have an up to date copy of the chunk for this path, copy it into data and size
+     * and return true.
+     */
+    bool fetch(const fs::path &path, std::unique_ptr<char[]> &data, int &size);
+    // whether fetch would find an up to date copy, without copying or counting it
+    bool contains(const fs::path &path);
+    void store(const fs::path &path, const char *data, int size);
+    void clear();
+
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+
+  private:
+    struct Entry
+    {
+        std::string path;
+        fs::file_time_type modified;
+        std::uintmax_t fileSize{0};
+        std::vector<char> chunk;
+    };
+
+    bool stat(const fs::path &path, fs::file_time_type &modified, std::uintmax_t &fileSize) const;
+
+    int capacity;
+    std::list<Entry> entries; // most recently used at the front
+    std::mutex lock;
+    int hits{0}, misses{0};
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_PATCHCHUNKCACHE_H
@@ -22,6 +22,10 @@
 
 #include "PatchDB.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <iterator>
 #include <chrono>
@@ -30,6 +34,7 @@
 #include "sqlite3.h"
 #include "SurgeStorage.h"
 #include "DebugHelpers.h"
+#include "RenderWorkerPool.h"
 
 #include "sst/basic-blocks/mechanics/endian-ops.h"
 
@@ -239,7 +244,7 @@ struct TxnGuard
 
 struct PatchDB::WriterWorker
 {
-    static constexpr const char *schema_version = "14"; // I will rebuild if this is not my version
+    static constexpr const char *schema_version = "15"; // I will rebuild if this is not my version
 
     static constexpr const char *setup_sql = R"SQL(
 DROP TABLE IF EXISTS "Patches";
@@ -247,6 +252,7 @@ DROP TABLE IF EXISTS "PatchFeature";
 DROP TABLE IF EXISTS "Version";
 DROP TABLE IF EXISTS "Category";
 DROP TABLE IF EXISTS "DebugJunk";
+DROP TABLE IF EXISTS "PatchSearch";
 CREATE TABLE "Version" (
     id integer primary key,
     schema_version varchar(256)
@@ -268,6 +274,16 @@ CREATE TABLE PatchFeature (
       feature_ivalue int,
       feature_svalue varchar(64)
 );
+CREATE INDEX PatchFeatureByPatch ON PatchFeature (patch_id);
+CREATE VIRTUAL TABLE PatchSearch USING fts5(
+      name,
+      author,
+      category,
+      comment,
+      tags,
+      tokenize = 'unicode61 remove_diacritics 1',
+      prefix = '2 3'
+);
 CREATE TABLE Category (
       id integer primary key,
       name varchar(2048),
@@ -289,6 +305,28 @@ CREATE TABLE IF NOT EXISTS Favorites (
     path varchar(2048)
 );
 )SQL";
+    // FIXME features should be an enum or something
+
+    enum FeatureType
+    {
+        INT,
+        STRING
+    };
+    typedef std::tuple<std::string, FeatureType, int, std::string> feature;
+
+    /*
+     * Everything we learn about an FXP from the file alone. This is filled in off the
+     * writer thread by the parse pool, so it must not touch the database or storage.
+     */
+    struct ParsedFXP
+    {
+        bool done{false};
+        bool exists{false};
+        bool valid{false};
+        int64_t lastWriteTime{0};
+        std::vector<feature> features;
+    };
+
     struct EnQAble
     {
         virtual ~EnQAble() = default;
@@ -305,6 +343,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
         std::string name;
         std::string catname;
         CatType type;
+        ParsedFXP parsed;
 
         void go(WriterWorker &w) override { w.parseFXPIntoDB(*this); }
     };
@@ -534,15 +573,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
         }
     }
 
-    // FIXME features should be an enum or something
-
-    enum FeatureType
-    {
-        INT,
-        STRING
-    };
-    typedef std::tuple<std::string, FeatureType, int, std::string> feature;
-    std::vector<feature> extractFeaturesFromXML(const std::string &xml)
+    static std::vector<feature> extractFeaturesFromXML(const std::string &xml)
     {
         std::vector<feature> res;
         TiXmlDocument doc;
@@ -586,6 +617,11 @@ CREATE TABLE IF NOT EXISTS Favorites (
                 res.emplace_back("AUTHOR", STRING, 0, meta->Attribute("author"));
             }
 
+            if (meta->Attribute("comment") && meta->Attribute("comment")[0])
+            {
+                res.emplace_back("COMMENT", STRING, 0, meta->Attribute("comment"));
+            }
+
             auto tags = TINYXML_SAFE_TO_ELEMENT(meta->FirstChild("tags"));
             if (tags)
             {
@@ -599,7 +635,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
         }
 
         auto parameters = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("parameters"));
-        auto par = parameters->FirstChildElement();
+        auto par = parameters ? parameters->FirstChildElement() : nullptr;
 
         while (par)
         {
@@ -642,13 +678,324 @@ CREATE TABLE IF NOT EXISTS Favorites (
         return res;
     }
 
+    /*
+     * The index only wants the revision, the meta block and a few type parameters, and a saved
+     * patch has all of those before its </parameters>. Building a TinyXML document for the
+     * whole body (and reading the wavetables behind it) is most of what a cold index pass
+     * costs, so this reads the XML in chunks, picks the attributes out of just those elements,
+     * and stops at </parameters>. Anything it doesn't expect, like a meta block after the
+     * parameters or a malformed tag, makes it return false and the caller does the full parse.
+     */
+    struct FeatureScanner
+    {
+        static constexpr size_t chunkSize = 16384;
+
+        std::istream &stream;
+        size_t xmlSize;
+        std::string buf;
+
+        FeatureScanner(std::istream &s, size_t sz) : stream(s), xmlSize(sz) {}
+
+        bool readMore()
+        {
+            if (buf.size() >= xmlSize)
+                return false;
+
+            auto had = buf.size();
+            auto want = std::min(chunkSize, xmlSize - had);
+            buf.resize(had + want);
+            stream.read(&buf[had], want);
+            buf.resize(had + stream.gcount());
+
+            return buf.size() > had;
+        }
+
+        // the end of the tag starting at lt, minding quoted '>'s; npos if it isn't all read yet
+        size_t tagEnd(size_t lt) const
+        {
+            char quote = 0;
+
+            for (auto i = lt + 1; i < buf.size(); ++i)
+            {
+                auto c = buf[i];
+
+                if (quote)
+                {
+                    if (c == quote)
+                        quote = 0;
+                }
+                else if (c == '"' || c == '\'')
+                    quote = c;
+                else if (c == '>')
+                    return i;
+            }
+
+            return std::string::npos;
+        }
+
+        // entities the way TinyXML reads them with TIXML_ENCODING_LEGACY
+        static std::string decode(const char *b, const char *e)
+        {
+            static const std::pair<const char *, char> named[] = {
+                {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}};
+            std::string res;
+            res.reserve(e - b);
+
+            while (b < e)
+            {
+                if (*b != '&')
+                {
+                    res += *b++;
+                    continue;
+                }
+
+                bool matched = false;
+                for (auto &[ent, c] : named)
+                {
+                    auto n = strlen(ent);
+                    if ((size_t)(e - b) >= n && strncmp(b, ent, n) == 0)
+                    {
+                        res += c;
+                        b += n;
+                        matched = true;
+                        break;
+                    }
+                }
+
+                auto semi = std::find(b, e, ';');
+                if (!matched && b + 2 < e && b[1] == '#' && semi != e)
+                {
+                    bool hex = b[2] == 'x';
+                    res += (char)strtoul(std::string(b + (hex ? 3 : 2), semi).c_str(), nullptr,
+                                         hex ? 16 : 10);
+                    b = semi + 1;
+                }
+                else if (!matched)
+                {
+                    res += *b++;
+                }
+            }
+
+            return res;
+        }
+
+        struct Tag
+        {
+            std::string name;
+            std::vector<std::pair<std::string, std::string>> attributes;
+            bool closing{false}, selfClosing{false};
+
+            const std::string *attribute(const char *n) const
+            {
+                for (auto &[k, v] : attributes)
+                    if (k == n)
+                        return &v;
+                return nullptr;
+            }
+
+            // QueryIntAttribute reads a leading integer the same way
+            bool intAttribute(const char *n, int &v) const
+            {
+                auto *a = attribute(n);
+                return a && sscanf(a->c_str(), "%d", &v) == 1;
+            }
+        };
+
+        static bool parseTag(const char *b, const char *e, Tag &t)
+        {
+            auto isName = [](char c) {
+                return std::isalnum((unsigned char)c) || c == '_' || c == '-' || c == ':' ||
+                       c == '.';
+            };
+
+            if (b < e && *b == '/')
+            {
+                t.closing = true;
+                ++b;
+            }
+            if (e > b && e[-1] == '/')
+            {
+                t.selfClosing = true;
+                --e;
+            }
+
+            auto n = b;
+            while (n < e && isName(*n))
+                ++n;
+            if (n == b)
+                return false;
+            t.name.assign(b, n);
+
+            while (n < e)
+            {
+                while (n < e && std::isspace((unsigned char)*n))
+                    ++n;
+                if (n == e)
+                    break;
+
+                auto k = n;
+                while (n < e && isName(*n))
+                    ++n;
+                if (n == k)
+                    return false;
+                auto key = std::string(k, n);
+
+                while (n < e && std::isspace((unsigned char)*n))
+                    ++n;
+                if (n == e || *n != '=')
+                    return false;
+                ++n;
+                while (n < e && std::isspace((unsigned char)*n))
+                    ++n;
+                if (n == e || (*n != '"' && *n != '\''))
+                    return false;
+
+                auto q = *n++;
+                auto v = std::find(n, e, q);
+                if (v == e)
+                    return false;
+                t.attributes.emplace_back(key, decode(n, v));
+                n = v + 1;
+            }
+
+            return true;
+        }
+
+        bool scan(std::vector<feature> &res)
+        {
+            size_t pos = 0;
+            int depth = 0;
+            bool inMeta{false}, inTags{false}, inParameters{false}, sawMeta{false};
+
+            while (true)
+            {
+                auto lt = buf.find('<', pos);
+                if (lt == std::string::npos)
+                {
+                    pos = buf.size();
+                    if (!readMore())
+                        return false;
+                    continue;
+                }
+
+                // comments and declarations carry nothing for us
+                if (buf.compare(lt, 4, "<!--") == 0 || buf.compare(lt, 2, "<?") == 0)
+                {
+                    auto close = buf.compare(lt, 4, "<!--") == 0 ? "-->" : "?>";
+                    size_t end;
+                    while ((end = buf.find(close, lt)) == std::string::npos)
+                        if (!readMore())
+                            return false;
+                    pos = end + strlen(close);
+                    continue;
+                }
+                if (buf.compare(lt, 2, "<!") == 0)
+                    return false;
+
+                size_t gt;
+                while ((gt = tagEnd(lt)) == std::string::npos)
+                    if (!readMore())
+                        return false;
+                pos = gt + 1;
+
+                Tag t;
+                if (!parseTag(buf.data() + lt + 1, buf.data() + gt, t))
+                    return false;
+
+                if (t.closing)
+                {
+                    depth--;
+
+                    if (depth == 1 && t.name == "meta")
+                        inMeta = false;
+                    if (depth == 2 && t.name == "tags")
+                        inTags = false;
+                    // everything the index wants is behind us
+                    if (depth == 1 && inParameters && t.name == "parameters")
+                        return sawMeta;
+                    if (depth == 0)
+                        return sawMeta;
+                    continue;
+                }
+
+                if (depth == 0)
+                {
+                    if (t.name != "patch")
+                        return false;
+
+                    int rev = 0;
+                    if (!t.intAttribute("revision", rev))
+                        return true; // the full parse gives up on these too
+                    res.emplace_back("REVISION", INT, rev, "");
+                }
+                else if (depth == 1 && t.name == "meta" && !sawMeta)
+                {
+                    sawMeta = true;
+                    inMeta = !t.selfClosing;
+
+                    if (auto *a = t.attribute("author"))
+                        res.emplace_back("AUTHOR", STRING, 0, *a);
+                    if (auto *c = t.attribute("comment"); c && !c->empty())
+                        res.emplace_back("COMMENT", STRING, 0, *c);
+                }
+                else if (depth == 2 && inMeta && t.name == "tags")
+                {
+                    inTags = !t.selfClosing;
+                }
+                else if (depth == 3 && inTags)
+                {
+                    if (auto *a = t.attribute("tag"))
+                        res.emplace_back("TAG", STRING, 0, *a);
+                }
+                else if (depth == 1 && t.name == "parameters")
+                {
+                    inParameters = !t.selfClosing;
+                }
+                else if (depth == 2 && inParameters)
+                {
+                    addParameterFeature(t, res);
+                }
+
+                if (!t.selfClosing)
+                    depth++;
+            }
+
+            return false;
+        }
+
+        static void addParameterFeature(const Tag &t, std::vector<feature> &res)
+        {
+            const auto &s = t.name;
+            int sm;
+
+            if (s == "scenemode" && t.intAttribute("value", sm) && sm >= 0 && sm < n_scene_modes)
+            {
+                res.emplace_back("SCENE_MODE", STRING, 0, scene_mode_names[sm]);
+            }
+
+            if (s.find("fx") == 0 && s.find("_type") != std::string::npos &&
+                t.intAttribute("value", sm) && sm > 0 && sm < n_fx_types)
+            {
+                res.emplace_back("FX", STRING, 0, fx_type_shortnames[sm]);
+            }
+
+            if (s.find("_filter") != std::string::npos && s.find("_type") != std::string::npos &&
+                t.intAttribute("value", sm) && sm > 0 && sm < sst::filters::num_filter_types)
+            {
+                res.emplace_back("FILTER", STRING, 0, sst::filters::filter_type_names[sm]);
+            }
+        }
+    };
+
     /*
      * Functions for the write thread
      */
     std::atomic<bool> waiting{false};
     void loadQueueFunction()
     {
-        static constexpr auto transChunkSize = 10; // How many FXP to load in a single txn
+        // How many FXP to load in a single txn. The parse happens before the txn opens, so
+        // this only bounds how long we hold the write lock, and bigger is much faster.
+        static constexpr auto transChunkSize = 256;
         int lock_retries{0};
         while (keepRunning)
         {
@@ -660,6 +1007,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
                 {
                     if (dbh)
                         closeDb();
+                    parsePool.reset();
                     waiting = true;
                     qCV.wait(lk);
                     waiting = false;
@@ -676,6 +1024,8 @@ CREATE TABLE IF NOT EXISTS Favorites (
             }
             if (!doThis.empty())
             {
+                parseFXPs(doThis);
+
                 if (!dbh)
                     openDb();
                 if (dbh == nullptr)
@@ -736,9 +1086,124 @@ CREATE TABLE IF NOT EXISTS Favorites (
         }
     }
 
-    void parseFXPIntoDB(const EnQPatch &p)
+    /*
+     * Read, validate and feature-extract every patch in a batch before we open the txn.
+     * This is the expensive part of an index pass and it is independent per file, so
+     * spread it over a small pool and leave only the inserts on this thread.
+     */
+    std::unique_ptr<Surge::Threading::RenderWorkerPool> parsePool;
+
+    void parseFXPs(const std::vector<EnQAble *> &items)
+    {
+        std::vector<EnQPatch *> patches;
+
+        for (auto *i : items)
+        {
+            auto *p = dynamic_cast<EnQPatch *>(i);
+
+            if (p && !p->parsed.done)
+                patches.push_back(p);
+        }
+
+        if (patches.size() > 1 && !parsePool)
+        {
+            auto hw = (int)std::thread::hardware_concurrency();
+            parsePool = std::make_unique<Surge::Threading::RenderWorkerPool>(std::max(hw - 1, 0));
+        }
+
+        if (patches.size() > 1)
+        {
+            parsePool->runAll(
+                (int)patches.size(),
+                [](void *ctx, int idx) {
+                    auto *ps = static_cast<std::vector<EnQPatch *> *>(ctx);
+                    parseFXP(*(*ps)[idx]);
+                },
+                &patches);
+        }
+        else
+        {
+            for (auto *p : patches)
+                parseFXP(*p);
+        }
+    }
+
+#pragma pack(push, 1)
+    struct patch_header
+    {
+        char tag[4];
+        unsigned int xmlsize,
+            wtsize[2][3]; // TODO: FIX SCENE AND OSC COUNT ASSUMPTION (but also since
+        // it's used in streaming, do it with care!)
+    };
+
+    struct fxChunkSetCustom
+    {
+        int chunkMagic; // 'CcnK'
+        int byteSize;   // of this chunk, excl. magic + byteSize
+
+        int fxMagic; // 'FPCh'
+        int version;
+        int fxID; // fx unique id
+        int fxVersion;
+
+        int numPrograms;
+        char prgName[28];
+
+        int chunkSize;
+        // char chunk[8]; // variable
+    };
+
+    struct FXPHead
+    {
+        fxChunkSetCustom fxp;
+        patch_header ph;
+    };
+#pragma pack(pop)
+
+    /*
+     * Reads only the headers of an FXP and checks them, leaving stream at the start of the
+     * patch XML; the body is read as far as the feature scan needs.
+     */
+    static bool readFXPHead(std::istream &stream, const fs::path &path, size_t &xmlSize)
     {
-        sqlite3_stmt *insertStmt = nullptr, *insfeatureStmt = nullptr, *dropIdStmt = nullptr;
+        FXPHead head;
+
+        if (!stream.read((char *)&head, sizeof(head)))
+        {
+            return false;
+        }
+
+        auto *fxp = &head.fxp;
+        if ((mech::endian_read_int32BE(fxp->chunkMagic) != 'CcnK') ||
+            (mech::endian_read_int32BE(fxp->fxMagic) != 'FPCh') ||
+            (mech::endian_read_int32BE(fxp->fxID) != 'cjs3'))
+        {
+            return false;
+        }
+
+        auto *ph = &head.ph;
+        auto xmlSz = mech::endian_read_int32LE(ph->xmlsize);
+        std::error_code ec;
+        auto fileSize = fs::file_size(path, ec);
+        if (ec)
+            return false;
+        auto xmlAvail = fileSize - sizeof(head);
+
+        if (!memcpy(ph->tag, "sub3", 4) || xmlSz < 0 || (size_t)xmlSz > xmlAvail)
+        {
+            std::cerr << "Skipping invalid patch : [" << path.u8string() << "]" << std::endl;
+            return false;
+        }
+
+        xmlSize = xmlSz;
+        return true;
+    }
+
+    static void parseFXP(EnQPatch &p)
+    {
+        auto &res = p.parsed;
+        res.done = true;
 
         if (!fs::exists(p.path))
         {
@@ -747,11 +1212,44 @@ CREATE TABLE IF NOT EXISTS Favorites (
 #endif
             return;
         }
+
+        res.exists = true;
+
         // Check with
         auto qtime = fs::last_write_time(p.path);
-        int64_t qtimeInt =
+        res.lastWriteTime =
             std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch()).count();
 
+        std::ifstream stream(p.path, std::ios::in | std::ios::binary);
+        size_t xmlSz;
+
+        if (!readFXPHead(stream, p.path, xmlSz))
+            return;
+
+        res.valid = true;
+
+        FeatureScanner scanner(stream, xmlSz);
+        if (scanner.scan(res.features))
+            return;
+
+        // the scan couldn't vouch for this one, so parse all of it
+        res.features.clear();
+        while (scanner.readMore())
+        {
+        }
+        res.features = extractFeaturesFromXML(scanner.buf);
+    }
+
+    void parseFXPIntoDB(EnQPatch &p)
+    {
+        if (!p.parsed.done)
+            parseFXP(p);
+
+        if (!p.parsed.exists)
+            return;
+
+        int64_t qtimeInt = p.parsed.lastWriteTime;
+
         bool patchLoaded = false;
         std::vector<int> dropIds;
         try
@@ -798,6 +1296,19 @@ CREATE TABLE IF NOT EXISTS Favorites (
                 }
 
                 dropF.finalize();
+
+                auto dropS = SQL::Statement(dbh, "DELETE FROM PatchSearch WHERE rowid=?1;");
+                for (auto did : dropIds)
+                {
+                    dropS.bind(1, did);
+                    while (dropS.step())
+                    {
+                    }
+                    dropS.clearBindings();
+                    dropS.reset();
+                }
+
+                dropS.finalize();
             }
         }
         catch (const SQL::Exception &e)
@@ -838,58 +1349,10 @@ CREATE TABLE IF NOT EXISTS Favorites (
         std::ostringstream searchName;
         searchName << p.name << " ";
 
-        std::ifstream stream(p.path, std::ios::in | std::ios::binary);
-        std::vector<uint8_t> contents((std::istreambuf_iterator<char>(stream)),
-                                      std::istreambuf_iterator<char>());
+        std::string author, comment, tags;
 
-#pragma pack(push, 1)
-        struct patch_header
-        {
-            char tag[4];
-            unsigned int xmlsize,
-                wtsize[2][3]; // TODO: FIX SCENE AND OSC COUNT ASSUMPTION (but also since
-            // it's used in streaming, do it with care!)
-        };
-
-        struct fxChunkSetCustom
-        {
-            int chunkMagic; // 'CcnK'
-            int byteSize;   // of this chunk, excl. magic + byteSize
-
-            int fxMagic; // 'FPCh'
-            int version;
-            int fxID; // fx unique id
-            int fxVersion;
-
-            int numPrograms;
-            char prgName[28];
-
-            int chunkSize;
-            // char chunk[8]; // variable
-        };
-#pragma pack(pop)
-
-        uint8_t *d = contents.data();
-        auto *fxp = (fxChunkSetCustom *)d;
-        if ((mech::endian_read_int32BE(fxp->chunkMagic) != 'CcnK') ||
-            (mech::endian_read_int32BE(fxp->fxMagic) != 'FPCh') ||
-            (mech::endian_read_int32BE(fxp->fxID) != 'cjs3'))
-        {
+        if (!p.parsed.valid)
             return;
-        }
-
-        auto phd = d + sizeof(fxChunkSetCustom);
-        auto *ph = (patch_header *)phd;
-        auto xmlSz = mech::endian_read_int32LE(ph->xmlsize);
-
-        if (!memcpy(ph->tag, "sub3", 4) || xmlSz < 0 || xmlSz > 1024 * 1024 * 1024)
-        {
-            std::cerr << "Skipping invalid patch : [" << p.path.u8string() << "]" << std::endl;
-            return;
-        }
-
-        auto xd = phd + sizeof(patch_header);
-        std::string xml(xd, xd + xmlSz);
 
         try
         {
@@ -897,8 +1360,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
                 SQL::Statement(dbh, "INSERT INTO PATCHFEATURE ( \"patch_id\", \"feature\", "
                                     "\"feature_type\", \"feature_ivalue\", \"feature_svalue\" ) "
                                     "VALUES ( ?1, ?2, ?3, ?4, ?5 )");
-            auto feat = extractFeaturesFromXML(xml);
-            for (auto f : feat)
+            for (const auto &f : p.parsed.features)
             {
                 auto ftype = std::get<0>(f);
                 ins.bindi64(1, patchid);
@@ -914,6 +1376,15 @@ CREATE TABLE IF NOT EXISTS Favorites (
                 if (ftype == "TAG")
                 {
                     searchName << " " << std::get<3>(f);
+                    tags += (tags.empty() ? "" : " ") + std::get<3>(f);
+                }
+                else if (ftype == "AUTHOR")
+                {
+                    author = std::get<3>(f);
+                }
+                else if (ftype == "COMMENT")
+                {
+                    comment = std::get<3>(f);
                 }
             }
 
@@ -940,6 +1411,27 @@ CREATE TABLE IF NOT EXISTS Favorites (
             storage->reportError(e.what(), "PatchDB - FXP Features");
             return;
         }
+
+        try
+        {
+            auto ins = SQL::Statement(dbh, "INSERT INTO PatchSearch ( rowid, name, author, "
+                                           "category, comment, tags ) "
+                                           "VALUES ( ?1, ?2, ?3, ?4, ?5, ?6 )");
+            ins.bindi64(1, patchid);
+            ins.bind(2, p.name);
+            ins.bind(3, author);
+            ins.bind(4, p.catname);
+            ins.bind(5, comment);
+            ins.bind(6, tags);
+
+            ins.step();
+            ins.finalize();
+        }
+        catch (const SQL::Exception &e)
+        {
+            storage->reportError(e.what(), "PatchDB - FXP Search Index");
+            return;
+        }
     }
 
     void setFavorite(const std::string &p, bool v)
@@ -980,6 +1472,11 @@ CREATE TABLE IF NOT EXISTS Favorites (
             feat.bind(1, id);
             feat.step();
             feat.finalize();
+
+            auto srch = SQL::Statement(dbh, "DELETE FROM PatchSearch where rowid=?");
+            srch.bind(1, id);
+            srch.step();
+            srch.finalize();
         }
         catch (const SQL::Exception &e)
         {
@@ -1143,8 +1640,208 @@ CREATE TABLE IF NOT EXISTS Favorites (
     sqlite3 *dbh{nullptr};
     SurgeStorage *storage;
 };
+// language=SQL
+static constexpr const char *nameLikeQuery =
+    "select p.id, p.path, p.category, p.name, pf.feature_svalue from Patches "
+    "as p, PatchFeature as pf where pf.patch_id == p.id and pf.feature LIKE "
+    "'AUTHOR' and p.name LIKE ? ORDER BY p.category_type, p.category, p.name";
+
+/*
+ * Runs browser queries off the message thread, on its own read only connection (the shared
+ * one is opened NOMUTEX and belongs to whoever calls the synchronous query APIs). Only the
+ * latest request matters: submitting a new one supersedes whatever is queued or running, and a
+ * running query stops at its next page.
+ */
+struct PatchDB::ReaderWorker
+{
+    struct Request
+    {
+        std::string nameLike;
+        size_t pageSize{256};
+        pageCallback_t onPage;
+    };
+
+    ReaderWorker(const std::string &dbname, SurgeStorage *storage)
+        : dbname(dbname), storage(storage)
+    {
+        qThread = std::thread([this]() { this->run(); });
+    }
+
+    ~ReaderWorker()
+    {
+        {
+            std::lock_guard<std::mutex> g(qLock);
+            keepRunning = false;
+        }
+        qCV.notify_all();
+        qThread.join();
+
+        if (rodbh)
+            sqlite3_close(rodbh);
+        rodbh = nullptr;
+    }
+
+    void submit(Request &&r)
+    {
+        {
+            std::lock_guard<std::mutex> g(qLock);
+            pending = std::move(r);
+            hasPending = true;
+            generation++;
+        }
+        qCV.notify_all();
+    }
+
+    void run()
+    {
+        while (true)
+        {
+            Request r;
+            uint64_t gen;
+
+            {
+                std::unique_lock<std::mutex> l(qLock);
+                qCV.wait(l, [this]() { return hasPending || !keepRunning; });
+
+                if (!keepRunning)
+                    return;
+
+                r = std::move(pending);
+                hasPending = false;
+                gen = generation;
+            }
+
+            execute(r, gen);
+        }
+    }
+
+    bool superseded(uint64_t gen) const { return generation != gen || !keepRunning; }
+
+    void execute(Request &r, uint64_t gen)
+    {
+        if (!rodbh)
+        {
+            auto flag = SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_READONLY;
+
+            if (sqlite3_open_v2(dbname.c_str(), &rodbh, flag, nullptr) != SQLITE_OK)
+            {
+                if (rodbh)
+                    sqlite3_close(rodbh);
+                rodbh = nullptr;
+            }
+        }
+
+        if (!rodbh)
+        {
+            r.onPage({}, true);
+            return;
+        }
+
+        std::vector<patchRecord> page;
+        auto pageSize = std::max(r.pageSize, (size_t)1);
+
+        try
+        {
+            auto q = SQL::Statement(rodbh, nameLikeQuery);
+            std::string nameLikeThis = "%" + r.nameLike + "%";
+            q.bind(1, nameLikeThis);
+
+            while (q.step())
+            {
+                page.emplace_back(q.col_int(0), q.col_str(1), q.col_str(2), q.col_str(3),
+                                  q.col_str(4));
+
+                if (page.size() == pageSize)
+                {
+                    if (superseded(gen))
+                    {
+                        q.finalize();
+                        return;
+                    }
+
+                    r.onPage(std::move(page), false);
+                    page = {};
+                }
+            }
+
+            q.finalize();
+        }
+        catch (SQL::Exception &e)
+        {
+            if (e.rc != SQLITE_BUSY)
+            {
+                storage->reportError(e.what(), "PatchDB - queryForNameLikeAsync");
+            }
+        }
+
+        if (!superseded(gen))
+        {
+            r.onPage(std::move(page), true);
+        }
+    }
+
+    std::string dbname;
+    SurgeStorage *storage;
+    sqlite3 *rodbh{nullptr};
+
+    std::thread qThread;
+    std::mutex qLock;
+    std::condition_variable qCV;
+    Request pending;
+    bool hasPending{false};
+    std::atomic<bool> keepRunning{true};
+    std::atomic<uint64_t> generation{0};
+};
+
 PatchDB::PatchDB(SurgeStorage *s) : storage(s) { initialize(); }
 
+static void scanFeatures(std::istream &stream, size_t xmlSize, std::vector<std::string> &scanned,
+                         std::vector<std::string> &parsed, bool &vouched)
+{
+    auto asStrings = [](const std::vector<PatchDB::WriterWorker::feature> &fs) {
+        std::vector<std::string> res;
+        for (auto &[name, type, i, str] : fs)
+            res.push_back(name + "=" +
+                          (type == PatchDB::WriterWorker::INT ? std::to_string(i) : str));
+        return res;
+    };
+
+    PatchDB::WriterWorker::FeatureScanner scanner(stream, xmlSize);
+    std::vector<PatchDB::WriterWorker::feature> quick;
+    vouched = scanner.scan(quick);
+
+    while (scanner.readMore())
+    {
+    }
+
+    scanned = vouched ? asStrings(quick) : std::vector<std::string>();
+    parsed = asStrings(PatchDB::WriterWorker::extractFeaturesFromXML(scanner.buf));
+}
+
+bool PatchDB::scanFeaturesForTesting(const fs::path &fxp, std::vector<std::string> &scanned,
+                                     std::vector<std::string> &parsed)
+{
+    std::ifstream stream(fxp, std::ios::in | std::ios::binary);
+    size_t xmlSize;
+    bool vouched{false};
+
+    if (WriterWorker::readFXPHead(stream, fxp, xmlSize))
+        scanFeatures(stream, xmlSize, scanned, parsed, vouched);
+
+    return vouched;
+}
+
+bool PatchDB::scanXMLFeaturesForTesting(const std::string &xml,
+                                        std::vector<std::string> &scanned,
+                                        std::vector<std::string> &parsed)
+{
+    std::istringstream stream(xml);
+    bool vouched{false};
+
+    scanFeatures(stream, xml.size(), scanned, parsed, vouched);
+    return vouched;
+}
+
 PatchDB::~PatchDB() = default;
 
 void PatchDB::initialize()
@@ -1256,10 +1953,7 @@ std::vector<PatchDB::patchRecord> PatchDB::rawQueryForNameLike(const std::string
 {
     std::vector<PatchDB::patchRecord> res;
 
-    // FIXME - cache this by pushing it to the worker
-    std::string query = "select p.id, p.path, p.category, p.name, pf.feature_svalue from Patches "
-                        "as p, PatchFeature as pf where pf.patch_id == p.id and pf.feature LIKE "
-                        "'AUTHOR' and p.name LIKE ? ORDER BY p.category_type, p.category, p.name";
+    std::string query = nameLikeQuery;
 
     try
     {
@@ -1298,6 +1992,15 @@ std::vector<PatchDB::patchRecord> PatchDB::rawQueryForNameLike(const std::string
     return res;
 }
 
+void PatchDB::queryForNameLikeAsync(const std::string &nameLikeThis, size_t pageSize,
+                                    pageCallback_t onPage)
+{
+    if (!reader)
+        reader = std::make_unique<ReaderWorker>(worker->dbname, storage);
+
+    reader->submit({nameLikeThis, pageSize, std::move(onPage)});
+}
+
 std::vector<PatchDB::catRecord> PatchDB::rootCategoriesForType(const CatType t)
 {
     std::string query = "select c.id, c.name, c.leaf_name, c.isroot, c.type from Category "
@@ -1456,8 +2159,90 @@ int PatchDB::waitForJobsOutstandingComplete(int maxWaitInMS)
     return numberOfJobsOutstanding();
 }
 
+/*
+ * Turn a query subtree into a single FTS5 MATCH expression over PatchSearch. Every literal
+ * becomes a prefix phrase, so typing "sa" finds "Saw Lead". Returns false if part of the
+ * tree can't be expressed (unknown keywords, literals with nothing to tokenize), in which
+ * case the caller builds that part of the clause node by node instead.
+ */
+static bool ftsMatchFor(const std::unique_ptr<PatchDBQueryParser::Token> &t, std::string &res)
+{
+    auto phrase = [](const std::string &s, std::string &out) {
+        bool hasWord = false;
+        std::string q = "\"";
+        for (auto c : s)
+        {
+            if (std::isalnum((unsigned char)c) || (unsigned char)c >= 0x80)
+                hasWord = true;
+            if (c == '"')
+                q += '"';
+            q += c;
+        }
+        q += "\"*";
+
+        if (hasWord)
+            out = q;
+        return hasWord;
+    };
+
+    switch (t->type)
+    {
+    case PatchDBQueryParser::LITERAL:
+        return phrase(t->content, res);
+    case PatchDBQueryParser::KEYWORD_EQUALS:
+    {
+        std::string col, ph;
+        if (t->content == "AUTHOR" || t->content == "AUTH")
+            col = "author";
+        else if (t->content == "CATEGORY" || t->content == "CAT")
+            col = "category";
+
+        if (col.empty() || !phrase(t->children[0]->content, ph))
+            return false;
+
+        res = col + " : " + ph;
+        return true;
+    }
+    case PatchDBQueryParser::AND:
+    case PatchDBQueryParser::OR:
+    {
+        if (t->children.empty())
+            return false;
+
+        std::string acc = "( ", inter = "";
+        for (auto &c : t->children)
+        {
+            std::string cres;
+            if (!ftsMatchFor(c, cres))
+                return false;
+
+            acc += inter + cres;
+            inter = t->type == PatchDBQueryParser::AND ? " AND " : " OR ";
+        }
+        res = acc + " )";
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
 std::string PatchDB::sqlWhereClauseFor(const std::unique_ptr<PatchDBQueryParser::Token> &t)
 {
+    std::string match;
+    if (ftsMatchFor(t, match))
+    {
+        std::string quoted;
+        for (auto c : match)
+        {
+            if (c == '\'')
+                quoted += '\'';
+            quoted += c;
+        }
+        return "( p.id IN ( SELECT rowid FROM PatchSearch WHERE PatchSearch MATCH '" + quoted +
+               "' ) )";
+    }
+
     auto protect = [](const std::string &s) -> std::string {
         std::vector<std::pair<std::string, std::string>> replacements{{"'", "''"}, {"%", "%%"}};
         auto res = s;
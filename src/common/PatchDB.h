@@ -27,6 +27,9 @@
 #include <deque>
 #include <unordered_map>
 #include <condition_variable>
+#include <atomic>
+#include <mutex>
+#include <memory>
 #include "filesystem/import.h"
 #include <iostream>
 #include <vector>
@@ -110,6 +113,9 @@ struct PatchDB
 
     std::unique_ptr<WriterWorker> worker;
 
+    struct ReaderWorker;
+    std::unique_ptr<ReaderWorker> reader;
+
     // Write APIs
     void considerFXPForLoad(const fs::path &fxp, const std::string &name,
                             const std::string &catName, const CatType type) const;
@@ -150,9 +156,30 @@ struct PatchDB
 
     // This is a temporary API point
     std::vector<patchRecord> rawQueryForNameLike(const std::string &nameLikeThis);
+
+    /*
+     * The same query, run on a reader thread and handed back pageSize rows at a time so a
+     * browser can show the first rows of a huge library at once. onPage is called on the reader
+     * thread, with last set on the final page (which may be empty). A newer call supersedes an
+     * older one, whose remaining pages are simply never delivered.
+     */
+    typedef std::function<void(std::vector<patchRecord> &&page, bool last)> pageCallback_t;
+    void queryForNameLikeAsync(const std::string &nameLikeThis, size_t pageSize,
+                               pageCallback_t onPage);
     std::vector<catRecord> rootCategoriesForType(const CatType t);
     std::vector<catRecord> childCategoriesOf(int catId);
 
+    /*
+     * For the test runner: the features the index's quick scan and the full XML parse find in
+     * a patch, each as "NAME=value". Returns whether the quick scan vouched for its result;
+     * scanned is left empty when it fell back to the full parse.
+     */
+    static bool scanFeaturesForTesting(const fs::path &fxp, std::vector<std::string> &scanned,
+                                       std::vector<std::string> &parsed);
+    static bool scanXMLFeaturesForTesting(const std::string &xml,
+                                          std::vector<std::string> &scanned,
+                                          std::vector<std::string> &parsed);
+
   private:
     std::vector<catRecord> internalCategories(int arg, const std::string &query);
 };
@@ -0,0 +1,117 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_PATCHLOADPROFILE_H
+#define SURGE_SRC_COMMON_PATCHLOADPROFILE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Surge
+{
+namespace Profiling
+{
+/*
+ * Where the time goes when a patch loads. SurgeSynthesizer::loadRaw starts a new profile, and
+ * from then on each phase adds its wall time as it happens, on whichever thread runs it.
+ * lp_load is the whole of loadRaw, so it contains the XML parse, the FX setup and any
+ * wavetables embedded in the patch. Wavetables the patch only names are built later on the
+ * audio or loader thread, oscillator type changes and formula compiles happen on the audio
+ * thread as blocks and voices need them, and lp_firstBlock is the whole of the first block
+ * rendered after the load.
+ *
+ * Everything is a relaxed atomic, so any thread may read a profile while it is still filling
+ * in. A Scope reads a steady clock twice, which is cheap next to any of the work it brackets.
+ */
+struct PatchLoadProfile
+{
+    enum Phase
+    {
+        lp_load = 0,
+        lp_parse,
+        lp_wavetables,
+        lp_fx,
+        lp_oscillators,
+        lp_formulas,
+        lp_firstBlock,
+
+        n_load_phases
+    };
+
+    static const char *phaseName(int phase)
+    {
+        static constexpr const char *names[n_load_phases] = {
+            "load", "parse", "wavetables", "fx", "oscillators", "formulas", "first-block"};
+        return phase >= 0 && phase < n_load_phases ? names[phase] : "unknown";
+    }
+
+    struct Scope
+    {
+        Scope(PatchLoadProfile &p, Phase phase, bool enabled = true)
+            : profile(p), phase(phase), running(enabled)
+        {
+            if (running)
+                start = std::chrono::steady_clock::now();
+        }
+        ~Scope()
+        {
+            if (running)
+                profile.add(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - start)
+                                       .count());
+        }
+
+        PatchLoadProfile &profile;
+        Phase phase;
+        bool running;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    void begin()
+    {
+        for (auto &n : ns)
+            n.store(0, std::memory_order_relaxed);
+        firstBlockPending.store(false, std::memory_order_relaxed);
+        loads.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // called once the load is done; the next block rendered is timed as lp_firstBlock
+    void armFirstBlock() { firstBlockPending.store(true, std::memory_order_relaxed); }
+    bool takeFirstBlock() { return firstBlockPending.exchange(false, std::memory_order_relaxed); }
+
+    void add(Phase phase, int64_t t) { ns[phase].fetch_add(t, std::memory_order_relaxed); }
+    int64_t getNs(Phase phase) const { return ns[phase].load(std::memory_order_relaxed); }
+    double getMs(Phase phase) const { return getNs(phase) * 1e-6; }
+
+    // how many loads have started, so a reader can tell one profile from the next
+    uint64_t getLoadCount() const { return loads.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<int64_t> ns[n_load_phases]{};
+    std::atomic<bool> firstBlockPending{false};
+    std::atomic<uint64_t> loads{0};
+};
+} // namespace Profiling
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_PATCHLOADPROFILE_H
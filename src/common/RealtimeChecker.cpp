@@ -0,0 +1,418 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#if SURGE_RT_CHECKS
+// the fortified inline wrappers for open, read and so on would clash with the hooks below
+#undef _FORTIFY_SOURCE
+#endif
+
+#include "RealtimeChecker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <sstream>
+
+#if SURGE_RT_CHECKS && (MAC || LINUX)
+#define SURGE_RT_HOOK_NEW 1
+#include <execinfo.h>
+#include <new>
+#endif
+
+#if SURGE_RT_CHECKS && LINUX && defined(__GLIBC__)
+#define SURGE_RT_HOOK_LIBC 1
+#include <cstdarg>
+#include <cstdio>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if SURGE_RT_HOOK_NEW
+// the hooks run inside malloc, so the thread locals must never need malloc to exist
+#define SURGE_RT_TLS __attribute__((tls_model("initial-exec"))) thread_local
+#else
+#define SURGE_RT_TLS thread_local
+#endif
+
+namespace Surge
+{
+namespace Debug
+{
+namespace
+{
+static constexpr int maxStacks = 512;
+static constexpr int maxFrames = 32;
+
+struct Record
+{
+    RealtimeChecker::Kind kind;
+    uint64_t hash;
+    size_t bytes;
+    int nFrames;
+    void *frames[maxFrames];
+    std::atomic<uint64_t> count;
+};
+
+Record records[maxStacks];
+std::atomic<int> nRecords{0};
+std::atomic<uint64_t> kindCounts[RealtimeChecker::n_rt_kinds]{};
+std::atomic<uint64_t> droppedStacks{0};
+
+// a spin lock rather than a mutex, since a mutex is one of the things we're watching for
+std::atomic_flag recordsLock = ATOMIC_FLAG_INIT;
+
+SURGE_RT_TLS int scopeDepth{0};
+SURGE_RT_TLS int allowDepth{0};
+SURGE_RT_TLS bool inFlag{false};
+
+#if SURGE_RT_HOOK_NEW
+// glibc's backtrace loads libgcc on first use, which allocates; get that over with now
+const int backtracePrimed = []() {
+    void *f[2];
+    return backtrace(f, 2);
+}();
+#endif
+} // namespace
+
+const char *RealtimeChecker::kindName(Kind k)
+{
+    switch (k)
+    {
+    case rt_allocation:
+        return "allocation";
+    case rt_lock:
+        return "lock";
+    case rt_fileIO:
+        return "file i/o";
+    default:
+        break;
+    }
+
+    return "unknown";
+}
+
+RealtimeChecker::Scope::Scope() { scopeDepth++; }
+RealtimeChecker::Scope::~Scope() { scopeDepth--; }
+RealtimeChecker::Allow::Allow() { allowDepth++; }
+RealtimeChecker::Allow::~Allow() { allowDepth--; }
+
+bool RealtimeChecker::isChecking() { return scopeDepth > 0 && allowDepth == 0 && !inFlag; }
+
+void RealtimeChecker::flag(Kind k, size_t bytes)
+{
+    if (!isChecking())
+        return;
+
+    inFlag = true;
+    kindCounts[k].fetch_add(1, std::memory_order_relaxed);
+
+#if SURGE_RT_HOOK_NEW
+    void *frames[maxFrames];
+    // skip flag itself and the hook which called it
+    auto n = std::max(0, backtrace(frames, maxFrames) - 2);
+    auto *f = frames + 2;
+#else
+    void **f = nullptr;
+    int n = 0;
+#endif
+
+    uint64_t hash = 14695981039346656037ULL ^ (uint64_t)k;
+    for (int i = 0; i < n; ++i)
+        hash = (hash ^ (uint64_t)(uintptr_t)f[i]) * 1099511628211ULL;
+
+    while (recordsLock.test_and_set(std::memory_order_acquire))
+    {
+    }
+
+    auto nr = nRecords.load(std::memory_order_relaxed);
+    bool found = false;
+
+    for (int i = 0; i < nr && !found; ++i)
+    {
+        if (records[i].hash == hash && records[i].kind == k)
+        {
+            records[i].count.fetch_add(1, std::memory_order_relaxed);
+            found = true;
+        }
+    }
+
+    if (!found && nr < maxStacks)
+    {
+        auto &r = records[nr];
+        r.kind = k;
+        r.hash = hash;
+        r.bytes = bytes;
+        r.nFrames = n;
+        std::copy(f, f + n, r.frames);
+        r.count.store(1, std::memory_order_relaxed);
+        nRecords.store(nr + 1, std::memory_order_release);
+    }
+    else if (!found)
+    {
+        droppedStacks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    recordsLock.clear(std::memory_order_release);
+    inFlag = false;
+}
+
+uint64_t RealtimeChecker::getViolationCount()
+{
+    uint64_t res = 0;
+    for (auto &c : kindCounts)
+        res += c.load(std::memory_order_relaxed);
+    return res;
+}
+
+uint64_t RealtimeChecker::getViolationCount(Kind k)
+{
+    return kindCounts[k].load(std::memory_order_relaxed);
+}
+
+std::vector<std::string> RealtimeChecker::report()
+{
+    std::vector<std::pair<uint64_t, std::string>> entries;
+    auto nr = nRecords.load(std::memory_order_acquire);
+
+    for (int i = 0; i < nr; ++i)
+    {
+        auto &r = records[i];
+        auto count = r.count.load(std::memory_order_relaxed);
+
+        std::ostringstream oss;
+        oss << kindName(r.kind) << " x" << count;
+        if (r.kind == rt_allocation && r.bytes > 0)
+            oss << " (first " << r.bytes << " bytes)";
+
+#if SURGE_RT_HOOK_NEW
+        auto **syms = backtrace_symbols(r.frames, r.nFrames);
+        for (int f = 0; syms && f < r.nFrames; ++f)
+            oss << "\n  [" << f << "] " << syms[f];
+        free(syms);
+#endif
+        entries.emplace_back(count, oss.str());
+    }
+
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    std::vector<std::string> res;
+    for (auto &e : entries)
+        res.push_back(std::move(e.second));
+
+    if (auto d = droppedStacks.load(std::memory_order_relaxed))
+        res.push_back(std::to_string(d) + " more violations from stacks past the first " +
+                      std::to_string(maxStacks));
+
+    return res;
+}
+
+void RealtimeChecker::clear()
+{
+    while (recordsLock.test_and_set(std::memory_order_acquire))
+    {
+    }
+
+    nRecords.store(0, std::memory_order_release);
+    droppedStacks.store(0, std::memory_order_relaxed);
+    for (auto &c : kindCounts)
+        c.store(0, std::memory_order_relaxed);
+
+    recordsLock.clear(std::memory_order_release);
+}
+} // namespace Debug
+} // namespace Surge
+
+#if SURGE_RT_HOOK_NEW
+using Surge::Debug::RealtimeChecker;
+
+/*
+ * The replacement operators. With the libc hooks below in play malloc flags for itself, so
+ * these only flag on macOS; on Linux they would count everything twice.
+ */
+#if SURGE_RT_HOOK_LIBC
+#define SURGE_RT_FLAG_NEW(bytes)
+#else
+#define SURGE_RT_FLAG_NEW(bytes) RealtimeChecker::flag(RealtimeChecker::rt_allocation, bytes)
+#endif
+
+static void *surgeRTNew(size_t n)
+{
+    SURGE_RT_FLAG_NEW(n);
+    if (auto *p = malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+static void *surgeRTNewAligned(size_t n, std::align_val_t al)
+{
+    SURGE_RT_FLAG_NEW(n);
+    void *p = nullptr;
+    auto a = std::max(sizeof(void *), (size_t)al);
+    if (posix_memalign(&p, a, n ? n : 1) == 0)
+        return p;
+    throw std::bad_alloc();
+}
+
+static void surgeRTDelete(void *p)
+{
+    if (!p)
+        return;
+    SURGE_RT_FLAG_NEW(0);
+    free(p);
+}
+
+void *operator new(size_t n) { return surgeRTNew(n); }
+void *operator new[](size_t n) { return surgeRTNew(n); }
+void *operator new(size_t n, std::align_val_t al) { return surgeRTNewAligned(n, al); }
+void *operator new[](size_t n, std::align_val_t al) { return surgeRTNewAligned(n, al); }
+
+void *operator new(size_t n, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return surgeRTNew(n);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+void *operator new[](size_t n, const std::nothrow_t &t) noexcept { return operator new(n, t); }
+
+void operator delete(void *p) noexcept { surgeRTDelete(p); }
+void operator delete[](void *p) noexcept { surgeRTDelete(p); }
+void operator delete(void *p, size_t) noexcept { surgeRTDelete(p); }
+void operator delete[](void *p, size_t) noexcept { surgeRTDelete(p); }
+void operator delete(void *p, std::align_val_t) noexcept { surgeRTDelete(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { surgeRTDelete(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { surgeRTDelete(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { surgeRTDelete(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { surgeRTDelete(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { surgeRTDelete(p); }
+#endif
+
+#if SURGE_RT_HOOK_LIBC
+/*
+ * glibc exports its allocator under these names too, so the malloc hooks can forward without
+ * a dlsym (which would itself want calloc). Everything else is found with dlsym on first use.
+ */
+extern "C"
+{
+    void *__libc_malloc(size_t);
+    void *__libc_calloc(size_t, size_t);
+    void *__libc_realloc(void *, size_t);
+    void __libc_free(void *);
+
+    void *malloc(size_t n) __THROW
+    {
+        RealtimeChecker::flag(RealtimeChecker::rt_allocation, n);
+        return __libc_malloc(n);
+    }
+
+    void *calloc(size_t n, size_t s) __THROW
+    {
+        RealtimeChecker::flag(RealtimeChecker::rt_allocation, n * s);
+        return __libc_calloc(n, s);
+    }
+
+    void *realloc(void *p, size_t n) __THROW
+    {
+        RealtimeChecker::flag(RealtimeChecker::rt_allocation, n);
+        return __libc_realloc(p, n);
+    }
+
+    void free(void *p) __THROW
+    {
+        if (p)
+            RealtimeChecker::flag(RealtimeChecker::rt_allocation);
+        __libc_free(p);
+    }
+}
+
+template <typename F> static F realFunction(std::atomic<F> &cache, const char *name)
+{
+    auto f = cache.load(std::memory_order_acquire);
+    if (!f)
+    {
+        f = (F)dlsym(RTLD_NEXT, name);
+        cache.store(f, std::memory_order_release);
+    }
+    return f;
+}
+
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t *m) __THROW
+    {
+        static std::atomic<int (*)(pthread_mutex_t *)> real{nullptr};
+        RealtimeChecker::flag(RealtimeChecker::rt_lock);
+        return realFunction(real, "pthread_mutex_lock")(m);
+    }
+
+    int open(const char *path, int flags, ...)
+    {
+        static std::atomic<int (*)(const char *, int, ...)> real{nullptr};
+        RealtimeChecker::flag(RealtimeChecker::rt_fileIO);
+
+        mode_t mode = 0;
+        if (flags & O_CREAT)
+        {
+            va_list args;
+            va_start(args, flags);
+            mode = va_arg(args, mode_t);
+            va_end(args);
+        }
+        return realFunction(real, "open")(path, flags, mode);
+    }
+
+    FILE *fopen(const char *path, const char *mode)
+    {
+        static std::atomic<FILE *(*)(const char *, const char *)> real{nullptr};
+        RealtimeChecker::flag(RealtimeChecker::rt_fileIO);
+        return realFunction(real, "fopen")(path, mode);
+    }
+
+    // iostreams write through this, std::cout included
+    size_t fwrite(const void *buf, size_t s, size_t n, FILE *f)
+    {
+        static std::atomic<size_t (*)(const void *, size_t, size_t, FILE *)> real{nullptr};
+        RealtimeChecker::flag(RealtimeChecker::rt_fileIO);
+        return realFunction(real, "fwrite")(buf, s, n, f);
+    }
+
+    ssize_t read(int fd, void *buf, size_t n)
+    {
+        static std::atomic<ssize_t (*)(int, void *, size_t)> real{nullptr};
+        RealtimeChecker::flag(RealtimeChecker::rt_fileIO);
+        return realFunction(real, "read")(fd, buf, n);
+    }
+
+    ssize_t write(int fd, const void *buf, size_t n)
+    {
+        static std::atomic<ssize_t (*)(int, const void *, size_t)> real{nullptr};
+        RealtimeChecker::flag(RealtimeChecker::rt_fileIO);
+        return realFunction(real, "write")(fd, buf, n);
+    }
+}
+#endif
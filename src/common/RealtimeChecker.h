@@ -0,0 +1,112 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_REALTIMECHECKER_H
+#define SURGE_SRC_COMMON_REALTIMECHECKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Build with SURGE_RT_CHECKS=1 (the SURGE_BUILD_WITH_RT_CHECKS cmake option) to have the audio
+ * path checked for things it must not do. This is a debug and CI mode: it replaces the global
+ * operator new and delete, and on Linux interposes malloc, pthread_mutex_lock and the basic
+ * file calls, so it is never on in a release.
+ */
+#ifndef SURGE_RT_CHECKS
+#define SURGE_RT_CHECKS 0
+#endif
+
+namespace Surge
+{
+namespace Debug
+{
+/*
+ * While a Scope is alive on a thread, every heap allocation or free, blocking mutex lock and
+ * file open, read or write that thread makes is recorded with the stack which made it. process()
+ * and the render pool jobs open one, so a test can drive the engine and then ask what it did.
+ *
+ * Where each hook is available:
+ *  - operator new and delete: Linux and macOS
+ *  - malloc and friends, mutex locks, file calls: Linux (glibc)
+ * Elsewhere, or without SURGE_RT_CHECKS, the scopes are free and nothing is ever recorded.
+ *
+ * Each distinct stack is kept once, with a count, so a violation made every block is one entry.
+ */
+struct RealtimeChecker
+{
+    enum Kind
+    {
+        rt_allocation = 0, // new, delete, malloc, free and the rest
+        rt_lock,           // a mutex lock which may block; try_lock is fine
+        rt_fileIO,         // open, fopen, read, write, fwrite (so std::cout too)
+
+        n_rt_kinds
+    };
+
+    static constexpr bool isCompiledIn() { return SURGE_RT_CHECKS != 0; }
+    static const char *kindName(Kind k);
+
+    struct Scope
+    {
+        Scope();
+        ~Scope();
+    };
+
+    // for the few places which knowingly do one of these things on the audio thread
+    struct Allow
+    {
+        Allow();
+        ~Allow();
+    };
+
+    // whether the calling thread is in a Scope and not in an Allow
+    static bool isChecking();
+
+    // called by the hooks; does nothing unless isChecking
+    static void flag(Kind k, size_t bytes = 0);
+
+    static uint64_t getViolationCount();
+    static uint64_t getViolationCount(Kind k);
+
+    // one entry per distinct stack, symbolized, most frequent first. not from a Scope
+    static std::vector<std::string> report();
+    static void clear();
+};
+} // namespace Debug
+} // namespace Surge
+
+#if SURGE_RT_CHECKS
+#define SURGE_RT_CONCAT_INNER(a, b) a##b
+#define SURGE_RT_CONCAT(a, b) SURGE_RT_CONCAT_INNER(a, b)
+#define SURGE_REALTIME_SCOPE                                                                       \
+    Surge::Debug::RealtimeChecker::Scope SURGE_RT_CONCAT(surgeRealtimeScope, __LINE__)
+#define SURGE_REALTIME_ALLOW                                                                       \
+    Surge::Debug::RealtimeChecker::Allow SURGE_RT_CONCAT(surgeRealtimeAllow, __LINE__)
+#else
+#define SURGE_REALTIME_SCOPE
+#define SURGE_REALTIME_ALLOW
+#endif
+
+#endif // SURGE_SRC_COMMON_REALTIMECHECKER_H
@@ -0,0 +1,215 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "RenderWorkerPool.h"
+#include "RealtimeChecker.h"
+#include <algorithm>
+#include <chrono>
+
+#include "sst/plugininfra/cpufeatures.h"
+
+namespace Surge
+{
+namespace Threading
+{
+// how many times an idle worker yields before it goes to sleep on the condition variable
+static constexpr int idleSpins = 20000;
+
+// a sleeping worker only wakes on its own if a wakeup was missed; see wakeWorkers
+static constexpr auto missedWakeupTimeout = std::chrono::milliseconds(100);
+
+RenderWorkerPool::RenderWorkerPool(int nWorkers, bool spinWhenIdle)
+    : spinsBeforeSleep(spinWhenIdle ? idleSpins : 0)
+{
+    for (int i = 0; i < nWorkers; ++i)
+    {
+        threads.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> g(sleepMutex);
+        keepRunning = false;
+    }
+    sleepCV.notify_all();
+
+    for (auto &t : threads)
+    {
+        if (t.joinable())
+            t.join();
+    }
+}
+
+void RenderWorkerPool::runAll(int n, job_t job, void *ctx)
+{
+    if (n <= 0)
+        return;
+
+    if ((threads.empty() && !executor) || n == 1)
+    {
+        for (int i = 0; i < n; ++i)
+            job(ctx, i);
+        return;
+    }
+
+    start(n, job, ctx);
+    finish();
+}
+
+void RenderWorkerPool::start(int n, job_t job, void *ctx)
+{
+    pending = std::max(n, 0);
+
+    if (!pending)
+        return;
+
+    currentJob = job;
+    currentCtx = ctx;
+    currentCount.store(n, std::memory_order_relaxed);
+    completed.store(0, std::memory_order_relaxed);
+
+    round++;
+    roundAndIndex.store((uint64_t)round << 32, std::memory_order_release);
+
+    if (!(executor && executor(executorCtx, this, n)) && !threads.empty())
+        wakeWorkers();
+}
+
+void RenderWorkerPool::finish()
+{
+    if (!pending)
+        return;
+
+    while (runOneFrom(round))
+    {
+    }
+
+    // anything left is already running on a worker
+    while (completed.load(std::memory_order_acquire) < pending)
+    {
+        std::this_thread::yield();
+    }
+
+    pending = 0;
+}
+
+void RenderWorkerPool::wakeWorkers()
+{
+    /*
+     * We mustn't block here, but when the lock is free, notifying under it means no worker can
+     * be between checking for a round and going to sleep, so the wakeup can't be lost. If a
+     * worker holds it right now we notify anyway, and in the rare case that misses, the
+     * caller's finish does the work and the sleep's timeout catches the worker up.
+     */
+    if (sleepMutex.try_lock())
+    {
+        sleepCV.notify_all();
+        sleepMutex.unlock();
+    }
+    else
+    {
+        sleepCV.notify_all();
+    }
+}
+
+void RenderWorkerPool::runPending()
+{
+    // host threads haven't necessarily got the flush-to-zero mode process() runs with
+    auto fpuguard = sst::plugininfra::cpufeatures::FPUStateGuard();
+
+    auto r = (uint32_t)(roundAndIndex.load(std::memory_order_acquire) >> 32);
+
+    while (runOneFrom(r))
+    {
+    }
+}
+
+bool RenderWorkerPool::runOneFrom(uint32_t r)
+{
+    auto cur = roundAndIndex.load(std::memory_order_acquire);
+
+    while (true)
+    {
+        if ((uint32_t)(cur >> 32) != r)
+            return false;
+
+        auto idx = (int)(cur & 0xFFFFFFFF);
+
+        if (idx >= currentCount.load(std::memory_order_relaxed))
+            return false;
+
+        if (roundAndIndex.compare_exchange_weak(cur, cur + 1, std::memory_order_acq_rel,
+                                                std::memory_order_acquire))
+        {
+            {
+                // the job is part of some process() call, even when it runs on a worker
+                SURGE_REALTIME_SCOPE;
+                currentJob(currentCtx, idx);
+            }
+            completed.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+    }
+}
+
+void RenderWorkerPool::workerLoop()
+{
+    // workers render voices and scenes, so they want the same flush-to-zero mode as process()
+    auto fpuguard = sst::plugininfra::cpufeatures::FPUStateGuard();
+
+    uint32_t seen = 0;
+    int idle = 0;
+
+    while (keepRunning)
+    {
+        auto r = (uint32_t)(roundAndIndex.load(std::memory_order_acquire) >> 32);
+
+        if (r != seen)
+        {
+            while (runOneFrom(r))
+            {
+            }
+
+            seen = r;
+            idle = 0;
+            continue;
+        }
+
+        if (idle < spinsBeforeSleep)
+        {
+            idle++;
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(sleepMutex);
+        sleepCV.wait_for(lk, missedWakeupTimeout, [this, seen]() {
+            return !keepRunning ||
+                   (uint32_t)(roundAndIndex.load(std::memory_order_acquire) >> 32) != seen;
+        });
+    }
+}
+
+} // namespace Threading
+} // namespace Surge
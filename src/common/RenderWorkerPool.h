@@ -0,0 +1,118 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_RENDERWORKERPOOL_H
+#define SURGE_SRC_COMMON_RENDERWORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Surge
+{
+namespace Threading
+{
+struct RenderWorkerPool;
+typedef bool (*render_executor_t)(void *executorCtx, RenderWorkerPool *pool, int n);
+
+/*
+ * A small fork/join pool for splitting the work of a single audio block across threads.
+ *
+ * runAll(n, job, ctx) calls job(ctx, i) once for every i in [0, n) and only returns when
+ * every index is complete. The calling thread takes part in the work, so the pool never
+ * deadlocks if its workers are asleep or descheduled; in the worst case the caller just
+ * does everything itself. Nothing in runAll allocates or takes a lock, so it is safe to
+ * call from the audio thread.
+ *
+ * Workers spin briefly after each job, so back-to-back blocks are picked up without
+ * a wakeup, and then fall back to sleeping on a condition variable when idle. A pool whose
+ * rounds are spread out (one per host block, say) can skip the spinning.
+ *
+ * runAll is start followed by finish. A caller which has other work to get on with can call
+ * those itself: start hands the round to the workers and returns, and finish, which must come
+ * before the next start, takes whatever no worker has picked up and waits for the rest.
+ *
+ * runAll is not reentrant and must only be called from one thread at a time.
+ *
+ * A host which owns a thread pool (CLAP's thread pool extension, say) can run the work instead
+ * of our workers. See setExecutor; a pool built for that usually has no workers of its own.
+ */
+struct RenderWorkerPool
+{
+    typedef void (*job_t)(void *ctx, int index);
+
+    explicit RenderWorkerPool(int nWorkers, bool spinWhenIdle = true);
+    ~RenderWorkerPool();
+
+    int numWorkers() const { return (int)threads.size(); }
+    void runAll(int n, job_t job, void *ctx);
+    void start(int n, job_t job, void *ctx);
+    void finish();
+
+    /*
+     * runAll calls the executor on the calling thread once the round is published. It should
+     * call runPending from as many threads as it likes and return once they are done, or
+     * return false straight away to leave the round to our own workers. Either way runAll
+     * also takes indices itself and waits for every one, so a host which runs fewer tasks than
+     * asked is still safe. Only set this while runAll can't be running.
+     */
+    void setExecutor(render_executor_t e, void *ectx)
+    {
+        executor = e;
+        executorCtx = ectx;
+    }
+    void runPending();
+
+  private:
+    bool runOneFrom(uint32_t round);
+    void wakeWorkers();
+    void workerLoop();
+
+    std::vector<std::thread> threads;
+
+    job_t currentJob{nullptr};
+    void *currentCtx{nullptr};
+    std::atomic<int> currentCount{0};
+    std::atomic<int> completed{0};
+
+    // high 32 bits are the round, low 32 bits the next index, so a worker which wakes late
+    // can never grab an index from a round which has since been restarted
+    std::atomic<uint64_t> roundAndIndex{0};
+    uint32_t round{0};
+    // the size of the round started and not yet finished; only the caller touches this
+    int pending{0};
+    int spinsBeforeSleep;
+
+    render_executor_t executor{nullptr};
+    void *executorCtx{nullptr};
+
+    std::atomic<bool> keepRunning{true};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCV;
+};
+} // namespace Threading
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_RENDERWORKERPOOL_H
@@ -0,0 +1,141 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_SCOPETAP_H
+#define SURGE_SRC_COMMON_SCOPETAP_H
+
+#include <array>
+#include <atomic>
+
+/*
+ * The audio side of the oscilloscope. When the waveform scope is zoomed out far enough that a
+ * pixel covers several samples, it asks for a decimation and the engine folds each run of that
+ * many frames into its minimum and maximum, in the order they happened, before the ring buffer.
+ * Every peak still reaches the display, but the buffer, the scope thread and the waveform fold
+ * see a fraction of the samples. A decimation of 1 passes the audio through untouched, which
+ * is what the spectrum always uses.
+ *
+ * The decimation is set by the scope thread and read by the audio thread; the run state is
+ * only ever touched by the audio thread.
+ */
+struct ScopeTap
+{
+    std::atomic<int> decimation{1};
+
+    // How many input frames each value the tap emits stands for
+    static float framesPerValue(int decimation)
+    {
+        return decimation <= 1 ? 1.f : decimation * 0.5f;
+    }
+
+    /*
+     * Fold n frames into outL and outR, which need room for n + 2 values, and return how many
+     * were written. Only call this with a decimation above 1; otherwise push the block as is.
+     */
+    int process(const float *L, const float *R, int n, float *outL, float *outR)
+    {
+        auto d = decimation.load(std::memory_order_relaxed);
+
+        if (d != runLength)
+        {
+            runLength = d;
+            inRun = 0;
+        }
+
+        int res = 0;
+
+        for (int i = 0; i < n; ++i)
+        {
+            chan[0].add(L[i], inRun);
+            chan[1].add(R[i], inRun);
+
+            if (++inRun == runLength)
+            {
+                chan[0].emit(outL + res);
+                chan[1].emit(outR + res);
+                res += 2;
+                inRun = 0;
+            }
+        }
+
+        return res;
+    }
+
+  private:
+    struct Run
+    {
+        float lo{0}, hi{0};
+        int loAt{0}, hiAt{0};
+
+        void add(float v, int at)
+        {
+            if (at == 0 || v < lo)
+            {
+                lo = v;
+                loAt = at;
+            }
+            if (at == 0 || v > hi)
+            {
+                hi = v;
+                hiAt = at;
+            }
+        }
+
+        void emit(float *o) const
+        {
+            o[0] = loAt <= hiAt ? lo : hi;
+            o[1] = loAt <= hiAt ? hi : lo;
+        }
+    };
+
+    std::array<Run, 2> chan;
+    int runLength{1}, inRun{0};
+};
+
+/*
+ * A single writer, single reader triple buffer. The writer fills back() and publishes it; the
+ * reader calls update() and, if that says something new arrived, reads front(). Neither side
+ * ever waits for the other and the reader always sees the latest complete value. The back slot
+ * holds whatever was there before, so the writer must fill all of it each time.
+ */
+template <typename T> struct TripleBuffer
+{
+    T &back() { return slots[backIdx]; }
+    void publish() { backIdx = middle.exchange(backIdx | fresh, std::memory_order_acq_rel) & idx; }
+
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & fresh))
+            return false;
+        frontIdx = middle.exchange(frontIdx, std::memory_order_acq_rel) & idx;
+        return true;
+    }
+    const T &front() const { return slots[frontIdx]; }
+
+  private:
+    static constexpr int fresh = 4, idx = 3;
+    std::array<T, 3> slots{};
+    int backIdx{0}, frontIdx{1};
+    std::atomic<int> middle{2};
+};
+
+#endif // SURGE_SRC_COMMON_SCOPETAP_H
@@ -0,0 +1,176 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "SharedStorageCore.h"
+
+#include <cmath>
+#include <map>
+#include <mutex>
+
+#include "sst/basic-blocks/tables/SincTableProvider.h"
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * We only hold weak references, so the process doesn't keep any of this alive once the last
+ * instance is gone. Hosts construct instances from several threads, hence the lock.
+ */
+static std::mutex sharedCoreMutex;
+
+std::shared_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sharedSincTables()
+{
+    static std::weak_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sinc;
+
+    std::lock_guard<std::mutex> g(sharedCoreMutex);
+
+    auto res = sinc.lock();
+    if (!res)
+    {
+        res = std::make_shared<sst::basic_blocks::tables::SurgeSincTableProvider>();
+        sinc = res;
+    }
+
+    return res;
+}
+
+SharedLookupTables::SharedLookupTables()
+{
+    float _512th = 1.f / 512.f;
+
+    for (int i = 0; i < size; i++)
+    {
+        dB[i] = powf(10.f, 0.05f * ((float)i - 384.f));
+        pitch[i] = powf(2.f, ((float)i - 256.f) * (1.f / 12.f));
+        pitch_inv[i] = 1.f / pitch[i];
+        glide_log[i] = log2(1.0 + (i * _512th * 10.f)) / log2(1.f + 10.f);
+        glide_exp[size - 1 - i] = 1.0 - glide_log[i];
+    }
+
+    for (int i = 0; i < 1001; ++i)
+    {
+        double twelths = i * 1.0 / 12.0 / 1000.0;
+        two_to_the[i] = pow(2.0, twelths);
+        two_to_the_minus[i] = pow(2.0, -twelths);
+    }
+}
+
+const SharedLookupTables &sharedLookupTables()
+{
+    static const SharedLookupTables tables;
+    return tables;
+}
+
+static std::map<std::string, std::weak_ptr<const SharedDirectoryScan>> &directoryScans()
+{
+    static std::map<std::string, std::weak_ptr<const SharedDirectoryScan>> scans;
+    return scans;
+}
+
+std::shared_ptr<const SharedDirectoryScan> findSharedDirectoryScan(const std::string &key)
+{
+    std::lock_guard<std::mutex> g(sharedCoreMutex);
+
+    auto &scans = directoryScans();
+    auto it = scans.find(key);
+
+    if (it == scans.end())
+        return nullptr;
+
+    auto res = it->second.lock();
+    if (!res)
+        scans.erase(it);
+
+    return res;
+}
+
+void publishSharedDirectoryScan(const std::string &key,
+                                const std::shared_ptr<const SharedDirectoryScan> &scan)
+{
+    std::lock_guard<std::mutex> g(sharedCoreMutex);
+
+    directoryScans()[key] = scan;
+}
+
+SharedWavetableKey sharedWavetableKeyFor(const wt_header &wh, const void *data, size_t dataSize)
+{
+    // FNV-1a. Sizes go in the key as well, so a collision would also need an equal length
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](const void *d, size_t n) {
+        auto c = (const uint8_t *)d;
+        for (size_t i = 0; i < n; ++i)
+        {
+            h ^= c[i];
+            h *= 1099511628211ULL;
+        }
+    };
+
+    mix(&wh, sizeof(wt_header));
+    mix(data, dataSize);
+
+    return {h, dataSize};
+}
+
+static std::map<SharedWavetableKey, std::weak_ptr<const Wavetable>> &wavetables()
+{
+    static std::map<SharedWavetableKey, std::weak_ptr<const Wavetable>> wts;
+    return wts;
+}
+
+std::shared_ptr<const Wavetable> findSharedWavetable(const SharedWavetableKey &key)
+{
+    std::lock_guard<std::mutex> g(sharedCoreMutex);
+
+    auto &wts = wavetables();
+    auto it = wts.find(key);
+
+    if (it == wts.end())
+        return nullptr;
+
+    auto res = it->second.lock();
+    if (!res)
+        wts.erase(it);
+
+    return res;
+}
+
+void publishSharedWavetable(const SharedWavetableKey &key,
+                            const std::shared_ptr<const Wavetable> &wt)
+{
+    std::lock_guard<std::mutex> g(sharedCoreMutex);
+
+    auto &wts = wavetables();
+
+    // drop anything nobody holds any more while we are here
+    for (auto it = wts.begin(); it != wts.end();)
+    {
+        if (it->second.expired())
+            it = wts.erase(it);
+        else
+            ++it;
+    }
+
+    wts[key] = wt;
+}
+} // namespace Storage
+} // namespace Surge
@@ -0,0 +1,99 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_SHAREDSTORAGECORE_H
+#define SURGE_SRC_COMMON_SHAREDSTORAGECORE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "SurgeStorage.h"
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * Parts of SurgeStorage which come out the same for every instance in a process: the sinc
+ * interpolation and sample rate independent lookup tables, the scans of the factory and third
+ * party patch and wavetable directories, and built wavetables. The first instance to need one
+ * builds it and later instances take a reference to the same copy. Nothing here is ever
+ * written after it is published, and each piece is freed when the last instance holding it
+ * goes away.
+ *
+ * Everything which depends on the sample rate, tuning or user data stays per instance.
+ */
+std::shared_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sharedSincTables();
+
+/*
+ * The lookup tables which depend on nothing but their index. They are a few kilobytes, so
+ * unlike the rest of this they are built the first time anyone asks and then kept for the life
+ * of the process.
+ */
+struct SharedLookupTables
+{
+    static constexpr int size = SurgeStorage::tuning_table_size;
+
+    float dB alignas(16)[size];
+    float glide_exp alignas(16)[size], glide_log alignas(16)[size];
+    // 12-TET, before any tuning is applied
+    float pitch alignas(16)[size], pitch_inv alignas(16)[size];
+    // 2^0 -> 2^+/-1/12th in 1000 steps
+    float two_to_the alignas(16)[1001], two_to_the_minus alignas(16)[1001];
+
+    SharedLookupTables();
+};
+
+const SharedLookupTables &sharedLookupTables();
+
+/*
+ * The result of refreshPatchOrWTListAddDir for one non-user directory, with categories
+ * numbered from zero. Keyed by the full directory path.
+ */
+struct SharedDirectoryScan
+{
+    std::vector<Patch> items;
+    std::vector<PatchCategory> categories;
+};
+
+// A scan some live instance already holds, or nullptr
+std::shared_ptr<const SharedDirectoryScan> findSharedDirectoryScan(const std::string &key);
+void publishSharedDirectoryScan(const std::string &key,
+                                const std::shared_ptr<const SharedDirectoryScan> &scan);
+
+/*
+ * Built wavetables, keyed by a hash of the header and sample data they were built from, so
+ * every oscillator loading the same .wt shares one set of mipmaps. See
+ * Wavetable::shareTablesWith; tables which get edited or scripted make their own copy.
+ */
+typedef std::pair<uint64_t, size_t> SharedWavetableKey;
+SharedWavetableKey sharedWavetableKeyFor(const wt_header &wh, const void *data, size_t dataSize);
+std::shared_ptr<const Wavetable> findSharedWavetable(const SharedWavetableKey &key);
+void publishSharedWavetable(const SharedWavetableKey &key,
+                            const std::shared_ptr<const Wavetable> &wt);
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_SHAREDSTORAGECORE_H
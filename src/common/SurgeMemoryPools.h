@@ -23,9 +23,16 @@
 #ifndef SURGE_SRC_COMMON_SURGEMEMORYPOOLS_H
 #define SURGE_SRC_COMMON_SURGEMEMORYPOOLS_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "SurgeStorage.h"
 #include "MemoryPool.h"
 #include "SSESincDelayLine.h"
+#include "TwistOscillator.h"
 
 namespace Surge
 {
@@ -33,11 +40,31 @@ namespace Memory
 {
 struct SurgeMemoryPools
 {
-    SurgeMemoryPools(SurgeStorage *s) : stringDelayLines(s->sinctable) {}
+    SurgeMemoryPools(SurgeStorage *s)
+        : poolStorage(s), stringDelayLines(s->sinctable), twistEngines(s)
+    {
+        // so a note on gets its delay lines and engines ready to go rather than clearing them
+        stringDelayLines.setScrubber([](auto *d) { d->clear(); });
+        twistEngines.setScrubber([s](auto *e) { e->prepare(s); });
+
+        replenishThread = std::thread([this]() { replenishLoop(); });
+    }
+
+    ~SurgeMemoryPools()
+    {
+        keepReplenishing = false;
+        replenishCV.notify_all();
+        if (replenishThread.joinable())
+            replenishThread.join();
+    }
+
+    SurgeStorage *poolStorage{nullptr};
 
     /*
      * The largest number of oscillator instances of a particular
-     * type are scenes * oscs * max voices, but add some pad
+     * type are scenes * oscs * max voices, but add some pad. This only
+     * sizes the pools' pointer slots; what they actually allocate follows
+     * the polyphony limit, clamped to the engine's voice capacity, below.
      */
     static constexpr int maxosc = n_scenes * n_oscs * (MAX_VOICES + 8);
 
@@ -45,11 +72,25 @@ struct SurgeMemoryPools
      * The string needs 2 delay lines per oscillator
      */
     MemoryPool<SSESincDelayLine<16384>, 8, 4, 2 * maxosc + 100> stringDelayLines;
+
+    /*
+     * The twist needs one plaits voice and its resamplers per oscillator
+     */
+    MemoryPool<TwistEngineMemory, 4, 4, maxosc + 100> twistEngines;
+
+    // what the pooled items take, including those lent out to running oscillators
+    size_t allocatedBytes() const
+    {
+        return stringDelayLines.allocatedCount() * sizeof(SSESincDelayLine<16384>) +
+               twistEngines.allocatedCount() * sizeof(TwistEngineMemory);
+    }
+
     void resetAllPools(SurgeStorage *storage) { resetOscillatorPools(storage); }
     void resetOscillatorPools(SurgeStorage *storage)
     {
         bool hasString{false}, hasTwist{false};
-        int nString{0};
+        int nString{0}, nTwist{0};
+        auto poly = std::min(storage->getPatch().polylimit.val.i, storage->voiceCapacity);
         for (int s = 0; s < n_scenes; ++s)
         {
             for (int os = 0; os < n_oscs; ++os)
@@ -61,20 +102,62 @@ struct SurgeMemoryPools
                     hasString = true;
                     nString++;
                 }
-                hasTwist |= (ot == ot_twist);
+                if (ot == ot_twist)
+                {
+                    hasTwist = true;
+                    nTwist++;
+                }
             }
         }
 
         if (hasString)
         {
-            int maxUsed = nString * 2 * storage->getPatch().polylimit.val.i;
+            int maxUsed = nString * 2 * poly;
             stringDelayLines.setupPoolToSize((int)(maxUsed * 0.5), storage->sinctable);
         }
         else
         {
             stringDelayLines.returnToPreAllocSize();
         }
+
+        if (hasTwist)
+        {
+            int maxUsed = nTwist * poly;
+            twistEngines.setupPoolToSize((int)(maxUsed * 0.5), storage);
+        }
+        else
+        {
+            twistEngines.returnToPreAllocSize();
+        }
     }
+
+    /*
+     * Allocating a delay line or a plaits engine on the audio thread at note on is exactly
+     * what the pools are for avoiding, so rather than growing there, the pools hand items over
+     * from a reserve which this thread keeps topped up. The audio thread never waits on it;
+     * it just polls the pools' requests.
+     */
+    void replenishLoop()
+    {
+        while (keepReplenishing)
+        {
+            {
+                std::unique_lock<std::mutex> lk(replenishMutex);
+                replenishCV.wait_for(lk, std::chrono::milliseconds(20));
+            }
+
+            if (!keepReplenishing)
+                break;
+
+            stringDelayLines.replenishReserve(poolStorage->sinctable);
+            twistEngines.replenishReserve(poolStorage);
+        }
+    }
+
+    std::atomic<bool> keepReplenishing{true};
+    std::mutex replenishMutex;
+    std::condition_variable replenishCV;
+    std::thread replenishThread;
 };
 
 } // namespace Memory
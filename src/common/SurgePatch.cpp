@@ -24,6 +24,7 @@
 #include "Oscillator.h"
 #include "SurgeParamConfig.h"
 #include "Effect.h"
+#include "ConvolutionEffect.h"
 #include <list>
 #include "MSEGModulationHelper.h"
 #include "FormulaModulationHelper.h"
@@ -806,6 +807,13 @@ SurgePatch::SurgePatch(SurgeStorage *storage)
     {
         param_ptr_by_oscname[p->get_osc_name()] = p;
     }
+
+    // and by storage name; the first one wins, as the first sibling did when walking the XML
+    param_index_by_storagename.reserve(param_ptr.size());
+    for (int i = 0; i < (int)param_ptr.size(); i++)
+    {
+        param_index_by_storagename.emplace(param_ptr[i]->get_storage_name(), i);
+    }
 }
 
 void SurgePatch::init_default_values()
@@ -1012,6 +1020,25 @@ void SurgePatch::copy_scenedata(pdata *d, int scene)
     }
 }
 
+void SurgePatch::diff_scenedata(int scene)
+{
+    auto *d = scenedata[scene];
+    auto *prev = scenedataPrevious[scene];
+    int n = 0;
+
+    for (int i = 0; i < n_scene_params; i++)
+    {
+        if (d[i].i != prev[i].i)
+        {
+            prev[i].i = d[i].i;
+            scenedataChanged[scene][n++] = i;
+        }
+    }
+
+    scenedataChangedCount[scene] = n;
+    scenedataGeneration[scene]++;
+}
+
 void SurgePatch::copy_globaldata(pdata *d)
 {
     for (int i = 0; i < n_global_params; i++)
@@ -1100,6 +1127,8 @@ void SurgePatch::update_controls(
             }
         }
     }
+
+    controlsRevision++;
 }
 
 #pragma pack(push, 1)
@@ -1206,28 +1235,37 @@ std::string base64_decode(std::string const &encoded_string)
     return ret;
 }
 
-void SurgePatch::load_patch(const void *data, int datasize, bool preset)
+void SurgePatch::load_patch(const void *data, int datasize, bool preset, TiXmlDocument *parsedXml)
 {
     if (datasize <= 4)
         return;
     assert(datasize);
     assert(data);
     void *end = (char *)data + datasize;
-    patch_header *ph = (patch_header *)data;
-    ph->xmlsize = mech::endian_read_int32LE(ph->xmlsize);
+    // read the sizes into locals rather than swapping them in place, so the same chunk can be
+    // loaded more than once (and by more than one engine at a time)
+    auto ph = (const patch_header *)data;
+    int xmlsize = mech::endian_read_int32LE(ph->xmlsize);
 
     if (!memcmp(ph->tag, "sub3", 4))
     {
         char *dr = (char *)data + sizeof(patch_header);
-        load_xml(dr, ph->xmlsize, preset);
-        dr += ph->xmlsize;
+        {
+            Surge::Profiling::PatchLoadProfile::Scope ps(
+                storage->patchLoadProfile, Surge::Profiling::PatchLoadProfile::lp_parse);
+            if (parsedXml)
+                load_xml_document(*parsedXml, preset);
+            else
+                load_xml(dr, xmlsize, preset);
+        }
+        dr += xmlsize;
 
         for (int sc = 0; sc < n_scenes; sc++)
         {
             for (int osc = 0; osc < n_oscs; osc++)
             {
-                ph->wtsize[sc][osc] = mech::endian_read_int32LE(ph->wtsize[sc][osc]);
-                if (ph->wtsize[sc][osc])
+                int wtsize = mech::endian_read_int32LE(ph->wtsize[sc][osc]);
+                if (wtsize)
                 {
                     wt_header *wth = (wt_header *)dr;
                     if (wth > end)
@@ -1240,6 +1278,10 @@ void SurgePatch::load_patch(const void *data, int datasize, bool preset)
 
                     void *d = (void *)((char *)dr + sizeof(wt_header));
 
+                    Surge::Profiling::PatchLoadProfile::Scope ps(
+                        storage->patchLoadProfile,
+                        Surge::Profiling::PatchLoadProfile::lp_wavetables);
+
                     storage->waveTableDataMutex.lock();
                     scene[sc].osc[osc].wt.BuildWT(d, *wth, false);
 
@@ -1275,26 +1317,32 @@ void SurgePatch::load_patch(const void *data, int datasize, bool preset)
                         }
                     }
 
-                    dr += ph->wtsize[sc][osc];
+                    dr += wtsize;
                 }
             }
         }
     }
     else
     {
-        load_xml(data, datasize, preset);
+        Surge::Profiling::PatchLoadProfile::Scope ps(storage->patchLoadProfile,
+                                                     Surge::Profiling::PatchLoadProfile::lp_parse);
+        if (parsedXml)
+            load_xml_document(*parsedXml, preset);
+        else
+            load_xml(data, datasize, preset);
     }
 }
 
 unsigned int SurgePatch::save_patch(void **data)
 {
     size_t psize = 0;
-    // void **xmldata = new void*();
-    void *xmldata = 0;
     patch_header header;
 
     memcpy(header.tag, "sub3", 4);
-    size_t xmlsize = save_xml(&xmldata);
+
+    // write the xml into a buffer we keep around and copy it straight into the patch below
+    save_xml_into(xmlSaveBuffer);
+    size_t xmlsize = xmlSaveBuffer.size();
     header.xmlsize = mech::endian_write_int32LE(xmlsize);
     wt_header wth[n_scenes][n_oscs];
     for (int sc = 0; sc < n_scenes; sc++)
@@ -1319,16 +1367,21 @@ unsigned int SurgePatch::save_patch(void **data)
         }
     }
     psize += xmlsize + sizeof(patch_header);
-    if (patchptr)
+
+    // patchptr only ever grows, so saving the same patch over and over doesn't allocate
+    if (!patchptr || psize > patchptrCapacity)
+    {
         free(patchptr);
-    patchptr = malloc(psize);
+        patchptr = malloc(psize);
+        patchptrCapacity = psize;
+    }
+
     char *dw = (char *)patchptr;
     *data = patchptr;
     memcpy(dw, &header, sizeof(patch_header));
     dw += sizeof(patch_header);
-    memcpy(dw, xmldata, xmlsize);
+    memcpy(dw, xmlSaveBuffer.data(), xmlsize);
     dw += xmlsize;
-    free(xmldata);
 
     for (int sc = 0; sc < n_scenes; sc++)
     {
@@ -1385,8 +1438,6 @@ float convert_v11_reso_to_v12_4P(float reso) { return reso * (0.99f / 1.05f); }
 void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
 {
     TiXmlDocument doc;
-    int j;
-    double d;
 
     if (datasize >= (1 << 22))
     {
@@ -1411,1720 +1462,1840 @@ void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
         free(temp);
     }
 
-    // clear old modulation routings
-    for (int sc = 0; sc < n_scenes; sc++)
-    {
-        scene[sc].modulation_scene.clear();
-        scene[sc].modulation_voice.clear();
-    }
+    load_xml_document(doc, is_preset);
+}
 
-    modulation_global.clear();
+void SurgePatch::load_daw_extra_state(TiXmlElement *patch)
+{
+    dawExtraState.isPopulated = false;
+    TiXmlElement *de = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("dawExtraState"));
 
-    for (auto &i : fx)
+    if (de)
     {
-        i.type.val.i = fxt_off;
-    }
+        int pop;
 
-    TiXmlElement *patch = TINYXML_SAFE_TO_ELEMENT(doc.FirstChild("patch"));
+        if (de->QueryIntAttribute("populated", &pop) == TIXML_SUCCESS)
+        {
+            dawExtraState.isPopulated = (pop != 0);
+        }
 
-    if (!patch)
-    {
-        return;
-    }
+        if (dawExtraState.isPopulated)
+        {
+            int ival;
+            TiXmlElement *p;
 
-    int revision = 0;
-    patch->QueryIntAttribute("revision", &revision);
-    streamingRevision = revision;
-    currentSynthStreamingRevision = ff_revision;
+            // This is the non-legacy way to save editor state
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("editor"));
 
-    if (revision > ff_revision)
-    {
-        std::ostringstream oss;
-        oss << "Surge XT version you are running (" << Surge::Build::FullVersionStr
-            << ") is older than the version which created this patch. Patch version "
-               "mismatch is: "
-            << revision << " (patch) vs " << ff_revision << " (current).\n"
-            << "Certain features of the patch will not be available in your session.\n\n"
-            << "You can always find the latest version of Surge XT at " << stringWebsite;
-        storage->reportError(oss.str(), "Patch Version Mismatch");
-    }
+            if (p)
+            {
+                if (p->QueryIntAttribute("current_scene", &ival) == TIXML_SUCCESS)
+                {
+                    dawExtraState.editor.current_scene = ival;
+                }
 
-    TiXmlElement *meta = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("meta"));
+                if (p->QueryIntAttribute("current_fx", &ival) == TIXML_SUCCESS)
+                {
+                    dawExtraState.editor.current_fx = ival;
+                }
 
-    if (meta)
-    {
-        const char *s;
+                if (p->QueryIntAttribute("modsource", &ival) == TIXML_SUCCESS)
+                {
+                    dawExtraState.editor.modsource = (modsources)ival;
+                }
 
-        if (!is_preset)
-        {
-            s = meta->Attribute("name");
+                if (p->QueryIntAttribute("isMSEGOpen", &ival) == TIXML_SUCCESS)
+                {
+                    dawExtraState.editor.isMSEGOpen = ival;
+                }
+                else
+                {
+                    dawExtraState.editor.isMSEGOpen = false;
+                }
 
-            if (s)
-            {
-                name = s;
-            }
+                dawExtraState.editor.activeOverlays.clear();
 
-            s = meta->Attribute("category");
+                auto overs = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("overlays"));
 
-            if (s)
-            {
-                category = s;
-            }
-        }
+                if (overs)
+                {
+                    auto curro = TINYXML_SAFE_TO_ELEMENT(overs->FirstChild("overlay"));
 
-        s = meta->Attribute("comment");
+                    while (curro)
+                    {
+                        DAWExtraStateStorage::EditorState::OverlayState os;
+                        int tv;
 
-        if (s)
-        {
-            comment = s;
-        }
+                        if (curro->QueryIntAttribute("whichOverlay", &tv) == TIXML_SUCCESS)
+                        {
+                            os.whichOverlay = tv;
+                        }
 
-        s = meta->Attribute("author");
+                        if (curro->QueryIntAttribute("isTornOut", &tv) == TIXML_SUCCESS)
+                        {
+                            os.isTornOut = tv;
+                        }
 
-        if (s)
-        {
-            author = s;
-        }
+                        if (curro->QueryIntAttribute("tearOut_x", &tv) == TIXML_SUCCESS)
+                        {
+                            os.tearOutPosition.first = tv;
+                        }
 
-        s = meta->Attribute("license");
+                        if (curro->QueryIntAttribute("tearOut_y", &tv) == TIXML_SUCCESS)
+                        {
+                            os.tearOutPosition.second = tv;
+                        }
 
-        if (s)
-        {
-            license = s;
-        }
-        else
-        {
-            license = "";
-        }
+                        dawExtraState.editor.activeOverlays.push_back(os);
+                        curro = TINYXML_SAFE_TO_ELEMENT(curro->NextSiblingElement("overlay"));
+                    }
+                }
 
-        auto *tagsX = TINYXML_SAFE_TO_ELEMENT(meta->FirstChild("tags"));
-        tags.clear();
+                // Just to be sure, even though constructor should do this
+                dawExtraState.editor.msegStateIsPopulated = false;
 
-        if (tagsX)
-        {
-            auto tag = TINYXML_SAFE_TO_ELEMENT(tagsX->FirstChildElement("tag"));
+                for (int sc = 0; sc < n_scenes; sc++)
+                {
+                    std::string con = "current_osc_" + std::to_string(sc);
 
-            while (tag)
-            {
-                std::string tagName = tag->Attribute("tag");
-                tags.emplace_back(tagName);
-                tag = TINYXML_SAFE_TO_ELEMENT(tag->NextSiblingElement("tag"));
-            }
-        }
-    }
+                    if (p->QueryIntAttribute(con, &ival) == TIXML_SUCCESS)
+                    {
+                        dawExtraState.editor.current_osc[sc] = ival;
+                    }
 
-    TiXmlElement *parameters = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("parameters"));
-    assert(parameters);
-    int n = param_ptr.size();
+                    con = "modsource_editor_" + std::to_string(sc);
 
-    // delete volume & fx_bypass if it's a preset. Those settings should stick
-    if (is_preset)
-    {
-        if (revision < 17)
-        {
-            TiXmlElement *tp = TINYXML_SAFE_TO_ELEMENT(parameters->FirstChild("volume"));
+                    if (p->QueryIntAttribute(con, &ival) == TIXML_SUCCESS)
+                    {
+                        dawExtraState.editor.modsource_editor[sc] = (modsources)ival;
+                    }
 
-            if (tp)
-            {
-                parameters->RemoveChild(tp);
-            }
-        }
+                    for (int lf = 0; lf < n_lfos; ++lf)
+                    {
+                        std::string msns =
+                            "mseg_state_" + std::to_string(sc) + "_" + std::to_string(lf);
+                        auto mss = TINYXML_SAFE_TO_ELEMENT(p->FirstChild(msns));
 
-        auto tp = TINYXML_SAFE_TO_ELEMENT(parameters->FirstChild("fx_bypass"));
+                        if (mss)
+                        {
+                            auto q = &(dawExtraState.editor.msegEditState[sc][lf]);
+                            double dv;
+                            int vv;
 
-        if (tp)
-        {
-            parameters->RemoveChild(tp);
-        }
+                            dawExtraState.editor.msegStateIsPopulated = true;
 
-        /*
-         * As of Surge 1.9, store the polylimit
-         *
-         * tp = TINYXML_SAFE_TO_ELEMENT(parameters->FirstChild("polylimit"));
-         * if (tp)
-         *   parameters->RemoveChild(tp);
-         */
-    }
+                            if (!userPrefRestoreMSEGFromPatch &&
+                                mss->QueryDoubleAttribute("hSnap", &dv) == TIXML_SUCCESS)
+                            {
+                                msegs[sc][lf].hSnap = dv;
+                            }
 
-    TiXmlElement *p;
+                            if (mss->QueryDoubleAttribute("hSnapDefault", &dv) == TIXML_SUCCESS)
+                            {
+                                // This is a case where we have the hSnapDefault in the DAW extra
+                                // state from the majority of the 18 run so at least try
+                                if (msegs[sc][lf].hSnapDefault == MSEGStorage::defaultHSnapDefault)
+                                {
+                                    msegs[sc][lf].hSnapDefault = dv;
+                                }
+                            }
 
-    for (int i = 0; i < n; i++)
-    {
-        if (!i)
-        {
-            p = TINYXML_SAFE_TO_ELEMENT(parameters->FirstChild(param_ptr[i]->get_storage_name()));
-        }
-        else
-        {
-            if (p)
-            {
-                p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling(param_ptr[i]->get_storage_name()));
-            }
+                            if (!userPrefRestoreMSEGFromPatch &&
+                                mss->QueryDoubleAttribute("vSnap", &dv) == TIXML_SUCCESS)
+                            {
+                                msegs[sc][lf].vSnap = dv;
+                            }
 
-            if (!p)
-            {
-                p = TINYXML_SAFE_TO_ELEMENT(
-                    parameters->FirstChild(param_ptr[i]->get_storage_name()));
-            }
-        }
+                            if (mss->QueryDoubleAttribute("vSnapDefault", &dv) == TIXML_SUCCESS)
+                            {
+                                if (msegs[sc][lf].vSnapDefault == MSEGStorage::defaultVSnapDefault)
+                                {
+                                    msegs[sc][lf].vSnapDefault = dv;
+                                }
+                            }
 
-        if (p)
-        {
-            int type;
-            bool hasStreamedType = true;
+                            if (mss->QueryIntAttribute("timeEditMode", &vv) == TIXML_SUCCESS)
+                            {
+                                q->timeEditMode = vv;
+                            }
+                        }
+                    }
 
-            if (!(p->QueryIntAttribute("type", &type) == TIXML_SUCCESS))
-            {
-                hasStreamedType = false;
-                type = param_ptr[i]->valtype;
-            }
+                    for (int lf = 0; lf < n_lfos; ++lf)
+                    {
+                        std::string fsns =
+                            "formula_state_" + std::to_string(sc) + "_" + std::to_string(lf);
+                        auto fss = TINYXML_SAFE_TO_ELEMENT(p->FirstChild(fsns));
+
+                        if (fss)
+                        {
+                            auto q = &(dawExtraState.editor.formulaEditState[sc][lf]);
+                            int vv;
+
+                            q->codeOrPrelude = 0;
+                            q->debuggerOpen = false;
+
+                            if (fss->QueryIntAttribute("codeOrPrelude", &vv) == TIXML_SUCCESS)
+                            {
+                                q->codeOrPrelude = vv;
+                            }
+
+                            if (fss->QueryIntAttribute("debuggerOpen", &vv) == TIXML_SUCCESS)
+                            {
+                                q->debuggerOpen = vv;
+                            }
+                        }
+                    }
+                } // end of scene loop
 
-            if (type == (valtypes)vt_float)
-            {
-                if (p->QueryDoubleAttribute("value", &d) == TIXML_SUCCESS)
-                {
-                    param_ptr[i]->set_storage_value((float)d);
-                }
-                else
                 {
-                    param_ptr[i]->val.f = param_ptr[i]->val_default.f;
+                    auto mes = &(dawExtraState.editor.modulationEditorState);
+                    auto node = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("modulation_editor"));
+
+                    mes->sortOrder = 0;
+                    mes->filterOn = 0;
+                    mes->filterString = "";
+                    mes->filterInt = 0;
+
+                    if (node)
+                    {
+                        int val;
+
+                        if (node->QueryIntAttribute("sortOrder", &val) == TIXML_SUCCESS)
+                        {
+                            mes->sortOrder = val;
+                        }
+
+                        if (node->QueryIntAttribute("filterOn", &val) == TIXML_SUCCESS)
+                        {
+                            mes->filterOn = val;
+                        }
+
+                        if (node->QueryIntAttribute("filterInt", &val) == TIXML_SUCCESS)
+                        {
+                            mes->filterInt = val;
+                        }
+
+                        if (node->Attribute("filterString"))
+                        {
+                            mes->filterString = std::string(node->Attribute("filterString"));
+                        }
+                    }
                 }
-            }
-            else
-            {
-                if (p->QueryIntAttribute("value", &j) == TIXML_SUCCESS)
+
                 {
-                    param_ptr[i]->set_storage_value(j);
+                    auto tes = &(dawExtraState.editor.tuningOverlayState);
+                    auto node = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("tuning_overlay"));
+
+                    tes->editMode = 0;
+
+                    if (node)
+                    {
+                        int val;
+
+                        if (node->QueryIntAttribute("editMode", &val) == TIXML_SUCCESS)
+                        {
+                            tes->editMode = val;
+                        }
+                    }
                 }
-                else
                 {
-                    param_ptr[i]->val.i = param_ptr[i]->val_default.i;
+                    auto oos = &(dawExtraState.editor.oscilloscopeOverlayState);
+                    auto node = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("oscilloscope_overlay"));
+
+                    if (node)
+                    {
+                        node->QueryIntAttribute("mode", &oos->mode);
+                        node->QueryFloatAttribute("trigger_speed", &oos->trigger_speed);
+                        node->QueryFloatAttribute("trigger_level", &oos->trigger_level);
+                        node->QueryFloatAttribute("time_window", &oos->time_window);
+                        node->QueryFloatAttribute("amp_window", &oos->amp_window);
+                        node->QueryIntAttribute("trigger_type", &oos->trigger_type);
+                        node->QueryBoolAttribute("dc_kill", &oos->dc_kill);
+                        node->QueryBoolAttribute("sync_draw", &oos->sync_draw);
+
+                        node->QueryFloatAttribute("noise_floor", &oos->noise_floor);
+                        node->QueryFloatAttribute("max_db", &oos->max_db);
+                        node->QueryFloatAttribute("decay_rate", &oos->decay_rate);
+                    }
                 }
+            } // end of editor populated block
+
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mpeEnabled"));
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
+            {
+                dawExtraState.mpeEnabled = ival;
             }
 
-            if ((p->QueryIntAttribute("temposync", &j) == TIXML_SUCCESS) && (j == 1))
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("isDirty"));
+            dawExtraState.isDirty = false;
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
             {
-                param_ptr[i]->temposync = (j == 1);
+                dawExtraState.isDirty = ival;
             }
 
-            if ((p->QueryIntAttribute("porta_const_rate", &j) == TIXML_SUCCESS))
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("disconnectFromOddSoundMTS"));
+            dawExtraState.disconnectFromOddSoundMTS = false;
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
             {
-                param_ptr[i]->porta_constrate = (j == 1);
+                dawExtraState.disconnectFromOddSoundMTS = ival;
             }
-            else
+
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mpePitchBendRange"));
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
             {
-                if (param_ptr[i]->has_portaoptions())
-                {
-                    param_ptr[i]->porta_constrate = false;
-                }
+                dawExtraState.mpePitchBendRange = ival;
             }
 
-            if ((p->QueryIntAttribute("porta_gliss", &j) == TIXML_SUCCESS))
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("monoPedalMode"));
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
             {
-                param_ptr[i]->porta_gliss = (j == 1);
+                dawExtraState.monoPedalMode = ival;
             }
-            else
+
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("midiReceiveChannelMask"));
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
             {
-                if (param_ptr[i]->has_portaoptions())
-                {
-                    param_ptr[i]->porta_gliss = false;
-                }
+                dawExtraState.midiReceiveChannelMask = ival;
             }
 
-            if ((p->QueryIntAttribute("porta_retrigger", &j) == TIXML_SUCCESS))
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("oddsoundRetuneMode"));
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
             {
-                param_ptr[i]->porta_retrigger = (j == 1);
+                dawExtraState.oddsoundRetuneMode = ival;
             }
             else
             {
-                if (param_ptr[i]->has_portaoptions())
-                {
-                    param_ptr[i]->porta_retrigger = false;
-                }
+                dawExtraState.oddsoundRetuneMode = SurgeStorage::RETUNE_CONSTANT;
             }
 
-            if ((p->QueryIntAttribute("porta_curve", &j) == TIXML_SUCCESS))
+            auto mts_main = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("oddsound_mts_active_as_main"));
+            if (mts_main)
             {
-                switch (j)
+                int tv;
+
+                if (mts_main->QueryIntAttribute("v", &tv) == TIXML_SUCCESS)
                 {
-                case porta_log:
-                case porta_lin:
-                case porta_exp:
-                    param_ptr[i]->porta_curve = j;
-                    break;
+                    if (tv)
+                    {
+#ifndef SURGE_SKIP_ODDSOUND_MTS
+                        storage->connect_as_oddsound_main();
+#endif
+                    }
                 }
             }
-            else
+
+            /*
+             * We originally stored scale as 'hasTuning' but cleaned it all up in 1.9 in
+             * the data structures. To not break old sessions though we kept the wrong names in the
+             * XML
+             */
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("hasTuning"));
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
             {
-                if (param_ptr[i]->has_portaoptions())
-                {
-                    param_ptr[i]->porta_curve = porta_lin;
-                }
+                dawExtraState.hasScale = (ival != 0);
             }
 
-            if ((p->QueryIntAttribute("deform_type", &j) == TIXML_SUCCESS))
-                param_ptr[i]->deform_type = j;
-            else
+            const char *td;
+
+            if (dawExtraState.hasScale)
             {
-                if (param_ptr[i]->has_deformoptions())
+                p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("tuningContents"));
+
+                if (p && (td = p->Attribute("v")))
                 {
-                    if (param_ptr[i]->ctrltype == ct_noise_color)
-                    {
-                        param_ptr[i]->deform_type = NoiseColorChannels::STEREO;
-                    }
-                    else
-                    {
-                        param_ptr[i]->deform_type = type_1;
-                    }
+                    auto tc = base64_decode(td);
+
+                    dawExtraState.scaleContents = tc;
                 }
             }
 
-            if ((p->QueryIntAttribute("deactivated", &j) == TIXML_SUCCESS))
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("hasMapping"));
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
             {
-                param_ptr[i]->deactivated = (j == 1);
+                dawExtraState.hasMapping = (ival != 0);
             }
-            else
-            {
-                /*
-                 * This code runs when there is no deactivated streaming. This can happen
-                 * in, say, nightlies when we toggle can_deactivate half way through the
-                 * dev cycle so half the patches have it true and half false. But there is
-                 * no good default so just maintain this nasty list.
-                 */
-                if (param_ptr[i]->can_deactivate())
-                {
-                    auto cg = param_ptr[i]->ctrlgroup;
-                    auto ct = param_ptr[i]->ctrltype;
 
-                    // Do we want to taggle to default deactivated on or off?
-                    if ((cg == cg_LFO) || // this is the LFO rate and env special case
-                        (cg == cg_GLOBAL &&
-                         ct == ct_freq_hpf) || // this is the global highpass special case
-                        (ct == ct_filtertype || ct == ct_wstype) || // filter bypass
-                        (ct == ct_amplitude_clipper)                // scene volume
-                    )
-                    {
-                        param_ptr[i]->deactivated = false;
-                    }
-                    else
-                    {
-                        param_ptr[i]->deactivated = true;
-                    }
-                }
-                else if (revision == 16 && param_ptr[i]->ctrlgroup == cg_FX)
+            if (dawExtraState.hasMapping)
+            {
+                p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mappingContents"));
+
+                if (p && (td = p->Attribute("v")))
                 {
-                    /*
-                     * So, alas, we added deactivatable FX filters and stuff very late in the 1.9
-                     * cycle. The handle streaming handles 15 versions and stuff but 16s with no POV
-                     * get the random default. Now, you may ask, why not put this inside the
-                     * can_deactivate block? Well since we haven't created the FX yet we don't
-                     * know the type and so we don't know if it is deactivatble.
-                     *
-                     * So what we do is, for revision 16 patches where we don't know if they
-                     * were saved during the 4 months of nightlies or 9 days before release,
-                     * we assume if there is no statement they were saved in the 4 months and
-                     * clobber any unknown deactivated state to false here.
-                     */
-                    param_ptr[i]->deactivated = false;
+                    auto tc = base64_decode(td);
+
+                    dawExtraState.mappingContents = tc;
                 }
-            }
 
-            if (p->QueryIntAttribute("extend_range", &j) == TIXML_SUCCESS)
-            {
-                param_ptr[i]->set_extend_range((j == 1));
-            }
-            else
-            {
-                param_ptr[i]->set_extend_range(false);
+                p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mappingName"));
 
-                if (revision >= 16 && param_ptr[i]->ctrltype == ct_percent_oscdrift)
+                if (p && (td = p->Attribute("v")))
                 {
-                    param_ptr[i]->set_extend_range(true);
+                    dawExtraState.mappingName = td;
+                }
+                else
+                {
+                    dawExtraState.mappingName = "";
                 }
             }
 
-            if (p->QueryIntAttribute("absolute", &j) == TIXML_SUCCESS)
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mapChannelToOctave"));
+
+            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
             {
-                param_ptr[i]->absolute = (j == 1);
+                dawExtraState.mapChannelToOctave = (ival != 0);
             }
 
-            int sceneId = param_ptr[i]->scene;
-            int paramIdInScene = param_ptr[i]->param_id_in_scene;
-            TiXmlElement *mr = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("modrouting"));
-
-            /*
-             * Note when we make int modulation work we will have to remove this conditional here
-             */
-            /*
-            if( mr && hasStreamedType && type != vt_float )
-                std::cout << "Dropping modulations for param " << p->Value()
-                << hasStreamedType << " " << type << " " << vt_float << std::endl;
-                */
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("midictrl_map"));
 
-            while (mr && (!hasStreamedType || type == vt_float))
+            if (p)
             {
-                int modsource;
-                double depth;
+                auto c = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("c"));
 
-                if ((mr->QueryIntAttribute("source", &modsource) == TIXML_SUCCESS) &&
-                    (mr->QueryDoubleAttribute("depth", &depth) == TIXML_SUCCESS))
+                while (c)
                 {
-                    if (revision < 9)
-                    {
-                        // make room for ctrl8 in old patches
-                        if (modsource > ms_ctrl7)
-                        {
-                            modsource++;
-                        }
-                    }
+                    int p, v;
 
-                    // see GitHub issue #6424
-                    if (revision < 21 && param_ptr[i] == &volume)
+                    if (c->QueryIntAttribute("p", &p) == TIXML_SUCCESS &&
+                        c->QueryIntAttribute("v", &v) == TIXML_SUCCESS)
                     {
-                        mr = TINYXML_SAFE_TO_ELEMENT(mr->NextSibling("modrouting"));
-                        continue;
+                        dawExtraState.midictrl_map[p] = v;
                     }
 
-                    vector<ModulationRouting> *modlist = nullptr;
+                    c = TINYXML_SAFE_TO_ELEMENT(c->NextSibling("c"));
+                }
+            }
 
-                    if (sceneId != 0)
-                    {
-                        if (isScenelevel((modsources)modsource))
-                        {
-                            modlist = &scene[sceneId - 1].modulation_scene;
-                        }
-                        else
-                        {
-                            modlist = &scene[sceneId - 1].modulation_voice;
-                        }
-                    }
-                    else
-                    {
-                        modlist = &modulation_global;
-                    }
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("midichan_map"));
 
-                    ModulationRouting t;
-                    t.depth = (float)depth;
-                    t.source_id = modsource;
+            if (p)
+            {
+                auto ch = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("ch"));
 
-                    if (sceneId != 0)
+                while (ch)
+                {
+                    int p, v;
+
+                    if (ch->QueryIntAttribute("p", &p) == TIXML_SUCCESS &&
+                        ch->QueryIntAttribute("v", &v) == TIXML_SUCCESS)
                     {
-                        t.source_scene = sceneId - 1;
+                        dawExtraState.midichan_map[p] = v;
                     }
-                    else
-                    {
-                        int sourcescene = 0;
 
-                        if (mr->QueryIntAttribute("source_scene", &sourcescene) == TIXML_SUCCESS)
-                        {
-                            t.source_scene = sourcescene;
-                        }
-                        else
-                        {
-                            // Explicitly set scene to A. See #2285
-                            t.source_scene = 0;
-                        }
-                    }
+                    ch = TINYXML_SAFE_TO_ELEMENT(ch->NextSibling("ch"));
+                }
+            }
+            else
+            {
+                dawExtraState.midichan_map.clear();
+            }
 
-                    int muted = 0;
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("customcontrol_map"));
 
-                    if (mr->QueryIntAttribute("muted", &muted) == TIXML_SUCCESS)
-                    {
-                        t.muted = muted;
-                    }
-                    else
-                    {
-                        t.muted = false;
-                    }
+            if (p)
+            {
+                auto c = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("c"));
 
-                    int source_index = 0;
+                while (c)
+                {
+                    int p, v;
 
-                    if (mr->QueryIntAttribute("source_index", &source_index) == TIXML_SUCCESS)
-                    {
-                        t.source_index = source_index;
-                    }
-                    else
+                    if (c->QueryIntAttribute("p", &p) == TIXML_SUCCESS &&
+                        c->QueryIntAttribute("v", &v) == TIXML_SUCCESS)
                     {
-                        t.source_index = 0;
+                        dawExtraState.customcontrol_map[p] = v;
                     }
 
-                    if (sceneId != 0)
-                    {
-                        t.destination_id = paramIdInScene;
-                    }
-                    else
+                    c = TINYXML_SAFE_TO_ELEMENT(c->NextSibling("c"));
+                }
+            }
+
+            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("customcontrol_chan_map"));
+
+            if (p)
+            {
+                auto ch = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("ch"));
+
+                while (ch)
+                {
+                    int p, v;
+
+                    if (ch->QueryIntAttribute("p", &p) == TIXML_SUCCESS &&
+                        ch->QueryIntAttribute("v", &v) == TIXML_SUCCESS)
                     {
-                        t.destination_id = i;
+                        dawExtraState.customcontrol_chan_map[p] = v;
                     }
 
-                    modlist->push_back(t);
+                    ch = TINYXML_SAFE_TO_ELEMENT(ch->NextSibling("ch"));
                 }
-
-                mr = TINYXML_SAFE_TO_ELEMENT(mr->NextSibling("modrouting"));
+            }
+            else
+            {
+                dawExtraState.customcontrol_chan_map.clear();
             }
         }
     }
+}
 
-    if (scene[0].pbrange_up.val.i & 0xffffff00) // is outside range, it must have been saved
+bool SurgePatch::parse_patch_xml(const void *data, int datasize, TiXmlDocument &doc)
+{
+    if (datasize <= 4 || !data)
+        return false;
+
+    auto xml = (const char *)data;
+    int xmlsize = datasize;
+    auto ph = (const patch_header *)data;
+
+    if (!memcmp(ph->tag, "sub3", 4))
     {
-        for (int sc = 0; sc < n_scenes; sc++)
-        {
-            scene[sc].pbrange_up.val.i = (int)scene[sc].pbrange_up.val.f;
-            scene[sc].pbrange_dn.val.i = (int)scene[sc].pbrange_dn.val.f;
-        }
+        if (datasize < sizeof(patch_header))
+            return false;
+
+        xml += sizeof(patch_header);
+        xmlsize = mech::endian_read_int32LE(ph->xmlsize);
+
+        if (xmlsize < 0 || xmlsize > datasize - (int)sizeof(patch_header))
+            return false;
     }
 
-    TiXmlElement *nonparamconfig = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("nonparamconfig"));
+    if (xmlsize >= (1 << 22))
+        return false;
 
-    // Set the default for TAM before 16
-    if (revision <= 15)
+    std::string temp(xml, xmlsize);
+    doc.Parse(temp.c_str(), nullptr, TIXML_ENCODING_LEGACY);
+
+    return !doc.Error() && doc.FirstChild("patch");
+}
+
+void SurgePatch::load_xml_document(TiXmlDocument &doc, bool is_preset)
+{
+    int j;
+    double d;
+
+    // clear old modulation routings
+    for (int sc = 0; sc < n_scenes; sc++)
     {
-        storage->setTuningApplicationMode(SurgeStorage::RETUNE_ALL);
+        scene[sc].modulation_scene.clear();
+        scene[sc].modulation_voice.clear();
     }
-    else
+
+    modulation_global.clear();
+
+    for (auto &i : fx)
     {
-        // We shouldn't need this since all 16s will stream it, but just in case
-        storage->setTuningApplicationMode(SurgeStorage::RETUNE_MIDI_ONLY);
+        i.type.val.i = fxt_off;
     }
 
-    // Default hardclip value
-    storage->hardclipMode = SurgeStorage::HARDCLIP_TO_18DBFS;
+    TiXmlElement *patch = TINYXML_SAFE_TO_ELEMENT(doc.FirstChild("patch"));
 
-    for (int sc = 0; sc < n_scenes; ++sc)
+    if (!patch)
     {
-        storage->sceneHardclipMode[sc] = SurgeStorage::HARDCLIP_TO_18DBFS;
+        return;
     }
 
-    if (nonparamconfig)
-    {
-        for (int sc = 0; sc < n_scenes; ++sc)
-        {
-            {
-                std::string mvname = "monoVoicePrority_" + std::to_string(sc);
-                auto *mv1 = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild(mvname));
-                storage->getPatch().scene[sc].monoVoicePriorityMode = ALWAYS_LATEST;
+    int revision = 0;
+    patch->QueryIntAttribute("revision", &revision);
+    streamingRevision = revision;
+    currentSynthStreamingRevision = ff_revision;
 
-                if (mv1)
-                {
-                    // Get value
-                    int mvv;
+    if (revision > ff_revision)
+    {
+        std::ostringstream oss;
+        oss << "Surge XT version you are running (" << Surge::Build::FullVersionStr
+            << ") is older than the version which created this patch. Patch version "
+               "mismatch is: "
+            << revision << " (patch) vs " << ff_revision << " (current).\n"
+            << "Certain features of the patch will not be available in your session.\n\n"
+            << "You can always find the latest version of Surge XT at " << stringWebsite;
+        storage->reportError(oss.str(), "Patch Version Mismatch");
+    }
 
-                    if (mv1->QueryIntAttribute("v", &mvv) == TIXML_SUCCESS)
-                    {
-                        storage->getPatch().scene[sc].monoVoicePriorityMode =
-                            (MonoVoicePriorityMode)mvv;
-                    }
-                }
-            }
+    TiXmlElement *meta = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("meta"));
 
-            {
-                std::string mvname = "monoVoiceEnvelope_" + std::to_string(sc);
-                auto *mv1 = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild(mvname));
-                storage->getPatch().scene[sc].monoVoiceEnvelopeMode = RESTART_FROM_ZERO;
+    if (meta)
+    {
+        const char *s;
 
-                if (mv1)
-                {
-                    // Get value
-                    int mvv;
+        if (!is_preset)
+        {
+            s = meta->Attribute("name");
 
-                    if (mv1->QueryIntAttribute("v", &mvv) == TIXML_SUCCESS)
-                    {
-                        storage->getPatch().scene[sc].monoVoiceEnvelopeMode =
-                            (MonoVoiceEnvelopeMode)mvv;
-                    }
-                }
+            if (s)
+            {
+                name = s;
             }
 
+            s = meta->Attribute("category");
+
+            if (s)
             {
-                std::string mvname = "polyVoiceRepeatedKeyMode_" + std::to_string(sc);
-                auto *mv1 = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild(mvname));
-                storage->getPatch().scene[sc].polyVoiceRepeatedKeyMode = NEW_VOICE_EVERY_NOTEON;
+                category = s;
+            }
+        }
 
-                if (mv1)
-                {
-                    // Get value
-                    int mvv;
+        s = meta->Attribute("comment");
 
-                    if (mv1->QueryIntAttribute("v", &mvv) == TIXML_SUCCESS)
-                    {
-                        storage->getPatch().scene[sc].polyVoiceRepeatedKeyMode =
-                            (PolyVoiceRepeatedKeyMode)mvv;
-                    }
-                }
-            }
+        if (s)
+        {
+            comment = s;
         }
 
-        auto *tam = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild("tuningApplicationMode"));
+        s = meta->Attribute("author");
 
-        if (tam)
+        if (s)
         {
-            int tv;
+            author = s;
+        }
 
-            if (tam->QueryIntAttribute("v", &tv) == TIXML_SUCCESS)
+        s = meta->Attribute("license");
+
+        if (s)
+        {
+            license = s;
+        }
+        else
+        {
+            license = "";
+        }
+
+        auto *tagsX = TINYXML_SAFE_TO_ELEMENT(meta->FirstChild("tags"));
+        tags.clear();
+
+        if (tagsX)
+        {
+            auto tag = TINYXML_SAFE_TO_ELEMENT(tagsX->FirstChildElement("tag"));
+
+            while (tag)
             {
-                storage->setTuningApplicationMode((SurgeStorage::TuningApplicationMode)(tv));
+                std::string tagName = tag->Attribute("tag");
+                tags.emplace_back(tagName);
+                tag = TINYXML_SAFE_TO_ELEMENT(tag->NextSiblingElement("tag"));
             }
         }
+    }
 
-        auto *hcs = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild("hardclipmodes"));
+    TiXmlElement *parameters = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("parameters"));
+    assert(parameters);
+    int n = param_ptr.size();
 
-        if (hcs)
+    // delete volume & fx_bypass if it's a preset. Those settings should stick
+    if (is_preset)
+    {
+        if (revision < 17)
         {
-            int tv;
+            TiXmlElement *tp = TINYXML_SAFE_TO_ELEMENT(parameters->FirstChild("volume"));
 
-            if (hcs->QueryIntAttribute("global", &tv) == TIXML_SUCCESS)
+            if (tp)
             {
-                storage->hardclipMode = (SurgeStorage::HardClipMode)tv;
+                parameters->RemoveChild(tp);
             }
+        }
 
-            for (int sc = 0; sc < n_scenes; ++sc)
-            {
-                auto an = std::string("sc") + std::to_string(sc);
+        auto tp = TINYXML_SAFE_TO_ELEMENT(parameters->FirstChild("fx_bypass"));
 
-                if (hcs->QueryIntAttribute(an, &tv) == TIXML_SUCCESS)
-                {
-                    storage->sceneHardclipMode[sc] = (SurgeStorage::HardClipMode)tv;
-                }
-            }
+        if (tp)
+        {
+            parameters->RemoveChild(tp);
         }
+
+        /*
+         * As of Surge 1.9, store the polylimit
+         *
+         * tp = TINYXML_SAFE_TO_ELEMENT(parameters->FirstChild("polylimit"));
+         * if (tp)
+         *   parameters->RemoveChild(tp);
+         */
     }
 
-    if (revision < 1)
+    /*
+     * Match the streamed elements to parameters in a single pass. Walking siblings by name per
+     * parameter is linear for a patch saved in param_ptr order, but every parameter after the
+     * first one missing from the stream (anything added since the patch was saved) went back
+     * to a FirstChild scan from the top, which made older patches quadratic to load.
+     */
+    std::vector<TiXmlElement *> streamedParams(n, nullptr);
+    TiXmlElement *p;
+
+    for (auto *e = parameters->FirstChildElement(); e; e = e->NextSiblingElement())
     {
-        for (int sc = 0; sc < n_scenes; sc++)
+        auto f = param_index_by_storagename.find(e->Value());
+
+        if (f != param_index_by_storagename.end() && !streamedParams[f->second])
         {
-            scene[sc].adsr[0].a_s.val.i = limit_range(scene[sc].adsr[0].a_s.val.i + 1, 0, 2);
-            scene[sc].adsr[1].a_s.val.i = limit_range(scene[sc].adsr[1].a_s.val.i + 1, 0, 2);
+            streamedParams[f->second] = e;
         }
     }
 
-    if (revision < 2)
+    for (int i = 0; i < n; i++)
     {
-        for (int i = 0; i < n_lfos; i++)
+        p = streamedParams[i];
+
+        if (p)
         {
-            if (scene[0].lfo[i].decay.val.f == scene[0].lfo[i].decay.val_max.f)
+            int type;
+            bool hasStreamedType = true;
+
+            if (!(p->QueryIntAttribute("type", &type) == TIXML_SUCCESS))
             {
-                scene[0].lfo[i].sustain.val.f = 1.f;
+                hasStreamedType = false;
+                type = param_ptr[i]->valtype;
+            }
+
+            if (type == (valtypes)vt_float)
+            {
+                if (p->QueryDoubleAttribute("value", &d) == TIXML_SUCCESS)
+                {
+                    param_ptr[i]->set_storage_value((float)d);
+                }
+                else
+                {
+                    param_ptr[i]->val.f = param_ptr[i]->val_default.f;
+                }
             }
             else
             {
-                scene[0].lfo[i].sustain.val.f = 0.f;
+                if (p->QueryIntAttribute("value", &j) == TIXML_SUCCESS)
+                {
+                    param_ptr[i]->set_storage_value(j);
+                }
+                else
+                {
+                    param_ptr[i]->val.i = param_ptr[i]->val_default.i;
+                }
             }
 
-            if (scene[1].lfo[i].decay.val.f == scene[1].lfo[i].decay.val_max.f)
+            if ((p->QueryIntAttribute("temposync", &j) == TIXML_SUCCESS) && (j == 1))
             {
-                scene[1].lfo[i].sustain.val.f = 1.f;
+                param_ptr[i]->temposync = (j == 1);
+            }
+
+            if ((p->QueryIntAttribute("porta_const_rate", &j) == TIXML_SUCCESS))
+            {
+                param_ptr[i]->porta_constrate = (j == 1);
             }
             else
             {
-                scene[1].lfo[i].sustain.val.f = 0.f;
+                if (param_ptr[i]->has_portaoptions())
+                {
+                    param_ptr[i]->porta_constrate = false;
+                }
             }
-        }
-    }
 
-    if (revision < 3)
-    {
-        for (auto &sc : scene)
-        {
-            for (auto &u : sc.filterunit)
+            if ((p->QueryIntAttribute("porta_gliss", &j) == TIXML_SUCCESS))
             {
-                switch (u.type.val.i)
+                param_ptr[i]->porta_gliss = (j == 1);
+            }
+            else
+            {
+                if (param_ptr[i]->has_portaoptions())
                 {
-                case sst::filters::FilterType::fut_lpmoog:
-                    u.subtype.val.i = 3;
-                    break;
-                case fut_14_comb:
-                    u.subtype.val.i = 1;
-                    break;
-                case sst::filters::FilterType::fut_SNH: // SNH replaced comb_neg in rev 4
-                    u.type.val.i = fut_14_comb;
-                    u.subtype.val.i = 3;
-                    break;
+                    param_ptr[i]->porta_gliss = false;
                 }
             }
-        }
-    }
 
-    if (revision == 3)
-    {
-        for (auto &sc : scene)
-        {
-            for (auto &u : sc.filterunit)
+            if ((p->QueryIntAttribute("porta_retrigger", &j) == TIXML_SUCCESS))
             {
-                // misc replaced comb_neg in rev 4
-                if (u.type.val.i == sst::filters::FilterType::fut_SNH)
+                param_ptr[i]->porta_retrigger = (j == 1);
+            }
+            else
+            {
+                if (param_ptr[i]->has_portaoptions())
                 {
-                    u.type.val.i = fut_14_comb;
-                    u.subtype.val.i += 2;
+                    param_ptr[i]->porta_retrigger = false;
                 }
             }
-        }
-    }
 
-    if (revision < 5)
-    {
-        for (auto &sc : scene)
-        {
-            if (sc.filterblock_configuration.val.i == fc_stereo)
+            if ((p->QueryIntAttribute("porta_curve", &j) == TIXML_SUCCESS))
             {
-                sc.pan.val.f = -1.f;
-                sc.width.val.f = 1.f;
-            }
-        }
-    }
-
-    if (revision < 6) // adjust resonance of older patches to match new range
-    {
-        using sst::filters::FilterType;
-
-        for (auto &sc : scene)
-        {
-            for (auto &u : sc.filterunit)
-            {
-                if ((u.type.val.i == FilterType::fut_lp12) ||
-                    (u.type.val.i == FilterType::fut_hp12) ||
-                    (u.type.val.i == FilterType::fut_bp12))
+                switch (j)
                 {
-                    u.resonance.val.f = convert_v11_reso_to_v12_2P(u.resonance.val.f);
+                case porta_log:
+                case porta_lin:
+                case porta_exp:
+                    param_ptr[i]->porta_curve = j;
+                    break;
                 }
-                else if ((u.type.val.i == FilterType::fut_lp24) ||
-                         (u.type.val.i == FilterType::fut_hp24))
+            }
+            else
+            {
+                if (param_ptr[i]->has_portaoptions())
                 {
-                    u.resonance.val.f = convert_v11_reso_to_v12_4P(u.resonance.val.f);
+                    param_ptr[i]->porta_curve = porta_lin;
                 }
             }
-        }
-    }
 
-    if (revision < 8)
-    {
-        using sst::filters::FilterType, sst::filters::FilterSubType;
+            if ((p->QueryIntAttribute("deform_type", &j) == TIXML_SUCCESS))
+                param_ptr[i]->deform_type = j;
+            else
+            {
+                if (param_ptr[i]->has_deformoptions())
+                {
+                    if (param_ptr[i]->ctrltype == ct_noise_color)
+                    {
+                        param_ptr[i]->deform_type = NoiseColorChannels::STEREO;
+                    }
+                    else
+                    {
+                        param_ptr[i]->deform_type = type_1;
+                    }
+                }
+            }
 
-        for (auto &sc : scene)
-        {
-            // set lp/hp filters to subtype 1
-            for (auto &u : sc.filterunit)
+            if ((p->QueryIntAttribute("deactivated", &j) == TIXML_SUCCESS))
             {
-                if ((u.type.val.i == FilterType::fut_lp12) ||
-                    (u.type.val.i == FilterType::fut_hp12) ||
-                    (u.type.val.i == FilterType::fut_bp12) ||
-                    (u.type.val.i == FilterType::fut_lp24) ||
-                    (u.type.val.i == FilterType::fut_hp24))
+                param_ptr[i]->deactivated = (j == 1);
+            }
+            else
+            {
+                /*
+                 * This code runs when there is no deactivated streaming. This can happen
+                 * in, say, nightlies when we toggle can_deactivate half way through the
+                 * dev cycle so half the patches have it true and half false. But there is
+                 * no good default so just maintain this nasty list.
+                 */
+                if (param_ptr[i]->can_deactivate())
                 {
-                    u.subtype.val.i =
-                        (revision < 6) ? FilterSubType::st_Standard : FilterSubType::st_Driven;
+                    auto cg = param_ptr[i]->ctrlgroup;
+                    auto ct = param_ptr[i]->ctrltype;
+
+                    // Do we want to taggle to default deactivated on or off?
+                    if ((cg == cg_LFO) || // this is the LFO rate and env special case
+                        (cg == cg_GLOBAL &&
+                         ct == ct_freq_hpf) || // this is the global highpass special case
+                        (ct == ct_filtertype || ct == ct_wstype) || // filter bypass
+                        (ct == ct_amplitude_clipper)                // scene volume
+                    )
+                    {
+                        param_ptr[i]->deactivated = false;
+                    }
+                    else
+                    {
+                        param_ptr[i]->deactivated = true;
+                    }
                 }
-                else if (u.type.val.i == FilterType::fut_notch12)
+                else if (revision == 16 && param_ptr[i]->ctrlgroup == cg_FX)
                 {
-                    u.subtype.val.i = 1;
+                    /*
+                     * So, alas, we added deactivatable FX filters and stuff very late in the 1.9
+                     * cycle. The handle streaming handles 15 versions and stuff but 16s with no POV
+                     * get the random default. Now, you may ask, why not put this inside the
+                     * can_deactivate block? Well since we haven't created the FX yet we don't
+                     * know the type and so we don't know if it is deactivatble.
+                     *
+                     * So what we do is, for revision 16 patches where we don't know if they
+                     * were saved during the 4 months of nightlies or 9 days before release,
+                     * we assume if there is no statement they were saved in the 4 months and
+                     * clobber any unknown deactivated state to false here.
+                     */
+                    param_ptr[i]->deactivated = false;
                 }
             }
 
-            // convert pan2 to width
-            if (sc.filterblock_configuration.val.i == fc_stereo)
+            if (p->QueryIntAttribute("extend_range", &j) == TIXML_SUCCESS)
             {
-                float pan1 = sc.pan.val.f;
-                float pan2 = sc.width.val.f;
+                param_ptr[i]->set_extend_range((j == 1));
+            }
+            else
+            {
+                param_ptr[i]->set_extend_range(false);
 
-                sc.pan.val.f = (pan1 + pan2) * 0.5f;
-                sc.width.val.f = (pan2 - pan1) * 0.5f;
+                if (revision >= 16 && param_ptr[i]->ctrltype == ct_percent_oscdrift)
+                {
+                    param_ptr[i]->set_extend_range(true);
+                }
             }
-        }
-    }
 
-    if (revision < 9)
-    {
-    }
+            if (p->QueryIntAttribute("absolute", &j) == TIXML_SUCCESS)
+            {
+                param_ptr[i]->absolute = (j == 1);
+            }
 
-    if (revision < 10)
-    {
-        character.val.i = 0;
-    }
+            int sceneId = param_ptr[i]->scene;
+            int paramIdInScene = param_ptr[i]->param_id_in_scene;
+            TiXmlElement *mr = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("modrouting"));
 
-    if (revision < 15)
-    {
-        for (auto &sc : scene)
-        {
-            // Older patches use Legacy mode
-            sc.monoVoicePriorityMode = NOTE_ON_LATEST_RETRIGGER_HIGHEST;
+            /*
+             * Note when we make int modulation work we will have to remove this conditional here
+             */
+            /*
+            if( mr && hasStreamedType && type != vt_float )
+                std::cout << "Dropping modulations for param " << p->Value()
+                << hasStreamedType << " " << type << " " << vt_float << std::endl;
+                */
 
-            // The Great Filter Remap, GitHub issue #3006
-            for (int u = 0; u < n_filterunits_per_scene; u++)
+            while (mr && (!hasStreamedType || type == vt_float))
             {
-                auto *fu = &(sc.filterunit[u]);
-                const auto futy = (fu_type_sv14)(fu->type.val.i);
-                auto subtype = fu->subtype.val.i;
+                int modsource;
+                double depth;
 
-                using sst::filters::FilterType;
-                switch (futy)
-                {
-                case fut_14_none:
-                case fut_14_lp12:
-                case fut_14_lp24:
-                case fut_14_lpmoog:
-                case fut_14_hp12:
-                case fut_14_hp24:
-                case fut_14_SNH:
-                case fut_14_vintageladder:
-                case fut_14_obxd_4pole:
-                case fut_14_k35_lp:
-                case fut_14_k35_hp:
-                case fut_14_diode:
-                case fut_14_cutoffwarp_lp:
-                case fut_14_cutoffwarp_hp:
-                case fut_14_cutoffwarp_n:
-                case fut_14_cutoffwarp_bp:
-                case n_fu_14_types:
-                    // These types were unchanged
-                    break;
-                case fut_14_obxd_2pole:
+                if ((mr->QueryIntAttribute("source", &modsource) == TIXML_SUCCESS) &&
+                    (mr->QueryDoubleAttribute("depth", &depth) == TIXML_SUCCESS))
                 {
-                    int newtype = subtype % 4;
-                    int newsub = (subtype < 4 ? 0 : 1);
-
-                    fu->subtype.val.i = newsub;
-
-                    switch (newtype)
+                    if (revision < 9)
                     {
-                    case 0:
-                        fu->type.val.i = FilterType::fut_obxd_2pole_lp;
-                        break;
-                    case 1:
-                        fu->type.val.i = FilterType::fut_obxd_2pole_bp;
-                        break;
-                    case 2:
-                        fu->type.val.i = FilterType::fut_obxd_2pole_hp;
-                        break;
-                    case 3:
-                        fu->type.val.i = FilterType::fut_obxd_2pole_n;
-                        break;
+                        // make room for ctrl8 in old patches
+                        if (modsource > ms_ctrl7)
+                        {
+                            modsource++;
+                        }
                     }
-                    break;
-                }
-                case fut_14_bp12:
-                    if (subtype < 3)
+
+                    // see GitHub issue #6424
+                    if (revision < 21 && param_ptr[i] == &volume)
                     {
-                        fu->type.val.i = FilterType::fut_bp12;
-                        fu->subtype.val.i = subtype;
+                        mr = TINYXML_SAFE_TO_ELEMENT(mr->NextSibling("modrouting"));
+                        continue;
                     }
-                    else if (subtype >= 3 && subtype < 6)
+
+                    vector<ModulationRouting> *modlist = nullptr;
+
+                    if (sceneId != 0)
                     {
-                        fu->type.val.i = FilterType::fut_bp24;
-                        fu->subtype.val.i = subtype - 3;
+                        if (isScenelevel((modsources)modsource))
+                        {
+                            modlist = &scene[sceneId - 1].modulation_scene;
+                        }
+                        else
+                        {
+                            modlist = &scene[sceneId - 1].modulation_voice;
+                        }
                     }
-                    break;
-                case fut_14_notch12:
-                    if (subtype < 2)
+                    else
                     {
-                        fu->type.val.i = FilterType::fut_notch12;
-                        fu->subtype.val.i = subtype;
+                        modlist = &modulation_global;
                     }
-                    else if (subtype >= 2 && subtype < 4)
+
+                    ModulationRouting t;
+                    t.depth = (float)depth;
+                    t.source_id = modsource;
+
+                    if (sceneId != 0)
                     {
-                        fu->type.val.i = FilterType::fut_notch24;
-                        fu->subtype.val.i = subtype - 2;
+                        t.source_scene = sceneId - 1;
                     }
+                    else
+                    {
+                        int sourcescene = 0;
 
-                    break;
-                case fut_14_comb:
-                    // subtypes 1 and 2 become positive, subtypes 3 and 4 become negative
-                    if (subtype == 0 || subtype == 1)
+                        if (mr->QueryIntAttribute("source_scene", &sourcescene) == TIXML_SUCCESS)
+                        {
+                            t.source_scene = sourcescene;
+                        }
+                        else
+                        {
+                            // Explicitly set scene to A. See #2285
+                            t.source_scene = 0;
+                        }
+                    }
+
+                    int muted = 0;
+
+                    if (mr->QueryIntAttribute("muted", &muted) == TIXML_SUCCESS)
                     {
-                        fu->type.val.i = FilterType::fut_comb_pos;
-                        fu->subtype.val.i = subtype;
+                        t.muted = muted;
                     }
-                    else if (subtype == 2 || subtype == 3)
+                    else
                     {
-                        fu->type.val.i = FilterType::fut_comb_neg;
-                        fu->subtype.val.i = subtype - 2;
+                        t.muted = false;
                     }
-                    break;
+
+                    int source_index = 0;
+
+                    if (mr->QueryIntAttribute("source_index", &source_index) == TIXML_SUCCESS)
+                    {
+                        t.source_index = source_index;
+                    }
+                    else
+                    {
+                        t.source_index = 0;
+                    }
+
+                    if (sceneId != 0)
+                    {
+                        t.destination_id = paramIdInScene;
+                    }
+                    else
+                    {
+                        t.destination_id = i;
+                    }
+
+                    modlist->push_back(t);
                 }
+
+                mr = TINYXML_SAFE_TO_ELEMENT(mr->NextSibling("modrouting"));
             }
         }
     }
 
-    if (revision <= 15 && polylimit.val.i == 8)
-    {
-        polylimit.val.i = DEFAULT_POLYLIMIT;
-    }
-
-    if (revision < 20)
+    if (scene[0].pbrange_up.val.i & 0xffffff00) // is outside range, it must have been saved
     {
-        for (auto &sc : scene)
+        for (int sc = 0; sc < n_scenes; sc++)
         {
-            sc.monoVoiceEnvelopeMode = RESTART_FROM_ZERO;
-            sc.polyVoiceRepeatedKeyMode = NEW_VOICE_EVERY_NOTEON;
+            scene[sc].pbrange_up.val.i = (int)scene[sc].pbrange_up.val.f;
+            scene[sc].pbrange_dn.val.i = (int)scene[sc].pbrange_dn.val.f;
         }
     }
 
-    if (revision <= 21)
+    TiXmlElement *nonparamconfig = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("nonparamconfig"));
+
+    // Set the default for TAM before 16
+    if (revision <= 15)
     {
-        for (auto sc = 0; sc < n_scenes; ++sc)
-        {
-            scene[sc].level_ring_12.deform_type = 0;
-            scene[sc].level_ring_23.deform_type = 0;
-            scene[sc].volume.deactivated = false;
-        }
+        storage->setTuningApplicationMode(SurgeStorage::RETUNE_ALL);
     }
-
-    // ensure that filter subtype is a valid value
-    for (auto &sc : scene)
+    else
     {
-        for (int u = 0; u < n_filterunits_per_scene; u++)
-        {
-            sc.filterunit[u].subtype.val.i =
-                limit_range(sc.filterunit[u].subtype.val.i, 0,
-                            max(0, sst::filters::fut_subcount[sc.filterunit[u].type.val.i] - 1));
-            sc.filterunit[u].type.set_user_data(&patchFilterSelectorMapper);
-        }
-
-        sc.wsunit.type.set_user_data(&patchWaveshaperSelectorMapper);
+        // We shouldn't need this since all 16s will stream it, but just in case
+        storage->setTuningApplicationMode(SurgeStorage::RETUNE_MIDI_ONLY);
     }
 
-    /*
-    ** extra osc data handling
-    */
+    // Default hardclip value
+    storage->hardclipMode = SurgeStorage::HARDCLIP_TO_18DBFS;
 
-    // Blank out the display names
-    for (int sc = 0; sc < n_scenes; sc++)
+    for (int sc = 0; sc < n_scenes; ++sc)
     {
-        for (int osc = 0; osc < n_oscs; osc++)
-        {
-            scene[sc].osc[osc].wavetable_display_name = "";
-            scene[sc].osc[osc].wavetable_formula = "";
-            scene[sc].osc[osc].wavetable_formula_nframes = 10;
-            scene[sc].osc[osc].wavetable_formula_res_base = 5;
-        }
+        storage->sceneHardclipMode[sc] = SurgeStorage::HARDCLIP_TO_18DBFS;
+        storage->sceneWaveshaperEvaluation[sc] = SurgeStorage::WAVESHAPER_EXACT;
     }
 
-    TiXmlElement *eod = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("extraoscdata"));
-
-    if (eod)
+    if (nonparamconfig)
     {
-        for (auto child = eod->FirstChild(); child; child = child->NextSibling())
+        for (int sc = 0; sc < n_scenes; ++sc)
         {
-            auto *lkid = TINYXML_SAFE_TO_ELEMENT(child);
-
-            if (lkid && lkid->Attribute("osc") && lkid->Attribute("scene"))
             {
-                int sos = std::atoi(lkid->Attribute("osc"));
-                int ssc = std::atoi(lkid->Attribute("scene"));
-
-                if (lkid->Attribute("wavetable_display_name"))
-                {
-                    scene[ssc].osc[sos].wavetable_display_name =
-                        lkid->Attribute("wavetable_display_name");
-                }
+                std::string mvname = "monoVoicePrority_" + std::to_string(sc);
+                auto *mv1 = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild(mvname));
+                storage->getPatch().scene[sc].monoVoicePriorityMode = ALWAYS_LATEST;
 
-                if (lkid->Attribute("wavetable_formula"))
+                if (mv1)
                 {
-                    int wfi;
-
-                    scene[ssc].osc[sos].wavetable_formula =
-                        base64_decode(lkid->Attribute("wavetable_formula"));
+                    // Get value
+                    int mvv;
 
-                    if (lkid->QueryIntAttribute("wavetable_formula_nframes", &wfi) == TIXML_SUCCESS)
+                    if (mv1->QueryIntAttribute("v", &mvv) == TIXML_SUCCESS)
                     {
-                        scene[ssc].osc[sos].wavetable_formula_nframes = wfi;
+                        storage->getPatch().scene[sc].monoVoicePriorityMode =
+                            (MonoVoicePriorityMode)mvv;
                     }
+                }
+            }
 
-                    if (lkid->QueryIntAttribute("wavetable_formula_res_base", &wfi) ==
-                        TIXML_SUCCESS)
+            {
+                std::string mvname = "monoVoiceEnvelope_" + std::to_string(sc);
+                auto *mv1 = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild(mvname));
+                storage->getPatch().scene[sc].monoVoiceEnvelopeMode = RESTART_FROM_ZERO;
+
+                if (mv1)
+                {
+                    // Get value
+                    int mvv;
+
+                    if (mv1->QueryIntAttribute("v", &mvv) == TIXML_SUCCESS)
                     {
-                        scene[ssc].osc[sos].wavetable_formula_res_base = wfi;
+                        storage->getPatch().scene[sc].monoVoiceEnvelopeMode =
+                            (MonoVoiceEnvelopeMode)mvv;
                     }
                 }
+            }
 
-                auto ec = &(scene[ssc].osc[sos].extraConfig);
-                int ti;
-                double tf;
+            {
+                std::string mvname = "polyVoiceRepeatedKeyMode_" + std::to_string(sc);
+                auto *mv1 = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild(mvname));
+                storage->getPatch().scene[sc].polyVoiceRepeatedKeyMode = NEW_VOICE_EVERY_NOTEON;
 
-                if (lkid->QueryIntAttribute("extra_n", &ti) == TIXML_SUCCESS)
+                if (mv1)
                 {
-                    ec->nData = ti;
+                    // Get value
+                    int mvv;
 
-                    for (int qq = 0; qq < ec->nData; ++qq)
+                    if (mv1->QueryIntAttribute("v", &mvv) == TIXML_SUCCESS)
                     {
-                        std::string attr = "extra_data_" + std::to_string(qq);
-
-                        if (lkid->QueryDoubleAttribute(attr, &tf) == TIXML_SUCCESS)
-                        {
-                            ec->data[qq] = tf;
-                        }
-                        else
-                        {
-                            ec->data[qq] = 0.f;
-                        }
+                        storage->getPatch().scene[sc].polyVoiceRepeatedKeyMode =
+                            (PolyVoiceRepeatedKeyMode)mvv;
                     }
                 }
             }
         }
-    }
 
-    // reset stepsequences first
-    for (auto &stepsequence : stepsequences)
-    {
-        for (auto &l : stepsequence)
+        auto *tam = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild("tuningApplicationMode"));
+
+        if (tam)
         {
-            for (int i = 0; i < n_stepseqsteps; i++)
+            int tv;
+
+            if (tam->QueryIntAttribute("v", &tv) == TIXML_SUCCESS)
             {
-                l.steps[i] = 0.f;
+                storage->setTuningApplicationMode((SurgeStorage::TuningApplicationMode)(tv));
             }
-
-            l.loop_start = 0;
-            l.loop_end = 15;
-            l.shuffle = 0.f;
         }
-    }
 
-    TiXmlElement *ss = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("stepsequences"));
+        auto *hcs = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild("hardclipmodes"));
 
-    if (ss)
-    {
-        p = TINYXML_SAFE_TO_ELEMENT(ss->FirstChild("sequence"));
-    }
-    else
-    {
-        p = nullptr;
-    }
+        if (hcs)
+        {
+            int tv;
 
-    while (p)
-    {
-        int sc, lfo;
+            if (hcs->QueryIntAttribute("global", &tv) == TIXML_SUCCESS)
+            {
+                storage->hardclipMode = (SurgeStorage::HardClipMode)tv;
+            }
 
-        if ((p->QueryIntAttribute("scene", &sc) == TIXML_SUCCESS) &&
-            (p->QueryIntAttribute("i", &lfo) == TIXML_SUCCESS) && within_range(0, sc, 1) &&
-            within_range(0, lfo, n_lfos - 1))
-        {
-            stepSeqFromXmlElement(&(stepsequences[sc][lfo]), p);
-        }
+            for (int sc = 0; sc < n_scenes; ++sc)
+            {
+                auto an = std::string("sc") + std::to_string(sc);
 
-        p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("sequence"));
-    }
+                if (hcs->QueryIntAttribute(an, &tv) == TIXML_SUCCESS)
+                {
+                    storage->sceneHardclipMode[sc] = (SurgeStorage::HardClipMode)tv;
+                }
+            }
+        }
 
-    // restore MSEGs. We optionally don't restore horiz/vert snap from patch
-    bool userPrefRestoreMSEGFromPatch = Surge::Storage::getUserDefaultValue(
-        storage, Surge::Storage::RestoreMSEGSnapFromPatch, true);
+        auto *wse = TINYXML_SAFE_TO_ELEMENT(nonparamconfig->FirstChild("waveshaperevaluation"));
 
-    for (int s = 0; s < n_scenes; ++s)
-    {
-        for (int m = 0; m < n_lfos; ++m)
+        if (wse)
         {
-            auto *ms = &(msegs[s][m]);
+            int tv;
 
-            if (ms_lfo1 + m >= ms_slfo1 && ms_lfo1 + m <= ms_slfo6)
+            for (int sc = 0; sc < n_scenes; ++sc)
             {
-                Surge::MSEG::createInitSceneMSEG(ms);
+                auto an = std::string("sc") + std::to_string(sc);
+
+                if (wse->QueryIntAttribute(an, &tv) == TIXML_SUCCESS)
+                {
+                    storage->sceneWaveshaperEvaluation[sc] =
+                        (SurgeStorage::WaveshaperEvaluation)limit_range(
+                            tv, (int)SurgeStorage::WAVESHAPER_EXACT,
+                            (int)SurgeStorage::WAVESHAPER_TABLE_ADAA);
+                }
             }
-            else
-            {
-                Surge::MSEG::createInitVoiceMSEG(ms);
-            }
-
-            Surge::MSEG::rebuildCache(ms);
-
-            auto *fs = &(formulamods[s][m]);
-
-            Surge::Formula::createInitFormula(fs);
         }
     }
 
-    TiXmlElement *ms = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("msegs"));
-
-    if (ms)
-    {
-        p = TINYXML_SAFE_TO_ELEMENT(ms->FirstChild("mseg"));
-    }
-    else
+    if (revision < 1)
     {
-        p = nullptr;
+        for (int sc = 0; sc < n_scenes; sc++)
+        {
+            scene[sc].adsr[0].a_s.val.i = limit_range(scene[sc].adsr[0].a_s.val.i + 1, 0, 2);
+            scene[sc].adsr[1].a_s.val.i = limit_range(scene[sc].adsr[1].a_s.val.i + 1, 0, 2);
+        }
     }
 
-    while (p)
+    if (revision < 2)
     {
-        int v;
-        auto sc = 0;
-
-        if (p->QueryIntAttribute("scene", &v) == TIXML_SUCCESS)
+        for (int i = 0; i < n_lfos; i++)
         {
-            sc = v;
-        }
-
-        auto mi = 0;
+            if (scene[0].lfo[i].decay.val.f == scene[0].lfo[i].decay.val_max.f)
+            {
+                scene[0].lfo[i].sustain.val.f = 1.f;
+            }
+            else
+            {
+                scene[0].lfo[i].sustain.val.f = 0.f;
+            }
 
-        if (p->QueryIntAttribute("i", &v) == TIXML_SUCCESS)
-        {
-            mi = v;
+            if (scene[1].lfo[i].decay.val.f == scene[1].lfo[i].decay.val_max.f)
+            {
+                scene[1].lfo[i].sustain.val.f = 1.f;
+            }
+            else
+            {
+                scene[1].lfo[i].sustain.val.f = 0.f;
+            }
         }
-
-        auto *ms = &(msegs[sc][mi]);
-
-        msegFromXMLElement(ms, p, userPrefRestoreMSEGFromPatch);
-        p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("mseg"));
     }
 
-    // end restore MSEGs
-
-    // make sure rev 15 and older patches have the locked endpoints if they were in LFO edit mode
-    if (revision < 16)
+    if (revision < 3)
     {
-        for (int sc = 0; sc < n_scenes; sc++)
+        for (auto &sc : scene)
         {
-            for (int i = 0; i < n_lfos; i++)
+            for (auto &u : sc.filterunit)
             {
-                if (msegs[sc][i].editMode == MSEGStorage::EditMode::LFO)
+                switch (u.type.val.i)
                 {
-                    msegs[sc][i].endpointMode = MSEGStorage::EndpointMode::LOCKED;
+                case sst::filters::FilterType::fut_lpmoog:
+                    u.subtype.val.i = 3;
+                    break;
+                case fut_14_comb:
+                    u.subtype.val.i = 1;
+                    break;
+                case sst::filters::FilterType::fut_SNH: // SNH replaced comb_neg in rev 4
+                    u.type.val.i = fut_14_comb;
+                    u.subtype.val.i = 3;
+                    break;
                 }
             }
         }
     }
 
-    // Unstream formula mods
-    TiXmlElement *fs = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("formulae"));
-
-    if (fs)
-    {
-        p = TINYXML_SAFE_TO_ELEMENT(fs->FirstChild("formula"));
-    }
-    else
-    {
-        p = nullptr;
-    }
-
-    while (p)
+    if (revision == 3)
     {
-        int v;
-        auto sc = 0;
-
-        if (p->QueryIntAttribute("scene", &v) == TIXML_SUCCESS)
-        {
-            sc = v;
-        }
-
-        auto mi = 0;
-
-        if (p->QueryIntAttribute("i", &v) == TIXML_SUCCESS)
+        for (auto &sc : scene)
         {
-            mi = v;
+            for (auto &u : sc.filterunit)
+            {
+                // misc replaced comb_neg in rev 4
+                if (u.type.val.i == sst::filters::FilterType::fut_SNH)
+                {
+                    u.type.val.i = fut_14_comb;
+                    u.subtype.val.i += 2;
+                }
+            }
         }
-
-        auto *fs = &(formulamods[sc][mi]);
-
-        formulaFromXMLElement(fs, p);
-        p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("formula"));
-    }
-
-    for (int i = 0; i < n_customcontrollers; i++)
-    {
-        scene[0].modsources[ms_ctrl1 + i]->reset();
     }
 
+    if (revision < 5)
     {
-        /*
-         * Reset to UNSCALED then try and read
-         */
-        for (int sc = 0; sc < n_scenes; sc++)
+        for (auto &sc : scene)
         {
-            for (int l = 0; l < n_lfos; l++)
+            if (sc.filterblock_configuration.val.i == fc_stereo)
             {
-                scene[sc].lfo[l].lfoExtraAmplitude = LFOStorage::UNSCALED;
+                sc.pan.val.f = -1.f;
+                sc.width.val.f = 1.f;
             }
         }
-        auto *el = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("extralfo"));
-        if (el)
+    }
+
+    if (revision < 6) // adjust resonance of older patches to match new range
+    {
+        using sst::filters::FilterType;
+
+        for (auto &sc : scene)
         {
-            auto l = TINYXML_SAFE_TO_ELEMENT(el->FirstChild("lfo"));
-            while (l)
+            for (auto &u : sc.filterunit)
             {
-                int sc, id, val;
-                if (l->QueryIntAttribute("scene", &sc) == TIXML_SUCCESS &&
-                    l->QueryIntAttribute("i", &id) == TIXML_SUCCESS &&
-                    l->QueryIntAttribute("extraAmplitude", &val) == TIXML_SUCCESS && sc >= 0 &&
-                    id >= 0 && sc < n_scenes && id < n_lfos)
+                if ((u.type.val.i == FilterType::fut_lp12) ||
+                    (u.type.val.i == FilterType::fut_hp12) ||
+                    (u.type.val.i == FilterType::fut_bp12))
                 {
-                    scene[sc].lfo[id].lfoExtraAmplitude = (LFOStorage::LFOExtraOutputAmplitude)val;
+                    u.resonance.val.f = convert_v11_reso_to_v12_2P(u.resonance.val.f);
+                }
+                else if ((u.type.val.i == FilterType::fut_lp24) ||
+                         (u.type.val.i == FilterType::fut_hp24))
+                {
+                    u.resonance.val.f = convert_v11_reso_to_v12_4P(u.resonance.val.f);
                 }
-                l = TINYXML_SAFE_TO_ELEMENT(l->NextSiblingElement("lfo"));
             }
         }
     }
 
-    TiXmlElement *cc = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("customcontroller"));
-
-    if (cc)
-    {
-        p = TINYXML_SAFE_TO_ELEMENT(cc->FirstChild("entry"));
-    }
-    else
-    {
-        p = nullptr;
-    }
-
-    while (p)
+    if (revision < 8)
     {
-        int cont, sc;
+        using sst::filters::FilterType, sst::filters::FilterSubType;
 
-        if ((p->QueryIntAttribute("i", &cont) == TIXML_SUCCESS) &&
-            within_range(0, cont, n_customcontrollers - 1) &&
-            ((p->QueryIntAttribute("scene", &sc) != TIXML_SUCCESS) || (sc == 0)))
+        for (auto &sc : scene)
         {
-            if (p->QueryIntAttribute("bipolar", &j) == TIXML_SUCCESS)
+            // set lp/hp filters to subtype 1
+            for (auto &u : sc.filterunit)
             {
-                scene[0].modsources[ms_ctrl1 + cont]->set_bipolar(j);
+                if ((u.type.val.i == FilterType::fut_lp12) ||
+                    (u.type.val.i == FilterType::fut_hp12) ||
+                    (u.type.val.i == FilterType::fut_bp12) ||
+                    (u.type.val.i == FilterType::fut_lp24) ||
+                    (u.type.val.i == FilterType::fut_hp24))
+                {
+                    u.subtype.val.i =
+                        (revision < 6) ? FilterSubType::st_Standard : FilterSubType::st_Driven;
+                }
+                else if (u.type.val.i == FilterType::fut_notch12)
+                {
+                    u.subtype.val.i = 1;
+                }
             }
 
-            if (p->QueryDoubleAttribute("v", &d) == TIXML_SUCCESS)
+            // convert pan2 to width
+            if (sc.filterblock_configuration.val.i == fc_stereo)
             {
-                ((ControllerModulationSource *)scene[0].modsources[ms_ctrl1 + cont])->init(d);
-            }
-
-            const char *lbl = p->Attribute("label");
+                float pan1 = sc.pan.val.f;
+                float pan2 = sc.width.val.f;
 
-            if (lbl)
-            {
-                strxcpy(CustomControllerLabel[cont], lbl, CUSTOM_CONTROLLER_LABEL_SIZE);
+                sc.pan.val.f = (pan1 + pan2) * 0.5f;
+                sc.width.val.f = (pan2 - pan1) * 0.5f;
             }
         }
-
-        p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("entry"));
     }
 
-    for (int s = 0; s < n_scenes; ++s)
+    if (revision < 9)
     {
-        for (int i = 0; i < n_lfos; ++i)
-        {
-            for (int d = 0; d < max_lfo_indices; ++d)
-            {
-                LFOBankLabel[s][i][d][0] = 0;
-            }
-        }
     }
 
-    TiXmlElement *lflb = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("lfobanklabels"));
-
-    if (lflb)
+    if (revision < 10)
     {
-        auto lb = TINYXML_SAFE_TO_ELEMENT(lflb->FirstChild("label"));
+        character.val.i = 0;
+    }
 
-        while (lb)
+    if (revision < 15)
+    {
+        for (auto &sc : scene)
         {
-            int lfo, idx, scene;
+            // Older patches use Legacy mode
+            sc.monoVoicePriorityMode = NOTE_ON_LATEST_RETRIGGER_HIGHEST;
 
-            if (lb->QueryIntAttribute("lfo", &lfo) == TIXML_SUCCESS &&
-                lb->QueryIntAttribute("idx", &idx) == TIXML_SUCCESS &&
-                lb->QueryIntAttribute("scene", &scene) == TIXML_SUCCESS)
-                strxcpy(LFOBankLabel[scene][lfo][idx], lb->Attribute("v"),
-                        CUSTOM_CONTROLLER_LABEL_SIZE);
-            lb = TINYXML_SAFE_TO_ELEMENT(lb->NextSibling("label"));
-        }
-    }
+            // The Great Filter Remap, GitHub issue #3006
+            for (int u = 0; u < n_filterunits_per_scene; u++)
+            {
+                auto *fu = &(sc.filterunit[u]);
+                const auto futy = (fu_type_sv14)(fu->type.val.i);
+                auto subtype = fu->subtype.val.i;
 
-    patchTuning.tuningStoredInPatch = false;
-    patchTuning.scaleContents = "";
-    patchTuning.mappingContents = "";
-    patchTuning.mappingName = "";
-
-    TiXmlElement *pt = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("patchTuning"));
-
-    if (pt)
-    {
-        const char *td;
-
-        if (pt && (td = pt->Attribute("v")))
-        {
-            auto tc = base64_decode(td);
-
-            patchTuning.tuningStoredInPatch = true;
-            patchTuning.scaleContents = tc;
-        }
-
-        if (pt && (td = pt->Attribute("m")))
-        {
-            auto tc = base64_decode(td);
-
-            patchTuning.tuningStoredInPatch = true;
-            patchTuning.mappingContents = tc;
-        }
-
-        if (patchTuning.tuningStoredInPatch && pt && (td = pt->Attribute("mname")))
-        {
-            patchTuning.mappingName = td;
-        }
-    }
-
-    dawExtraState.isPopulated = false;
-    TiXmlElement *de = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("dawExtraState"));
-
-    if (de)
-    {
-        int pop;
-
-        if (de->QueryIntAttribute("populated", &pop) == TIXML_SUCCESS)
-        {
-            dawExtraState.isPopulated = (pop != 0);
-        }
-
-        if (dawExtraState.isPopulated)
-        {
-            int ival;
-            TiXmlElement *p;
-
-            // This is the non-legacy way to save editor state
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("editor"));
-
-            if (p)
-            {
-                if (p->QueryIntAttribute("current_scene", &ival) == TIXML_SUCCESS)
-                {
-                    dawExtraState.editor.current_scene = ival;
-                }
-
-                if (p->QueryIntAttribute("current_fx", &ival) == TIXML_SUCCESS)
-                {
-                    dawExtraState.editor.current_fx = ival;
-                }
-
-                if (p->QueryIntAttribute("modsource", &ival) == TIXML_SUCCESS)
-                {
-                    dawExtraState.editor.modsource = (modsources)ival;
-                }
-
-                if (p->QueryIntAttribute("isMSEGOpen", &ival) == TIXML_SUCCESS)
+                using sst::filters::FilterType;
+                switch (futy)
                 {
-                    dawExtraState.editor.isMSEGOpen = ival;
-                }
-                else
+                case fut_14_none:
+                case fut_14_lp12:
+                case fut_14_lp24:
+                case fut_14_lpmoog:
+                case fut_14_hp12:
+                case fut_14_hp24:
+                case fut_14_SNH:
+                case fut_14_vintageladder:
+                case fut_14_obxd_4pole:
+                case fut_14_k35_lp:
+                case fut_14_k35_hp:
+                case fut_14_diode:
+                case fut_14_cutoffwarp_lp:
+                case fut_14_cutoffwarp_hp:
+                case fut_14_cutoffwarp_n:
+                case fut_14_cutoffwarp_bp:
+                case n_fu_14_types:
+                    // These types were unchanged
+                    break;
+                case fut_14_obxd_2pole:
                 {
-                    dawExtraState.editor.isMSEGOpen = false;
-                }
-
-                dawExtraState.editor.activeOverlays.clear();
-
-                auto overs = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("overlays"));
+                    int newtype = subtype % 4;
+                    int newsub = (subtype < 4 ? 0 : 1);
 
-                if (overs)
-                {
-                    auto curro = TINYXML_SAFE_TO_ELEMENT(overs->FirstChild("overlay"));
+                    fu->subtype.val.i = newsub;
 
-                    while (curro)
+                    switch (newtype)
                     {
-                        DAWExtraStateStorage::EditorState::OverlayState os;
-                        int tv;
-
-                        if (curro->QueryIntAttribute("whichOverlay", &tv) == TIXML_SUCCESS)
-                        {
-                            os.whichOverlay = tv;
-                        }
-
-                        if (curro->QueryIntAttribute("isTornOut", &tv) == TIXML_SUCCESS)
-                        {
-                            os.isTornOut = tv;
-                        }
-
-                        if (curro->QueryIntAttribute("tearOut_x", &tv) == TIXML_SUCCESS)
-                        {
-                            os.tearOutPosition.first = tv;
-                        }
-
-                        if (curro->QueryIntAttribute("tearOut_y", &tv) == TIXML_SUCCESS)
-                        {
-                            os.tearOutPosition.second = tv;
-                        }
-
-                        dawExtraState.editor.activeOverlays.push_back(os);
-                        curro = TINYXML_SAFE_TO_ELEMENT(curro->NextSiblingElement("overlay"));
+                    case 0:
+                        fu->type.val.i = FilterType::fut_obxd_2pole_lp;
+                        break;
+                    case 1:
+                        fu->type.val.i = FilterType::fut_obxd_2pole_bp;
+                        break;
+                    case 2:
+                        fu->type.val.i = FilterType::fut_obxd_2pole_hp;
+                        break;
+                    case 3:
+                        fu->type.val.i = FilterType::fut_obxd_2pole_n;
+                        break;
                     }
+                    break;
                 }
-
-                // Just to be sure, even though constructor should do this
-                dawExtraState.editor.msegStateIsPopulated = false;
-
-                for (int sc = 0; sc < n_scenes; sc++)
-                {
-                    std::string con = "current_osc_" + std::to_string(sc);
-
-                    if (p->QueryIntAttribute(con, &ival) == TIXML_SUCCESS)
+                case fut_14_bp12:
+                    if (subtype < 3)
                     {
-                        dawExtraState.editor.current_osc[sc] = ival;
+                        fu->type.val.i = FilterType::fut_bp12;
+                        fu->subtype.val.i = subtype;
                     }
-
-                    con = "modsource_editor_" + std::to_string(sc);
-
-                    if (p->QueryIntAttribute(con, &ival) == TIXML_SUCCESS)
+                    else if (subtype >= 3 && subtype < 6)
                     {
-                        dawExtraState.editor.modsource_editor[sc] = (modsources)ival;
+                        fu->type.val.i = FilterType::fut_bp24;
+                        fu->subtype.val.i = subtype - 3;
                     }
-
-                    for (int lf = 0; lf < n_lfos; ++lf)
+                    break;
+                case fut_14_notch12:
+                    if (subtype < 2)
                     {
-                        std::string msns =
-                            "mseg_state_" + std::to_string(sc) + "_" + std::to_string(lf);
-                        auto mss = TINYXML_SAFE_TO_ELEMENT(p->FirstChild(msns));
-
-                        if (mss)
-                        {
-                            auto q = &(dawExtraState.editor.msegEditState[sc][lf]);
-                            double dv;
-                            int vv;
-
-                            dawExtraState.editor.msegStateIsPopulated = true;
-
-                            if (!userPrefRestoreMSEGFromPatch &&
-                                mss->QueryDoubleAttribute("hSnap", &dv) == TIXML_SUCCESS)
-                            {
-                                msegs[sc][lf].hSnap = dv;
-                            }
-
-                            if (mss->QueryDoubleAttribute("hSnapDefault", &dv) == TIXML_SUCCESS)
-                            {
-                                // This is a case where we have the hSnapDefault in the DAW extra
-                                // state from the majority of the 18 run so at least try
-                                if (msegs[sc][lf].hSnapDefault == MSEGStorage::defaultHSnapDefault)
-                                {
-                                    msegs[sc][lf].hSnapDefault = dv;
-                                }
-                            }
-
-                            if (!userPrefRestoreMSEGFromPatch &&
-                                mss->QueryDoubleAttribute("vSnap", &dv) == TIXML_SUCCESS)
-                            {
-                                msegs[sc][lf].vSnap = dv;
-                            }
-
-                            if (mss->QueryDoubleAttribute("vSnapDefault", &dv) == TIXML_SUCCESS)
-                            {
-                                if (msegs[sc][lf].vSnapDefault == MSEGStorage::defaultVSnapDefault)
-                                {
-                                    msegs[sc][lf].vSnapDefault = dv;
-                                }
-                            }
-
-                            if (mss->QueryIntAttribute("timeEditMode", &vv) == TIXML_SUCCESS)
-                            {
-                                q->timeEditMode = vv;
-                            }
-                        }
+                        fu->type.val.i = FilterType::fut_notch12;
+                        fu->subtype.val.i = subtype;
+                    }
+                    else if (subtype >= 2 && subtype < 4)
+                    {
+                        fu->type.val.i = FilterType::fut_notch24;
+                        fu->subtype.val.i = subtype - 2;
                     }
 
-                    for (int lf = 0; lf < n_lfos; ++lf)
+                    break;
+                case fut_14_comb:
+                    // subtypes 1 and 2 become positive, subtypes 3 and 4 become negative
+                    if (subtype == 0 || subtype == 1)
                     {
-                        std::string fsns =
-                            "formula_state_" + std::to_string(sc) + "_" + std::to_string(lf);
-                        auto fss = TINYXML_SAFE_TO_ELEMENT(p->FirstChild(fsns));
+                        fu->type.val.i = FilterType::fut_comb_pos;
+                        fu->subtype.val.i = subtype;
+                    }
+                    else if (subtype == 2 || subtype == 3)
+                    {
+                        fu->type.val.i = FilterType::fut_comb_neg;
+                        fu->subtype.val.i = subtype - 2;
+                    }
+                    break;
+                }
+            }
+        }
+    }
 
-                        if (fss)
-                        {
-                            auto q = &(dawExtraState.editor.formulaEditState[sc][lf]);
-                            int vv;
+    if (revision <= 15 && polylimit.val.i == 8)
+    {
+        polylimit.val.i = DEFAULT_POLYLIMIT;
+    }
 
-                            q->codeOrPrelude = 0;
-                            q->debuggerOpen = false;
+    if (revision < 20)
+    {
+        for (auto &sc : scene)
+        {
+            sc.monoVoiceEnvelopeMode = RESTART_FROM_ZERO;
+            sc.polyVoiceRepeatedKeyMode = NEW_VOICE_EVERY_NOTEON;
+        }
+    }
 
-                            if (fss->QueryIntAttribute("codeOrPrelude", &vv) == TIXML_SUCCESS)
-                            {
-                                q->codeOrPrelude = vv;
-                            }
+    if (revision <= 21)
+    {
+        for (auto sc = 0; sc < n_scenes; ++sc)
+        {
+            scene[sc].level_ring_12.deform_type = 0;
+            scene[sc].level_ring_23.deform_type = 0;
+            scene[sc].volume.deactivated = false;
+        }
+    }
 
-                            if (fss->QueryIntAttribute("debuggerOpen", &vv) == TIXML_SUCCESS)
-                            {
-                                q->debuggerOpen = vv;
-                            }
-                        }
-                    }
-                } // end of scene loop
+    // ensure that filter subtype is a valid value
+    for (auto &sc : scene)
+    {
+        for (int u = 0; u < n_filterunits_per_scene; u++)
+        {
+            sc.filterunit[u].subtype.val.i =
+                limit_range(sc.filterunit[u].subtype.val.i, 0,
+                            max(0, sst::filters::fut_subcount[sc.filterunit[u].type.val.i] - 1));
+            sc.filterunit[u].type.set_user_data(&patchFilterSelectorMapper);
+        }
 
-                {
-                    auto mes = &(dawExtraState.editor.modulationEditorState);
-                    auto node = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("modulation_editor"));
+        sc.wsunit.type.set_user_data(&patchWaveshaperSelectorMapper);
+    }
 
-                    mes->sortOrder = 0;
-                    mes->filterOn = 0;
-                    mes->filterString = "";
-                    mes->filterInt = 0;
+    /*
+    ** extra osc data handling
+    */
 
-                    if (node)
-                    {
-                        int val;
+    // Blank out the display names
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        for (int osc = 0; osc < n_oscs; osc++)
+        {
+            scene[sc].osc[osc].wavetable_display_name = "";
+            scene[sc].osc[osc].wavetable_formula = "";
+            scene[sc].osc[osc].wavetable_formula_nframes = 10;
+            scene[sc].osc[osc].wavetable_formula_res_base = 5;
+        }
+    }
 
-                        if (node->QueryIntAttribute("sortOrder", &val) == TIXML_SUCCESS)
-                        {
-                            mes->sortOrder = val;
-                        }
+    TiXmlElement *eod = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("extraoscdata"));
 
-                        if (node->QueryIntAttribute("filterOn", &val) == TIXML_SUCCESS)
-                        {
-                            mes->filterOn = val;
-                        }
+    if (eod)
+    {
+        for (auto child = eod->FirstChild(); child; child = child->NextSibling())
+        {
+            auto *lkid = TINYXML_SAFE_TO_ELEMENT(child);
 
-                        if (node->QueryIntAttribute("filterInt", &val) == TIXML_SUCCESS)
-                        {
-                            mes->filterInt = val;
-                        }
+            if (lkid && lkid->Attribute("osc") && lkid->Attribute("scene"))
+            {
+                int sos = std::atoi(lkid->Attribute("osc"));
+                int ssc = std::atoi(lkid->Attribute("scene"));
 
-                        if (node->Attribute("filterString"))
-                        {
-                            mes->filterString = std::string(node->Attribute("filterString"));
-                        }
-                    }
+                if (lkid->Attribute("wavetable_display_name"))
+                {
+                    scene[ssc].osc[sos].wavetable_display_name =
+                        lkid->Attribute("wavetable_display_name");
                 }
 
+                if (lkid->Attribute("wavetable_formula"))
                 {
-                    auto tes = &(dawExtraState.editor.tuningOverlayState);
-                    auto node = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("tuning_overlay"));
+                    int wfi;
 
-                    tes->editMode = 0;
+                    scene[ssc].osc[sos].wavetable_formula =
+                        base64_decode(lkid->Attribute("wavetable_formula"));
 
-                    if (node)
+                    if (lkid->QueryIntAttribute("wavetable_formula_nframes", &wfi) == TIXML_SUCCESS)
                     {
-                        int val;
+                        scene[ssc].osc[sos].wavetable_formula_nframes = wfi;
+                    }
 
-                        if (node->QueryIntAttribute("editMode", &val) == TIXML_SUCCESS)
-                        {
-                            tes->editMode = val;
-                        }
+                    if (lkid->QueryIntAttribute("wavetable_formula_res_base", &wfi) ==
+                        TIXML_SUCCESS)
+                    {
+                        scene[ssc].osc[sos].wavetable_formula_res_base = wfi;
                     }
                 }
+
+                auto ec = &(scene[ssc].osc[sos].extraConfig);
+                int ti;
+                double tf;
+
+                if (lkid->QueryIntAttribute("extra_n", &ti) == TIXML_SUCCESS)
                 {
-                    auto oos = &(dawExtraState.editor.oscilloscopeOverlayState);
-                    auto node = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("oscilloscope_overlay"));
+                    ec->nData = ti;
 
-                    if (node)
+                    for (int qq = 0; qq < ec->nData; ++qq)
                     {
-                        node->QueryIntAttribute("mode", &oos->mode);
-                        node->QueryFloatAttribute("trigger_speed", &oos->trigger_speed);
-                        node->QueryFloatAttribute("trigger_level", &oos->trigger_level);
-                        node->QueryFloatAttribute("time_window", &oos->time_window);
-                        node->QueryFloatAttribute("amp_window", &oos->amp_window);
-                        node->QueryIntAttribute("trigger_type", &oos->trigger_type);
-                        node->QueryBoolAttribute("dc_kill", &oos->dc_kill);
-                        node->QueryBoolAttribute("sync_draw", &oos->sync_draw);
+                        std::string attr = "extra_data_" + std::to_string(qq);
 
-                        node->QueryFloatAttribute("noise_floor", &oos->noise_floor);
-                        node->QueryFloatAttribute("max_db", &oos->max_db);
-                        node->QueryFloatAttribute("decay_rate", &oos->decay_rate);
+                        if (lkid->QueryDoubleAttribute(attr, &tf) == TIXML_SUCCESS)
+                        {
+                            ec->data[qq] = tf;
+                        }
+                        else
+                        {
+                            ec->data[qq] = 0.f;
+                        }
                     }
                 }
-            } // end of editor populated block
+            }
+        }
+    }
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mpeEnabled"));
+    /*
+     * The convolution's response parameter is an index into ir_list, which changes whenever
+     * responses are added or removed, so the response is streamed by name too and the index
+     * found again here. One we can't find loads as None rather than whatever has its index.
+     */
+    TiXmlElement *efd = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("extrafxdata"));
 
-            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
+    if (efd)
+    {
+        for (auto child = efd->FirstChild(); child; child = child->NextSibling())
+        {
+            auto *lkid = TINYXML_SAFE_TO_ELEMENT(child);
+            int slot;
+
+            if (!lkid || !lkid->Attribute("ir") ||
+                lkid->QueryIntAttribute("slot", &slot) != TIXML_SUCCESS || slot < 0 ||
+                slot >= n_fx_slots || fx[slot].type.val.i != fxt_convolution)
             {
-                dawExtraState.mpeEnabled = ival;
+                continue;
             }
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("isDirty"));
-            dawExtraState.isDirty = false;
+            std::string name = lkid->Attribute("ir");
+            std::string cat = lkid->Attribute("ir_category") ? lkid->Attribute("ir_category") : "";
+            int found = -1;
 
-            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
+            for (int i = 0; i < (int)storage->ir_list.size(); ++i)
             {
-                dawExtraState.isDirty = ival;
-            }
+                auto &ir = storage->ir_list[i];
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("disconnectFromOddSoundMTS"));
-            dawExtraState.disconnectFromOddSoundMTS = false;
+                if (ir.name != name)
+                    continue;
 
-            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
-            {
-                dawExtraState.disconnectFromOddSoundMTS = ival;
-            }
+                auto c = ir.category;
+                auto sameCategory = c >= 0 && c < (int)storage->ir_category.size() &&
+                                    storage->ir_category[c].name == cat;
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mpePitchBendRange"));
+                // a response of that name in the category it was saved from beats any other
+                if (found < 0 || sameCategory)
+                    found = i;
 
-            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
-            {
-                dawExtraState.mpePitchBendRange = ival;
+                if (sameCategory)
+                    break;
             }
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("monoPedalMode"));
+            fx[slot].p[ConvolutionEffect::conv_ir].val.i = found;
+        }
+    }
 
-            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
+    // reset stepsequences first
+    for (auto &stepsequence : stepsequences)
+    {
+        for (auto &l : stepsequence)
+        {
+            for (int i = 0; i < n_stepseqsteps; i++)
             {
-                dawExtraState.monoPedalMode = ival;
+                l.steps[i] = 0.f;
             }
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("oddsoundRetuneMode"));
+            l.loop_start = 0;
+            l.loop_end = 15;
+            l.shuffle = 0.f;
+        }
+    }
 
-            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
+    TiXmlElement *ss = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("stepsequences"));
+
+    if (ss)
+    {
+        p = TINYXML_SAFE_TO_ELEMENT(ss->FirstChild("sequence"));
+    }
+    else
+    {
+        p = nullptr;
+    }
+
+    while (p)
+    {
+        int sc, lfo;
+
+        if ((p->QueryIntAttribute("scene", &sc) == TIXML_SUCCESS) &&
+            (p->QueryIntAttribute("i", &lfo) == TIXML_SUCCESS) && within_range(0, sc, 1) &&
+            within_range(0, lfo, n_lfos - 1))
+        {
+            stepSeqFromXmlElement(&(stepsequences[sc][lfo]), p);
+        }
+
+        p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("sequence"));
+    }
+
+    // restore MSEGs. We optionally don't restore horiz/vert snap from patch
+    bool userPrefRestoreMSEGFromPatch = Surge::Storage::getUserDefaultValue(
+        storage, Surge::Storage::RestoreMSEGSnapFromPatch, true);
+
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        for (int m = 0; m < n_lfos; ++m)
+        {
+            auto *ms = &(msegs[s][m]);
+
+            if (ms_lfo1 + m >= ms_slfo1 && ms_lfo1 + m <= ms_slfo6)
             {
-                dawExtraState.oddsoundRetuneMode = ival;
+                Surge::MSEG::createInitSceneMSEG(ms);
             }
             else
             {
-                dawExtraState.oddsoundRetuneMode = SurgeStorage::RETUNE_CONSTANT;
+                Surge::MSEG::createInitVoiceMSEG(ms);
             }
 
-            auto mts_main = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("oddsound_mts_active_as_main"));
-            if (mts_main)
-            {
-                int tv;
+            Surge::MSEG::rebuildCache(ms);
 
-                if (mts_main->QueryIntAttribute("v", &tv) == TIXML_SUCCESS)
+            auto *fs = &(formulamods[s][m]);
+
+            Surge::Formula::createInitFormula(fs);
+        }
+    }
+
+    TiXmlElement *ms = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("msegs"));
+
+    if (ms)
+    {
+        p = TINYXML_SAFE_TO_ELEMENT(ms->FirstChild("mseg"));
+    }
+    else
+    {
+        p = nullptr;
+    }
+
+    while (p)
+    {
+        int v;
+        auto sc = 0;
+
+        if (p->QueryIntAttribute("scene", &v) == TIXML_SUCCESS)
+        {
+            sc = v;
+        }
+
+        auto mi = 0;
+
+        if (p->QueryIntAttribute("i", &v) == TIXML_SUCCESS)
+        {
+            mi = v;
+        }
+
+        auto *ms = &(msegs[sc][mi]);
+
+        msegFromXMLElement(ms, p, userPrefRestoreMSEGFromPatch);
+        p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("mseg"));
+    }
+
+    // end restore MSEGs
+
+    // make sure rev 15 and older patches have the locked endpoints if they were in LFO edit mode
+    if (revision < 16)
+    {
+        for (int sc = 0; sc < n_scenes; sc++)
+        {
+            for (int i = 0; i < n_lfos; i++)
+            {
+                if (msegs[sc][i].editMode == MSEGStorage::EditMode::LFO)
                 {
-                    if (tv)
-                    {
-#ifndef SURGE_SKIP_ODDSOUND_MTS
-                        storage->connect_as_oddsound_main();
-#endif
-                    }
+                    msegs[sc][i].endpointMode = MSEGStorage::EndpointMode::LOCKED;
                 }
             }
+        }
+    }
 
-            /*
-             * We originally stored scale as 'hasTuning' but cleaned it all up in 1.9 in
-             * the data structures. To not break old sessions though we kept the wrong names in the
-             * XML
-             */
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("hasTuning"));
+    // Unstream formula mods
+    TiXmlElement *fs = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("formulae"));
+
+    if (fs)
+    {
+        p = TINYXML_SAFE_TO_ELEMENT(fs->FirstChild("formula"));
+    }
+    else
+    {
+        p = nullptr;
+    }
+
+    while (p)
+    {
+        int v;
+        auto sc = 0;
 
-            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
-            {
-                dawExtraState.hasScale = (ival != 0);
-            }
+        if (p->QueryIntAttribute("scene", &v) == TIXML_SUCCESS)
+        {
+            sc = v;
+        }
 
-            const char *td;
+        auto mi = 0;
 
-            if (dawExtraState.hasScale)
-            {
-                p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("tuningContents"));
+        if (p->QueryIntAttribute("i", &v) == TIXML_SUCCESS)
+        {
+            mi = v;
+        }
 
-                if (p && (td = p->Attribute("v")))
-                {
-                    auto tc = base64_decode(td);
+        auto *fs = &(formulamods[sc][mi]);
 
-                    dawExtraState.scaleContents = tc;
-                }
-            }
+        formulaFromXMLElement(fs, p);
+        p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("formula"));
+    }
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("hasMapping"));
+    for (int i = 0; i < n_customcontrollers; i++)
+    {
+        scene[0].modsources[ms_ctrl1 + i]->reset();
+    }
 
-            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
+    {
+        /*
+         * Reset to UNSCALED then try and read
+         */
+        for (int sc = 0; sc < n_scenes; sc++)
+        {
+            for (int l = 0; l < n_lfos; l++)
             {
-                dawExtraState.hasMapping = (ival != 0);
+                scene[sc].lfo[l].lfoExtraAmplitude = LFOStorage::UNSCALED;
             }
-
-            if (dawExtraState.hasMapping)
+        }
+        auto *el = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("extralfo"));
+        if (el)
+        {
+            auto l = TINYXML_SAFE_TO_ELEMENT(el->FirstChild("lfo"));
+            while (l)
             {
-                p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mappingContents"));
-
-                if (p && (td = p->Attribute("v")))
+                int sc, id, val;
+                if (l->QueryIntAttribute("scene", &sc) == TIXML_SUCCESS &&
+                    l->QueryIntAttribute("i", &id) == TIXML_SUCCESS &&
+                    l->QueryIntAttribute("extraAmplitude", &val) == TIXML_SUCCESS && sc >= 0 &&
+                    id >= 0 && sc < n_scenes && id < n_lfos)
                 {
-                    auto tc = base64_decode(td);
-
-                    dawExtraState.mappingContents = tc;
+                    scene[sc].lfo[id].lfoExtraAmplitude = (LFOStorage::LFOExtraOutputAmplitude)val;
                 }
+                l = TINYXML_SAFE_TO_ELEMENT(l->NextSiblingElement("lfo"));
+            }
+        }
+    }
 
-                p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mappingName"));
+    TiXmlElement *cc = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("customcontroller"));
 
-                if (p && (td = p->Attribute("v")))
-                {
-                    dawExtraState.mappingName = td;
-                }
-                else
-                {
-                    dawExtraState.mappingName = "";
-                }
-            }
+    if (cc)
+    {
+        p = TINYXML_SAFE_TO_ELEMENT(cc->FirstChild("entry"));
+    }
+    else
+    {
+        p = nullptr;
+    }
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("mapChannelToOctave"));
+    while (p)
+    {
+        int cont, sc;
 
-            if (p && p->QueryIntAttribute("v", &ival) == TIXML_SUCCESS)
+        if ((p->QueryIntAttribute("i", &cont) == TIXML_SUCCESS) &&
+            within_range(0, cont, n_customcontrollers - 1) &&
+            ((p->QueryIntAttribute("scene", &sc) != TIXML_SUCCESS) || (sc == 0)))
+        {
+            if (p->QueryIntAttribute("bipolar", &j) == TIXML_SUCCESS)
             {
-                dawExtraState.mapChannelToOctave = (ival != 0);
+                scene[0].modsources[ms_ctrl1 + cont]->set_bipolar(j);
             }
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("midictrl_map"));
-
-            if (p)
+            if (p->QueryDoubleAttribute("v", &d) == TIXML_SUCCESS)
             {
-                auto c = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("c"));
-
-                while (c)
-                {
-                    int p, v;
-
-                    if (c->QueryIntAttribute("p", &p) == TIXML_SUCCESS &&
-                        c->QueryIntAttribute("v", &v) == TIXML_SUCCESS)
-                    {
-                        dawExtraState.midictrl_map[p] = v;
-                    }
-
-                    c = TINYXML_SAFE_TO_ELEMENT(c->NextSibling("c"));
-                }
+                ((ControllerModulationSource *)scene[0].modsources[ms_ctrl1 + cont])->init(d);
             }
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("midichan_map"));
+            const char *lbl = p->Attribute("label");
 
-            if (p)
+            if (lbl)
             {
-                auto ch = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("ch"));
-
-                while (ch)
-                {
-                    int p, v;
+                strxcpy(CustomControllerLabel[cont], lbl, CUSTOM_CONTROLLER_LABEL_SIZE);
+            }
+        }
 
-                    if (ch->QueryIntAttribute("p", &p) == TIXML_SUCCESS &&
-                        ch->QueryIntAttribute("v", &v) == TIXML_SUCCESS)
-                    {
-                        dawExtraState.midichan_map[p] = v;
-                    }
+        p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling("entry"));
+    }
 
-                    ch = TINYXML_SAFE_TO_ELEMENT(ch->NextSibling("ch"));
-                }
-            }
-            else
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        for (int i = 0; i < n_lfos; ++i)
+        {
+            for (int d = 0; d < max_lfo_indices; ++d)
             {
-                dawExtraState.midichan_map.clear();
+                LFOBankLabel[s][i][d][0] = 0;
             }
+        }
+    }
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("customcontrol_map"));
+    TiXmlElement *lflb = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("lfobanklabels"));
 
-            if (p)
-            {
-                auto c = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("c"));
+    if (lflb)
+    {
+        auto lb = TINYXML_SAFE_TO_ELEMENT(lflb->FirstChild("label"));
 
-                while (c)
-                {
-                    int p, v;
+        while (lb)
+        {
+            int lfo, idx, scene;
 
-                    if (c->QueryIntAttribute("p", &p) == TIXML_SUCCESS &&
-                        c->QueryIntAttribute("v", &v) == TIXML_SUCCESS)
-                    {
-                        dawExtraState.customcontrol_map[p] = v;
-                    }
+            if (lb->QueryIntAttribute("lfo", &lfo) == TIXML_SUCCESS &&
+                lb->QueryIntAttribute("idx", &idx) == TIXML_SUCCESS &&
+                lb->QueryIntAttribute("scene", &scene) == TIXML_SUCCESS)
+                strxcpy(LFOBankLabel[scene][lfo][idx], lb->Attribute("v"),
+                        CUSTOM_CONTROLLER_LABEL_SIZE);
+            lb = TINYXML_SAFE_TO_ELEMENT(lb->NextSibling("label"));
+        }
+    }
 
-                    c = TINYXML_SAFE_TO_ELEMENT(c->NextSibling("c"));
-                }
-            }
+    patchTuning.tuningStoredInPatch = false;
+    patchTuning.scaleContents = "";
+    patchTuning.mappingContents = "";
+    patchTuning.mappingName = "";
 
-            p = TINYXML_SAFE_TO_ELEMENT(de->FirstChild("customcontrol_chan_map"));
+    TiXmlElement *pt = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("patchTuning"));
 
-            if (p)
-            {
-                auto ch = TINYXML_SAFE_TO_ELEMENT(p->FirstChild("ch"));
+    if (pt)
+    {
+        const char *td;
 
-                while (ch)
-                {
-                    int p, v;
+        if (pt && (td = pt->Attribute("v")))
+        {
+            auto tc = base64_decode(td);
 
-                    if (ch->QueryIntAttribute("p", &p) == TIXML_SUCCESS &&
-                        ch->QueryIntAttribute("v", &v) == TIXML_SUCCESS)
-                    {
-                        dawExtraState.customcontrol_chan_map[p] = v;
-                    }
+            patchTuning.tuningStoredInPatch = true;
+            patchTuning.scaleContents = tc;
+        }
 
-                    ch = TINYXML_SAFE_TO_ELEMENT(ch->NextSibling("ch"));
-                }
-            }
-            else
-            {
-                dawExtraState.customcontrol_chan_map.clear();
-            }
+        if (pt && (td = pt->Attribute("m")))
+        {
+            auto tc = base64_decode(td);
+
+            patchTuning.tuningStoredInPatch = true;
+            patchTuning.mappingContents = tc;
+        }
+
+        if (patchTuning.tuningStoredInPatch && pt && (td = pt->Attribute("mname")))
+        {
+            patchTuning.mappingName = td;
         }
     }
 
+    load_daw_extra_state(patch);
+
     if (!is_preset)
     {
         TiXmlElement *mw = TINYXML_SAFE_TO_ELEMENT(patch->FirstChild("modwheel"));
@@ -3178,6 +3349,17 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
         return 0;
     }
 
+    std::string s;
+    save_xml_into(s);
+
+    void *d = malloc(s.size());
+    memcpy(d, s.data(), s.size());
+    *data = d;
+    return s.size();
+}
+
+void SurgePatch::save_xml_into(std::string &s)
+{
     char tempstr[TXT_SIZE];
     int n = param_ptr.size();
 
@@ -3342,6 +3524,14 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
     }
     nonparamconfig.InsertEndChild(hcs);
 
+    TiXmlElement wse("waveshaperevaluation");
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        auto an = std::string("sc") + std::to_string(sc);
+        wse.SetAttribute(an, (int)(storage->sceneWaveshaperEvaluation[sc]));
+    }
+    nonparamconfig.InsertEndChild(wse);
+
     // Revision 16 adds the TAM
     TiXmlElement tam("tuningApplicationMode");
     if (storage->oddsound_mts_active_as_client)
@@ -3397,6 +3587,32 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
     }
     patch.InsertEndChild(eod);
 
+    TiXmlElement efd("extrafxdata");
+    for (int slot = 0; slot < n_fx_slots; ++slot)
+    {
+        auto ir = fx[slot].p[ConvolutionEffect::conv_ir].val.i;
+
+        if (fx[slot].type.val.i != fxt_convolution || ir < 0 ||
+            ir >= (int)storage->ir_list.size())
+        {
+            continue;
+        }
+
+        auto &irp = storage->ir_list[ir];
+        TiXmlElement fn("fx_extra");
+
+        fn.SetAttribute("slot", slot);
+        fn.SetAttribute("ir", irp.name);
+
+        if (irp.category >= 0 && irp.category < (int)storage->ir_category.size())
+        {
+            fn.SetAttribute("ir_category", storage->ir_category[irp.category].name);
+        }
+
+        efd.InsertEndChild(fn);
+    }
+    patch.InsertEndChild(efd);
+
     TiXmlElement ss("stepsequences");
     for (int sc = 0; sc < n_scenes; sc++)
     {
@@ -3674,6 +3890,10 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
         mpm.SetAttribute("v", dawExtraState.monoPedalMode);
         dawExtraXML.InsertEndChild(mpm);
 
+        TiXmlElement mrc("midiReceiveChannelMask");
+        mrc.SetAttribute("v", dawExtraState.midiReceiveChannelMask);
+        dawExtraXML.InsertEndChild(mrc);
+
         TiXmlElement osd("oddsoundRetuneMode");
         osd.SetAttribute("v", dawExtraState.oddsoundRetuneMode);
         dawExtraXML.InsertEndChild(osd);
@@ -3770,13 +3990,8 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
     doc.InsertEndChild(decl);
     doc.InsertEndChild(patch);
 
-    std::string s;
+    s.clear();
     s << doc;
-
-    void *d = malloc(s.size());
-    memcpy(d, s.data(), s.size());
-    *data = d;
-    return s.size();
 }
 
 void SurgePatch::msegToXMLElement(MSEGStorage *ms, TiXmlElement &p) const
@@ -24,6 +24,7 @@
 #include "SurgeStorage.h"
 #include <set>
 #include <numeric>
+#include <algorithm>
 #include <cctype>
 #include <map>
 #include <queue>
@@ -50,6 +51,14 @@
 #include "FxPresetAndClipboardManager.h"
 #include "ModulatorPresetManager.h"
 #include "SurgeMemoryPools.h"
+#include "BackgroundService.h"
+#include "WavetableLoader.h"
+#include "PatchChunkCache.h"
+#include "FilterCoefficientCache.h"
+#include "TableWaveshapers.h"
+#include "DirectoryManifest.h"
+#include "SharedStorageCore.h"
+#include "WavetableDiskCache.h"
 #include "sst/basic-blocks/tables/SincTableProvider.h"
 
 // FIXME probably remove this when we remove the hardcoded hack below
@@ -66,6 +75,8 @@ std::string SurgeStorage::skipPatchLoadDataPathSentinel = "<SKIP-PATCH-SENTINEL>
 
 SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : otherscene_clients(0)
 {
+    startupConfig = config;
+
     auto suppliedDataPath = config.suppliedDataPath;
     bool loadWtAndPatch = true;
     loadWtAndPatch = !skipLoadWtAndPatch && suppliedDataPath != skipPatchLoadDataPathSentinel &&
@@ -94,8 +105,26 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
 
     _patch.reset(new SurgePatch(this));
 
+    // Reserve enough that copying the routing on the audio thread doesn't allocate in practice
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        modRoutingSnapshot.voice[sc].reserve(256);
+        modRoutingSnapshot.scene[sc].reserve(256);
+    }
+    modRoutingSnapshot.global.reserve(256);
+    selectModRouting(false);
+
+    for (auto &c : compiledVoiceRouting)
+    {
+        c.order.reserve(256);
+        c.source.reserve(256);
+        c.sourceIndex.reserve(256);
+        c.destination.reserve(256);
+        c.depth.reserve(256);
+    }
+
     namespace tabl = sst::basic_blocks::tables;
-    sincTableProvider = std::make_unique<tabl::SurgeSincTableProvider>();
+    sincTableProvider = Surge::Storage::sharedSincTables();
     static_assert(tabl::SurgeSincTableProvider::FIRipol_M == FIRipol_M);
     static_assert(tabl::SurgeSincTableProvider::FIRipol_N == FIRipol_N);
     static_assert(tabl::SurgeSincTableProvider::FIRipolI16_N == FIRipolI16_N);
@@ -103,6 +132,17 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     sinctable1X = sincTableProvider->sinctable1X;
     sinctableI16 = sincTableProvider->sinctableI16;
 
+    auto &lookup = Surge::Storage::sharedLookupTables();
+    table_dB = lookup.dB;
+    table_glide_exp = lookup.glide_exp;
+    table_glide_log = lookup.glide_log;
+    table_pitch_ignoring_tuning = lookup.pitch;
+    table_pitch_inv_ignoring_tuning = lookup.pitch_inv;
+    table_two_to_the = lookup.two_to_the;
+    table_two_to_the_minus = lookup.two_to_the_minus;
+    // once per process, and here so the first table mode switch doesn't build them in audio
+    Surge::DSP::prepareTableWaveshapers();
+
     for (int s = 0; s < n_scenes; s++)
         for (int m = 0; m < n_modsources; ++m)
             getPatch().scene[s].modsource_doprocess[m] = false;
@@ -142,6 +182,7 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
         }
     }
 
+    filterCoefficientCache = std::make_unique<FilterCoefficientCache>();
     init_tables();
 
     pitch_bend = 0;
@@ -171,6 +212,7 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
                 poly_aftertouch[s][c][cc] = 0.f;
 
     memset(&audio_in[0][0], 0, 2 * BLOCK_SIZE_OS * sizeof(float));
+    memset(&audio_in_nonOS[0][0], 0, 2 * BLOCK_SIZE * sizeof(float));
 
     bool hasSuppliedDataPath = !suppliedDataPath.empty();
     std::string buildOverrideDataPath;
@@ -286,9 +328,12 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
 
     userDefaultFilePath = userDataPath;
 
-    userDefaultsProvider = std::make_unique<Surge::Storage::UserDefaultsProvider>(
-        userDataPath, "SurgeXT", Surge::Storage::defaultKeyToString,
-        [this](auto &a, auto &b) { reportError(a, b); });
+    if (config.readUserDefaults)
+    {
+        userDefaultsProvider = std::make_unique<Surge::Storage::UserDefaultsProvider>(
+            userDataPath, "SurgeXT", Surge::Storage::defaultKeyToString,
+            [this](auto &a, auto &b) { reportError(a, b); });
+    }
 
     std::string userSpecifiedDataPath =
         Surge::Storage::getUserDefaultValue(this, Surge::Storage::UserDataPath, "UNSPEC");
@@ -301,6 +346,7 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     userPatchesPath = userDataPath / "Patches";
     userWavetablesPath = userDataPath / "Wavetables";
     userWavetablesExportPath = userWavetablesPath / "Exported";
+    userImpulseResponsesPath = userDataPath / "Impulse Responses";
     userFXPath = userDataPath / "FX Presets";
     userMidiMappingsPath = userDataPath / "MIDI Mappings";
     userModulatorSettingsPath = userDataPath / "Modulator Presets";
@@ -342,14 +388,20 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
 #endif
     }
 
-    load_midi_controllers();
+    load_midi_controllers(config.loadUserMidiMappings);
 
     patchDB = std::make_unique<Surge::PatchStorage::PatchDB>(this);
-    if (loadWtAndPatch)
+    if (loadWtAndPatch && config.deferDirectoryScans)
+    {
+        directoryScansDeferred = true;
+    }
+    else if (loadWtAndPatch)
     {
         refresh_wtlist();
         refresh_patchlist();
+        refresh_irlist();
     }
+    reuseSharedDirectoryScans = false;
 
 #if HAS_JUCE
     if (!load_wt_wt_mem(SurgeSharedBinary::windows_wt, SurgeSharedBinary::windows_wtSize,
@@ -392,7 +444,7 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     Surge::Formula::setupStorage(this);
 
     // Load the XML DocStrings if we are loading startup data
-    if (loadWtAndPatch)
+    if (loadWtAndPatch && !directoryScansDeferred)
     {
 #if HAS_JUCE
         auto pdData = std::string(SurgeSharedBinary::paramdocumentation_xml,
@@ -489,6 +541,21 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     monoPedalMode = (MonoPedalMode)Surge::Storage::getUserDefaultValue(
         this, Surge::Storage::MonoPedalMode, MonoPedalMode::HOLD_ALL_NOTES);
 
+    offlineHighestQuality =
+        Surge::Storage::getUserDefaultValue(this, Surge::Storage::OfflineRenderHighestQuality, true);
+    glideHostTempo =
+        Surge::Storage::getUserDefaultValue(this, Surge::Storage::GlideHostTempo, false);
+    halfbandProfile = (HalfbandProfile)std::clamp(
+        Surge::Storage::getUserDefaultValue(this, Surge::Storage::HalfbandProfile,
+                                            (int)HALFBAND_STANDARD),
+        (int)HALFBAND_LOW_CPU, (int)HALFBAND_HIGH);
+
+    voiceCapacity = config.voiceCapacity;
+    if (voiceCapacity <= 0)
+        voiceCapacity =
+            Surge::Storage::getUserDefaultValue(this, Surge::Storage::VoiceCapacity, MAX_VOICES);
+    voiceCapacity = std::clamp((voiceCapacity + 3) & ~3, 8, MAX_VOICES);
+
     for (int s = 0; s < n_scenes; ++s)
     {
         getPatch().scene[s].drift.set_extend_range(true);
@@ -515,12 +582,34 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
         this, Surge::Storage::InitialPatchCategoryType, "Factory");
 
     fxUserPreset = std::make_unique<Surge::Storage::FxUserPreset>();
-    fxUserPreset->doPresetRescan(this);
+    if (!directoryScansDeferred)
+    {
+        fxUserPreset->doPresetRescan(this);
+    }
 
     modulatorPreset = std::make_unique<Surge::Storage::ModulatorPreset>();
     modulatorPreset->forcePresetRescan();
 
     memoryPools = std::make_unique<Surge::Memory::SurgeMemoryPools>(this);
+    backgroundService = std::make_unique<Surge::Threading::BackgroundService>();
+    patchChunkCache = std::make_unique<Surge::Storage::PatchChunkCache>();
+    wavetableDiskCache =
+        std::make_unique<Surge::Storage::WavetableDiskCache>(userDataPath / fs::path{"WTCache"});
+}
+
+void SurgeStorage::ensureDirectoryScans()
+{
+    if (!directoryScansDeferred)
+        return;
+
+    // this is the scan the constructor skipped, so it can share like the constructor would
+    directoryScansDeferred = false;
+    reuseSharedDirectoryScans = true;
+    refresh_wtlist();
+    refresh_patchlist();
+    refresh_irlist();
+    reuseSharedDirectoryScans = false;
+    fxUserPreset->doPresetRescan(this);
 }
 
 void SurgeStorage::createUserDirectory()
@@ -538,7 +627,7 @@ void SurgeStorage::createUserDirectory()
         {
             for (auto &s : {userDataPath, userDefaultFilePath, userPatchesPath, userWavetablesPath,
                             userModulatorSettingsPath, userFXPath, userWavetablesExportPath,
-                            userSkinsPath, userMidiMappingsPath})
+                            userSkinsPath, userMidiMappingsPath, userImpulseResponsesPath})
                 fs::create_directories(s);
 
 #if HAS_JUCE
@@ -636,16 +725,98 @@ void SurgeStorage::initializePatchDb(bool force)
 
 SurgePatch &SurgeStorage::getPatch() const { return *_patch.get(); }
 
+void SurgeStorage::selectModRouting(bool useSnapshot)
+{
+    auto &patch = getPatch();
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        modRouting.voice[sc] =
+            useSnapshot ? &modRoutingSnapshot.voice[sc] : &patch.scene[sc].modulation_voice;
+        modRouting.scene[sc] =
+            useSnapshot ? &modRoutingSnapshot.scene[sc] : &patch.scene[sc].modulation_scene;
+    }
+
+    modRouting.global = useSnapshot ? &modRoutingSnapshot.global : &patch.modulation_global;
+}
+
+void SurgeStorage::compileVoiceRouting()
+{
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        auto &r = *modRouting.voice[sc];
+        auto &c = compiledVoiceRouting[sc];
+
+        c.order.clear();
+
+        for (int i = 0; i < (int)r.size(); ++i)
+        {
+            if (!r[i].muted)
+                c.order.push_back(i);
+        }
+
+        std::sort(c.order.begin(), c.order.end(), [&r](int a, int b) {
+            if (r[a].source_id != r[b].source_id)
+                return r[a].source_id < r[b].source_id;
+            if (r[a].source_index != r[b].source_index)
+                return r[a].source_index < r[b].source_index;
+            return a < b;
+        });
+
+        c.count = c.order.size();
+        c.source.resize(c.count);
+        c.sourceIndex.resize(c.count);
+        c.destination.resize(c.count);
+        c.depth.resize(c.count);
+
+        for (int i = 0; i < c.count; ++i)
+        {
+            auto &mr = r[c.order[i]];
+            c.source[i] = mr.source_id;
+            c.sourceIndex[i] = mr.source_index;
+            c.destination[i] = mr.destination_id;
+            c.depth[i] = mr.depth;
+        }
+    }
+}
+
+void SurgeStorage::captureModRoutingSnapshot()
+{
+    auto &patch = getPatch();
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        modRoutingSnapshot.voice[sc].assign(patch.scene[sc].modulation_voice.begin(),
+                                            patch.scene[sc].modulation_voice.end());
+        modRoutingSnapshot.scene[sc].assign(patch.scene[sc].modulation_scene.begin(),
+                                            patch.scene[sc].modulation_scene.end());
+    }
+
+    modRoutingSnapshot.global.assign(patch.modulation_global.begin(),
+                                     patch.modulation_global.end());
+}
+
 struct PEComparer
 {
     bool operator()(const Patch &a, const Patch &b) { return a.name.compare(b.name) < 0; }
 };
 
+fs::path SurgeStorage::patchDirectoryManifestPath() const
+{
+    return userDataPath / fs::path{"SurgePatches.manifest"};
+}
+
 void SurgeStorage::refresh_patchlist()
 {
     patch_category.clear();
     patch_list.clear();
 
+    if (!patchDirectoryManifest)
+    {
+        patchDirectoryManifest = std::make_unique<Surge::Storage::DirectoryManifest>();
+        patchDirectoryManifest->load(patchDirectoryManifestPath());
+    }
+
     refreshPatchlistAddDir(false, "patches_factory");
     firstThirdPartyCategory = patch_category.size();
 
@@ -653,6 +824,14 @@ void SurgeStorage::refresh_patchlist()
     firstUserCategory = patch_category.size();
     refreshPatchlistAddDir(true, "Patches");
 
+    patchDirectoryManifest->pruneUnvisited();
+
+    if (patchDirectoryManifest->isDirty() && fs::is_directory(userDataPath))
+    {
+        // if we can't write it we just scan everything again next time
+        patchDirectoryManifest->save(patchDirectoryManifestPath());
+    }
+
     patchOrdering = std::vector<int>(patch_list.size());
     std::iota(patchOrdering.begin(), patchOrdering.end(), 0);
 
@@ -687,6 +866,41 @@ void SurgeStorage::refresh_patchlist()
         patch_category[patchCategoryOrdering[i]].order = i;
     }
 
+    patchesInCategory.assign(patch_category.size(), {});
+    childCategoriesOf.assign(patch_category.size(), {});
+
+    for (auto p : patchOrdering)
+    {
+        auto c = patch_list[p].category;
+
+        if (c >= 0 && c < patch_category.size())
+        {
+            patchesInCategory[c].push_back(p);
+        }
+    }
+
+    // children are held by value, so find them by name and id; the first match wins as before
+    std::map<std::pair<std::string, int>, int> categoryIndex;
+
+    for (int i = 0; i < patch_category.size(); i++)
+    {
+        categoryIndex.emplace(std::make_pair(patch_category[i].name, patch_category[i].internalid),
+                              i);
+    }
+
+    for (int i = 0; i < patch_category.size(); i++)
+    {
+        for (auto &child : patch_category[i].children)
+        {
+            auto ci = categoryIndex.find(std::make_pair(child.name, child.internalid));
+
+            if (ci != categoryIndex.end())
+            {
+                childCategoriesOf[i].push_back(ci->second);
+            }
+        }
+    }
+
     auto favorites = patchDB->readUserFavorites();
     auto pathToTrunc = [](const std::string &s) -> std::string {
         auto pf = s.find("patches_factory");
@@ -735,17 +949,81 @@ void SurgeStorage::refreshPatchlistAddDir(bool userDir, string subdir)
     refreshPatchOrWTListAddDir(
         userDir, userDir ? userDataPath : datapath, subdir,
         [](std::string s) -> bool { return _stricmp(s.c_str(), ".fxp") == 0; }, patch_list,
-        patch_category);
+        patch_category, patchDirectoryManifest.get());
 }
 
 void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &initialPatchPath,
                                               string subdir,
                                               std::function<bool(std::string)> filterOp,
                                               std::vector<Patch> &items,
-                                              std::vector<PatchCategory> &categories)
+                                              std::vector<PatchCategory> &categories,
+                                              Surge::Storage::DirectoryManifest *manifest)
+{
+    if (userDir)
+    {
+        scanPatchOrWTDir(userDir, initialPatchPath, subdir, filterOp, items, categories, manifest);
+        return;
+    }
+
+    auto dir = subdir.empty() ? initialPatchPath : initialPatchPath / subdir;
+    auto key = path_to_string(dir);
+
+    std::shared_ptr<const Surge::Storage::SharedDirectoryScan> scan;
+    if (reuseSharedDirectoryScans)
+        scan = Surge::Storage::findSharedDirectoryScan(key);
+
+    if (scan)
+    {
+        // we didn't walk it, but it is still there, so don't let the manifest forget it
+        if (manifest)
+            manifest->markVisitedUnder(dir);
+    }
+    else
+    {
+        auto fresh = std::make_shared<Surge::Storage::SharedDirectoryScan>();
+        scanPatchOrWTDir(userDir, initialPatchPath, subdir, filterOp, fresh->items,
+                         fresh->categories, manifest);
+        Surge::Storage::publishSharedDirectoryScan(key, fresh);
+        scan = fresh;
+    }
+
+    heldDirectoryScans[key] = scan;
+
+    // the shared scan numbers its categories from zero, so shift them to follow ours
+    int offset = categories.size();
+    std::function<void(PatchCategory &)> rebase = [&rebase, offset](PatchCategory &c) {
+        c.internalid += offset;
+        for (auto &ckid : c.children)
+            rebase(ckid);
+    };
+
+    for (auto e : scan->items)
+    {
+        e.category += offset;
+        items.push_back(std::move(e));
+    }
+
+    for (auto c : scan->categories)
+    {
+        rebase(c);
+        categories.push_back(std::move(c));
+    }
+}
+
+void SurgeStorage::scanPatchOrWTDir(bool userDir, const fs::path &initialPatchPath,
+                                    const std::string &subdir,
+                                    const std::function<bool(std::string)> &filterOp,
+                                    std::vector<Patch> &items,
+                                    std::vector<PatchCategory> &categories,
+                                    Surge::Storage::DirectoryManifest *manifest)
 {
     int category = categories.size();
 
+    // without a persistent manifest we still use a throwaway one, so each directory is read once
+    Surge::Storage::DirectoryManifest localManifest;
+    if (!manifest)
+        manifest = &localManifest;
+
     // See issue 4200. In some cases this can throw a filesystem exception so:
     std::vector<PatchCategory> local_categories;
 
@@ -776,13 +1054,11 @@ void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &init
         {
             auto top = workStack.front();
             workStack.pop_front();
-            for (auto &d : fs::directory_iterator(top))
+            for (auto &sd : manifest->list(top, filterOp).subdirs)
             {
-                if (fs::is_directory(d))
-                {
-                    alldirs.push_back(d);
-                    workStack.push_back(d);
-                }
+                auto d = top / string_to_path(sd);
+                alldirs.push_back(d);
+                workStack.push_back(d);
             }
         }
 
@@ -808,20 +1084,19 @@ void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &init
             c.isFactory = !userDir;
 
             c.numberOfPatchesInCatgory = 0;
-            for (auto &f : fs::directory_iterator(p))
+            for (auto &fn : manifest->list(p, filterOp).files)
             {
-                std::string xtn = path_to_string(f.path().extension());
-                if (filterOp(xtn))
-                {
-                    Patch e;
-                    e.category = category;
-                    e.path = f.path();
-                    e.name = path_to_string(f.path().filename());
-                    e.name = e.name.substr(0, e.name.size() - xtn.length());
-                    items.push_back(e);
-
-                    c.numberOfPatchesInCatgory++;
-                }
+                auto f = p / string_to_path(fn);
+                std::string xtn = path_to_string(f.extension());
+
+                Patch e;
+                e.category = category;
+                e.path = f;
+                e.name = path_to_string(f.filename());
+                e.name = e.name.substr(0, e.name.size() - xtn.length());
+                items.push_back(e);
+
+                c.numberOfPatchesInCatgory++;
             }
 
             c.numberOfPatchesInCategoryAndChildren = c.numberOfPatchesInCatgory;
@@ -1046,8 +1321,42 @@ void SurgeStorage::refresh_wtlistFrom(bool isUser, const fs::path &p, const std:
         wt_list, wt_category);
 }
 
-void SurgeStorage::perform_queued_wtloads()
+void SurgeStorage::refresh_irlist()
+{
+    ir_list.clear();
+    ir_category.clear();
+
+    auto isWav = [](std::string in) -> bool { return _stricmp(in.c_str(), ".wav") == 0; };
+
+    refreshPatchOrWTListAddDir(false, datapath, "impulse_responses", isWav, ir_list, ir_category);
+    refreshPatchOrWTListAddDir(true, userDataPath, "Impulse Responses", isWav, ir_list,
+                               ir_category);
+
+    std::sort(ir_list.begin(), ir_list.end(), [](const Patch &a, const Patch &b) {
+        return strnatcasecmp(a.name.c_str(), b.name.c_str()) < 0;
+    });
+}
+
+void SurgeStorage::setLoadWavetablesOffAudioThread(bool b)
 {
+    if (b && !wavetableLoader)
+    {
+        wavetableLoader = std::make_unique<Surge::Storage::WavetableLoader>(this);
+    }
+    else if (!b)
+    {
+        wavetableLoader.reset();
+    }
+}
+
+void SurgeStorage::perform_queued_wtloads(bool allowBackgroundLoad)
+{
+    if (wavetableLoader && allowBackgroundLoad)
+    {
+        wavetableLoader->processQueuedLoads();
+        return;
+    }
+
     SurgePatch &patch =
         getPatch(); // Change here is for performance and ease of debugging, simply not calling
                     // getPatch so many times. Code should behave identically.
@@ -1132,8 +1441,16 @@ void SurgeStorage::load_wt(int id, Wavetable *wt, OscillatorStorage *osc)
     }
 }
 
-void SurgeStorage::load_wt(string filename, Wavetable *wt, OscillatorStorage *osc)
+void SurgeStorage::load_wt(string filename, Wavetable *wt, OscillatorStorage *osc,
+                           int headWindows, bool *headOnly)
 {
+    if (headOnly)
+        *headOnly = false;
+
+    noteBlockEvent(be_wavetableLoad);
+    Surge::Profiling::PatchLoadProfile::Scope ps(patchLoadProfile,
+                                                 Surge::Profiling::PatchLoadProfile::lp_wavetables);
+
     wt->current_filename = wt->queue_filename;
     wt->queue_filename = "";
 
@@ -1152,7 +1469,7 @@ void SurgeStorage::load_wt(string filename, Wavetable *wt, OscillatorStorage *os
     }
     else if (extension.compare(".wav") == 0)
     {
-        loaded = load_wt_wav_portable(filename, wt);
+        loaded = load_wt_wav_portable(filename, wt, headWindows, headOnly);
     }
     else
     {
@@ -1224,9 +1541,7 @@ bool SurgeStorage::load_wt_wt(string filename, Wavetable *wt)
         memset(dpad, 0, drest);
     }
 
-    waveTableDataMutex.lock();
-    bool wasBuilt = wt->BuildWT(data.get(), wh, false);
-    waveTableDataMutex.unlock();
+    bool wasBuilt = buildSharedWT(data.get(), ds, wh, wt);
 
     if (!wasBuilt)
     {
@@ -1248,6 +1563,38 @@ bool SurgeStorage::load_wt_wt(string filename, Wavetable *wt)
     return wasBuilt;
 }
 
+bool SurgeStorage::buildSharedWT(void *data, size_t dataSize, wt_header &wh, Wavetable *wt)
+{
+    auto key = Surge::Storage::sharedWavetableKeyFor(wh, data, dataSize);
+    auto shared = Surge::Storage::findSharedWavetable(key);
+
+    if (!shared)
+    {
+        // build outside the lock; only the hand over needs to exclude the UI
+        auto built = std::make_shared<Wavetable>();
+        bool fromDisk = wavetableDiskCache && wavetableDiskCache->load(key, *built);
+
+        if (!fromDisk)
+        {
+            if (!built->BuildWT(data, wh, false))
+                return false;
+
+            // like the patch manifest, only write into a user directory which already exists
+            if (wavetableDiskCache && fs::is_directory(userDataPath))
+                wavetableDiskCache->store(key, *built);
+        }
+
+        Surge::Storage::publishSharedWavetable(key, built);
+        shared = built;
+    }
+
+    waveTableDataMutex.lock();
+    wt->shareTablesWith(shared);
+    waveTableDataMutex.unlock();
+
+    return true;
+}
+
 bool SurgeStorage::load_wt_wt_mem(const char *data, size_t dataSize, Wavetable *wt)
 {
     wt_header wh;
@@ -1278,9 +1625,7 @@ bool SurgeStorage::load_wt_wt_mem(const char *data, size_t dataSize, Wavetable *
     }
 
     const char *wtData = data + sizeof(wt_header);
-    waveTableDataMutex.lock();
-    bool wasBuilt = wt->BuildWT((void *)wtData, wh, false);
-    waveTableDataMutex.unlock();
+    bool wasBuilt = buildSharedWT((void *)wtData, ds, wh, wt);
 
     if (!wasBuilt)
     {
@@ -1447,14 +1792,13 @@ void SurgeStorage::clipboard_copy(int type, int scene, int entry, modsources ms)
 
         for (int i = 0; i < n; i++)
         {
-            Parameter p = *getPatch().param_ptr[i];
+            const Parameter *p = getPatch().param_ptr[i];
 
-            if (((p.ctrlgroup == cgroup) || (cgroup < 0)) &&
-                ((p.ctrlgroup_entry == cgroup_e) || (cgroup_e < 0)) && (p.scene == (scene + 1)))
+            if (((p->ctrlgroup == cgroup) || (cgroup < 0)) &&
+                ((p->ctrlgroup_entry == cgroup_e) || (cgroup_e < 0)) && (p->scene == (scene + 1)))
             {
-                p.id = p.id - id;
-                used_entries.insert(p.id);
-                clipboard_p.push_back(p);
+                used_entries.insert(p->id - id);
+                clipboard_p.push_back({p->id - id, p->get_state()});
             }
         }
 
@@ -1587,7 +1931,7 @@ void SurgeStorage::clipboard_paste(int type, int scene, int entry, modsources ms
         cgroup = cg_OSC;
         cgroup_e = entry;
         id = getPatch().scene[scene].osc[entry].type.id; // first parameter id
-        getPatch().scene[scene].osc[entry].type.val.i = clipboard_p[0].val.i;
+        getPatch().scene[scene].osc[entry].type.val.i = clipboard_p[0].state.val.i;
         start = 1;
         getPatch().update_controls(false, &getPatch().scene[scene].osc[entry]);
 
@@ -1656,18 +2000,9 @@ void SurgeStorage::clipboard_paste(int type, int scene, int entry, modsources ms
     {
         for (int i = start; i < n; i++)
         {
-            Parameter p = clipboard_p[i];
-            int pid = p.id + id;
-            getPatch().param_ptr[pid]->val.i = p.val.i;
-            getPatch().param_ptr[pid]->temposync = p.temposync;
-            getPatch().param_ptr[pid]->set_extend_range(p.extend_range);
-            getPatch().param_ptr[pid]->deactivated = p.deactivated;
-            getPatch().param_ptr[pid]->absolute = p.absolute;
-            getPatch().param_ptr[pid]->porta_constrate = p.porta_constrate;
-            getPatch().param_ptr[pid]->porta_gliss = p.porta_gliss;
-            getPatch().param_ptr[pid]->porta_retrigger = p.porta_retrigger;
-            getPatch().param_ptr[pid]->porta_curve = p.porta_curve;
-            getPatch().param_ptr[pid]->deform_type = p.deform_type;
+            const auto &p = clipboard_p[i].state;
+            int pid = clipboard_p[i].id + id;
+            getPatch().param_ptr[pid]->set_state(p);
 
             /*
              * This is a really nasty special case that the bool relative switch
@@ -1943,13 +2278,13 @@ void SurgeStorage::setSamplerate(float sr)
     }
 }
 
-void SurgeStorage::load_midi_controllers()
+void SurgeStorage::load_midi_controllers(bool readUserDefaultsFile)
 {
     auto mcp = userDataPath / "SurgeMIDIDefaults.xml";
     TiXmlDocument mcd;
     TiXmlElement *midiRoot = nullptr;
 
-    if (mcd.LoadFile(mcp))
+    if (readUserDefaultsFile && mcd.LoadFile(mcp))
     {
         midiRoot = mcd.FirstChildElement("midiconfig");
     }
@@ -2033,10 +2368,15 @@ void SurgeStorage::load_midi_controllers()
 
         entry = TINYXML_SAFE_TO_ELEMENT(entry->NextSibling("entry"));
     }
+
+    midiMappingChanged();
 }
 
 SurgeStorage::~SurgeStorage()
 {
+    // the loader thread reads the wavetable list, so stop it before anything else goes away
+    wavetableLoader.reset();
+
 #ifndef SURGE_SKIP_ODDSOUND_MTS
     if (oddsound_mts_active_as_main)
         disconnect_as_oddsound_main();
@@ -2051,34 +2391,25 @@ void SurgeStorage::init_tables()
 {
     isStandardTuning = true;
     float db60 = powf(10.f, 0.05f * -60.f);
-    float _512th = 1.f / 512.f;
+
+    auto &tt = spareTuningTables();
 
     for (int i = 0; i < tuning_table_size; i++)
     {
-        table_dB[i] = powf(10.f, 0.05f * ((float)i - 384.f));
-        table_pitch[i] = powf(2.f, ((float)i - 256.f) * (1.f / 12.f));
-        table_pitch_ignoring_tuning[i] = table_pitch[i];
-        table_pitch_inv[i] = 1.f / table_pitch[i];
-        table_pitch_inv_ignoring_tuning[i] = table_pitch_inv[i];
-        table_note_omega[0][i] =
-            (float)sin(2 * M_PI * min(0.5, 440 * table_pitch[i] * dsamplerate_os_inv));
-        table_note_omega[1][i] =
-            (float)cos(2 * M_PI * min(0.5, 440 * table_pitch[i] * dsamplerate_os_inv));
-        table_note_omega_ignoring_tuning[0][i] = table_note_omega[0][i];
-        table_note_omega_ignoring_tuning[1][i] = table_note_omega[1][i];
+        tt.pitch[i] = table_pitch_ignoring_tuning[i];
+        tt.pitch_inv[i] = table_pitch_inv_ignoring_tuning[i];
+        tt.note_omega[0][i] =
+            (float)sin(2 * M_PI * min(0.5, 440 * tt.pitch[i] * dsamplerate_os_inv));
+        tt.note_omega[1][i] =
+            (float)cos(2 * M_PI * min(0.5, 440 * tt.pitch[i] * dsamplerate_os_inv));
+        table_note_omega_ignoring_tuning[0][i] = tt.note_omega[0][i];
+        table_note_omega_ignoring_tuning[1][i] = tt.note_omega[1][i];
         double k = dsamplerate_os * pow(2.0, (((double)i - 256.0) / 16.0)) / (double)BLOCK_SIZE_OS;
         table_envrate_linear[i] = (float)(1.f / k);
         table_envrate_lpf[i] = (float)(1.f - exp(log(db60) / k));
-        table_glide_log[i] = log2(1.0 + (i * _512th * 10.f)) / log2(1.f + 10.f);
-        table_glide_exp[511 - i] = 1.0 - table_glide_log[i];
     }
 
-    for (int i = 0; i < 1001; ++i)
-    {
-        double twelths = i * 1.0 / 12.0 / 1000.0;
-        table_two_to_the[i] = pow(2.0, twelths);
-        table_two_to_the_minus[i] = pow(2.0, -twelths);
-    }
+    liveTuningTables.store(&tt, std::memory_order_release);
 
     // include some margin for error (and to avoid denormals in IIR filter clamping)
     nyquist_pitch =
@@ -2109,7 +2440,9 @@ float SurgeStorage::note_to_pitch(float x)
         int e = (int)x;
         float a = x - (float)e;
 
-        return (1 - a) * table_pitch[e] + a * table_pitch[(e + 1) & 0x1ff];
+        const auto &tp = tuningTables().pitch;
+
+        return (1 - a) * tp[e] + a * tp[(e + 1) & 0x1ff];
     }
 }
 
@@ -2125,7 +2458,9 @@ float SurgeStorage::note_to_pitch_inv(float x)
         int e = (int)x;
         float a = x - (float)e;
 
-        return (1 - a) * table_pitch_inv[e] + a * table_pitch_inv[(e + 1) & 0x1ff];
+        const auto &tpi = tuningTables().pitch_inv;
+
+        return (1 - a) * tpi[e] + a * tpi[(e + 1) & 0x1ff];
     }
 }
 
@@ -2165,8 +2500,10 @@ void SurgeStorage::note_to_omega(float x, float &sinu, float &cosi)
     int e = (int)x;
     float a = x - (float)e;
 
-    sinu = (1 - a) * table_note_omega[0][e] + a * table_note_omega[0][(e + 1) & 0x1ff];
-    cosi = (1 - a) * table_note_omega[1][e] + a * table_note_omega[1][(e + 1) & 0x1ff];
+    const auto &tno = tuningTables().note_omega;
+
+    sinu = (1 - a) * tno[0][e] + a * tno[0][(e + 1) & 0x1ff];
+    cosi = (1 - a) * tno[1][e] + a * tno[1][(e + 1) & 0x1ff];
 }
 
 void SurgeStorage::note_to_omega_ignoring_tuning(float x, float &sinu, float &cosi,
@@ -2183,6 +2520,47 @@ void SurgeStorage::note_to_omega_ignoring_tuning(float x, float &sinu, float &co
            a * table_note_omega_ignoring_tuning[1][(e + 1) & 0x1ff];
 }
 
+namespace
+{
+// Interpolates a sin/cos omega table at four notes, clamped like the scalar lookup
+void lookup_note_omega(const float (&table)[2][SurgeStorage::tuning_table_size], __m128 x,
+                       __m128 &sinu, __m128 &cosi)
+{
+    x = _mm_add_ps(x, _mm_set1_ps(256.f));
+    x = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()),
+                   _mm_set1_ps(SurgeStorage::tuning_table_size - (float)1.e-4));
+    auto e = _mm_cvttps_epi32(x);
+    auto a = _mm_sub_ps(x, _mm_cvtepi32_ps(e));
+    auto oma = _mm_sub_ps(_mm_set1_ps(1.f), a);
+
+    int idx alignas(16)[4];
+    float s0 alignas(16)[4], s1 alignas(16)[4], c0 alignas(16)[4], c1 alignas(16)[4];
+    _mm_store_si128((__m128i *)idx, e);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        auto n = (idx[i] + 1) & 0x1ff;
+        s0[i] = table[0][idx[i]];
+        s1[i] = table[0][n];
+        c0[i] = table[1][idx[i]];
+        c1[i] = table[1][n];
+    }
+
+    sinu = _mm_add_ps(_mm_mul_ps(oma, _mm_load_ps(s0)), _mm_mul_ps(a, _mm_load_ps(s1)));
+    cosi = _mm_add_ps(_mm_mul_ps(oma, _mm_load_ps(c0)), _mm_mul_ps(a, _mm_load_ps(c1)));
+}
+} // namespace
+
+void SurgeStorage::note_to_omega(__m128 x, __m128 &sinu, __m128 &cosi)
+{
+    lookup_note_omega(tuningTables().note_omega, x, sinu, cosi);
+}
+
+void SurgeStorage::note_to_omega_ignoring_tuning(__m128 x, __m128 &sinu, __m128 &cosi)
+{
+    lookup_note_omega(table_note_omega_ignoring_tuning, x, sinu, cosi);
+}
+
 float SurgeStorage::db_to_linear(float x)
 {
     x += 384;
@@ -2192,6 +2570,26 @@ float SurgeStorage::db_to_linear(float x)
     return (1 - a) * table_dB[e & 0x1ff] + a * table_dB[(e + 1) & 0x1ff];
 }
 
+__m128 SurgeStorage::db_to_linear(__m128 x)
+{
+    x = _mm_add_ps(x, _mm_set1_ps(384.f));
+    auto e = _mm_cvttps_epi32(x);
+    auto a = _mm_sub_ps(x, _mm_cvtepi32_ps(e));
+
+    int idx alignas(16)[4];
+    float d0 alignas(16)[4], d1 alignas(16)[4];
+    _mm_store_si128((__m128i *)idx, e);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        d0[i] = table_dB[idx[i] & 0x1ff];
+        d1[i] = table_dB[(idx[i] + 1) & 0x1ff];
+    }
+
+    return _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.f), a), _mm_load_ps(d0)),
+                      _mm_mul_ps(a, _mm_load_ps(d1)));
+}
+
 float SurgeStorage::lookup_waveshape(sst::waveshapers::WaveshaperType entry, float x)
 {
     x *= 32.f;
@@ -2208,6 +2606,35 @@ float SurgeStorage::lookup_waveshape(sst::waveshapers::WaveshaperType entry, flo
     return (1 - a) * waveshapers[e & 0x3ff] + a * waveshapers[(e + 1) & 0x3ff];
 }
 
+__m128 SurgeStorage::lookup_waveshape(sst::waveshapers::WaveshaperType entry, __m128 x)
+{
+    x = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(32.f)), _mm_set1_ps(512.f));
+    auto e = _mm_cvttps_epi32(x);
+    auto a = _mm_sub_ps(x, _mm_cvtepi32_ps(e));
+
+    auto over = _mm_castsi128_ps(_mm_cmpgt_epi32(e, _mm_set1_epi32(0x3fd)));
+    auto under = _mm_castsi128_ps(_mm_cmplt_epi32(e, _mm_set1_epi32(1)));
+
+    const auto &waveshapers = sst::waveshapers::globalWaveshaperTables.waveshapers[(int)entry];
+    int idx alignas(16)[4];
+    float w0 alignas(16)[4], w1 alignas(16)[4];
+    _mm_store_si128((__m128i *)idx, e);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        w0[i] = waveshapers[idx[i] & 0x3ff];
+        w1[i] = waveshapers[(idx[i] + 1) & 0x3ff];
+    }
+
+    auto res = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.f), a), _mm_load_ps(w0)),
+                          _mm_mul_ps(a, _mm_load_ps(w1)));
+
+    res = _mm_or_ps(_mm_andnot_ps(over, res), _mm_and_ps(over, _mm_set1_ps(1.f)));
+    res = _mm_or_ps(_mm_andnot_ps(under, res), _mm_and_ps(under, _mm_set1_ps(-1.f)));
+
+    return res;
+}
+
 float SurgeStorage::lookup_waveshape_warp(sst::waveshapers::WaveshaperType entry, float x)
 {
     x *= 256.f;
@@ -2298,19 +2725,27 @@ bool SurgeStorage::resetToCurrentScaleAndMapping()
         tuningPitchInv = 1.0 / tuningPitch;
     }
 
-    for (int i = 0; i < 512; ++i)
-    {
-        table_pitch[i] = t.frequencyForMidiNoteScaledByMidi0(i - 256);
-        table_pitch_inv[i] = 1.f / table_pitch[i];
-        table_note_omega[0][i] =
-            (float)sin(2 * M_PI * min(0.5, 440 * table_pitch[i] * dsamplerate_os_inv));
-        table_note_omega[1][i] =
-            (float)cos(2 * M_PI * min(0.5, 440 * table_pitch[i] * dsamplerate_os_inv));
-    }
+    auto &tt = spareTuningTables();
+    fillTuningTables(tt, t);
+    liveTuningTables.store(&tt, std::memory_order_release);
+
     tuningUpdates++;
     return true;
 }
 
+void SurgeStorage::fillTuningTables(TuningTables &tt, const Tunings::Tuning &t)
+{
+    for (int i = 0; i < tuning_table_size; ++i)
+    {
+        tt.pitch[i] = t.frequencyForMidiNoteScaledByMidi0(i - 256);
+        tt.pitch_inv[i] = 1.f / tt.pitch[i];
+        tt.note_omega[0][i] =
+            (float)sin(2 * M_PI * min(0.5, 440 * tt.pitch[i] * dsamplerate_os_inv));
+        tt.note_omega[1][i] =
+            (float)cos(2 * M_PI * min(0.5, 440 * tt.pitch[i] * dsamplerate_os_inv));
+    }
+}
+
 void SurgeStorage::loadTuningFromSCL(const fs::path &p)
 {
     try
@@ -2478,6 +2913,8 @@ void SurgeStorage::loadMidiMappingByName(std::string name)
             ctrl = ctrl->NextSiblingElement("ctrl");
         }
     }
+
+    midiMappingChanged();
 }
 
 void SurgeStorage::storeMidiMappingToName(std::string name)
@@ -2627,6 +3064,33 @@ void SurgeStorage::send_tuning_update()
 }
 #endif
 
+float SurgeStorage::mtsNotePitch(float note, int channel)
+{
+    int k = (int)note;
+    int ch = channel & 15;
+    auto &row = mtsKeyPitch[ch];
+
+    if (mtsKeyPitchAsOf[ch] != mtsBlock)
+    {
+        for (int i = 0; i < 128; ++i)
+        {
+            double f = Tunings::MIDI_0_FREQ * pow(2.0, i / 12.0);
+#ifndef SURGE_SKIP_ODDSOUND_MTS
+            if (oddsound_mts_client)
+                f = MTS_NoteToFrequency(oddsound_mts_client, i, ch);
+#endif
+            row[i] = (float)(12.0 * log2(f / Tunings::MIDI_0_FREQ));
+        }
+        mtsKeyPitchAsOf[ch] = mtsBlock;
+    }
+
+    if (k < 0)
+        return row[0] + k;
+    if (k > 127)
+        return row[127] + (k - 127);
+    return row[k];
+}
+
 void SurgeStorage::toggleTuningToCache()
 {
     if (isToggledToCache)
@@ -2834,6 +3298,7 @@ Surge::Storage::ScenesOutputData::ScenesOutputData()
             std::shared_ptr<float> block(new float[BLOCK_SIZE], [](float *p) { delete[] p; });
             memset(block.get(), 0, BLOCK_SIZE * sizeof(float));
             sceneData[i][j] = block;
+            sceneView[i][j] = block.get();
         }
     }
 }
@@ -2844,6 +3309,12 @@ const std::shared_ptr<float> &Surge::Storage::ScenesOutputData::getSceneData(int
     assert(channel < N_OUTPUTS && channel >= 0);
     return sceneData[scene][channel];
 }
+const float *Surge::Storage::ScenesOutputData::getSceneView(int scene, int channel) const
+{
+    assert(scene < n_scenes && scene >= 0);
+    assert(channel < N_OUTPUTS && channel >= 0);
+    return sceneView[scene][channel];
+}
 bool Surge::Storage::ScenesOutputData::thereAreClients(int scene) const
 {
     return std::any_of(std::begin(sceneData[scene]), std::end(sceneData[scene]),
@@ -2855,6 +3326,30 @@ void Surge::Storage::ScenesOutputData::provideSceneData(int scene, int channel,
         sceneData[scene][channel].use_count() > 1) // we don't provide data if there are no clients
     {
         memcpy(sceneData[scene][channel].get(), data, BLOCK_SIZE * sizeof(float));
+        sceneView[scene][channel] = sceneData[scene][channel].get();
+    }
+}
+void Surge::Storage::ScenesOutputData::provideSceneView(int scene, int channel, const float *data)
+{
+    if (scene < n_scenes && scene >= 0 && channel < N_OUTPUTS && channel >= 0)
+    {
+        sceneView[scene][channel] = data;
+    }
+}
+void Surge::Storage::ScenesOutputData::snapshotSceneData(int scene)
+{
+    if (!thereAreClients(scene))
+        return;
+
+    for (int channel = 0; channel < N_OUTPUTS; channel++)
+    {
+        auto *owned = sceneData[scene][channel].get();
+
+        if (sceneView[scene][channel] != owned)
+        {
+            memcpy(owned, sceneView[scene][channel], BLOCK_SIZE * sizeof(float));
+            sceneView[scene][channel] = owned;
+        }
     }
 }
 
@@ -48,6 +48,8 @@
 
 #include "Tunings.h"
 #include "PatchDB.h"
+#include "PatchLoadProfile.h"
+#include "ScopeTap.h"
 #include <unordered_set>
 #include "UserDefaults.h"
 
@@ -406,6 +408,7 @@ enum fx_type
     fxt_spring_reverb,
     fxt_bonsai,
     fxt_audio_input,
+    fxt_convolution,
 
     n_fx_types,
 };
@@ -439,19 +442,22 @@ const char fx_type_names[n_fx_types][32] = {"Off",
                                             "Mid-Side Tool",
                                             "Spring Reverb",
                                             "Bonsai",
-                                            "Audio Input"};
+                                            "Audio Input",
+                                            "Convolution"};
 
 const char fx_type_shortnames[n_fx_types][16] = {
     "Off",         "Delay",      "Reverb 1",      "Phaser",        "Rotary",     "Distortion",
     "EQ",          "Freq Shift", "Conditioner",   "Chorus",        "Vocoder",    "Reverb 2",
     "Flanger",     "Ring Mod",   "Airwindows",    "Neuron",        "Graphic EQ", "Resonator",
     "CHOW",        "Exciter",    "Ensemble",      "Combulator",    "Nimbus",     "Tape",
-    "Treemonster", "Waveshaper", "Mid-Side Tool", "Spring Reverb", "Bonsai",     "Audio In"};
+    "Treemonster", "Waveshaper", "Mid-Side Tool", "Spring Reverb", "Bonsai",     "Audio In",
+    "Convolution"};
 
 const char fx_type_acronyms[n_fx_types][8] = {
     "OFF", "DLY", "RV1", "PH",   "ROT", "DIST", "EQ",  "FRQ", "DYN", "CH",
     "VOC", "RV2", "FL",  "RM",   "AW",  "NEU",  "GEQ", "RES", "CHW", "XCT",
-    "ENS", "CMB", "NIM", "TAPE", "TM",  "WS",   "M-S", "SRV", "BON", "IN"};
+    "ENS", "CMB", "NIM", "TAPE", "TM",  "WS",   "M-S", "SRV", "BON", "IN",
+    "CNV"};
 
 enum fx_bypass
 {
@@ -827,10 +833,19 @@ struct MSEGStorage
     // If you edit the segments, then MSEGModulationHelper::rebuildCache can rebuild them
     float totalDuration;
     std::array<float, max_msegs> segmentStart, segmentEnd;
+    bool segmentEndsSorted{true}; // lets timeToSegment binary search segmentEnd
     float durationToLoopEnd;
     float durationLoopStartToLoopEnd;
     float envelopeModeDuration = -1, envelopeModeNV1 = -2; // -2 as sentinel since NV1 is -1/1
 
+    /*
+     * Curve shape terms which only depend on a segment's own control point, so valueAt
+     * doesn't redo their exp, log and sqrt on every call. rebuildCache fills these too.
+     */
+    std::array<float, max_msegs> segmentCurveA;   // control point exponent, LINEAR and SCURVE
+    std::array<int, max_msegs> segmentSteps;      // cycles or stairs for the stepped types
+    std::array<float, max_msegs> segmentBezierCp; // through-curve control time, QUAD_BEZIER
+
     /*
      * These "UI" type things we decided, late in 1.8, are actually a critical part of
      * the modelling experience, so even if they aren't required to actually evaluate
@@ -973,6 +988,7 @@ struct DAWExtraStateStorage
 
     int monoPedalMode = 0;
     int oddsoundRetuneMode = 0;
+    int midiReceiveChannelMask = 0xFFFF;
 
     bool isDirty{false};
 
@@ -988,6 +1004,7 @@ struct PatchTuningStorage
 };
 
 class SurgeStorage;
+struct FilterCoefficientCache;
 
 class SurgePatch
 {
@@ -1004,7 +1021,16 @@ class SurgePatch
     // void load_xml();
     // void save_xml();
     void load_xml(const void *data, int size, bool preset);
+    // apply an already parsed patch document; see parse_patch_xml
+    void load_xml_document(TiXmlDocument &doc, bool preset);
+    // parse the xml of a patch chunk (with or without the sub3 header) without applying it, so
+    // callers can parse once and apply to many patches or engines. Returns false if unusable
+    static bool parse_patch_xml(const void *data, int size, TiXmlDocument &doc);
+    // the dawExtraState part of load_xml_document on its own, for a patch element
+    void load_daw_extra_state(TiXmlElement *patch);
     unsigned int save_xml(void **data);
+    // the same document as save_xml, written into out (which is cleared first)
+    void save_xml_into(std::string &out);
     unsigned int save_RIFF(void **data);
 
     // Factor these so the LFO preset mechanism can use them as well
@@ -1015,7 +1041,9 @@ class SurgePatch
     void formulaToXMLElement(FormulaModulatorStorage *ms, TiXmlElement &parent) const;
     void formulaFromXMLElement(FormulaModulatorStorage *ms, TiXmlElement *parent) const;
 
-    void load_patch(const void *data, int size, bool preset);
+    // parsedXml, if given, is the result of parse_patch_xml on the same data. It is only read
+    // unless preset is true, in which case the stripped preset parameters are removed from it
+    void load_patch(const void *data, int size, bool preset, TiXmlDocument *parsedXml = nullptr);
     unsigned int save_patch(void **data);
     Parameter *parameterFromOSCName(std::string stName);
 
@@ -1032,6 +1060,8 @@ class SurgePatch
     int scene_start[n_scenes], scene_size;
 
     std::unordered_map<std::string, Parameter *> param_ptr_by_oscname;
+    // index into param_ptr by streamed element name, so load_xml takes the parameters in one pass
+    std::unordered_map<std::string, int> param_index_by_storagename;
 
     // streaming name for splitpoint is splitkey (due to legacy)
     Parameter scene_active, scenemode, splitpoint;
@@ -1053,7 +1083,17 @@ class SurgePatch
     std::vector<ModulationRouting> modulation_global;
     pdata scenedata[n_scenes][n_scene_params];
     pdata globaldata[n_global_params];
+
+    // scenedata as of the previous block, and which entries of it moved in the latest one,
+    // so voices only refresh those entries of their local copy
+    pdata scenedataPrevious[n_scenes][n_scene_params]{};
+    int scenedataChanged[n_scenes][n_scene_params];
+    int scenedataChangedCount[n_scenes]{};
+    uint32_t scenedataGeneration[n_scenes]{};
+    void diff_scenedata(int scene);
     void *patchptr;
+    size_t patchptrCapacity{0};
+    std::string xmlSaveBuffer; // reused by save_patch so hosts which autosave don't reallocate
     SurgeStorage *storage;
 
     // metadata
@@ -1067,7 +1107,32 @@ class SurgePatch
     };
     std::vector<Tag> tags;
 
-    std::atomic<bool> isDirty{false};
+    /*
+     * Everything which edits the patch sets isDirty, so alongside the flag this counts those
+     * edits. A state recorded at some revision still describes the patch while the revision
+     * hasn't moved. Changes which shouldn't show the patch as modified can touch() it instead.
+     */
+    struct DirtyFlag
+    {
+        DirtyFlag &operator=(bool b)
+        {
+            if (b)
+                revision++;
+            flag = b;
+            return *this;
+        }
+        operator bool() const { return flag; }
+        void touch() { revision++; }
+
+        std::atomic<bool> flag{false};
+        std::atomic<uint64_t> revision{0};
+    } isDirty;
+
+    /*
+     * Moves each time update_controls re-types the parameters, so anything derived from the
+     * control layout (such as cached display text) knows to rebuild.
+     */
+    std::atomic<uint64_t> controlsRevision{0};
 
     // macro controllers
 #define CUSTOM_CONTROLLER_LABEL_SIZE 20
@@ -1147,24 +1212,47 @@ namespace Surge
 {
 namespace Storage
 {
+/*
+ * Scene output for anything inside the engine which wants to listen to a scene (the
+ * audio input effect, for instance). Clients subscribe by holding on to the shared_ptr
+ * from getSceneData, and read the current block through getSceneView.
+ *
+ * The engine publishes its own scene buffers with provideSceneView, so nothing is copied
+ * unless a buffer is about to be changed in place while a client may still want the
+ * original; snapshotSceneData makes that copy, and only if there are clients.
+ * provideSceneData is the copying version for providers whose buffer doesn't outlive the call.
+ */
 struct ScenesOutputData
 {
     std::shared_ptr<float> sceneData[n_scenes][N_OUTPUTS]{{nullptr, nullptr}, {nullptr, nullptr}};
+    const float *sceneView[n_scenes][N_OUTPUTS]{{nullptr, nullptr}, {nullptr, nullptr}};
 
   public:
     ScenesOutputData();
     const std::shared_ptr<float> &getSceneData(int scene, int channel) const;
+    const float *getSceneView(int scene, int channel) const;
     void provideSceneData(int scene, int channel, float *data);
+    void provideSceneView(int scene, int channel, const float *data);
+    void snapshotSceneData(int scene);
     bool thereAreClients(int scene) const;
 };
 
 struct FxUserPreset;
 struct ModulatorPreset;
+struct WavetableLoader;
+struct PatchChunkCache;
+struct DirectoryManifest;
+struct SharedDirectoryScan;
+struct WavetableDiskCache;
 } // namespace Storage
 namespace Memory
 {
 struct SurgeMemoryPools;
 }
+namespace Threading
+{
+struct BackgroundService;
+}
 namespace Formula
 {
 struct GlobalData;
@@ -1184,19 +1272,22 @@ class alignas(16) SurgeStorage
     // this will be a pointer to an aligned 2 x BLOCK_SIZE_OS array
     float audio_otherscene alignas(16)[2][BLOCK_SIZE_OS];
 
-    std::unique_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sincTableProvider;
+    // shared by every instance in the process, see SharedStorageCore.h. Never write to it.
+    std::shared_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sincTableProvider;
     float *sinctable, *sinctable1X;
     int16_t *sinctableI16;
 
-    float table_dB alignas(16)[512], table_envrate_lpf alignas(16)[512],
-        table_envrate_linear alignas(16)[512], table_glide_exp alignas(16)[512],
-        table_glide_log alignas(16)[512];
+    float table_envrate_lpf alignas(16)[512], table_envrate_linear alignas(16)[512];
+    // these point into Surge::Storage::sharedLookupTables(), so are the same for every instance
+    const float *table_dB{nullptr}, *table_glide_exp{nullptr}, *table_glide_log{nullptr};
     float samplerate{0}, samplerate_inv{1};
     double dsamplerate{0}, dsamplerate_inv{1};
     double dsamplerate_os{0}, dsamplerate_os_inv{1};
     // Ring buffer that holds the audio output, used for the oscilloscope. Will hold a bit under 1/4
     // second of data, assuming the sample rate is 48k.
     sst::cpputils::StereoRingBuffer<float, 8192> audioOut;
+    // Folds the output down to min/max pairs before audioOut when the scope asks for it
+    ScopeTap audioOutTap;
 
     struct SurgeStorageConfig
     {
@@ -1204,6 +1295,22 @@ class alignas(16) SurgeStorage
         bool createUserDirectory{true};
         fs::path extraThirdPartyWavetablesPath{};
         bool scanWavetableAndPatches{true};
+        /*
+         * The rest of these let a headless host (the python bindings, the test runner, a
+         * render farm) skip the startup work which only the plugin and its GUI need. With
+         * readUserDefaults off no user defaults file is read or written and every default
+         * reads as its fallback value. With deferDirectoryScans on the patch, wavetable,
+         * IR and FX preset lists stay empty until ensureDirectoryScans() is called, which
+         * the patch browsing calls (jogPatch and friends) do for you.
+         */
+        bool readUserDefaults{true};
+        bool loadUserMidiMappings{true};
+        bool deferDirectoryScans{false};
+        /*
+         * How many voices per scene the engine allocates, up to MAX_VOICES (the compile time
+         * ceiling, see SURGE_COMPILE_MAX_VOICES). Zero takes the VoiceCapacity user default.
+         */
+        int voiceCapacity{0};
 
         static SurgeStorageConfig fromDataPath(const std::string &s)
         {
@@ -1211,8 +1318,20 @@ class alignas(16) SurgeStorage
             r.suppliedDataPath = s;
             return r;
         }
+
+        static SurgeStorageConfig minimal(const std::string &s = "")
+        {
+            auto r = fromDataPath(s);
+            r.createUserDirectory = false;
+            r.readUserDefaults = false;
+            r.loadUserMidiMappings = false;
+            r.deferDirectoryScans = true;
+            return r;
+        }
     };
     SurgeStorage(const SurgeStorageConfig &);
+    // what this storage was constructed with, so SurgeSynthesizer::fork can make another
+    SurgeStorageConfig startupConfig;
     SurgeStorage(std::string suppliedDataPath = "")
         : SurgeStorage(SurgeStorageConfig::fromDataPath(suppliedDataPath))
     {
@@ -1220,6 +1339,10 @@ class alignas(16) SurgeStorage
 
     static std::string skipPatchLoadDataPathSentinel;
 
+    // True when the directory scans were deferred at construction and have not run yet
+    bool directoryScansDeferred{false};
+    void ensureDirectoryScans();
+
     // In Surge XT, SurgeStorage can now keep a cache of errors it reports to the user
     enum ErrorType
     {
@@ -1270,15 +1393,42 @@ class alignas(16) SurgeStorage
         initPatchCategoryType{"Factory"};
 
     static constexpr int tuning_table_size = 512;
-    float table_pitch alignas(16)[tuning_table_size];
-    float table_pitch_inv alignas(16)[tuning_table_size];
-    float table_note_omega alignas(16)[2][tuning_table_size];
-    float table_pitch_ignoring_tuning alignas(16)[tuning_table_size];
-    float table_pitch_inv_ignoring_tuning alignas(16)[tuning_table_size];
+
+    /*
+     * The tuned tables are double buffered. A retune fills the buffer voices aren't reading
+     * and then swaps it in, so a lookup sees either the old tuning or the new one in full
+     * and never a half-rebuilt table. Readers should fetch tuningTables() once per lookup.
+     */
+    struct TuningTables
+    {
+        float pitch alignas(16)[tuning_table_size];
+        float pitch_inv alignas(16)[tuning_table_size];
+        float note_omega alignas(16)[2][tuning_table_size];
+    };
+    const TuningTables &tuningTables() const
+    {
+        return *liveTuningTables.load(std::memory_order_acquire);
+    }
+
+  private:
+    TuningTables tuningTableBuffers[2];
+    std::atomic<TuningTables *> liveTuningTables{&tuningTableBuffers[0]};
+    TuningTables &spareTuningTables()
+    {
+        auto live = liveTuningTables.load(std::memory_order_relaxed);
+        return live == &tuningTableBuffers[0] ? tuningTableBuffers[1] : tuningTableBuffers[0];
+    }
+    void fillTuningTables(TuningTables &t, const Tunings::Tuning &tuning);
+
+  public:
+    // shared like table_dB
+    const float *table_pitch_ignoring_tuning{nullptr}, *table_pitch_inv_ignoring_tuning{nullptr};
     float table_note_omega_ignoring_tuning alignas(16)[2][tuning_table_size];
-    // 2^0 -> 2^+/-1/12th. See comment in note_to_pitch
-    float table_two_to_the alignas(16)[1001];
-    float table_two_to_the_minus alignas(16)[1001];
+
+    // filter coefficient targets shared by the voices; see FilterCoefficientCache.h
+    std::unique_ptr<FilterCoefficientCache> filterCoefficientCache;
+    // 2^0 -> 2^+/-1/12th, shared like table_dB. See comment in note_to_pitch
+    const float *table_two_to_the{nullptr}, *table_two_to_the_minus{nullptr};
 
     ~SurgeStorage();
 
@@ -1303,11 +1453,18 @@ class alignas(16) SurgeStorage
     float nyquist_pitch;
     int last_key[2]; // TODO: FIX SCENE ASSUMPTION
     TiXmlElement *getSnapshotSection(const char *name);
-    void load_midi_controllers();
+    void load_midi_controllers(bool readUserDefaultsFile = true);
     void write_midi_controllers_to_user_default();
     void save_snapshots();
     int controllers[n_customcontrollers];
     int controllers_chan[n_customcontrollers];
+
+    /*
+     * Anything which changes a parameter's midictrl/midichan or a macro's controllers entry
+     * calls this, so the synth rebuilds its CC dispatch table before the next CC is routed.
+     */
+    std::atomic<uint32_t> midiMappingRevision{0};
+    void midiMappingChanged() { midiMappingRevision++; }
     float poly_aftertouch[2][16][128]; // TODO: FIX SCENE ASSUMPTION
     float modsource_vu[n_modsources];
     void setSamplerate(float sr);
@@ -1324,19 +1481,72 @@ class alignas(16) SurgeStorage
     void refresh_wtlistFrom(bool isUser, const fs::path &from, const std::string &subdir);
     void refresh_patchlist();
     void refreshPatchlistAddDir(bool userDir, std::string subdir);
+    void refresh_irlist();
 
     void refreshPatchOrWTListAddDir(bool userDir, const fs::path &fromPath, std::string subdir,
                                     std::function<bool(std::string)> filterOp,
                                     std::vector<Patch> &items,
-                                    std::vector<PatchCategory> &categories);
+                                    std::vector<PatchCategory> &categories,
+                                    Surge::Storage::DirectoryManifest *manifest = nullptr);
+    void scanPatchOrWTDir(bool userDir, const fs::path &fromPath, const std::string &subdir,
+                          const std::function<bool(std::string)> &filterOp,
+                          std::vector<Patch> &items, std::vector<PatchCategory> &categories,
+                          Surge::Storage::DirectoryManifest *manifest);
+
+    /*
+     * Factory and third party directories scan the same for every instance, so while we are
+     * constructing we take the scan another instance already made. An explicit refresh later
+     * on always rescans and publishes the fresh result for the instances which follow.
+     */
+    bool reuseSharedDirectoryScans{true};
+    std::map<std::string, std::shared_ptr<const Surge::Storage::SharedDirectoryScan>>
+        heldDirectoryScans;
+
+    /*
+     * The patch library scan keeps a manifest of every directory it walked, saved next to the
+     * patch database, so the next scan only reads directories which have changed.
+     */
+    std::unique_ptr<Surge::Storage::DirectoryManifest> patchDirectoryManifest;
+    fs::path patchDirectoryManifestPath() const;
+
+    /*
+     * perform_queued_wtloads is called from the audio thread at the top of every block. If the
+     * background wavetable loader is enabled, it only hands requests to the loader and picks up
+     * finished tables; otherwise (or if allowBackgroundLoad is false, which we use when the audio
+     * engine isn't running) it loads synchronously in the calling thread.
+     */
+    void perform_queued_wtloads(bool allowBackgroundLoad = true);
+    void setLoadWavetablesOffAudioThread(bool b);
+    bool isLoadingWavetablesOffAudioThread() const { return (bool)wavetableLoader; }
+    std::unique_ptr<Surge::Storage::WavetableLoader> wavetableLoader;
+
+    // recently read FXP chunks, so re-loading a patch we have just seen skips the disk
+    std::unique_ptr<Surge::Storage::PatchChunkCache> patchChunkCache;
 
-    void perform_queued_wtloads();
+    // the phases of the most recent patch load, for the benchmarks and anyone chasing latency
+    Surge::Profiling::PatchLoadProfile patchLoadProfile;
+
+    // large built wavetables saved with their mipmaps, so reloading them skips the rebuild
+    std::unique_ptr<Surge::Storage::WavetableDiskCache> wavetableDiskCache;
 
     void load_wt(int id, Wavetable *wt, OscillatorStorage *);
-    void load_wt(std::string filename, Wavetable *wt, OscillatorStorage *);
+    /*
+     * With headWindows set, a sample (rather than a wavetable) longer than twice that many
+     * windows is only built as far as its first headWindows windows, and headOnly reports
+     * whether that happened. The wavetable loader uses this to get a long sample playing
+     * while it builds the rest.
+     */
+    void load_wt(std::string filename, Wavetable *wt, OscillatorStorage *, int headWindows = 0,
+                 bool *headOnly = nullptr);
     bool load_wt_wt(std::string filename, Wavetable *wt);
     bool load_wt_wt_mem(const char *data, const size_t dataSize, Wavetable *wt);
-    bool load_wt_wav_portable(std::string filename, Wavetable *wt);
+    // BuildWT through the process wide cache in SharedStorageCore, so identical tables share data
+    bool buildSharedWT(void *data, size_t dataSize, wt_header &wh, Wavetable *wt);
+    bool load_wt_wav_portable(std::string filename, Wavetable *wt, int headWindows = 0,
+                              bool *headOnly = nullptr);
+    // 16 or 24 bit PCM or 32 bit float; a mono file leaves right empty
+    bool load_ir_wav(const fs::path &path, std::vector<float> &left, std::vector<float> &right,
+                     float &sampleRate);
     std::string export_wt_wav_portable(std::string fbase, Wavetable *wt);
     void clipboard_copy(int type, int scene, int entry, modsources ms = ms_original);
     // this function is a bit of a hack to stop me having a reference to SurgeSynth here
@@ -1357,6 +1567,10 @@ class alignas(16) SurgeStorage
     int firstUserCategory;
     std::vector<int> patchOrdering;
     std::vector<int> patchCategoryOrdering;
+    // For each category, its patches in patchOrdering order and the indices of its child
+    // categories, so the patch menus don't rescan every patch and category per category.
+    // Rebuilt with the list by refresh_patchlist.
+    std::vector<std::vector<int>> patchesInCategory, childCategoriesOf;
 
     // The in-memory wavetable database
     std::vector<Patch> wt_list;
@@ -1366,6 +1580,14 @@ class alignas(16) SurgeStorage
     std::vector<int> wtOrdering;
     std::vector<int> wtCategoryOrdering;
 
+    // Impulse responses for the convolution effect, by name. This is only rebuilt when storage
+    // is constructed, so effects may read it from any thread.
+    std::vector<Patch> ir_list;
+    std::vector<PatchCategory> ir_category;
+
+    // Convolution is no use with nothing to convolve with, so menus leave it out until there is
+    bool isFxTypeAvailable(int type) const { return type != fxt_convolution || !ir_list.empty(); }
+
     std::unique_ptr<Surge::Storage::FxUserPreset> fxUserPreset;
     std::unique_ptr<Surge::Storage::ModulatorPreset> modulatorPreset;
 
@@ -1375,6 +1597,7 @@ class alignas(16) SurgeStorage
     fs::path userDataPath;
     fs::path userPatchesPath;
     fs::path userWavetablesPath;
+    fs::path userImpulseResponsesPath;
     fs::path userModulatorSettingsPath;
     fs::path userFXPath;
     fs::path userWavetablesExportPath;
@@ -1389,6 +1612,42 @@ class alignas(16) SurgeStorage
 
     std::mutex waveTableDataMutex;
     std::recursive_mutex modRoutingMutex;
+
+    /*
+     * The audio thread only ever try_locks modRoutingMutex, so a UI thread dragging a
+     * modulation depth can't stall it. A block which gets the lock copies the routing into
+     * modRoutingSnapshot on the way out, and a block which doesn't renders from that copy
+     * instead. Audio side code reads the routing through modRouting, which selectModRouting
+     * points at either the live patch lists or the snapshot for the current block.
+     */
+    struct ModRoutingView
+    {
+        const std::vector<ModulationRouting> *voice[n_scenes]{}, *scene[n_scenes]{};
+        const std::vector<ModulationRouting> *global{nullptr};
+    } modRouting;
+
+    struct ModRoutingSnapshot
+    {
+        std::vector<ModulationRouting> voice[n_scenes], scene[n_scenes], global;
+    } modRoutingSnapshot;
+
+    void selectModRouting(bool useSnapshot);
+    // call with modRoutingMutex held
+    void captureModRoutingSnapshot();
+
+    /*
+     * Every voice applies its scene's voice routing every block, so once per block the audio
+     * thread flattens that routing into structure of arrays form for SurgeVoice: muted routes
+     * are dropped and the rest sorted by source, so a voice evaluates each source output once
+     * however many destinations it feeds.
+     */
+    struct CompiledVoiceRouting
+    {
+        std::vector<int> order, source, sourceIndex, destination;
+        std::vector<float> depth;
+        int count{0};
+    } compiledVoiceRouting[n_scenes];
+    void compileVoiceRouting();
     Wavetable WindowWT;
 
     // hardclip
@@ -1400,6 +1659,14 @@ class alignas(16) SurgeStorage
     } hardclipMode = HARDCLIP_TO_18DBFS,
       sceneHardclipMode[n_scenes] = {HARDCLIP_TO_18DBFS, HARDCLIP_TO_18DBFS};
 
+    // how the scene waveshaper is evaluated, see TableWaveshapers.h
+    enum WaveshaperEvaluation
+    {
+        WAVESHAPER_EXACT = 0,
+        WAVESHAPER_TABLE,
+        WAVESHAPER_TABLE_ADAA
+    } sceneWaveshaperEvaluation[n_scenes] = {WAVESHAPER_EXACT, WAVESHAPER_EXACT};
+
     void loadTuningFromSCL(const fs::path &p);
     void loadMappingFromKBM(const fs::path &p);
     std::function<void()> onTuningChanged{nullptr};
@@ -1419,6 +1686,9 @@ class alignas(16) SurgeStorage
 
     void note_to_omega(float, float &, float &);
     void note_to_omega_ignoring_tuning(float, float &, float &, float sampleRate = 0.0f);
+    // four notes at once, for callers which hold several voices' or bands' pitches as lanes
+    void note_to_omega(__m128, __m128 &, __m128 &);
+    void note_to_omega_ignoring_tuning(__m128, __m128 &, __m128 &);
 
     /*
      * Tuning Support and Tuning State. Here's how it works
@@ -1567,6 +1837,18 @@ class alignas(16) SurgeStorage
 #endif
     MTSClient *oddsound_mts_client = nullptr;
     std::atomic<bool> oddsound_mts_active_as_client{false};
+
+    /*
+     * Voices read MTS-ESP tuning through here rather than calling the client. Each MIDI
+     * channel's 128 keys are read once per block, on first use in that block, and held as
+     * semitones above MIDI note 0. Keys outside 0..127 extend the end notes by 12-TET.
+     * Audio thread only; the synth calls beginMTSBlock at the top of each block.
+     */
+    float mtsNotePitch(float note, int channel);
+    void beginMTSBlock() { mtsBlock++; }
+    float mtsKeyPitch[16][128]{};
+    uint64_t mtsKeyPitchAsOf[16]{};
+    uint64_t mtsBlock{1};
     uint32_t oddsound_mts_on_check = 0;
     std::atomic<bool> oddsound_mts_active_as_main{false};
     enum OddsoundRetuneMode
@@ -1603,6 +1885,8 @@ class alignas(16) SurgeStorage
     float mpePitchBendRange = -1.0f;
 
     std::atomic<int> otherscene_clients;
+    // how many live oscillators and effects read audio_in or audio_in_nonOS; see AudioInputClient
+    std::atomic<int> audio_in_clients{0};
 
     Surge::Storage::ScenesOutputData scenesOutputData;
 
@@ -1615,9 +1899,76 @@ class alignas(16) SurgeStorage
     int subtypeMemory[n_scenes][n_filterunits_per_scene][sst::filters::num_filter_types];
     MonoPedalMode monoPedalMode = HOLD_ALL_NOTES;
 
+    /*
+     * Render profile. renderingOffline is set by the plugin each block from what the host
+     * says; while it is on, and offlineHighestQuality (a user default) allows it, anything
+     * which trades quality for CPU picks its best variant, since there is no deadline to
+     * meet. Live, everything runs as configured.
+     */
+    bool renderingOffline{false};
+    bool offlineHighestQuality{true};
+    bool useHighestQuality() const { return renderingOffline && offlineHighestQuality; }
+
+    /*
+     * The halfband filters between the oversampled engine and the host rate. Low CPU runs a
+     * shorter allpass chain, trading alias rejection for fewer stages. High keeps the full
+     * chain but with the gentler coefficient set, which rejects more at the cost of a wider
+     * transition band, and is what offline renders use when useHighestQuality() allows.
+     */
+    enum HalfbandProfile
+    {
+        HALFBAND_LOW_CPU = 0,
+        HALFBAND_STANDARD,
+        HALFBAND_HIGH,
+    };
+    HalfbandProfile halfbandProfile{HALFBAND_STANDARD};
+    HalfbandProfile activeHalfbandProfile() const
+    {
+        return useHighestQuality() ? HALFBAND_HIGH : halfbandProfile;
+    }
+
+    /*
+     * Hosts report the tempo once per buffer, so a tempo ramp arrives as a staircase with
+     * a step every buffer. With this on (a user default) the plugin spreads each step over
+     * the blocks of the buffer instead.
+     */
+    bool glideHostTempo{false};
+
+    /*
+     * Voices per scene this engine was built with: a multiple of 4 (one filter quad) between
+     * 8 and MAX_VOICES. Fixed at construction, so polyphony limits clamp to it.
+     */
+    int voiceCapacity{MAX_VOICES};
+
+    /*
+     * Bit n set means this instance responds to channel messages on MIDI channel n + 1. With
+     * a different set of channels per instance, several instances on one MIDI input play as
+     * the parts of a multi-timbral setup. Stored with the DAW state rather than the patch.
+     */
+    uint16_t midiReceiveChannelMask = 0xFFFF;
+
+    /*
+     * Things which happened since the end of the last block and which may explain a late one.
+     * Any thread may note them; the engine takes and clears them at the end of every block for
+     * its deadline monitor.
+     */
+    enum BlockEvent : uint32_t
+    {
+        be_patchLoad = 1 << 0,
+        be_wavetableLoad = 1 << 1,
+        be_formulaError = 1 << 2,
+    };
+    std::atomic<uint32_t> blockEvents{0};
+    void noteBlockEvent(BlockEvent e) { blockEvents.fetch_or(e, std::memory_order_relaxed); }
+
   private:
     TiXmlDocument snapshotloader;
-    std::vector<Parameter> clipboard_p;
+    struct ClipboardParameter
+    {
+        int id; // relative to the first parameter of the copied group
+        ParameterState state;
+    };
+    std::vector<ClipboardParameter> clipboard_p;
     int clipboard_type;
     StepSequencerStorage clipboard_stepsequences[n_lfos];
     MSEGStorage clipboard_msegs[n_lfos];
@@ -1636,6 +1987,9 @@ class alignas(16) SurgeStorage
 
     std::unique_ptr<Surge::Memory::SurgeMemoryPools> memoryPools;
 
+    // the thread effects and the like hand their non realtime work to. See BackgroundService.h
+    std::unique_ptr<Surge::Threading::BackgroundService> backgroundService;
+
 /*
  * An RNG which is decoupled from the non-Surge global state and is threadsafe.
  * This RNG has the semantic that it is seeded when the first Surge in your session
@@ -1656,6 +2010,14 @@ class alignas(16) SurgeStorage
               pm1(-1.f, 1.f), z1(0.f, 1.f), u32(0, 0xFFFFFFFF)
         {
         }
+        void seed(uint32_t s)
+        {
+            g.seed(s);
+            d.reset();
+            pm1.reset();
+            z1.reset();
+            u32.reset();
+        }
         std::minstd_rand g;
         std::uniform_int_distribution<int> d;
         std::uniform_real_distribution<float> pm1, z1;
@@ -1675,6 +2037,49 @@ class alignas(16) SurgeStorage
 #else
 #define runningOnAudioThread() (void *)0;
 #endif
+    /*
+     * Work which the audio thread farms out to a render worker (for instance a scene rendered
+     * in parallel) installs its own generator here for the duration of that work, so the
+     * calls below never race the audio thread's generator. See SurgeSynthesizer::renderScene.
+     */
+    static inline thread_local RNGGen *threadRNGOverride{nullptr};
+    inline RNGGen &activeRNG() { return threadRNGOverride ? *threadRNGOverride : rngGen; }
+
+    // installs a generator as this thread's for the life of the scope; nullptr leaves it alone
+    struct ScopedRNGOverride
+    {
+        explicit ScopedRNGOverride(RNGGen *r) : prior(threadRNGOverride)
+        {
+            if (r)
+                threadRNGOverride = r;
+        }
+        ~ScopedRNGOverride() { threadRNGOverride = prior; }
+        RNGGen *prior;
+    };
+
+    /*
+     * Seeded rendering (see SurgeSynthesizer::setRandomSeed). Every generator the engine owns
+     * is then derived from randomSeed, and each voice draws only from its own generator,
+     * derived from the seed and its place in the note order, so a render depends on its
+     * inputs alone and not on how the voices, scenes and effects were spread over threads.
+     */
+    bool seededRandom{false};
+    uint64_t randomSeed{0};
+    int64_t randomSeedVoiceOrigin{0};
+    static constexpr uint64_t randomSeedVoiceStreams{1024};
+
+    // splitmix64, so neighbouring streams of one seed start far apart
+    static uint32_t deriveRandomSeed(uint64_t seed, uint64_t stream)
+    {
+        uint64_t z = seed + (stream + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z = z ^ (z >> 31);
+
+        // minstd_rand can't be seeded with a multiple of its modulus
+        return (uint32_t)(z % 2147483646ULL) + 1;
+    }
+
     /*
      * These API points are only thread safe on the AUDIO thread.
      * If you want to have an independent RNG on another thread, manage
@@ -1684,22 +2089,26 @@ class alignas(16) SurgeStorage
     inline int rand()
     {
         runningOnAudioThread();
-        return rngGen.d(rngGen.g);
+        auto &r = activeRNG();
+        return r.d(r.g);
     }
     inline uint32_t rand_u32()
     {
         runningOnAudioThread();
-        return rngGen.u32(rngGen.g);
+        auto &r = activeRNG();
+        return r.u32(r.g);
     }
     inline float rand_pm1()
     {
         runningOnAudioThread();
-        return rngGen.pm1(rngGen.g);
+        auto &r = activeRNG();
+        return r.pm1(r.g);
     }
     inline float rand_01()
     {
         runningOnAudioThread();
-        return rngGen.z1(rngGen.g);
+        auto &r = activeRNG();
+        return r.z1(r.g);
     }
 // void seed_rand(int s) { rngGen.g.seed(s); }
 #else
@@ -1709,7 +2118,10 @@ class alignas(16) SurgeStorage
     inline float rand_01() { return (float)std::rand() / (float)(RAND_MAX); }
 #endif
     float db_to_linear(float);
+    __m128 db_to_linear(__m128);
     float lookup_waveshape(sst::waveshapers::WaveshaperType, float);
+    // the same lookup on four values at once, for effects which run their channels as lanes
+    __m128 lookup_waveshape(sst::waveshapers::WaveshaperType, __m128);
     float lookup_waveshape_warp(sst::waveshapers::WaveshaperType, float);
     float envelope_rate_lpf(float);
     float envelope_rate_linear(float);
@@ -1729,6 +2141,29 @@ bool isValidUTF8(const std::string &testThis);
 std::string findReplaceSubstring(std::string &source, const std::string &from,
                                  const std::string &to);
 
+/*
+ * Oscillators and effects which can read the audio input hold one of these while they exist,
+ * and the synth only clips, copies and upsamples the host input while anything does.
+ */
+struct AudioInputClient
+{
+    explicit AudioInputClient(SurgeStorage *s) : storage(s)
+    {
+        if (storage)
+            storage->audio_in_clients++;
+    }
+    ~AudioInputClient()
+    {
+        if (storage)
+            storage->audio_in_clients--;
+    }
+    AudioInputClient(const AudioInputClient &) = delete;
+    AudioInputClient &operator=(const AudioInputClient &) = delete;
+
+  private:
+    SurgeStorage *storage;
+};
+
 } // namespace Storage
 } // namespace Surge
 
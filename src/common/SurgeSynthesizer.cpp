@@ -33,6 +33,9 @@
 #include "globals.h"
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
+#include <optional>
 #include <thread>
 #include <set>
 #ifndef SURGE_SKIP_ODDSOUND_MTS
@@ -40,18 +43,46 @@
 #endif
 
 #include "SurgeMemoryPools.h"
+#include "RenderWorkerPool.h"
+#include "NoteRenderCache.h"
+#include "AliasOscillator.h"
 
 #include "sst/basic-blocks/mechanics/block-ops.h"
+#include "sst/plugininfra/cpufeatures.h"
 #include "sst/basic-blocks/dsp/Clippers.h"
 
 using namespace std;
 namespace mech = sst::basic_blocks::mechanics;
 namespace sdsp = sst::basic_blocks::dsp;
 
+template <size_t N>
+inline void hardclipScene(SurgeStorage::HardClipMode mode, float *dataL, float *dataR)
+{
+    switch (mode)
+    {
+    case SurgeStorage::HARDCLIP_TO_18DBFS:
+        sdsp::hardclip_block8<N>(dataL);
+        sdsp::hardclip_block8<N>(dataR);
+        break;
+    case SurgeStorage::HARDCLIP_TO_0DBFS:
+        sdsp::hardclip_block<N>(dataL);
+        sdsp::hardclip_block<N>(dataR);
+        break;
+    default:
+        break;
+    }
+}
+
 using CMSKey = ControllerModulationSourceVector<1>; // sigh see #4286 for failed first try
 
 SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppliedDataPath)
-    : storage(suppliedDataPath), hpA{&storage, &storage, &storage, &storage}, hpB{&storage,
+    : SurgeSynthesizer(parent, SurgeStorage::SurgeStorageConfig::fromDataPath(suppliedDataPath))
+{
+}
+
+SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent,
+                                   const SurgeStorage::SurgeStorageConfig &config)
+    : storage(config), hpA{&storage, &storage, &storage, &storage}, hpB{&storage,
                                                                                   &storage,
                                                                                   &storage,
                                                                                   &storage},
@@ -69,6 +100,10 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
 
     fx_suspend_bitmask = 0;
 
+    fxStager.fn = serviceEffectStaging;
+    fxStager.ctx = this;
+    storage.backgroundService->add(fxStager);
+
     for (int i = 0; i < n_fx_slots; ++i)
     {
         fx[i].reset(nullptr);
@@ -88,28 +123,36 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
     memset(storage.getPatch().scenedata[0], 0, sizeof(pdata) * n_scene_params);
     memset(storage.getPatch().scenedata[1], 0, sizeof(pdata) * n_scene_params);
     memset(storage.getPatch().globaldata, 0, sizeof(pdata) * n_global_params);
-    memset(mControlInterpolatorUsed, 0, sizeof(bool) * num_controlinterpolators);
+    resetControlInterpolators();
 
     for (int i = 0; i < n_fx_slots; i++)
     {
         fxsync[i] = storage.getPatch().fx[i];
         fx_reload[i] = false;
         fx_reload_mod[i] = false;
+        fxMoveFrom[i] = -1;
     }
 
     allNotesOff();
 
-    for (int i = 0; i < MAX_VOICES; i++)
+    auto capacity = voiceCapacity();
+    for (int sc = 0; sc < n_scenes; sc++)
     {
-        voices_usedby[0][i] = 0;
-        voices_usedby[1][i] = 0;
+        voices_array[sc] = Surge::Memory::makeLargeArray<SurgeVoice>(capacity);
+        voices_usedby[sc].assign(capacity, 0);
     }
 
+    for (auto *v : {&endedHostNoteIds, &nextBlockEndedHostNoteIds})
+        v->assign(capacity << 3, 0);
+    for (auto *v : {&endedHostNoteOriginalKey, &endedHostNoteOriginalChannel,
+                    &nextBlockEndedHostNoteOriginalKey, &nextBlockEndedHostNoteOriginalChannel})
+        v->assign(capacity << 3, 0);
+
     for (int sc = 0; sc < n_scenes; sc++)
     {
-        FBQ[sc] = new QuadFilterChainState[MAX_VOICES >> 2]();
+        FBQ[sc] = new QuadFilterChainState[capacity >> 2]();
 
-        for (int i = 0; i < (MAX_VOICES >> 2); ++i)
+        for (int i = 0; i < (capacity >> 2); ++i)
         {
             InitQuadFilterChainStateToZero(&(FBQ[sc][i]));
         }
@@ -296,6 +339,9 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
 
 SurgeSynthesizer::~SurgeSynthesizer()
 {
+    storage.backgroundService->remove(fxStager);
+    releaseRetiredEffects();
+
     {
         /*
          * This should "never" happen due to cleanup at end of
@@ -306,6 +352,15 @@ SurgeSynthesizer::~SurgeSynthesizer()
             patchLoadThread->join();
     }
 
+    if (patchPrefetch.thread)
+        patchPrefetch.thread->join();
+
+    {
+        std::lock_guard<std::mutex> mg(neighbourPrefetchMutex);
+        if (neighbourPrefetchThread)
+            neighbourPrefetchThread->join();
+    }
+
     allNotesOff();
 
     for (int sc = 0; sc < n_scenes; sc++)
@@ -346,9 +401,18 @@ SurgeSynthesizer::~SurgeSynthesizer()
 // So, "1" means scene A, "2" means scene B and "3" (= 2 | 1) means both.
 int SurgeSynthesizer::calculateChannelMask(int channel, int key)
 {
+    // a batch of note-ons reads the user default once rather than once a note
+    if (noteBatchActive)
+        return calculateChannelMask(channel, key, noteBatchCh2Ch3);
+
     bool useMIDICh2Ch3 = Surge::Storage::getUserDefaultValue(
         &storage, Surge::Storage::UseCh2Ch3ToPlayScenesIndividually, true);
 
+    return calculateChannelMask(channel, key, useMIDICh2Ch3);
+}
+
+int SurgeSynthesizer::calculateChannelMask(int channel, int key, bool useMIDICh2Ch3)
+{
     int channelmask = channel;
 
     if (((channel == 0 || channel > 2) && useMIDICh2Ch3) ||
@@ -416,15 +480,10 @@ void SurgeSynthesizer::playNote(char channel, char key, char velocity, char detu
         return;
     }
 
-#ifndef SURGE_SKIP_ODDSOUND_MTS
-    if (storage.oddsound_mts_client && storage.oddsound_mts_active_as_client)
+    if (noteFilteredByMTS(channel, key))
     {
-        if (MTS_ShouldFilterNote(storage.oddsound_mts_client, key, channel))
-        {
-            return;
-        }
+        return;
     }
-#endif
 
     if (learn_param_from_note >= 0 &&
         storage.getPatch().param_ptr[learn_param_from_note]->ctrltype == ct_midikey_or_channel)
@@ -449,6 +508,7 @@ void SurgeSynthesizer::playNote(char channel, char key, char velocity, char detu
     }
 
     midiNoteEvents++;
+    editorChanges.mark(EditorChangeBus::ch_midiKeys);
 
     if (!storage.isStandardTuning)
     {
@@ -516,6 +576,110 @@ void SurgeSynthesizer::playNote(char channel, char key, char velocity, char detu
     }
 }
 
+bool SurgeSynthesizer::noteFilteredByMTS(char channel, char key)
+{
+#ifndef SURGE_SKIP_ODDSOUND_MTS
+    if (storage.oddsound_mts_client && storage.oddsound_mts_active_as_client)
+    {
+        return MTS_ShouldFilterNote(storage.oddsound_mts_client, key, channel);
+    }
+#endif
+
+    return false;
+}
+
+void SurgeSynthesizer::queueNoteOn(char channel, char key, char velocity, char detune,
+                                   int32_t host_noteid)
+{
+    if (nQueuedNoteOns == (int)queuedNoteOns.size())
+        flushNoteOns();
+
+    queuedNoteOns[nQueuedNoteOns++] = {channel, key, velocity, detune, host_noteid,
+                                       eventOffsetInBlock};
+}
+
+void SurgeSynthesizer::flushNoteOns()
+{
+    if (nQueuedNoteOns == 0)
+        return;
+
+    auto n = nQueuedNoteOns;
+    nQueuedNoteOns = 0;
+
+    auto priorOffset = eventOffsetInBlock;
+    auto play = [this](const QueuedNoteOn &q) {
+        eventOffsetInBlock = q.offset;
+        playNote(q.channel, q.key, q.velocity, q.detune, q.host_noteid);
+    };
+
+    // a lone note has nothing to share, and a note learn only wants the first note anyway
+    if (n == 1 || halt_engine || learn_param_from_note >= 0)
+    {
+        for (int i = 0; i < n; ++i)
+            play(queuedNoteOns[i]);
+
+        eventOffsetInBlock = priorOffset;
+        return;
+    }
+
+    noteBatchActive = true;
+    noteBatchCh2Ch3 = Surge::Storage::getUserDefaultValue(
+        &storage, Surge::Storage::UseCh2Ch3ToPlayScenesIndividually, true);
+
+    int incoming[n_scenes]{};
+
+    for (int i = 0; i < n; ++i)
+    {
+        auto &q = queuedNoteOns[i];
+
+        if (noteFilteredByMTS(q.channel, q.key) ||
+            (!storage.isStandardTuning && !storage.currentTuning.isMidiNoteMapped(q.key)))
+            continue;
+
+        auto mask = calculateChannelMask(q.channel, q.key);
+
+        for (int s = 0; s < n_scenes; ++s)
+            if (mask & (1 << s))
+                incoming[s]++;
+    }
+
+    /*
+     * Played one at a time, each note past the polyphony limit soft kills the oldest voice, and
+     * once the voices from before the batch are gone that is the batch's own first notes. So
+     * skip those outright, and soft kill only as many older voices as the notes which do start
+     * need. This only holds when every note-on is a new voice; the modes which hand a
+     * repeated key its old voice back keep stealing a note at a time.
+     */
+    auto limit = getEffectivePolyphonyLimit();
+
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        auto &scene = storage.getPatch().scene[s];
+
+        noteBatchSkip[s] = 0;
+        noteBatchStolen[s] = incoming[s] > 0 && scene.polymode.val.i == pm_poly &&
+                             scene.polyVoiceRepeatedKeyMode == NEW_VOICE_EVERY_NOTEON;
+
+        if (!noteBatchStolen[s])
+            continue;
+
+        noteBatchSkip[s] = std::max(0, incoming[s] - limit);
+
+        auto excess = getNonUltrareleaseVoices(s) + incoming[s] - noteBatchSkip[s] - limit;
+
+        for (int i = 0; i < excess; ++i)
+            softkillVoice(s);
+    }
+
+    for (int i = 0; i < n; ++i)
+        play(queuedNoteOns[i]);
+
+    noteBatchActive = false;
+    noteBatchStolen.fill(false);
+    noteBatchSkip.fill(0);
+    eventOffsetInBlock = priorOffset;
+}
+
 // This supports an OSC message that specifies pitch by frequency (rather than by MIDI note number)
 void SurgeSynthesizer::playNoteByFrequency(float freq, char velocity, int32_t id)
 {
@@ -531,7 +695,7 @@ void SurgeSynthesizer::playNoteByFrequency(float freq, char velocity, int32_t id
 
 void SurgeSynthesizer::softkillVoice(int s)
 {
-    list<SurgeVoice *>::iterator iter, max_playing, max_released;
+    ActiveVoiceList::iterator iter, max_playing, max_released;
     int max_age = -1, max_age_release = -1;
     iter = voices[s].begin();
 
@@ -566,13 +730,14 @@ void SurgeSynthesizer::softkillVoice(int s)
 // only allow 'margin' number of voices to be softkilled simultaneously
 void SurgeSynthesizer::enforcePolyphonyLimit(int s, int margin)
 {
-    list<SurgeVoice *>::iterator iter;
+    ActiveVoiceList::iterator iter;
 
-    int paddedPoly = std::min((storage.getPatch().polylimit.val.i + margin), MAX_VOICES - 1);
+    int paddedPoly = std::min((getEffectivePolyphonyLimit() + margin), voiceCapacity() - 1);
     if (voices[s].size() > paddedPoly)
     {
         int excess_voices = max(0, (int)voices[s].size() - paddedPoly);
         iter = voices[s].begin();
+        bool shifted = false;
 
         while (iter != voices[s].end())
         {
@@ -585,9 +750,21 @@ void SurgeSynthesizer::enforcePolyphonyLimit(int s, int margin)
                 excess_voices--;
                 freeVoice(v);
                 iter = voices[s].erase(iter);
+                shifted = true;
             }
             else
+            {
+                // erasing moves every later voice down a filter lane
+                if (shifted)
+                    v->evictFromQFB();
                 iter++;
+            }
+        }
+
+        while (shifted && iter != voices[s].end())
+        {
+            (*iter)->evictFromQFB();
+            iter++;
         }
     }
 }
@@ -628,7 +805,7 @@ int SurgeSynthesizer::getNonReleasedVoices(int s) const
 
 SurgeVoice *SurgeSynthesizer::getUnusedVoice(int scene)
 {
-    for (int i = 0; i < MAX_VOICES; i++)
+    for (int i = 0; i < voiceCapacity(); i++)
     {
         if (!voices_usedby[scene][i])
         {
@@ -641,38 +818,53 @@ SurgeVoice *SurgeSynthesizer::getUnusedVoice(int scene)
 
 void SurgeSynthesizer::freeVoice(SurgeVoice *v)
 {
+    int scene, slot;
+    bool indexed = voiceSlot(v, scene, slot);
+
+    if (v->noteCacheRole != SurgeVoice::nc_live)
+        endNoteCacheRole(v);
+
     if (v->host_note_id >= 0)
     {
-        bool used_away = false;
         // does any other voice have this voiceid
-        for (int s = 0; s < n_scenes; ++s)
-        {
-            for (auto vo : voices[s])
-            {
-                if (vo != v && vo->host_note_id == v->host_note_id)
-                {
-                    used_away = true;
-                }
-            }
-        }
+        bool used_away =
+            indexed && noteVoiceIndex.noteIdUsedElsewhere(v->host_note_id, scene, slot);
+
         if (!used_away)
         {
             notifyEndedNote(v->host_note_id, v->originating_host_key, v->originating_host_channel);
         }
     }
 
-    for (int i = 0; i < MAX_VOICES; i++)
+    if (indexed)
     {
-        if (voices_usedby[0][i] && (v == &voices_array[0][i]))
-        {
-            voices_usedby[0][i] = 0;
-        }
-        if (voices_usedby[1][i] && (v == &voices_array[1][i]))
+        voices_usedby[scene][slot] = 0;
+        noteVoiceIndex.clear(scene, slot);
+    }
+
+    v->freeAllocatedElements();
+}
+
+bool SurgeSynthesizer::voiceSlot(const SurgeVoice *v, int &scene, int &slot) const
+{
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        auto first = &voices_array[sc][0];
+        if (v >= first && v < first + voiceCapacity())
         {
-            voices_usedby[1][i] = 0;
+            scene = sc;
+            slot = (int)(v - first);
+            return true;
         }
     }
-    v->freeAllocatedElements();
+    return false;
+}
+
+void SurgeSynthesizer::indexVoice(SurgeVoice *v)
+{
+    int scene, slot;
+    if (voiceSlot(v, scene, slot))
+        noteVoiceIndex.set(scene, slot, v->state.channel, v->state.key, v->host_note_id);
 }
 
 void SurgeSynthesizer::notifyEndedNote(int32_t nid, int16_t key, int16_t chan, bool thisBlock)
@@ -682,6 +874,8 @@ void SurgeSynthesizer::notifyEndedNote(int32_t nid, int16_t key, int16_t chan, b
     if (thisBlock)
     {
         int h = hostNoteEndedDuringBlockCount;
+        if (h >= (int)endedHostNoteIds.size())
+            return;
         endedHostNoteIds[h] = nid;
         endedHostNoteOriginalKey[h] = key;
         endedHostNoteOriginalChannel[h] = chan;
@@ -690,6 +884,8 @@ void SurgeSynthesizer::notifyEndedNote(int32_t nid, int16_t key, int16_t chan, b
     else
     {
         int h = hostNoteEndedToPushToNextBlock;
+        if (h >= (int)nextBlockEndedHostNoteIds.size())
+            return;
         nextBlockEndedHostNoteIds[h] = nid;
         nextBlockEndedHostNoteOriginalKey[h] = key;
         nextBlockEndedHostNoteOriginalChannel[h] = chan;
@@ -741,12 +937,15 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
         storage.getPatch().scene[scene].modsources[i]->attack();
     }
 
-    int excessVoices =
-        max(0, (int)getNonUltrareleaseVoices(scene) - storage.getPatch().polylimit.val.i + 1);
-
-    for (int i = 0; i < excessVoices; i++)
+    if (!noteBatchStolen[scene])
     {
-        softkillVoice(scene);
+        int excessVoices =
+            max(0, (int)getNonUltrareleaseVoices(scene) - getEffectivePolyphonyLimit() + 1);
+
+        for (int i = 0; i < excessVoices; i++)
+        {
+            softkillVoice(scene);
+        }
     }
     enforcePolyphonyLimit(scene, 3);
 
@@ -793,7 +992,19 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
             }
         }
 
-        if (!reusedVoice)
+        // the rest of this batch of note-ons would only steal this one straight back
+        if (!reusedVoice && noteBatchSkip[scene] > 0)
+        {
+            noteBatchSkip[scene]--;
+
+            // it never sounds, but the host still has to hear that the note is over
+            if (host_noteid >= 0)
+            {
+                notifyEndedNote(host_noteid, host_originating_key, host_originating_channel,
+                                false);
+            }
+        }
+        else if (!reusedVoice)
         {
             SurgeVoice *nvoice = getUnusedVoice(scene);
 
@@ -808,6 +1019,11 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                                         &channelState[mpeMainChannel], &channelState[channel],
                                         mpeEnabled, voiceCounter++, host_noteid,
                                         host_originating_key, host_originating_channel, 0.f, 0.f);
+                indexVoice(nvoice);
+                nvoice->setStartOffset(eventOffsetInBlock * OSC_OVERSAMPLING);
+
+                if (noteRenderCache)
+                    startNoteCacheRole(nvoice, scene);
             }
         }
         break;
@@ -816,7 +1032,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
     case pm_mono_fp:
     case pm_latch:
     {
-        list<SurgeVoice *>::const_iterator iter;
+        ActiveVoiceList::const_iterator iter;
         bool glide = false;
 
         int primode = storage.getPatch().scene[scene].monoVoicePriorityMode;
@@ -946,6 +1162,8 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                         &channelState[channel].keyState[key], &channelState[mpeMainChannel],
                         &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                         host_originating_key, host_originating_channel, aegReuse, fegReuse);
+                    indexVoice(nvoice);
+                    nvoice->setStartOffset(eventOffsetInBlock * OSC_OVERSAMPLING);
                 }
             }
         }
@@ -1024,7 +1242,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
 
         if (createVoice)
         {
-            list<SurgeVoice *>::const_iterator iter;
+            ActiveVoiceList::const_iterator iter;
             SurgeVoice *recycleThis{nullptr};
             float aegStart{0.}, fegStart{0.};
             for (iter = voices[scene].begin(); iter != voices[scene].end(); iter++)
@@ -1046,6 +1264,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                         v->state.channel = channel;
                         v->state.voiceChannelState = &channelState[channel];
                     }
+                    indexVoice(v);
                     break;
                 }
                 else
@@ -1079,6 +1298,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                         &channelState[channel].keyState[key], &channelState[mpeMainChannel],
                         &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                         host_originating_key, host_originating_channel, aegStart, fegStart);
+                    indexVoice(nvoice);
                 }
             }
             else
@@ -1119,7 +1339,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
 
 void SurgeSynthesizer::releaseScene(int s)
 {
-    list<SurgeVoice *>::const_iterator iter;
+    ActiveVoiceList::const_iterator iter;
     for (iter = voices[s].begin(); iter != voices[s].end(); iter++)
     {
         freeVoice(*iter);
@@ -1133,6 +1353,7 @@ void SurgeSynthesizer::releaseScene(int s)
         else
             hpB[i].suspend();
     }
+    lowcutCoefficientState[s] = LowcutCoefficientState();
     if (s == 0)
         halfbandA.reset();
     if (s == 1)
@@ -1152,30 +1373,31 @@ void SurgeSynthesizer::chokeNote(int16_t channel, int16_t key, char velocity, in
 
     for (int sc = 0; sc < n_scenes; ++sc)
     {
-        for (auto *v : voices[sc])
-        {
+        forEachVoiceCandidate(sc, channel, key, host_noteid, [&](SurgeVoice *v) {
             if (v->matchesChannelKeyId(channel, key, host_noteid))
             {
                 v->uber_release();
             }
-        }
+        });
     }
 }
 
 void SurgeSynthesizer::releaseNote(char channel, char key, char velocity, int32_t host_noteid)
 {
+    // a queued note-on for this key has to start before it can be released
+    flushNoteOns();
+
     midiNoteEvents++;
+    editorChanges.mark(EditorChangeBus::ch_midiKeys);
     bool foundVoice[n_scenes];
     for (int sc = 0; sc < n_scenes; ++sc)
     {
-        foundVoice[sc] = false;
-        for (auto *v : voices[sc])
-        {
-            foundVoice[sc] = true;
+        foundVoice[sc] = !voices[sc].empty();
+        forEachVoiceCandidate(sc, channel, key, host_noteid, [&](SurgeVoice *v) {
             if ((v->state.key == key) && (v->state.channel == channel) &&
                 (host_noteid < 0 || v->host_note_id == host_noteid))
                 v->state.releasevelocity = velocity;
-        }
+        });
     }
 
     /*
@@ -1265,7 +1487,7 @@ void SurgeSynthesizer::releaseNotePostHoldCheck(int scene, char channel, char ke
                                                 int32_t host_noteid)
 {
     channelState[channel].keyState[key].keystate = 0;
-    list<SurgeVoice *>::const_iterator iter;
+    ActiveVoiceList::const_iterator iter;
     for (int s = 0; s < n_scenes; s++)
     {
         bool do_switch = false;
@@ -1600,6 +1822,7 @@ void SurgeSynthesizer::releaseNotePostHoldCheck(int scene, char channel, char ke
                         {
                             v->legato(k, velocity, channelState[channel].keyState[k].lastdetune);
                             do_release = false;
+                            indexVoice(v);
                         }
                     }
                     else if (!mpeEnabled && storage.mapChannelToOctave)
@@ -1668,6 +1891,7 @@ void SurgeSynthesizer::releaseNotePostHoldCheck(int scene, char channel, char ke
 
                             v->state.channel = ch;
                             v->state.voiceChannelState = &channelState[ch];
+                            indexVoice(v);
                         }
                     }
                     else
@@ -1729,6 +1953,7 @@ void SurgeSynthesizer::releaseNotePostHoldCheck(int scene, char channel, char ke
                             // See the comment above at the other _st legato spot
                             v->state.channel = kchan;
                             v->state.voiceChannelState = &channelState[kchan];
+                            indexVoice(v);
                             // std::cout << _D(v->state.gate) << _D(v->state.key) <<
                             // _D(v->state.scene_id ) << std::endl;
                         }
@@ -1760,13 +1985,30 @@ void SurgeSynthesizer::setNoteExpression(SurgeVoice::NoteExpressionType net, int
 {
     for (int sc = 0; sc < n_scenes; sc++)
     {
-        for (auto v : voices[sc])
-        {
+        forEachVoiceCandidate(sc, channel, key, note_id, [&](SurgeVoice *v) {
             if (v->matchesChannelKeyId(channel, key, note_id))
             {
                 v->applyNoteExpression(net, value);
             }
-        }
+        });
+    }
+}
+
+void SurgeSynthesizer::setNoteExpressions(int32_t note_id, int16_t key, int16_t channel,
+                                          const float *values, uint32_t which)
+{
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        forEachVoiceCandidate(sc, channel, key, note_id, [&](SurgeVoice *v) {
+            if (v->matchesChannelKeyId(channel, key, note_id))
+            {
+                for (int n = 0; n < SurgeVoice::numNoteExpressionTypes; ++n)
+                {
+                    if (which & (1 << n))
+                        v->applyNoteExpression((SurgeVoice::NoteExpressionType)n, values[n]);
+                }
+            }
+        });
     }
 }
 
@@ -1836,6 +2078,7 @@ void SurgeSynthesizer::resetPitchBend(int8_t channel)
     storage.pitch_bend = 0.f;
     pitchbendMIDIVal = 0;
     hasUpdatedMidiCC = true;
+    editorChanges.mark(EditorChangeBus::ch_midiCC);
 
     if (channel > -1)
     {
@@ -1888,6 +2131,7 @@ void SurgeSynthesizer::pitchBend(char channel, int value)
 
         pitchbendMIDIVal = value;
         hasUpdatedMidiCC = true;
+        editorChanges.mark(EditorChangeBus::ch_midiCC);
 
         for (int sc = 0; sc < n_scenes; sc++)
         {
@@ -2057,6 +2301,8 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
 
         modwheelCC = value;
         hasUpdatedMidiCC = true;
+        storage.getPatch().isDirty.touch(); // the mod wheel is streamed with the patch
+        editorChanges.mark(EditorChangeBus::ch_midiCC);
         break;
     case 2:
         for (int sc = 0; sc < n_scenes; sc++)
@@ -2116,6 +2362,7 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
 
         sustainpedalCC = value;
         hasUpdatedMidiCC = true;
+        editorChanges.mark(EditorChangeBus::ch_midiCC);
 
         channelState[channel].hold = value > 63; // check hold pedal
 
@@ -2264,6 +2511,7 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
         {
             storage.getPatch().param_ptr[learn_param_from_cc]->midictrl = cc_encoded;
             storage.getPatch().param_ptr[learn_param_from_cc]->midichan = channel;
+            storage.midiMappingChanged();
 
             learn_param_from_cc = -1;
         }
@@ -2275,23 +2523,39 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
         {
             storage.controllers[learn_macro_from_cc] = cc_encoded;
             storage.controllers_chan[learn_macro_from_cc] = channel;
+            storage.midiMappingChanged();
 
             learn_macro_from_cc = -1;
         }
     }
 
-    for (int i = 0; i < n_customcontrollers; i++)
+    if (!ccDispatchBuilt || ccDispatchRevision != storage.midiMappingRevision)
     {
-        if (storage.controllers[i] == cc_encoded &&
-            (storage.controllers_chan[i] == channel || storage.controllers_chan[i] == -1))
-        {
-            ((ControllerModulationSource *)storage.getPatch().scene[0].modsources[ms_ctrl1 + i])
-                ->set_target01(0, fval);
-        }
+        rebuildCCDispatch();
     }
 
-    for (int i = 0; i < (n_global_params + (n_scene_params * n_scenes)); i++)
+    int bucket = (cc_encoded >= 0 && cc_encoded < 128) ? cc_encoded : 128;
+
+    for (int t = ccDispatchStart[bucket]; t < ccDispatchStart[bucket + 1]; t++)
     {
+        int i = ccDispatchTargets[t];
+
+        if (i < 0)
+        {
+            i = -1 - i;
+
+            if (storage.controllers[i] == cc_encoded &&
+                (storage.controllers_chan[i] == channel || storage.controllers_chan[i] == -1))
+            {
+                ((ControllerModulationSource *)storage.getPatch().scene[0].modsources[ms_ctrl1 + i])
+                    ->set_target01(0, fval);
+                storage.getPatch().isDirty.touch();
+                editorChanges.mark(EditorChangeBus::ch_controllers);
+            }
+
+            continue;
+        }
+
         if (storage.getPatch().param_ptr[i]->midictrl == cc_encoded &&
             (storage.getPatch().param_ptr[i]->midichan == channel ||
              storage.getPatch().param_ptr[i]->midichan == -1))
@@ -2313,10 +2577,54 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
 
             refresh_ctrl_queue[j] = i;
             refresh_ctrl_queue_value[j] = fval;
+            editorChanges.markParameter(i, n_total_params);
         }
     }
 }
 
+void SurgeSynthesizer::rebuildCCDispatch()
+{
+    ccDispatchRevision = storage.midiMappingRevision;
+    ccDispatchBuilt = true;
+
+    auto bucketOf = [](int enc) { return (enc >= 0 && enc < 128) ? enc : 128; };
+    int nParams = n_global_params + (n_scene_params * n_scenes);
+    int counts[n_cc_dispatch_buckets]{};
+
+    for (int i = 0; i < n_customcontrollers; i++)
+    {
+        if (storage.controllers[i] >= 0)
+            counts[bucketOf(storage.controllers[i])]++;
+    }
+
+    for (int i = 0; i < nParams; i++)
+    {
+        if (storage.getPatch().param_ptr[i]->midictrl >= 0)
+            counts[bucketOf(storage.getPatch().param_ptr[i]->midictrl)]++;
+    }
+
+    ccDispatchStart[0] = 0;
+
+    for (int b = 0; b < n_cc_dispatch_buckets; b++)
+    {
+        ccDispatchStart[b + 1] = ccDispatchStart[b] + counts[b];
+        counts[b] = ccDispatchStart[b];
+    }
+
+    // macros go first and parameters in index order, as the full scan this replaces did
+    for (int i = 0; i < n_customcontrollers; i++)
+    {
+        if (storage.controllers[i] >= 0)
+            ccDispatchTargets[counts[bucketOf(storage.controllers[i])]++] = -1 - i;
+    }
+
+    for (int i = 0; i < nParams; i++)
+    {
+        if (storage.getPatch().param_ptr[i]->midictrl >= 0)
+            ccDispatchTargets[counts[bucketOf(storage.getPatch().param_ptr[i]->midictrl)]++] = i;
+    }
+}
+
 void SurgeSynthesizer::purgeHoldbuffer(int scene)
 {
     std::list<HoldBufferItem> retainBuffer;
@@ -2386,6 +2694,8 @@ void SurgeSynthesizer::purgeDuplicateHeldVoicesInPolyMode(int scene, int channel
 
 void SurgeSynthesizer::allNotesOff()
 {
+    nQueuedNoteOns = 0;
+
     for (int i = 0; i < 16; i++)
     {
         channelState[i].hold = false;
@@ -2399,7 +2709,7 @@ void SurgeSynthesizer::allNotesOff()
 
     for (int s = 0; s < n_scenes; s++)
     {
-        list<SurgeVoice *>::const_iterator iter;
+        ActiveVoiceList::const_iterator iter;
         for (iter = voices[s].begin(); iter != voices[s].end(); iter++)
         {
             freeVoice(*iter);
@@ -2417,6 +2727,8 @@ void SurgeSynthesizer::allNotesOff()
         hpA[i].suspend();
         hpB[i].suspend();
     }
+    for (auto &lc : lowcutCoefficientState)
+        lc = LowcutCoefficientState();
 
     for (int i = 0; i < n_fx_slots; i++)
     {
@@ -2426,7 +2738,7 @@ void SurgeSynthesizer::allNotesOff()
         }
     }
 
-    memset(mControlInterpolatorUsed, 0, sizeof(bool) * num_controlinterpolators);
+    resetControlInterpolators();
 }
 
 void SurgeSynthesizer::setSamplerate(float sr)
@@ -2453,31 +2765,59 @@ void SurgeSynthesizer::setSamplerate(float sr)
 
 //-------------------------------------------------------------------------------------------------
 
-int SurgeSynthesizer::GetFreeControlInterpolatorIndex()
+void SurgeSynthesizer::resetControlInterpolators()
 {
+    for (auto &s : mControlInterpolatorSlot)
+        s = -1;
+
+    mControlInterpolatorFreeCount = num_controlinterpolators;
     for (int i = 0; i < num_controlinterpolators; i++)
+        mControlInterpolatorFree[i] = num_controlinterpolators - 1 - i;
+
+    mControlInterpolatorActiveCount = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int SurgeSynthesizer::GetFreeControlInterpolatorIndex()
+{
+    if (mControlInterpolatorFreeCount == 0)
     {
-        if (!mControlInterpolatorUsed[i])
-        {
-            return i;
-        }
+        assert(0);
+        return -1;
     }
-    assert(0);
-    return -1;
+
+    int Index = mControlInterpolatorFree[--mControlInterpolatorFreeCount];
+    mControlInterpolatorActivePos[Index] = mControlInterpolatorActiveCount;
+    mControlInterpolatorActive[mControlInterpolatorActiveCount++] = Index;
+    return Index;
 }
 
 //-------------------------------------------------------------------------------------------------
 
 int SurgeSynthesizer::GetControlInterpolatorIndex(int Id)
 {
-    for (int i = 0; i < num_controlinterpolators; i++)
-    {
-        if (mControlInterpolatorUsed[i] && mControlInterpolator[i].id == Id)
-        {
-            return i;
-        }
-    }
-    return -1;
+    if (Id < 0 || Id >= n_total_params)
+        return -1;
+
+    return mControlInterpolatorSlot[Id];
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void SurgeSynthesizer::releaseControlInterpolatorSlot(int Index)
+{
+    assert(Index >= 0 && Index < num_controlinterpolators);
+
+    mControlInterpolatorSlot[mControlInterpolator[Index].id] = -1;
+
+    // swap the last busy slot into this one's place in the packed list
+    auto pos = mControlInterpolatorActivePos[Index];
+    auto last = mControlInterpolatorActive[--mControlInterpolatorActiveCount];
+    mControlInterpolatorActive[pos] = last;
+    mControlInterpolatorActivePos[last] = pos;
+
+    mControlInterpolatorFree[mControlInterpolatorFreeCount++] = Index;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -2487,8 +2827,7 @@ void SurgeSynthesizer::ReleaseControlInterpolator(int Id)
     int Index = GetControlInterpolatorIndex(Id);
     if (Index >= 0)
     {
-        assert(Index < num_controlinterpolators);
-        mControlInterpolatorUsed[Index] = false;
+        releaseControlInterpolatorSlot(Index);
     }
 }
 
@@ -2520,13 +2859,16 @@ ControllerModulationSource *SurgeSynthesizer::AddControlInterpolator(int Id, boo
         return &mControlInterpolator[Index];
     }
 
+    if (Id < 0 || Id >= n_total_params)
+        return nullptr;
+
     Index = GetFreeControlInterpolatorIndex();
 
     if (Index >= 0)
     {
         // Add new
         mControlInterpolator[Index].id = Id;
-        mControlInterpolatorUsed[Index] = true;
+        mControlInterpolatorSlot[Id] = Index;
 
         mControlInterpolator[Index].set_samplerate(storage.samplerate, storage.samplerate_inv);
         mControlInterpolator[Index].smoothingMode = storage.smoothingMode; // IMPLEMENT THIS HERE
@@ -2569,6 +2911,30 @@ bool SurgeSynthesizer::setParameter01(long index, float value, bool external, bo
 
     if (index >= 0 && index < storage.getPatch().param_ptr.size())
     {
+        /*
+         * Dense host automation is almost all continuous float parameters, and none of the
+         * special cases below are about those; they are all switches and types. So set those
+         * straight away, and if the host sent the value we already have, which it does a lot,
+         * there is nothing to mark dirty or refresh either.
+         */
+        auto *fp = storage.getPatch().param_ptr[index];
+
+        if (fp->valtype == vt_float && !fp->affect_other_parameters)
+        {
+            auto oldf = fp->val.f;
+            fp->set_value_f01(value, force_integer);
+
+            if (fp->val.f != oldf)
+            {
+                storage.getPatch().isDirty = true;
+
+                if (external)
+                    queueParameterRefresh(index);
+            }
+
+            return false;
+        }
+
         pdata oldval, newval;
         oldval.i = storage.getPatch().param_ptr[index]->val.i;
 
@@ -2684,13 +3050,9 @@ bool SurgeSynthesizer::setParameter01(long index, float value, bool external, bo
                 // so funnily we want to set the value *back* so that loadFx picks up the change in
                 // fxsync
                 p->val.i = oldval.i;
-                Effect *t_fx = spawn_effect(fxsync[cge].type.val.i, &storage, &fxsync[cge], 0);
-                if (t_fx)
-                {
-                    t_fx->init_ctrltypes();
-                    t_fx->init_default_values();
-                    delete t_fx;
-                }
+
+                // this can be the audio thread, so the defaults are set where the effect is built
+                stageEffectForSlot(cge, fxsync[cge].type.val.i, true);
 
                 switch_toggled_queued = true;
                 load_fx_needed = true;
@@ -2763,28 +3125,32 @@ bool SurgeSynthesizer::setParameter01(long index, float value, bool external, bo
     }
 
     if (external && !need_refresh)
+        queueParameterRefresh(index);
+
+    return need_refresh;
+}
+
+void SurgeSynthesizer::queueParameterRefresh(long index)
+{
+    for (int i = 0; i < 8; i++)
     {
-        bool got = false;
-        for (int i = 0; i < 8; i++)
+        if (refresh_parameter_queue[i] < 0 || refresh_parameter_queue[i] == index)
         {
-            if (refresh_parameter_queue[i] < 0 || refresh_parameter_queue[i] == index)
-            {
-                refresh_parameter_queue[i] = index;
-                got = true;
-                break;
-            }
+            refresh_parameter_queue[i] = index;
+            editorChanges.markParameter((int)index, n_total_params);
+            return;
         }
-        if (!got)
-            refresh_overflow = true;
     }
-    return need_refresh;
+
+    refresh_overflow = true;
+    editorChanges.markParameter((int)index, n_total_params);
 }
 
 void SurgeSynthesizer::switch_toggled()
 {
     for (int s = 0; s < n_scenes; s++)
     {
-        list<SurgeVoice *>::iterator iter;
+        ActiveVoiceList::iterator iter;
         for (iter = voices[s].begin(); iter != voices[s].end(); iter++)
         {
             SurgeVoice *v = *iter;
@@ -2796,18 +3162,86 @@ void SurgeSynthesizer::switch_toggled()
 bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
 {
     load_fx_needed = false;
-    for (int s = 0; s < n_fx_slots; s++)
+
+    /*
+     * Lift the instances a reorder moves out of their old slots before any slot is rebuilt,
+     * since a swap reads each slot it writes, and hold the spawn lock until they have all
+     * landed. A patch load replaces them all anyway.
+     */
+    std::unique_ptr<Effect> moved[n_fx_slots];
+    std::unique_lock<std::mutex> moveLock(fxSpawnMutex, std::defer_lock);
+
+    if (!force_reload_all &&
+        std::any_of(std::begin(fxMoveFrom), std::end(fxMoveFrom), [](int f) { return f >= 0; }))
     {
-        bool something_changed = false;
-        if ((fxsync[s].type.val.i != storage.getPatch().fx[s].type.val.i) || force_reload_all ||
-            fx_reload[s])
+        if (!moveLock.try_lock())
         {
+            load_fx_needed = true;
+            return true;
+        }
+
+        for (int s = 0; s < n_fx_slots; s++)
+        {
+            auto from = fxMoveFrom[s];
+
+            // the instance has to still be the type the slot is getting
+            if (from >= 0 && fx[from] &&
+                storage.getPatch().fx[from].type.val.i == fxsync[s].type.val.i)
+                moved[s] = std::move(fx[from]);
+        }
+    }
+
+    std::fill(std::begin(fxMoveFrom), std::end(fxMoveFrom), -1);
+
+    if (force_reload_all)
+    {
+        for (int s = 0; s < n_fx_slots; s++)
+            retireEffect(s, std::move(fxCrossfade[s].from));
+    }
+
+    for (int s = 0; s < n_fx_slots; s++)
+    {
+        bool something_changed = false;
+        if ((fxsync[s].type.val.i != storage.getPatch().fx[s].type.val.i) || force_reload_all ||
+            fx_reload[s])
+        {
+            // a single slot change waits, with the old effect running, for its new one to be built
+            if (!force_reload_all && !moved[s] && isStagingEffect(s))
+            {
+                load_fx_needed = true;
+                continue;
+            }
+
+            /*
+             * The UI holds this lock while it looks at, or builds, an effect. A single slot
+             * change hasn't touched the patch's copy of the FX yet, so rather than wait on the
+             * UI we leave the old effect running and try again next block. A patch load has
+             * already rewritten every slot's parameters, so that has to go through now.
+             */
+            std::unique_lock<std::mutex> g(fxSpawnMutex, std::defer_lock);
+
+            if (moveLock.owns_lock())
+            {
+                // already ours for the reorder
+            }
+            else if (force_reload_all)
+            {
+                g.lock();
+            }
+            else if (!g.try_lock())
+            {
+                load_fx_needed = true;
+                continue;
+            }
+
             storage.getPatch().isDirty = true;
             fx_reload[s] = false;
 
-            std::lock_guard<std::mutex> g(fxSpawnMutex);
+            auto retiring = std::move(fx[s]);
 
-            fx[s].reset();
+            // a single slot change fades from the old effect to the new one; see processFXSlot
+            if (retiring && !force_reload_all && fxsync[s].type.val.i != fxt_off)
+                beginFXCrossfade(s, std::move(retiring));
             /*if (!force_reload_all)*/ storage.getPatch().fx[s].type.val.i = fxsync[s].type.val.i;
             // else fxsync[s].type.val.i = storage.getPatch().fx[s].type.val.i;
 
@@ -2827,8 +3261,25 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
                           std::begin(storage.getPatch().fx[s].p));
             }
 
-            fx[s].reset(spawn_effect(storage.getPatch().fx[s].type.val.i, &storage,
-                                     &storage.getPatch().fx[s], storage.getPatch().globaldata));
+            bool adopted = (bool)moved[s], primed = false;
+
+            if (adopted)
+            {
+                fx[s] = std::move(moved[s]);
+                fx[s]->rebindStorage(&storage.getPatch().fx[s], storage.getPatch().globaldata);
+            }
+            else if (!force_reload_all)
+            {
+                fx[s] = takeStagedEffect(s, storage.getPatch().fx[s].type.val.i);
+                primed = (bool)fx[s];
+            }
+
+            if (!fx[s])
+                fx[s].reset(spawn_effect(storage.getPatch().fx[s].type.val.i, &storage,
+                                         &storage.getPatch().fx[s], storage.getPatch().globaldata));
+
+            retireEffect(s, std::move(retiring));
+
             if (fx[s])
             {
                 fx[s]->init_ctrltypes();
@@ -2886,7 +3337,10 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
                     storage.getPatch().fx[s].p[j].val.f;
                 }*/
 
-                fx[s]->init();
+                // a moved instance keeps its buffers, and with them its tail, and a staged one
+                // was initialized as it was built
+                if (!adopted && !primed)
+                    fx[s]->init();
 
                 /*
                 ** Clear modulation onto FX otherwise it hangs around from old ones, often with
@@ -2965,6 +3419,10 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
         }
     }
 
+    // a moved effect no slot ended up taking goes the way of any replaced one
+    for (int s = 0; s < n_fx_slots; s++)
+        retireEffect(s, std::move(moved[s]));
+
     // if (something_changed) storage.getPatch().update_controls(false);
     return true;
 }
@@ -2978,6 +3436,12 @@ bool SurgeSynthesizer::loadOscalgos()
         {
             bool resend = false;
 
+            // only an actual type change or queued settings count as a load phase
+            Surge::Profiling::PatchLoadProfile::Scope ps(
+                storage.patchLoadProfile, Surge::Profiling::PatchLoadProfile::lp_oscillators,
+                storage.getPatch().scene[s].osc[i].queue_type > -1 ||
+                    storage.getPatch().scene[s].osc[i].queue_xmldata);
+
             if (storage.getPatch().scene[s].osc[i].queue_type > -1)
             {
                 algosChanged = true;
@@ -3061,6 +3525,8 @@ bool SurgeSynthesizer::loadOscalgos()
 
     if (algosChanged)
     {
+        Surge::Profiling::PatchLoadProfile::Scope ps(
+            storage.patchLoadProfile, Surge::Profiling::PatchLoadProfile::lp_oscillators);
         storage.memoryPools->resetOscillatorPools(&storage);
     }
     return true;
@@ -3329,53 +3795,234 @@ void SurgeSynthesizer::updateUsedState()
     storage.modRoutingMutex.unlock();
 }
 
+/*
+ * A modulator only needs to run if something audible depends on it. We treat the routings as
+ * a graph from sources to destinations, and a destination is live if the thing owning it is
+ * actually in the signal path (an unmuted oscillator, a filter unit which isn't off, an FX
+ * slot which is loaded and enabled) or is itself a live modulator. Solving that needs a small
+ * fixpoint since modulators modulate each other, so we only do it when the inputs change,
+ * which the liveness key below detects.
+ */
+uint64_t SurgeSynthesizer::modsourceLivenessKey(int scenemask) const
+{
+    // FNV-1a over everything the liveness graph is built from
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto mix = [&h](int64_t v) {
+        h ^= (uint64_t)v;
+        h *= 0x100000001b3ULL;
+    };
+
+    auto mixRouting = [&mix](const std::vector<ModulationRouting> &routing) {
+        mix((int64_t)routing.size());
+
+        for (const auto &r : routing)
+        {
+            mix(r.source_id);
+            mix(r.source_scene);
+            mix(r.destination_id);
+            mix(r.muted);
+        }
+    };
+
+    auto &patch = storage.getPatch();
+
+    mix(scenemask);
+    mixRouting(*storage.modRouting.global);
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        auto &scene = patch.scene[sc];
+
+        mixRouting(*storage.modRouting.scene[sc]);
+        mixRouting(*storage.modRouting.voice[sc]);
+
+        for (const auto *pb : {&scene.mute_o1, &scene.mute_o2, &scene.mute_o3, &scene.mute_ring_12,
+                               &scene.mute_ring_23, &scene.solo_o1, &scene.solo_o2, &scene.solo_o3,
+                               &scene.solo_ring_12, &scene.solo_ring_23, &scene.solo_noise,
+                               &scene.f2_cutoff_is_offset, &scene.f2_link_resonance})
+        {
+            mix(pb->val.b);
+        }
+
+        mix(scene.fm_switch.val.i);
+
+        for (const auto &fu : scene.filterunit)
+        {
+            mix(fu.type.val.i);
+            mix(fu.type.deactivated);
+        }
+
+        for (int l = 0; l < n_lfos; ++l)
+        {
+            mix(scene.lfo[l].shape.val.i);
+            mix((int64_t)patch.stepsequences[sc][l].trigmask);
+        }
+    }
+
+    for (const auto &fx : patch.fx)
+        mix(fx.type.val.i);
+
+    mix(patch.fx_disable.val.i);
+    mix(patch.fx_bypass.val.i);
+
+    return h;
+}
+
+bool SurgeSynthesizer::isModulationDestinationLive(int scene, int paramId,
+                                                   const bool *sceneSourceLive) const
+{
+    auto &patch = storage.getPatch();
+
+    if (paramId < 0 || paramId >= (int)patch.param_ptr.size())
+        return true;
+
+    auto *p = patch.param_ptr[paramId];
+    auto &sc = patch.scene[scene];
+
+    switch (p->ctrlgroup)
+    {
+    case cg_OSC:
+    {
+        bool solo = sc.solo_o1.val.b || sc.solo_o2.val.b || sc.solo_o3.val.b ||
+                    sc.solo_ring_12.val.b || sc.solo_ring_23.val.b || sc.solo_noise.val.b;
+
+        // the solo and FM paths are involved enough that we just assume everything is used
+        if (solo || sc.fm_switch.val.i != fm_off)
+            return true;
+
+        switch (p->ctrlgroup_entry)
+        {
+        case 0:
+            return !sc.mute_o1.val.b || !sc.mute_ring_12.val.b;
+        case 1:
+            return !sc.mute_o2.val.b || !sc.mute_ring_12.val.b || !sc.mute_ring_23.val.b;
+        case 2:
+            return !sc.mute_o3.val.b || !sc.mute_ring_23.val.b;
+        }
+
+        return true;
+    }
+    case cg_FILTER:
+    {
+        auto unitOn = [&sc](int u) {
+            return !sc.filterunit[u].type.deactivated && sc.filterunit[u].type.val.i != 0;
+        };
+
+        auto f = p->ctrlgroup_entry;
+
+        if (f < 0 || f >= n_filterunits_per_scene || unitOn(f))
+            return true;
+
+        // filter 2 can borrow the cutoff and resonance of filter 1
+        return f == 0 && unitOn(1) && (sc.f2_cutoff_is_offset.val.b || sc.f2_link_resonance.val.b);
+    }
+    case cg_FX:
+    {
+        auto slot = p->ctrlgroup_entry;
+
+        if (slot < 0 || slot >= n_fx_slots)
+            return true;
+
+        return patch.fx[slot].type.val.i != fxt_off && patch.fx_bypass.val.i != fxb_no_fx &&
+               !(patch.fx_disable.val.i & (1 << slot));
+    }
+    case cg_LFO:
+    {
+        auto ms = p->ctrlgroup_entry;
+
+        if (ms < 0 || ms >= n_modsources)
+            return true;
+
+        return sceneSourceLive[ms];
+    }
+    default:
+        break;
+    }
+
+    return true;
+}
+
 void SurgeSynthesizer::prepareModsourceDoProcess(int scenemask)
 {
+    auto key = modsourceLivenessKey(scenemask);
+
+    if (key == modsourceLivenessKeyLastBlock)
+        return;
+
+    modsourceLivenessKeyLastBlock = key;
+
+    auto &patch = storage.getPatch();
+    bool live[n_scenes][n_modsources];
+
     for (int scene = 0; scene < n_scenes; scene++)
     {
-        if ((1 << scene) & scenemask)
+        for (int i = 0; i < n_modsources; i++)
         {
-            for (int i = 0; i < n_modsources; i++)
+            bool setTo = false;
+            if (i >= ms_lfo1 && i <= ms_lfo6)
             {
-                bool setTo = false;
-                if (i >= ms_lfo1 && i <= ms_lfo6)
+                auto lf = &(patch.scene[scene].lfo[i - ms_lfo1]);
+                if (lf->shape.val.i == lt_stepseq)
                 {
-                    auto lf = &(storage.getPatch().scene[scene].lfo[i - ms_lfo1]);
-                    if (lf->shape.val.i == lt_stepseq)
-                    {
-                        auto ss = &(storage.getPatch().stepsequences[scene][i - ms_lfo1]);
-                        setTo = (ss->trigmask != 0);
-                    }
+                    auto ss = &(patch.stepsequences[scene][i - ms_lfo1]);
+                    setTo = (ss->trigmask != 0);
                 }
-                storage.getPatch().scene[scene].modsource_doprocess[i] = setTo;
             }
+            live[scene][i] = setTo;
+        }
+    }
 
-            for (int j = 0; j < 3; j++)
-            {
-                vector<ModulationRouting> *modlist;
+    // every pass can only add sources, so this settles in at most n_modsources passes
+    bool changed = true;
 
-                switch (j)
-                {
-                case 0:
-                    modlist = &storage.getPatch().modulation_global;
-                    break;
-                case 1:
-                    modlist = &storage.getPatch().scene[scene].modulation_scene;
-                    break;
-                case 2:
-                    modlist = &storage.getPatch().scene[scene].modulation_voice;
-                    break;
-                }
+    while (changed)
+    {
+        changed = false;
 
-                int n = modlist->size();
-                for (int i = 0; i < n; i++)
+        for (int scene = 0; scene < n_scenes; scene++)
+        {
+            for (const auto *modlist :
+                 {storage.modRouting.scene[scene], storage.modRouting.voice[scene]})
+            {
+                for (const auto &r : *modlist)
                 {
-                    int id = modlist->at(i).source_id;
-                    assert((id > 0) && (id < n_modsources));
-                    storage.getPatch().scene[scene].modsource_doprocess[id] = true;
+                    assert((r.source_id > 0) && (r.source_id < n_modsources));
+
+                    if (live[scene][r.source_id] || r.muted)
+                        continue;
+
+                    if (isModulationDestinationLive(
+                            scene, r.destination_id + patch.scene_start[scene], live[scene]))
+                    {
+                        live[scene][r.source_id] = true;
+                        changed = true;
+                    }
                 }
             }
         }
+
+        for (const auto &r : *storage.modRouting.global)
+        {
+            auto sc = limit_range(r.source_scene, 0, n_scenes - 1);
+
+            if (live[sc][r.source_id] || r.muted)
+                continue;
+
+            if (isModulationDestinationLive(sc, r.destination_id, live[sc]))
+            {
+                live[sc][r.source_id] = true;
+                changed = true;
+            }
+        }
+    }
+
+    for (int scene = 0; scene < n_scenes; scene++)
+    {
+        if ((1 << scene) & scenemask)
+        {
+            for (int i = 0; i < n_modsources; i++)
+                patch.scene[scene].modsource_doprocess[i] = live[scene][i];
+        }
     }
 }
 
@@ -3508,13 +4155,12 @@ void SurgeSynthesizer::applyParameterPolyphonicModulation(Parameter *p, int32_t
         }
     }
 
-    for (auto v : voices[p->scene - 1])
-    {
+    forEachVoiceCandidate(p->scene - 1, channel, key, note_id, [&](SurgeVoice *v) {
         if (v->matchesChannelKeyId(channel, key, note_id))
         {
             v->applyPolyphonicParamModulation(p, depth, underlyingMonoMod);
         }
-    }
+    });
 }
 
 void SurgeSynthesizer::clear_osc_modulation(int scene, int entry)
@@ -3728,6 +4374,7 @@ void SurgeSynthesizer::setMacroParameter01(long macroNum, float val)
     storage.getPatch().isDirty = true;
     ((ControllerModulationSource *)storage.getPatch().scene[0].modsources[ms_ctrl1 + macroNum])
         ->set_target01(val, true);
+    editorChanges.mark(EditorChangeBus::ch_controllers);
 }
 
 void SurgeSynthesizer::applyMacroMonophonicModulation(long macroNum, float val)
@@ -3777,6 +4424,29 @@ void SurgeSynthesizer::getParameterDisplay(long index, char *text, float x) cons
         snprintf(text, TXT_SIZE, "-");
 }
 
+std::string SurgeSynthesizer::getParameterDisplayCached(long index, bool external, float x)
+{
+    if ((index >= 0) && (index < storage.getPatch().param_ptr.size()))
+        return parameterDisplayCache.get(storage.getPatch().param_ptr[index], external, x);
+
+    return "-";
+}
+
+void SurgeSynthesizer::getParameterDisplaysCached(const std::vector<ID> &indices,
+                                                  std::vector<std::string> &into)
+{
+    std::vector<const Parameter *> params(indices.size(), nullptr);
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        auto index = indices[i].getSynthSideId();
+        if ((index >= 0) && (index < storage.getPatch().param_ptr.size()))
+            params[i] = storage.getPatch().param_ptr[index];
+    }
+
+    parameterDisplayCache.getAll(params, into);
+}
+
 void SurgeSynthesizer::getParameterName(long index, char *text) const
 {
     if ((index >= 0) && (index < storage.getPatch().param_ptr.size()))
@@ -3936,6 +4606,9 @@ void loadPatchInBackgroundThread(SurgeSynthesizer *sy)
             (it.second)(ppath.replace_extension());
     }
 
+    // a prefetch for a request which was replaced while it was reading is of no use now
+    synth->clearPatchPrefetch();
+
     // Now we want to null out the patchLoadThread since everything is done
     auto myThread = std::move(synth->patchLoadThread);
     myThread->detach();
@@ -3989,7 +4662,8 @@ void SurgeSynthesizer::processAudioThreadOpsWhenAudioEngineUnavailable(bool dang
 
         loadOscalgos();
 
-        storage.perform_queued_wtloads();
+        // with no audio thread to hand the result back to, load synchronously
+        storage.perform_queued_wtloads(false);
     }
 }
 
@@ -4000,6 +4674,16 @@ void SurgeSynthesizer::resetStateFromTimeData()
     if (time_data.timeSigDenominator < 1)
         time_data.timeSigDenominator = 4;
     storage.songpos = time_data.ppqPos;
+    updateTempoSyncRatio();
+}
+
+void SurgeSynthesizer::updateTempoSyncRatio()
+{
+    if (time_data.tempo == tempoSyncRatioTempo)
+        return;
+
+    tempoSyncRatioTempo = time_data.tempo;
+
     if (time_data.tempo > 0)
     {
         storage.temposyncratio = time_data.tempo / 120.f;
@@ -4012,90 +4696,238 @@ void SurgeSynthesizer::resetStateFromTimeData()
     }
 }
 
-void SurgeSynthesizer::enqueueFXOff(int whichFX)
+void SurgeSynthesizer::stageEffectForSlot(int slot, int type, bool withDefaults)
 {
-    // this can come from the UI thread. I don't think we need the spawn mutex but we might
-    std::lock_guard<std::mutex> lg(fxSpawnMutex);
-    fxsync[whichFX].type.val.i = fxt_off;
-    load_fx_needed = true;
+    if (slot < 0 || slot >= n_fx_slots)
+        return;
+
+    if (stageEffectsInline || storage.renderingOffline)
+    {
+        buildStagedEffect(slot, type, withDefaults);
+        return;
+    }
+
+    fxStageType[slot].store(type, std::memory_order_relaxed);
+    fxStageDefaults[slot].store(withDefaults, std::memory_order_relaxed);
+    fxStageRequested[slot].fetch_add(1, std::memory_order_acq_rel);
+
+    storage.backgroundService->request(fxStager);
 }
 
-void SurgeSynthesizer::processControl()
+void SurgeSynthesizer::serviceEffectStaging(void *ctx)
 {
-    processEnqueuedPatchIfNeeded();
+    auto synth = static_cast<SurgeSynthesizer *>(ctx);
 
-    storage.perform_queued_wtloads();
-    int sm = storage.getPatch().scenemode.val.i;
-    // TODO: FIX SCENE ASSUMPTION
-    bool playA = (sm == sm_split) || (sm == sm_dual) || (sm == sm_chsplit) ||
-                 (storage.getPatch().scene_active.val.i == 0);
-    bool playB = (sm == sm_split) || (sm == sm_dual) || (sm == sm_chsplit) ||
-                 (storage.getPatch().scene_active.val.i == 1);
+    for (int s = 0; s < n_fx_slots; ++s)
+    {
+        auto req = synth->fxStageRequested[s].load(std::memory_order_acquire);
 
-    storage.songpos = time_data.ppqPos;
-    storage.temposyncratio = time_data.tempo / 120.f;
-    storage.temposyncratio_inv = 1.f / storage.temposyncratio;
+        if (req == synth->fxStageServed[s].load(std::memory_order_acquire))
+            continue;
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (release_if_latched[0])
-    {
-        if (!playA || release_anyway[0])
-            releaseScene(0);
-        release_if_latched[0] = false;
-        release_anyway[0] = false;
-    }
-    if (release_if_latched[1])
-    {
-        if (!playB || release_anyway[1])
-            releaseScene(1);
-        release_if_latched[1] = false;
-        release_anyway[1] = false;
+        synth->buildStagedEffect(s, synth->fxStageType[s].load(std::memory_order_relaxed),
+                                 synth->fxStageDefaults[s].load(std::memory_order_relaxed));
+
+        // a request which came in while we built this one is still outstanding, and asked again
+        synth->fxStageServed[s].store(req, std::memory_order_release);
     }
 
-    // interpolate MIDI controllers
-    for (int i = 0; i < num_controlinterpolators; i++)
+    synth->releaseRetiredEffects();
+}
+
+void SurgeSynthesizer::buildStagedEffect(int slot, int type, bool withDefaults)
+{
+    if (withDefaults)
     {
-        if (mControlInterpolatorUsed[i])
+        std::unique_ptr<Effect> t_fx(spawn_effect(type, &storage, &fxsync[slot], 0));
+
+        if (t_fx)
         {
-            ControllerModulationSource *mc = &mControlInterpolator[i];
-            bool cont = mc->process_block_until_close(0.001f);
-            int id = mc->id;
-            storage.getPatch().param_ptr[id]->set_value_f01(mc->get_output(0));
-            if (!cont)
-            {
-                mControlInterpolatorUsed[i] = false;
-            }
+            t_fx->init_ctrltypes();
+            t_fx->init_default_values();
         }
     }
 
-    // Update keys if we are bound
-    prepareModsourceDoProcess((playA ? 1 : 0) | (playB ? 2 : 0));
+    // Build the instance outside the lock so the audio thread never waits on a constructor
+    std::unique_ptr<Effect> e;
 
-    for (int sc = 0; sc < n_scenes; ++sc)
+    if (type != fxt_off)
     {
-        if (storage.getPatch().scene[sc].modsource_doprocess[ms_highest_key] ||
-            storage.getPatch().scene[sc].modsource_doprocess[ms_lowest_key] ||
-            storage.getPatch().scene[sc].modsource_doprocess[ms_latest_key])
+        /*
+         * Prime it too, running init against a copy of the settings it is about to get (which
+         * fxsync holds by now), and only then point it at the slot. loadFx skips init for a
+         * staged effect, so it starts warm.
+         */
+        FxStorage primeStorage{fxsync[slot]};
+        std::vector<pdata> primeData(n_global_params);
+
+        e.reset(spawn_effect(type, &storage, &primeStorage, primeData.data()));
+
+        if (e)
         {
-            updateHighLowKeys(sc);
+            e->init_ctrltypes();
+
+            for (const auto &p : primeStorage.p)
+                primeData[p.id] = p.val;
+
+            e->init();
+            e->rebindStorage(&storage.getPatch().fx[slot], storage.getPatch().globaldata);
         }
     }
 
-    storage.getPatch().copy_globaldata(
-        storage.getPatch()
-            .globaldata); // Drains a great deal of CPU while in Debug mode.. optimize?
+    std::unique_ptr<Effect> replaced;
+    {
+        std::lock_guard<std::mutex> g(fxStagingMutex);
+        replaced = std::move(fxStaged[slot]);
+        fxStaged[slot] = std::move(e);
+        fxStagedType[slot] = type;
+    }
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (playA)
-        storage.getPatch().copy_scenedata(storage.getPatch().scenedata[0], 0); // -""-
-    if (playB)
-        storage.getPatch().copy_scenedata(storage.getPatch().scenedata[1], 1);
+    // and one which was never adopted dies here, as we leave, on this thread
+}
 
-    // TODO: FIX SCENE ASSUMPTION.
-    // Prior to 1.1 we could play before or after copying modulation data but as we
-    // introduce int mods, we need to make sure the scenedata and so on is set up before
-    // we latch
-    if (playA && (storage.getPatch().scene[0].polymode.val.i == pm_latch) && voices[0].empty())
+void SurgeSynthesizer::releaseRetiredEffects()
+{
+    for (auto &r : fxRetired)
+        delete r.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+int SurgeSynthesizer::retiredEffectCount() const
+{
+    int res = 0;
+
+    for (auto &r : fxRetired)
+        res += r.load(std::memory_order_acquire) != nullptr;
+
+    return res;
+}
+
+std::unique_ptr<Effect> SurgeSynthesizer::takeStagedEffect(int slot, int type)
+{
+    std::unique_lock<std::mutex> g(fxStagingMutex, std::try_to_lock);
+
+    if (!g.owns_lock() || !fxStaged[slot] || fxStagedType[slot] != type)
+        return nullptr;
+
+    return std::move(fxStaged[slot]);
+}
+
+void SurgeSynthesizer::retireEffect(int slot, std::unique_ptr<Effect> &&e)
+{
+    if (!e)
+        return;
+
+    for (auto &r : fxRetired)
+    {
+        Effect *expected = nullptr;
+
+        if (r.compare_exchange_strong(expected, e.get(), std::memory_order_acq_rel))
+        {
+            e.release();
+            storage.backgroundService->request(fxStager);
+            return;
+        }
+    }
+
+    // only if the service is a long way behind; better to free it here than leak it
+    e.reset();
+}
+
+void SurgeSynthesizer::enqueueFXOff(int whichFX)
+{
+    // this can come from the UI thread. I don't think we need the spawn mutex but we might
+    std::lock_guard<std::mutex> lg(fxSpawnMutex);
+    fxsync[whichFX].type.val.i = fxt_off;
+    load_fx_needed = true;
+}
+
+void SurgeSynthesizer::releaseModRoutingForBlock()
+{
+    if (!haveModRoutingLockThisBlock)
+        return;
+
+    storage.captureModRoutingSnapshot();
+    storage.modRoutingMutex.unlock();
+    haveModRoutingLockThisBlock = false;
+}
+
+void SurgeSynthesizer::processControl()
+{
+    SURGE_TRACE_SCOPE(traceRecorder, "processControl");
+
+    // Patch loads rewrite the routing, so they wait for a block where we hold it
+    if (haveModRoutingLockThisBlock)
+        processEnqueuedPatchIfNeeded();
+
+    storage.perform_queued_wtloads();
+    int sm = storage.getPatch().scenemode.val.i;
+    // TODO: FIX SCENE ASSUMPTION
+    bool playA = (sm == sm_split) || (sm == sm_dual) || (sm == sm_chsplit) ||
+                 (storage.getPatch().scene_active.val.i == 0);
+    bool playB = (sm == sm_split) || (sm == sm_dual) || (sm == sm_chsplit) ||
+                 (storage.getPatch().scene_active.val.i == 1);
+
+    storage.songpos = time_data.ppqPos;
+    updateTempoSyncRatio();
+
+    // TODO: FIX SCENE ASSUMPTION
+    if (release_if_latched[0])
+    {
+        if (!playA || release_anyway[0])
+            releaseScene(0);
+        release_if_latched[0] = false;
+        release_anyway[0] = false;
+    }
+    if (release_if_latched[1])
+    {
+        if (!playB || release_anyway[1])
+            releaseScene(1);
+        release_if_latched[1] = false;
+        release_anyway[1] = false;
+    }
+
+    // interpolate MIDI controllers; backwards, so a release only moves one we've already done
+    for (int a = mControlInterpolatorActiveCount - 1; a >= 0; a--)
+    {
+        int i = mControlInterpolatorActive[a];
+        ControllerModulationSource *mc = &mControlInterpolator[i];
+        bool cont = mc->process_block_until_close(0.001f);
+        int id = mc->id;
+        storage.getPatch().param_ptr[id]->set_value_f01(mc->get_output(0));
+        if (!cont)
+        {
+            releaseControlInterpolatorSlot(i);
+        }
+    }
+
+    // Update keys if we are bound
+    prepareModsourceDoProcess((playA ? 1 : 0) | (playB ? 2 : 0));
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        if (storage.getPatch().scene[sc].modsource_doprocess[ms_highest_key] ||
+            storage.getPatch().scene[sc].modsource_doprocess[ms_lowest_key] ||
+            storage.getPatch().scene[sc].modsource_doprocess[ms_latest_key])
+        {
+            updateHighLowKeys(sc);
+        }
+    }
+
+    storage.getPatch().copy_globaldata(
+        storage.getPatch()
+            .globaldata); // Drains a great deal of CPU while in Debug mode.. optimize?
+
+    // TODO: FIX SCENE ASSUMPTION
+    if (playA)
+        storage.getPatch().copy_scenedata(storage.getPatch().scenedata[0], 0); // -""-
+    if (playB)
+        storage.getPatch().copy_scenedata(storage.getPatch().scenedata[1], 1);
+
+    // TODO: FIX SCENE ASSUMPTION.
+    // Prior to 1.1 we could play before or after copying modulation data but as we
+    // introduce int mods, we need to make sure the scenedata and so on is set up before
+    // we latch
+    if (playA && (storage.getPatch().scene[0].polymode.val.i == pm_latch) && voices[0].empty())
         playNote(1, 60, 100, 0, -1, 0);
     if (playB && (storage.getPatch().scene[1].polymode.val.i == pm_latch) && voices[1].empty())
         playNote(2, 60, 100, 0, -1, 1);
@@ -4138,24 +4970,30 @@ void SurgeSynthesizer::processControl()
             // for(int i=0; i<n_lfos_scene; i++)
             // storage.getPatch().scene[s].modsources[ms_slfo1+i]->process_block();
 
-            int n = storage.getPatch().scene[s].modulation_scene.size();
+            auto &sceneRouting = *storage.modRouting.scene[s];
+            int n = sceneRouting.size();
             for (int i = 0; i < n; i++)
             {
-                int src_id = storage.getPatch().scene[s].modulation_scene[i].source_id;
-                int src_index = storage.getPatch().scene[s].modulation_scene[i].source_index;
+                int src_id = sceneRouting[i].source_id;
+                int src_index = sceneRouting[i].source_index;
                 if (storage.getPatch().scene[s].modsources[src_id])
                 {
-                    int dst_id = storage.getPatch().scene[s].modulation_scene[i].destination_id;
-                    float depth = storage.getPatch().scene[s].modulation_scene[i].depth;
+                    int dst_id = sceneRouting[i].destination_id;
+                    float depth = sceneRouting[i].depth;
                     storage.getPatch().scenedata[s][dst_id].f +=
                         depth *
                         storage.getPatch().scene[s].modsources[src_id]->get_output(src_index) *
-                        (1.0 - storage.getPatch().scene[s].modulation_scene[i].muted);
+                        (1.0 - sceneRouting[i].muted);
                 }
             }
 
+            storage.getPatch().diff_scenedata(s);
+
             for (int i = 0; i < n_lfos_scene; i++)
             {
+                if (!storage.getPatch().scene[s].modsource_doprocess[ms_slfo1 + i])
+                    continue;
+
                 if (storage.getPatch().scene[s].lfo[n_lfos_voice + i].shape.val.i == lt_formula)
                 {
                     auto lms = dynamic_cast<LFOModulationSource *>(
@@ -4173,16 +5011,17 @@ void SurgeSynthesizer::processControl()
 
     loadOscalgos();
 
-    int n = storage.getPatch().modulation_global.size();
+    auto &globalRouting = *storage.modRouting.global;
+    int n = globalRouting.size();
     for (int i = 0; i < n; i++)
     {
-        int src_id = storage.getPatch().modulation_global[i].source_id;
-        int dst_id = storage.getPatch().modulation_global[i].destination_id;
-        float depth = storage.getPatch().modulation_global[i].depth;
-        int source_scene = storage.getPatch().modulation_global[i].source_scene;
+        int src_id = globalRouting[i].source_id;
+        int dst_id = globalRouting[i].destination_id;
+        float depth = globalRouting[i].depth;
+        int source_scene = globalRouting[i].source_scene;
         storage.getPatch().globaldata[dst_id].f +=
             depth * storage.getPatch().scene[source_scene].modsources[src_id]->get_output(0) *
-            (1 - storage.getPatch().modulation_global[i].muted);
+            (1 - globalRouting[i].muted);
     }
 
     if (switch_toggled_queued)
@@ -4191,7 +5030,8 @@ void SurgeSynthesizer::processControl()
         switch_toggled_queued = false;
     }
 
-    if (load_fx_needed)
+    // as does an FX change, which clears the modulation onto the old FX
+    if (load_fx_needed && haveModRoutingLockThisBlock)
         loadFx(false, false);
 
     if (fx_suspend_bitmask)
@@ -4240,6 +5080,35 @@ void SurgeSynthesizer::processControl()
 #endif
 }
 
+void SurgeSynthesizer::updateHalfbandProfile()
+{
+    auto profile = storage.activeHalfbandProfile();
+
+    if (profile == halfbandProfileInUse)
+        return;
+
+    int order = 6;
+    bool steep = true;
+
+    switch (profile)
+    {
+    case SurgeStorage::HALFBAND_LOW_CPU:
+        order = 4;
+        break;
+    case SurgeStorage::HALFBAND_HIGH:
+        steep = false;
+        break;
+    default:
+        break;
+    }
+
+    // a fresh filter starts from silence, which is also what switching profile should do
+    halfbandA = sst::filters::HalfRate::HalfRateFilter(order, steep);
+    halfbandB = sst::filters::HalfRate::HalfRateFilter(order, steep);
+    halfbandIN = sst::filters::HalfRate::HalfRateFilter(order, steep);
+    halfbandProfileInUse = profile;
+}
+
 void SurgeSynthesizer::process()
 {
 #if DEBUG_RNG_THREADING
@@ -4248,11 +5117,35 @@ void SurgeSynthesizer::process()
     processRunning = 0;
 
 #if DEBUG
-    memset(endedHostNoteIds, 0, 512 * sizeof(int32_t));
+    std::fill(endedHostNoteIds.begin(), endedHostNoteIds.end(), 0);
 #endif
 
+    /*
+     * Hosts usually give us flush-to-zero already, but surgepy, the CLI and the test runner
+     * call straight in here, so set it up ourselves rather than rely on every caller to.
+     */
+    auto fpuguard = sst::plugininfra::cpufeatures::FPUStateGuard();
+    SURGE_TRACE_SCOPE(traceRecorder, "process");
+    SURGE_REALTIME_SCOPE;
+
+    // the host's events for this block have all been applied by now
+    flushNoteOns();
+    eventOffsetInBlock = 0;
+    storage.beginMTSBlock();
+    Surge::Formula::beginAudioBlock(&storage);
+    updateHalfbandProfile();
+
     auto process_start = std::chrono::high_resolution_clock::now();
 
+    bool profiling = blockProfiler.isEnabled();
+    uint64_t profileStart = 0;
+
+    if (profiling)
+    {
+        blockProfiler.beginBlock();
+        profileStart = Surge::Profiling::BlockProfiler::now();
+    }
+
     if (hostNoteEndedToPushToNextBlock)
     {
         for (int i = 0; i < hostNoteEndedToPushToNextBlock; ++i)
@@ -4272,13 +5165,18 @@ void SurgeSynthesizer::process()
 
     float mfade = 1.f;
 
+    // the whole first block after a patch load, so don't take it while the load still runs
+    Surge::Profiling::PatchLoadProfile::Scope firstBlockAfterLoad(
+        storage.patchLoadProfile, Surge::Profiling::PatchLoadProfile::lp_firstBlock,
+        !halt_engine && storage.patchLoadProfile.takeFirstBlock());
+
     if (halt_engine)
     {
         mech::clear_block<BLOCK_SIZE>(output[0]);
         mech::clear_block<BLOCK_SIZE>(output[1]);
         return;
     }
-    else if (patchid_queue >= 0 || has_patchid_file)
+    else if ((patchid_queue >= 0 || has_patchid_file) && queuedPatchIsPrefetched())
     {
         masterfade = max(0.f, masterfade - 0.05f);
         mfade = masterfade * masterfade;
@@ -4319,9 +5217,14 @@ void SurgeSynthesizer::process()
         }
     }
 
-    // process inputs (upsample & halfrate)
-    if (process_input)
+    // process inputs (upsample & halfrate), if anything in the patch is going to read them
+    if (process_input && storage.audio_in_clients > 0)
     {
+        // the filter has been idle, so don't let it ring out whatever it last saw
+        if (!audioInputLive)
+            halfbandIN.reset();
+        audioInputLive = true;
+
         sdsp::hardclip_block8<BLOCK_SIZE>(input[0]);
         sdsp::hardclip_block8<BLOCK_SIZE>(input[1]);
         mech::copy_from_to<BLOCK_SIZE>(input[0], storage.audio_in_nonOS[0]);
@@ -4329,12 +5232,13 @@ void SurgeSynthesizer::process()
         halfbandIN.process_block_U2(input[0], input[1], storage.audio_in[0], storage.audio_in[1],
                                     BLOCK_SIZE_OS);
     }
-    else
+    else if (audioInputLive)
     {
         mech::clear_block<BLOCK_SIZE_OS>(storage.audio_in[0]);
         mech::clear_block<BLOCK_SIZE_OS>(storage.audio_in[1]);
+        mech::clear_block<BLOCK_SIZE>(storage.audio_in_nonOS[0]);
         mech::clear_block<BLOCK_SIZE>(storage.audio_in_nonOS[1]);
-        mech::clear_block<BLOCK_SIZE>(storage.audio_in_nonOS[1]);
+        audioInputLive = false;
     }
 
     // TODO: FIX SCENE ASSUMPTION
@@ -4354,8 +5258,15 @@ void SurgeSynthesizer::process()
         }
     }
 
-    storage.modRoutingMutex.lock();
-    processControl();
+    // Never wait on the UI thread here. If it is editing the routing, render from the snapshot
+    haveModRoutingLockThisBlock = storage.modRoutingMutex.try_lock();
+    storage.selectModRouting(!haveModRoutingLockThisBlock);
+
+    {
+        Surge::Profiling::BlockProfiler::Scope t(blockProfiler, Surge::Profiling::ps_modulation);
+        processControl();
+        storage.compileVoiceRouting();
+    }
 
     amp.set_target_smoothed(
         storage.db_to_linear(storage.getPatch().globaldata[storage.getPatch().volume.id].f));
@@ -4374,8 +5285,12 @@ void SurgeSynthesizer::process()
             auto idx = si[1];
             if (fx[slot])
             {
-                FX[idx].set_target_smoothed(amp_to_linear(
-                    storage.getPatch().globaldata[storage.getPatch().fx[slot].return_level.id].f));
+                FX[idx].set_target_smoothed(
+                    amp_to_linear(
+                        storage.getPatch()
+                            .globaldata[storage.getPatch().fx[slot].return_level.id]
+                            .f) *
+                    fxBudget.sendFade[idx]);
                 send[idx][0].set_target_smoothed(amp_to_linear(
                     storage.getPatch()
                         .scenedata[0][storage.getPatch().scene[0].send_level[idx].param_id_in_scene]
@@ -4388,353 +5303,1701 @@ void SurgeSynthesizer::process()
         }
     }
 
-    list<SurgeVoice *>::iterator iter;
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        play_scene[sc] = (!voices[sc].empty());
+        sceneRenderState[sc].play = play_scene[sc];
+    }
+
+    int vcount = 0;
+
+    if (canRenderScenesInParallel())
+    {
+        // The scenes share nothing until the insert FX, so render them side by side and retire
+        // finished voices (which touches cross-scene state) once both are done.
+        sceneRenderPool->runAll(n_scenes, renderSceneJob, this);
+        releaseModRoutingForBlock();
+
+        for (int s = 0; s < n_scenes; s++)
+        {
+            vcount += sceneRenderState[s].FBentry + sceneRenderState[s].cachedVoices;
+            retireFinishedVoices(s);
+        }
+    }
+    else
+    {
+        renderVoicesOfAllScenes();
+
+        for (int s = 0; s < n_scenes; s++)
+        {
+            // the same generators renderSceneJob uses, so a seeded render doesn't depend on
+            // which of the two paths ran
+            SurgeStorage::ScopedRNGOverride rng(s > 0 ? &sceneRenderState[s].rng : nullptr);
+
+            renderScene(s);
+            vcount += sceneRenderState[s].FBentry + sceneRenderState[s].cachedVoices;
+            retireFinishedVoices(s);
+        }
+
+        releaseModRoutingForBlock();
+    }
+
+    if (polydisplay.exchange(vcount) != vcount)
+        editorChanges.mark(EditorChangeBus::ch_voices);
+
+    for (int cls = 0; cls < n_scenes; ++cls)
+    {
+        hardclipScene<BLOCK_SIZE>(storage.sceneHardclipMode[cls], sceneout[cls][0],
+                                  sceneout[cls][1]);
+    }
+
+    // TODO: FIX SCENE ASSUMPTION
+    bool sc_state[n_scenes];
+
+    for (int i = 0; i < n_scenes; i++)
+    {
+        sc_state[i] = play_scene[i];
+    }
+
+    for (int i = 0; i < n_scenes; i++)
+        for (int channel = 0; channel < N_OUTPUTS; channel++)
+            storage.scenesOutputData.provideSceneView(i, channel, sceneout[i][channel]);
+
+    // apply insert effects
+    if (fx_bypass != fxb_no_fx)
+    {
+        bool insertsActive[n_scenes];
+
+        for (int s = 0; s < n_scenes; s++)
+            insertsActive[s] = sceneHasActiveInserts(s);
+
+        if (fxRenderPool && insertsActive[0] && insertsActive[1])
+        {
+            /*
+             * Each scene's inserts can listen to the other scene, which the other chain is
+             * changing in place at the same time, so both listen to a copy taken before either
+             * chain starts. That is exactly what the serial order below hands them.
+             */
+            for (int s = 0; s < n_scenes; s++)
+            {
+                storage.scenesOutputData.snapshotSceneData(s);
+                fxRenderState.sceneState[s] = sc_state[s];
+            }
+
+            fxRenderPool->runAll(n_scenes, renderInsertChainJob, this);
+
+            for (int s = 0; s < n_scenes; s++)
+                sc_state[s] = fxRenderState.sceneState[s];
+        }
+        else
+        {
+            /*
+             * Scene B's inserts can listen to scene A, and run after scene A's inserts have
+             * changed sceneout[0] in place, so keep a copy of A for them if they need it.
+             * Scene A's inserts listen to B before anything touches it, so B is never copied.
+             */
+            if (insertsActive[0])
+                storage.scenesOutputData.snapshotSceneData(0);
+
+            for (int s = 0; s < n_scenes; s++)
+            {
+                // as renderInsertChainJob does
+                SurgeStorage::ScopedRNGOverride rng(s > 0 ? &fxRenderState.rng[s] : nullptr);
+
+                sc_state[s] = processInsertChain(s, sc_state[s]);
+            }
+        }
+    }
+
+    for (int cls = 0; cls < n_scenes; ++cls)
+    {
+        switch (storage.sceneHardclipMode[cls])
+        {
+        case SurgeStorage::HARDCLIP_TO_18DBFS:
+            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][0]);
+            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][1]);
+            break;
+        case SurgeStorage::HARDCLIP_TO_0DBFS:
+            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][0]);
+            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][1]);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // sum scenes
+    // TODO: FIX SCENE ASSUMPTION
+    mech::copy_from_to<BLOCK_SIZE>(sceneout[0][0], output[0]);
+    mech::copy_from_to<BLOCK_SIZE>(sceneout[0][1], output[1]);
+    mech::accumulate_from_to<BLOCK_SIZE>(sceneout[1][0], output[0]);
+    mech::accumulate_from_to<BLOCK_SIZE>(sceneout[1][1], output[1]);
+
+    bool sendused[4] = {false, false, false, false};
+    // add send effects
+    // TODO: FIX SCENE ASSUMPTION
+    if (fx_bypass == fxb_all_fx)
+    {
+        auto &fs = fxRenderState;
+        fs.nSends = 0;
+        fs.sendout = fxsendout;
+        fs.sceneState[0] = sc_state[0];
+        fs.sceneState[1] = sc_state[1];
+
+        for (auto si : sendToIndex)
+        {
+            auto slot = si[0];
+            auto idx = si[1];
+
+            if (fx[slot] && !(storage.getPatch().fx_disable.val.i & (1 << slot)) &&
+                sendProcessingAllowedByFXBudget(idx))
+            {
+                fs.sendIdx[fs.nSends] = idx;
+                fs.sendSlot[fs.nSends] = slot;
+                fs.nSends++;
+            }
+        }
+
+        // the sends only read the scenes, so they can run side by side once the inserts are done
+        if (fxRenderPool && fs.nSends > 1)
+        {
+            fxRenderPool->runAll(fs.nSends, renderSendJob, this);
+        }
+        else
+        {
+            for (int i = 0; i < fs.nSends; ++i)
+                renderSendJob(this, i);
+        }
+
+        // the returns are summed here, in slot order, so the output doesn't depend on the pool
+        for (int i = 0; i < fs.nSends; ++i)
+        {
+            auto idx = fs.sendIdx[i];
+
+            sendused[idx] = fs.sendUsed[i];
+            FX[idx].MAC_2_blocks_to(fxsendout[idx][0], fxsendout[idx][1], output[0], output[1],
+                                    BLOCK_SIZE_QUAD);
+        }
+    }
+
+    // apply global effects
+    if ((fx_bypass == fxb_all_fx) || (fx_bypass == fxb_no_sends))
+    {
+        bool glob = sc_state[0] || sc_state[1];
+        for (int i = 0; i < n_send_slots; ++i)
+            glob = glob || sendused[i];
+
+        for (auto v : {fxslot_global1, fxslot_global2, fxslot_global3, fxslot_global4})
+        {
+            if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
+            {
+                Surge::Profiling::BlockProfiler::Scope t(blockProfiler,
+                                                         Surge::Profiling::ps_fx_first + v);
+                SURGE_TRACE_SCOPE(traceRecorder, fxslot_shortnames[v], v);
+                glob = processFXSlot(v, output[0], output[1], glob);
+
+                if (denormalCounterEnabled)
+                    countDenormals(v, output[0], output[1]);
+            }
+        }
+    }
+
+    // the output stage runs to the end of the block, just before the CPU meter
+    auto outputStart = profiling ? Surge::Profiling::BlockProfiler::now() : 0;
+
+    amp.multiply_2_blocks(output[0], output[1], BLOCK_SIZE_QUAD);
+    amp_mute.multiply_2_blocks(output[0], output[1], BLOCK_SIZE_QUAD);
+
+    // VU falloff
+    float a = storage.vu_falloff;
+    vu_peak[0] = min(2.f, a * vu_peak[0]);
+    vu_peak[1] = min(2.f, a * vu_peak[1]);
+    vu_peak[0] = max(vu_peak[0], mech::blockAbsMax<BLOCK_SIZE>(output[0]));
+    vu_peak[1] = max(vu_peak[1], mech::blockAbsMax<BLOCK_SIZE>(output[1]));
+
+    // until the meters have fallen to nothing there is something for the editor to draw
+    if (vu_peak[0] + vu_peak[1] > 1e-6f)
+        editorChanges.mark(EditorChangeBus::ch_meters);
+
+    switch (storage.hardclipMode)
+    {
+    case SurgeStorage::HARDCLIP_TO_18DBFS:
+        sdsp::hardclip_block8<BLOCK_SIZE>(output[0]);
+        sdsp::hardclip_block8<BLOCK_SIZE>(output[1]);
+        break;
+
+    case SurgeStorage::HARDCLIP_TO_0DBFS:
+        sdsp::hardclip_block<BLOCK_SIZE>(output[0]);
+        sdsp::hardclip_block<BLOCK_SIZE>(output[1]);
+        break;
+    case SurgeStorage::BYPASS_HARDCLIP:
+        break;
+    }
+
+    // Send output to the oscilloscope, if anyone is listening.
+    if (storage.audioOut.subscribed())
+    {
+        if (storage.audioOutTap.decimation.load(std::memory_order_relaxed) > 1)
+        {
+            float tapL[BLOCK_SIZE + 2], tapR[BLOCK_SIZE + 2];
+            auto n = storage.audioOutTap.process(output[0], output[1], BLOCK_SIZE, tapL, tapR);
+
+            if (n > 0)
+            {
+                storage.audioOut.push(tapL, tapR, n);
+            }
+        }
+        else
+        {
+            storage.audioOut.push(output[0], output[1], BLOCK_SIZE);
+        }
+    }
+
+    // since the sceneout is now routable we also need to mute it
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        amp_mute.multiply_2_blocks(sceneout[sc][0], sceneout[sc][1], BLOCK_SIZE_QUAD);
+    }
+
+    // Calculate how close we are to overloading the CPU
+    // (how close is the process() duration to duration)
+    auto process_end = std::chrono::high_resolution_clock::now();
+    auto duration_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(process_end - process_start);
+    auto max_duration_usec = BLOCK_SIZE * storage.dsamplerate_inv * 1000000;
+    float ratio = duration_usec.count() / max_duration_usec;
+    float c = cpu_level.load();
+    int window = max_duration_usec;
+    auto smoothed_ratio = (c * (window - 1) + ratio) / window;
+    c = c * storage.cpu_falloff;
+    cpu_level.store(max(c, smoothed_ratio));
+
+    updateFXBudget();
+    updatePolyphonyGovernor();
+
+    if (profiling)
+    {
+        auto profileEnd = Surge::Profiling::BlockProfiler::now();
+        blockProfiler.add(Surge::Profiling::ps_output, profileEnd - outputStart);
+        blockProfiler.endBlock(profileEnd - profileStart, duration_usec.count() * 1e-6,
+                               BLOCK_SIZE * storage.dsamplerate_inv);
+    }
+
+    checkDeadline(ratio);
+}
+
+void SurgeSynthesizer::checkDeadline(float load)
+{
+    auto block = blocksProcessed++;
+    auto events = storage.blockEvents.exchange(0, std::memory_order_relaxed);
+
+    // an offline render has no deadline to miss
+    if (storage.renderingOffline || !deadlineMonitor.isLate(load))
+        return;
+
+    Surge::Profiling::DeadlineMiss miss;
+    miss.block = block;
+    miss.when = std::chrono::system_clock::now();
+    miss.load = load;
+    miss.events = events;
+
+    for (int s = 0; s < n_scenes; ++s)
+        miss.voices += voices[s].size();
+
+    for (int i = 0; i < n_fx_slots; ++i)
+        miss.fxTypes[i] = fx[i] ? storage.getPatch().fx[i].type.val.i : fxt_off;
+
+    if (blockProfiler.isEnabled())
+    {
+        miss.topSection = blockProfiler.getLastBlockTopSection();
+        miss.topLoad = blockProfiler.getLastBlockTopLoad();
+    }
+
+    deadlineMonitor.report(miss);
+}
+
+Surge::Profiling::MemoryFootprint SurgeSynthesizer::getMemoryFootprint()
+{
+    Surge::Profiling::MemoryFootprint res;
+
+    auto capacity = voiceCapacity();
+    res.add("voices", n_scenes * capacity * sizeof(SurgeVoice),
+            fmt::format("{} x {} voices, with their oscillators", n_scenes, capacity));
+    res.add("voice filters", n_scenes * (capacity >> 2) * sizeof(QuadFilterChainState),
+            fmt::format("{} x {} quad filter chains", n_scenes, capacity >> 2));
+
+    size_t fxBytes = 0;
+    int fxCount = 0;
+    {
+        std::lock_guard<std::mutex> g(fxSpawnMutex);
+        for (const auto &e : fx)
+            if (e)
+            {
+                fxBytes += e->getInstanceBytes();
+                fxCount++;
+            }
+    }
+    {
+        std::lock_guard<std::mutex> g(fxStagingMutex);
+        for (int s = 0; s < n_fx_slots; ++s)
+            if (fxStaged[s])
+            {
+                fxBytes += fxStaged[s]->getInstanceBytes();
+                fxCount++;
+            }
+    }
+    res.add("effects", fxBytes,
+            fmt::format("{} instances, not counting buffers they allocate themselves", fxCount));
+
+    res.add("patch", sizeof(SurgePatch), "scenes, FX settings and modulator storage");
+
+    size_t ownTables = 0, sharedTables = 0;
+    {
+        std::lock_guard<std::mutex> g(storage.waveTableDataMutex);
+        for (const auto &sc : storage.getPatch().scene)
+            for (const auto &o : sc.osc)
+                (o.wt.hasSharedTables() ? sharedTables : ownTables) += o.wt.dataBytes();
+    }
+    res.add("wavetables", ownTables, "oscillator tables held by this engine alone");
+    res.add("shared wavetables", sharedTables, "oscillator tables built once for the process",
+            true);
+
+    if (storage.memoryPools)
+        res.add("memory pools",
+                sizeof(Surge::Memory::SurgeMemoryPools) + storage.memoryPools->allocatedBytes(),
+                "string delay lines and twist engines, pooled or in use");
+
+    res.add("storage", sizeof(SurgeStorage), "lookup tables, tuning, clipboards and the like");
+    if (storage.sincTableProvider)
+        res.add("sinc tables", sizeof(*storage.sincTableProvider),
+                "interpolation tables for every instance", true);
+
+    res.add("engine", sizeof(SurgeSynthesizer) - sizeof(SurgeStorage),
+            "scene and FX buffers, routing and voice bookkeeping");
+
+    return res;
+}
+
+// how long the FX budget waits between steps, and how long a send takes to fade in or out
+static constexpr float fxBudgetHoldoffSeconds = 0.25f;
+static constexpr float fxBudgetFadeSeconds = 0.05f;
+// once faded out, let the return smoothing land on zero before we stop processing the send
+static constexpr int fxBudgetSettleBlocks = 16;
+// reduced quality is the first rung, then one rung per send
+static constexpr int fxBudgetMaxDegradeLevel = 1 + n_send_slots;
+
+void SurgeSynthesizer::setFXBudgetEnabled(bool b)
+{
+    fxBudget.enabled = b;
+    fxBudget.blocksSinceChange = 0;
+}
+
+void SurgeSynthesizer::setFXBudgetWaterMarks(float low, float high)
+{
+    fxBudget.lowWater = std::min(low, high);
+    fxBudget.highWater = std::max(low, high);
+}
+
+bool SurgeSynthesizer::sendProcessingAllowedByFXBudget(int send) const
+{
+    return fxBudget.sendFade[send] > 0.f || fxBudget.sendBlocksAtZero[send] < fxBudgetSettleBlocks;
+}
+
+void SurgeSynthesizer::updateFXBudget()
+{
+    auto &b = fxBudget;
+
+    // an offline render has no deadline to protect
+    if (b.enabled && !storage.useHighestQuality())
+    {
+        auto holdoff = (int)(storage.samplerate * fxBudgetHoldoffSeconds) / BLOCK_SIZE;
+        auto load = cpu_level.load();
+
+        if (++b.blocksSinceChange >= holdoff)
+        {
+            if (load > b.highWater && b.degradeLevel < fxBudgetMaxDegradeLevel)
+            {
+                b.degradeLevel++;
+                b.blocksSinceChange = 0;
+            }
+            else if (load < b.lowWater && b.degradeLevel > 0)
+            {
+                b.degradeLevel--;
+                b.blocksSinceChange = 0;
+            }
+        }
+    }
+    else
+    {
+        b.degradeLevel = 0;
+    }
+
+    for (auto &f : fx)
+    {
+        if (f && f->supportsReducedQuality())
+            f->setReducedQuality(b.degradeLevel >= 1);
+    }
+
+    int sendSlots[n_send_slots] = {fxslot_send1, fxslot_send2, fxslot_send3, fxslot_send4};
+    auto fadeStep = std::min(1.f, BLOCK_SIZE / (storage.samplerate * fxBudgetFadeSeconds));
+
+    for (int i = 0; i < n_send_slots; ++i)
+    {
+        // the last send goes first
+        bool bypass = b.degradeLevel >= 2 + (n_send_slots - 1 - i);
+
+        if (bypass)
+            b.sendFade[i] = std::max(0.f, b.sendFade[i] - fadeStep);
+        else
+            b.sendFade[i] = std::min(1.f, b.sendFade[i] + fadeStep);
+
+        if (b.sendFade[i] > 0.f)
+        {
+            b.sendBlocksAtZero[i] = 0;
+        }
+        else if (b.sendBlocksAtZero[i] < fxBudgetSettleBlocks)
+        {
+            // clear the tail now, so the effect comes back clean when it fades back in
+            if (++b.sendBlocksAtZero[i] == fxBudgetSettleBlocks && fx[sendSlots[i]])
+                fx[sendSlots[i]]->suspend();
+        }
+    }
+}
+
+// the governor reacts quickly to overload but is slow to give voices back
+static constexpr float polyGovernorLowerHoldoffSeconds = 0.1f;
+static constexpr float polyGovernorRaiseHoldoffSeconds = 1.f;
+static constexpr int polyGovernorMinimumVoices = 4;
+
+void SurgeSynthesizer::resetDenormalCounts()
+{
+    for (auto &c : denormalCount)
+        c.store(0, std::memory_order_relaxed);
+}
+
+void SurgeSynthesizer::countDenormals(int slot, const float *L, const float *R)
+{
+    uint64_t ct = 0;
+
+    for (auto *d : {L, R})
+    {
+        for (int i = 0; i < BLOCK_SIZE; ++i)
+        {
+            auto bits = std::bit_cast<uint32_t>(d[i]);
+
+            // zero exponent, nonzero mantissa
+            ct += ((bits & 0x7F800000) == 0) && ((bits & 0x007FFFFF) != 0);
+        }
+    }
+
+    if (ct)
+        denormalCount[slot].fetch_add(ct, std::memory_order_relaxed);
+}
+
+void SurgeSynthesizer::setPolyphonyGovernorEnabled(bool b)
+{
+    polyGovernor.enabled = b;
+    polyGovernor.limit = voiceCapacity();
+    polyGovernor.blocksSinceChange = 0;
+}
+
+void SurgeSynthesizer::setPolyphonyGovernorWaterMarks(float low, float high)
+{
+    polyGovernor.lowWater = std::min(low, high);
+    polyGovernor.highWater = std::max(low, high);
+}
+
+int SurgeSynthesizer::getEffectivePolyphonyLimit() const
+{
+    // patches may ask for more voices than this engine was built with
+    auto pl = std::min(storage.getPatch().polylimit.val.i, voiceCapacity());
+
+    if (!polyGovernor.enabled)
+        return pl;
+
+    return std::min(pl, polyGovernor.limit);
+}
+
+bool SurgeSynthesizer::softkillQuietestReleasedVoice(int s)
+{
+    SurgeVoice *quietest = nullptr;
+    float quietestLevel = 0.f;
+
+    for (auto v : voices[s])
+    {
+        if (v->state.gate || v->state.uberrelease)
+            continue;
+
+        auto level = v->getAmpEnvelopeLevel();
+
+        if (!quietest || level < quietestLevel)
+        {
+            quietest = v;
+            quietestLevel = level;
+        }
+    }
+
+    if (!quietest)
+        return false;
+
+    quietest->uber_release();
+    return true;
+}
+
+void SurgeSynthesizer::updatePolyphonyGovernor()
+{
+    auto &g = polyGovernor;
+
+    if (!g.enabled)
+        return;
+
+    if (storage.useHighestQuality())
+    {
+        g.limit = voiceCapacity();
+        g.blocksSinceChange = 0;
+        return;
+    }
+
+    auto pl = std::min(storage.getPatch().polylimit.val.i, voiceCapacity());
+    auto load = cpu_level.load();
+    g.blocksSinceChange++;
+
+    if (load > g.highWater &&
+        g.blocksSinceChange >= (int)(storage.samplerate * polyGovernorLowerHoldoffSeconds) / BLOCK_SIZE)
+    {
+        int playing = 0;
+        for (int s = 0; s < n_scenes; ++s)
+            playing = std::max(playing, getNonUltrareleaseVoices(s));
+
+        // start from what is actually sounding, so the first step bites
+        auto from = std::min({g.limit, pl, playing});
+        auto to = std::max(polyGovernorMinimumVoices, from - std::max(1, from / 8));
+
+        if (to < g.limit)
+        {
+            g.limit = to;
+            g.blocksSinceChange = 0;
+        }
+    }
+    else if (load < g.lowWater && g.limit < voiceCapacity() &&
+             g.blocksSinceChange >=
+                 (int)(storage.samplerate * polyGovernorRaiseHoldoffSeconds) / BLOCK_SIZE)
+    {
+        g.limit = std::min(voiceCapacity(), g.limit + std::max(1, g.limit / 8));
+
+        // once we are back to the patch's own limit the governor is out of the way
+        if (g.limit >= pl)
+            g.limit = voiceCapacity();
+
+        g.blocksSinceChange = 0;
+    }
+
+    if (g.limit >= pl)
+        return;
+
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        int excess = getNonUltrareleaseVoices(s) - g.limit;
+
+        while (excess-- > 0 && softkillQuietestReleasedVoice(s))
+        {
+        }
+    }
+}
+
+void SurgeSynthesizer::renderSceneVoices(int s, bool allowParallelVoices)
+{
+    auto &rs = sceneRenderState[s];
+    rs.FBentry = 0;
+    rs.cachedVoices = 0;
+
+    if (noteRenderCache)
+        assignNoteCacheLanes(s);
+
+    if (allowParallelVoices && canRenderVoicesInParallel(s))
+    {
+        nVoiceGroupJobs = 0;
+        queueVoiceGroups(s);
+        voiceRenderPool->runAll(nVoiceGroupJobs, renderVoiceGroupJob, this);
+    }
+    else
+    {
+        if (sceneUsesFormulaModulators(s))
+        {
+            formulaShares[s].clear();
+
+            for (auto v : voices[s])
+                v->formulaShare = &formulaShares[s];
+
+            processBlockFormulaLFOs(s);
+        }
+
+        SURGE_TRACE_SCOPE(traceRecorder, "voices", s);
+
+        // voiceEnded follows the voice list and FBentry the lanes, which only live voices use
+        int vi = 0;
+
+        for (auto v : voices[s])
+        {
+            assert(v);
+
+            if (v->noteCacheRole == SurgeVoice::nc_live)
+            {
+                rs.voiceEnded[vi] = !v->process_block(FBQ[s][rs.FBentry >> 2], rs.FBentry & 3);
+                rs.FBentry++;
+            }
+            else
+            {
+                rs.voiceEnded[vi] = !renderNoteCacheVoice(s, v);
+                rs.cachedVoices++;
+            }
+
+            vi++;
+        }
+    }
+}
+
+void SurgeSynthesizer::renderScene(int s, bool allowParallelVoices)
+{
+    SURGE_TRACE_SCOPE(traceRecorder, "scene", s);
+    auto &rs = sceneRenderState[s];
+
+    // each section is closed as the next one opens
+    std::optional<Surge::Profiling::BlockProfiler::Scope> profiledSection;
+
+    if (rs.voicesRendered)
+    {
+        rs.voicesRendered = false;
+    }
+    else
+    {
+        profiledSection.emplace(blockProfiler, Surge::Profiling::ps_voices);
+        renderSceneVoices(s, allowParallelVoices);
+    }
+
+    auto &scene = storage.getPatch().scene[s];
+    ResolvedFilterChain::Settings fcs;
+    fcs.fu1Type = scene.filterunit[0].type.val.i;
+    fcs.fu1Subtype = scene.filterunit[0].subtype.val.i;
+    fcs.fu1Off = scene.filterunit[0].type.deactivated;
+    fcs.fu2Type = scene.filterunit[1].type.val.i;
+    fcs.fu2Subtype = scene.filterunit[1].subtype.val.i;
+    fcs.fu2Off = scene.filterunit[1].type.deactivated;
+    fcs.wsType = scene.wsunit.type.val.i;
+    fcs.wsOff = scene.wsunit.type.deactivated;
+    fcs.wsEvaluation = storage.sceneWaveshaperEvaluation[s];
+    fcs.blockConfig = scene.filterblock_configuration.val.i;
+
+    auto &chain = resolvedFilterChain[s];
+    chain.update(fcs);
+    auto &g = chain.g;
+    FBQFPtr ProcessQuadFB = chain.process;
+
+    profiledSection.emplace(blockProfiler, Surge::Profiling::ps_filters);
+
+    for (int e = 0; e < rs.FBentry; e += 4)
+    {
+        int units = rs.FBentry - e;
+        for (int i = units; i < 4; i++)
+        {
+            FBQ[s][e >> 2].FU[0].active[i] = 0;
+            FBQ[s][e >> 2].FU[1].active[i] = 0;
+            FBQ[s][e >> 2].FU[2].active[i] = 0;
+            FBQ[s][e >> 2].FU[3].active[i] = 0;
+        }
+        ProcessQuadFB(FBQ[s][e >> 2], g, sceneout[s][0], sceneout[s][1]);
+    }
+
+    for (auto v : voices[s])
+    {
+        if (v->noteCacheRole != SurgeVoice::nc_recording)
+            continue;
+
+        // the recorder quads only ever use their first lane
+        auto &q = noteRenderCache->recorderQuad(s, v->noteCacheRecorder);
+        float recorded alignas(16)[2][BLOCK_SIZE_OS]{};
+
+        ProcessQuadFB(q, g, recorded[0], recorded[1]);
+        noteRenderCache->record(s, v->noteCacheRecorder, recorded[0], recorded[1]);
+        mech::accumulate_from_to<BLOCK_SIZE_OS>(recorded[0], sceneout[s][0]);
+        mech::accumulate_from_to<BLOCK_SIZE_OS>(recorded[1], sceneout[s][1]);
+    }
+
+    if (s == 0 && storage.otherscene_clients > 0)
+    {
+        // Make available for scene B
+        mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][0], storage.audio_otherscene[0]);
+        mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][1], storage.audio_otherscene[1]);
+    }
+
+    int vi = 0;
+    for (auto v : voices[s])
+    {
+        // save filter state in voices after quad processing is done
+        if (!rs.voiceEnded[vi++] && v->noteCacheRole != SurgeVoice::nc_replaying)
+            v->GetQFB();
+    }
+
+    // mute scene
+    if (storage.getPatch().scene[s].volume.deactivated)
+    {
+        mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][0]);
+        mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][1]);
+    }
+
+    profiledSection.emplace(blockProfiler, Surge::Profiling::ps_halfband);
+
+    // TODO: FIX SCENE ASSUMPTION (for halfbandA/B and hpA/B)
+    auto &halfband = (s == 0) ? halfbandA : halfbandB;
+    auto &hp = (s == 0) ? hpA : hpB;
+
+    /*
+     * A scene which has produced exact silence for long enough that the halfband and lowcut
+     * tails have died away is left alone. Resetting those filters when we start skipping
+     * them means they pick up exactly where a settled filter would have been.
+     */
+    bool sceneIdle = false;
+
+    if (sceneoutIsSilent(s))
+    {
+        auto settleBlocks = (int)(storage.samplerate * sceneIdleSettleSeconds) / BLOCK_SIZE;
+
+        if (rs.silentBlocks == settleBlocks)
+        {
+            halfband.reset();
+
+            for (auto &h : hp)
+                h.suspend();
+
+            lowcutCoefficientState[s] = LowcutCoefficientState();
+        }
+
+        sceneIdle = rs.silentBlocks >= settleBlocks;
+
+        if (!sceneIdle)
+            rs.silentBlocks++;
+    }
+    else
+    {
+        rs.silentBlocks = 0;
+    }
+
+    if (rs.play && !sceneIdle)
+    {
+        hardclipScene<BLOCK_SIZE_OS>(storage.sceneHardclipMode[s], sceneout[s][0], sceneout[s][1]);
+        halfband.process_block_D2(sceneout[s][0], sceneout[s][1], BLOCK_SIZE_OS);
+    }
+
+    if (storage.getPatch().scene[s].lowcut.deactivated == false && !sceneIdle)
+    {
+        auto freq =
+            storage.getPatch().scenedata[s][storage.getPatch().scene[s].lowcut.param_id_in_scene].f;
+
+        auto slope = storage.getPatch().scene[s].lowcut.deform_type;
+        auto &lc = lowcutCoefficientState[s];
+
+        /*
+         * The coefficients are smoothed across a block, so after a change we set them for one
+         * more block to let the smoothing land on the target, and then leave them alone until
+         * the cutoff, slope or sample rate moves again.
+         */
+        if (freq != lc.freq || slope != lc.slope || storage.samplerate != lc.samplerate)
+        {
+            lc.freq = freq;
+            lc.slope = slope;
+            lc.samplerate = storage.samplerate;
+            lc.blocksToUpdate = 2;
+        }
+
+        bool updateCoefficients = lc.blocksToUpdate > 0;
+
+        if (updateCoefficients)
+            lc.blocksToUpdate--;
+
+        for (int i = 0; i <= slope; i++)
+        {
+            if (updateCoefficients)
+                hp[i].coeff_HP(hp[i].calc_omega(freq / 12.0), 0.4); // var 0.707
+
+            hp[i].process_block(sceneout[s][0], sceneout[s][1]);
+        }
+    }
+}
+
+bool SurgeSynthesizer::sceneoutIsSilent(int s) const
+{
+    for (int c = 0; c < 2; ++c)
+        for (int i = 0; i < BLOCK_SIZE_OS; ++i)
+            if (sceneout[s][c][i] != 0.f)
+                return false;
+
+    return true;
+}
+
+void SurgeSynthesizer::retireFinishedVoices(int s)
+{
+    int vi = 0;
+    bool shifted = false;
+    auto iter = voices[s].begin();
+
+    while (iter != voices[s].end())
+    {
+        bool ended = sceneRenderState[s].voiceEnded[vi++];
+
+        if ((*iter)->noteCacheRole == SurgeVoice::nc_recording)
+            ended = settleNoteCacheRecording(s, *iter, ended);
+
+        if (ended)
+        {
+            freeVoice(*iter);
+            iter = voices[s].erase(iter);
+            shifted = true;
+        }
+        else
+        {
+            // survivors behind a retired voice move to a new filter lane next block
+            if (shifted)
+                (*iter)->evictFromQFB();
+            iter++;
+        }
+    }
+}
+
+void SurgeSynthesizer::renderSceneJob(void *ctx, int s)
+{
+    auto synth = static_cast<SurgeSynthesizer *>(ctx);
+
+    // every scene other than the first gets its own generator, so the scenes never share one
+    auto priorRNG = SurgeStorage::threadRNGOverride;
+
+    if (s > 0)
+        SurgeStorage::threadRNGOverride = &synth->sceneRenderState[s].rng;
+
+    synth->renderScene(s, false);
+
+    SurgeStorage::threadRNGOverride = priorRNG;
+}
+
+void SurgeSynthesizer::renderVoiceGroupJob(void *ctx, int job)
+{
+    auto synth = static_cast<SurgeSynthesizer *>(ctx);
+    auto s = synth->voiceGroupJobs[job].scene;
+    auto group = synth->voiceGroupJobs[job].group;
+    auto &rs = synth->sceneRenderState[s];
+
+    auto priorRNG = SurgeStorage::threadRNGOverride;
+    SurgeStorage::threadRNGOverride = &synth->voiceGroupRNG[s][group];
+
+    auto end = std::min(rs.FBentry, (group + 1) << 2);
+    SURGE_TRACE_SCOPE(synth->traceRecorder, "voiceGroup", group);
+
+    for (int e = group << 2; e < end; ++e)
+    {
+        rs.voiceEnded[e] = !rs.voicesInOrder[e]->process_block(synth->FBQ[s][group], e & 3);
+    }
+
+    SurgeStorage::threadRNGOverride = priorRNG;
+}
+
+bool SurgeSynthesizer::sceneUsesFormulaModulators(int s) const
+{
+    // formula modulators evaluate in the single audio thread Lua state
+    for (int l = 0; l < n_lfos_voice; ++l)
+    {
+        if (storage.getPatch().scene[s].lfo[l].shape.val.i == lt_formula)
+            return true;
+    }
+
+    return false;
+}
+
+void SurgeSynthesizer::processBlockFormulaLFOs(int s)
+{
+    bool anyBlockFormulas = false;
+
+    for (auto v : voices[s])
+        anyBlockFormulas = anyBlockFormulas || v->hasBlockFormulaLFOs();
+
+    // running the LFOs ahead of the voices reorders random draws, so leave other patches be
+    if (!anyBlockFormulas)
+        return;
+
+    formulaBatch.clear();
+
+    for (auto v : voices[s])
+        v->processVoiceLFOs(&formulaBatch);
+
+    Surge::Formula::evaluateBlockBatch(&storage, formulaBatch);
+}
+
+bool SurgeSynthesizer::canRenderVoicesInParallel(int s) const
+{
+    if (!voiceRenderPool)
+        return false;
+
+    // a single group gains nothing from a handoff
+    if (voices[s].size() <= 4)
+        return false;
+
+    return voicesAreParallelSafe(s);
+}
+
+bool SurgeSynthesizer::voicesAreParallelSafe(int s) const
+{
+    // cached voices don't keep to the one lane per voice layout the groups rely on
+    if (noteRenderCache)
+    {
+        for (auto v : voices[s])
+            if (v->noteCacheRole != SurgeVoice::nc_live)
+                return false;
+    }
+
+    return voices[s].empty() || !sceneUsesFormulaModulators(s);
+}
+
+void SurgeSynthesizer::queueVoiceGroups(int s)
+{
+    auto &rs = sceneRenderState[s];
+
+    for (auto v : voices[s])
+    {
+        assert(v);
+        rs.voicesInOrder[rs.FBentry++] = v;
+    }
+
+    auto cost = estimateVoiceCost(s);
+
+    for (int g = 0; g < (rs.FBentry + 3) >> 2; ++g)
+    {
+        auto n = std::min(4, rs.FBentry - (g << 2));
+        auto at = nVoiceGroupJobs++;
+
+        // keep the round sorted longest first; ties stay in scene and group order
+        while (at > 0 && voiceGroupJobs[at - 1].cost < cost * n)
+        {
+            voiceGroupJobs[at] = voiceGroupJobs[at - 1];
+            at--;
+        }
+
+        voiceGroupJobs[at] = {s, g, cost * n};
+    }
+}
+
+bool SurgeSynthesizer::renderVoicesOfAllScenes()
+{
+    // scene B can listen to scene A through the audio input oscillator, which orders them
+    if (!voiceRenderPool || storage.otherscene_clients > 0)
+        return false;
+
+    size_t total = 0;
+
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        if (noteRenderCache)
+            assignNoteCacheLanes(s);
+
+        if (!voicesAreParallelSafe(s))
+            return false;
+
+        total += voices[s].size();
+    }
+
+    if (total <= 4)
+        return false;
+
+    Surge::Profiling::BlockProfiler::Scope profiled(blockProfiler, Surge::Profiling::ps_voices);
+    nVoiceGroupJobs = 0;
+
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        sceneRenderState[s].FBentry = 0;
+        sceneRenderState[s].cachedVoices = 0;
+        queueVoiceGroups(s);
+    }
+
+    voiceRenderPool->runAll(nVoiceGroupJobs, renderVoiceGroupJob, this);
+
+    for (auto &rs : sceneRenderState)
+        rs.voicesRendered = true;
+
+    return true;
+}
+
+float SurgeSynthesizer::estimateVoiceCost(int s) const
+{
+    /*
+     * Roughly what one voice of each oscillator type costs next to a classic oscillator, per
+     * unison voice where it has them. All this decides is the order the render work is handed
+     * out in, so it only has to be about right.
+     */
+    static constexpr float oscCost[] = {
+        1.f,  // classic
+        0.5f, // sine
+        1.f,  // wavetable
+        1.f,  // S&H noise
+        0.2f, // audio input
+        1.f,  // FM3
+        0.6f, // FM2
+        1.5f, // window
+        1.f,  // modern
+        3.f,  // string
+        4.f,  // twist
+        0.8f, // alias
+    };
+    static_assert(sizeof(oscCost) / sizeof(oscCost[0]) == n_osc_types);
+
+    auto &scene = storage.getPatch().scene[s];
+    const Parameter *mutes[n_oscs] = {&scene.mute_o1, &scene.mute_o2, &scene.mute_o3};
+
+    // envelopes, LFOs and the filter block, whatever the oscillators are
+    float cost = 2.f;
+
+    for (int o = 0; o < n_oscs; ++o)
+    {
+        if (mutes[o]->val.b)
+            continue;
+
+        auto &osc = scene.osc[o];
+        int unison = 1;
+
+        for (const auto &p : osc.p)
+        {
+            if (p.ctrltype == ct_osccount)
+            {
+                unison = std::max(p.val.i, 1);
+                break;
+            }
+        }
+
+        cost += oscCost[std::clamp(osc.type.val.i, 0, n_osc_types - 1)] * unison;
+    }
+
+    return cost;
+}
+
+void SurgeSynthesizer::setRenderVoicesInParallel(bool b)
+{
+    // Only call this when the audio thread is not running
+    if (b && !voiceRenderPool)
+    {
+        // leave one core for the audio thread, which also takes groups, and never start more
+        // workers than there can be groups
+        int hw = (int)std::thread::hardware_concurrency();
+        int nWorkers = std::clamp(hw - 1, 1, voiceCapacity() / 4 - 1);
+
+        voiceRenderPool = makeRenderPool(nWorkers);
+    }
+    else if (!b)
+    {
+        voiceRenderPool.reset();
+    }
+}
+
+void SurgeSynthesizer::setNoteRenderCache(bool b, int velocityBuckets)
+{
+    // Only call this when the audio thread is not running
+    noteCacheVelocityBuckets = std::clamp(velocityBuckets, 1, 128);
+
+    if (b && !noteRenderCache)
+    {
+        noteRenderCache = std::make_unique<NoteRenderCache>(storage.samplerate);
+    }
+    else if (!b && noteRenderCache)
+    {
+        allNotesOff();
+        noteRenderCache.reset();
+    }
+}
+
+/*
+ * Everything a one-shot note's output depends on, hashed along with the key and velocity
+ * bucket. A note can only be cached if it ends by itself and starts the same way whatever
+ * else is playing, and if nothing which moves independently of the note (a scene LFO, the
+ * random and alternate sources, the channel controllers, the audio input) modulates it or
+ * sounds in it. Macros can, since their values at the hit go in the key, as do the patch
+ * globals and tuning settings which the oscillators and filters read.
+ */
+uint64_t SurgeSynthesizer::noteCacheKey(int scene, int key, int velocity)
+{
+    auto &patch = storage.getPatch();
+    auto &sc = patch.scene[scene];
+
+    if (mpeEnabled || sc.polymode.val.i != pm_poly ||
+        sc.polyVoiceRepeatedKeyMode != NEW_VOICE_EVERY_NOTEON)
+        return 0;
+
+    // a sustaining note has no fixed length, and a glide depends on the note before
+    if (sc.adsr[0].s.val.f > 0.f || sc.portamento.val.f > sc.portamento.val_min.f)
+        return 0;
+
+    if (!storage.modRouting.voice[scene] || !storage.modRouting.scene[scene])
+        return 0;
+
+    // FNV-1a, as for the liveness key
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto mix = [&h](int64_t v) {
+        h ^= (uint64_t)v;
+        h *= 0x100000001b3ULL;
+    };
+    auto mixFloat = [&mix](float f) {
+        int32_t i;
+        memcpy(&i, &f, sizeof(i));
+        mix(i);
+    };
+
+    for (const auto *routing : {storage.modRouting.voice[scene], storage.modRouting.scene[scene]})
+    {
+        for (const auto &r : *routing)
+        {
+            if (r.muted)
+                continue;
+
+            auto src = r.source_id;
+            bool voiceLFO = src >= ms_lfo1 && src <= ms_lfo6;
+
+            if (voiceLFO && sc.lfo[src - ms_lfo1].trigmode.val.i == lm_freerun)
+                return 0;
+
+            if (src >= ms_ctrl1 && src <= ms_ctrl8)
+                mixFloat(sc.modsources[src]->get_output(0));
+            else if (!(voiceLFO || src == ms_velocity || src == ms_keytrack || src == ms_ampeg ||
+                       src == ms_filtereg))
+                return 0;
+
+            mix(src);
+            mix(r.source_index);
+            mix(r.destination_id);
+            mixFloat(r.depth);
+        }
+    }
+
+    for (const auto *p : patch.param_ptr)
+    {
+        if (p->scene != scene + 1)
+            continue;
+
+        mix(p->val.i);
+        mix(p->deactivated | (p->absolute << 1) | (p->extend_range << 2) | (p->temposync << 3) |
+            (p->porta_constrate << 4) | (p->porta_gliss << 5) | (p->porta_retrigger << 6));
+        mix(p->deform_type);
+        mix(p->porta_curve);
+    }
+
+    for (const auto &o : sc.osc)
+    {
+        if (o.type.val.i == ot_audioinput)
+            return 0;
+
+        auto aliasWave = o.p[AliasOscillator::ao_wave].val.i;
+
+        // these alias waves read live memory or the audio input rather than a fixed shape
+        if (o.type.val.i == ot_alias && aliasWave >= AliasOscillator::aow_mem_alias &&
+            aliasWave <= AliasOscillator::aow_audiobuffer)
+            return 0;
+
+        mix(o.wt.dataRevision);
+        mix(o.extraConfig.nData);
+
+        for (int i = 0; i < o.extraConfig.nData; ++i)
+            mixFloat(o.extraConfig.data[i]);
+    }
+
+    for (int l = 0; l < n_lfos_voice; ++l)
+    {
+        const auto &ss = patch.stepsequences[scene][l];
+
+        for (auto f : ss.steps)
+            mixFloat(f);
+
+        mix(ss.loop_start);
+        mix(ss.loop_end);
+        mixFloat(ss.shuffle);
+        mix((int64_t)ss.trigmask);
+
+        const auto &ms = patch.msegs[scene][l];
+
+        mix(ms.endpointMode);
+        mix(ms.editMode);
+        mix(ms.loopMode);
+        mix(ms.loop_start);
+        mix(ms.loop_end);
+        mix(ms.n_activeSegments);
+
+        for (int i = 0; i < ms.n_activeSegments; ++i)
+        {
+            const auto &seg = ms.segments[i];
+
+            for (auto f : {seg.duration, seg.v0, seg.nv1, seg.cpduration, seg.cpv})
+                mixFloat(f);
+
+            mix(seg.type);
+            mix(seg.useDeform | (seg.invertDeform << 1) | (seg.retriggerFEG << 2) |
+                (seg.retriggerAEG << 3));
+        }
+
+        mix((int64_t)patch.formulamods[scene][l].formulaHash);
+    }
+
+    mixFloat(storage.samplerate);
+    mixFloat(storage.temposyncratio);
+    mix(patch.character.val.i);
+    mix((int64_t)storage.tuningUpdates);
+    mix(storage.isStandardTuning | (storage.isStandardMapping << 1));
+    mix(storage.tuningApplicationMode);
+    mixFloat(storage.note_to_pitch(key));
+    mixFloat(sc.modsources[ms_pitchbend]->get_output(0));
+    mix(scene);
+    mix(key);
+    mix(velocity * noteCacheVelocityBuckets / 128);
+
+    return h ? h : 1;
+}
+
+void SurgeSynthesizer::startNoteCacheRole(SurgeVoice *v, int scene)
+{
+    auto key = noteCacheKey(scene, v->state.key, v->state.velocity);
+
+    if (!key)
+        return;
+
+    auto &cache = *noteRenderCache;
+
+    cache.clearIfFull();
+
+    auto e = cache.entryFor(key);
+
+    if (e < 0)
+        return;
+
+    switch (cache.stateOf(e))
+    {
+    case NoteRenderCache::es_trusted:
+        v->noteCacheRole = SurgeVoice::nc_replaying;
+        v->noteCacheEntry = e;
+        v->noteCachePosition = -v->getStartOffset();
+        cache.beginReplay();
+        break;
+    case NoteRenderCache::es_empty:
+    case NoteRenderCache::es_pending:
+    {
+        auto r = cache.startRecording(scene, e, v->state.velocity, v->getStartOffset());
+
+        if (r >= 0)
+        {
+            v->noteCacheRole = SurgeVoice::nc_recording;
+            v->noteCacheEntry = e;
+            v->noteCacheRecorder = r;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void SurgeSynthesizer::assignNoteCacheLanes(int s)
+{
+    // a recording which gets stolen or silenced finishes like any other voice
+    for (auto v : voices[s])
+    {
+        if (v->noteCacheRole == SurgeVoice::nc_recording && v->state.uberrelease)
+        {
+            noteRenderCache->abandonRecording(s, v->noteCacheRecorder);
+            v->noteCacheRole = SurgeVoice::nc_live;
+        }
+    }
+
+    /*
+     * Live voices pack into the scene's quads in list order and recording voices each have a
+     * recorder quad, so any voice whose lane moved since the last block takes its registers
+     * back before anything renders over them.
+     */
+    int lane = 0;
+
+    for (auto v : voices[s])
+    {
+        if (v->noteCacheRole == SurgeVoice::nc_live)
+        {
+            v->evictUnlessIn(&FBQ[s][lane >> 2], lane & 3);
+            lane++;
+        }
+        else if (v->noteCacheRole == SurgeVoice::nc_recording)
+        {
+            v->evictUnlessIn(&noteRenderCache->recorderQuad(s, v->noteCacheRecorder), 0);
+        }
+    }
+}
+
+bool SurgeSynthesizer::renderNoteCacheVoice(int s, SurgeVoice *v)
+{
+    if (v->noteCacheRole == SurgeVoice::nc_recording)
+        return v->process_block(noteRenderCache->recorderQuad(s, v->noteCacheRecorder), 0);
+
+    // a replay which gets stolen or silenced fades out over this block
+    auto e = v->noteCacheEntry;
+    auto length = noteRenderCache->lengthOf(e);
+    auto fade = v->state.uberrelease;
+
+    for (int c = 0; c < 2; ++c)
+    {
+        auto recorded = noteRenderCache->samplesOf(e, c);
+
+        for (int i = 0; i < BLOCK_SIZE_OS; ++i)
+        {
+            auto p = v->noteCachePosition + i;
+
+            if (p >= 0 && p < length)
+                sceneout[s][c][i] += fade ? recorded[p] * (1.f - (float)i * BLOCK_SIZE_OS_INV)
+                                          : recorded[p];
+        }
+    }
+
+    v->noteCachePosition += BLOCK_SIZE_OS;
+
+    return !fade && v->noteCachePosition < length;
+}
+
+bool SurgeSynthesizer::settleNoteCacheRecording(int s, SurgeVoice *v, bool ended)
+{
+    auto r = v->noteCacheRecorder;
+
+    if (ended || v->hasFinishedSounding())
+    {
+        noteRenderCache->finishRecording(s, r);
+        v->noteCacheRole = SurgeVoice::nc_live;
+        return true;
+    }
+
+    if (noteRenderCache->recorderOverflowed(s, r))
+    {
+        // too long to keep, so it plays out as an ordinary voice
+        noteRenderCache->abandonRecording(s, r);
+        noteRenderCache->markUncacheable(v->noteCacheEntry);
+        v->noteCacheRole = SurgeVoice::nc_live;
+
+        if (v->noteCacheReleasePending)
+            v->release();
+    }
+
+    return false;
+}
+
+void SurgeSynthesizer::endNoteCacheRole(SurgeVoice *v)
+{
+    if (v->noteCacheRole == SurgeVoice::nc_recording)
+        noteRenderCache->abandonRecording(v->state.scene_id, v->noteCacheRecorder);
+    else if (v->noteCacheRole == SurgeVoice::nc_replaying)
+        noteRenderCache->endReplay();
+
+    v->noteCacheRole = SurgeVoice::nc_live;
+}
+
+bool SurgeSynthesizer::canRenderScenesInParallel() const
+{
+    if (!sceneRenderPool)
+        return false;
+
+    // scene B can listen to scene A through the audio input oscillator, which orders them
+    if (storage.otherscene_clients > 0)
+        return false;
+
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        if (voices[s].empty() || sceneUsesFormulaModulators(s))
+            return false;
+    }
+
+    return true;
+}
+
+void SurgeSynthesizer::setRenderScenesInParallel(bool b)
+{
+    // Only call this when the audio thread is not running
+    if (b && !sceneRenderPool)
+    {
+        // the audio thread renders one scene, so we only need workers for the rest
+        sceneRenderPool = makeRenderPool(n_scenes - 1);
+    }
+    else if (!b)
+    {
+        sceneRenderPool.reset();
+    }
+}
+
+static constexpr int sceneInsertSlots[n_scenes][n_fx_per_chain] = {
+    {fxslot_ains1, fxslot_ains2, fxslot_ains3, fxslot_ains4},
+    {fxslot_bins1, fxslot_bins2, fxslot_bins3, fxslot_bins4}};
+
+bool SurgeSynthesizer::sceneHasActiveInserts(int s) const
+{
+    for (auto v : sceneInsertSlots[s])
+    {
+        if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
+            return true;
+    }
+
+    return false;
+}
+
+bool SurgeSynthesizer::processInsertChain(int s, bool sceneState)
+{
+    for (auto v : sceneInsertSlots[s])
+    {
+        if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
+        {
+            Surge::Profiling::BlockProfiler::Scope t(blockProfiler,
+                                                     Surge::Profiling::ps_fx_first + v);
+            SURGE_TRACE_SCOPE(traceRecorder, fxslot_shortnames[v], v);
+            sceneState = processFXSlot(v, sceneout[s][0], sceneout[s][1], sceneState);
+
+            if (denormalCounterEnabled)
+                countDenormals(v, sceneout[s][0], sceneout[s][1]);
+        }
+    }
+
+    return sceneState;
+}
 
-    for (int sc = 0; sc < n_scenes; sc++)
-    {
-        play_scene[sc] = (!voices[sc].empty());
-    }
+bool SurgeSynthesizer::processSendFX(int idx, int slot, bool sceneState)
+{
+    auto &out = fxRenderState.sendout[idx];
 
-    int FBentry[n_scenes];
-    int vcount = 0;
+    Surge::Profiling::BlockProfiler::Scope t(blockProfiler, Surge::Profiling::ps_fx_first + slot);
+    SURGE_TRACE_SCOPE(traceRecorder, fxslot_shortnames[slot], slot);
+    send[idx][0].MAC_2_blocks_to(sceneout[0][0], sceneout[0][1], out[0], out[1], BLOCK_SIZE_QUAD);
+    send[idx][1].MAC_2_blocks_to(sceneout[1][0], sceneout[1][1], out[0], out[1], BLOCK_SIZE_QUAD);
 
-    for (int s = 0; s < n_scenes; s++)
-    {
-        FBentry[s] = 0;
-        iter = voices[s].begin();
-        while (iter != voices[s].end())
-        {
-            SurgeVoice *v = *iter;
-            assert(v);
-            bool resume = v->process_block(FBQ[s][FBentry[s] >> 2], FBentry[s] & 3);
-            FBentry[s]++;
+    auto used = processFXSlot(slot, out[0], out[1], sceneState);
 
-            vcount++;
+    if (denormalCounterEnabled)
+        countDenormals(slot, out[0], out[1]);
 
-            if (!resume)
-            {
-                freeVoice(v);
-                iter = voices[s].erase(iter);
-            }
-            else
-                iter++;
-        }
+    return used;
+}
 
-        storage.modRoutingMutex.unlock();
+void SurgeSynthesizer::beginFXCrossfade(int slot, std::unique_ptr<Effect> &&from)
+{
+    auto &xf = fxCrossfade[slot];
 
-        using sst::filters::FilterType, sst::filters::FilterSubType;
-        fbq_global g;
-        if (storage.getPatch().scene[s].filterunit[0].type.deactivated)
-        {
-            g.FU1ptr = nullptr;
-        }
-        else
-        {
-            g.FU1ptr = sst::filters::GetQFPtrFilterUnit(
-                static_cast<FilterType>(storage.getPatch().scene[s].filterunit[0].type.val.i),
-                static_cast<FilterSubType>(
-                    storage.getPatch().scene[s].filterunit[0].subtype.val.i));
-        }
-        if (storage.getPatch().scene[s].filterunit[1].type.deactivated)
-        {
-            g.FU2ptr = nullptr;
-        }
-        else
-        {
-            g.FU2ptr = sst::filters::GetQFPtrFilterUnit(
-                static_cast<FilterType>(storage.getPatch().scene[s].filterunit[1].type.val.i),
-                static_cast<FilterSubType>(
-                    storage.getPatch().scene[s].filterunit[1].subtype.val.i));
-        }
+    // a change in the middle of a fade cuts the oldest effect off
+    retireEffect(slot, std::move(xf.from));
 
-        if (storage.getPatch().scene[s].wsunit.type.deactivated)
-        {
-            g.WSptr = nullptr;
-        }
-        else
-        {
-            g.WSptr =
-                sst::waveshapers::GetQuadWaveshaper(static_cast<sst::waveshapers::WaveshaperType>(
-                    storage.getPatch().scene[s].wsunit.type.val.i));
-        }
+    // the old effect keeps the settings it had, in storage of its own
+    auto &fxs = storage.getPatch().fx[slot];
 
-        FBQFPtr ProcessQuadFB =
-            GetFBQPointer(storage.getPatch().scene[s].filterblock_configuration.val.i,
-                          g.FU1ptr != 0, g.WSptr != 0, g.FU2ptr != 0);
+    xf.storage.emplace(fxs);
 
-        for (int e = 0; e < FBentry[s]; e += 4)
-        {
-            int units = FBentry[s] - e;
-            for (int i = units; i < 4; i++)
-            {
-                FBQ[s][e >> 2].FU[0].active[i] = 0;
-                FBQ[s][e >> 2].FU[1].active[i] = 0;
-                FBQ[s][e >> 2].FU[2].active[i] = 0;
-                FBQ[s][e >> 2].FU[3].active[i] = 0;
-            }
-            ProcessQuadFB(FBQ[s][e >> 2], g, sceneout[s][0], sceneout[s][1]);
-        }
+    for (const auto &p : fxs.p)
+        xf.data[p.id] = storage.getPatch().globaldata[p.id];
 
-        if (s == 0 && storage.otherscene_clients > 0)
-        {
-            // Make available for scene B
-            mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][0], storage.audio_otherscene[0]);
-            mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][1], storage.audio_otherscene[1]);
-        }
+    xf.from = std::move(from);
+    xf.from->rebindStorage(&*xf.storage, xf.data);
+    xf.block = 0;
+}
 
-        iter = voices[s].begin();
+bool SurgeSynthesizer::processFXSlot(int slot, float *dataL, float *dataR, bool inputPresent)
+{
+    auto &xf = fxCrossfade[slot];
 
-        while (iter != voices[s].end())
-        {
-            SurgeVoice *v = *iter;
-            assert(v);
-            v->GetQFB(); // save filter state in voices after quad processing is done
-            iter++;
-        }
+    if (!xf.from)
+        return fx[slot]->process_ringout(dataL, dataR, inputPresent);
 
-        storage.modRoutingMutex.lock();
+    float oldL alignas(16)[BLOCK_SIZE], oldR alignas(16)[BLOCK_SIZE];
 
-        // mute scene
-        if (storage.getPatch().scene[s].volume.deactivated)
-        {
-            mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][0]);
-            mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][1]);
-        }
-    }
+    mech::copy_from_to<BLOCK_SIZE>(dataL, oldL);
+    mech::copy_from_to<BLOCK_SIZE>(dataR, oldR);
 
-    storage.modRoutingMutex.unlock();
-    polydisplay = vcount;
+    auto oldUsed = xf.from->process_ringout(oldL, oldR, inputPresent);
+    auto used = fx[slot]->process_ringout(dataL, dataR, inputPresent);
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (play_scene[0])
+    for (int i = 0; i < BLOCK_SIZE; ++i)
     {
-        switch (storage.sceneHardclipMode[0])
-        {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[0][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[0][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[0][0]);
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[0][1]);
-            break;
-        case SurgeStorage::BYPASS_HARDCLIP:
-            break;
-        }
+        auto g = (float)(xf.block * BLOCK_SIZE + i + 1) / (fxCrossfadeBlocks * BLOCK_SIZE);
 
-        halfbandA.process_block_D2(sceneout[0][0], sceneout[0][1], BLOCK_SIZE_OS);
+        dataL[i] = oldL[i] + g * (dataL[i] - oldL[i]);
+        dataR[i] = oldR[i] + g * (dataR[i] - oldR[i]);
     }
 
-    if (play_scene[1])
-    {
-        switch (storage.sceneHardclipMode[1])
-        {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[1][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[1][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[1][0]);
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[1][1]);
-            break;
-        case SurgeStorage::BYPASS_HARDCLIP:
-            break;
-        }
+    if (++xf.block == fxCrossfadeBlocks)
+        retireEffect(slot, std::move(xf.from));
 
-        halfbandB.process_block_D2(sceneout[1][0], sceneout[1][1], BLOCK_SIZE_OS);
-    }
+    return used || oldUsed;
+}
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (storage.getPatch().scene[0].lowcut.deactivated == false)
-    {
-        auto freq =
-            storage.getPatch().scenedata[0][storage.getPatch().scene[0].lowcut.param_id_in_scene].f;
+void SurgeSynthesizer::renderInsertChainJob(void *ctx, int s)
+{
+    auto synth = static_cast<SurgeSynthesizer *>(ctx);
+    auto &fs = synth->fxRenderState;
 
-        auto slope = storage.getPatch().scene[0].lowcut.deform_type;
+    // as with the scenes, every job but the first draws from its own generator
+    auto priorRNG = SurgeStorage::threadRNGOverride;
 
-        for (int i = 0; i <= slope; i++)
-        {
-            hpA[i].coeff_HP(hpA[i].calc_omega(freq / 12.0), 0.4); // var 0.707
-            hpA[i].process_block(sceneout[0][0], sceneout[0][1]); // TODO: quadify
-        }
-    }
+    if (s > 0)
+        SurgeStorage::threadRNGOverride = &fs.rng[s];
 
-    if (storage.getPatch().scene[1].lowcut.deactivated == false)
-    {
-        auto freq =
-            storage.getPatch().scenedata[1][storage.getPatch().scene[1].lowcut.param_id_in_scene].f;
+    fs.sceneState[s] = synth->processInsertChain(s, fs.sceneState[s]);
 
-        auto slope = storage.getPatch().scene[1].lowcut.deform_type;
+    SurgeStorage::threadRNGOverride = priorRNG;
+}
 
-        for (int i = 0; i <= slope; i++)
-        {
-            hpB[i].coeff_HP(hpB[i].calc_omega(freq / 12.0), 0.4); // var 0.707
-            hpB[i].process_block(sceneout[1][0], sceneout[1][1]); // TODO: quadify
-        }
-    }
+void SurgeSynthesizer::renderSendJob(void *ctx, int job)
+{
+    auto synth = static_cast<SurgeSynthesizer *>(ctx);
+    auto &fs = synth->fxRenderState;
 
-    for (int cls = 0; cls < n_scenes; ++cls)
-    {
-        switch (storage.sceneHardclipMode[cls])
-        {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        default:
-            break;
-        }
-    }
+    auto priorRNG = SurgeStorage::threadRNGOverride;
 
-    // TODO: FIX SCENE ASSUMPTION
-    bool sc_state[n_scenes];
+    if (job > 0)
+        SurgeStorage::threadRNGOverride = &fs.rng[job];
 
-    for (int i = 0; i < n_scenes; i++)
-    {
-        sc_state[i] = play_scene[i];
-    }
+    fs.sendUsed[job] = synth->processSendFX(fs.sendIdx[job], fs.sendSlot[job],
+                                            fs.sceneState[0] || fs.sceneState[1]);
 
-    for (int i = 0; i < n_scenes; i++)
-        for (int channel = 0; channel < N_OUTPUTS; channel++)
-            storage.scenesOutputData.provideSceneData(i, channel, sceneout[i][channel]);
+    SurgeStorage::threadRNGOverride = priorRNG;
+}
 
-    // apply insert effects
-    if (fx_bypass != fxb_no_fx)
+void SurgeSynthesizer::setRenderFXInParallel(bool b)
+{
+    // Only call this when the audio thread is not running
+    if (b && !fxRenderPool)
     {
-        for (auto v : {fxslot_ains1, fxslot_ains2, fxslot_ains3, fxslot_ains4})
-        {
-            if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
-            {
-                sc_state[0] = fx[v]->process_ringout(sceneout[0][0], sceneout[0][1], sc_state[0]);
-            }
-        }
-
-        for (auto v : {fxslot_bins1, fxslot_bins2, fxslot_bins3, fxslot_bins4})
-        {
-            if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
-            {
-                sc_state[1] = fx[v]->process_ringout(sceneout[1][0], sceneout[1][1], sc_state[1]);
-            }
-        }
+        // the widest stage is the sends, and the audio thread takes one of those itself
+        fxRenderPool = makeRenderPool(n_send_slots - 1);
     }
-
-    for (int cls = 0; cls < n_scenes; ++cls)
+    else if (!b)
     {
-        switch (storage.sceneHardclipMode[cls])
-        {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        default:
-            break;
-        }
+        fxRenderPool.reset();
     }
+}
 
-    // sum scenes
-    // TODO: FIX SCENE ASSUMPTION
-    mech::copy_from_to<BLOCK_SIZE>(sceneout[0][0], output[0]);
-    mech::copy_from_to<BLOCK_SIZE>(sceneout[0][1], output[1]);
-    mech::accumulate_from_to<BLOCK_SIZE>(sceneout[1][0], output[0]);
-    mech::accumulate_from_to<BLOCK_SIZE>(sceneout[1][1], output[1]);
+std::unique_ptr<Surge::Threading::RenderWorkerPool> SurgeSynthesizer::makeRenderPool(int nWorkers)
+{
+    if (!renderExecutor)
+        return std::make_unique<Surge::Threading::RenderWorkerPool>(nWorkers);
 
-    bool sendused[4] = {false, false, false, false};
-    // add send effects
-    // TODO: FIX SCENE ASSUMPTION
-    if (fx_bypass == fxb_all_fx)
+    auto res = std::make_unique<Surge::Threading::RenderWorkerPool>(0);
+    res->setExecutor(renderExecutor, renderExecutorCtx);
+    return res;
+}
+
+void SurgeSynthesizer::setRenderExecutor(Surge::Threading::render_executor_t e, void *ctx)
+{
+    // Only call this when the audio thread is not running
+    renderExecutor = e;
+    renderExecutorCtx = ctx;
+
+    bool scenes = getRenderScenesInParallel(), voices = getRenderVoicesInParallel(),
+         fx = getRenderFXInParallel();
+
+    setRenderScenesInParallel(false);
+    setRenderVoicesInParallel(false);
+    setRenderFXInParallel(false);
+
+    setRenderScenesInParallel(scenes);
+    setRenderVoicesInParallel(voices);
+    setRenderFXInParallel(fx);
+}
+
+void SurgeSynthesizer::setRandomSeed(uint64_t seed)
+{
+    storage.seededRandom = true;
+    storage.randomSeed = seed;
+    storage.randomSeedVoiceOrigin = voiceCounter;
+
+    uint64_t stream = 0;
+
+    storage.rngGen.seed(SurgeStorage::deriveRandomSeed(seed, stream++));
+
+    for (auto &rs : sceneRenderState)
+        rs.rng.seed(SurgeStorage::deriveRandomSeed(seed, stream++));
+
+    for (auto &r : fxRenderState.rng)
+        r.seed(SurgeStorage::deriveRandomSeed(seed, stream++));
+
+    for (auto &r : voiceGroupRNG[0])
+        r.seed(SurgeStorage::deriveRandomSeed(seed, stream++));
+
+    for (int sc = 0; sc < n_scenes; ++sc)
     {
-        for (auto si : sendToIndex)
+        for (auto ms : {ms_random_bipolar, ms_random_unipolar})
         {
-            auto slot = si[0];
-            auto idx = si[1];
-
-            if (fx[slot] && !(storage.getPatch().fx_disable.val.i & (1 << slot)))
-            {
-                send[idx][0].MAC_2_blocks_to(sceneout[0][0], sceneout[0][1], fxsendout[idx][0],
-                                             fxsendout[idx][1], BLOCK_SIZE_QUAD);
-                send[idx][1].MAC_2_blocks_to(sceneout[1][0], sceneout[1][1], fxsendout[idx][0],
-                                             fxsendout[idx][1], BLOCK_SIZE_QUAD);
-                sendused[idx] = fx[slot]->process_ringout(fxsendout[idx][0], fxsendout[idx][1],
-                                                          sc_state[0] || sc_state[1]);
-                FX[idx].MAC_2_blocks_to(fxsendout[idx][0], fxsendout[idx][1], output[0], output[1],
-                                        BLOCK_SIZE_QUAD);
-            }
+            if (auto rms = dynamic_cast<RandomModulationSource *>(
+                    storage.getPatch().scene[sc].modsources[ms]))
+                rms->seed(SurgeStorage::deriveRandomSeed(seed, stream++));
         }
     }
 
-    // apply global effects
-    if ((fx_bypass == fxb_all_fx) || (fx_bypass == fxb_no_sends))
+    // the other scenes' voice groups came later, so they take the streams after everything else
+    for (int sc = 1; sc < n_scenes; ++sc)
     {
-        bool glob = sc_state[0] || sc_state[1];
-        for (int i = 0; i < n_send_slots; ++i)
-            glob = glob || sendused[i];
-
-        for (auto v : {fxslot_global1, fxslot_global2, fxslot_global3, fxslot_global4})
-        {
-            if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
-            {
-                glob = fx[v]->process_ringout(output[0], output[1], glob);
-            }
-        }
+        for (auto &r : voiceGroupRNG[sc])
+            r.seed(SurgeStorage::deriveRandomSeed(seed, stream++));
     }
 
-    amp.multiply_2_blocks(output[0], output[1], BLOCK_SIZE_QUAD);
-    amp_mute.multiply_2_blocks(output[0], output[1], BLOCK_SIZE_QUAD);
+    assert(stream < SurgeStorage::randomSeedVoiceStreams);
+}
 
-    // VU falloff
-    float a = storage.vu_falloff;
-    vu_peak[0] = min(2.f, a * vu_peak[0]);
-    vu_peak[1] = min(2.f, a * vu_peak[1]);
-    vu_peak[0] = max(vu_peak[0], mech::blockAbsMax<BLOCK_SIZE>(output[0]));
-    vu_peak[1] = max(vu_peak[1], mech::blockAbsMax<BLOCK_SIZE>(output[1]));
+std::unique_ptr<SurgeSynthesizer> SurgeSynthesizer::fork(PluginLayer *parent)
+{
+    // the directory scans are shared and only patch browsing needs them, so skip them here
+    auto config = storage.startupConfig;
+    config.createUserDirectory = false;
+    config.deferDirectoryScans = true;
+    config.voiceCapacity = storage.voiceCapacity;
 
-    switch (storage.hardclipMode)
-    {
-    case SurgeStorage::HARDCLIP_TO_18DBFS:
-        sdsp::hardclip_block8<BLOCK_SIZE>(output[0]);
-        sdsp::hardclip_block8<BLOCK_SIZE>(output[1]);
-        break;
+    auto res = std::make_unique<SurgeSynthesizer>(parent, config);
 
-    case SurgeStorage::HARDCLIP_TO_0DBFS:
-        sdsp::hardclip_block<BLOCK_SIZE>(output[0]);
-        sdsp::hardclip_block<BLOCK_SIZE>(output[1]);
-        break;
-    case SurgeStorage::BYPASS_HARDCLIP:
-        break;
-    }
+    if (storage.samplerate > 0)
+        res->setSamplerate(storage.samplerate);
 
-    // Send output to the oscilloscope, if anyone is listening.
-    if (storage.audioOut.subscribed())
+    res->time_data = time_data;
+    res->process_input = process_input;
+
+    if (storage.seededRandom)
+        res->setRandomSeed(storage.randomSeed);
+
+    void *data{nullptr};
+    auto sz = saveRaw(&data);
+    res->loadRaw(data, sz, false);
+
+    res->storage.tuningApplicationMode = storage.tuningApplicationMode;
+    if (!storage.isStandardScale)
+        res->storage.retuneToScale(storage.currentScale);
+    if (!storage.isStandardMapping)
+        res->storage.remapToKeyboard(storage.currentMapping);
+
+    res->mpeEnabled = mpeEnabled;
+    for (int c = 0; c < 16; ++c)
     {
-        storage.audioOut.push(output[0], output[1], BLOCK_SIZE);
+        auto &dst = res->channelState[c];
+        auto keyState = dst.keyState;
+        dst = channelState[c];
+        // there are no voices, so no keys are down
+        std::copy(std::begin(keyState), std::end(keyState), std::begin(dst.keyState));
+        dst.hold = false;
     }
 
-    // since the sceneout is now routable we also need to mute it
+    res->storage.pitch_bend = storage.pitch_bend;
+    res->pitchbendMIDIVal = pitchbendMIDIVal.load();
+    res->modwheelCC = modwheelCC.load();
+
     for (int sc = 0; sc < n_scenes; ++sc)
     {
-        amp_mute.multiply_2_blocks(sceneout[sc][0], sceneout[sc][1], BLOCK_SIZE_QUAD);
+        for (auto ms : {ms_modwheel, ms_breath, ms_expression, ms_aftertouch, ms_pitchbend})
+        {
+            auto src = dynamic_cast<ControllerModulationSource *>(
+                storage.getPatch().scene[sc].modsources[ms]);
+            auto dst = dynamic_cast<ControllerModulationSource *>(
+                res->storage.getPatch().scene[sc].modsources[ms]);
+
+            if (src && dst)
+                dst->init(src->target[0]);
+        }
     }
 
-    // Calculate how close we are to overloading the CPU
-    // (how close is the process() duration to duration)
-    auto process_end = std::chrono::high_resolution_clock::now();
-    auto duration_usec =
-        std::chrono::duration_cast<std::chrono::microseconds>(process_end - process_start);
-    auto max_duration_usec = BLOCK_SIZE * storage.dsamplerate_inv * 1000000;
-    float ratio = duration_usec.count() / max_duration_usec;
-    float c = cpu_level.load();
-    int window = max_duration_usec;
-    auto smoothed_ratio = (c * (window - 1) + ratio) / window;
-    c = c * storage.cpu_falloff;
-    cpu_level.store(max(c, smoothed_ratio));
+    res->resetControlInterpolators();
+
+    return res;
 }
 
 SurgeSynthesizer::PluginLayer *SurgeSynthesizer::getParent()
@@ -4792,6 +7055,7 @@ void SurgeSynthesizer::populateDawExtraState()
     }
 
     des.monoPedalMode = storage.monoPedalMode;
+    des.midiReceiveChannelMask = storage.midiReceiveChannelMask;
     des.oddsoundRetuneMode = storage.oddsoundRetuneMode;
 }
 
@@ -4814,6 +7078,7 @@ void SurgeSynthesizer::loadFromDawExtraState()
     storage.getPatch().isDirty = des.isDirty;
 
     storage.monoPedalMode = (MonoPedalMode)des.monoPedalMode;
+    storage.midiReceiveChannelMask = (uint16_t)(des.midiReceiveChannelMask & 0xFFFF);
     storage.oddsoundRetuneMode = (SurgeStorage::OddsoundRetuneMode)des.oddsoundRetuneMode;
 
     if (des.hasScale)
@@ -4899,6 +7164,8 @@ void SurgeSynthesizer::loadFromDawExtraState()
             storage.controllers_chan[i] = des.customcontrol_chan_map[i];
         }
     }
+
+    storage.midiMappingChanged();
 }
 
 void SurgeSynthesizer::swapMetaControllers(int c1, int c2)
@@ -5043,6 +7310,30 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
         break;
     }
 
+    /*
+     * A move or swap hands the running instances over in loadFx (see fxMoveFrom), so only a
+     * copy needs a new one. Reorders made before the audio thread picks up the last one
+     * compose, so the slots always point at the instance which is really going there.
+     */
+    auto pendingFrom = [this](int slot) { return fxMoveFrom[slot] >= 0 ? fxMoveFrom[slot] : slot; };
+
+    if (m == FXReorderMode::MOVE)
+    {
+        fxMoveFrom[target] = pendingFrom(source);
+        fxMoveFrom[source] = -1;
+    }
+    else if (m == FXReorderMode::SWAP)
+    {
+        auto sourceFrom = pendingFrom(source);
+
+        fxMoveFrom[source] = pendingFrom(target);
+        fxMoveFrom[target] = sourceFrom;
+    }
+    else
+    {
+        fxMoveFrom[target] = -1;
+    }
+
     /*
      * OK we can't copy the params - they contain things like id in scene - we need to copy the
      * values
@@ -5065,6 +7356,10 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
         cp(fxsync[target].p[i], so.p[i]);
     }
 
+    // a copy gets a new instance, primed with the values it is getting
+    if (fxMoveFrom[target] < 0)
+        stageEffectForSlot(target, fxsync[target].type.val.i);
+
     // Now swap the routings. FX routings are always global
     std::vector<ModulationRouting> *mv = nullptr;
     mv = &(storage.getPatch().modulation_global);
@@ -5212,6 +7507,7 @@ void SurgeSynthesizer::reclaimVoiceFor(SurgeVoice *v, char key, char channel, ch
     v->host_note_id = host_noteid;
     v->originating_host_channel = host_originating_channel;
     v->originating_host_key = host_originating_key;
+    indexVoice(v);
 
     channelState[channel].keyState[key].voiceOrder = voiceCounter++;
 
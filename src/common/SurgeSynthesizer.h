@@ -23,19 +23,43 @@
 #ifndef SURGE_SRC_COMMON_SURGESYNTHESIZER_H
 #define SURGE_SRC_COMMON_SURGESYNTHESIZER_H
 #include "SurgeStorage.h"
+#include "BackgroundService.h"
 #include "SurgeVoice.h"
 #include "Effect.h"
 #include "BiquadFilter.h"
+#include "ActiveVoiceList.h"
+#include "NoteVoiceIndex.h"
+#include "ParameterDisplayCache.h"
+#include "BlockProfiler.h"
+#include "DeadlineMonitor.h"
+#include "EditorChangeBus.h"
+#include "LargeBuffers.h"
+#include "MemoryFootprint.h"
+#include "RealtimeChecker.h"
+#include "TraceRecorder.h"
 #include <set>
 #include <sst/filters/HalfRateFilter.h>
 
 struct QuadFilterChainState;
+struct NoteRenderCache;
+
+namespace Surge
+{
+namespace Threading
+{
+struct RenderWorkerPool;
+typedef bool (*render_executor_t)(void *executorCtx, RenderWorkerPool *pool, int n);
+}
+} // namespace Surge
 
 #include <list>
 #include <utility>
+#include <optional>
 #include <atomic>
 #include <cstdio>
+#include <bit>
 #include <bitset>
+#include <limits>
 #include <vector>
 
 struct timedata
@@ -79,6 +103,7 @@ class alignas(16) SurgeSynthesizer
         virtual void surgeMacroUpdated(long macroNum, float) = 0;
     };
     SurgeSynthesizer(PluginLayer *parent, const std::string &suppliedDataPath = "");
+    SurgeSynthesizer(PluginLayer *parent, const SurgeStorage::SurgeStorageConfig &config);
     virtual ~SurgeSynthesizer();
 
     // Also see setNoteExpression() which allows you to control all note parameters polyphonically
@@ -88,6 +113,18 @@ class alignas(16) SurgeSynthesizer
     void playNote(char channel, char key, char velocity, char detune, int32_t host_noteid = -1,
                   int32_t forceScene = -1);
     void playNoteByFrequency(float freq, char velocity, int32_t id);
+
+    /*
+     * Note-ons which land together (a chord, an arpeggiator burst, a block of a MIDI file) can
+     * be queued rather than played one at a time. flushNoteOns plays them with a single
+     * stealing decision per scene: the voices the whole batch needs are taken at once, and
+     * notes which the rest of the batch would steal straight back never start a voice. Each
+     * note keeps the eventOffsetInBlock it was queued with. A caller has to flush before any
+     * other event so nothing is reordered; the note releases and process flush by themselves.
+     */
+    void queueNoteOn(char channel, char key, char velocity, char detune, int32_t host_noteid = -1);
+    void flushNoteOns();
+
     void releaseNote(char channel, char key, char velocity, int32_t host_noteid = -1);
     void chokeNote(int16_t channel, int16_t key, char velocity, int32_t host_noteid = -1);
     void releaseNotePostHoldCheck(int scene, char channel, char key, char velocity,
@@ -105,8 +142,173 @@ class alignas(16) SurgeSynthesizer
     int getNumOutputs() { return N_OUTPUTS; }
     int getBlockSize() { return BLOCK_SIZE; }
     int getMpeMainChannel(int voiceChannel, int key);
+
+    // See SurgeStorage::midiReceiveChannelMask. MPE needs every channel, so it ignores the mask
+    bool receivesMidiChannel(int channel) const
+    {
+        return mpeEnabled || channel < 0 || channel > 15 ||
+               (storage.midiReceiveChannelMask & (1 << channel));
+    }
     void process();
 
+    /*
+     * Scene rendering. renderScene runs one scene's voices, filter blocks, halfband
+     * downsampling and lowcut, and touches nothing the other scene uses, so with parallel
+     * scene rendering on (which is opt-in, and must be toggled while the audio thread is
+     * stopped) the scenes render side by side on a RenderWorkerPool. Voices which finish
+     * during the block are only flagged there and retired afterwards on the audio thread by
+     * retireFinishedVoices, since freeing a voice looks across both scenes.
+     */
+    void setRenderScenesInParallel(bool b);
+    bool getRenderScenesInParallel() const { return (bool)sceneRenderPool; }
+    void renderScene(int s, bool allowParallelVoices = true);
+    void renderSceneVoices(int s, bool allowParallelVoices);
+    void retireFinishedVoices(int s);
+    bool sceneoutIsSilent(int s) const;
+    // how long a scene must be silent before its halfband and lowcut are skipped
+    static constexpr float sceneIdleSettleSeconds = 0.25f;
+    bool canRenderScenesInParallel() const;
+    static void renderSceneJob(void *ctx, int s);
+
+    /*
+     * Within a scene, voices are independent until ProcessQuadFB, so with parallel voice
+     * rendering on (also opt-in) each group of four voices sharing a QuadFilterChainState
+     * runs its process_block calls as one job on a second pool. Each group owns its
+     * QuadFilterChainState outright, so no lane is ever written from two threads. This path is
+     * not used while the scenes themselves are rendering in parallel.
+     *
+     * When neither scene has to wait for the other, the groups of both scenes go into one
+     * round rather than a round per scene, and the pool hands them out longest first by
+     * estimateVoiceCost, so a costly scene's groups start first and the cheap ones fill in
+     * around them instead of the block waiting on a straggler. If that still isn't enough,
+     * the polyphony governor is what backs off.
+     */
+    void setRenderVoicesInParallel(bool b);
+    bool getRenderVoicesInParallel() const { return (bool)voiceRenderPool; }
+    bool canRenderVoicesInParallel(int s) const;
+    bool voicesAreParallelSafe(int s) const;
+    bool renderVoicesOfAllScenes();
+    void queueVoiceGroups(int s);
+    // relative cost of one voice of the scene, from its oscillator types and unison counts
+    float estimateVoiceCost(int s) const;
+    static void renderVoiceGroupJob(void *ctx, int job);
+
+    /*
+     * The note render cache (opt-in, and toggled only while the audio thread is stopped)
+     * replays the one-shot notes of drum-like patches instead of rendering them again; see
+     * NoteRenderCache. Hits in the same velocity bucket share a recording, so fewer buckets
+     * trade velocity detail for more replays. Cached notes play out their whole envelope
+     * whatever the note length, and ignore pitch bend and controller moves after the hit.
+     */
+    void setNoteRenderCache(bool b, int velocityBuckets = 128);
+    bool getNoteRenderCache() const { return (bool)noteRenderCache; }
+    std::unique_ptr<NoteRenderCache> noteRenderCache;
+    int noteCacheVelocityBuckets{128};
+    // 0 if the scene's notes can't be cached right now
+    uint64_t noteCacheKey(int scene, int key, int velocity);
+    void startNoteCacheRole(SurgeVoice *v, int scene);
+    void assignNoteCacheLanes(int s);
+    bool renderNoteCacheVoice(int s, SurgeVoice *v);
+    bool settleNoteCacheRecording(int s, SurgeVoice *v, bool ended);
+    void endNoteCacheRole(SurgeVoice *v);
+
+    /*
+     * FX rendering. Once the scenes are rendered, the scene A and scene B insert chains are
+     * independent of each other, and once the inserts are done so are the four sends, so with
+     * parallel FX rendering on (also opt-in) each of those two stages runs its chains side by
+     * side on a third pool. Inserts which listen to the other scene read a copy of it taken
+     * before either chain starts, and the send returns are summed on the audio thread in slot
+     * order, so the output doesn't depend on the pool. The global chain always runs serially.
+     */
+    void setRenderFXInParallel(bool b);
+    bool getRenderFXInParallel() const { return (bool)fxRenderPool; }
+    bool sceneHasActiveInserts(int s) const;
+    bool processInsertChain(int s, bool sceneState);
+    bool processSendFX(int idx, int slot, bool sceneState);
+    static void renderInsertChainJob(void *ctx, int s);
+    static void renderSendJob(void *ctx, int job);
+
+    bool sceneUsesFormulaModulators(int s) const;
+
+    /*
+     * When the host lends us its threads, pools made after this have no workers of their own
+     * and hand each round to the executor instead. Like the setters above, only call this
+     * while the audio thread is stopped; it rebuilds any pool which is already running.
+     */
+    void setRenderExecutor(Surge::Threading::render_executor_t e, void *ctx);
+    std::unique_ptr<Surge::Threading::RenderWorkerPool> makeRenderPool(int nWorkers);
+    Surge::Threading::render_executor_t renderExecutor{nullptr};
+    void *renderExecutorCtx{nullptr};
+
+    /*
+     * Seeded rendering. Reseeds every generator the engine owns from seed, and from then on
+     * each new voice gets its own generator derived from the seed and its note order, so
+     * identical calls and events give identical output at any thread count. Effects and LFOs
+     * draw their seeds when they are set up, so seed before loading the patch you render.
+     * Call from the audio thread, or while it is stopped.
+     */
+    void setRandomSeed(uint64_t seed);
+    void clearRandomSeed() { storage.seededRandom = false; }
+
+    /*
+     * A second engine starting from this one's state, for rendering variants of a loaded and
+     * warmed up patch on other threads without going back to disk. The fork gets the patch
+     * (from memory, with its wavetables and the storage core shared rather than rebuilt), the
+     * sample rate, tuning, transport, random seed and the channel controllers, snapped to
+     * their targets so nothing is still gliding. Voices and effect tails are not copied: they
+     * live in pooled and type erased DSP state which has no copy semantics, so a fork starts
+     * silent. With a random seed set, forks given the same events render identically.
+     *
+     * parent gets the fork's parameter callbacks, so it should not be the host's. Call from
+     * the audio thread, or while it is stopped; the fork can then be run on any thread.
+     */
+    std::unique_ptr<SurgeSynthesizer> fork(PluginLayer *parent);
+
+    /*
+     * Voice formulas which define process_block are gathered across a scene's voices and
+     * evaluated with one interpreter entry. See Surge::Formula::BlockBatch.
+     */
+    void processBlockFormulaLFOs(int s);
+    Surge::Formula::BlockBatch formulaBatch;
+
+    // voice formulas which don't read voice state share their results within a scene
+    Surge::Formula::SharedEvaluations formulaShares[n_scenes];
+
+    struct SceneRenderState
+    {
+        int FBentry{0};
+        bool play{false};
+        std::array<bool, MAX_VOICES> voiceEnded{};
+        std::array<SurgeVoice *, MAX_VOICES> voicesInOrder{};
+        SurgeStorage::RNGGen rng;
+        int silentBlocks{0};
+        int cachedVoices{0};
+        // set when renderVoicesOfAllScenes has already rendered this block's voices
+        bool voicesRendered{false};
+    } sceneRenderState[n_scenes];
+    std::unique_ptr<Surge::Threading::RenderWorkerPool> sceneRenderPool;
+
+    struct FXRenderState
+    {
+        std::array<bool, n_scenes> sceneState{};
+        int nSends{0};
+        std::array<int, n_send_slots> sendIdx{}, sendSlot{};
+        std::array<bool, n_send_slots> sendUsed{};
+        float (*sendout)[2][BLOCK_SIZE]{nullptr};
+        std::array<SurgeStorage::RNGGen, n_send_slots> rng;
+    } fxRenderState;
+    std::unique_ptr<Surge::Threading::RenderWorkerPool> fxRenderPool;
+
+    struct VoiceGroupJob
+    {
+        int scene, group;
+        float cost;
+    };
+    std::array<VoiceGroupJob, n_scenes * MAX_VOICES / 4> voiceGroupJobs;
+    int nVoiceGroupJobs{0};
+    std::array<std::array<SurgeStorage::RNGGen, MAX_VOICES / 4>, n_scenes> voiceGroupRNG;
+    std::unique_ptr<Surge::Threading::RenderWorkerPool> voiceRenderPool;
+
     PluginLayer *getParent();
 
     // protected:
@@ -115,7 +317,12 @@ class alignas(16) SurgeSynthesizer
     void onNRPN(int channel, int lsbNRPN, int msbNRPN, int lsbValue, int msbValue);
 
     void resetStateFromTimeData();
+    // temposyncratio follows time_data.tempo, recomputed only when the tempo has moved
+    void updateTempoSyncRatio();
+    double tempoSyncRatioTempo{std::numeric_limits<double>::quiet_NaN()};
     void processControl();
+    void releaseModRoutingForBlock();
+    bool haveModRoutingLockThisBlock{false};
     /*
      * processAudioThreadOpsWhenAudioEngineUnavailable reloads a patch if the audio thread
      * isn't running but if it is running lets the deferred queue handle it. But it has an option
@@ -132,10 +339,72 @@ class alignas(16) SurgeSynthesizer
 
     /*
      * FX Lifecycle events happen on the audio thread but is read in the openOrRecreateEditor
-     * so if you swpan or init the fx[s] object lock this mutex
+     * so if you swpan or init the fx[s] object lock this mutex. The audio thread only
+     * try_locks it for single slot changes, deferring the change a block if the UI has it.
      */
     std::mutex fxSpawnMutex;
     std::mutex patchLoadSpawnMutex;
+
+    /*
+     * Constructing an effect can be expensive (large delay lines, the Nimbus and chowdsp
+     * buffers) so when an FX type changes, stageEffectForSlot asks the storage's
+     * BackgroundService to build the new instance for the slot. It only sets atomics, so it is
+     * safe from setParameter01 on the audio thread. loadFx leaves the old effect running until
+     * the slot's request has been served and then adopts the staged instance rather than
+     * calling spawn_effect. Effects the audio thread is done with are parked in fxRetired
+     * and the same service frees them, so nothing on that thread frees an effect either.
+     *
+     * withDefaults also sets the new type's default values into fxsync first, as a type change
+     * from a parameter wants; see setParameter01.
+     *
+     * Offline renders (storage.renderingOffline) and engines with stageEffectsInline, like the
+     * headless test engine and surgepy, build on the calling thread instead, so a change always
+     * lands on the next block.
+     */
+    void stageEffectForSlot(int slot, int type, bool withDefaults = false);
+    bool stageEffectsInline{false};
+    bool isStagingEffect(int slot) const
+    {
+        return fxStageServed[slot].load(std::memory_order_acquire) !=
+               fxStageRequested[slot].load(std::memory_order_acquire);
+    }
+    void releaseRetiredEffects();
+    int retiredEffectCount() const;
+    std::unique_ptr<Effect> takeStagedEffect(int slot, int type);
+    void retireEffect(int slot, std::unique_ptr<Effect> &&e);
+
+    static void serviceEffectStaging(void *ctx);
+    void buildStagedEffect(int slot, int type, bool withDefaults);
+
+    std::mutex fxStagingMutex;
+    std::unique_ptr<Effect> fxStaged[n_fx_slots];
+    int fxStagedType[n_fx_slots]{};
+
+    std::atomic<int> fxStageType[n_fx_slots]{}, fxStageRequested[n_fx_slots]{},
+        fxStageServed[n_fx_slots]{};
+    std::atomic<bool> fxStageDefaults[n_fx_slots]{};
+    Surge::Threading::BackgroundService::Client fxStager;
+
+    // a few per slot, since a crossfade retires two effects and the service may be behind
+    static constexpr int maxRetiredEffects = 4 * n_fx_slots;
+    std::atomic<Effect *> fxRetired[maxRetiredEffects]{};
+
+    /*
+     * When a slot changes from one effect to another, the old one keeps running on a frozen
+     * copy of its settings and the slot crossfades to the new one over fxCrossfadeBlocks,
+     * after which the old one is retired like any other. processFXSlot runs a slot's effect,
+     * and the fade if there is one. Patch loads and moves don't fade.
+     */
+    static constexpr int fxCrossfadeBlocks = 16;
+    struct FXCrossfade
+    {
+        std::unique_ptr<Effect> from;
+        std::optional<FxStorage> storage;
+        pdata data[n_global_params]{};
+        int block{0};
+    } fxCrossfade[n_fx_slots];
+    void beginFXCrossfade(int slot, std::unique_ptr<Effect> &&from);
+    bool processFXSlot(int slot, float *dataL, float *dataR, bool inputPresent);
     enum FXReorderMode
     {
         NONE,
@@ -151,6 +420,8 @@ class alignas(16) SurgeSynthesizer
                    int32_t host_noteid, int16_t okey = -1, int16_t ochan = -1);
     void releaseScene(int s);
     int calculateChannelMask(int channel, int key);
+    int calculateChannelMask(int channel, int key, bool useMIDICh2Ch3);
+    bool noteFilteredByMTS(char channel, char key);
     void softkillVoice(int scene);
     void enforcePolyphonyLimit(int scene, int margin);
     int getNonUltrareleaseVoices(int scene) const;
@@ -162,9 +433,36 @@ class alignas(16) SurgeSynthesizer
                          int host_note_id, int host_originating_channel, int host_originating_key,
                          bool envFromZero = false);
     void notifyEndedNote(int32_t nid, int16_t key, int16_t chan, bool thisBlock = true);
-    std::array<std::array<SurgeVoice, MAX_VOICES>, 2> voices_array;
+    // storage.voiceCapacity voices per scene, allocated once at construction
+    std::array<Surge::Memory::LargeArray<SurgeVoice>, n_scenes> voices_array;
+    int voiceCapacity() const { return storage.voiceCapacity; }
     // TODO: FIX SCENE ASSUMPTION!
-    unsigned int voices_usedby[2][MAX_VOICES]; // 0 indicates no user, 1 is scene A, 2 is scene B
+    // 0 indicates no user, 1 is scene A, 2 is scene B
+    std::array<std::vector<unsigned int>, n_scenes> voices_usedby;
+
+    // which voices_array slots are on each channel/key and host note id
+    NoteVoiceIndex noteVoiceIndex;
+    bool voiceSlot(const SurgeVoice *v, int &scene, int &slot) const;
+    // call whenever a voice takes on a new key, channel or host note id; freeVoice unindexes
+    void indexVoice(SurgeVoice *v);
+
+    /*
+     * Call f with each voice of the scene which may match channel, key and host note id (with
+     * -1 as a wildcard). This is a superset of the matches, so f still has to check.
+     */
+    template <typename F>
+    void forEachVoiceCandidate(int scene, int16_t channel, int16_t key, int32_t noteId, F &&f)
+    {
+        NoteVoiceIndex::mask_t m;
+        if (!noteVoiceIndex.candidates(scene, channel, key, noteId, m))
+        {
+            for (auto v : voices[scene])
+                f(v);
+            return;
+        }
+
+        m.forEachSlot([&](int slot) { f(&voices_array[scene][slot]); });
+    }
 
     int64_t voiceCounter = 1L;
 
@@ -172,14 +470,38 @@ class alignas(16) SurgeSynthesizer
 
     bool doNotifyEndedNote{true};
     int32_t hostNoteEndedDuringBlockCount{0};
-    int32_t endedHostNoteIds[MAX_VOICES << 3];
-    int16_t endedHostNoteOriginalKey[MAX_VOICES << 3];
-    int16_t endedHostNoteOriginalChannel[MAX_VOICES << 3];
+    // these hold voiceCapacity() << 3 entries
+    std::vector<int32_t> endedHostNoteIds;
+    std::vector<int16_t> endedHostNoteOriginalKey;
+    std::vector<int16_t> endedHostNoteOriginalChannel;
 
     int32_t hostNoteEndedToPushToNextBlock{0};
-    int32_t nextBlockEndedHostNoteIds[MAX_VOICES << 3];
-    int16_t nextBlockEndedHostNoteOriginalKey[MAX_VOICES << 3];
-    int16_t nextBlockEndedHostNoteOriginalChannel[MAX_VOICES << 3];
+    std::vector<int32_t> nextBlockEndedHostNoteIds;
+    std::vector<int16_t> nextBlockEndedHostNoteOriginalKey;
+    std::vector<int16_t> nextBlockEndedHostNoteOriginalChannel;
+
+    /*
+     * How far into the coming block, in samples, the event being applied right now happens.
+     * Hosts set it before handing us each event ahead of a process() call, and the voices a
+     * note-on starts begin that far into the block, so note starts are sample accurate without
+     * a smaller BLOCK_SIZE. process() puts it back to 0 for anything applied between blocks.
+     */
+    int eventOffsetInBlock{0};
+
+    // see queueNoteOn
+    struct QueuedNoteOn
+    {
+        char channel, key, velocity, detune;
+        int32_t host_noteid;
+        int offset;
+    };
+    std::array<QueuedNoteOn, 128> queuedNoteOns;
+    int nQueuedNoteOns{0};
+    // while a batch plays: the channel mask default read once, and per scene whether its
+    // stealing is already done and how many of its notes start no voice
+    bool noteBatchActive{false}, noteBatchCh2Ch3{true};
+    std::array<bool, n_scenes> noteBatchStolen{};
+    std::array<int, n_scenes> noteBatchSkip{};
 
   public:
     /*
@@ -245,6 +567,18 @@ class alignas(16) SurgeSynthesizer
     {
         getParameterDisplayAlt(index.getSynthSideId(), text);
     }
+    /*
+     * The same text as getParameterDisplay, but remembered per parameter until the value or
+     * anything else it depends on changes. For hosts which redraw every parameter's text far
+     * more often than any of it changes. The vector version fills in the current value text
+     * for a whole set of parameters in one go.
+     */
+    std::string getParameterDisplayCached(const ID &index, bool external = false, float x = 0.f)
+    {
+        return getParameterDisplayCached(index.getSynthSideId(), external, x);
+    }
+    void getParameterDisplaysCached(const std::vector<ID> &indices,
+                                    std::vector<std::string> &into);
     void getParameterName(const ID &index, char *text) const
     {
         getParameterName(index.getSynthSideId(), text);
@@ -297,6 +631,10 @@ class alignas(16) SurgeSynthesizer
     // Then, later, call releaseNote() as appropriate.
     void setNoteExpression(SurgeVoice::NoteExpressionType net, int32_t note_id, int16_t key,
                            int16_t channel, float value);
+    // Several expressions for one note in one pass over its voices; bit n of which says
+    // values[n] is set for NoteExpressionType n
+    void setNoteExpressions(int32_t note_id, int16_t key, int16_t channel, const float *values,
+                            uint32_t which);
 
     bool getParameterIsBoolean(const ID &index) const;
 
@@ -319,6 +657,7 @@ class alignas(16) SurgeSynthesizer
 
   private:
     bool setParameter01(long index, float value, bool external = false, bool force_integer = false);
+    void queueParameterRefresh(long index);
     void sendParameterAutomation(long index, float value);
     float getParameter01(long index) const;
     float getParameter(long index) const;
@@ -327,6 +666,7 @@ class alignas(16) SurgeSynthesizer
     void getParameterDisplay(long index, char *text) const;
     void getParameterDisplay(long index, char *text, float x) const;
     void getParameterDisplayAlt(long index, char *text) const;
+    std::string getParameterDisplayCached(long index, bool external, float x);
     void getParameterName(long index, char *text) const;
     void getParameterAccessibleName(long index, char *text) const;
     void getParameterMeta(long index, parametermeta &pm) const;
@@ -395,13 +735,69 @@ class alignas(16) SurgeSynthesizer
     void enqueuePatchForLoad(const void *data, int size); // safe from any thread
     void processEnqueuedPatchIfNeeded();                  // only safe from audio thread
 
-    void loadRaw(const void *data, int size, bool preset = false);
+    /*
+     * Hosts hand the same state back a lot (project load, undo, delay compensation resets).
+     * We key the last state we loaded or saved, leaving out the DAW extra state, and note the
+     * patch revision it was taken at. An enqueued state with the same key while the revision
+     * is unchanged is already what we are playing, so only its DAW extra state is applied.
+     */
+    static uint64_t patchStateKey(const void *data, int size);
+    void rememberPatchState(const void *data, int size);
+    std::mutex patchStateKeyMutex;
+    uint64_t patchStateKeyValue{0}, patchStateKeyRevision{0};
+    bool patchStateKeyKnown{false};
+
+    void loadRaw(const void *data, int size, bool preset = false,
+                 TiXmlDocument *parsedXml = nullptr);
     void loadPatch(int id);
     bool loadPatchByPath(const char *fxpPath, int categoryId, const char *name,
                          bool forceIsPreset = true);
+    bool loadPatchFromChunk(std::unique_ptr<char[]> &data, int size, int categoryId,
+                            const char *name, bool forceIsPreset);
+    // As above but leaves data alone, and applies parsedXml (see SurgePatch::parse_patch_xml)
+    // rather than parsing the chunk's xml again if it is given
+    bool loadPatchFromChunk(const void *data, int size, int categoryId, const char *name,
+                            bool forceIsPreset, TiXmlDocument *parsedXml = nullptr);
     void selectRandomPatch();
     std::unique_ptr<std::thread> patchLoadThread;
 
+    /*
+     * When a patch is queued by id or by file, the audio thread first asks for its FXP chunk
+     * to be read on a background thread and keeps playing at full level until it is in memory.
+     * Only then does it fade out and halt for the load, which no longer has to wait on the
+     * disk. If the request changes while the read is in flight, loadPatchByPath sees the path
+     * doesn't match and just reads the file itself as before.
+     */
+    struct PatchPrefetch
+    {
+        enum State
+        {
+            IDLE,
+            READING,
+            READY
+        };
+        std::atomic<int> state{IDLE};
+        std::string path;
+        std::unique_ptr<char[]> data;
+        int size{0};
+        std::unique_ptr<std::thread> thread;
+    } patchPrefetch;
+    bool queuedPatchIsPrefetched(); // audio thread; starts the read if it isn't running
+    void prefetchQueuedPatch();
+    void clearPatchPrefetch();
+    bool readPatchChunk(const fs::path &path, std::unique_ptr<char[]> &data, int &size);
+
+    /*
+     * Stepping through a bank in order is the common case on stage, so once a patch is loaded
+     * by id the chunks of the patches either side of it are read into the patch chunk cache on
+     * a background thread. The next step then finds its chunk in memory.
+     */
+    std::unique_ptr<std::thread> neighbourPrefetchThread;
+    std::mutex neighbourPrefetchMutex;
+    void prefetchNeighbourPatches(int id);
+
+    Surge::Storage::ParameterDisplayCache parameterDisplayCache;
+
     // if increment is true, we go to next patch, else go to previous patch
     void jogCategory(bool increment);
     void jogPatch(bool increment, bool insideCategory = true);
@@ -413,6 +809,9 @@ class alignas(16) SurgeSynthesizer
     void savePatch(bool factoryInPlace = false, bool skipOverwrite = false);
     void updateUsedState();
     void prepareModsourceDoProcess(int scenemask);
+    uint64_t modsourceLivenessKey(int scenemask) const;
+    bool isModulationDestinationLive(int scene, int paramId, const bool *sceneSourceLive) const;
+    uint64_t modsourceLivenessKeyLastBlock{0};
     unsigned int saveRaw(void **data);
 
     //==============================================================================
@@ -450,6 +849,66 @@ class alignas(16) SurgeSynthesizer
     float vu_peak[8];
     std::atomic<float> cpu_level{0.f};
 
+    // which of the above changed since the editor last looked
+    EditorChangeBus editorChanges;
+
+    // where the block time goes, section by section; off until someone enables it
+    Surge::Profiling::BlockProfiler blockProfiler;
+    float getFXSlotLoad(int slot) const
+    {
+        return blockProfiler.getLoad(Surge::Profiling::ps_fx_first + slot);
+    }
+
+    // a timeline of the same, for a trace viewer; only fed when built with SURGE_TRACING
+    Surge::Profiling::TraceRecorder traceRecorder;
+
+    // the last blocks which came close to (or past) their deadline, and why they might have
+    Surge::Profiling::DeadlineMonitor deadlineMonitor;
+
+    /*
+     * What this engine holds in memory, subsystem by subsystem. Safe from any thread but the
+     * audio thread, since it briefly takes the FX and wavetable locks.
+     */
+    Surge::Profiling::MemoryFootprint getMemoryFootprint();
+
+    /*
+     * How many denormal samples each FX slot has written since the last reset. process()
+     * runs with flush-to-zero and denormals-are-zero on, so these should all stay at zero;
+     * anything else points at a path which escapes that guard. Off unless enabled, since it
+     * scans every slot's output every block.
+     */
+    void setDenormalCounterEnabled(bool b) { denormalCounterEnabled = b; }
+    bool getDenormalCounterEnabled() const { return denormalCounterEnabled; }
+    uint64_t getDenormalCount(int slot) const
+    {
+        return denormalCount[slot].load(std::memory_order_relaxed);
+    }
+    void resetDenormalCounts();
+
+    /*
+     * The FX budget is an optional governor for when the whole block gets close to its
+     * deadline. Above the high water mark of cpu_level it steps down one rung at a time: first
+     * every effect which can run at reduced quality does so, then the send effects are faded
+     * out and bypassed starting from the last send. Once the load falls below the low water
+     * mark it climbs back up the same way, fading the sends back in.
+     */
+    void setFXBudgetEnabled(bool b);
+    bool getFXBudgetEnabled() const { return fxBudget.enabled; }
+    void setFXBudgetWaterMarks(float low, float high);
+    int getFXBudgetDegradeLevel() const { return fxBudget.degradeLevel; }
+    bool isSendBypassedByFXBudget(int send) const { return fxBudget.sendFade[send] == 0.f; }
+
+    /*
+     * The polyphony governor is the voice side of the same idea. While cpu_level is above
+     * its high water mark it lowers an effective polyphony limit, which playNote honours, and
+     * soft-kills the quietest released voices over that limit. Held notes are never taken by
+     * the governor itself. Below the low water mark the limit climbs back to the patch's own.
+     */
+    void setPolyphonyGovernorEnabled(bool b);
+    bool getPolyphonyGovernorEnabled() const { return polyGovernor.enabled; }
+    void setPolyphonyGovernorWaterMarks(float low, float high);
+    int getEffectivePolyphonyLimit() const;
+
     void populateDawExtraState();
 
     void loadFromDawExtraState();
@@ -460,7 +919,13 @@ class alignas(16) SurgeSynthesizer
     bool approachingAllSoundsOff{false};
     // TODO: FIX SCENE ASSUMPTION (for halfbandA/B - use std::array)
     sst::filters::HalfRate::HalfRateFilter halfbandA, halfbandB, halfbandIN;
-    std::list<SurgeVoice *> voices[n_scenes];
+    // whether the storage audio input buffers hold input rather than the silence left for
+    // patches with nothing reading them
+    bool audioInputLive{false};
+    // rebuilds the halfbands above when the storage's active profile differs from theirs
+    void updateHalfbandProfile();
+    SurgeStorage::HalfbandProfile halfbandProfileInUse{SurgeStorage::HALFBAND_STANDARD};
+    ActiveVoiceList voices[n_scenes];
     std::unique_ptr<Effect> fx[n_fx_slots];
     std::atomic<bool> halt_engine;
     MidiChannelState channelState[16];
@@ -469,6 +934,20 @@ class alignas(16) SurgeSynthesizer
     int mpeGlobalPitchBendRange = 0;
 
     std::bitset<128> disallowedLearnCCs{0};
+
+    /*
+     * CC routing table, rebuilt whenever storage.midiMappingRevision moves. Targets are grouped
+     * by CC number, with every RPN/NRPN mapping in one extra bucket at the end; a target is a
+     * param_ptr index, or -1 - i for macro i. Entries are re-checked against the mapping when
+     * dispatched, so a change which missed midiMappingChanged() can only miss a target, not
+     * hit a wrong one.
+     */
+    static constexpr int n_cc_dispatch_buckets = 129;
+    int ccDispatchStart[n_cc_dispatch_buckets + 1]{};
+    int ccDispatchTargets[n_total_params + n_customcontrollers]{};
+    uint32_t ccDispatchRevision{0};
+    bool ccDispatchBuilt{false};
+    void rebuildCCDispatch();
     std::array<uint64_t, 128> midiKeyPressedForScene[n_scenes];
     uint64_t orderedMidiKey = 0;
     std::atomic<uint64_t> midiNoteEvents{0};
@@ -485,6 +964,40 @@ class alignas(16) SurgeSynthesizer
     // TODO: FIX SCENE ASSUMPTION (use std::array)
     std::array<BiquadFilter, n_hpBQ> hpA, hpB;
 
+    // what the scene lowcut coefficients were last computed for; see renderScene
+    struct LowcutCoefficientState
+    {
+        float freq{0.f}, samplerate{0.f};
+        int slope{-1}, blocksToUpdate{0};
+    } lowcutCoefficientState[n_scenes];
+
+    struct FXBudgetState
+    {
+        bool enabled{false};
+        float lowWater{0.6f}, highWater{0.85f};
+        int degradeLevel{0}, blocksSinceChange{0};
+        float sendFade[n_send_slots]{1.f, 1.f, 1.f, 1.f};
+        int sendBlocksAtZero[n_send_slots]{};
+    } fxBudget;
+    void updateFXBudget();
+    bool sendProcessingAllowedByFXBudget(int send) const;
+
+    struct PolyphonyGovernorState
+    {
+        bool enabled{false};
+        float lowWater{0.7f}, highWater{0.9f};
+        int limit{MAX_VOICES}, blocksSinceChange{0};
+    } polyGovernor;
+    void updatePolyphonyGovernor();
+
+    uint64_t blocksProcessed{0};
+    void checkDeadline(float load);
+
+    bool denormalCounterEnabled{false};
+    std::atomic<uint64_t> denormalCount[n_fx_slots]{};
+    void countDenormals(int slot, const float *L, const float *R);
+    bool softkillQuietestReleasedVoice(int s);
+
     bool fx_reload[n_fx_slots]; // if true, reload new effect parameters from fxsync
     FxStorage fxsync[n_fx_slots]{
         FxStorage(fxslot_ains1),   FxStorage(fxslot_ains2),   FxStorage(fxslot_bins1),
@@ -494,6 +1007,8 @@ class alignas(16) SurgeSynthesizer
         FxStorage(fxslot_send3),   FxStorage(fxslot_send4),   FxStorage(fxslot_global3),
         FxStorage(fxslot_global4)}; // used for synchronisation of parameter init
     bool fx_reload_mod[n_fx_slots];
+    // the slot whose running effect a pending reorder moves into this one, or -1
+    int fxMoveFrom[n_fx_slots];
 
     struct FXModSyncItem
     {
@@ -520,6 +1035,8 @@ class alignas(16) SurgeSynthesizer
     void purgeDuplicateHeldVoicesInPolyMode(int scehe, int channel, int key);
 
     QuadFilterChainState *FBQ[n_scenes];
+    // each scene's filter block functions, resolved again only when its filter settings change
+    ResolvedFilterChain resolvedFilterChain[n_scenes];
 
     std::string hostProgram = "Unknown Host";
     std::string juceWrapperType = "Unknown Wrapper Type";
@@ -527,17 +1044,31 @@ class alignas(16) SurgeSynthesizer
 
     void changeModulatorSmoothing(Modulator::SmoothingMode m);
 
+    // how many parameters setParameterSmoothed can be moving at once
+    static constexpr int num_controlinterpolators = 128;
+
     // these have to be thread-safe, so keep them private
   private:
     PluginLayer *_parent = nullptr;
 
     void switch_toggled();
 
-    // MIDI control interpolators
-    static constexpr int num_controlinterpolators = 128;
+    /*
+     * MIDI control interpolators. Each parameter being smoothed owns a slot, found through
+     * the per parameter slot table; free slots are kept on a stack and the slots in use in a
+     * packed list, so taking, finding and releasing a slot and walking the busy ones in
+     * processControl never scan all of them.
+     */
     ControllerModulationSource mControlInterpolator[num_controlinterpolators];
-    bool mControlInterpolatorUsed[num_controlinterpolators];
-
+    int16_t mControlInterpolatorSlot[n_total_params];
+    int16_t mControlInterpolatorFree[num_controlinterpolators];
+    int mControlInterpolatorFreeCount{0};
+    int16_t mControlInterpolatorActive[num_controlinterpolators];
+    int16_t mControlInterpolatorActivePos[num_controlinterpolators];
+    int mControlInterpolatorActiveCount{0};
+
+    void resetControlInterpolators();
+    void releaseControlInterpolatorSlot(int Index);
     int GetFreeControlInterpolatorIndex();
     int GetControlInterpolatorIndex(int Idx);
     void ReleaseControlInterpolator(int Idx);
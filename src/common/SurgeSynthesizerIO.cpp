@@ -30,6 +30,7 @@
 #include <fstream>
 #include <iterator>
 #include "SurgeMemoryPools.h"
+#include "PatchChunkCache.h"
 
 #include "sst/basic-blocks/mechanics/endian-ops.h"
 namespace mech = sst::basic_blocks::mechanics;
@@ -57,8 +58,87 @@ struct fxChunkSetCustom
     // char chunk[8]; // variable
 };
 
+/*
+ * Read the FXP chunk for path, from the patch chunk cache if it has it and from disk (caching
+ * it) otherwise. Anything unusual is left to loadPatchByPath, which reports the errors.
+ */
+bool SurgeSynthesizer::readPatchChunk(const fs::path &path, std::unique_ptr<char[]> &data,
+                                      int &cs)
+{
+    if (storage.patchChunkCache->fetch(path, data, cs))
+        return true;
+
+    std::filebuf f;
+
+    if (!f.open(path, std::ios::binary | std::ios::in))
+        return false;
+
+    fxChunkSetCustom fxp;
+
+    if (f.sgetn(reinterpret_cast<char *>(&fxp), sizeof(fxp)) == sizeof(fxp) &&
+        mech::endian_read_int32BE(fxp.chunkMagic) == 'CcnK' &&
+        mech::endian_read_int32BE(fxp.fxMagic) == 'FPCh' &&
+        mech::endian_read_int32BE(fxp.fxID) == 'cjs3')
+    {
+        cs = mech::endian_read_int32BE(fxp.chunkSize);
+        data.reset(new char[cs]);
+
+        if (f.sgetn(data.get(), cs) != cs)
+        {
+            data.reset();
+            cs = 0;
+        }
+        else
+        {
+            storage.patchChunkCache->store(path, data.get(), cs);
+        }
+    }
+
+    f.close();
+    return data != nullptr;
+}
+
+void SurgeSynthesizer::prefetchNeighbourPatches(int id)
+{
+    int p = storage.patch_list.size();
+
+    if (p < 2 || id < 0 || id >= p)
+        return;
+
+    // the same order jogPatch walks when it isn't held inside a category
+    int order = storage.patch_list[id].order;
+    std::vector<fs::path> paths;
+
+    for (auto o : {order + 1, order - 1})
+    {
+        auto n = storage.patchOrdering[(o + p) % p];
+
+        if (n != id)
+            paths.push_back(storage.patch_list[n].path);
+    }
+
+    std::lock_guard<std::mutex> mg(neighbourPrefetchMutex);
+
+    if (neighbourPrefetchThread)
+        neighbourPrefetchThread->join();
+
+    neighbourPrefetchThread = std::make_unique<std::thread>([this, paths]() {
+        for (auto &path : paths)
+        {
+            if (storage.patchChunkCache->contains(path))
+                continue;
+
+            std::unique_ptr<char[]> data;
+            int cs = 0;
+            readPatchChunk(path, data, cs);
+        }
+    });
+}
+
 void SurgeSynthesizer::jogPatch(bool increment, bool insideCategory)
 {
+    storage.ensureDirectoryScans();
+
     // Don't increment if we still have an outstanding load
     if (patchid_queue >= 0)
         return;
@@ -144,6 +224,8 @@ void SurgeSynthesizer::jogPatch(bool increment, bool insideCategory)
 
 void SurgeSynthesizer::jogCategory(bool increment)
 {
+    storage.ensureDirectoryScans();
+
     int c = storage.patch_category.size();
 
     if (!c)
@@ -198,6 +280,8 @@ void SurgeSynthesizer::jogPatchOrCategory(bool increment, bool isCategory, bool
 
 void SurgeSynthesizer::selectRandomPatch()
 {
+    storage.ensureDirectoryScans();
+
     if (patchid_queue >= 0)
         return;
     int p = storage.patch_list.size();
@@ -223,11 +307,91 @@ void SurgeSynthesizer::loadPatch(int id)
     Patch e = storage.patch_list[id];
     loadPatchByPath(path_to_string(e.path).c_str(), e.category, e.name.c_str());
     storage.getPatch().isDirty = false;
+
+    prefetchNeighbourPatches(id);
+}
+
+bool SurgeSynthesizer::queuedPatchIsPrefetched()
+{
+    auto st = patchPrefetch.state.load();
+
+    if (st == PatchPrefetch::IDLE)
+    {
+        std::lock_guard<std::mutex> mg(patchLoadSpawnMutex);
+
+        if (patchPrefetch.thread)
+            patchPrefetch.thread->join();
+
+        patchPrefetch.state = PatchPrefetch::READING;
+        patchPrefetch.thread = std::make_unique<std::thread>([this]() { prefetchQueuedPatch(); });
+    }
+
+    return st == PatchPrefetch::READY;
+}
+
+void SurgeSynthesizer::prefetchQueuedPatch()
+{
+    std::string path;
+
+    {
+        std::lock_guard<std::mutex> mg(patchLoadSpawnMutex);
+
+        if (patchid_queue >= 0 && !storage.patch_list.empty())
+        {
+            // resolve the id the same way loadPatch will
+            auto id = std::max(0, (int)patchid_queue);
+            id = id % storage.patch_list.size();
+            path = path_to_string(storage.patch_list[id].path);
+        }
+        else if (has_patchid_file)
+        {
+            path = patchid_file;
+        }
+    }
+
+    std::unique_ptr<char[]> data;
+    int cs = 0;
+
+    if (!path.empty())
+        readPatchChunk(string_to_path(path), data, cs);
+
+    patchPrefetch.path = data ? path : std::string();
+    patchPrefetch.data = std::move(data);
+    patchPrefetch.size = cs;
+    patchPrefetch.state = PatchPrefetch::READY;
+}
+
+void SurgeSynthesizer::clearPatchPrefetch()
+{
+    patchPrefetch.data.reset();
+    patchPrefetch.size = 0;
+    patchPrefetch.path.clear();
+    patchPrefetch.state = PatchPrefetch::IDLE;
 }
 
 bool SurgeSynthesizer::loadPatchByPath(const char *fxpPath, int categoryId, const char *patchName,
                                        bool forceIsPreset)
 {
+    SURGE_TRACE_SCOPE(traceRecorder, "loadPatchByPath");
+
+    if (patchPrefetch.state == PatchPrefetch::READY && patchPrefetch.data &&
+        patchPrefetch.path == fxpPath)
+    {
+        auto data = std::move(patchPrefetch.data);
+        auto cs = patchPrefetch.size;
+        clearPatchPrefetch();
+
+        return loadPatchFromChunk(data, cs, categoryId, patchName, forceIsPreset);
+    }
+
+    {
+        std::unique_ptr<char[]> data;
+        int cs = 0;
+
+        if (storage.patchChunkCache->fetch(string_to_path(fxpPath), data, cs))
+            return loadPatchFromChunk(data, cs, categoryId, patchName, forceIsPreset);
+    }
+
     std::filebuf f;
     if (!f.open(string_to_path(fxpPath), std::ios::binary | std::ios::in))
         return false;
@@ -276,9 +440,30 @@ bool SurgeSynthesizer::loadPatchByPath(const char *fxpPath, int categoryId, cons
     {
         perror("Error while loading patch!");
     }
+    else
+    {
+        storage.patchChunkCache->store(string_to_path(fxpPath), data.get(), cs);
+    }
 
     f.close();
 
+    return loadPatchFromChunk(data, cs, categoryId, patchName, forceIsPreset);
+}
+
+bool SurgeSynthesizer::loadPatchFromChunk(std::unique_ptr<char[]> &data, int cs, int categoryId,
+                                          const char *patchName, bool forceIsPreset)
+{
+    auto res = loadPatchFromChunk((const void *)data.get(), cs, categoryId, patchName,
+                                  forceIsPreset);
+    data.reset();
+
+    return res;
+}
+
+bool SurgeSynthesizer::loadPatchFromChunk(const void *data, int cs, int categoryId,
+                                          const char *patchName, bool forceIsPreset,
+                                          TiXmlDocument *parsedXml)
+{
     storage.getPatch().comment = "";
     storage.getPatch().author = "";
 
@@ -294,8 +479,7 @@ bool SurgeSynthesizer::loadPatchByPath(const char *fxpPath, int categoryId, cons
     current_category_id = categoryId;
     storage.getPatch().name = patchName;
 
-    loadRaw(data.get(), cs, forceIsPreset);
-    data.reset();
+    loadRaw(data, cs, forceIsPreset, parsedXml);
 
     // OK so at this point we may have loaded a patch with a tuning override
     if (storage.getPatch().patchTuning.tuningStoredInPatch)
@@ -423,16 +607,85 @@ void SurgeSynthesizer::processEnqueuedPatchIfNeeded()
         }
         std::lock_guard<std::mutex> g(rawLoadQueueMutex);
         rawLoadEnqueued = false;
-        loadRaw(enqueuedLoadData.get(), enqueuedLoadSize);
+
+        auto key = patchStateKey(enqueuedLoadData.get(), enqueuedLoadSize);
+        bool unchanged{false};
+        {
+            std::lock_guard<std::mutex> kg(patchStateKeyMutex);
+            unchanged = patchStateKeyKnown && patchStateKeyValue == key &&
+                        patchStateKeyRevision == storage.getPatch().isDirty.revision;
+        }
+
+        TiXmlDocument doc;
+
+        if (unchanged &&
+            SurgePatch::parse_patch_xml(enqueuedLoadData.get(), enqueuedLoadSize, doc))
+        {
+            storage.getPatch().load_daw_extra_state(
+                TINYXML_SAFE_TO_ELEMENT(doc.FirstChild("patch")));
+        }
+        else
+        {
+            loadRaw(enqueuedLoadData.get(), enqueuedLoadSize);
+        }
+
         loadFromDawExtraState();
+        rememberPatchState(enqueuedLoadData.get(), enqueuedLoadSize);
 
         rawLoadNeedsUIDawExtraState = true;
         refresh_editor = true;
     }
 }
 
-void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset)
+uint64_t SurgeSynthesizer::patchStateKey(const void *data, int size)
 {
+    auto d = static_cast<const char *>(data);
+    auto end = d + size;
+
+    // skip the DAW extra state, which changes with the editor and the host without the patch
+    static constexpr char openTag[] = "<dawExtraState", closeTag[] = "</dawExtraState>";
+    auto skipFrom = std::search(d, end, openTag, openTag + sizeof(openTag) - 1);
+    auto skipTo = std::search(skipFrom, end, closeTag, closeTag + sizeof(closeTag) - 1);
+
+    if (skipTo == end)
+        skipFrom = end;
+    else
+        skipTo += sizeof(closeTag) - 1;
+
+    // 64 bit FNV-1a
+    uint64_t h = 14695981039346656037ULL;
+
+    for (auto p = d; p < end; ++p)
+    {
+        if (p == skipFrom)
+            p = skipTo;
+        if (p == end)
+            break;
+
+        h = (h ^ (uint8_t)*p) * 1099511628211ULL;
+    }
+
+    return h;
+}
+
+void SurgeSynthesizer::rememberPatchState(const void *data, int size)
+{
+    auto key = patchStateKey(data, size);
+
+    std::lock_guard<std::mutex> kg(patchStateKeyMutex);
+    patchStateKeyValue = key;
+    patchStateKeyRevision = storage.getPatch().isDirty.revision;
+    patchStateKeyKnown = true;
+}
+
+void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset, TiXmlDocument *parsedXml)
+{
+    SURGE_TRACE_SCOPE(traceRecorder, "loadPatch");
+    storage.noteBlockEvent(SurgeStorage::be_patchLoad);
+    storage.patchLoadProfile.begin();
+    Surge::Profiling::PatchLoadProfile::Scope loadScope(
+        storage.patchLoadProfile, Surge::Profiling::PatchLoadProfile::lp_load);
+
     halt_engine = true;
     allNotesOff();
     for (int s = 0; s < n_scenes; s++)
@@ -440,7 +693,7 @@ void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset)
             storage.getPatch().scene[s].modsources[ms_ctrl1 + i]->reset();
 
     storage.getPatch().init_default_values();
-    storage.getPatch().load_patch(data, size, preset);
+    storage.getPatch().load_patch(data, size, preset, parsedXml);
     storage.getPatch().update_controls(false, nullptr, true);
     for (int i = 0; i < n_fx_slots; i++)
     {
@@ -448,7 +701,11 @@ void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset)
         fx_reload[i] = true;
     }
 
-    loadFx(false, true);
+    {
+        Surge::Profiling::PatchLoadProfile::Scope ps(storage.patchLoadProfile,
+                                                     Surge::Profiling::PatchLoadProfile::lp_fx);
+        loadFx(false, true);
+    }
 
     for (int sc = 0; sc < n_scenes; sc++)
     {
@@ -469,6 +726,7 @@ void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset)
 
     storage.getPatch().isDirty = false;
 
+    storage.patchLoadProfile.armFirstBlock();
     halt_engine = false;
     patch_loaded = true;
     refresh_editor = true;
@@ -660,4 +918,9 @@ void SurgeSynthesizer::savePatchToPath(fs::path filename, bool refreshPatchList)
     }
 }
 
-unsigned int SurgeSynthesizer::saveRaw(void **data) { return storage.getPatch().save_patch(data); }
+unsigned int SurgeSynthesizer::saveRaw(void **data)
+{
+    auto sz = storage.getPatch().save_patch(data);
+    rememberPatchState(*data, sz);
+    return sz;
+}
@@ -0,0 +1,208 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <set>
+
+namespace Surge
+{
+namespace Profiling
+{
+TraceRecorder::TraceRecorder() : epochNs(now()) {}
+TraceRecorder::~TraceRecorder() = default;
+
+uint64_t TraceRecorder::now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void TraceRecorder::setEnabled(bool e)
+{
+    if (e && !slots)
+    {
+        slots = std::make_unique<Slot[]>(capacity);
+        ring.store(slots.get(), std::memory_order_release);
+    }
+
+    enabled.store(e, std::memory_order_release);
+}
+
+void TraceRecorder::clear()
+{
+    auto *r = ring.load(std::memory_order_acquire);
+
+    if (r)
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            r[i].seq.store(~0ULL, std::memory_order_relaxed);
+    }
+
+    head.store(0, std::memory_order_release);
+    epochNs = now();
+}
+
+void TraceRecorder::record(const char *name, int index, uint64_t beginNs, uint64_t endNs)
+{
+    auto *r = ring.load(std::memory_order_acquire);
+
+    if (!r)
+        return;
+
+    // small and stable, so the trace viewer's thread rows stay readable
+    static std::atomic<uint32_t> nextThread{0};
+    thread_local uint32_t thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+
+    auto i = head.fetch_add(1, std::memory_order_relaxed);
+    auto &slot = r[i & (capacity - 1)];
+
+    // mark it as being written, so a reader which catches us half way through skips it
+    slot.seq.store(~0ULL, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.index.store(index, std::memory_order_relaxed);
+    slot.thread.store(thread, std::memory_order_relaxed);
+    slot.beginNs.store(beginNs, std::memory_order_relaxed);
+    slot.durationNs.store(endNs > beginNs ? endNs - beginNs : 0, std::memory_order_relaxed);
+
+    slot.seq.store(i, std::memory_order_release);
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::snapshot() const
+{
+    std::vector<Event> res;
+    auto *r = ring.load(std::memory_order_acquire);
+
+    if (!r)
+        return res;
+
+    auto h = head.load(std::memory_order_acquire);
+    auto first = h > capacity ? h - capacity : 0;
+    res.reserve(h - first);
+
+    for (auto i = first; i < h; ++i)
+    {
+        auto &slot = r[i & (capacity - 1)];
+
+        if (slot.seq.load(std::memory_order_acquire) != i)
+            continue;
+
+        Event ev;
+        ev.name = slot.name.load(std::memory_order_relaxed);
+        ev.index = slot.index.load(std::memory_order_relaxed);
+        ev.thread = slot.thread.load(std::memory_order_relaxed);
+        ev.beginNs = slot.beginNs.load(std::memory_order_relaxed);
+        ev.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.seq.load(std::memory_order_relaxed) != i || !ev.name)
+            continue;
+
+        res.push_back(ev);
+    }
+
+    return res;
+}
+
+void TraceRecorder::writeChromeTrace(std::ostream &os,
+                                     const std::vector<const TraceRecorder *> &rs)
+{
+    auto quoted = [](const char *s) {
+        std::string res = "\"";
+        for (; *s; ++s)
+        {
+            if (*s == '"' || *s == '\\')
+                res += '\\';
+            res += *s;
+        }
+        return res + "\"";
+    };
+
+    // one time origin for everyone, so engines line up against each other
+    uint64_t epoch = ~0ULL;
+    for (auto *r : rs)
+        epoch = std::min(epoch, r->epochNs);
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool first = true;
+    auto sep = [&]() -> std::ostream & {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        return os;
+    };
+
+    os << std::fixed << std::setprecision(3);
+
+    for (size_t p = 0; p < rs.size(); ++p)
+    {
+        auto pid = p + 1;
+        auto events = rs[p]->snapshot();
+
+        sep() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+              << ",\"args\":{\"name\":\"surge engine " << p << "\"}}";
+
+        std::set<uint32_t> threads;
+        for (const auto &e : events)
+            threads.insert(e.thread);
+
+        for (auto t : threads)
+            sep() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                  << ",\"tid\":" << t << ",\"args\":{\"name\":\"surge thread " << t
+                  << "\"}}";
+
+        for (const auto &e : events)
+        {
+            auto ts = e.beginNs > epoch ? (e.beginNs - epoch) * 0.001 : 0.0;
+
+            sep() << "{\"name\":" << quoted(e.name) << ",\"cat\":\"surge\",\"ph\":\"X\""
+                  << ",\"pid\":" << pid << ",\"tid\":" << e.thread << ",\"ts\":" << ts
+                  << ",\"dur\":" << e.durationNs * 0.001;
+            if (e.index >= 0)
+                os << ",\"args\":{\"index\":" << e.index << "}";
+            os << "}";
+        }
+    }
+
+    os << "\n]}\n";
+}
+
+bool TraceRecorder::writeChromeTrace(const std::string &path,
+                                     const std::vector<const TraceRecorder *> &rs)
+{
+    std::ofstream ofs(path);
+
+    if (!ofs)
+        return false;
+
+    writeChromeTrace(ofs, rs);
+    return (bool)ofs;
+}
+} // namespace Profiling
+} // namespace Surge
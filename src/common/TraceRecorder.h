@@ -0,0 +1,147 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_TRACERECORDER_H
+#define SURGE_SRC_COMMON_TRACERECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * Build with SURGE_TRACING=1 (the SURGE_BUILD_WITH_TRACING cmake option) to compile the trace
+ * scopes into the engine. Without it SURGE_TRACE_SCOPE is empty and a recorder only ever holds
+ * what is recorded into it by hand.
+ */
+#ifndef SURGE_TRACING
+#define SURGE_TRACING 0
+#endif
+
+namespace Surge
+{
+namespace Profiling
+{
+/*
+ * A flight recorder of timed engine scopes (the block, the control pass, each scene, each
+ * voice group, each FX slot, patch loads) for finding out where an xrun went.
+ *
+ * Any thread may record, the audio thread and the render pool workers included: a slot in the
+ * ring is claimed with one fetch_add and published with a sequence number, so recording never
+ * locks or allocates and a reader copying the ring while it is being written simply drops the
+ * slots it sees half written. Once the ring is full the oldest events are overwritten, so what
+ * it holds is the last few seconds before you look.
+ *
+ * Recording is off by default, and the ring is only allocated when it is first turned on.
+ * writeChromeTrace dumps what is there as Chrome trace event JSON, which chrome://tracing and
+ * ui.perfetto.dev both open.
+ */
+struct TraceRecorder
+{
+    static constexpr size_t defaultCapacity = 1 << 16;
+
+    struct Event
+    {
+        const char *name; // must outlive the recorder; a literal or a static table entry
+        int32_t index;    // a scene, voice group or FX slot; -1 for none
+        uint32_t thread;
+        uint64_t beginNs, durationNs;
+    };
+
+    struct Scope
+    {
+        Scope(TraceRecorder &r, const char *name, int index = -1)
+            : recorder(r), name(name), index(index), running(r.isEnabled())
+        {
+            if (running)
+                start = now();
+        }
+        ~Scope()
+        {
+            if (running)
+                recorder.record(name, index, start, now());
+        }
+
+        TraceRecorder &recorder;
+        const char *name;
+        int index;
+        bool running;
+        uint64_t start{0};
+    };
+
+    TraceRecorder();
+    ~TraceRecorder();
+
+    static constexpr bool isCompiledIn() { return SURGE_TRACING != 0; }
+    static uint64_t now(); // ns on a steady clock
+
+    // not from the audio thread: turning it on the first time allocates the ring
+    void setEnabled(bool e);
+    bool isEnabled() const { return enabled.load(std::memory_order_acquire); }
+    void clear();
+
+    // any thread
+    void record(const char *name, int index, uint64_t beginNs, uint64_t endNs);
+
+    // any thread; the events still in the ring, oldest first
+    std::vector<Event> snapshot() const;
+    void writeChromeTrace(std::ostream &os) const { writeChromeTrace(os, {this}); }
+    bool writeChromeTrace(const std::string &path) const { return writeChromeTrace(path, {this}); }
+
+    // several engines in one trace, each as its own process row
+    static void writeChromeTrace(std::ostream &os, const std::vector<const TraceRecorder *> &rs);
+    static bool writeChromeTrace(const std::string &path,
+                                 const std::vector<const TraceRecorder *> &rs);
+
+  private:
+    struct Slot
+    {
+        std::atomic<uint64_t> seq{~0ULL};
+        std::atomic<const char *> name{nullptr};
+        std::atomic<int32_t> index{-1};
+        std::atomic<uint32_t> thread{0};
+        std::atomic<uint64_t> beginNs{0}, durationNs{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<Slot *> ring{nullptr};
+    size_t capacity{defaultCapacity};
+    std::atomic<uint64_t> head{0};
+    std::atomic<bool> enabled{false};
+    uint64_t epochNs{0};
+};
+} // namespace Profiling
+} // namespace Surge
+
+#if SURGE_TRACING
+#define SURGE_TRACE_CONCAT_INNER(a, b) a##b
+#define SURGE_TRACE_CONCAT(a, b) SURGE_TRACE_CONCAT_INNER(a, b)
+#define SURGE_TRACE_SCOPE(recorder, ...)                                                           \
+    Surge::Profiling::TraceRecorder::Scope SURGE_TRACE_CONCAT(surgeTraceScope, __LINE__)(         \
+        recorder, __VA_ARGS__)
+#else
+#define SURGE_TRACE_SCOPE(recorder, ...)
+#endif
+
+#endif // SURGE_SRC_COMMON_TRACERECORDER_H
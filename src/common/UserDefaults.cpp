@@ -26,6 +26,7 @@
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <fstream>
 
@@ -315,6 +316,9 @@ std::string defaultKeyToString(DefaultKey k)
     case FXUnitAssumeFixedBlock:
         r = "fxAssumeFixedBlock";
         break;
+    case FXUnitAnticipativeRendering:
+        r = "fxAnticipativeRendering";
+        break;
     case FXUnitDefaultZoom:
         r = "fxUnitDefaultZoom";
         break;
@@ -347,6 +351,30 @@ std::string defaultKeyToString(DefaultKey k)
         r = "openSoundControlPortOut";
         break;
 
+    case OSCOutputInterval:
+        r = "openSoundControlOutputInterval";
+        break;
+
+    case OfflineRenderHighestQuality:
+        r = "offlineRenderHighestQuality";
+        break;
+
+    case GlideHostTempo:
+        r = "glideHostTempo";
+        break;
+
+    case HalfbandProfile:
+        r = "halfbandProfile";
+        break;
+
+    case UndoHistoryMegabytes:
+        r = "undoHistoryMegabytes";
+        break;
+
+    case VoiceCapacity:
+        r = "voiceCapacity";
+        break;
+
     case StartOSCIn:
         r = "startOSCIn";
         break;
@@ -361,6 +389,150 @@ std::string defaultKeyToString(DefaultKey k)
     return r;
 }
 
+/*
+** The defaults file behind every provider opened on the same user data folder. The file
+** provider reports errors through whichever instance is making the call, since the instance
+** which happened to open the file first may be long gone.
+*/
+struct UserDefaultsProvider::SharedFile
+{
+    std::mutex lock;
+    std::unique_ptr<DefaultsFileProvider> provider;
+    std::atomic<uint64_t> writes{0};
+};
+
+namespace
+{
+thread_local const UserDefaultsProvider::errorReporter_t *callingReporter{nullptr};
+
+struct ReportThrough
+{
+    const UserDefaultsProvider::errorReporter_t *prior;
+    ReportThrough(const UserDefaultsProvider::errorReporter_t &r) : prior(callingReporter)
+    {
+        callingReporter = &r;
+    }
+    ~ReportThrough() { callingReporter = prior; }
+};
+
+std::mutex sharedFilesMutex;
+std::map<std::string, std::weak_ptr<UserDefaultsProvider::SharedFile>> sharedFiles;
+} // namespace
+
+UserDefaultsProvider::UserDefaultsProvider(const fs::path &userDataPath,
+                                           const std::string &productName,
+                                           std::function<std::string(DefaultKey)> keyToString,
+                                           errorReporter_t reporter)
+    : errorReporter(std::move(reporter))
+{
+    auto fileKey = path_to_string(userDataPath) + "|" + productName;
+
+    std::lock_guard<std::mutex> g(sharedFilesMutex);
+    file = sharedFiles[fileKey].lock();
+    if (file)
+        return;
+
+    file = std::make_shared<SharedFile>();
+    ReportThrough rt(errorReporter);
+    file->provider = std::make_unique<DefaultsFileProvider>(
+        userDataPath, productName, keyToString, [](auto &msg, auto &title) {
+            if (callingReporter && *callingReporter)
+                (*callingReporter)(msg, title);
+        });
+    sharedFiles[fileKey] = file;
+}
+
+UserDefaultsProvider::~UserDefaultsProvider()
+{
+    std::lock_guard<std::mutex> g(sharedFilesMutex);
+    file.reset();
+    for (auto it = sharedFiles.begin(); it != sharedFiles.end();)
+    {
+        if (it->second.expired())
+            it = sharedFiles.erase(it);
+        else
+            ++it;
+    }
+}
+
+template <typename T> T UserDefaultsProvider::get(DefaultKey key, const T &valueIfMissing)
+{
+    auto o = overrides.find(key);
+    if (o != overrides.end())
+    {
+        if (auto v = std::get_if<T>(&o->second))
+            return *v;
+    }
+
+    std::lock_guard<std::mutex> g(file->lock);
+    ReportThrough rt(errorReporter);
+    return file->provider->getUserDefaultValue(key, valueIfMissing);
+}
+
+template <typename T> bool UserDefaultsProvider::update(DefaultKey key, const T &value)
+{
+    std::lock_guard<std::mutex> g(file->lock);
+    ReportThrough rt(errorReporter);
+
+    /*
+     * Menus and overlays store their state whenever it is touched, usually unchanged. The key
+     * is present exactly when two different fallbacks read back the same value, and if that
+     * value is the one being stored there is nothing to write.
+     */
+    auto &p = file->provider;
+    auto stored = p->getUserDefaultValue(key, value);
+    if (stored == value)
+    {
+        auto other = value;
+        if constexpr (std::is_same_v<T, std::string>)
+            other += "*";
+        else if constexpr (std::is_same_v<T, int>)
+            other += 1;
+        else
+            other.first += 1;
+
+        if (p->getUserDefaultValue(key, other) == value)
+            return true;
+    }
+    file->writes++;
+    return p->updateUserDefaultValue(key, value);
+}
+
+uint64_t UserDefaultsProvider::revision() const { return file->writes + overrideRevision; }
+
+std::string UserDefaultsProvider::getUserDefaultValue(DefaultKey key,
+                                                      const std::string &valueIfMissing)
+{
+    return get(key, valueIfMissing);
+}
+
+int UserDefaultsProvider::getUserDefaultValue(DefaultKey key, int valueIfMissing)
+{
+    return get(key, valueIfMissing);
+}
+
+std::pair<int, int> UserDefaultsProvider::getUserDefaultValue(
+    DefaultKey key, const std::pair<int, int> &valueIfMissing)
+{
+    return get(key, valueIfMissing);
+}
+
+bool UserDefaultsProvider::updateUserDefaultValue(DefaultKey key, const std::string &value)
+{
+    return update(key, value);
+}
+
+bool UserDefaultsProvider::updateUserDefaultValue(DefaultKey key, int value)
+{
+    return update(key, value);
+}
+
+bool UserDefaultsProvider::updateUserDefaultValue(DefaultKey key,
+                                                  const std::pair<int, int> &value)
+{
+    return update(key, value);
+}
+
 /*
 ** Functions from the header
 */
@@ -368,33 +540,45 @@ std::string defaultKeyToString(DefaultKey k)
 std::string getUserDefaultValue(SurgeStorage *storage, const DefaultKey &key,
                                 const std::string &valueIfMissing)
 {
+    if (!storage->userDefaultsProvider)
+        return valueIfMissing;
     return storage->userDefaultsProvider->getUserDefaultValue(key, valueIfMissing);
 }
 
 int getUserDefaultValue(SurgeStorage *storage, const DefaultKey &key, int valueIfMissing)
 {
+    if (!storage->userDefaultsProvider)
+        return valueIfMissing;
     return storage->userDefaultsProvider->getUserDefaultValue(key, valueIfMissing);
 }
 
 std::pair<int, int> getUserDefaultValue(SurgeStorage *storage, const DefaultKey &key,
                                         const std::pair<int, int> &valueIfMissing)
 {
+    if (!storage->userDefaultsProvider)
+        return valueIfMissing;
     return storage->userDefaultsProvider->getUserDefaultValue(key, valueIfMissing);
 }
 
 bool updateUserDefaultValue(SurgeStorage *storage, const DefaultKey &key, const std::string &value)
 {
+    if (!storage->userDefaultsProvider)
+        return false;
     return storage->userDefaultsProvider->updateUserDefaultValue(key, value);
 }
 
 bool updateUserDefaultValue(SurgeStorage *storage, const DefaultKey &key, const int value)
 {
+    if (!storage->userDefaultsProvider)
+        return false;
     return storage->userDefaultsProvider->updateUserDefaultValue(key, value);
 }
 
 bool updateUserDefaultValue(SurgeStorage *storage, const DefaultKey &key,
                             const std::pair<int, int> &value)
 {
+    if (!storage->userDefaultsProvider)
+        return false;
     return storage->userDefaultsProvider->updateUserDefaultValue(key, value);
 }
 
@@ -22,7 +22,12 @@
 #ifndef SURGE_SRC_COMMON_USERDEFAULTS_H
 #define SURGE_SRC_COMMON_USERDEFAULTS_H
 
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
+#include <variant>
 #include <vector>
 #include <filesystem/import.h>
 #include "sst/plugininfra/userdefaults.h"
@@ -157,6 +162,7 @@ enum DefaultKey
 
     // Surge XT Effects specific defaults
     FXUnitAssumeFixedBlock,
+    FXUnitAnticipativeRendering,
     FXUnitDefaultZoom,
 
     IgnoreMIDIProgramChange,
@@ -168,12 +174,77 @@ enum DefaultKey
     StartOSCOut,
     OSCPortIn,
     OSCPortOut,
+    OSCOutputInterval,
+
+    OfflineRenderHighestQuality,
+    GlideHostTempo,
+    HalfbandProfile,
+    UndoHistoryMegabytes,
+    VoiceCapacity,
 
     nKeys
 };
 
 std::string defaultKeyToString(DefaultKey k);
-typedef sst::plugininfra::defaults::Provider<DefaultKey, DefaultKey::nKeys> UserDefaultsProvider;
+typedef sst::plugininfra::defaults::Provider<DefaultKey, DefaultKey::nKeys> DefaultsFileProvider;
+
+/*
+** One instance's view of the user defaults. The defaults file is read once per process and
+** shared by every instance using the same user data folder, so a setting changed in one
+** instance is what the others read next, and no instance rewrites the file from a stale copy.
+** Storing the value a key already holds does not touch the file. Overrides stay per instance.
+*/
+class UserDefaultsProvider
+{
+  public:
+    typedef std::function<void(const std::string &, const std::string &)> errorReporter_t;
+
+    UserDefaultsProvider(const fs::path &userDataPath, const std::string &productName,
+                         std::function<std::string(DefaultKey)> keyToString,
+                         errorReporter_t errorReporter);
+    ~UserDefaultsProvider();
+
+    std::string getUserDefaultValue(DefaultKey key, const std::string &valueIfMissing);
+    int getUserDefaultValue(DefaultKey key, int valueIfMissing);
+    std::pair<int, int> getUserDefaultValue(DefaultKey key,
+                                            const std::pair<int, int> &valueIfMissing);
+
+    bool updateUserDefaultValue(DefaultKey key, const std::string &value);
+    bool updateUserDefaultValue(DefaultKey key, int value);
+    bool updateUserDefaultValue(DefaultKey key, const std::pair<int, int> &value);
+
+    void addOverride(DefaultKey key, const std::string &value) { setOverride(key, value); }
+    void addOverride(DefaultKey key, int value) { setOverride(key, value); }
+    void addOverride(DefaultKey key, const std::pair<int, int> &value) { setOverride(key, value); }
+    void clearOverride(DefaultKey key)
+    {
+        overrides.erase(key);
+        overrideRevision++;
+    }
+
+    /*
+     * Moves whenever a value this provider hands out may have changed, whether through an
+     * override here or a write to the file by any instance sharing it. Anything caching text
+     * derived from a default can compare this rather than re-reading the key.
+     */
+    uint64_t revision() const;
+
+    struct SharedFile;
+
+  private:
+    template <typename T> T get(DefaultKey key, const T &valueIfMissing);
+    template <typename T> bool update(DefaultKey key, const T &value);
+    template <typename T> void setOverride(DefaultKey key, const T &value)
+    {
+        overrides[key] = value;
+        overrideRevision++;
+    }
+
+    std::shared_ptr<SharedFile> file;
+    std::atomic<uint64_t> overrideRevision{0};
+    std::map<DefaultKey, std::variant<std::string, int, std::pair<int, int>>> overrides;
+    errorReporter_t errorReporter;
+};
 
 /**
  * getUserDefaultValue
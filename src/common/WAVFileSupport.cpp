@@ -44,10 +44,14 @@ bool four_chars(char *v, char a, char b, char c, char d)
     return v[0] == a && v[1] == b && v[2] == c && v[3] == d;
 }
 
-bool SurgeStorage::load_wt_wav_portable(std::string fn, Wavetable *wt)
+bool SurgeStorage::load_wt_wav_portable(std::string fn, Wavetable *wt, int headWindows,
+                                        bool *headOnly)
 {
     std::string uitag = "Wavetable Import Error";
 
+    if (headOnly)
+        *headOnly = false;
+
 #if WAV_STDOUT_INFO
     std::cout << "Loading wt_wav_portable" << std::endl;
     std::cout << "  fn = '" << fn << "'" << std::endl;
@@ -475,6 +479,15 @@ bool SurgeStorage::load_wt_wav_portable(std::string fn, Wavetable *wt)
 
         wh.n_samples = windowSize;
         wh.n_tables = (int)(sample_length / windowSize);
+
+        // only worth doing in two goes if the rest is a good deal more than the head
+        if (headWindows > 0 && wh.n_tables > 2 * headWindows)
+        {
+            wh.n_tables = headWindows;
+
+            if (headOnly)
+                *headOnly = true;
+        }
     }
 
     int channels = 1;
@@ -544,6 +557,134 @@ bool SurgeStorage::load_wt_wav_portable(std::string fn, Wavetable *wt)
     return true;
 }
 
+bool SurgeStorage::load_ir_wav(const fs::path &path, std::vector<float> &left,
+                               std::vector<float> &right, float &sampleRate)
+{
+    std::string uitag = "Impulse Response Import Error";
+
+    left.clear();
+    right.clear();
+
+    std::filebuf fp;
+
+    if (!fp.open(path, std::ios::binary | std::ios::in))
+    {
+        reportError("Unable to open file '" + path_to_string(path) + "'!", uitag);
+        return false;
+    }
+
+    char riff[4], szd[4], wav[4];
+    auto hds = fp.sgetn(riff, sizeof(riff));
+
+    hds += fp.sgetn(szd, sizeof(szd));
+    hds += fp.sgetn(wav, sizeof(wav));
+
+    if (hds != 12 || !four_chars(riff, 'R', 'I', 'F', 'F') || !four_chars(wav, 'W', 'A', 'V', 'E'))
+    {
+        reportError("'" + path_to_string(path) + "' is not a standard RIFF/WAVE file.", uitag);
+        return false;
+    }
+
+    unsigned short audioFormat{0}, numChannels{0}, bitsPerSample{0};
+    std::vector<char> data;
+
+    while (true)
+    {
+        char chunkType[4], chunkSzD[4];
+
+        if (fp.sgetn(chunkType, sizeof(chunkType)) != sizeof(chunkType) ||
+            fp.sgetn(chunkSzD, sizeof(chunkSzD)) != sizeof(chunkSzD))
+        {
+            break;
+        }
+
+        int cs = pl_int(chunkSzD);
+
+        // RIFF requires all chunks to be in 2 byte sizes
+        if (cs % 2 == 1)
+            cs = cs + 1;
+
+        std::vector<char> chunk(cs);
+
+        if (fp.sgetn(chunk.data(), cs) != cs)
+        {
+            // plenty of writers leave off the pad byte on the last chunk
+            if (!four_chars(chunkType, 'd', 'a', 't', 'a'))
+                break;
+        }
+
+        if (four_chars(chunkType, 'f', 'm', 't', ' ') && cs >= 16)
+        {
+            audioFormat = pl_short(chunk.data());
+            numChannels = pl_short(chunk.data() + 2);
+            sampleRate = (float)pl_int(chunk.data() + 4);
+            bitsPerSample = pl_short(chunk.data() + 14);
+
+            // WAVE_FORMAT_EXTENSIBLE keeps the real format at the start of its subformat GUID
+            if (audioFormat == 0xFFFE && cs >= 26)
+                audioFormat = pl_short(chunk.data() + 24);
+        }
+        else if (four_chars(chunkType, 'd', 'a', 't', 'a'))
+        {
+            data = std::move(chunk);
+        }
+    }
+
+    bool supported = (audioFormat == 1 /* WAVE_FORMAT_PCM */ &&
+                      (bitsPerSample == 16 || bitsPerSample == 24)) ||
+                     (audioFormat == 3 /* IEEE_FLOAT */ && bitsPerSample == 32);
+
+    if (!supported || numChannels == 0 || data.empty())
+    {
+        std::ostringstream oss;
+        oss << "Surge XT only supports 16 or 24-bit PCM or 32-bit float impulse responses. '"
+            << path_to_string(path) << "' is a " << bitsPerSample << "-bit " << numChannels
+            << "-channel file.";
+        reportError(oss.str(), uitag);
+        return false;
+    }
+
+    // anything past the first two channels is ignored
+    auto bytesPerSample = bitsPerSample / 8;
+    auto frames = data.size() / (bytesPerSample * numChannels);
+    auto channels = std::min((int)numChannels, 2);
+
+    left.resize(frames);
+
+    if (channels == 2)
+        right.resize(frames);
+
+    for (size_t f = 0; f < frames; ++f)
+    {
+        for (int c = 0; c < channels; ++c)
+        {
+            auto *d = data.data() + (f * numChannels + c) * bytesPerSample;
+            float v;
+
+            if (audioFormat == 3)
+            {
+                uint32_t bits = pl_int(d);
+                memcpy(&v, &bits, sizeof(v));
+            }
+            else if (bitsPerSample == 24)
+            {
+                int32_t i = (int32_t)(((uint32_t)(unsigned char)d[0] << 8) |
+                                      ((uint32_t)(unsigned char)d[1] << 16) |
+                                      ((uint32_t)(unsigned char)d[2] << 24));
+                v = (float)(i >> 8) / 8388608.f;
+            }
+            else
+            {
+                v = (float)(int16_t)pl_short(d) / 32768.f;
+            }
+
+            (c == 0 ? left : right)[f] = v;
+        }
+    }
+
+    return true;
+}
+
 std::string SurgeStorage::export_wt_wav_portable(std::string fbase, Wavetable *wt)
 {
     auto path = userDataPath / "Wavetables" / "Exported";
@@ -0,0 +1,288 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "WavetableDiskCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <tuple>
+#include <vector>
+
+#include "Wavetable.h"
+#include "SurgeStorage.h"
+
+namespace Surge
+{
+namespace Storage
+{
+// tables smaller than this rebuild quickly enough that a cache file isn't worth it
+static constexpr size_t minCachedSamples = 64 * 1024;
+
+// bump this if the layout of a built Wavetable changes
+static constexpr uint32_t cacheVersion = 1;
+
+#pragma pack(push, 1)
+struct CacheHeader
+{
+    char tag[4];           // 'wtmc'
+    uint32_t version;      // cacheVersion
+    uint32_t headerBytes;  // sizeof(CacheHeader), as a cheap check of the layout
+    uint32_t byteOrder;    // 0x01020304 as written
+    uint64_t keyHash, keySize;
+    int32_t size, n_tables, size_po2, flags;
+    float dt;
+    uint64_t dataSizes;
+};
+#pragma pack(pop)
+
+// the offsets of the weak pointers into the data blocks, or -1 for null
+typedef int32_t offsets_t[max_mipmap_levels][max_subtables];
+
+static size_t expectedFileSize(uint64_t dataSizes)
+{
+    return sizeof(CacheHeader) + 2 * sizeof(offsets_t) + dataSizes * (sizeof(float) + sizeof(short));
+}
+
+// whether a table at this mipmap level, starting at offset, lies wholly inside the data
+static bool tableFits(int64_t offset, int level, int size, int padding, uint64_t dataSizes)
+{
+    return offset >= 0 && offset + (size >> level) + padding <= (int64_t)dataSizes;
+}
+
+fs::path WavetableDiskCache::pathFor(const key_t &key) const
+{
+    char fn[64];
+    snprintf(fn, sizeof(fn), "%016llx-%llx.wtcache", (unsigned long long)key.first,
+             (unsigned long long)key.second);
+    return dir / fn;
+}
+
+bool WavetableDiskCache::isWorthCaching(const Wavetable &wt)
+{
+    return wt.everBuilt && (size_t)wt.size * wt.n_tables >= minCachedSamples;
+}
+
+bool WavetableDiskCache::load(const key_t &key, Wavetable &wt)
+{
+    auto p = pathFor(key);
+
+    std::error_code ec;
+    auto fsz = fs::file_size(p, ec);
+    if (ec)
+    {
+        misses++;
+        return false;
+    }
+
+    std::ifstream in(p, std::ios::binary);
+    CacheHeader h;
+
+    if (!in.read((char *)&h, sizeof(h)) || memcmp(h.tag, "wtmc", 4) != 0 ||
+        h.version != cacheVersion || h.headerBytes != sizeof(CacheHeader) ||
+        h.byteOrder != 0x01020304 || h.keyHash != key.first || h.keySize != key.second ||
+        h.size <= 0 || h.size > max_wtable_size || h.n_tables <= 0 ||
+        h.n_tables > max_subtables + 3 || h.dataSizes > fsz ||
+        fsz != expectedFileSize(h.dataSizes))
+    {
+        misses++;
+        return false;
+    }
+
+    std::vector<int32_t> offsets(2 * max_mipmap_levels * max_subtables);
+    if (!in.read((char *)offsets.data(), offsets.size() * sizeof(int32_t)))
+    {
+        misses++;
+        return false;
+    }
+
+    auto oF32 = offsets.data(), oI16 = offsets.data() + max_mipmap_levels * max_subtables;
+    for (int i = 0; i < max_mipmap_levels; ++i)
+    {
+        for (int j = 0; j < max_subtables; ++j)
+        {
+            auto f = oF32[i * max_subtables + j], s = oI16[i * max_subtables + j];
+
+            if ((f != -1 && !tableFits(f, i, h.size, 0, h.dataSizes)) ||
+                (s != -1 && !tableFits(s, i, h.size, FIRipolI16_N, h.dataSizes)))
+            {
+                misses++;
+                return false;
+            }
+        }
+    }
+
+    // never read into a block we are sharing with someone else
+    if (wt.hasSharedTables() || wt.dataSizes < h.dataSizes)
+        wt.allocPointers(h.dataSizes);
+
+    if (!in.read((char *)wt.TableF32Data, h.dataSizes * sizeof(float)) ||
+        !in.read((char *)wt.TableI16Data, h.dataSizes * sizeof(short)))
+    {
+        wt.everBuilt = false;
+        misses++;
+        return false;
+    }
+
+    wt.size = h.size;
+    wt.n_tables = h.n_tables;
+    wt.size_po2 = h.size_po2;
+    wt.flags = h.flags;
+    wt.dt = h.dt;
+
+    for (int i = 0; i < max_mipmap_levels; ++i)
+    {
+        for (int j = 0; j < max_subtables; ++j)
+        {
+            auto f = oF32[i * max_subtables + j], s = oI16[i * max_subtables + j];
+            wt.TableF32WeakPointers[i][j] = f < 0 ? nullptr : wt.TableF32Data + f;
+            wt.TableI16WeakPointers[i][j] = s < 0 ? nullptr : wt.TableI16Data + s;
+        }
+    }
+
+    wt.everBuilt = true;
+    wt.markDataChanged();
+    hits++;
+
+    in.close();
+    fs::last_write_time(p, fs::file_time_type::clock::now(), ec);
+
+    return true;
+}
+
+bool WavetableDiskCache::store(const key_t &key, const Wavetable &wt)
+{
+    if (!isWorthCaching(wt))
+        return false;
+
+    CacheHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.tag, "wtmc", 4);
+    h.version = cacheVersion;
+    h.headerBytes = sizeof(CacheHeader);
+    h.byteOrder = 0x01020304;
+    h.keyHash = key.first;
+    h.keySize = key.second;
+    h.size = wt.size;
+    h.n_tables = wt.n_tables;
+    h.size_po2 = wt.size_po2;
+    h.flags = wt.flags;
+    h.dt = wt.dt;
+    h.dataSizes = wt.dataSizes;
+
+    std::vector<int32_t> offsets(2 * max_mipmap_levels * max_subtables);
+    auto oF32 = offsets.data(), oI16 = offsets.data() + max_mipmap_levels * max_subtables;
+    for (int i = 0; i < max_mipmap_levels; ++i)
+    {
+        for (int j = 0; j < max_subtables; ++j)
+        {
+            auto f = wt.TableF32WeakPointers[i][j];
+            auto s = wt.TableI16WeakPointers[i][j];
+
+            // stale pointers reaching past the data (BuildWT doesn't clear them) aren't kept,
+            // since load would turn the file away
+            bool fok = f && tableFits(f - wt.TableF32Data, i, wt.size, 0, wt.dataSizes);
+            bool sok =
+                s && tableFits(s - wt.TableI16Data, i, wt.size, FIRipolI16_N, wt.dataSizes);
+            oF32[i * max_subtables + j] = fok ? (int32_t)(f - wt.TableF32Data) : -1;
+            oI16[i * max_subtables + j] = sok ? (int32_t)(s - wt.TableI16Data) : -1;
+        }
+    }
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+        return false;
+
+    // write to the side and rename, so another instance never reads a half written file
+    auto p = pathFor(key);
+    auto tmp = p;
+    tmp += ".tmp";
+
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write((const char *)&h, sizeof(h));
+        out.write((const char *)offsets.data(), offsets.size() * sizeof(int32_t));
+        out.write((const char *)wt.TableF32Data, wt.dataSizes * sizeof(float));
+        out.write((const char *)wt.TableI16Data, wt.dataSizes * sizeof(short));
+
+        if (!out)
+        {
+            out.close();
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+
+    fs::rename(tmp, p, ec);
+    if (ec)
+    {
+        fs::remove(tmp, ec);
+        return false;
+    }
+
+    prune();
+
+    return true;
+}
+
+void WavetableDiskCache::prune()
+{
+    std::vector<std::tuple<fs::file_time_type, uintmax_t, fs::path>> entries;
+    uintmax_t total = 0;
+    std::error_code ec;
+
+    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator();
+         it.increment(ec))
+    {
+        auto p = it->path();
+        if (p.extension() != ".wtcache")
+            continue;
+
+        std::error_code fec;
+        auto sz = fs::file_size(p, fec);
+        auto t = fs::last_write_time(p, fec);
+        if (fec)
+            continue;
+
+        entries.emplace_back(t, sz, p);
+        total += sz;
+    }
+
+    if (total <= maxBytes)
+        return;
+
+    // oldest first
+    std::sort(entries.begin(), entries.end());
+
+    for (auto &[t, sz, p] : entries)
+    {
+        if (total <= maxBytes)
+            break;
+
+        if (fs::remove(p, ec))
+            total -= sz;
+    }
+}
+} // namespace Storage
+} // namespace Surge
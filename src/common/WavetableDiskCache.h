@@ -0,0 +1,80 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_WAVETABLEDISKCACHE_H
+#define SURGE_SRC_COMMON_WAVETABLEDISKCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "filesystem/import.h"
+
+class Wavetable;
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * Built wavetables, mipmaps and all, saved to a cache directory so that loading a large table
+ * a second time is a single read instead of a rebuild. Entries are named by the same content
+ * key as the in memory SharedStorageCore cache, so an edited source file just misses.
+ *
+ * The files are in native byte order and layout and are only meant for the machine which
+ * wrote them; anything which doesn't match exactly is ignored and rebuilt. Only tables worth
+ * the disk space (see isWorthCaching) are stored, and once the directory grows past maxBytes
+ * the least recently used entries are deleted. A hit touches its file, so the modification
+ * time is the last use.
+ */
+struct WavetableDiskCache
+{
+    typedef std::pair<uint64_t, size_t> key_t;
+
+    static constexpr uintmax_t defaultMaxBytes{512u << 20};
+
+    explicit WavetableDiskCache(const fs::path &dir, uintmax_t maxBytes = defaultMaxBytes)
+        : dir(dir), maxBytes(maxBytes)
+    {
+    }
+
+    bool load(const key_t &key, Wavetable &wt);
+    bool store(const key_t &key, const Wavetable &wt);
+
+    static bool isWorthCaching(const Wavetable &wt);
+
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+
+  private:
+    fs::path pathFor(const key_t &key) const;
+    void prune();
+
+    fs::path dir;
+    uintmax_t maxBytes;
+    std::atomic<int> hits{0}, misses{0};
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_WAVETABLEDISKCACHE_H
@@ -0,0 +1,360 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "WavetableLoader.h"
+#include "RenderWorkerPool.h"
+#include "WavetableScriptEvaluator.h"
+#include <algorithm>
+#include <chrono>
+
+namespace Surge
+{
+namespace Storage
+{
+WavetableLoader::WavetableLoader(SurgeStorage *s) : storage(s)
+{
+    for (auto &sc : slots)
+        for (auto &sl : sc)
+            sl.staged = std::make_unique<Wavetable>();
+
+    workerThread = std::thread([this]() { workerLoop(); });
+}
+
+WavetableLoader::~WavetableLoader()
+{
+    keepRunning = false;
+    workerCV.notify_all();
+    if (workerThread.joinable())
+        workerThread.join();
+}
+
+bool WavetableLoader::processQueuedLoads()
+{
+    auto &patch = storage->getPatch();
+    bool changed = false, wakeWorker = false;
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        for (int o = 0; o < n_oscs; ++o)
+        {
+            auto &slot = slots[sc][o];
+            auto &osc = patch.scene[sc].osc[o];
+
+            if (slot.state == READY && handOver(slot, osc))
+            {
+                // the editor watches this to know the table has actually landed
+                if (slot.scripted)
+                    slot.scriptGenerating = false;
+
+                slot.state = IDLE;
+                changed = true;
+
+                if (slot.tailPending)
+                {
+                    bool superseded = osc.wt.queue_id != -1 || osc.wt.queue_filename[0];
+                    if (!superseded)
+                    {
+                        slot.state = REQUESTED;
+                        wakeWorker = true;
+                    }
+                    else
+                    {
+                        slot.tailPending = false;
+                    }
+                }
+            }
+
+            if (slot.state != IDLE)
+                continue;
+
+            if (osc.wt.queue_id != -1)
+            {
+                slot.requestedId = osc.wt.queue_id;
+                slot.requestedFilename.clear();
+                slot.scripted = false;
+                osc.wt.queue_id = -1;
+                slot.state = REQUESTED;
+                wakeWorker = true;
+            }
+            else if (osc.wt.queue_filename[0])
+            {
+                if (!(uses_wavetabledata(osc.type.val.i)))
+                {
+                    osc.queue_type = ot_wavetable;
+                }
+
+                // swapping the strings rather than copying keeps the allocation off this thread
+                slot.requestedId = -1;
+                slot.requestedFilename.clear();
+                std::swap(slot.requestedFilename, osc.wt.queue_filename);
+                slot.scripted = false;
+                slot.state = REQUESTED;
+                wakeWorker = true;
+            }
+            else if (slot.scriptPending)
+            {
+                // the worker picks the script itself up from under the slot's script lock
+                slot.scripted = true;
+                slot.state = REQUESTED;
+                wakeWorker = true;
+            }
+        }
+    }
+
+    // We notify without holding the lock, so the worker also polls. See workerLoop.
+    if (wakeWorker)
+        workerCV.notify_one();
+
+    return changed;
+}
+
+bool WavetableLoader::hasOutstandingLoads() const
+{
+    for (const auto &sc : slots)
+        for (const auto &sl : sc)
+            if (sl.state != IDLE || sl.scriptPending)
+                return true;
+
+    return false;
+}
+
+bool WavetableLoader::handOver(Slot &slot, OscillatorStorage &osc)
+{
+    if (!slot.loaded)
+    {
+        // Failed loads have already been reported by the load path; leave the oscillator alone
+        return true;
+    }
+
+    // The UI reads wavetables under this lock. If it is busy, just try again next block.
+    if (!storage->waveTableDataMutex.try_lock())
+        return false;
+
+    // the rest of a sample replaces its own head, which isn't a change to the patch
+    if (osc.wt.everBuilt && !slot.loadingTail)
+        storage->getPatch().isDirty = true;
+
+    osc.wt.swapTablesWith(*slot.staged);
+    storage->waveTableDataMutex.unlock();
+
+    // a scripted table keeps whatever the oscillator said it was loaded from, as BuildWT did
+    if (!slot.scripted)
+    {
+        osc.wt.current_id = slot.requestedId;
+        std::swap(osc.wt.current_filename, slot.requestedFilename);
+    }
+
+    if (!slot.displayName.empty())
+        std::swap(osc.wavetable_display_name, slot.displayName);
+
+    osc.wt.refresh_display = true;
+
+    return true;
+}
+
+void WavetableLoader::loadIntoSlot(Slot &slot)
+{
+    auto wt = slot.staged.get();
+
+    // we are off the audio thread, so let the mipmap build use a few more cores
+    Surge::Threading::RenderWorkerPool pool(
+        std::max(1, (int)std::thread::hardware_concurrency() / 2 - 1));
+    Wavetable::MipMapPoolScope mipMapScope(&pool);
+
+    wt->everBuilt = false;
+    slot.loaded = false;
+    slot.displayName.clear();
+
+    // the second pass over a sample whose head has already been handed over
+    slot.loadingTail = slot.tailPending;
+    slot.tailPending = false;
+
+    if (slot.loadingTail)
+    {
+        slot.requestedId = slot.tailId;
+        slot.requestedFilename = slot.tailFilename;
+    }
+
+    auto headWindows = slot.loadingTail ? 0 : sampleHeadWindows;
+    bool headOnly = false;
+
+    if (slot.requestedId >= 0)
+    {
+        auto id = slot.requestedId;
+
+        if (id < storage->wt_list.size())
+        {
+            slot.displayName = storage->wt_list[id].name;
+            slot.requestedFilename = path_to_string(storage->wt_list[id].path);
+
+            storage->load_wt(slot.requestedFilename, wt, nullptr, headWindows, &headOnly);
+        }
+        else
+        {
+            storage->load_wt(id, wt, nullptr);
+
+            if (storage->wt_list.empty() && id == 0)
+            {
+                slot.displayName = "Sin to Saw";
+            }
+        }
+    }
+    else
+    {
+        int wtidx = -1, ct = 0;
+
+        for (const auto &wti : storage->wt_list)
+        {
+            if (path_to_string(wti.path) == slot.requestedFilename)
+            {
+                wtidx = ct;
+            }
+
+            ct++;
+        }
+
+        storage->load_wt(slot.requestedFilename, wt, nullptr, headWindows, &headOnly);
+
+        slot.requestedId = wtidx;
+        slot.displayName = path_to_string(string_to_path(slot.requestedFilename).stem());
+    }
+
+    slot.loaded = wt->everBuilt;
+
+    // handing over swaps the names away, so keep our own copy for the second pass
+    if (slot.loaded && headOnly)
+    {
+        slot.tailPending = true;
+        slot.tailId = slot.requestedId;
+        slot.tailFilename = slot.requestedFilename;
+    }
+}
+
+void WavetableLoader::requestScriptedTable(int scene, int osc, const std::string &script,
+                                           int resolution, int frames)
+{
+    auto &slot = slots[scene][osc];
+
+    {
+        std::lock_guard<std::mutex> g(slot.scriptMutex);
+        slot.pendingScript = {script, resolution, frames};
+        slot.scriptFramesDone = 0;
+        slot.scriptFramesTotal = frames;
+        slot.latestFrame.clear();
+    }
+
+    slot.scriptPending = true;
+}
+
+bool WavetableLoader::scriptedTableProgress(int scene, int osc, int &framesDone,
+                                            int &framesTotal, std::vector<float> &latestFrame)
+{
+    auto &slot = slots[scene][osc];
+
+    std::lock_guard<std::mutex> g(slot.scriptMutex);
+    framesDone = slot.scriptFramesDone;
+    framesTotal = slot.scriptFramesTotal;
+    latestFrame = slot.latestFrame;
+
+    return slot.scriptPending || slot.scriptGenerating;
+}
+
+void WavetableLoader::generateIntoSlot(Slot &slot)
+{
+    auto wt = slot.staged.get();
+
+    ScriptRequest req;
+    {
+        std::lock_guard<std::mutex> g(slot.scriptMutex);
+        std::swap(req, slot.pendingScript);
+        slot.scriptGenerating = true;
+        slot.scriptPending = false;
+    }
+
+    wt->everBuilt = false;
+    slot.loaded = false;
+    slot.loadingTail = false;
+    slot.displayName = "Scripted Wavetable";
+
+    wt_header wh;
+    float *wd = nullptr;
+    auto complete = Surge::WavetableScript::constructWavetable(
+        req.script, req.resolution, req.frames, wh, &wd,
+        [&slot](int frame, const float *data, int resolution) {
+            {
+                std::lock_guard<std::mutex> g(slot.scriptMutex);
+                slot.latestFrame.assign(data, data + resolution);
+                slot.scriptFramesDone = frame + 1;
+            }
+
+            // a newer script for this oscillator makes the rest of this one pointless
+            return !slot.scriptPending;
+        });
+
+    if (complete)
+    {
+        Surge::Threading::RenderWorkerPool pool(
+            std::max(1, (int)std::thread::hardware_concurrency() / 2 - 1));
+        Wavetable::MipMapPoolScope mipMapScope(&pool);
+
+        wt->BuildWT(wd, wh, wh.flags & wtf_is_sample);
+    }
+
+    delete[] wd;
+
+    slot.loaded = wt->everBuilt;
+}
+
+void WavetableLoader::workerLoop()
+{
+    while (keepRunning)
+    {
+        {
+            /*
+             * The audio thread can't take this lock, so a notify can race the wait. Time
+             * out periodically so a lost wakeup only costs us a few milliseconds.
+             */
+            std::unique_lock<std::mutex> lk(workerMutex);
+            workerCV.wait_for(lk, std::chrono::milliseconds(20));
+        }
+
+        for (auto &sc : slots)
+        {
+            for (auto &sl : sc)
+            {
+                int expected = REQUESTED;
+
+                if (sl.state.compare_exchange_strong(expected, LOADING))
+                {
+                    if (sl.scripted)
+                        generateIntoSlot(sl);
+                    else
+                        loadIntoSlot(sl);
+                    sl.state = READY;
+                }
+            }
+        }
+    }
+}
+
+} // namespace Storage
+} // namespace Surge
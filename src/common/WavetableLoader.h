@@ -0,0 +1,153 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_WAVETABLELOADER_H
+#define SURGE_SRC_COMMON_WAVETABLELOADER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SurgeStorage.h"
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * The WavetableLoader moves the file read, BuildWT and MipMapWT part of a
+ * queued wavetable load off the audio thread. There is one slot per scene/oscillator
+ * and each slot moves through a small state machine
+ *
+ *   IDLE -> REQUESTED (audio thread) -> LOADING (worker) -> READY (worker) -> IDLE (audio thread)
+ *
+ * The audio thread only ever flips atomics and swaps already-built tables into
+ * the oscillator storage, so it never allocates or touches the disk. The worker
+ * owns the staged wavetable between REQUESTED and READY. If a second request lands
+ * while a slot is busy, it simply stays in the oscillator's queue_id/queue_filename
+ * and is picked up once the slot returns to IDLE.
+ *
+ * Scripted wavetables from the wavetable editor follow the same path. The UI thread leaves
+ * the script in the slot, the audio thread moves the slot to REQUESTED when it is IDLE, and
+ * the worker evaluates the script a frame at a time, publishing each finished frame so the
+ * editor can preview the table as it is generated. *
+ * A long sample is loaded in two goes. The worker first builds just its opening windows and
+ * hands those over, so the oscillator can start playing it, and the slot then goes straight
+ * back to REQUESTED for the whole sample. The first windows are the same in both, so a voice
+ * already playing carries on into the rest when it lands. A newer request for the oscillator
+ * made in the meantime drops the second pass.
+ */
+struct WavetableLoader
+{
+    explicit WavetableLoader(SurgeStorage *s);
+    ~WavetableLoader();
+
+    enum SlotState
+    {
+        IDLE,
+        REQUESTED,
+        LOADING,
+        READY
+    };
+
+    /*
+     * Audio thread only. Picks up requests from the oscillator wavetable queue and hands
+     * finished tables over to the oscillators. Returns true if anything changed.
+     */
+    bool processQueuedLoads();
+
+    /*
+     * Is there anything in flight? Mostly useful for tests and offline renders which
+     * want to wait for loads to land.
+     */
+    bool hasOutstandingLoads() const;
+
+    // how many windows of a long sample are built before it is first handed over
+    static constexpr int sampleHeadWindows = 64;
+
+    /*
+     * UI thread. Generate the wavetable for this oscillator from a wavetable script. A newer
+     * request for the same oscillator cancels one which is still generating.
+     */
+    void requestScriptedTable(int scene, int osc, const std::string &script, int resolution,
+                              int frames);
+
+    /*
+     * UI thread. Returns false once no scripted table is pending or generating for this
+     * oscillator; otherwise reports how far along it is and copies out the most recently
+     * generated frame, which is empty until the first frame completes.
+     */
+    bool scriptedTableProgress(int scene, int osc, int &framesDone, int &framesTotal,
+                               std::vector<float> &latestFrame);
+
+  private:
+    struct ScriptRequest
+    {
+        std::string script;
+        int resolution{0}, frames{0};
+    };
+
+    struct Slot
+    {
+        std::atomic<int> state{IDLE};
+        int requestedId{-1};
+        std::string requestedFilename;
+        std::string displayName;
+        bool loaded{false};
+        bool scripted{false};
+
+        // set by the worker when it only built the head of a sample; what to load the rest of
+        bool tailPending{false}, loadingTail{false};
+        int tailId{-1};
+        std::string tailFilename;
+        std::unique_ptr<Wavetable> staged;
+
+        // the audio thread only ever reads scriptPending; the rest is under scriptMutex
+        std::mutex scriptMutex;
+        ScriptRequest pendingScript;
+        std::atomic<bool> scriptPending{false}, scriptGenerating{false};
+        std::atomic<int> scriptFramesDone{0}, scriptFramesTotal{0};
+        std::vector<float> latestFrame;
+    };
+
+    void workerLoop();
+    void loadIntoSlot(Slot &slot);
+    void generateIntoSlot(Slot &slot);
+    bool handOver(Slot &slot, OscillatorStorage &osc);
+
+    SurgeStorage *storage{nullptr};
+    std::array<std::array<Slot, n_oscs>, n_scenes> slots;
+
+    std::thread workerThread;
+    std::mutex workerMutex;
+    std::condition_variable workerCV;
+    std::atomic<bool> keepRunning{true};
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_WAVETABLELOADER_H
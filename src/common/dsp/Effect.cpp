@@ -24,6 +24,7 @@
 #include "ChorusEffectImpl.h"
 #include "CombulatorEffect.h"
 #include "ConditionerEffect.h"
+#include "ConvolutionEffect.h"
 #include "DistortionEffect.h"
 #include "DelayEffect.h"
 #include "FlangerEffect.h"
@@ -52,6 +53,13 @@
 
 using namespace std;
 
+template <typename T> Effect *spawnSized(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
+{
+    auto *fx = new T(storage, fxdata, pd);
+    fx->instanceBytes = sizeof(T);
+    return fx;
+}
+
 Effect *spawn_effect(int id, SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
 {
     // std::cout << "Spawn Effect " << _D(id) << std::endl;
@@ -59,63 +67,65 @@ Effect *spawn_effect(int id, SurgeStorage *storage, FxStorage *fxdata, pdata *pd
     switch (id)
     {
     case fxt_delay:
-        return new DelayEffect(storage, fxdata, pd);
+        return spawnSized<DelayEffect>(storage, fxdata, pd);
     case fxt_eq:
-        return new ParametricEQ3BandEffect(storage, fxdata, pd);
+        return spawnSized<ParametricEQ3BandEffect>(storage, fxdata, pd);
     case fxt_phaser:
-        return new PhaserEffect(storage, fxdata, pd);
+        return spawnSized<PhaserEffect>(storage, fxdata, pd);
     case fxt_rotaryspeaker:
-        return new RotarySpeakerEffect(storage, fxdata, pd);
+        return spawnSized<RotarySpeakerEffect>(storage, fxdata, pd);
     case fxt_distortion:
-        return new DistortionEffect(storage, fxdata, pd);
+        return spawnSized<DistortionEffect>(storage, fxdata, pd);
     case fxt_reverb:
-        return new Reverb1Effect(storage, fxdata, pd);
+        return spawnSized<Reverb1Effect>(storage, fxdata, pd);
     case fxt_reverb2:
-        return new Reverb2Effect(storage, fxdata, pd);
+        return spawnSized<Reverb2Effect>(storage, fxdata, pd);
     case fxt_freqshift:
-        return new FrequencyShifterEffect(storage, fxdata, pd);
+        return spawnSized<FrequencyShifterEffect>(storage, fxdata, pd);
     case fxt_conditioner:
-        return new ConditionerEffect(storage, fxdata, pd);
+        return spawnSized<ConditionerEffect>(storage, fxdata, pd);
     case fxt_chorus4:
-        return new ChorusEffect<4>(storage, fxdata, pd);
+        return spawnSized<ChorusEffect<4>>(storage, fxdata, pd);
     case fxt_vocoder:
-        return new VocoderEffect(storage, fxdata, pd);
+        return spawnSized<VocoderEffect>(storage, fxdata, pd);
     case fxt_flanger:
-        return new FlangerEffect(storage, fxdata, pd);
+        return spawnSized<FlangerEffect>(storage, fxdata, pd);
     case fxt_ringmod:
-        return new RingModulatorEffect(storage, fxdata, pd);
+        return spawnSized<RingModulatorEffect>(storage, fxdata, pd);
     case fxt_airwindows:
-        return new AirWindowsEffect(storage, fxdata, pd);
+        return spawnSized<AirWindowsEffect>(storage, fxdata, pd);
     case fxt_neuron:
-        return new chowdsp::NeuronEffect(storage, fxdata, pd);
+        return spawnSized<chowdsp::NeuronEffect>(storage, fxdata, pd);
     case fxt_geq11:
-        return new GraphicEQ11BandEffect(storage, fxdata, pd);
+        return spawnSized<GraphicEQ11BandEffect>(storage, fxdata, pd);
     case fxt_resonator:
-        return new ResonatorEffect(storage, fxdata, pd);
+        return spawnSized<ResonatorEffect>(storage, fxdata, pd);
     case fxt_combulator:
-        return new CombulatorEffect(storage, fxdata, pd);
+        return spawnSized<CombulatorEffect>(storage, fxdata, pd);
     case fxt_chow:
-        return new chowdsp::CHOWEffect(storage, fxdata, pd);
+        return spawnSized<chowdsp::CHOWEffect>(storage, fxdata, pd);
     case fxt_nimbus:
-        return new NimbusEffect(storage, fxdata, pd);
+        return spawnSized<NimbusEffect>(storage, fxdata, pd);
     case fxt_exciter:
-        return new chowdsp::ExciterEffect(storage, fxdata, pd);
+        return spawnSized<chowdsp::ExciterEffect>(storage, fxdata, pd);
     case fxt_tape:
-        return new chowdsp::TapeEffect(storage, fxdata, pd);
+        return spawnSized<chowdsp::TapeEffect>(storage, fxdata, pd);
     case fxt_ensemble:
-        return new BBDEnsembleEffect(storage, fxdata, pd);
+        return spawnSized<BBDEnsembleEffect>(storage, fxdata, pd);
     case fxt_treemonster:
-        return new TreemonsterEffect(storage, fxdata, pd);
+        return spawnSized<TreemonsterEffect>(storage, fxdata, pd);
     case fxt_waveshaper:
-        return new WaveShaperEffect(storage, fxdata, pd);
+        return spawnSized<WaveShaperEffect>(storage, fxdata, pd);
     case fxt_mstool:
-        return new MSToolEffect(storage, fxdata, pd);
+        return spawnSized<MSToolEffect>(storage, fxdata, pd);
     case fxt_spring_reverb:
-        return new chowdsp::SpringReverbEffect(storage, fxdata, pd);
+        return spawnSized<chowdsp::SpringReverbEffect>(storage, fxdata, pd);
     case fxt_bonsai:
-        return new BonsaiEffect(storage, fxdata, pd);
+        return spawnSized<BonsaiEffect>(storage, fxdata, pd);
     case fxt_audio_input:
-        return new AudioInputEffect(storage, fxdata, pd);
+        return spawnSized<AudioInputEffect>(storage, fxdata, pd);
+    case fxt_convolution:
+        return spawnSized<ConvolutionEffect>(storage, fxdata, pd);
     default:
         return 0;
     };
@@ -138,17 +148,59 @@ Effect::Effect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
     }
 }
 
+void Effect::rebindStorage(FxStorage *fxdata, pdata *pd)
+{
+    this->fxdata = fxdata;
+    this->pd = pd;
+
+    if (pd)
+    {
+        for (int i = 0; i < n_fx_params; i++)
+        {
+            pd_float[i] = &pd[fxdata->p[i].id].f;
+            pd_int[i] = &pd[fxdata->p[i].id].i;
+        }
+    }
+
+    resetParamChanges();
+}
+
 bool Effect::process_ringout(float *dataL, float *dataR, bool indata_present)
 {
     if (indata_present)
+    {
         ringout = 0;
+        silentTailBlocks = 0;
+    }
     else
         ringout++;
 
     int d = get_ringout_decay();
     if ((d < 0) || (ringout < d) || (ringout == 0))
     {
+        auto st = ringout > 0 ? get_silent_tail_blocks() : -1;
+
+        if (st >= 0 && silentTailBlocks > st)
+        {
+            process_only_control();
+            return false;
+        }
+
         process(dataL, dataR);
+
+        if (st >= 0)
+        {
+            float e = 0.f;
+
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+                e += dataL[i] * dataL[i] + dataR[i] * dataR[i];
+
+            if (e < 2.f * BLOCK_SIZE * silentTailLevel * silentTailLevel)
+                silentTailBlocks++;
+            else
+                silentTailBlocks = 0;
+        }
+
         return true;
     }
     else
@@ -156,6 +208,29 @@ bool Effect::process_ringout(float *dataL, float *dataR, bool indata_present)
     return false;
 }
 
+void Effect::updateParamChanges()
+{
+    // without a pdata there is nothing to compare against, so always recompute
+    if (!pd)
+    {
+        changedParams.set();
+        return;
+    }
+
+    bool all = !paramChangesPrimed || lastParamSampleRate != storage->samplerate;
+
+    for (int i = 0; i < n_fx_params; i++)
+    {
+        // comparing the bits covers both the float and int members of the union
+        auto bits = *pd_int[i];
+        changedParams[i] = all || bits != lastParamBits[i];
+        lastParamBits[i] = bits;
+    }
+
+    lastParamSampleRate = storage->samplerate;
+    paramChangesPrimed = true;
+}
+
 void Effect::init_ctrltypes()
 {
     for (int j = 0; j < n_fx_params; j++)
@@ -23,6 +23,8 @@
 #ifndef SURGE_SRC_COMMON_DSP_EFFECT_H
 #define SURGE_SRC_COMMON_DSP_EFFECT_H
 
+#include <bitset>
+
 #include "DSPUtils.h"
 #include "SurgeStorage.h"
 #include "lipol.h"
@@ -75,6 +77,19 @@ class alignas(16) Effect
     } // for controllers that should run regardless of the audioprocess
     virtual bool process_ringout(float *dataL, float *dataR,
                                  bool indata_present = true); // returns rtue if outdata is present
+
+    /*
+     * Effects whose tail only ever decays once the input stops, with no self oscillation or
+     * drive which can bring it back, may go to sleep as soon as their output has stayed below
+     * silentTailLevel for this many blocks, rather than running out get_ringout_decay(). The
+     * count has to cover the longest the effect can hold energy without any of it reaching
+     * the output, like a predelay. -1 means always run the whole ring out.
+     */
+    virtual int get_silent_tail_blocks() { return -1; }
+    static constexpr float silentTailLevel = 1e-6f; // -120 dB RMS
+
+    // samples by which the effect delays its whole output, which a host may compensate for
+    virtual int get_latency_samples() { return 0; }
     // virtual void processSSE(float *dataL, float *dataR){ return; }
     // virtual void processSSE2(float *dataL, float *dataR){ return; }
     // virtual void processSSE3(float *dataL, float *dataR){ return; }
@@ -82,6 +97,15 @@ class alignas(16) Effect
     virtual void suspend() { return; }
     float vu[KNumVuSlots]; // stereo pairs, just use every other when mono
 
+    /*
+     * When the engine runs short of CPU it may ask an effect to trade quality for speed.
+     * Effects which can do that override supportsReducedQuality and check reducedQuality
+     * as they process.
+     */
+    virtual bool supportsReducedQuality() const { return false; }
+    void setReducedQuality(bool b) { reducedQuality = b; }
+    bool isQualityReduced() const { return reducedQuality; }
+
     // Most of the fx read the sample rate at sample time but airwindows
     // keeps a cache so give loaded fx a notice when the sample rate changes
     virtual void sampleRateReset() {}
@@ -110,14 +134,48 @@ class alignas(16) Effect
     float *pd_float[n_fx_params];
     int *pd_int[n_fx_params];
 
+    // Point a running effect at other storage, as when reordering or crossfading the FX
+    void rebindStorage(FxStorage *fxdata, pdata *pd);
+
+    // sizeof the concrete effect, set by spawn_effect. Buffers it allocates itself aren't included
+    size_t getInstanceBytes() const { return instanceBytes; }
+
     friend struct surge::sstfx::SurgeFXConfig;
 
   protected:
+    /*
+     * Parameter change tracking for effects which only need to recompute something, like
+     * biquad coefficients, when the values it depends on move. Call updateParamChanges() once
+     * per control update and then ask paramChanged() about the slots you depend on. This looks
+     * at the modulated values in pd_float/pd_int, so modulation counts as a change. Every slot
+     * reads as changed on the first update, after resetParamChanges() and when the sample rate
+     * changes.
+     */
+    void updateParamChanges();
+    void resetParamChanges() { paramChangesPrimed = false; }
+    bool paramChanged(int i) const { return changedParams[i]; }
+    template <typename... Ids> bool anyParamChanged(Ids... ids) const
+    {
+        return (paramChanged(ids) || ...);
+    }
+
     SurgeStorage *storage;
     FxStorage *fxdata;
     pdata *pd;
     int ringout;
+    int silentTailBlocks{0};
     bool hasInvalidated{false};
+    bool reducedQuality{false};
+    size_t instanceBytes{0};
+
+    template <typename T>
+    friend Effect *spawnSized(SurgeStorage *storage, FxStorage *fxdata, pdata *pd);
+
+  private:
+    std::bitset<n_fx_params> changedParams;
+    int lastParamBits[n_fx_params]{};
+    float lastParamSampleRate{0.f};
+    bool paramChangesPrimed{false};
 };
 
 // Some common constants
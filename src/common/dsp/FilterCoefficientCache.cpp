@@ -0,0 +1,59 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#include "FilterCoefficientCache.h"
+#include "SurgeStorage.h"
+
+const float *FilterCoefficientCache::targetsFor(const Key &key, SurgeStorage *storage)
+{
+    useClock++;
+
+    Entry *oldest = &entries[0];
+    for (auto &e : entries)
+    {
+        if (e.lastUsed && e.key == key)
+        {
+            e.lastUsed = useClock;
+            hits++;
+            return e.targets;
+        }
+        if (e.lastUsed < oldest->lastUsed)
+            oldest = &e;
+    }
+
+    /*
+     * A maker's first MakeCoeffs lands its targets directly in C with no easing, so a fresh
+     * one gives us exactly the values a voice's maker would be easing towards.
+     */
+    sst::filters::FilterCoefficientMaker<SurgeStorage> maker;
+    maker.setSampleRateAndBlockSize(key.sampleRate, BLOCK_SIZE_OS);
+    maker.MakeCoeffs(key.cutoff, key.resonance, static_cast<sst::filters::FilterType>(key.type),
+                     static_cast<sst::filters::FilterSubType>(key.subtype), storage,
+                     key.extendRange);
+
+    oldest->key = key;
+    for (int i = 0; i < sst::filters::n_cm_coeffs; ++i)
+        oldest->targets[i] = maker.C[i];
+    oldest->lastUsed = useClock;
+    misses++;
+
+    return oldest->targets;
+}
@@ -0,0 +1,87 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#ifndef SURGE_SRC_COMMON_DSP_FILTERCOEFFICIENTCACHE_H
+#define SURGE_SRC_COMMON_DSP_FILTERCOEFFICIENTCACHE_H
+
+#include <cstdint>
+#include "sst/filters.h"
+
+class SurgeStorage;
+
+/*
+ * Settled filter coefficients for the last few filter settings the voices have asked for.
+ *
+ * FilterCoefficientMaker::MakeCoeffs does two things: it works out the coefficients a filter
+ * wants for a cutoff and resonance (often several pow, tan or exp calls), and it eases the
+ * running coefficients towards them with FromDirect. Voices playing an unmodulated filter ask
+ * for the same settings block after block, and every voice of a chord asks for the same ones,
+ * so SurgeVoice keeps the inputs it last used per unit and skips straight to FromDirect when
+ * they haven't moved, and fetches new targets from here when they have.
+ *
+ * Keys match exactly rather than by a quantized cutoff so the output is bit for bit what
+ * MakeCoeffs gives; unmodulated voices share exact values anyway. The tuning and sample rate
+ * are part of the key since the targets depend on both. Audio thread only.
+ */
+struct FilterCoefficientCache
+{
+    struct Key
+    {
+        float cutoff{0.f}, resonance{0.f};
+        int type{-1}, subtype{0};
+        bool extendRange{false};
+        float sampleRate{0.f};
+        uint64_t tuningUpdate{0};
+
+        bool operator==(const Key &o) const
+        {
+            return cutoff == o.cutoff && resonance == o.resonance && type == o.type &&
+                   subtype == o.subtype && extendRange == o.extendRange &&
+                   sampleRate == o.sampleRate && tuningUpdate == o.tuningUpdate;
+        }
+        bool operator!=(const Key &o) const { return !(*this == o); }
+    };
+
+    static constexpr int maxEntries = 16;
+
+    /*
+     * The coefficients MakeCoeffs would settle on for these settings, computed on a miss by
+     * evicting the least recently used entry. The pointer is valid until the next call.
+     */
+    const float *targetsFor(const Key &key, SurgeStorage *storage);
+
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+
+  private:
+    struct Entry
+    {
+        Key key;
+        float targets[sst::filters::n_cm_coeffs];
+        uint64_t lastUsed{0};
+    };
+
+    Entry entries[maxEntries];
+    uint64_t useClock{0};
+    int hits{0}, misses{0};
+};
+
+#endif // SURGE_SRC_COMMON_DSP_FILTERCOEFFICIENTCACHE_H
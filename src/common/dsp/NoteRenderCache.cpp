@@ -0,0 +1,205 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#include "NoteRenderCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+NoteRenderCache::NoteRenderCache(float samplerate)
+    : entries(maxEntries), arena(arenaSize),
+      recorderCapacity((int)(maxNoteSeconds * std::max(samplerate, 48000.f) * OSC_OVERSAMPLING))
+{
+    for (auto &sr : recorders)
+    {
+        sr.resize(recordersPerScene);
+
+        for (auto &r : sr)
+        {
+            InitQuadFilterChainStateToZero(&r.quad);
+            r.data[0].resize(recorderCapacity);
+            r.data[1].resize(recorderCapacity);
+        }
+    }
+}
+
+int NoteRenderCache::entryFor(uint64_t key)
+{
+    // open addressing with linear probing; entries are only ever removed all at once
+    auto start = (int)(key % maxEntries);
+
+    for (int i = 0; i < maxEntries; ++i)
+    {
+        auto idx = (start + i) % maxEntries;
+        auto &e = entries[idx];
+
+        if (!e.used)
+        {
+            e.used = true;
+            e.key = key;
+            return idx;
+        }
+
+        if (e.key == key)
+            return idx;
+    }
+
+    full = true;
+    return -1;
+}
+
+int NoteRenderCache::startRecording(int scene, int entry, int velocity, int skip)
+{
+    for (int i = 0; i < recordersPerScene; ++i)
+    {
+        auto &r = recorders[scene][i];
+
+        if (r.busy)
+            continue;
+
+        r.busy = true;
+        r.overflowed = false;
+        r.entry = entry;
+        r.velocity = velocity;
+        r.skip = skip;
+        r.length = 0;
+        return i;
+    }
+
+    return -1;
+}
+
+void NoteRenderCache::record(int scene, int ri, const float *L, const float *R)
+{
+    auto &r = recorders[scene][ri];
+    int from = std::min(r.skip, BLOCK_SIZE_OS);
+    int n = BLOCK_SIZE_OS - from;
+
+    r.skip -= from;
+
+    if (r.length + n > recorderCapacity)
+    {
+        r.overflowed = true;
+        return;
+    }
+
+    memcpy(&r.data[0][r.length], &L[from], n * sizeof(float));
+    memcpy(&r.data[1][r.length], &R[from], n * sizeof(float));
+    r.length += n;
+}
+
+void NoteRenderCache::finishRecording(int scene, int ri)
+{
+    auto &r = recorders[scene][ri];
+    auto &e = entries[r.entry];
+
+    r.busy = false;
+
+    if (r.overflowed)
+    {
+        e.state = es_uncacheable;
+        return;
+    }
+
+    switch (e.state)
+    {
+    case es_empty:
+    {
+        size_t n = r.length;
+
+        if (arenaUsed + 2 * n > arena.size())
+        {
+            full = true;
+            return;
+        }
+
+        e.offset = arenaUsed;
+        e.length = r.length;
+        e.velocity = r.velocity;
+        std::copy(r.data[0].begin(), r.data[0].begin() + n, arena.begin() + arenaUsed);
+        std::copy(r.data[1].begin(), r.data[1].begin() + n, arena.begin() + arenaUsed + n);
+        arenaUsed += 2 * n;
+        e.state = es_pending;
+        break;
+    }
+    case es_pending:
+        // a bucket can hold several velocities, but only the same one can confirm a recording
+        if (r.velocity == e.velocity)
+            e.state = matches(e, r) ? es_trusted : es_uncacheable;
+        break;
+    default:
+        break;
+    }
+}
+
+bool NoteRenderCache::matches(const Entry &e, const Recorder &r) const
+{
+    float peak = 0.f;
+
+    for (int c = 0; c < 2; ++c)
+        for (int i = 0; i < e.length; ++i)
+            peak = std::max(peak, std::fabs(arena[e.offset + c * e.length + i]));
+
+    auto tolerance = std::max(peak * 1e-3f, 1e-6f);
+    auto n = std::max(e.length, r.length);
+
+    for (int c = 0; c < 2; ++c)
+    {
+        auto stored = &arena[e.offset + c * e.length];
+
+        for (int i = 0; i < n; ++i)
+        {
+            auto a = i < e.length ? stored[i] : 0.f;
+            auto b = i < r.length ? r.data[c][i] : 0.f;
+
+            if (std::fabs(a - b) > tolerance)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool NoteRenderCache::isIdle() const
+{
+    if (activeReplays > 0)
+        return false;
+
+    for (auto &sr : recorders)
+        for (auto &r : sr)
+            if (r.busy)
+                return false;
+
+    return true;
+}
+
+void NoteRenderCache::clearIfFull()
+{
+    if (full && isIdle())
+        clear();
+}
+
+void NoteRenderCache::clear()
+{
+    std::fill(entries.begin(), entries.end(), Entry());
+    arenaUsed = 0;
+    full = false;
+}
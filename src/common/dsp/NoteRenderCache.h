@@ -0,0 +1,140 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#ifndef SURGE_SRC_COMMON_DSP_NOTERENDERCACHE_H
+#define SURGE_SRC_COMMON_DSP_NOTERENDERCACHE_H
+
+#include <cstdint>
+#include <vector>
+#include "globals.h"
+#include "QuadFilterChain.h"
+
+/*
+ * What one-shot notes added to their scene, kept so a later hit of the same note can replay
+ * it instead of rendering. Drum and percussion patches with no voice level randomness play
+ * the same audio every time a given key and velocity fires, so SurgeSynthesizer keys entries
+ * by a hash of everything the voice output depends on (see noteCacheKey there) and the cache
+ * only has to hold on to the audio.
+ *
+ * The first hit of a key records an entry, and the second hit records it again and compares,
+ * since a patch can be random in ways the key doesn't see (a free running oscillator phase,
+ * for instance). An entry whose two recordings agree to within -60 dB of its peak is trusted
+ * and replayed from then on, and one which doesn't is never recorded again.
+ *
+ * A recording captures a voice after the filter block, before the scene's halfband, hardclip
+ * and lowcut, so a replay goes into the scene exactly where the voice would have. The voice
+ * renders in a filter quad of its own while it records, which the recorders own here.
+ *
+ * Everything is allocated up front, since recording and replaying happen on the audio thread.
+ * Recorders belong to a scene and are written only while that scene renders; entries and the
+ * sample arena are written only between scene renders, by the audio thread.
+ */
+struct NoteRenderCache
+{
+    enum EntryState
+    {
+        es_empty,
+        es_pending,   // recorded once, waiting for a second recording to confirm it
+        es_trusted,   // replayed for every hit
+        es_uncacheable // the recordings disagreed, or the note was too long to keep
+    };
+
+    static constexpr int maxEntries = 4096;
+    static constexpr int recordersPerScene = 2;
+    static constexpr float maxNoteSeconds = 4.f;
+    // both channels of every recording, about 64 MB
+    static constexpr size_t arenaSize = 16 * 1024 * 1024;
+
+    explicit NoteRenderCache(float samplerate);
+
+    // The entry for a key, added if it is new. Returns -1 if the table is full.
+    int entryFor(uint64_t key);
+    EntryState stateOf(int entry) const { return entries[entry].state; }
+    int velocityOf(int entry) const { return entries[entry].velocity; }
+    int lengthOf(int entry) const { return entries[entry].length; }
+    const float *samplesOf(int entry, int channel) const
+    {
+        auto &e = entries[entry];
+        return &arena[e.offset + channel * e.length];
+    }
+    void markUncacheable(int entry) { entries[entry].state = es_uncacheable; }
+
+    void beginReplay()
+    {
+        activeReplays++;
+        replays++;
+    }
+    void endReplay() { activeReplays--; }
+
+    /*
+     * A free recorder of the scene for this entry, or -1. The first skip samples are left out,
+     * since a voice started partway into a block holds its output back by that much and the
+     * replay puts the offset of the new hit back in.
+     */
+    int startRecording(int scene, int entry, int velocity, int skip);
+    QuadFilterChainState &recorderQuad(int scene, int r) { return recorders[scene][r].quad; }
+    void record(int scene, int r, const float *L, const float *R);
+    bool recorderOverflowed(int scene, int r) const { return recorders[scene][r].overflowed; }
+    // store or check the recording, depending on its entry's state, and free the recorder
+    void finishRecording(int scene, int r);
+    void abandonRecording(int scene, int r) { recorders[scene][r].busy = false; }
+
+    /*
+     * Once the arena is full, new recordings are dropped until nothing is recording or
+     * replaying, at which point the next lookup starts the cache over.
+     */
+    bool isIdle() const;
+    void clearIfFull();
+
+    uint64_t getReplays() const { return replays; }
+
+  private:
+    struct Entry
+    {
+        uint64_t key{0};
+        bool used{false};
+        EntryState state{es_empty};
+        int velocity{-1}, length{0};
+        size_t offset{0};
+    };
+
+    struct Recorder
+    {
+        QuadFilterChainState quad;
+        bool busy{false}, overflowed{false};
+        int entry{-1}, velocity{0}, skip{0}, length{0};
+        std::vector<float> data[2];
+    };
+
+    bool matches(const Entry &e, const Recorder &r) const;
+    void clear();
+
+    std::vector<Entry> entries;
+    std::vector<float> arena;
+    size_t arenaUsed{0};
+    bool full{false};
+    std::vector<Recorder> recorders[n_scenes];
+    int recorderCapacity;
+    int activeReplays{0};
+    uint64_t replays{0};
+};
+
+#endif // SURGE_SRC_COMMON_DSP_NOTERENDERCACHE_H
@@ -21,6 +21,7 @@
  */
 #include "QuadFilterChain.h"
 #include "SurgeStorage.h"
+#include "TableWaveshapers.h"
 #include <vembertech/basic_dsp.h>
 #include <vembertech/portable_intrinsics.h>
 #include "sst/basic-blocks/mechanics/simd-ops.h"
@@ -60,6 +61,15 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
                                            // this in the code because it is assumed to be half
     const __m128 one = _mm_set1_ps(1.0f);
 
+    /*
+     * The kernels are opaque calls which get d's address, so anything read through d or g
+     * inside the loop is read again after every call. The unit pointers and the active mask
+     * hold for the whole block, so take them once here.
+     */
+    const auto fu1 = g.FU1ptr, fu2 = g.FU2ptr;
+    const auto ws = g.WSptr;
+    const __m128 mask = _mm_load_ps((float *)&d.FU[0].active);
+
     switch (config)
     {
     case fc_serial1: // no feedback at all  (saves CPU)
@@ -67,15 +77,14 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
         {
             __m128 input = d.DL[k];
             __m128 x = input, y = d.DR[k];
-            __m128 mask = _mm_load_ps((float *)&d.FU[0].active);
 
             if (A)
-                x = g.FU1ptr(&d.FU[0], x);
+                x = fu1(&d.FU[0], x);
             if (WS)
             {
                 d.wsLPF = _mm_mul_ps(hb_c, _mm_add_ps(d.wsLPF, _mm_and_ps(mask, x)));
                 d.Drive = _mm_add_ps(d.Drive, d.dDrive);
-                x = g.WSptr(&d.WSS[0], d.wsLPF, d.Drive);
+                x = ws(&d.WSS[0], d.wsLPF, d.Drive);
             }
 
             if (A || WS)
@@ -87,7 +96,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             y = _mm_add_ps(x, y);
 
             if (B)
-                y = g.FU2ptr(&d.FU[1], y);
+                y = fu2(&d.FU[1], y);
 
             d.Mix2 = _mm_add_ps(d.Mix2, d.dMix2);
             x = _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(one, d.Mix2)), _mm_mul_ps(y, d.Mix2));
@@ -104,16 +113,15 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             d.FB = _mm_add_ps(d.FB, d.dFB);
             __m128 input = vMul(d.FB, d.FBlineL);
             input = vAdd(d.DL[k], sdsp::softclip_ps(input));
-            __m128 mask = _mm_load_ps((float *)&d.FU[0].active);
             __m128 x = input, y = d.DR[k];
 
             if (A)
-                x = g.FU1ptr(&d.FU[0], x);
+                x = fu1(&d.FU[0], x);
             if (WS)
             {
                 d.wsLPF = _mm_mul_ps(hb_c, _mm_add_ps(d.wsLPF, _mm_and_ps(mask, x)));
                 d.Drive = _mm_add_ps(d.Drive, d.dDrive);
-                x = g.WSptr(&d.WSS[0], d.wsLPF, d.Drive);
+                x = ws(&d.WSS[0], d.wsLPF, d.Drive);
             }
 
             if (A || WS)
@@ -125,7 +133,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             y = _mm_add_ps(x, y);
 
             if (B)
-                y = g.FU2ptr(&d.FU[1], y);
+                y = fu2(&d.FU[1], y);
 
             d.Mix2 = _mm_add_ps(d.Mix2, d.dMix2);
             x = _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(one, d.Mix2)), _mm_mul_ps(y, d.Mix2));
@@ -145,15 +153,14 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             __m128 input = vMul(d.FB, d.FBlineL);
             input = vAdd(d.DL[k], sdsp::softclip_ps(input));
             __m128 x = input, y = d.DR[k];
-            __m128 mask = _mm_load_ps((float *)&d.FU[0].active);
 
             if (A)
-                x = g.FU1ptr(&d.FU[0], x);
+                x = fu1(&d.FU[0], x);
             if (WS)
             {
                 d.wsLPF = _mm_mul_ps(hb_c, _mm_add_ps(d.wsLPF, _mm_and_ps(mask, x)));
                 d.Drive = _mm_add_ps(d.Drive, d.dDrive);
-                x = g.WSptr(&d.WSS[0], d.wsLPF, d.Drive);
+                x = ws(&d.WSS[0], d.wsLPF, d.Drive);
             }
 
             if (A || WS)
@@ -171,7 +178,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
                 y = _mm_add_ps(x, y);
 
             if (B)
-                y = g.FU2ptr(&d.FU[1], y);
+                y = fu2(&d.FU[1], y);
 
             d.Mix2 = _mm_add_ps(d.Mix2, d.dMix2);
             x = _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(one, d.Mix2)), _mm_mul_ps(y, d.Mix2));
@@ -187,12 +194,11 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             fb = sdsp::softclip_ps(fb);
             __m128 x = _mm_add_ps(d.DL[k], fb);
             __m128 y = _mm_add_ps(d.DR[k], fb);
-            __m128 mask = _mm_load_ps((float *)&d.FU[0].active);
 
             if (A)
-                x = g.FU1ptr(&d.FU[0], x);
+                x = fu1(&d.FU[0], x);
             if (B)
-                y = g.FU2ptr(&d.FU[1], y);
+                y = fu2(&d.FU[1], y);
 
             d.Mix1 = _mm_add_ps(d.Mix1, d.dMix1);
             d.Mix2 = _mm_add_ps(d.Mix2, d.dMix2);
@@ -202,7 +208,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             {
                 d.wsLPF = _mm_mul_ps(hb_c, _mm_add_ps(d.wsLPF, _mm_and_ps(mask, x)));
                 d.Drive = _mm_add_ps(d.Drive, d.dDrive);
-                x = g.WSptr(&d.WSS[0], d.wsLPF, d.Drive);
+                x = ws(&d.WSS[0], d.wsLPF, d.Drive);
             }
 
             d.Gain = _mm_add_ps(d.Gain, d.dGain);
@@ -220,19 +226,18 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             fb = sdsp::softclip_ps(fb);
             __m128 x = _mm_add_ps(d.DL[k], fb);
             __m128 y = _mm_add_ps(d.DR[k], fb);
-            __m128 mask = _mm_load_ps((float *)&d.FU[0].active);
 
             if (A)
-                x = g.FU1ptr(&d.FU[0], x);
+                x = fu1(&d.FU[0], x);
             if (WS)
             {
                 d.wsLPF = _mm_mul_ps(hb_c, _mm_add_ps(d.wsLPF, _mm_and_ps(mask, x)));
                 d.Drive = _mm_add_ps(d.Drive, d.dDrive);
-                x = g.WSptr(&d.WSS[0], d.wsLPF, d.Drive);
+                x = ws(&d.WSS[0], d.wsLPF, d.Drive);
             }
 
             if (B)
-                y = g.FU2ptr(&d.FU[1], y);
+                y = fu2(&d.FU[1], y);
 
             d.Mix1 = _mm_add_ps(d.Mix1, d.dMix1);
             d.Mix2 = _mm_add_ps(d.Mix2, d.dMix2);
@@ -253,12 +258,11 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             fb = sdsp::softclip_ps(fb);
             __m128 x = _mm_add_ps(d.DL[k], fb);
             __m128 y = _mm_add_ps(d.DR[k], fb);
-            __m128 mask = _mm_load_ps((float *)&d.FU[0].active);
 
             if (A)
-                x = g.FU1ptr(&d.FU[0], x);
+                x = fu1(&d.FU[0], x);
             if (B)
-                y = g.FU2ptr(&d.FU[1], y);
+                y = fu2(&d.FU[1], y);
 
             d.Mix1 = _mm_add_ps(d.Mix1, d.dMix1);
             d.Mix2 = _mm_add_ps(d.Mix2, d.dMix2);
@@ -271,7 +275,7 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             {
                 d.wsLPF = _mm_mul_ps(hb_c, _mm_add_ps(d.wsLPF, x));
                 d.Drive = _mm_add_ps(d.Drive, d.dDrive);
-                x = g.WSptr(&d.WSS[0], _mm_and_ps(mask, d.wsLPF), d.Drive);
+                x = ws(&d.WSS[0], _mm_and_ps(mask, d.wsLPF), d.Drive);
             }
 
             d.Gain = _mm_add_ps(d.Gain, d.dGain);
@@ -289,18 +293,17 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             fb = sdsp::softclip_ps(fb);
             __m128 x = _mm_add_ps(d.DL[k], fb);
             __m128 y = _mm_add_ps(d.DR[k], fb);
-            __m128 mask = _mm_load_ps((float *)&d.FU[0].active);
 
             if (A)
-                x = g.FU1ptr(&d.FU[0], x);
+                x = fu1(&d.FU[0], x);
             if (B)
-                y = g.FU2ptr(&d.FU[1], y);
+                y = fu2(&d.FU[1], y);
 
             if (WS)
             {
                 d.Drive = _mm_add_ps(d.Drive, d.dDrive);
-                x = g.WSptr(&d.WSS[0], _mm_and_ps(mask, x), d.Drive);
-                y = g.WSptr(&d.WSS[1], _mm_and_ps(mask, y), d.Drive);
+                x = ws(&d.WSS[0], _mm_and_ps(mask, x), d.Drive);
+                y = ws(&d.WSS[1], _mm_and_ps(mask, y), d.Drive);
             }
 
             d.Mix1 = _mm_add_ps(d.Mix1, d.dMix1);
@@ -329,19 +332,18 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
             __m128 x = xin;
             __m128 y = yin;
 
-            __m128 mask = _mm_load_ps((float *)&d.FU[0].active);
 
             if (A)
             {
-                x = g.FU1ptr(&d.FU[0], x);
-                y = g.FU1ptr(&d.FU[2], y);
+                x = fu1(&d.FU[0], x);
+                y = fu1(&d.FU[2], y);
             }
 
             if (WS)
             {
                 d.Drive = _mm_add_ps(d.Drive, d.dDrive);
-                x = g.WSptr(&d.WSS[0], _mm_and_ps(mask, x), d.Drive);
-                y = g.WSptr(&d.WSS[1], _mm_and_ps(mask, y), d.Drive);
+                x = ws(&d.WSS[0], _mm_and_ps(mask, x), d.Drive);
+                y = ws(&d.WSS[1], _mm_and_ps(mask, y), d.Drive);
             }
 
             if (A || WS)
@@ -354,8 +356,8 @@ void ProcessFBQuad(QuadFilterChainState &d, fbq_global &g, float *OutL, float *O
 
             if (B)
             {
-                __m128 z = g.FU2ptr(&d.FU[1], x);
-                __m128 w = g.FU2ptr(&d.FU[3], y);
+                __m128 z = fu2(&d.FU[1], x);
+                __m128 w = fu2(&d.FU[3], y);
 
                 d.Mix2 = _mm_add_ps(d.Mix2, d.dMix2);
                 __m128 t = _mm_sub_ps(one, d.Mix2);
@@ -440,6 +442,37 @@ FBQFPtr GetFBQPointer(int config, bool A, bool WS, bool B)
     return 0;
 }
 
+void ResolvedFilterChain::update(const Settings &s)
+{
+    if (process && s == settings)
+        return;
+
+    using sst::filters::FilterType, sst::filters::FilterSubType;
+
+    auto unit = [](bool off, int type, int subtype) -> sst::filters::FilterUnitQFPtr {
+        if (off)
+            return nullptr;
+        return sst::filters::GetQFPtrFilterUnit(static_cast<FilterType>(type),
+                                                static_cast<FilterSubType>(subtype));
+    };
+
+    settings = s;
+    g.FU1ptr = unit(s.fu1Off, s.fu1Type, s.fu1Subtype);
+    g.FU2ptr = unit(s.fu2Off, s.fu2Type, s.fu2Subtype);
+    g.WSptr = nullptr;
+    if (!s.wsOff)
+    {
+        auto wst = static_cast<sst::waveshapers::WaveshaperType>(s.wsType);
+
+        if (s.wsEvaluation != SurgeStorage::WAVESHAPER_EXACT)
+            g.WSptr = Surge::DSP::GetTableQuadWaveshaper(
+                wst, s.wsEvaluation == SurgeStorage::WAVESHAPER_TABLE_ADAA);
+        if (!g.WSptr)
+            g.WSptr = sst::waveshapers::GetQuadWaveshaper(wst);
+    }
+    process = GetFBQPointer(s.blockConfig, g.FU1ptr != 0, g.WSptr != 0, g.FU2ptr != 0);
+}
+
 void InitQuadFilterChainStateToZero(QuadFilterChainState *Q)
 {
     Q->Gain = _mm_setzero_ps();
@@ -116,6 +116,17 @@
  *
  * Finally, the filter types, subtypes and names thereof are enumerated in SurgeStorage.h.
  *
+ * A note on width: it is tempting to run 8 or 16 voices per chain on AVX2 or AVX-512 machines.
+ * The lane count here is not ours to pick, though. FilterUnitQFPtr, QuadWaveshaperPtr and
+ * the FilterCoefficientMaker updateState all take a fixed __m128 (via SIMD_M128 so the ARM
+ * build shares the signature), and the coefficient and register layouts of every filter in
+ * sst-filters are 4 wide. A wider FBQ group would need those to be templated on the lane type
+ * first. On the Surge side it would then mean a QuadFilterChainState per width with GetFBQPointer
+ * choosing a chain at runtime from sst::plugininfra::cpufeatures, FBentry >> 3 or >> 4 indexing
+ * in SurgeSynthesizer::renderScene, and widening the set1f/get1f lane writes in SurgeVoice. Until
+ * then, the SSE path is the only one, and the cost of a full scene is spread across threads
+ * instead (see SurgeSynthesizer::setRenderVoicesInParallel).
+ *
  * There are a few more Surge filter functions - the Allpass BiquadFilter and VectorizedSVFFilter
  * are used by various FX in a different context and they don't follow this architecture. That code
  * is fairly clear, though.
@@ -158,4 +169,38 @@ typedef void (*FBQFPtr)(QuadFilterChainState &, fbq_global &, float *, float *);
 
 FBQFPtr GetFBQPointer(int config, bool A, bool WS, bool B);
 
+/*
+ * The unit pointers and chain function a scene's filter block runs with. Resolving them means
+ * a switch over filter types, subtypes and waveshapers plus the configuration, so the synth
+ * keeps one of these per scene and only resolves again when the settings it was resolved for
+ * change. The chain function is already specialized on configuration and on which units are
+ * present; the filter and waveshaper kernels themselves come from sst as plain pointers.
+ */
+struct ResolvedFilterChain
+{
+    struct Settings
+    {
+        int fu1Type{-1}, fu1Subtype{0}, fu2Type{-1}, fu2Subtype{0}, wsType{-1}, blockConfig{-1};
+        bool fu1Off{false}, fu2Off{false}, wsOff{false};
+        // a SurgeStorage::WaveshaperEvaluation; the table modes fall back to exact per shape
+        int wsEvaluation{0};
+
+        bool operator==(const Settings &o) const
+        {
+            return fu1Type == o.fu1Type && fu1Subtype == o.fu1Subtype && fu2Type == o.fu2Type &&
+                   fu2Subtype == o.fu2Subtype && wsType == o.wsType &&
+                   blockConfig == o.blockConfig && fu1Off == o.fu1Off && fu2Off == o.fu2Off &&
+                   wsOff == o.wsOff && wsEvaluation == o.wsEvaluation;
+        }
+        bool operator!=(const Settings &o) const { return !(*this == o); }
+    };
+
+    Settings settings;
+    fbq_global g{};
+    FBQFPtr process{nullptr};
+
+    // re-resolves only if these settings differ from the ones we hold
+    void update(const Settings &s);
+};
+
 #endif // SURGE_SRC_COMMON_DSP_QUADFILTERCHAIN_H
@@ -25,6 +25,7 @@
 #include "QuadFilterChain.h"
 #include "globals.h"
 #include <cmath>
+#include <algorithm>
 #ifndef SURGE_SKIP_ODDSOUND_MTS
 #include "libMTSClient.h"
 #endif
@@ -72,7 +73,8 @@ float SurgeVoiceState::getPitch(SurgeStorage *storage)
             key != keyRetuningForKey)
         {
             keyRetuningForKey = key;
-            keyRetuning = MTS_RetuningInSemitones(storage->oddsound_mts_client, key + mpeBend, 0);
+            int rk = (int)(key + mpeBend);
+            keyRetuning = storage->mtsNotePitch(rk, 0) - rk;
         }
         auto rkey = keyRetuning;
 
@@ -150,9 +152,20 @@ SurgeVoice::SurgeVoice(SurgeStorage *storage, SurgeSceneStorage *oscene, pdata *
     this->originating_host_key = host_key;
     this->originating_host_channel = host_chan;
     this->paramModulationCount = 0;
+    polyphonicParamModulationIndex.fill(-1);
     assert(storage);
     assert(oscene);
 
+    if (storage->seededRandom)
+    {
+        rng.seed(SurgeStorage::deriveRandomSeed(storage->randomSeed,
+                                                SurgeStorage::randomSeedVoiceStreams + voiceOrder -
+                                                    storage->randomSeedVoiceOrigin));
+        ownsRNG = true;
+    }
+
+    SurgeStorage::ScopedRNGOverride voiceRNG(ownsRNG ? &rng : nullptr);
+
     sampleRateReset();
 
     memcpy(localcopy, paramptr, sizeof(localcopy));
@@ -423,11 +436,7 @@ void SurgeVoice::retriggerPortaIfKeyChanged()
 #ifndef SURGE_SKIP_ODDSOUND_MTS
         if (storage->oddsound_mts_client && storage->oddsound_mts_active_as_client)
         {
-            v4k = [this](int k) {
-                return log2f(MTS_NoteToFrequency(storage->oddsound_mts_client, k, state.channel) /
-                             Tunings::MIDI_0_FREQ) *
-                       12;
-            };
+            v4k = [this](int k) { return storage->mtsNotePitch(k, state.channel); };
         }
 #endif
 
@@ -479,9 +488,9 @@ void SurgeVoice::switch_toggled()
     /*
      * Since we have updated the keytrack output here we need to re-update the localcopy modulators
      */
-    vector<ModulationRouting>::iterator iter;
-    iter = scene->modulation_voice.begin();
-    while (iter != scene->modulation_voice.end())
+    auto &voiceRouting = *storage->modRouting.voice[state.scene_id];
+    auto iter = voiceRouting.begin();
+    while (iter != voiceRouting.end())
     {
         int src_id = iter->source_id;
         int dst_id = iter->destination_id;
@@ -490,6 +499,7 @@ void SurgeVoice::switch_toggled()
         {
             localcopy[dst_id].f +=
                 depth * modsources[ms_keytrack]->get_output(0) * (1 - iter->muted);
+            markModulated(dst_id);
         }
         iter++;
     }
@@ -580,6 +590,8 @@ void SurgeVoice::switch_toggled()
         if ((scene->filterunit[u].type.val.i != FBP.FU[u].type) ||
             (scene->filterunit[u].subtype.val.i != FBP.FU[u].subtype))
         {
+            // bring the other units' registers home before we reset this one
+            evictFromQFB();
             memset(&FBP.FU[u], 0, sizeof(FBP.FU[u]));
             FBP.FU[u].type = scene->filterunit[u].type.val.i;
             FBP.FU[u].subtype = scene->filterunit[u].subtype.val.i;
@@ -598,6 +610,12 @@ void SurgeVoice::switch_toggled()
 
 void SurgeVoice::release()
 {
+    if (noteCacheRole != nc_live)
+    {
+        noteCacheReleasePending = true;
+        return;
+    }
+
     ampEGSource.release();
     filterEGSource.release();
 
@@ -695,26 +713,59 @@ int SurgeVoice::routefilter(int r)
     return r;
 }
 
-template <bool first> void SurgeVoice::calc_ctrldata(QuadFilterChainState *Q, int e)
+void SurgeVoice::processVoiceLFOs(Surge::Formula::BlockBatch *formulaBatch)
 {
+    for (int i = 0; i < n_lfos_voice; i++)
+        lfo[i].formulaShare = formulaShare;
+
     // Always process LFO1 so the gate retrigger always work
+    lfo[0].formulaBatch = formulaBatch;
     lfo[0].process_block();
+    lfo[0].formulaBatch = nullptr;
     velocitySource.process_block();
 
     for (int i = 0; i < n_lfos_voice; i++)
     {
+        // LFO1 has already run above, so its formula state has to be set up regardless
+        if (i != 0 && !scene->modsource_doprocess[ms_lfo1 + i])
+            continue;
+
         if (scene->lfo[i].shape.val.i == lt_formula)
         {
             Surge::Formula::setupEvaluatorStateFrom(lfo[i].formulastate, storage->getPatch());
             Surge::Formula::setupEvaluatorStateFrom(lfo[i].formulastate, this);
         }
 
-        if (i != 0 && scene->modsource_doprocess[ms_lfo1 + i])
+        if (i != 0)
         {
+            lfo[i].formulaBatch = formulaBatch;
             lfo[i].process_block();
+            lfo[i].formulaBatch = nullptr;
         }
     }
 
+    lfosProcessedAhead = formulaBatch != nullptr;
+}
+
+bool SurgeVoice::hasBlockFormulaLFOs() const
+{
+    for (int i = 0; i < n_lfos_voice; i++)
+    {
+        if (scene->lfo[i].shape.val.i == lt_formula && lfo[i].formulastate.hasBlockProcess)
+            return true;
+    }
+
+    return false;
+}
+
+template <bool first> void SurgeVoice::calc_ctrldata(QuadFilterChainState *Q, int e)
+{
+    // the synth may already have run our LFOs this block, to batch their formulas
+    if (!lfosProcessedAhead)
+        processVoiceLFOs(nullptr);
+
+    lfosProcessedAhead = false;
+
     for (int i = 0; i < n_lfos_voice; ++i)
     {
         if (lfo[i].retrigger_AEG)
@@ -735,14 +786,9 @@ template <bool first> void SurgeVoice::calc_ctrldata(QuadFilterChainState *Q, in
         state.keep_playing = false;
     }
 
-    // TODO: memcpy is bottleneck
-    // don't actually need to copy everything
-    // LFOs could be ignored when unused
-    // same for FX & OSCs
-    // also ignore integer parameters
-    memcpy(localcopy, paramptr, sizeof(localcopy));
+    refreshLocalcopy();
 
-    applyModulationToLocalcopy();
+    applyModulationToLocalcopy<false, !first>();
     update_portamento();
 
     if (state.porta_doretrigger)
@@ -964,6 +1010,8 @@ inline void all_ring_modes_block(float *__restrict src1_l, float *__restrict src
 
 bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
 {
+    SurgeStorage::ScopedRNGOverride voiceRNG(ownsRNG ? &rng : nullptr);
+
     calc_ctrldata<0>(&Q, Qe);
 
     bool is_wide = scene->filterblock_configuration.val.i == fc_wide;
@@ -979,6 +1027,19 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
     mech::clear_block<BLOCK_SIZE_OS>(output[0]);
     mech::clear_block<BLOCK_SIZE_OS>(output[1]);
 
+    /*
+     * If nothing we could render would be heard, feed the filters silence and keep only the
+     * envelopes and modulators running, so a held voice comes back when its gain does. A
+     * released voice whose gain can only keep falling is simply done.
+     */
+    if (inaudibleBlocks >= inaudibleBlocksBeforeFastPath)
+    {
+        if (!state.gate && !outputGainCanRise())
+            state.keep_playing = false;
+
+        return finishBlock(Q, Qe);
+    }
+
     for (int i = 0; i < n_oscs; ++i)
     {
         if (osc[i])
@@ -1200,6 +1261,34 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
     // pre-filter gain
     osclevels[le_pfg].multiply_2_blocks(output[0], output[1], BLOCK_SIZE_OS_QUAD);
 
+    return finishBlock(Q, Qe);
+}
+
+void SurgeVoice::setStartOffset(int offset)
+{
+    startOffset = limit_range(offset, 0, BLOCK_SIZE_OS - 1);
+
+    mech::clear_block<BLOCK_SIZE_OS>(startCarry[0]);
+    mech::clear_block<BLOCK_SIZE_OS>(startCarry[1]);
+}
+
+bool SurgeVoice::finishBlock(QuadFilterChainState &Q, int Qe)
+{
+    if (startOffset > 0)
+    {
+        auto held = BLOCK_SIZE_OS - startOffset;
+
+        for (int c = 0; c < 2; ++c)
+        {
+            float next alignas(16)[BLOCK_SIZE_OS];
+
+            memcpy(next, &output[c][held], startOffset * sizeof(float));
+            memmove(&output[c][startOffset], output[c], held * sizeof(float));
+            memcpy(output[c], startCarry[c], startOffset * sizeof(float));
+            memcpy(startCarry[c], next, startOffset * sizeof(float));
+        }
+    }
+
     for (int i = 0; i < BLOCK_SIZE_OS; i++)
     {
         _mm_store_ss(((float *)&Q.DL[i] + Qe), _mm_load_ss(&output[0][i]));
@@ -1214,25 +1303,107 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
     return state.keep_playing;
 }
 
-template <bool noLFOSources> void SurgeVoice::applyModulationToLocalcopy()
+bool SurgeVoice::outputGainCanRise() const
 {
-    vector<ModulationRouting>::iterator iter;
-    iter = scene->modulation_voice.begin();
-    while (iter != scene->modulation_voice.end())
+    // the step sequencer, MSEG and formula LFOs can retrigger the AEG out of its release
+    for (int i = 0; i < n_lfos_voice; ++i)
     {
-        int src_id = iter->source_id;
-        int dst_id = iter->destination_id;
-        float depth = iter->depth;
+        auto shape = scene->lfo[i].shape.val.i;
+
+        if (shape == lt_stepseq || shape == lt_mseg || shape == lt_formula)
+            return true;
+    }
 
-        if (noLFOSources && isLFO((::modsources)src_id))
+    auto modulatesGain = [this](const std::vector<ModulationRouting> &routing) {
+        for (const auto &r : routing)
         {
+            auto d = r.destination_id;
+
+            if (d == id_vca || d == id_vcavel || d == volume_id || d == pan_id || d == width_id)
+                return true;
         }
-        else if (modsources[src_id])
+
+        return false;
+    };
+
+    return modulatesGain(*storage->modRouting.voice[state.scene_id]) ||
+           modulatesGain(*storage->modRouting.scene[state.scene_id]);
+}
+
+void SurgeVoice::refreshLocalcopy()
+{
+    auto &patch = storage->getPatch();
+    auto sc = state.scene_id;
+    auto generation = patch.scenedataGeneration[sc];
+
+    if (!localcopySynced || localcopyGeneration + 1 != generation ||
+        paramptr != patch.scenedata[sc])
+    {
+        memcpy(localcopy, paramptr, sizeof(localcopy));
+    }
+    else
+    {
+        auto *changed = patch.scenedataChanged[sc];
+
+        for (int i = 0; i < patch.scenedataChangedCount[sc]; ++i)
+            localcopy[changed[i]] = paramptr[changed[i]];
+
+        for (int i = 0; i < modulatedParamCount; ++i)
+            localcopy[modulatedParams[i]] = paramptr[modulatedParams[i]];
+    }
+
+    localcopySynced = true;
+    localcopyGeneration = generation;
+    modulatedParamCount = 0;
+}
+
+template <bool noLFOSources, bool useCompiledRouting>
+void SurgeVoice::applyModulationToLocalcopy()
+{
+    auto &voiceRouting = *storage->modRouting.voice[state.scene_id];
+    auto iter = voiceRouting.begin();
+
+    if constexpr (noLFOSources || !useCompiledRouting)
+    {
+        while (iter != voiceRouting.end())
         {
-            localcopy[dst_id].f +=
-                depth * modsources[src_id]->get_output(iter->source_index) * (1.0 - iter->muted);
+            int src_id = iter->source_id;
+            int dst_id = iter->destination_id;
+            float depth = iter->depth;
+
+            if (!(noLFOSources && isLFO((::modsources)src_id)) && modsources[src_id])
+            {
+                localcopy[dst_id].f += depth * modsources[src_id]->get_output(iter->source_index) *
+                                       (1.0 - iter->muted);
+                markModulated(dst_id);
+            }
+            iter++;
+        }
+    }
+    else
+    {
+        auto &cr = storage->compiledVoiceRouting[state.scene_id];
+        int lastSource = -1, lastIndex = -1;
+        float output = 0.f;
+
+        for (int i = 0; i < cr.count; ++i)
+        {
+            auto src_id = cr.source[i];
+
+            if (!modsources[src_id])
+                continue;
+
+            // routes are sorted by source, so each output is only fetched once
+            if (src_id != lastSource || cr.sourceIndex[i] != lastIndex)
+            {
+                lastSource = src_id;
+                lastIndex = cr.sourceIndex[i];
+                output = modsources[src_id]->get_output(lastIndex);
+            }
+
+            localcopy[cr.destination[i]].f += cr.depth[i] * output;
+            markModulated(cr.destination[i]);
         }
-        iter++;
     }
 
     if (mpeEnabled)
@@ -1240,8 +1411,9 @@ template <bool noLFOSources> void SurgeVoice::applyModulationToLocalcopy()
         // See github issue 1214. This basically compensates for
         // channel AT being per-voice in MPE mode (since it is per channel)
         // vs per-scene (since it is per keyboard in non MPE mode).
-        iter = scene->modulation_scene.begin();
-        while (iter != scene->modulation_scene.end())
+        auto &sceneRouting = *storage->modRouting.scene[state.scene_id];
+        iter = sceneRouting.begin();
+        while (iter != sceneRouting.end())
         {
             int src_id = iter->source_id;
             if (src_id == ms_aftertouch && modsources[src_id])
@@ -1254,6 +1426,7 @@ template <bool noLFOSources> void SurgeVoice::applyModulationToLocalcopy()
                     float depth = iter->depth;
                     localcopy[dst_id].f +=
                         depth * modsources[src_id]->get_output(0) * (1.0 - iter->muted);
+                    markModulated(dst_id);
                 }
             }
             iter++;
@@ -1289,6 +1462,8 @@ template <bool noLFOSources> void SurgeVoice::applyModulationToLocalcopy()
     for (int i = 0; i < paramModulationCount; ++i)
     {
         auto &pc = polyphonicParamModulations[i];
+        markModulated(pc.param_id);
+
         switch (pc.vt_type)
         {
         case vt_float:
@@ -1327,8 +1502,22 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
 {
     using namespace sst::filters;
 
+    /*
+     * If only the filter configuration changed, the lane still holds our live registers laid
+     * out the old way. Bring them back into FBP while fbqResidentConfig still says how to read
+     * them, so the copy-in below starts the new configuration from them rather than stale FBP.
+     */
+    if (Q && fbqResident && Q == fbq && e == fbqi &&
+        fbqResidentConfig != scene->filterblock_configuration.val.i)
+        evictFromQFB();
+
+    bool resident = Q && fbqResident && Q == fbq && e == fbqi &&
+                    fbqResidentConfig == scene->filterblock_configuration.val.i;
+
     fbq = Q;
     fbqi = e;
+    fbqResident = resident;
+    fbqResidentConfig = scene->filterblock_configuration.val.i;
 
     float FMix1, FMix2;
     switch (scene->filterblock_configuration.val.i)
@@ -1354,6 +1543,17 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
                  modsources[ms_ampeg]->get_output(0);
     float FB = scene->feedback.get_extended(localcopy[id_feedback].f);
 
+    if (Q)
+    {
+        auto outGain = std::max(std::max(std::fabs(FBP.OutL), std::fabs(FBP.OutR)),
+                                std::max(std::fabs(FBP.Out2L), std::fabs(FBP.Out2R)));
+
+        if (Gain * outGain < inaudibleGain)
+            inaudibleBlocks++;
+        else
+            inaudibleBlocks = 0;
+    }
+
     if (!Q)
     {
         // We need to initialize the waveshaper registers
@@ -1378,9 +1578,12 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
 
         for (int c = 0; c < 2; ++c)
         {
-            for (int i = 0; i < sst::waveshapers::n_waveshaper_registers; ++i)
+            if (!resident)
             {
-                set1f(Q->WSS[c].R[i], e, FBP.WS[c].R[i]);
+                for (int i = 0; i < sst::waveshapers::n_waveshaper_registers; ++i)
+                {
+                    set1f(Q->WSS[c].R[i], e, FBP.WS[c].R[i]);
+                }
             }
             set1ui(Q->WSS[c].init, e, 0xFFFFFFFF);
         }
@@ -1395,9 +1598,12 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
     // filterunits
     if (Q)
     {
-        set1f(Q->wsLPF, e, FBP.wsLPF); // remember state
-        set1f(Q->FBlineL, e, FBP.FBlineL);
-        set1f(Q->FBlineR, e, FBP.FBlineR);
+        if (!resident)
+        {
+            set1f(Q->wsLPF, e, FBP.wsLPF); // remember state
+            set1f(Q->FBlineL, e, FBP.FBlineL);
+            set1f(Q->FBlineR, e, FBP.FBlineR);
+        }
         Q->FU[0].active[e] = 0xffffffff;
         Q->FU[1].active[e] = 0xffffffff;
         Q->FU[2].active[e] = 0xffffffff;
@@ -1413,24 +1619,43 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
         if (scene->f2_cutoff_is_offset.val.b)
             cutoffB += cutoffA;
 
-        CM[0].MakeCoeffs(cutoffA, localcopy[id_resoa].f,
-                         static_cast<FilterType>(scene->filterunit[0].type.val.i),
-                         static_cast<FilterSubType>(scene->filterunit[0].subtype.val.i), storage,
-                         scene->filterunit[0].cutoff.extend_range);
-        CM[1].MakeCoeffs(
-            cutoffB, scene->f2_link_resonance.val.b ? localcopy[id_resoa].f : localcopy[id_resob].f,
-            static_cast<FilterType>(scene->filterunit[1].type.val.i),
-            static_cast<FilterSubType>(scene->filterunit[1].subtype.val.i), storage,
-            scene->filterunit[1].cutoff.extend_range);
+        float cutoff[n_filterunits_per_scene] = {cutoffA, cutoffB};
+        float reso[n_filterunits_per_scene] = {
+            localcopy[id_resoa].f,
+            scene->f2_link_resonance.val.b ? localcopy[id_resoa].f : localcopy[id_resob].f};
+
+        for (int u = 0; u < n_filterunits_per_scene; u++)
+        {
+            FilterCoefficientCache::Key key;
+            key.cutoff = cutoff[u];
+            key.resonance = reso[u];
+            key.type = scene->filterunit[u].type.val.i;
+            key.subtype = scene->filterunit[u].subtype.val.i;
+            key.extendRange = scene->filterunit[u].cutoff.extend_range;
+            key.sampleRate = (float)storage->dsamplerate_os;
+            key.tuningUpdate = storage->tuningUpdates;
+
+            // unmoved settings ease towards the targets we already have
+            if (key != coeffKey[u])
+            {
+                auto targets = storage->filterCoefficientCache->targetsFor(key, storage);
+                std::copy(targets, targets + n_cm_coeffs, coeffTargets[u]);
+                coeffKey[u] = key;
+            }
+            CM[u].FromDirect(coeffTargets[u]);
+        }
 
         for (int u = 0; u < n_filterunits_per_scene; u++)
         {
             if (scene->filterunit[u].type.val.i != 0)
             {
                 CM[u].updateState(Q->FU[u], e);
-                for (int i = 0; i < n_filter_registers; i++)
+                if (!resident)
                 {
-                    set1f(Q->FU[u].R[i], e, FBP.FU[u].R[i]);
+                    for (int i = 0; i < n_filter_registers; i++)
+                    {
+                        set1f(Q->FU[u].R[i], e, FBP.FU[u].R[i]);
+                    }
                 }
 
                 Q->FU[u].DB[e] = FBP.Delay[u];
@@ -1439,9 +1664,12 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
                 if (scene->filterblock_configuration.val.i == fc_wide)
                 {
                     CM[u].updateState(Q->FU[u + 2], e);
-                    for (int i = 0; i < n_filter_registers; i++)
+                    if (!resident)
                     {
-                        set1f(Q->FU[u + 2].R[i], e, FBP.FU[u + 2].R[i]);
+                        for (int i = 0; i < n_filter_registers; i++)
+                        {
+                            set1f(Q->FU[u + 2].R[i], e, FBP.FU[u + 2].R[i]);
+                        }
                     }
 
                     Q->FU[u + 2].DB[e] = FBP.Delay[u + 2];
@@ -1456,22 +1684,49 @@ void SurgeVoice::GetQFB()
 {
     using namespace sst::filters;
 
+    /*
+     * The coefficients are interpolated from where the lane ended up, and the delay write
+     * position is shared between the wide units, so those always come back. The registers
+     * stay in the lane until the voice is evicted.
+     */
     for (int u = 0; u < n_filterunits_per_scene; u++)
     {
         if (scene->filterunit[u].type.val.i != 0)
         {
-            for (int i = 0; i < n_filter_registers; i++)
-            {
-                FBP.FU[u].R[i] = get1f(fbq->FU[u].R[i], fbqi);
-            }
-
             for (int i = 0; i < n_cm_coeffs; i++)
             {
                 CM[u].C[i] = get1f(fbq->FU[u].C[i], fbqi);
             }
             FBP.FU[u].WP = fbq->FU[u].WP[fbqi];
+        }
+    }
 
-            if (scene->filterblock_configuration.val.i == fc_wide)
+    fbqResident = true;
+}
+
+void SurgeVoice::evictUnlessIn(QuadFilterChainState *Q, int e)
+{
+    if (fbqResident && (Q != fbq || e != fbqi))
+        evictFromQFB();
+}
+
+void SurgeVoice::evictFromQFB()
+{
+    using namespace sst::filters;
+
+    if (!fbqResident)
+        return;
+
+    for (int u = 0; u < n_filterunits_per_scene; u++)
+    {
+        if (scene->filterunit[u].type.val.i != 0)
+        {
+            for (int i = 0; i < n_filter_registers; i++)
+            {
+                FBP.FU[u].R[i] = get1f(fbq->FU[u].R[i], fbqi);
+            }
+
+            if (fbqResidentConfig == fc_wide)
             {
                 for (int i = 0; i < n_filter_registers; i++)
                 {
@@ -1490,6 +1745,8 @@ void SurgeVoice::GetQFB()
     FBP.FBlineL = get1f(fbq->FBlineL, fbqi);
     FBP.FBlineR = get1f(fbq->FBlineR, fbqi);
     FBP.wsLPF = get1f(fbq->wsLPF, fbqi);
+
+    fbqResident = false;
 }
 
 void SurgeVoice::freeAllocatedElements()
@@ -1512,56 +1769,39 @@ void SurgeVoice::applyPolyphonicParamModulation(Parameter *p, double value,
     // For a discussion of underlyingMonoMod please see the comment in
     // SurgeSynthesizer::applyParameterPolyphonicModulation
 
-    // quickly do a search to see if i'm there
     int param_id = p->param_id_in_scene;
-    for (int i = 0; i < paramModulationCount; ++i)
-    {
-        if (polyphonicParamModulations[i].param_id == param_id)
-        {
-            auto &pp = polyphonicParamModulations[i];
-            pp.vt_type = (valtypes)p->valtype;
-            switch (pp.vt_type)
-            {
-            case vt_float:
-                pp.value = value * (p->val_max.f - p->val_min.f);
-                break;
-            case vt_int:
-                pp.value = value * (p->val_max.i - p->val_min.i);
-                pp.imin = p->val_min.i;
-                pp.imax = p->val_max.i;
-                break;
-            case vt_bool:
-                pp.value = value;
-            }
+    if (param_id < 0 || param_id >= n_scene_params)
+        return;
 
-            pp.value -= underlyingMonoMod;
+    int idx = polyphonicParamModulationIndex[param_id];
+    if (idx < 0)
+    {
+        assert(paramModulationCount < maxPolyphonicParamModulations);
+        if (paramModulationCount >= maxPolyphonicParamModulations)
             return;
-        }
+
+        idx = paramModulationCount++;
+        polyphonicParamModulationIndex[param_id] = idx;
+        polyphonicParamModulations[idx].param_id = param_id;
     }
-    int idx = paramModulationCount;
-    assert(paramModulationCount < maxPolyphonicParamModulations);
-    if (paramModulationCount < maxPolyphonicParamModulations)
-    {
-        auto &pp = polyphonicParamModulations[idx];
-        pp.param_id = param_id;
-        pp.vt_type = (valtypes)p->valtype;
-        switch (pp.vt_type)
-        {
-        case vt_float:
-            pp.value = value * (p->val_max.f - p->val_min.f);
-            break;
-        case vt_int:
-            pp.value = value * (p->val_max.i - p->val_min.i);
-            pp.imin = p->val_min.i;
-            pp.imax = p->val_max.i;
-            break;
-        case vt_bool:
-            pp.value = value;
-        }
 
-        pp.value -= underlyingMonoMod;
-        paramModulationCount++;
+    auto &pp = polyphonicParamModulations[idx];
+    pp.vt_type = (valtypes)p->valtype;
+    switch (pp.vt_type)
+    {
+    case vt_float:
+        pp.value = value * (p->val_max.f - p->val_min.f);
+        break;
+    case vt_int:
+        pp.value = value * (p->val_max.i - p->val_min.i);
+        pp.imin = p->val_min.i;
+        pp.imax = p->val_max.i;
+        break;
+    case vt_bool:
+        pp.value = value;
     }
+
+    pp.value -= underlyingMonoMod;
 }
 
 void SurgeVoice::applyNoteExpression(NoteExpressionType net, float value)
@@ -1613,7 +1853,7 @@ void SurgeVoice::resetPortamentoFrom(int key, int channel)
 #ifndef SURGE_SKIP_ODDSOUND_MTS
         if (storage->oddsound_mts_client && storage->oddsound_mts_active_as_client)
         {
-            lk += MTS_RetuningInSemitones(storage->oddsound_mts_client, lk, channel);
+            lk = storage->mtsNotePitch(lk, channel);
             state.portasrc_key = lk;
         }
         else
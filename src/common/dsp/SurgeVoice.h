@@ -29,6 +29,7 @@
 #include "LFOModulationSource.h"
 #include <vembertech/lipol.h>
 #include "QuadFilterChain.h"
+#include "FilterCoefficientCache.h"
 #include <array>
 
 struct QuadFilterChainState;
@@ -58,7 +59,34 @@ class alignas(16) SurgeVoice
     void sampleRateReset();
     bool process_block(QuadFilterChainState &, int);
     void GetQFB(); // Get the updated registers from the QuadFB
+    void evictFromQFB(); // Copy the registers back if the voice is about to change lanes
+    void evictUnlessIn(QuadFilterChainState *Q, int e); // ... unless it is staying in this one
+    bool isResidentInQFB() const { return fbqResident; }
+    int getQFBLane() const { return fbqi; }
+    bool isInaudible() const { return inaudibleBlocks >= inaudibleBlocksBeforeFastPath; }
+    float getAmpEnvelopeLevel() const { return modsources[ms_ampeg]->get_output(0); }
     void legato(int key, int velocity, char detune);
+    // Start this voice partway into its first block, in oversampled samples
+    void setStartOffset(int offset);
+    int getStartOffset() const { return startOffset; }
+    // inaudible, and nothing could bring it back short of a new note
+    bool hasFinishedSounding() const { return isInaudible() && !outputGainCanRise(); }
+
+    /*
+     * The voice's part in the note render cache (see NoteRenderCache). A recording voice
+     * renders as usual, but in a filter quad of its own so the synth can capture it, and a
+     * replaying voice doesn't render at all while the synth plays the recording in its place.
+     * Either kind is a one-shot: release() only notes the release in noteCacheReleasePending,
+     * and the synth acts on uber_release() when it next renders the scene.
+     */
+    enum NoteCacheRole
+    {
+        nc_live,
+        nc_recording,
+        nc_replaying
+    } noteCacheRole{nc_live};
+    int noteCacheEntry{-1}, noteCacheRecorder{-1}, noteCachePosition{0};
+    bool noteCacheReleasePending{false};
     void switch_toggled();
     void freeAllocatedElements();
     int osctype[n_oscs];
@@ -85,6 +113,8 @@ class alignas(16) SurgeVoice
     int32_t paramModulationCount{0};
     static constexpr int maxPolyphonicParamModulations = 64;
     std::array<PolyphonicParamModulation, maxPolyphonicParamModulations> polyphonicParamModulations;
+    // where each scene parameter's entry lives in polyphonicParamModulations, or -1
+    std::array<int8_t, n_scene_params> polyphonicParamModulationIndex;
     // See comment in SurgeSynthesizer::applyParameterPolyphonicModulation for why this has 2 args
     void applyPolyphonicParamModulation(Parameter *, double value, double underlyingMonoMod);
 
@@ -118,7 +148,7 @@ class alignas(16) SurgeVoice
 
         if (scene->osc[oscNum].pitch.absolute)
         {
-            // remember note_to_pitch is linear interpolation on storage->table_pitch from
+            // remember note_to_pitch is linear interpolation on the tuning table pitch from
             // position note + 256 % 512
             // OK so now what we are searching for is the pair which surrounds us plus the pitch
             // drift... so
@@ -133,8 +163,9 @@ class alignas(16) SurgeVoice
 
             // so just iterate up. Deal with negative also of course. Since we will always be close
             // just do it brute force for now but later we can do a binary or some such.
-            float pitch0 = storage->table_pitch[tableIdx] * (1.0 - tableFrac) +
-                           storage->table_pitch[tableIdx + 1] * tableFrac;
+            const auto &tablePitch = storage->tuningTables().pitch;
+            float pitch0 = tablePitch[tableIdx] * (1.0 - tableFrac) +
+                           tablePitch[tableIdx + 1] * tableFrac;
             float targetPitch = pitch0 + fqShift / Tunings::MIDI_0_FREQ;
             if (targetPitch < 0)
                 targetPitch = 0.01;
@@ -143,7 +174,7 @@ class alignas(16) SurgeVoice
             {
                 while (tableIdx < 0x1fe)
                 {
-                    float pitch1 = storage->table_pitch[tableIdx + 1];
+                    float pitch1 = tablePitch[tableIdx + 1];
                     if (pitch0 <= targetPitch && pitch1 > targetPitch)
                     {
                         break;
@@ -156,7 +187,7 @@ class alignas(16) SurgeVoice
             {
                 while (tableIdx > 0)
                 {
-                    float pitch1 = storage->table_pitch[tableIdx - 1];
+                    float pitch1 = tablePitch[tableIdx - 1];
                     if (pitch0 >= targetPitch && pitch1 < targetPitch)
                     {
                         tableIdx--;
@@ -170,8 +201,8 @@ class alignas(16) SurgeVoice
             // So what's the frac
             // (1-x) * [tableIdx] + x * [tableIdx+1] = targetPitch
             // Or: x = ( target - table) / ( [ table+1 ] - [table] );
-            float frac = (targetPitch - storage->table_pitch[tableIdx]) /
-                         (storage->table_pitch[tableIdx + 1] - storage->table_pitch[tableIdx]);
+            float frac = (targetPitch - tablePitch[tableIdx]) /
+                         (tablePitch[tableIdx + 1] - tablePitch[tableIdx]);
             // frac = 1 -> targetpitch = +1; frac = 0 -> targetPitch
 
             // std::cout << note0 << " " << tableIdx << " " << frac << " " << fqShift << " " <<
@@ -206,6 +237,21 @@ class alignas(16) SurgeVoice
 
     void retriggerLFOEnvelopes();
     void retriggerOSCWithIndependentAttacks();
+
+    /*
+     * Run this voice's LFOs for the coming block ahead of process_block, queueing any block
+     * formulas on formulaBatch. The caller has to evaluate the batch before process_block,
+     * which then skips the LFOs.
+     */
+    void processVoiceLFOs(Surge::Formula::BlockBatch *formulaBatch);
+    bool hasBlockFormulaLFOs() const;
+
+    // The scene's shared formula results for the coming block, handed out by the synth
+    Surge::Formula::SharedEvaluations *formulaShare{nullptr};
+
+    // under seeded rendering the voice draws only from this; see SurgeStorage::seededRandom
+    SurgeStorage::RNGGen rng;
+    bool ownsRNG{false};
     void resetPortamentoFrom(int key, int channel);
 
     static float channelKeyEquvialent(float key, int channel, bool isMpeEnabled,
@@ -213,6 +259,7 @@ class alignas(16) SurgeVoice
 
   private:
     template <bool first> void calc_ctrldata(QuadFilterChainState *, int);
+    bool lfosProcessedAhead{false};
 
     /*
      * Some modulations at the voice level were applied to the local
@@ -225,8 +272,13 @@ class alignas(16) SurgeVoice
      * the local sources pre-attack) and then call that before the attck in
      * voice initiation, and again after attack to finish the matrix (via
      * calc_ctrldata)
+     *
+     * Once running, a voice reads the per block compiled routing from storage. The first
+     * pass at voice start walks the routing itself, since the note can arrive before the
+     * routing for this block has been compiled.
      */
-    template <bool noLFOSources = false> void applyModulationToLocalcopy();
+    template <bool noLFOSources = false, bool useCompiledRouting = true>
+    void applyModulationToLocalcopy();
 
     void update_portamento();
     void set_path(bool osc1, bool osc2, bool osc3, int FMmode, bool ring12, bool ring23,
@@ -241,6 +293,38 @@ class alignas(16) SurgeVoice
     QuadFilterChainState *fbq;
     int fbqi;
 
+    /*
+     * While a voice stays in the same QuadFilterChain lane from block to block, the lane
+     * already holds its filter, waveshaper and feedback registers, so SetQFB and GetQFB
+     * skip copying them through FBP. Anything which changes the lane out from under the
+     * voice (a reset of FBP, a change of filter configuration, or the voice list shifting
+     * it to another lane) must clear this, using evictFromQFB if the registers are live.
+     */
+    bool fbqResident{false};
+    int fbqResidentConfig{-1};
+
+    /*
+     * Audibility tracking. The VCA is applied after the filters, so the gain SetQFB hands
+     * the chain (AEG, VCA and velocity) times the output pan gain bounds what a voice can
+     * contribute, however hard its filters ring. Once that has been below -96 dB for a few
+     * blocks, process_block stops running the oscillators; see there for when it also ends
+     * the voice outright.
+     */
+    static constexpr float inaudibleGain = 1.5849e-5f;
+    static constexpr int inaudibleBlocksBeforeFastPath = 8;
+    int inaudibleBlocks{0};
+    bool outputGainCanRise() const;
+    bool finishBlock(QuadFilterChainState &Q, int Qe);
+
+    /*
+     * A voice started partway into a block holds its output back by startOffset samples for
+     * its whole life, carrying the end of each block over into the next, so the note sounds
+     * from the sample the host asked for rather than from the block edge. The envelopes
+     * and modulators still run on the block grid.
+     */
+    int startOffset{0};
+    float startCarry alignas(16)[2][BLOCK_SIZE_OS];
+
     struct
     {
         float Gain, FB, Mix1, Mix2, OutL, OutR, Out2L, Out2R, Drive, wsLPF, FBlineL, FBlineR;
@@ -258,6 +342,9 @@ class alignas(16) SurgeVoice
         } WS[2];
     } FBP;
     sst::filters::FilterCoefficientMaker<SurgeStorage> CM[2];
+    // the settings each unit's targets were made for, so unmoved filters skip MakeCoeffs
+    FilterCoefficientCache::Key coeffKey[2];
+    float coeffTargets[2][sst::filters::n_cm_coeffs];
 
     // data
     int lag_id[8], pitch_id, octave_id, volume_id, pan_id, width_id;
@@ -266,6 +353,24 @@ class alignas(16) SurgeVoice
     pdata *paramptr;
     int route[6];
 
+    /*
+     * localcopy is brought back to paramptr every block. Only the entries the scene moved
+     * since the last block and the ones this voice modulated are copied; a new voice, a
+     * missed block or more modulated entries than fit in the list take a full copy instead.
+     */
+    int modulatedParams[n_scene_params];
+    int modulatedParamCount{0};
+    bool localcopySynced{false};
+    uint32_t localcopyGeneration{0};
+    void refreshLocalcopy();
+    void markModulated(int id)
+    {
+        if (modulatedParamCount < n_scene_params)
+            modulatedParams[modulatedParamCount++] = id;
+        else
+            localcopySynced = false;
+    }
+
     float octaveSize = 12.0f;
 
     bool osc1, osc2, osc3, ring12, ring23, noise;
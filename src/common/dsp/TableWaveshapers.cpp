@@ -0,0 +1,279 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#include "TableWaveshapers.h"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+namespace Surge
+{
+namespace DSP
+{
+namespace
+{
+namespace sw = sst::waveshapers;
+
+static_assert(sw::n_waveshaper_registers >= 2, "ADAA keeps two values in the waveshaper state");
+
+constexpr int nTypes = (int)sw::WaveshaperType::n_ws_types;
+constexpr int midPoint = tableWaveshaperIntervals / 2;
+constexpr float gridStep = 2.f * tableWaveshaperRange / tableWaveshaperIntervals;
+// below this input step ADAA falls back to the curve at the midpoint
+constexpr float adaaMinimumStep = 1e-2f;
+
+struct Tables
+{
+    bool tabulated[nTypes]{};
+    // one guard point past the top so the top of the range can interpolate too
+    float f[nTypes][tableWaveshaperIntervals + 2]{};
+    float F[nTypes][tableWaveshaperIntervals + 2]{};
+};
+
+// set once the tables are built; the kernels are only handed out after that
+const Tables *tables{nullptr};
+
+// the exact shaper with a state of its own, as a voice would start it
+struct Probe
+{
+    sw::QuadWaveshaperPtr fn;
+    sw::QuadWaveshaperState s;
+
+    Probe(sw::QuadWaveshaperPtr fn, sw::WaveshaperType type) : fn(fn)
+    {
+        float R[sw::n_waveshaper_registers];
+        sw::initializeWaveshaperRegister(type, R);
+        for (int i = 0; i < sw::n_waveshaper_registers; ++i)
+            s.R[i] = _mm_set1_ps(R[i]);
+        s.init = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+    }
+
+    float operator()(float x, float drive)
+    {
+        float r alignas(16)[4];
+        _mm_store_ps(r, fn(&s, _mm_set1_ps(x), _mm_set1_ps(drive)));
+        return r[0];
+    }
+};
+
+bool matches(float a, float b, float tolerance)
+{
+    return std::fabs(a - b) <= tolerance * (1.f + std::fabs(b));
+}
+
+bool buildTable(Tables &t, int type)
+{
+    auto wst = static_cast<sw::WaveshaperType>(type);
+    auto fn = sw::GetQuadWaveshaper(wst);
+
+    if (!fn)
+        return false;
+
+    auto exact = [&](float x, float drive) { return Probe(fn, wst)(x, drive); };
+    auto *f = t.f[type], *F = t.F[type];
+
+    for (int i = 0; i <= tableWaveshaperIntervals; ++i)
+    {
+        f[i] = exact((i - midPoint) * gridStep, 1.f);
+
+        if (!std::isfinite(f[i]))
+            return false;
+    }
+    f[tableWaveshaperIntervals + 1] = f[tableWaveshaperIntervals];
+
+    // the curve has to be flat past the table for the clamp to be exact
+    for (auto k : {1.5f, 4.f, 64.f})
+    {
+        if (!matches(exact(k * tableWaveshaperRange, 1.f), f[tableWaveshaperIntervals], 1e-4f) ||
+            !matches(exact(-k * tableWaveshaperRange, 1.f), f[0], 1e-4f))
+            return false;
+    }
+
+    // the drive has to be a plain gain on the input
+    for (auto x : {-3.7f, -1.3f, -0.41f, 0.05f, 0.6f, 2.2f, 5.1f})
+    {
+        for (auto d : {0.25f, 3.f, 11.f})
+        {
+            if (!matches(exact(x, d), exact(x * d, 1.f), 1e-4f))
+                return false;
+        }
+    }
+
+    // the interpolation has to hold up between the grid points, which steps and folds don't
+    for (int i = 0; i < tableWaveshaperIntervals; ++i)
+    {
+        auto mid = exact((i - midPoint + 0.5f) * gridStep, 1.f);
+
+        if (!matches(0.5f * (f[i] + f[i + 1]), mid, 1e-3f))
+            return false;
+    }
+
+    // and a slow sweep through one running state has to trace the same curve. That rules out
+    // shapes with filters or other memory in them, while ADAA shapers settle onto their curve
+    Probe running(fn, wst);
+    constexpr int sweepSteps = 8;
+
+    for (int i = 0; i < tableWaveshaperIntervals * sweepSteps; ++i)
+    {
+        int n = i / sweepSteps;
+        float a = (float)(i % sweepSteps) / sweepSteps;
+        auto y = running((n - midPoint + a) * gridStep, 1.f);
+
+        if (!matches(y, f[n] + a * (f[n + 1] - f[n]), 1e-2f))
+            return false;
+    }
+
+    // trapezoids are exact for the interpolated curve at the grid points; F(0) = 0
+    double acc = 0.0;
+    F[midPoint] = 0.f;
+    for (int i = midPoint; i < tableWaveshaperIntervals; ++i)
+    {
+        acc += 0.5 * gridStep * ((double)f[i] + f[i + 1]);
+        F[i + 1] = (float)acc;
+    }
+
+    acc = 0.0;
+    for (int i = midPoint; i > 0; --i)
+    {
+        acc -= 0.5 * gridStep * ((double)f[i] + f[i - 1]);
+        F[i - 1] = (float)acc;
+    }
+    F[tableWaveshaperIntervals + 1] =
+        F[tableWaveshaperIntervals] + gridStep * f[tableWaveshaperIntervals];
+
+    return true;
+}
+
+const Tables &buildTables()
+{
+    static const std::unique_ptr<Tables> built = []() {
+        auto res = std::make_unique<Tables>();
+
+        for (int i = 0; i < nTypes; ++i)
+            res->tabulated[i] = buildTable(*res, i);
+
+        tables = res.get();
+        return res;
+    }();
+
+    return *built;
+}
+
+// max first, so a NaN lands on the bottom of the table rather than indexing with it
+inline __m128 clampToTable(__m128 x)
+{
+    return _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-tableWaveshaperRange)),
+                      _mm_set1_ps(tableWaveshaperRange));
+}
+
+// x has to be clamped to the table already
+inline __m128 interpolate(const float *table, __m128 x)
+{
+    x = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.f / gridStep)), _mm_set1_ps((float)midPoint));
+    auto e = _mm_cvttps_epi32(x);
+    auto a = _mm_sub_ps(x, _mm_cvtepi32_ps(e));
+
+    int idx alignas(16)[4];
+    float w0 alignas(16)[4], w1 alignas(16)[4];
+    _mm_store_si128((__m128i *)idx, e);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        w0[i] = table[idx[i]];
+        w1[i] = table[idx[i] + 1];
+    }
+
+    auto v0 = _mm_load_ps(w0);
+    return _mm_add_ps(v0, _mm_mul_ps(a, _mm_sub_ps(_mm_load_ps(w1), v0)));
+}
+
+inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+template <int T>
+__m128 tableShape(sw::QuadWaveshaperState *__restrict, __m128 in, __m128 drive)
+{
+    return interpolate(tables->f[T], clampToTable(_mm_mul_ps(in, drive)));
+}
+
+template <int T>
+__m128 tableShapeADAA(sw::QuadWaveshaperState *__restrict s, __m128 in, __m128 drive)
+{
+    const auto &t = *tables;
+    auto x = _mm_mul_ps(in, drive);
+    auto xc = clampToTable(x);
+
+    // past the table the curve is flat, so its antiderivative carries on as a line
+    auto edge = select(_mm_cmpgt_ps(x, _mm_setzero_ps()),
+                       _mm_set1_ps(t.f[T][tableWaveshaperIntervals]), _mm_set1_ps(t.f[T][0]));
+    auto ad = _mm_add_ps(interpolate(t.F[T], xc), _mm_mul_ps(_mm_sub_ps(x, xc), edge));
+
+    auto xPrev = select(s->init, x, s->R[0]);
+    auto adPrev = select(s->init, ad, s->R[1]);
+    s->R[0] = x;
+    s->R[1] = ad;
+    s->init = _mm_setzero_ps();
+
+    // for close inputs the quotient is all rounding error; the midpoint value is its limit
+    auto dx = _mm_sub_ps(x, xPrev);
+    auto useMid =
+        _mm_cmplt_ps(_mm_andnot_ps(_mm_set1_ps(-0.f), dx), _mm_set1_ps(adaaMinimumStep));
+    auto mid =
+        interpolate(t.f[T], clampToTable(_mm_mul_ps(_mm_set1_ps(0.5f), _mm_add_ps(x, xPrev))));
+
+    return select(useMid, mid, _mm_div_ps(_mm_sub_ps(ad, adPrev), dx));
+}
+
+template <bool antialiased, int... T>
+std::array<sw::QuadWaveshaperPtr, sizeof...(T)> makeKernels(std::integer_sequence<int, T...>)
+{
+    if constexpr (antialiased)
+        return {{&tableShapeADAA<T>...}};
+    else
+        return {{&tableShape<T>...}};
+}
+
+const auto tableKernels = makeKernels<false>(std::make_integer_sequence<int, nTypes>());
+const auto tableKernelsADAA = makeKernels<true>(std::make_integer_sequence<int, nTypes>());
+} // namespace
+
+void prepareTableWaveshapers() { buildTables(); }
+
+bool isTableWaveshaper(sst::waveshapers::WaveshaperType type)
+{
+    int i = (int)type;
+    return i >= 0 && i < nTypes && buildTables().tabulated[i];
+}
+
+sst::waveshapers::QuadWaveshaperPtr GetTableQuadWaveshaper(sst::waveshapers::WaveshaperType type,
+                                                           bool antialiased)
+{
+    if (!isTableWaveshaper(type))
+        return nullptr;
+
+    return antialiased ? tableKernelsADAA[(int)type] : tableKernels[(int)type];
+}
+} // namespace DSP
+} // namespace Surge
@@ -0,0 +1,63 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#ifndef SURGE_SRC_COMMON_DSP_TABLEWAVESHAPERS_H
+#define SURGE_SRC_COMMON_DSP_TABLEWAVESHAPERS_H
+
+#include "sst/waveshapers.h"
+
+/*
+ * Table driven versions of the scene waveshapers.
+ *
+ * The shapes sst::waveshapers hands out evaluate their curve in full per sample, which for
+ * several of them means a tanh, exp or pow per lane. A shape which only depends on its input
+ * times the drive and which flattens out before +/- tableRange can be sampled once here and
+ * played back with a linear interpolation, four lanes at a time like lookup_waveshape. That
+ * rules out the folders, the bitcrushers and anything with a filter in it; for those
+ * GetTableQuadWaveshaper returns nullptr and the chain keeps the exact shaper. Each shape is
+ * checked against its exact version when the tables are built rather than listed by hand, so
+ * a change to a curve upstream can't leave a stale table behind.
+ *
+ * The antialiased variant plays back the first order antiderivative of the curve instead
+ * (ADAA): it outputs (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1]), which takes most of the alias
+ * energy out of hard drive without oversampling further. It keeps x[n-1] and F(x[n-1]) in the
+ * first two registers of the waveshaper state and reseeds from the input when the init lanes
+ * are set, the same way the sst ADAA shapers do.
+ */
+namespace Surge
+{
+namespace DSP
+{
+static constexpr float tableWaveshaperRange = 16.f;
+static constexpr int tableWaveshaperIntervals = 4096;
+
+// builds the tables if they haven't been; call off the audio thread, the storage does at startup
+void prepareTableWaveshapers();
+
+bool isTableWaveshaper(sst::waveshapers::WaveshaperType type);
+
+// nullptr for the shapes which can't be tabulated
+sst::waveshapers::QuadWaveshaperPtr GetTableQuadWaveshaper(sst::waveshapers::WaveshaperType type,
+                                                           bool antialiased);
+} // namespace DSP
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_DSP_TABLEWAVESHAPERS_H
@@ -24,6 +24,10 @@
 #include "DSPUtils.h"
 #include <vembertech/basic_dsp.h>
 #include "SurgeStorage.h"
+#include "RenderWorkerPool.h"
+#include "LargeBuffers.h"
+#include "SIMDDotProducts.h"
+#include <atomic>
 
 #include "sst/basic-blocks/mechanics/endian-ops.h"
 namespace mech = sst::basic_blocks::mechanics;
@@ -59,6 +63,45 @@ const int HRFilterI16[64] = {
     375, 1951, -687,  -1279, 782,  779,   -748,  -416, 642,   168,   -505, -14, 364,
     -66, -240, 95,    143,   -92,  -74,   72,    31,   -48,   -8,    33,   1};
 
+/*
+ * The two filters above, padded to 64 taps with a zero and aligned, so the mipmap builder can
+ * run them as whole SSE vectors.
+ */
+struct alignas(16) HalfbandTaps
+{
+    float f32[64];
+    int16_t i16[64];
+
+    HalfbandTaps()
+    {
+        for (int a = 0; a < 63; ++a)
+        {
+            f32[a] = hrfilter[a];
+            i16[a] = (int16_t)HRFilterI16[a];
+        }
+        f32[63] = 0.f;
+        i16[63] = 0;
+    }
+};
+static const HalfbandTaps halfbandTaps;
+
+static inline float halfbandF32(const float *x)
+{
+    return Surge::DSP::dotF32(halfbandTaps.f32, x, 64);
+}
+
+// the taps and samples are both short, so the pairwise products are exact in 32 bits
+static inline int halfbandI16(const short *x)
+{
+    return Surge::DSP::dotI16(halfbandTaps.i16, x, 64);
+}
+
+thread_local Surge::Threading::RenderWorkerPool *Wavetable::mipMapPool{nullptr};
+
+static std::atomic<uint32_t> wavetableRevisions{0};
+
+void Wavetable::markDataChanged() { dataRevision = ++wavetableRevisions; }
+
 int min_F32_tables = 3;
 
 #if MAC || LINUX
@@ -100,10 +143,7 @@ int GetWTIndex(int WaveIdx, int WaveSize, int NumWaves, int MipMap, int Padding
 Wavetable::Wavetable()
 {
     dataSizes = 35000;
-    TableF32Data = (float *)malloc(dataSizes * sizeof(float));
-    TableI16Data = (short *)malloc(dataSizes * sizeof(short));
-    memset(TableF32Data, 0, dataSizes * sizeof(float));
-    memset(TableI16Data, 0, dataSizes * sizeof(short));
+    allocTables();
     memset(TableF32WeakPointers, 0, sizeof(TableF32WeakPointers));
     memset(TableI16WeakPointers, 0, sizeof(TableI16WeakPointers));
     current_id = -1;
@@ -114,23 +154,55 @@ Wavetable::Wavetable()
 
 Wavetable::~Wavetable()
 {
-    free(TableF32Data);
-    free(TableI16Data);
+    if (!sharedTables)
+    {
+        freeTables();
+    }
+}
+
+void Wavetable::allocTables()
+{
+    TableF32Data = (float *)Surge::Memory::allocateLargeBuffer(dataSizes * sizeof(float));
+    TableI16Data = (short *)Surge::Memory::allocateLargeBuffer(dataSizes * sizeof(short));
+}
+
+void Wavetable::freeTables()
+{
+    Surge::Memory::freeLargeBuffer(TableF32Data, dataSizes * sizeof(float));
+    Surge::Memory::freeLargeBuffer(TableI16Data, dataSizes * sizeof(short));
 }
 
 void Wavetable::allocPointers(size_t newSize)
 {
-    free(TableF32Data);
-    free(TableI16Data);
+    if (sharedTables)
+    {
+        sharedTables.reset();
+    }
+    else
+    {
+        freeTables();
+    }
     dataSizes = newSize;
-    TableF32Data = (float *)malloc(dataSizes * sizeof(float));
-    TableI16Data = (short *)malloc(dataSizes * sizeof(short));
-    memset(TableF32Data, 0, dataSizes * sizeof(float));
-    memset(TableI16Data, 0, dataSizes * sizeof(short));
+    allocTables();
+    markDataChanged();
 }
 
 void Wavetable::Copy(Wavetable *wt)
 {
+    if (wt->sharedTables)
+    {
+        // copying a shared table is just another reference to it
+        shareTablesWith(wt->sharedTables);
+        current_id = wt->current_id;
+        queue_id = -1;
+        return;
+    }
+
+    if (sharedTables)
+    {
+        allocPointers(std::max(dataSizes, wt->dataSizes));
+    }
+
     size = wt->size;
     size_po2 = wt->size_po2;
     flags = wt->flags;
@@ -172,12 +244,95 @@ void Wavetable::Copy(Wavetable *wt)
     }
 
     current_id = wt->current_id;
+    markDataChanged();
+}
+
+void Wavetable::swapTablesWith(Wavetable &other)
+{
+    std::swap(everBuilt, other.everBuilt);
+    std::swap(size, other.size);
+    std::swap(n_tables, other.n_tables);
+    std::swap(size_po2, other.size_po2);
+    std::swap(flags, other.flags);
+    std::swap(dt, other.dt);
+    std::swap(dataSizes, other.dataSizes);
+    std::swap(TableF32Data, other.TableF32Data);
+    std::swap(TableI16Data, other.TableI16Data);
+    std::swap(sharedTables, other.sharedTables);
+
+    // the weak pointers point into the data blocks we just swapped, so they stay valid
+    std::swap(TableF32WeakPointers, other.TableF32WeakPointers);
+    std::swap(TableI16WeakPointers, other.TableI16WeakPointers);
+
+    markDataChanged();
+    other.markDataChanged();
+}
+
+void Wavetable::shareTablesWith(const std::shared_ptr<const Wavetable> &source)
+{
+    if (source.get() == this || source == sharedTables)
+        return;
+
+    if (!sharedTables)
+    {
+        freeTables();
+    }
+
+    sharedTables = source;
+
+    everBuilt = source->everBuilt;
+    size = source->size;
+    n_tables = source->n_tables;
+    size_po2 = source->size_po2;
+    flags = source->flags;
+    dt = source->dt;
+    dataSizes = source->dataSizes;
+    TableF32Data = source->TableF32Data;
+    TableI16Data = source->TableI16Data;
+
+    memcpy(TableF32WeakPointers, source->TableF32WeakPointers, sizeof(TableF32WeakPointers));
+    memcpy(TableI16WeakPointers, source->TableI16WeakPointers, sizeof(TableI16WeakPointers));
+    markDataChanged();
+}
+
+void Wavetable::makeTablesUnique()
+{
+    if (!sharedTables)
+        return;
+
+    // hold the source until we're done copying out of it
+    auto source = sharedTables;
+    sharedTables.reset();
+
+    allocTables();
+    memcpy(TableF32Data, source->TableF32Data, dataSizes * sizeof(float));
+    memcpy(TableI16Data, source->TableI16Data, dataSizes * sizeof(short));
+
+    for (int i = 0; i < max_mipmap_levels; i++)
+    {
+        for (int j = 0; j < max_subtables; j++)
+        {
+            if (TableF32WeakPointers[i][j])
+                TableF32WeakPointers[i][j] =
+                    TableF32Data + (TableF32WeakPointers[i][j] - source->TableF32Data);
+
+            if (TableI16WeakPointers[i][j])
+                TableI16WeakPointers[i][j] =
+                    TableI16Data + (TableI16WeakPointers[i][j] - source->TableI16Data);
+        }
+    }
 }
 
 bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
 {
     assert(wdata);
 
+    // we are about to overwrite everything, so there is no need to copy a shared table first
+    if (sharedTables)
+    {
+        allocPointers(dataSizes);
+    }
+
     flags = mech::endian_read_int16LE(wh.flags);
     n_tables = mech::endian_read_int16LE(wh.n_tables);
     size = mech::endian_read_int32LE(wh.n_samples);
@@ -288,78 +443,113 @@ bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
 
 void Wavetable::MipMapWT()
 {
+    makeTablesUnique();
+
     int levels = 1;
     while (((1 << levels) < size) & (levels < max_mipmap_levels))
         levels++;
     int ns = this->n_tables;
 
-    const int filter_size = 63;
-    const int filter_id_of = (filter_size - 1) >> 1;
+    struct LevelJob
+    {
+        Wavetable *wt;
+        int level;
+    };
 
     for (int l = 1; l < levels; l++)
     {
-        int psize = size >> (l - 1);
-        int lsize = size >> l;
-
         for (int s = 0; s < ns; s++)
         {
             this->TableF32WeakPointers[l][s] = TableF32Data + GetWTIndex(s, size, n_tables, l);
             this->TableI16WeakPointers[l][s] =
                 TableI16Data + GetWTIndex(s, size, n_tables, l, FIRipolI16_N);
+        }
 
-            if (this->flags & wtf_is_sample)
-            {
-                for (int i = 0; i < lsize; i++)
-                {
-                    this->TableF32WeakPointers[l][s][i] = 0;
-                    for (int a = 0; a < filter_size; a++)
-                    {
-                        int srcindex = (i << 1) + a - filter_id_of;
-                        int srctable = max(0, s + (srcindex / psize));
-                        srcindex = srcindex & (psize - 1);
-                        if (srctable < ns)
-                            this->TableF32WeakPointers[l][s][i] +=
-                                hrfilter[a] * this->TableF32WeakPointers[l - 1][srctable][srcindex];
-                    }
-                    this->TableI16WeakPointers[l][s][i + FIRoffsetI16] =
-                        0; // not supported in int16 atm
-                }
-            }
-            else
-            {
-                for (int i = 0; i < lsize; i++)
-                {
-                    this->TableF32WeakPointers[l][s][i] = 0;
-                    for (int a = 0; a < filter_size; a++)
-                    {
-                        this->TableF32WeakPointers[l][s][i] +=
-                            hrfilter[a] * this->TableF32WeakPointers[l - 1][s][(
-                                              ((i << 1) + a - filter_id_of) & (psize - 1))];
-                    }
-                    int ival = 0;
-                    for (int a = 0; a < filter_size; a++)
-                    {
-                        ival += HRFilterI16[a] *
-                                this->TableI16WeakPointers[l - 1][s]
-                                                          [(((i << 1) + a - 31) & (psize - 1)) +
-                                                           FIRoffsetI16];
-                    }
-                    this->TableI16WeakPointers[l][s][i + FIRoffsetI16] = ival >> 16;
-                }
-            }
-            // float2i16_block(this->TableF32WeakPointers[l][s],this->TableI16WeakPointers[l][s],lsize);
-            auto toCopy = std::min(FIRoffsetI16, lsize);
-            memcpy(&this->TableI16WeakPointers[l][s][lsize + FIRoffsetI16],
-                   &this->TableI16WeakPointers[l][s][FIRoffsetI16], toCopy * sizeof(short));
-            memcpy(&this->TableI16WeakPointers[l][s][0], &this->TableI16WeakPointers[l][s][lsize],
-                   toCopy * sizeof(short));
+        // each subtable of a level only reads the level above, so they can all go at once
+        LevelJob job{this, l};
+        if (mipMapPool && ns > 1)
+        {
+            mipMapPool->runAll(
+                ns,
+                [](void *ctx, int s) {
+                    auto *j = static_cast<LevelJob *>(ctx);
+                    j->wt->mipMapSubtable(j->level, s);
+                },
+                &job);
+        }
+        else
+        {
+            for (int s = 0; s < ns; s++)
+                mipMapSubtable(l, s);
         }
-        // fwrite(this->TableI16WeakPointers[l][0],lsize*sizeof(short),1,F);
     }
-    // fclose(F);
 
     // TODO I16 mipmaps end up out of phase
     // The click/knot/bug probably results from the fact that there is no padding in the beginning,
     // so it becomes out of phase at mipmap switch - makes sense because as they were off by a whole
     // sample at the mipmap switch, which cannot be explained by the half rate filter
+
+    markDataChanged();
+}
+
+void Wavetable::mipMapSubtable(int l, int s)
+{
+    const int filter_id_of = (63 - 1) >> 1;
+
+    int ns = this->n_tables;
+    int psize = size >> (l - 1);
+    int lsize = size >> l;
+    int mask = psize - 1;
+
+    /*
+     * Lay the source out flat, with the wrap (or for samples, the neighbouring tables) already
+     * resolved, so output i is just a 64 tap dot product starting at ext[2i]. The indexing is
+     * exactly what the scalar filter used to do per tap.
+     */
+    float extF32 alignas(16)[max_wtable_size + 64];
+    short extI16 alignas(16)[max_wtable_size + 64];
+    int extSize = 2 * (lsize - 1) + 64;
+
+    auto *dstF32 = this->TableF32WeakPointers[l][s];
+    auto *dstI16 = this->TableI16WeakPointers[l][s];
+
+    if (this->flags & wtf_is_sample)
+    {
+        for (int k = 0; k < extSize; k++)
+        {
+            int srcindex = k - filter_id_of;
+            int srctable = max(0, s + (srcindex / psize));
+            extF32[k] = (srctable < ns)
+                            ? this->TableF32WeakPointers[l - 1][srctable][srcindex & mask]
+                            : 0.f;
+        }
+
+        for (int i = 0; i < lsize; i++)
+        {
+            dstF32[i] = halfbandF32(&extF32[i << 1]);
+            dstI16[i + FIRoffsetI16] = 0; // not supported in int16 atm
+        }
+    }
+    else
+    {
+        auto *srcF32 = this->TableF32WeakPointers[l - 1][s];
+        auto *srcI16 = this->TableI16WeakPointers[l - 1][s];
+
+        for (int k = 0; k < extSize; k++)
+        {
+            int idx = (k - filter_id_of) & mask;
+            extF32[k] = srcF32[idx];
+            extI16[k] = srcI16[idx + FIRoffsetI16];
+        }
+
+        for (int i = 0; i < lsize; i++)
+        {
+            dstF32[i] = halfbandF32(&extF32[i << 1]);
+            dstI16[i + FIRoffsetI16] = halfbandI16(&extI16[i << 1]) >> 16;
+        }
+    }
+
+    auto toCopy = std::min(FIRoffsetI16, lsize);
+    memcpy(&dstI16[lsize + FIRoffsetI16], &dstI16[FIRoffsetI16], toCopy * sizeof(short));
+    memcpy(&dstI16[0], &dstI16[lsize], toCopy * sizeof(short));
 }
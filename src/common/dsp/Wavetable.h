@@ -21,6 +21,8 @@
  */
 #ifndef SURGE_SRC_COMMON_DSP_WAVETABLE_H
 #define SURGE_SRC_COMMON_DSP_WAVETABLE_H
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <StringOps.h>
 const int max_wtable_size = 4096;
@@ -39,17 +41,62 @@ struct wt_header
 };
 #pragma pack(pop)
 
+namespace Surge
+{
+namespace Threading
+{
+struct RenderWorkerPool;
+}
+} // namespace Surge
+
 class Wavetable
 {
   public:
     Wavetable();
     ~Wavetable();
     void Copy(Wavetable *wt);
+    // Exchange the built table data (and its mipmap pointers) with another wavetable without
+    // copying or allocating. The id/queue/filename bookkeeping is left alone.
+    void swapTablesWith(Wavetable &other);
+
+    /*
+     * Point our tables at the data of a built wavetable which is shared between oscillators
+     * (and instances) rather than holding a copy of it. Anything which writes the tables
+     * first takes a private copy, so a shared source is never modified.
+     */
+    void shareTablesWith(const std::shared_ptr<const Wavetable> &source);
+    bool hasSharedTables() const { return (bool)sharedTables; }
+    // the float and int16 tables we point at, whether our own or shared
+    size_t dataBytes() const { return dataSizes * (sizeof(float) + sizeof(short)); }
+    void makeTablesUnique();
     bool BuildWT(void *wdata, wt_header &wh, bool AppendSilence);
     void MipMapWT();
 
     void allocPointers(size_t newSize);
 
+    /*
+     * Anything which changes the table contents calls this. It gives the table a revision no
+     * other table has had, so values derived from the tables (like the wavetable oscillator's
+     * level cache) can tell they are stale even across a swapTablesWith.
+     */
+    void markDataChanged();
+
+    /*
+     * If the calling thread has set a pool with this scope, MipMapWT spreads the subtables of
+     * each level over it. Background loaders and the UI do this; the audio thread never does.
+     */
+    struct MipMapPoolScope
+    {
+        explicit MipMapPoolScope(Surge::Threading::RenderWorkerPool *p) : prior(mipMapPool)
+        {
+            mipMapPool = p;
+        }
+        ~MipMapPoolScope() { mipMapPool = prior; }
+
+      private:
+        Surge::Threading::RenderWorkerPool *prior;
+    };
+
   public:
     bool everBuilt = false;
     int size;
@@ -63,12 +110,22 @@ class Wavetable
     size_t dataSizes;
     float *TableF32Data;
     short *TableI16Data;
+    // set if the two blocks above belong to this shared table instead of to us
+    std::shared_ptr<const Wavetable> sharedTables;
 
     int current_id, queue_id;
     bool refresh_display;
     std::string queue_filename;
     std::string current_filename;
     int frame_size_if_absent{-1};
+    uint32_t dataRevision{0};
+
+  private:
+    // our own (unshared) tables, dataSizes long, from the large buffer allocator
+    void allocTables();
+    void freeTables();
+    void mipMapSubtable(int level, int subtable);
+    static thread_local Surge::Threading::RenderWorkerPool *mipMapPool;
 };
 
 enum wtflags
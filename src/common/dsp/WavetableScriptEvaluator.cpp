@@ -31,16 +31,26 @@ std::vector<float> evaluateScriptAtFrame(const std::string &eqn, int resolution,
                                          int nFrames)
 {
 #if HAS_LUA
-    static lua_State *L = nullptr;
-    if (L == nullptr)
+    struct ThreadState
     {
-        L = lua_open();
-        luaL_openlibs(L);
-    }
+        ThreadState()
+        {
+            L = lua_open();
+            luaL_openlibs(L);
+        }
+        ~ThreadState() { lua_close(L); }
+        lua_State *L;
+    };
+    static thread_local ThreadState threadState;
+    auto L = threadState.L;
 
     auto values = std::vector<float>();
 
     auto wg = Surge::LuaSupport::SGLD("WavetableScript::evaluate", L);
+
+    // a runaway script would otherwise hang the editor, so each frame gets a generous budget
+    Surge::LuaSupport::ScopedEvaluationBudget budget(L, 5.0);
+
     std::string emsg;
     auto res = Surge::LuaSupport::parseStringDefiningFunction(L, eqn.c_str(), "generate", emsg);
     if (res)
@@ -95,6 +105,11 @@ std::vector<float> evaluateScriptAtFrame(const std::string &eqn, int resolution,
             }
             lua_pop(L, 1);
         }
+        else
+        {
+            std::cout << lua_tostring(L, -1) << std::endl;
+            lua_pop(L, 1);
+        }
     }
     else
     {
@@ -108,7 +123,7 @@ std::vector<float> evaluateScriptAtFrame(const std::string &eqn, int resolution,
 }
 
 bool constructWavetable(const std::string &eqn, int resolution, int frames, wt_header &wh,
-                        float **wavdata)
+                        float **wavdata, const frameCallback_t &onFrame)
 {
     auto wd = new float[frames * resolution];
     wh.n_samples = resolution;
@@ -116,10 +131,20 @@ bool constructWavetable(const std::string &eqn, int resolution, int frames, wt_h
     wh.flags = 0;
     *wavdata = wd;
 
+    memset(wd, 0, frames * resolution * sizeof(float));
+
     for (int i = 0; i < frames; ++i)
     {
         auto v = evaluateScriptAtFrame(eqn, resolution, i, frames);
+
+        // a frame which failed, or ran out of budget, would just fail again; leave the rest silent
+        if (v.size() != (size_t)resolution)
+            break;
+
         memcpy(&(wd[i * resolution]), &(v[0]), resolution * sizeof(float));
+
+        if (onFrame && !onFrame(i, &(wd[i * resolution]), resolution))
+            return false;
     }
     return true;
 }
@@ -27,14 +27,16 @@
 #include "StringOps.h"
 #include "Wavetable.h"
 
+#include <functional>
+
 namespace Surge
 {
 namespace WavetableScript
 {
 /*
  * Unlike the LFO modulator this is called at render time of the wavetable
- * not at the evaluation or synthesis time. As such I expect you call it from
- * one thread at a time and just you know generally be careful.
+ * not at the evaluation or synthesis time. Each thread which calls this gets its
+ * own lua state, so the editor preview and the background generator can both run.
  */
 std::vector<float> evaluateScriptAtFrame(const std::string &eqn, int resolution, int frame,
                                          int nFrames);
@@ -42,9 +44,13 @@ std::vector<float> evaluateScriptAtFrame(const std::string &eqn, int resolution,
 /*
  * Generate all the data required to call BuildWT. The wavdata here is data you
  * must free with delete[]
+ *
+ * If you provide onFrame it is called with each frame as it is generated. Return false
+ * from it to stop early, in which case this returns false and the rest of wavdata is zero.
  */
+typedef std::function<bool(int frame, const float *data, int resolution)> frameCallback_t;
 bool constructWavetable(const std::string &eqn, int resolution, int frames, wt_header &wh,
-                        float **wavdata);
+                        float **wavdata, const frameCallback_t &onFrame = nullptr);
 
 std::string defaultWavetableFormula();
 
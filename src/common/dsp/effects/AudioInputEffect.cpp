@@ -168,9 +168,10 @@ void AudioInputEffect::process(float *dataL, float *dataR)
         float &sceneInputPan = fxdata->p[in_scene_input_pan].val.f;
         float &sceneInputLevelDb = fxdata->p[in_scene_input_level].val.f;
 
-        float *sceneData[] = {
-            sceneDataPtr[0].get(),
-            sceneDataPtr[1].get(),
+        int scene = slotType == a_insert_slot ? 1 : 0;
+        const float *sceneData[] = {
+            storage->scenesOutputData.getSceneView(scene, 0),
+            storage->scenesOutputData.getSceneView(scene, 1),
         };
         float sceneDataBuffer[2][BLOCK_SIZE];
         std::memcpy(sceneDataBuffer[0], sceneData[0], BLOCK_SIZE * sizeof(float));
@@ -52,8 +52,10 @@ class AudioInputEffect : public Effect
     int group_label_ypos(int id) override;
 
   private:
+    // held to subscribe to the scene output; the data itself is read through getSceneView
     std::shared_ptr<float> sceneDataPtr[N_OUTPUTS]{nullptr, nullptr};
     effect_slot_type getSlotType(fxslot_positions p);
     void applySlidersControls(float *buffer[], const float &channel, const float &pan,
                               const float &levelDb);
+    Surge::Storage::AudioInputClient audioInputClient{storage};
 };
@@ -114,21 +114,24 @@ void BBDEnsembleEffect::init()
     setvars(true);
     block_counter = 0;
 
-    auto init_bbds = [this](auto &delL1, auto &delL2, auto &delR1, auto &delR2) {
-        for (auto *del : {&delL1, &delL2, &delR1, &delR2})
-        {
-            del->prepare(storage->samplerate);
-            del->setFilterFreq(10000.0f);
-            del->setDelayTime(0.005f);
-        }
+    auto init_bbds = [this](auto &delL1, auto &delC, auto &delR2) {
+        auto init_bbd = [this](auto &del) {
+            del.prepare(storage->samplerate);
+            del.setFilterFreq(10000.0f);
+            del.setDelayTime(0.005f);
+        };
+
+        init_bbd(delL1);
+        init_bbd(delC);
+        init_bbd(delR2);
     };
 
-    init_bbds(del_128L1, del_128L2, del_128R1, del_128R2);
-    init_bbds(del_256L1, del_256L2, del_256R1, del_256R2);
-    init_bbds(del_512L1, del_512L2, del_512R1, del_512R2);
-    init_bbds(del_1024L1, del_1024L2, del_1024R1, del_1024R2);
-    init_bbds(del_2048L1, del_2048L2, del_2048R1, del_2048R2);
-    init_bbds(del_4096L1, del_4096L2, del_4096R1, del_4096R2);
+    init_bbds(del_128L1, del_128C, del_128R2);
+    init_bbds(del_256L1, del_256C, del_256R2);
+    init_bbds(del_512L1, del_512C, del_512R2);
+    init_bbds(del_1024L1, del_1024C, del_1024R2);
+    init_bbds(del_2048L1, del_2048C, del_2048R2);
+    init_bbds(del_4096L1, del_4096C, del_4096R2);
 
     bbd_saturation_sse.reset(storage->samplerate);
     bbd_saturation_sse.setDrive(0.5f);
@@ -271,8 +274,8 @@ void BBDEnsembleEffect::process(float *dataL, float *dataR)
     const auto delayScale =
         0.95f * delayCenterMs / (delay1Ms + delay2Ms); // make sure total delay is always positive
 
-    auto process_bbd_delays = [=, this](float *dataL, float *dataR, auto &delL1, auto &delL2,
-                                        auto &delR1, auto &delR2) {
+    auto process_bbd_delays = [=, this](float *dataL, float *dataR, auto &delL1, auto &delC,
+                                        auto &delR2) {
         // copy input data ("dry") to processed output ("wet)
         mech::copy_from_to<BLOCK_SIZE>(dataL, L);
         mech::copy_from_to<BLOCK_SIZE>(dataR, R);
@@ -282,8 +285,9 @@ void BBDEnsembleEffect::process(float *dataL, float *dataR)
         if (block_counter++ == 3)
         {
             const auto aa_cutoff = calculateFilterParamFrequency(*pd_float, storage);
-            for (auto *del : {&delL1, &delL2, &delR1, &delR2})
-                del->setFilterFreq(aa_cutoff);
+            delL1.setFilterFreq(aa_cutoff);
+            delC.setFilterFreq(aa_cutoff);
+            delR2.setFilterFreq(aa_cutoff);
 
             block_counter = 0;
         }
@@ -313,14 +317,13 @@ void BBDEnsembleEffect::process(float *dataL, float *dataR)
             float t3 = del1 * modlfos[0][2].value() + del2 * modlfos[1][2].value() + del0;
 
             delL1.setDelayTime(t1);
-            delL2.setDelayTime(t2);
-            delR1.setDelayTime(t2);
+            delC.setDelayTime(t2);
             delR2.setDelayTime(t3);
 
             float delayOuts alignas(16)[4];
+            const float inC[2] = {L[s], R[s]};
             delayOuts[0] = delL1.process(L[s]);
-            delayOuts[1] = delL2.process(L[s]);
-            delayOuts[2] = delR1.process(R[s]);
+            delC.process(inC, &delayOuts[1]);
             delayOuts[3] = delR2.process(R[s]);
 
             fbStateL = fbGain * (delayOuts[0] + delayOuts[1]);
@@ -353,22 +356,22 @@ void BBDEnsembleEffect::process(float *dataL, float *dataR)
         process_sinc_delays(dataL, dataR, delayCenterMs, delayScale);
         break;
     case ens_128:
-        process_bbd_delays(dataL, dataR, del_128L1, del_128L2, del_128R1, del_128R2);
+        process_bbd_delays(dataL, dataR, del_128L1, del_128C, del_128R2);
         break;
     case ens_256:
-        process_bbd_delays(dataL, dataR, del_256L1, del_256L2, del_256R1, del_256R2);
+        process_bbd_delays(dataL, dataR, del_256L1, del_256C, del_256R2);
         break;
     case ens_512:
-        process_bbd_delays(dataL, dataR, del_512L1, del_512L2, del_512R1, del_512R2);
+        process_bbd_delays(dataL, dataR, del_512L1, del_512C, del_512R2);
         break;
     case ens_1024:
-        process_bbd_delays(dataL, dataR, del_1024L1, del_1024L2, del_1024R1, del_1024R2);
+        process_bbd_delays(dataL, dataR, del_1024L1, del_1024C, del_1024R2);
         break;
     case ens_2048:
-        process_bbd_delays(dataL, dataR, del_2048L1, del_2048L2, del_2048R1, del_2048R2);
+        process_bbd_delays(dataL, dataR, del_2048L1, del_2048C, del_2048R2);
         break;
     case ens_4096:
-        process_bbd_delays(dataL, dataR, del_4096L1, del_4096L2, del_4096R1, del_4096R2);
+        process_bbd_delays(dataL, dataR, del_4096L1, del_4096C, del_4096R2);
         break;
     }
 
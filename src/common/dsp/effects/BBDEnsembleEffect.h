@@ -88,12 +88,20 @@ class BBDEnsembleEffect : public Effect
 
     Surge::ModControl modlfos[2][3]; // 2 LFOs differening by 120 degree in phase at outputs
     SSESincDelayLine<8192> delL, delR;
-    BBDDelayLine<128> del_128L1, del_128L2, del_128R1, del_128R2;
-    BBDDelayLine<256> del_256L1, del_256L2, del_256R1, del_256R2;
-    BBDDelayLine<512> del_512L1, del_512L2, del_512R1, del_512R2;
-    BBDDelayLine<1024> del_1024L1, del_1024L2, del_1024R1, del_1024R2;
-    BBDDelayLine<2048> del_2048L1, del_2048L2, del_2048R1, del_2048R2;
-    BBDDelayLine<4096> del_4096L1, del_4096L2, del_4096R1, del_4096R2;
+
+    // L2 and R1 always run at the same delay time, so they share one clock as a stereo line
+    BBDDelayLine<128> del_128L1, del_128R2;
+    BBDDelayLine<128, 2> del_128C;
+    BBDDelayLine<256> del_256L1, del_256R2;
+    BBDDelayLine<256, 2> del_256C;
+    BBDDelayLine<512> del_512L1, del_512R2;
+    BBDDelayLine<512, 2> del_512C;
+    BBDDelayLine<1024> del_1024L1, del_1024R2;
+    BBDDelayLine<1024, 2> del_1024C;
+    BBDDelayLine<2048> del_2048L1, del_2048R2;
+    BBDDelayLine<2048, 2> del_2048C;
+    BBDDelayLine<4096> del_4096L1, del_4096R2;
+    BBDDelayLine<4096, 2> del_4096C;
 
     BBDNonlin bbd_saturation_sse;
     size_t block_counter;
@@ -116,6 +116,23 @@ template <int v> void ChorusEffect<v>::process(float *dataL, float *dataR)
     mech::clear_block<BLOCK_SIZE>(tbufferL);
     mech::clear_block<BLOCK_SIZE>(tbufferR);
 
+    /*
+     * The read position and sinc phase of every voice's tap are worked out four voices at a
+     * time. Clamping before truncating gives the same integers as clamping after, since the
+     * bounds are whole numbers, so this matches the scalar version exactly.
+     */
+    constexpr int vq = (v + 3) / 4;
+    static_assert(FIRipol_N == 12, "The sinc phase multiply below assumes 12 taps");
+    float vtimes alignas(16)[vq * 4]{};
+    int rps alignas(16)[vq * 4], sincs alignas(16)[vq * 4];
+
+    const auto minTime = _mm_set1_ps((float)BLOCK_SIZE);
+    const auto maxTime = _mm_set1_ps((float)(max_delay_length - FIRipol_N - 1));
+    const auto maxPhase = _mm_set1_ps((float)(FIRipol_M - 1));
+    const auto ipolM = _mm_set1_ps((float)FIRipol_M);
+    const auto one = _mm_set1_epi32(1);
+    const auto delayMask = _mm_set1_epi32(max_delay_length - 1);
+
     for (int k = 0; k < BLOCK_SIZE; k++)
     {
         __m128 L = _mm_setzero_ps(), R = _mm_setzero_ps();
@@ -123,11 +140,30 @@ template <int v> void ChorusEffect<v>::process(float *dataL, float *dataR)
         for (int j = 0; j < v; j++)
         {
             time[j].process();
-            float vtime = time[j].v;
-            int i_dtime = max(BLOCK_SIZE, min((int)vtime, max_delay_length - FIRipol_N - 1));
-            int rp = ((wpos - i_dtime + k) - FIRipol_N) & (max_delay_length - 1);
-            int sinc = FIRipol_N * limit_range((int)(FIRipol_M * (float(i_dtime + 1) - vtime)), 0,
-                                               FIRipol_M - 1);
+            vtimes[j] = time[j].v;
+        }
+
+        const auto rbase = _mm_set1_epi32(wpos + k - FIRipol_N);
+
+        for (int q = 0; q < vq; q++)
+        {
+            auto vtime = _mm_load_ps(&vtimes[q * 4]);
+            auto i_dtime = _mm_cvttps_epi32(_mm_max_ps(minTime, _mm_min_ps(vtime, maxTime)));
+            auto frac = _mm_mul_ps(
+                ipolM, _mm_sub_ps(_mm_cvtepi32_ps(_mm_add_epi32(i_dtime, one)), vtime));
+            auto phase = _mm_cvttps_epi32(_mm_max_ps(_mm_setzero_ps(), _mm_min_ps(frac, maxPhase)));
+
+            _mm_store_si128((__m128i *)&rps[q * 4],
+                            _mm_and_si128(_mm_sub_epi32(rbase, i_dtime), delayMask));
+            // SSE2 has no 32 bit multiply, so times FIRipol_N is two shifts and an add
+            _mm_store_si128((__m128i *)&sincs[q * 4],
+                            _mm_add_epi32(_mm_slli_epi32(phase, 3), _mm_slli_epi32(phase, 2)));
+        }
+
+        for (int j = 0; j < v; j++)
+        {
+            int rp = rps[j];
+            int sinc = sincs[j];
 
             __m128 vo;
             vo = _mm_mul_ps(_mm_load_ps(&storage->sinctable1X[sinc]), _mm_loadu_ps(&buffer[rp]));
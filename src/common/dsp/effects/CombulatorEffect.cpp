@@ -245,40 +245,56 @@ void CombulatorEffect::process(float *dataL, float *dataR)
     }
 
     /* Run the filters */
-    float noise[2];
+    float noise alignas(16)[4] = {0.f, 0.f, 0.f, 0.f};
+
+    // the combs are lanes 0-2 of each channel's filter unit, lane 3 is never active
+    const auto combLanes = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    __m128 combMixL, combMixR;
+
+    auto updateCombMix = [&]() {
+        // FIXME - we want to interpolate the non-integral part if we like this
+        int panIndex2 = (int)((limit_range(pan2.v, -1.f, 1.f) + 1) * ((PANLAW_SIZE - 1) / 2)) &
+                        (PANLAW_SIZE - 1);
+        int panIndex3 = (int)((limit_range(pan3.v, -1.f, 1.f) + 1) * ((PANLAW_SIZE - 1) / 2)) &
+                        (PANLAW_SIZE - 1);
+
+        auto g = _mm_setr_ps(gain[0].v, gain[1].v, gain[2].v, 0.f);
+        auto center = _mm_set1_ps(0.59f);
+
+        // comb 1 is centered, comb 3 pans the other way
+        auto pl = _mm_setr_ps(0.59f, panL[panIndex2], panL[panIndex3], 0.f);
+        auto pr = _mm_setr_ps(0.59f, panR[panIndex2], panR[panIndex3], 0.f);
+
+        combMixL = _mm_mul_ps(g, _mm_div_ps(pl, center));
+        combMixR = _mm_mul_ps(g, _mm_div_ps(pr, center));
+    };
+
+    updateCombMix();
+
+    auto envAtt = _mm_set1_ps(envA), envRel = _mm_set1_ps(envR);
+    auto envLR = _mm_setr_ps(envV[0], envV[1], 0.f, 0.f);
 
     for (int s = 0; s < BLOCK_SIZE_OS; ++s)
     {
-        // Envelope Follower Update
-        for (int c = 0; c < 2; ++c)
-        {
-            auto v = dataOS[c][s];
-            auto e = envV[c];
+        // Envelope Follower Update, both channels as lanes
+        auto v = _mm_setr_ps(dataOS[0][s], dataOS[1][s], 0.f, 0.f);
+        auto rising = _mm_cmpgt_ps(v, envLR);
+        auto envCoeff = _mm_or_ps(_mm_and_ps(rising, envAtt), _mm_andnot_ps(rising, envRel));
 
-            if (v > e)
-            {
-                e = envA * (e - v) + v;
-            }
-            else
-            {
-                e = envR * (e - v) + v;
-            }
+        envLR = _mm_add_ps(_mm_mul_ps(envCoeff, _mm_sub_ps(envLR, v)), v);
 
-            envV[c] = e;
-            noise[c] = noisemix.v * 3.f * envV[c] *
-                       sst::basic_blocks::dsp::correlated_noise_o2mk2_supplied_value(
-                           noiseGen[c][0], noiseGen[c][1], 0, storage->rand_pm1());
+        for (int c = 0; c < 2; ++c)
+        {
+            noise[c] = sst::basic_blocks::dsp::correlated_noise_o2mk2_supplied_value(
+                noiseGen[c][0], noiseGen[c][1], 0, storage->rand_pm1());
         }
 
+        _mm_store_ps(noise, _mm_mul_ps(_mm_load_ps(noise),
+                                       _mm_mul_ps(_mm_set1_ps(noisemix.v * 3.f), envLR)));
+
         auto l128 = _mm_setzero_ps();
         auto r128 = _mm_setzero_ps();
 
-        // FIXME - we want to interpolate the non-integral part if we like this
-        int panIndex2 = (int)((limit_range(pan2.v, -1.f, 1.f) + 1) * ((PANLAW_SIZE - 1) / 2)) &
-                        (PANLAW_SIZE - 1);
-        int panIndex3 = (int)((limit_range(pan3.v, -1.f, 1.f) + 1) * ((PANLAW_SIZE - 1) / 2)) &
-                        (PANLAW_SIZE - 1);
-
         if (filtptr)
         {
             l128 = filtptr(&(qfus[0]), _mm_set1_ps(dataOS[0][s] + noise[0]));
@@ -290,38 +306,20 @@ void CombulatorEffect::process(float *dataL, float *dataR)
             r128 = _mm_set1_ps(dataOS[1][s]);
         }
 
-        float mixl = 0, mixr = 0;
-        float tl[4], tr[4];
-
-        _mm_store_ps(tl, l128);
-        _mm_store_ps(tr, r128);
-
-        for (int i = 0; i < 3; ++i)
-        {
-            float panl = 0.59, panr = 0.59;
-
-            if (i == 1)
-            {
-                panl = panL[panIndex2];
-                panr = panR[panIndex2];
-            }
-            else if (i == 2)
-            {
-                // The other way!
-                panl = panL[panIndex3];
-                panr = panR[panIndex3];
-            }
+        auto wl = _mm_and_ps(_mm_mul_ps(l128, combMixL), combLanes);
+        auto wr = _mm_and_ps(_mm_mul_ps(r128, combMixR), combLanes);
 
-            mixl += tl[i] * gain[i].v * panl / 0.59;
-            mixr += tr[i] * gain[i].v * panr / 0.59;
-        }
+        // sum the comb lanes of both channels together, leaving (left, right) in lanes 0 and 1
+        auto sum = _mm_add_ps(_mm_unpacklo_ps(wl, wr), _mm_unpackhi_ps(wl, wr));
+        auto mixlr = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
 
         // soft-clip output for good measure
-        mixl = storage->lookup_waveshape(sst::waveshapers::WaveshaperType::wst_soft, mixl);
-        mixr = storage->lookup_waveshape(sst::waveshapers::WaveshaperType::wst_soft, mixr);
+        mixlr = storage->lookup_waveshape(sst::waveshapers::WaveshaperType::wst_soft, mixlr);
 
-        dataOS[0][s] = mixl;
-        dataOS[1][s] = mixr;
+        float mixed alignas(16)[4];
+        _mm_store_ps(mixed, mixlr);
+        dataOS[0][s] = mixed[0];
+        dataOS[1][s] = mixed[1];
 
         // lag class only works at BLOCK_SIZE time, not BLOCK_SIZE_OS,
         // so call process every other sample
@@ -341,9 +339,14 @@ void CombulatorEffect::process(float *dataL, float *dataR)
                     noisemix.process();
                 }
             }
+
+            updateCombMix();
         }
     }
 
+    envV[0] = get1f(envLR, 0);
+    envV[1] = get1f(envLR, 1);
+
     /* preserve those registers and stuff */
     for (int c = 0; c < 2; ++c)
     {
@@ -151,9 +151,91 @@ void ConditionerEffect::process(float *dataL, float *dataR)
     ampL.multiply_block(dataL, BLOCK_SIZE_QUAD);
     ampR.multiply_block(dataR, BLOCK_SIZE_QUAD);
 
-    vu[0] = max(vu[0], mech::blockAbsMax<BLOCK_SIZE>(dataL));
-    vu[1] = max(vu[1], mech::blockAbsMax<BLOCK_SIZE>(dataR));
+    float peakL = mech::blockAbsMax<BLOCK_SIZE>(dataL);
+    float peakR = mech::blockAbsMax<BLOCK_SIZE>(dataR);
 
+    vu[0] = max(vu[0], peakL);
+    vu[1] = max(vu[1], peakR);
+
+    if (!force_per_sample_limiter && limiter_is_idle(max(peakL, peakR), attack, release))
+    {
+        process_idle_limiter(dataL, dataR);
+    }
+    else
+    {
+        process_limiter(dataL, dataR, attack, release);
+    }
+
+    postamp.multiply_2_blocks(dataL, dataR, BLOCK_SIZE_QUAD);
+
+    vu[2] = gain;
+
+    vu[4] = max(vu[4], mech::blockAbsMax<BLOCK_SIZE>(dataL));
+    vu[5] = max(vu[5], mech::blockAbsMax<BLOCK_SIZE>(dataR));
+}
+
+bool ConditionerEffect::limiter_is_idle(float peak, float attack, float release)
+{
+    if (bufpos + BLOCK_SIZE > lookahead)
+        return false;
+
+    // the level read below the threshold, both the one already in the lookahead buffer and
+    // anything this block could write over it, so every sample sees la = 1
+    if (lamax[lookahead - 2] > 0.5f || peak * peak > 0.5f)
+        return false;
+
+    // and the envelopes have settled, so with la = 1 they don't move and the gain is constant
+    float la = 1.f;
+    float fl = (1 - attack) * filtered_lamax + attack * la;
+    float fl2 = (1 - release) * filtered_lamax2 + (release)*fl;
+    if (fl > fl2)
+        fl2 = fl;
+
+    return fl == filtered_lamax && fl2 == filtered_lamax2;
+}
+
+void ConditionerEffect::process_idle_limiter(float *dataL, float *dataR)
+{
+    gain = mech::rcp(filtered_lamax2);
+
+    auto g = _mm_set1_ps(gain);
+
+    for (int k = 0; k < BLOCK_SIZE; k += 4)
+    {
+        auto inL = _mm_load_ps(dataL + k);
+        auto inR = _mm_load_ps(dataR + k);
+        auto dL = _mm_loadu_ps(&delayed[0][bufpos + k]);
+        auto dR = _mm_loadu_ps(&delayed[1][bufpos + k]);
+
+        _mm_storeu_ps(&delayed[0][bufpos + k], inL);
+        _mm_storeu_ps(&delayed[1][bufpos + k], inR);
+
+        auto m = _mm_max_ps(mech::abs_ps(inL), mech::abs_ps(inR));
+        _mm_storeu_ps(&lamax[bufpos + k], _mm_mul_ps(m, m)); // RMS
+
+        _mm_store_ps(dataL + k, _mm_mul_ps(g, dL));
+        _mm_store_ps(dataR + k, _mm_mul_ps(g, dR));
+    }
+
+    // bring the max tree up to date over the leaves we wrote, a level at a time
+    int of = 0, from = bufpos, to = bufpos + BLOCK_SIZE - 1;
+    for (int i = 0; i < (lookahead_bits); i++)
+    {
+        int nextof = of + (lookahead >> i);
+        for (int p = from >> 1; p <= to >> 1; p++)
+        {
+            lamax[nextof + p] = max(lamax[of + 2 * p], lamax[of + 2 * p + 1]);
+        }
+        of = nextof;
+        from >>= 1;
+        to >>= 1;
+    }
+
+    bufpos = (bufpos + BLOCK_SIZE) & (lookahead - 1);
+}
+
+void ConditionerEffect::process_limiter(float *dataL, float *dataR, float attack, float release)
+{
     for (int k = 0; k < BLOCK_SIZE; k++)
     {
         float dL = delayed[0][bufpos];
@@ -190,13 +272,6 @@ void ConditionerEffect::process(float *dataL, float *dataR)
 
         bufpos = (bufpos + 1) & (lookahead - 1);
     }
-
-    postamp.multiply_2_blocks(dataL, dataR, BLOCK_SIZE_QUAD);
-
-    vu[2] = gain;
-
-    vu[4] = max(vu[4], mech::blockAbsMax<BLOCK_SIZE>(dataL));
-    vu[5] = max(vu[5], mech::blockAbsMax<BLOCK_SIZE>(dataR));
 }
 
 Surge::ParamConfig::VUType ConditionerEffect::vu_type(int id)
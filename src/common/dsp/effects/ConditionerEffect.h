@@ -68,12 +68,21 @@ class ConditionerEffect : public Effect
         cond_hpwidth,
     };
 
+    // skip the block at a time idle path, so the tests can hold it up against this one
+    bool force_per_sample_limiter{false};
+
   private:
+    // with the level under the threshold and the envelopes settled, the limiter is a plain
+    // delay at a constant gain, which we can run a block at a time
+    bool limiter_is_idle(float peak, float attack, float release);
+    void process_idle_limiter(float *dataL, float *dataR);
+    void process_limiter(float *dataL, float *dataR, float attack, float release);
+
     BiquadFilter band1, band2, hp;
     float ef;
     lipol<float, true> a_rate, r_rate;
-    float lamax[lookahead << 1];
-    float delayed[2][lookahead];
+    float lamax alignas(16)[lookahead << 1];
+    float delayed alignas(16)[2][lookahead];
     int bufpos;
     float filtered_lamax, filtered_lamax2, gain;
 };
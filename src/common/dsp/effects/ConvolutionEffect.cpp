@@ -0,0 +1,243 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "ConvolutionEffect.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "samplerate.h"
+
+std::string ConvolutionEffect::ImpulseResponseNames::nameAtStreamedIndex(int i) const
+{
+    if (!storage || i < 0 || i >= (int)storage->ir_list.size())
+        return "None";
+
+    return storage->ir_list[i].name;
+}
+
+ConvolutionEffect::ConvolutionEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
+    : Effect(storage, fxdata, pd)
+{
+    irNames.storage = storage;
+    gain.set_blocksize(BLOCK_SIZE);
+    width.set_blocksize(BLOCK_SIZE);
+    mix.set_blocksize(BLOCK_SIZE);
+
+    loader.fn = serviceLoad;
+    loader.ctx = this;
+    storage->backgroundService->add(loader);
+}
+
+ConvolutionEffect::~ConvolutionEffect() { storage->backgroundService->remove(loader); }
+
+void ConvolutionEffect::init()
+{
+    convolver.reset();
+
+    gain.set_target(1.f);
+    width.set_target(1.f);
+    mix.set_target(1.f);
+
+    gain.instantize();
+    width.instantize();
+    mix.instantize();
+}
+
+void ConvolutionEffect::process(float *dataL, float *dataR)
+{
+    auto ir = *pd_int[conv_ir];
+
+    if (ir != requestedIR.load(std::memory_order_relaxed) ||
+        storage->samplerate != requestedSampleRate.load(std::memory_order_relaxed))
+    {
+        requestedSampleRate = storage->samplerate;
+        requestedIR = ir;
+
+        storage->backgroundService->request(loader);
+    }
+
+    float wetL alignas(16)[BLOCK_SIZE], wetR alignas(16)[BLOCK_SIZE];
+
+    convolver.process(dataL, dataR, wetL, wetR);
+
+    // the response we just swapped out is freed on the background thread too
+    if (convolver.hasRetiredResponses())
+        storage->backgroundService->request(loader);
+
+    gain.set_target_smoothed(storage->db_to_linear(*pd_float[conv_gain]));
+    width.set_target_smoothed(storage->db_to_linear(*pd_float[conv_width]));
+    mix.set_target_smoothed(*pd_float[conv_mix]);
+
+    gain.multiply_2_blocks(wetL, wetR, BLOCK_SIZE_QUAD);
+    applyWidth(wetL, wetR, width);
+    mix.fade_2_blocks_inplace(dataL, wetL, dataR, wetR, BLOCK_SIZE_QUAD);
+}
+
+void ConvolutionEffect::suspend() { init(); }
+
+int ConvolutionEffect::get_ringout_decay()
+{
+    // blocks, plus a couple for the response which may still be on its way in
+    return convolver.impulseResponseLength() / BLOCK_SIZE + 2;
+}
+
+void ConvolutionEffect::serviceLoad(void *ctx)
+{
+    auto that = static_cast<ConvolutionEffect *>(ctx);
+
+    that->convolver.freeRetiredResponses();
+
+    auto ir = that->requestedIR.load();
+    auto sr = that->requestedSampleRate.load();
+
+    if (sr <= 0.f || (ir == that->loadedIR && sr == that->loadedSampleRate))
+        return;
+
+    that->loadImpulseResponse(ir, sr);
+
+    that->loadedIR = ir;
+    that->loadedSampleRate = sr;
+}
+
+void ConvolutionEffect::loadImpulseResponse(int ir, float sampleRate)
+{
+    std::vector<float> ch[2];
+    float fileRate = sampleRate;
+
+    // an unknown or unreadable response leaves us with an empty one, which is silence
+    if (ir >= 0 && ir < (int)storage->ir_list.size() &&
+        storage->load_ir_wav(storage->ir_list[ir].path, ch[0], ch[1], fileRate) &&
+        fileRate != sampleRate)
+    {
+        auto ratio = (double)sampleRate / fileRate;
+
+        for (auto &c : ch)
+        {
+            if (c.empty())
+                continue;
+
+            std::vector<float> out((size_t)std::ceil(c.size() * ratio) + 1);
+
+            SRC_DATA sd{};
+            sd.data_in = c.data();
+            sd.data_out = out.data();
+            sd.input_frames = (long)c.size();
+            sd.output_frames = (long)out.size();
+            sd.src_ratio = ratio;
+
+            // we're off the audio thread, so there is no reason to skimp on quality here
+            if (src_simple(&sd, SRC_SINC_MEDIUM_QUALITY, 1) == 0)
+            {
+                out.resize(sd.output_frames_gen);
+                c = std::move(out);
+            }
+            else
+            {
+                c.clear();
+            }
+        }
+    }
+
+    auto maxLength = (size_t)(maxImpulseResponseSeconds * sampleRate);
+
+    float energy = 0.f;
+
+    for (auto &c : ch)
+    {
+        if (c.size() > maxLength)
+            c.resize(maxLength);
+
+        float e = 0.f;
+
+        for (auto v : c)
+            e += v * v;
+
+        energy = std::max(energy, e);
+    }
+
+    // unit energy, so responses of any length come out at much the same loudness
+    if (energy > 0.f)
+    {
+        auto norm = 1.f / std::sqrt(energy);
+
+        for (auto &c : ch)
+            for (auto &v : c)
+                v *= norm;
+    }
+
+    convolver.setImpulseResponse(ch[0], ch[1]);
+}
+
+const char *ConvolutionEffect::group_label(int id)
+{
+    switch (id)
+    {
+    case 0:
+        return "Impulse Response";
+    case 1:
+        return "Output";
+    }
+    return 0;
+}
+
+int ConvolutionEffect::group_label_ypos(int id)
+{
+    switch (id)
+    {
+    case 0:
+        return 1;
+    case 1:
+        return 5;
+    }
+    return 0;
+}
+
+void ConvolutionEffect::init_ctrltypes()
+{
+    Effect::init_ctrltypes();
+
+    fxdata->p[conv_ir].set_name("Response");
+    fxdata->p[conv_ir].set_type(ct_convolution_ir);
+    fxdata->p[conv_ir].val_max.i = std::max((int)storage->ir_list.size() - 1, 0);
+    fxdata->p[conv_ir].set_user_data(&irNames);
+
+    fxdata->p[conv_gain].set_name("Gain");
+    fxdata->p[conv_gain].set_type(ct_decibel_narrow);
+    fxdata->p[conv_width].set_name("Width");
+    fxdata->p[conv_width].set_type(ct_decibel_narrow);
+    fxdata->p[conv_mix].set_name("Mix");
+    fxdata->p[conv_mix].set_type(ct_percent);
+
+    fxdata->p[conv_ir].posy_offset = 1;
+
+    for (int i = conv_gain; i < conv_num_params; ++i)
+        fxdata->p[i].posy_offset = 3;
+}
+
+void ConvolutionEffect::init_default_values()
+{
+    fxdata->p[conv_ir].val.i = 0;
+    fxdata->p[conv_gain].val.f = 0.f;
+    fxdata->p[conv_width].val.f = 0.f;
+    fxdata->p[conv_mix].val.f = 0.5f;
+}
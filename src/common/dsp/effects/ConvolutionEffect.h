@@ -0,0 +1,96 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_DSP_EFFECTS_CONVOLUTIONEFFECT_H
+#define SURGE_SRC_COMMON_DSP_EFFECTS_CONVOLUTIONEFFECT_H
+
+#include "Effect.h"
+#include "BackgroundService.h"
+#include "PartitionedConvolver.h"
+
+#include <atomic>
+
+#include <vembertech/lipol.h>
+
+/*
+ * A convolution reverb. The impulse response is one of the .wav files in the factory
+ * impulse_responses folder or the user Impulse Responses folder (see SurgeStorage::ir_list),
+ * and the IR parameter indexes that list by name. Patches store the response's name as well,
+ * so they load the same one when the list changes; see SurgePatch.
+ *
+ * Reading, resampling and partitioning a response all happen on the storage's
+ * BackgroundService; process() only notices that the parameter has changed and asks for a
+ * load. The convolution itself is a Surge::DSP::PartitionedConvolver.
+ */
+class ConvolutionEffect : public Effect
+{
+    lipol_ps_blocksz gain alignas(16), width alignas(16), mix alignas(16);
+
+  public:
+    ConvolutionEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd);
+    virtual ~ConvolutionEffect();
+    virtual const char *get_effectname() override { return "convolution"; }
+    virtual void init() override;
+    virtual void process(float *dataL, float *dataR) override;
+    virtual void suspend() override;
+    virtual void init_ctrltypes() override;
+    virtual void init_default_values() override;
+    virtual const char *group_label(int id) override;
+    virtual int group_label_ypos(int id) override;
+    virtual int get_ringout_decay() override;
+
+    enum conv_params
+    {
+        conv_ir = 0,
+        conv_gain,
+        conv_width,
+        conv_mix,
+
+        conv_num_params,
+    };
+
+    // responses longer than this are cut short
+    static constexpr float maxImpulseResponseSeconds = 12.f;
+
+  private:
+    struct ImpulseResponseNames : public ParameterDiscreteIndexRemapper
+    {
+        SurgeStorage *storage{nullptr};
+
+        int remapStreamedIndexToDisplayIndex(int i) const override { return i; }
+        std::string nameAtStreamedIndex(int i) const override;
+    } irNames;
+
+    static void serviceLoad(void *ctx);
+    void loadImpulseResponse(int ir, float sampleRate);
+
+    Surge::DSP::PartitionedConvolver convolver;
+
+    std::atomic<int> requestedIR{-1};
+    std::atomic<float> requestedSampleRate{0.f};
+    int loadedIR{-1};
+    float loadedSampleRate{0.f};
+
+    Surge::Threading::BackgroundService::Client loader;
+};
+
+#endif // SURGE_SRC_COMMON_DSP_EFFECTS_CONVOLUTIONEFFECT_H
@@ -24,15 +24,12 @@
 
 // feedback can get tricky with packed SSE
 
-const int dist_OS_bits = 2;
-const int distortion_OS = 1 << dist_OS_bits;
-
 DistortionEffect::DistortionEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
-    : Effect(storage, fxdata, pd), band1(storage), band2(storage), lp1(storage), lp2(storage),
-      hr_a(3, false), hr_b(3, true)
+    : Effect(storage, fxdata, pd), band1(storage), band2(storage), lp1(storage), lp2(storage)
 {
-    lp1.setBlockSize(BLOCK_SIZE * distortion_OS);
-    lp2.setBlockSize(BLOCK_SIZE * distortion_OS);
+    os.setOSFactor(default_OS_bits);
+    lp1.setBlockSize(BLOCK_SIZE << default_OS_bits);
+    lp2.setBlockSize(BLOCK_SIZE << default_OS_bits);
     drive.set_blocksize(BLOCK_SIZE);
     outgain.set_blocksize(BLOCK_SIZE);
 }
@@ -41,6 +38,8 @@ DistortionEffect::~DistortionEffect() {}
 
 void DistortionEffect::init()
 {
+    setOversampling();
+    os.reset();
     setvars(true);
     band1.suspend();
     band2.suspend();
@@ -54,6 +53,21 @@ void DistortionEffect::init()
         wsState.R[i] = _mm_setzero_ps();
 }
 
+void DistortionEffect::setOversampling()
+{
+    // rendering offline, the default choice goes as high as we can
+    auto defBits = storage->useHighestQuality() ? max_OS_bits : default_OS_bits;
+    auto bits = os.factorForChoice(fxdata->p[dist_drive].deform_type, defBits);
+
+    if (os.setOSFactor(bits))
+    {
+        lp1.setBlockSize(BLOCK_SIZE << bits);
+        lp2.setBlockSize(BLOCK_SIZE << bits);
+        lp1.suspend();
+        lp2.suspend();
+    }
+}
+
 void DistortionEffect::setvars(bool init)
 {
     if (init)
@@ -77,8 +91,12 @@ void DistortionEffect::setvars(bool init)
                            *pd_float[dist_preeq_bw], pregain);
         band2.coeff_peakEQ(band2.calc_omega(*pd_float[dist_posteq_freq] / 12.f),
                            *pd_float[dist_posteq_bw], postgain);
-        lp1.coeff_LP2B(lp1.calc_omega((*pd_float[dist_preeq_highcut] / 12.0) - 2.f), 0.707);
-        lp2.coeff_LP2B(lp2.calc_omega((*pd_float[dist_posteq_highcut] / 12.0) - 2.f), 0.707);
+        // the lowpasses run at the oversampled rate
+        float osOctaves = os.getOSFactor();
+        lp1.coeff_LP2B(lp1.calc_omega((*pd_float[dist_preeq_highcut] / 12.0) - osOctaves),
+                       0.707);
+        lp2.coeff_LP2B(lp2.calc_omega((*pd_float[dist_posteq_highcut] / 12.0) - osOctaves),
+                       0.707);
         lp1.coeff_instantize();
         lp2.coeff_instantize();
     }
@@ -87,7 +105,10 @@ void DistortionEffect::setvars(bool init)
 void DistortionEffect::process(float *dataL, float *dataR)
 {
     if (bi == 0)
+    {
+        setOversampling();
         setvars(false);
+    }
 
     bi = (bi + 1) & slowrate_m1;
 
@@ -109,9 +130,8 @@ void DistortionEffect::process(float *dataL, float *dataR)
         wsi = 0;
     auto ws = FXWaveShapers[wsi];
 
-    float bL alignas(16)[BLOCK_SIZE << dist_OS_bits];
-    float bR alignas(16)[BLOCK_SIZE << dist_OS_bits];
-    assert(dist_OS_bits == 2);
+    const int osBits = os.getOSFactor(), distortion_OS = 1 << osBits;
+    auto bL = os.leftUp, bR = os.rightUp;
 
     drive.multiply_2_blocks(dataL, dataR, BLOCK_SIZE_QUAD);
 
@@ -123,7 +143,9 @@ void DistortionEffect::process(float *dataL, float *dataR)
 
     if (useSSEShaper)
     {
-        dD = (dE - dS) / (BLOCK_SIZE * dist_OS_bits);
+        // this has always ramped over one sample per halfband stage rather than per oversampled
+        // sample; keep that so the drive sweeps exactly as it did
+        dD = (dE - dS) / (BLOCK_SIZE * std::max(osBits, 1));
     }
 
     for (int k = 0; k < BLOCK_SIZE; k++)
@@ -174,15 +196,14 @@ void DistortionEffect::process(float *dataL, float *dataR)
                 lp2.process_sample_nolag(L, R);
             }
 
-            bL[s + (k << dist_OS_bits)] = L;
-            bR[s + (k << dist_OS_bits)] = R;
+            bL[s + (k << osBits)] = L;
+            bR[s + (k << osBits)] = R;
         }
     }
 
-    hr_a.process_block_D2(bL, bR, BLOCK_SIZE * 4);
-    hr_b.process_block_D2(bL, bR, BLOCK_SIZE * 2);
+    os.downsample(dataL, dataR);
 
-    outgain.multiply_2_blocks_to(bL, bR, dataL, dataR, BLOCK_SIZE_QUAD);
+    outgain.multiply_2_blocks(dataL, dataR, BLOCK_SIZE_QUAD);
 
     band2.process_block(dataL, dataR);
 }
@@ -234,7 +255,7 @@ void DistortionEffect::init_ctrltypes()
     fxdata->p[dist_preeq_highcut].set_type(ct_freq_audible_deactivatable_lp);
 
     fxdata->p[dist_drive].set_name("Drive");
-    fxdata->p[dist_drive].set_type(ct_decibel_narrow_extendable);
+    fxdata->p[dist_drive].set_type(ct_distortion_drive);
     fxdata->p[dist_feedback].set_name("Feedback");
     fxdata->p[dist_feedback].set_type(ct_percent_bipolar);
 
@@ -27,14 +27,17 @@
 #include "DSPUtils.h"
 #include "AllpassFilter.h"
 
-#include <sst/filters/HalfRateFilter.h>
 #include <vembertech/lipol.h>
 
+#include "chowdsp/shared/Oversampling.h"
+
 #include "sst/waveshapers.h"
 
 class DistortionEffect : public Effect
 {
-    sst::filters::HalfRate::HalfRateFilter hr_a alignas(16), hr_b alignas(16);
+    // up to 8x; the drive parameter's deform_type picks the ratio and the default is 4x
+    static constexpr int max_OS_bits = 3, default_OS_bits = 2;
+    chowdsp::VariableOversampling<max_OS_bits, BLOCK_SIZE> os;
     lipol_ps_blocksz drive alignas(16), outgain alignas(16);
     sst::waveshapers::QuadWaveshaperState wsState alignas(16);
 
@@ -50,6 +53,7 @@ class DistortionEffect : public Effect
 
     virtual int get_ringout_decay() override { return ringout_time; }
     void setvars(bool init);
+    void setOversampling();
     virtual void init_ctrltypes() override;
     virtual void init_default_values() override;
     virtual const char *group_label(int id) override;
@@ -111,27 +111,70 @@ void FrequencyShifterEffect::process(float *dataL, float *dataR)
     float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE], Li alignas(16)[BLOCK_SIZE],
         Ri alignas(16)[BLOCK_SIZE], Lr alignas(16)[BLOCK_SIZE], Rr alignas(16)[BLOCK_SIZE];
 
+    int rps[BLOCK_SIZE], sincs[BLOCK_SIZE];
+    bool steady = true;
+
     for (k = 0; k < BLOCK_SIZE; k++)
     {
         time.process();
 
         int i_dtime =
             max(FIRipol_N + BLOCK_SIZE, min((int)time.v, max_delay_length - FIRipol_N - 1));
-        int rp = (wpos - i_dtime + k);
-        int sinc = FIRipol_N *
+        rps[k] = (wpos - i_dtime + k);
+        sincs[k] = FIRipol_N *
                    limit_range((int)(FIRipol_M * (float(i_dtime + 1) - time.v)), 0, FIRipol_M - 1);
 
-        L[k] = 0;
-        R[k] = 0;
+        steady = steady && rps[k] == rps[0] + k && sincs[k] == sincs[0];
+    }
+
+    auto base = rps[0] & (max_delay_length - 1);
+
+    if (steady && base >= FIRipol_N - 1 && base + BLOCK_SIZE <= max_delay_length)
+    {
+        /*
+         * Once the delay time has settled, every sample in the block reads through the same
+         * sinc phase from consecutive positions, so we can run four outputs at a time. The
+         * taps add up in the same order as below, so this is exactly the same result.
+         */
+        auto *coef = &storage->sinctable1X[sincs[0] + FIRipol_N];
+
+        for (k = 0; k < BLOCK_SIZE; k += 4)
+        {
+            auto l = _mm_setzero_ps(), r = _mm_setzero_ps();
+
+            for (int i = 0; i < FIRipol_N; i++)
+            {
+                auto c = _mm_set1_ps(coef[-i]);
+                l = _mm_add_ps(l, _mm_mul_ps(_mm_loadu_ps(&buffer[0][base + k - i]), c));
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&buffer[1][base + k - i]), c));
+            }
 
-        for (int i = 0; i < FIRipol_N; i++)
+            _mm_store_ps(&L[k], l);
+            _mm_store_ps(&R[k], r);
+        }
+    }
+    else
+    {
+        for (k = 0; k < BLOCK_SIZE; k++)
         {
-            L[k] += buffer[0][(rp - i) & (max_delay_length - 1)] *
-                    storage->sinctable1X[sinc + FIRipol_N - i];
-            R[k] += buffer[1][(rp - i) & (max_delay_length - 1)] *
-                    storage->sinctable1X[sinc + FIRipol_N - i];
+            int rp = rps[k];
+            int sinc = sincs[k];
+
+            L[k] = 0;
+            R[k] = 0;
+
+            for (int i = 0; i < FIRipol_N; i++)
+            {
+                L[k] += buffer[0][(rp - i) & (max_delay_length - 1)] *
+                        storage->sinctable1X[sinc + FIRipol_N - i];
+                R[k] += buffer[1][(rp - i) & (max_delay_length - 1)] *
+                        storage->sinctable1X[sinc + FIRipol_N - i];
+            }
         }
+    }
 
+    for (k = 0; k < BLOCK_SIZE; k++)
+    {
         // do freqshift (part I)
         o1L.process();
         Lr[k] = L[k] * o1L.r;
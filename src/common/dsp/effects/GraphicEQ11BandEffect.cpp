@@ -93,20 +93,44 @@ void GraphicEQ11BandEffect::setvars(bool init)
         gain.set_target(1.f);
 
         gain.instantize();
+
+        resetParamChanges();
+
+        for (auto &f : flatUpdates)
+            f = 0;
     }
     else
     {
-        band1.coeff_peakEQ(band1.calc_omega_from_Hz(30.f), 0.5, *pd_float[geq11_30]);
-        band2.coeff_peakEQ(band2.calc_omega_from_Hz(60.f), 0.5, *pd_float[geq11_60]);
-        band3.coeff_peakEQ(band3.calc_omega_from_Hz(120.f), 0.5, *pd_float[geq11_120]);
-        band4.coeff_peakEQ(band4.calc_omega_from_Hz(250.f), 0.5, *pd_float[geq11_250]);
-        band5.coeff_peakEQ(band5.calc_omega_from_Hz(500.f), 0.5, *pd_float[geq11_500]);
-        band6.coeff_peakEQ(band6.calc_omega_from_Hz(1000.f), 0.5, *pd_float[geq11_1k]);
-        band7.coeff_peakEQ(band7.calc_omega_from_Hz(2000.f), 0.5, *pd_float[geq11_2k]);
-        band8.coeff_peakEQ(band8.calc_omega_from_Hz(4000.f), 0.5, *pd_float[geq11_4k]);
-        band9.coeff_peakEQ(band9.calc_omega_from_Hz(8000.f), 0.5, *pd_float[geq11_8k]);
-        band10.coeff_peakEQ(band10.calc_omega_from_Hz(12000.f), 0.5, *pd_float[geq11_12k]);
-        band11.coeff_peakEQ(band11.calc_omega_from_Hz(16000.f), 0.5, *pd_float[geq11_16k]);
+        updateParamChanges();
+
+        if (paramChanged(geq11_30))
+            band1.coeff_peakEQ(band1.calc_omega_from_Hz(30.f), 0.5, *pd_float[geq11_30]);
+        if (paramChanged(geq11_60))
+            band2.coeff_peakEQ(band2.calc_omega_from_Hz(60.f), 0.5, *pd_float[geq11_60]);
+        if (paramChanged(geq11_120))
+            band3.coeff_peakEQ(band3.calc_omega_from_Hz(120.f), 0.5, *pd_float[geq11_120]);
+        if (paramChanged(geq11_250))
+            band4.coeff_peakEQ(band4.calc_omega_from_Hz(250.f), 0.5, *pd_float[geq11_250]);
+        if (paramChanged(geq11_500))
+            band5.coeff_peakEQ(band5.calc_omega_from_Hz(500.f), 0.5, *pd_float[geq11_500]);
+        if (paramChanged(geq11_1k))
+            band6.coeff_peakEQ(band6.calc_omega_from_Hz(1000.f), 0.5, *pd_float[geq11_1k]);
+        if (paramChanged(geq11_2k))
+            band7.coeff_peakEQ(band7.calc_omega_from_Hz(2000.f), 0.5, *pd_float[geq11_2k]);
+        if (paramChanged(geq11_4k))
+            band8.coeff_peakEQ(band8.calc_omega_from_Hz(4000.f), 0.5, *pd_float[geq11_4k]);
+        if (paramChanged(geq11_8k))
+            band9.coeff_peakEQ(band9.calc_omega_from_Hz(8000.f), 0.5, *pd_float[geq11_8k]);
+        if (paramChanged(geq11_12k))
+            band10.coeff_peakEQ(band10.calc_omega_from_Hz(12000.f), 0.5, *pd_float[geq11_12k]);
+        if (paramChanged(geq11_16k))
+            band11.coeff_peakEQ(band11.calc_omega_from_Hz(16000.f), 0.5, *pd_float[geq11_16k]);
+
+        for (int i = 0; i < 11; ++i)
+        {
+            auto flat = *pd_float[geq11_30 + i] == 0.f;
+            flatUpdates[i] = flat ? std::min(flatUpdates[i] + 1, 2) : 0;
+        }
     }
 }
 
@@ -116,27 +140,27 @@ void GraphicEQ11BandEffect::process(float *dataL, float *dataR)
         setvars(false);
     bi = (bi + 1) & slowrate_m1;
 
-    if (!fxdata->p[geq11_30].deactivated)
+    if (!fxdata->p[geq11_30].deactivated && !isBandFlat(0))
         band1.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_60].deactivated)
+    if (!fxdata->p[geq11_60].deactivated && !isBandFlat(1))
         band2.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_120].deactivated)
+    if (!fxdata->p[geq11_120].deactivated && !isBandFlat(2))
         band3.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_250].deactivated)
+    if (!fxdata->p[geq11_250].deactivated && !isBandFlat(3))
         band4.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_500].deactivated)
+    if (!fxdata->p[geq11_500].deactivated && !isBandFlat(4))
         band5.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_1k].deactivated)
+    if (!fxdata->p[geq11_1k].deactivated && !isBandFlat(5))
         band6.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_2k].deactivated)
+    if (!fxdata->p[geq11_2k].deactivated && !isBandFlat(6))
         band7.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_4k].deactivated)
+    if (!fxdata->p[geq11_4k].deactivated && !isBandFlat(7))
         band8.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_8k].deactivated)
+    if (!fxdata->p[geq11_8k].deactivated && !isBandFlat(8))
         band9.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_12k].deactivated)
+    if (!fxdata->p[geq11_12k].deactivated && !isBandFlat(9))
         band10.process_block(dataL, dataR);
-    if (!fxdata->p[geq11_16k].deactivated)
+    if (!fxdata->p[geq11_16k].deactivated && !isBandFlat(10))
         band11.process_block(dataL, dataR);
 
     gain.set_target_smoothed(storage->db_to_linear(*pd_float[geq11_gain]));
@@ -76,6 +76,14 @@ class GraphicEQ11BandEffect : public Effect
         "2 kHz", "4 kHz", "8 kHz",  "12 kHz", "16 kHz",
     };
     BiquadFilter band1, band2, band3, band4, band5, band6, band7, band8, band9, band10, band11;
+
+    /*
+     * A band at 0 dB is a wire. Once its coefficients have had a whole control update to
+     * settle there, process() leaves it out of the cascade.
+     */
+    int flatUpdates[11]{};
+    bool isBandFlat(int b) const { return flatUpdates[b] >= 2; }
+
     int bi; // block increment (to keep track of events not occurring every n blocks)
 };
 
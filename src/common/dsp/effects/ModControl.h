@@ -43,6 +43,9 @@ class ModControl
     }
     ModControl() : ModControl(0, 0) {}
 
+    // the sample and hold shapes draw from their own generator; effects seed it from storage
+    void seed(uint32_t s) { rngState = s ? s : 0x9E3779B9; }
+
     enum mod_waves
     {
         mod_sine = 0,
@@ -177,7 +180,10 @@ class ModControl
         {
             if (lforeset)
             {
-                lfosandhtarget = (rand() / (float)RAND_MAX) - 1.f;
+                rngState ^= rngState << 13;
+                rngState ^= rngState >> 17;
+                rngState ^= rngState << 5;
+                lfosandhtarget = (float)(rngState >> 8) * (1.f / 16777215.f) - 1.f;
             }
 
             if (mwave == mod_noise)
@@ -221,6 +227,7 @@ class ModControl
     lipol<float, true> depth{};
     float lfophase;
     float lfosandhtarget;
+    uint32_t rngState{0x9E3779B9};
 
     static constexpr int LFO_TABLE_SIZE = 8192;
     static constexpr int LFO_TABLE_MASK = LFO_TABLE_SIZE - 1;
@@ -45,18 +45,7 @@ NimbusEffect::NimbusEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
     processor->Init(block_mem, memLen, block_ccm, ccmLen);
     mix.set_blocksize(BLOCK_SIZE);
 
-    int error;
-    surgeSR_to_euroSR = src_new(SRC_SINC_FASTEST, 2, &error);
-    if (error != 0)
-    {
-        surgeSR_to_euroSR = nullptr;
-    }
-
-    euroSR_to_surgeSR = src_new(SRC_SINC_FASTEST, 2, &error);
-    if (error != 0)
-    {
-        euroSR_to_surgeSR = nullptr;
-    }
+    sampleRateReset();
 }
 
 NimbusEffect::~NimbusEffect()
@@ -83,6 +72,80 @@ void NimbusEffect::init()
     builtBuffer = false;
     resampReadPtr = 0;
     resampWritePtr = 1; // why 1? well while we are stalling we want to output 0 so write 1 ahead
+
+    surgeToEuro.reset();
+    euroToSurge.reset();
+}
+
+void NimbusEffect::sampleRateReset()
+{
+    auto sr = (int)storage->samplerate;
+    bool fixed = (sr == storage->samplerate && surgeToEuro.setRates(sr, processor_sr) &&
+                  euroToSurge.setRates(processor_sr, sr));
+
+    if (fixed)
+    {
+        if (surgeSR_to_euroSR)
+            surgeSR_to_euroSR = src_delete(surgeSR_to_euroSR);
+        if (euroSR_to_surgeSR)
+            euroSR_to_surgeSR = src_delete(euroSR_to_surgeSR);
+
+        return;
+    }
+
+    int error;
+
+    if (!surgeSR_to_euroSR)
+    {
+        surgeSR_to_euroSR = src_new(SRC_SINC_FASTEST, 2, &error);
+        if (error != 0)
+        {
+            surgeSR_to_euroSR = nullptr;
+        }
+    }
+
+    if (!euroSR_to_surgeSR)
+    {
+        euroSR_to_surgeSR = src_new(SRC_SINC_FASTEST, 2, &error);
+        if (error != 0)
+        {
+            euroSR_to_surgeSR = nullptr;
+        }
+    }
+}
+
+int NimbusEffect::resampleToEuro(float *in, int nIn, float *out, int maxOut)
+{
+    if (surgeToEuro.isValid())
+        return surgeToEuro.process(in, nIn, out, maxOut);
+
+    SRC_DATA sdata;
+    sdata.end_of_input = 0;
+    sdata.src_ratio = processor_sr * storage->samplerate_inv;
+    sdata.data_in = in;
+    sdata.data_out = out;
+    sdata.input_frames = nIn;
+    sdata.output_frames = maxOut;
+    src_process(surgeSR_to_euroSR, &sdata);
+
+    return sdata.output_frames_gen;
+}
+
+int NimbusEffect::resampleToSurge(float *in, int nIn, float *out, int maxOut)
+{
+    if (euroToSurge.isValid())
+        return euroToSurge.process(in, nIn, out, maxOut);
+
+    SRC_DATA odata;
+    odata.end_of_input = 0;
+    odata.src_ratio = processor_sr_inv * storage->samplerate;
+    odata.data_in = in;
+    odata.data_out = out;
+    odata.input_frames = nIn;
+    odata.output_frames = maxOut;
+    src_process(euroSR_to_surgeSR, &odata);
+
+    return odata.output_frames_gen;
 }
 
 void NimbusEffect::setvars(bool init) {}
@@ -91,7 +154,8 @@ void NimbusEffect::process(float *dataL, float *dataR)
 {
     setvars(false);
 
-    if (!surgeSR_to_euroSR || !euroSR_to_surgeSR)
+    if (!(surgeToEuro.isValid() && euroToSurge.isValid()) &&
+        !(surgeSR_to_euroSR && euroSR_to_surgeSR))
         return;
 
     /* Resample Temp Buffers */
@@ -104,27 +168,25 @@ void NimbusEffect::process(float *dataL, float *dataR)
         resample_this[i][1] = dataR[i];
     }
 
-    SRC_DATA sdata;
-    sdata.end_of_input = 0;
-    sdata.src_ratio = processor_sr * storage->samplerate_inv;
-    sdata.data_in = &(resample_this[0][0]);
-    sdata.data_out = &(resample_into[0][0]);
-    sdata.input_frames = BLOCK_SIZE;
-    sdata.output_frames = (BLOCK_SIZE << 3);
-    auto res = src_process(surgeSR_to_euroSR, &sdata);
-    consumed += sdata.input_frames_used;
-
-    if (sdata.output_frames_gen)
+    auto generated =
+        resampleToEuro(&(resample_this[0][0]), BLOCK_SIZE, &(resample_into[0][0]), BLOCK_SIZE << 3);
+    consumed += BLOCK_SIZE;
+
+    if (generated)
     {
         clouds::ShortFrame input[BLOCK_SIZE << 3];
         clouds::ShortFrame output[BLOCK_SIZE << 3];
 
-        int frames_to_go = sdata.output_frames_gen;
+        int frames_to_go = generated;
         int outpos = 0;
 
         processor->set_playback_mode(
             (clouds::PlaybackMode)((int)clouds::PLAYBACK_MODE_GRANULAR + *pd_int[nmb_mode]));
-        processor->set_quality(*pd_int[nmb_quality]);
+        // bit 1 of the quality is the low fidelity flag; see ct_nimbusquality
+        auto quality = *pd_int[nmb_quality];
+        if (reducedQuality)
+            quality |= 0b10;
+        processor->set_quality(quality);
 
         int consume_ptr = 0;
         while (frames_to_go + numStubs >= nimbusprocess_blocksize)
@@ -196,19 +258,13 @@ void NimbusEffect::process(float *dataL, float *dataR)
 
         if (outpos > 0)
         {
-            SRC_DATA odata;
-            odata.end_of_input = 0;
-            odata.src_ratio = processor_sr_inv * storage->samplerate;
-            odata.data_in = &(resample_this[0][0]);
-            odata.data_out = &(resample_into[0][0]);
-            odata.input_frames = outpos;
-            odata.output_frames = BLOCK_SIZE << 3;
-            auto reso = src_process(euroSR_to_surgeSR, &odata);
+            auto resampled = resampleToSurge(&(resample_this[0][0]), outpos,
+                                             &(resample_into[0][0]), BLOCK_SIZE << 3);
             if (!builtBuffer)
-                created += odata.output_frames_gen;
+                created += resampled;
 
             size_t w = resampWritePtr;
-            for (int i = 0; i < odata.output_frames_gen; ++i)
+            for (int i = 0; i < resampled; ++i)
             {
                 resampled_output[w][0] = resample_into[i][0];
                 resampled_output[w][1] = resample_into[i][1];
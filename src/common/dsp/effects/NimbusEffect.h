@@ -24,6 +24,7 @@
 #define SURGE_SRC_COMMON_DSP_EFFECTS_NIMBUSEFFECT_H
 
 #include "Effect.h"
+#include "PolyphaseResampler.h"
 
 #include <memory>
 #include <vembertech/lipol.h>
@@ -70,6 +71,7 @@ class NimbusEffect : public Effect
     virtual void init() override;
     virtual void process(float *dataL, float *dataR) override;
     virtual void suspend() override;
+    virtual void sampleRateReset() override;
     void setvars(bool init);
     virtual void init_ctrltypes() override;
     virtual void init_default_values() override;
@@ -79,6 +81,9 @@ class NimbusEffect : public Effect
 
     virtual int get_ringout_decay() override { return -1; }
 
+    // running at low fidelity roughly halves the granular processor's work
+    virtual bool supportsReducedQuality() const override { return true; }
+
   private:
     uint8_t *block_mem, *block_ccm;
     clouds::GranularProcessor *processor;
@@ -86,7 +91,16 @@ class NimbusEffect : public Effect
     static constexpr float processor_sr_inv = 1.f / 32000;
     int old_nmb_mode = 0;
 
-    SRC_STATE_tag *surgeSR_to_euroSR, *euroSR_to_surgeSR;
+    /*
+     * The fixed ratio resamplers handle any pair of integer rates they have a kernel for,
+     * which covers every common host rate and is a plain copy at 32k. libsamplerate is only
+     * set up for anything else.
+     */
+    Surge::DSP::PolyphaseResampler surgeToEuro, euroToSurge;
+    SRC_STATE_tag *surgeSR_to_euroSR{nullptr}, *euroSR_to_surgeSR{nullptr};
+
+    int resampleToEuro(float *in, int nIn, float *out, int maxOut);
+    int resampleToSurge(float *in, int nIn, float *out, int maxOut);
 
     static constexpr int raw_out_sz = BLOCK_SIZE_OS << 5; // power of 2 pls
     float resampled_output[raw_out_sz][2];                // at sr
@@ -67,15 +67,33 @@ void ParametricEQ3BandEffect::setvars(bool init)
 
         gain.instantize();
         mix.instantize();
+
+        resetParamChanges();
+
+        for (auto &f : flatUpdates)
+            f = 0;
     }
     else
     {
-        band1.coeff_peakEQ(band1.calc_omega(*pd_float[eq3_freq1] * (1.f / 12.f)),
-                           *pd_float[eq3_bw1], *pd_float[eq3_gain1]);
-        band2.coeff_peakEQ(band2.calc_omega(*pd_float[eq3_freq2] * (1.f / 12.f)),
-                           *pd_float[eq3_bw2], *pd_float[eq3_gain2]);
-        band3.coeff_peakEQ(band3.calc_omega(*pd_float[eq3_freq3] * (1.f / 12.f)),
-                           *pd_float[eq3_bw3], *pd_float[eq3_gain3]);
+        updateParamChanges();
+
+        if (anyParamChanged(eq3_freq1, eq3_bw1, eq3_gain1))
+            band1.coeff_peakEQ(band1.calc_omega(*pd_float[eq3_freq1] * (1.f / 12.f)),
+                               *pd_float[eq3_bw1], *pd_float[eq3_gain1]);
+        if (anyParamChanged(eq3_freq2, eq3_bw2, eq3_gain2))
+            band2.coeff_peakEQ(band2.calc_omega(*pd_float[eq3_freq2] * (1.f / 12.f)),
+                               *pd_float[eq3_bw2], *pd_float[eq3_gain2]);
+        if (anyParamChanged(eq3_freq3, eq3_bw3, eq3_gain3))
+            band3.coeff_peakEQ(band3.calc_omega(*pd_float[eq3_freq3] * (1.f / 12.f)),
+                               *pd_float[eq3_bw3], *pd_float[eq3_gain3]);
+
+        int gains[3] = {eq3_gain1, eq3_gain2, eq3_gain3};
+
+        for (int i = 0; i < 3; ++i)
+        {
+            auto flat = *pd_float[gains[i]] == 0.f;
+            flatUpdates[i] = flat ? std::min(flatUpdates[i] + 1, 2) : 0;
+        }
     }
 }
 
@@ -89,11 +107,11 @@ void ParametricEQ3BandEffect::process(float *dataL, float *dataR)
     mech::copy_from_to<BLOCK_SIZE>(dataL, L);
     mech::copy_from_to<BLOCK_SIZE>(dataR, R);
 
-    if (!fxdata->p[eq3_gain1].deactivated)
+    if (!fxdata->p[eq3_gain1].deactivated && !isBandFlat(0))
         band1.process_block(L, R);
-    if (!fxdata->p[eq3_gain2].deactivated)
+    if (!fxdata->p[eq3_gain2].deactivated && !isBandFlat(1))
         band2.process_block(L, R);
-    if (!fxdata->p[eq3_gain3].deactivated)
+    if (!fxdata->p[eq3_gain3].deactivated && !isBandFlat(2))
         band3.process_block(L, R);
 
     gain.set_target_smoothed(storage->db_to_linear(*pd_float[eq3_gain]));
@@ -74,6 +74,11 @@ class ParametricEQ3BandEffect : public Effect
 
   private:
     BiquadFilter band1, band2, band3;
+
+    // As in the graphic EQ, a band which has settled at 0 dB is skipped
+    int flatUpdates[3]{};
+    bool isBandFlat(int b) const { return flatUpdates[b] >= 2; }
+
     int bi; // block increment (to keep track of events not occurring every n blocks)
 };
 
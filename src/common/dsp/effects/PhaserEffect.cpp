@@ -25,22 +25,30 @@
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "sst/basic-blocks/dsp/MidSide.h"
 
+#include <cmath>
+
 namespace mech = sst::basic_blocks::mechanics;
 namespace sdsp = sst::basic_blocks::dsp;
 
 float bend(float x, float b) { return (1.f + b) * x - b * x * x * x; }
 
+// the RBJ all-pass, normalized; past Nyquist the sine flips sign and the stage would go unstable
+static void allpassCoefficients(double omega, double q, double &a1, double &a2)
+{
+    omega = limit_range(omega, 1e-4, 0.99 * M_PI);
+
+    double alpha = std::sin(omega) / (2.0 * q);
+    double a0inv = 1.0 / (1.0 + alpha);
+
+    a1 = -2.0 * std::cos(omega) * a0inv;
+    a2 = (1.0 - alpha) * a0inv;
+}
+
 PhaserEffect::PhaserEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
     : Effect(storage, fxdata, pd), lp(storage), hp(storage),
       modLFOL(storage->samplerate, storage->samplerate_inv),
       modLFOR(storage->samplerate, storage->samplerate_inv)
 {
-    for (int i = 0; i < n_bq_units; i++)
-    {
-        biquad[i] = new BiquadFilter(storage);
-    }
-
-    n_bq_units_initialised = n_bq_units;
     feedback.setBlockSize(BLOCK_SIZE * slowrate);
     tone.setBlockSize(BLOCK_SIZE);
     width.set_blocksize(BLOCK_SIZE);
@@ -50,22 +58,19 @@ PhaserEffect::PhaserEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
     bi = 0;
 }
 
-PhaserEffect::~PhaserEffect()
-{
-    for (int i = 0; i < n_bq_units_initialised; i++)
-        delete biquad[i];
-}
+PhaserEffect::~PhaserEffect() {}
 
 void PhaserEffect::init()
 {
+    modLFOL.seed(storage->rand_u32());
+    modLFOR.seed(storage->rand_u32());
+
     bi = 0;
     dL = 0;
     dR = 0;
 
-    for (int i = 0; i < n_bq_units_initialised; i++)
-    {
-        biquad[i]->suspend();
-    }
+    // setvars starts every stage afresh, at its target and with a clear state
+    n_stages_running = 0;
 
     mech::clear_block<BLOCK_SIZE>(L);
     mech::clear_block<BLOCK_SIZE>(R);
@@ -81,23 +86,13 @@ void PhaserEffect::init()
     tone.instantize();
     width.instantize();
     mix.instantize();
+
+    resetParamChanges();
 }
 
 inline void PhaserEffect::init_stages()
 {
-    n_stages = *(pd_int[ph_stages]);
-    n_bq_units = n_stages * 2;
-
-    if (n_bq_units_initialised < n_bq_units)
-    {
-        // we need to increase the number of stages
-        for (int k = n_bq_units_initialised; k < n_bq_units; k++)
-        {
-            biquad[k] = new BiquadFilter(storage);
-        }
-
-        n_bq_units_initialised = n_bq_units;
-    }
+    n_stages = limit_range(*(pd_int[ph_stages]), 1, (int)max_stages);
 }
 
 void PhaserEffect::process_only_control()
@@ -111,6 +106,7 @@ void PhaserEffect::process_only_control()
 void PhaserEffect::setvars()
 {
     init_stages();
+    updateParamChanges();
 
     double rate = storage->envelope_rate_linear(-*pd_float[ph_mod_rate]) *
                   (fxdata->p[ph_mod_rate].temposync ? storage->temposyncratio : 1.f);
@@ -135,18 +131,21 @@ void PhaserEffect::setvars()
         modLFOR.pre_process(mwave, rate, depth, 0.5 * *pd_float[ph_stereo]);
     }
 
+    double omegaL[max_stages], omegaR[max_stages];
+    int n_coeff_stages = n_stages;
+
     // if stages is set to 1 to indicate we are in legacy mode, use legacy freqs and spans
     if (n_stages < 2)
     {
         // 4 stages in original phaser mode
+        n_coeff_stages = 2;
+
         for (int i = 0; i < 2; i++)
         {
-            double omega = biquad[2 * i]->calc_omega(2 * *pd_float[ph_center] + legacy_freq[i] +
-                                                     legacy_span[i] * modLFOL.value());
-            biquad[2 * i]->coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
-            omega = biquad[2 * i + 1]->calc_omega(2 * *pd_float[ph_center] + legacy_freq[i] +
-                                                  legacy_span[i] * modLFOR.value());
-            biquad[2 * i + 1]->coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
+            omegaL[i] = lp.calc_omega(2 * *pd_float[ph_center] + legacy_freq[i] +
+                                      legacy_span[i] * modLFOL.value());
+            omegaR[i] = lp.calc_omega(2 * *pd_float[ph_center] + legacy_freq[i] +
+                                      legacy_span[i] * modLFOR.value());
         }
     }
     else
@@ -154,21 +153,54 @@ void PhaserEffect::setvars()
         for (int i = 0; i < n_stages; i++)
         {
             double center = powf(2, (i + 1.0) * 2 / n_stages);
-            double omega =
-                biquad[2 * i]->calc_omega(2 * *pd_float[ph_center] + *pd_float[ph_spread] * center +
-                                          2.0 / (i + 1) * modLFOL.value());
-            biquad[2 * i]->coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
-            omega = biquad[2 * i + 1]->calc_omega(2 * *pd_float[ph_center] +
-                                                  *pd_float[ph_spread] * center +
-                                                  (2.0 / (i + 1) * modLFOR.value()));
-            biquad[2 * i + 1]->coeff_APF(omega, 1.0 + 0.8 * *pd_float[ph_sharpness]);
+            omegaL[i] = lp.calc_omega(2 * *pd_float[ph_center] + *pd_float[ph_spread] * center +
+                                      2.0 / (i + 1) * modLFOL.value());
+            omegaR[i] = lp.calc_omega(2 * *pd_float[ph_center] + *pd_float[ph_spread] * center +
+                                      (2.0 / (i + 1) * modLFOR.value()));
+        }
+    }
+
+    const double q = 1.0 + 0.8 * *pd_float[ph_sharpness];
+    const auto rampInv = _mm_set1_pd(1.0 / (BLOCK_SIZE * slowrate));
+
+    for (int i = 0; i < n_coeff_stages; i++)
+    {
+        double a1L, a2L, a1R, a2R;
+        allpassCoefficients(omegaL[i], q, a1L, a2L);
+        allpassCoefficients(omegaR[i], q, a1R, a2R);
+
+        auto &st = stages[i];
+        // the last ramp ended on its target up to rounding, so restart from there exactly
+        st.a1 = st.targetA1;
+        st.a2 = st.targetA2;
+        st.targetA1 = _mm_set_pd(a1R, a1L);
+        st.targetA2 = _mm_set_pd(a2R, a2L);
+
+        if (i >= n_stages_running)
+        {
+            // a stage coming into use starts on its coefficients with nothing in it
+            st.a1 = st.targetA1;
+            st.a2 = st.targetA2;
+            st.z1 = _mm_setzero_pd();
+            st.z2 = _mm_setzero_pd();
         }
+
+        st.da1 = _mm_mul_pd(_mm_sub_pd(st.targetA1, st.a1), rampInv);
+        st.da2 = _mm_mul_pd(_mm_sub_pd(st.targetA2, st.a2), rampInv);
     }
 
+    n_stages_running = n_coeff_stages;
+
     feedback.newValue(0.95f * *pd_float[ph_feedback]);
     tone.newValue(clamp1bp(*pd_float[ph_tone]));
     width.set_target_smoothed(storage->db_to_linear(*pd_float[ph_width]));
 
+    // the all-passes follow the LFO, but the tone filters only move with the smoothed tone
+    if (!paramChanged(ph_tone) && tone.v == toneCoeffValue)
+        return;
+
+    toneCoeffValue = tone.v;
+
     // lowpass range is from MIDI note 136 down to 57 (~21.1 kHz down to 220 Hz)
     // highpass range is from MIDI note 34 to 136(~61 Hz to ~21.1 kHz)
     float clo = -12, cmid = 67, chi = -33;
@@ -210,12 +242,27 @@ void PhaserEffect::process(float *dataL, float *dataR)
         dL = limit_range(dL, -32.f, 32.f);
         dR = limit_range(dR, -32.f, 32.f);
 
+        // transposed direct form II, both channels at once
+        auto x = _mm_set_pd(dR, dL);
+
         for (int curr_stage = 0; curr_stage < n_stages; curr_stage++)
         {
-            dL = biquad[2 * curr_stage]->process_sample(dL);
-            dR = biquad[2 * curr_stage + 1]->process_sample(dR);
+            auto &st = stages[curr_stage];
+
+            st.a1 = _mm_add_pd(st.a1, st.da1);
+            st.a2 = _mm_add_pd(st.a2, st.da2);
+
+            auto y = _mm_add_pd(_mm_mul_pd(st.a2, x), st.z1);
+            st.z1 = _mm_add_pd(_mm_mul_pd(st.a1, _mm_sub_pd(x, y)), st.z2);
+            st.z2 = _mm_sub_pd(x, _mm_mul_pd(st.a2, y));
+            x = y;
         }
 
+        double out alignas(16)[2];
+        _mm_store_pd(out, x);
+        dL = out[0];
+        dR = out[1];
+
         L[i] = dL;
         R[i] = dR;
     }
@@ -72,13 +72,25 @@ class PhaserEffect : public Effect
 
   private:
     lipol<float, true> feedback, tone;
+    float toneCoeffValue{0.f};
     static constexpr int max_stages = 16;
     static constexpr int default_stages = 4;
     int n_stages = default_stages;
-    int n_bq_units = default_stages << 1;
-    int n_bq_units_initialised = 0;
     float dL, dR;
-    BiquadFilter *biquad[max_stages * 2], lp, hp;
+    BiquadFilter lp, hp;
+
+    /*
+     * The all-pass cascade, with the left and right channel of each stage as the two lanes of a
+     * double vector. An all-pass biquad has b0 = a2, b1 = a1 and b2 = 1, so a1 and a2 describe a
+     * stage; setvars sets their targets once per slowrate blocks and they ramp linearly towards
+     * them per sample, rather than every coefficient running a lag of its own.
+     */
+    struct AllpassStage
+    {
+        __m128d a1, a2, da1, da2, targetA1, targetA2, z1, z2;
+    };
+    AllpassStage stages alignas(16)[max_stages]{};
+    int n_stages_running{0};
     int bi; // block increment (to keep track of events not occurring every n blocks)
     void init_stages();
 
@@ -201,10 +201,12 @@ void ResonatorEffect::process(float *dataL, float *dataR)
     {
         // preprocess audio in through asymmetric waveshaper
         // this mimics Polymoog's power supply which only operated on positive rails
-        dataOS[0][s] =
-            storage->lookup_waveshape(sst::waveshapers::WaveshaperType::wst_asym, dataOS[0][s]);
-        dataOS[1][s] =
-            storage->lookup_waveshape(sst::waveshapers::WaveshaperType::wst_asym, dataOS[1][s]);
+        float shaped alignas(16)[4];
+        _mm_store_ps(shaped, storage->lookup_waveshape(sst::waveshapers::WaveshaperType::wst_asym,
+                                                       _mm_setr_ps(dataOS[0][s], dataOS[1][s],
+                                                                   0.f, 0.f)));
+        dataOS[0][s] = shaped[0];
+        dataOS[1][s] = shaped[1];
 
         auto l128 = _mm_setzero_ps();
         auto r128 = _mm_setzero_ps();
@@ -220,28 +222,22 @@ void ResonatorEffect::process(float *dataL, float *dataR)
             r128 = _mm_set1_ps(dataOS[1][s]);
         }
 
-        float mixl = 0, mixr = 0;
-        float tl[4], tr[4];
-
-        _mm_store_ps(tl, l128);
-        _mm_store_ps(tr, r128);
+        // the bands are lanes of l128 and r128; pair them up as (left, right) for each band
+        auto lo = _mm_unpacklo_ps(l128, r128), hi = _mm_unpackhi_ps(l128, r128);
+        __m128 band[3] = {lo, _mm_movehl_ps(lo, lo), hi};
+        auto mixlr = _mm_setzero_ps();
 
         for (int i = 0; i < 3; ++i)
         {
+            auto g = _mm_mul_ps(band[i], _mm_set1_ps(bandGain[i].v));
+
             if (whichModel == 2 && i == 1)
-            {
-                mixl -= tl[i] * bandGain[i].v;
-                mixr -= tr[i] * bandGain[i].v;
-            }
+                mixlr = _mm_sub_ps(mixlr, g);
             else
-            {
-                mixl += tl[i] * bandGain[i].v;
-                mixr += tr[i] * bandGain[i].v;
-            }
+                mixlr = _mm_add_ps(mixlr, g);
 
             // soft-clip output for good measure
-            mixl = storage->lookup_waveshape(sst::waveshapers::WaveshaperType::wst_soft, mixl);
-            mixr = storage->lookup_waveshape(sst::waveshapers::WaveshaperType::wst_soft, mixr);
+            mixlr = storage->lookup_waveshape(sst::waveshapers::WaveshaperType::wst_soft, mixlr);
 
             // lag class only works at BLOCK_SIZE time, not BLOCK_SIZE_OS, so call process every
             // other sample
@@ -253,8 +249,10 @@ void ResonatorEffect::process(float *dataL, float *dataR)
             }
         }
 
-        dataOS[0][s] = mixl;
-        dataOS[1][s] = mixr;
+        float mixed alignas(16)[4];
+        _mm_store_ps(mixed, mixlr);
+        dataOS[0][s] = mixed[0];
+        dataOS[1][s] = mixed[1];
     }
 
     /* preserve those registers and stuff */
@@ -52,28 +52,6 @@ Reverb2Effect::delay::delay()
 
 void Reverb2Effect::delay::setLen(int len) { _len = std::clamp(len, 0, MAX_DELAY_LEN - 1); }
 
-float Reverb2Effect::delay::process(float in, int tap1, float &tap_out1, int tap2, float &tap_out2,
-                                    int modulation)
-{
-    _k = (_k + 1) & DELAY_LEN_MASK;
-
-    tap_out1 = _data[(_k - tap1) & DELAY_LEN_MASK];
-    tap_out2 = _data[(_k - tap2) & DELAY_LEN_MASK];
-
-    int modulation_int = modulation >> DELAY_SUBSAMPLE_BITS;
-    int modulation_frac1 = modulation & (DELAY_SUBSAMPLE_RANGE - 1);
-    int modulation_frac2 = DELAY_SUBSAMPLE_RANGE - modulation_frac1;
-
-    float d1 = _data[(_k - _len + modulation_int + 1) & DELAY_LEN_MASK];
-    float d2 = _data[(_k - _len + modulation_int) & DELAY_LEN_MASK];
-    const float multiplier = 1.f / (float)(DELAY_SUBSAMPLE_RANGE);
-
-    float result = (d1 * (float)modulation_frac1 + d2 * (float)modulation_frac2) * multiplier;
-    _data[_k] = in;
-
-    return result;
-}
-
 Reverb2Effect::onepole_filter::onepole_filter() { a0 = 0.f; }
 
 float Reverb2Effect::onepole_filter::process_lowpass(float x, float c0)
@@ -201,6 +179,41 @@ void Reverb2Effect::process(float *dataL, float *dataR)
                           (fxdata->p[rev2_predelay].temposync ? storage->temposyncratio_inv : 1.f)),
                     1, PREDELAY_BUFFER_SIZE_LIMIT - 1);
 
+    /*
+     * Energy in the predelay or anywhere in the tank reaches the taps within the predelay
+     * plus one trip round the loop, which is a bit under a second at the nominal size. With
+     * the mix all the way down the output says nothing about the tank, so never sleep.
+     */
+    if (*pd_float[rev2_mix] > 0.001f)
+        silent_tail_blocks = (pdt + (int)(storage->samplerate * scale)) / BLOCK_SIZE + 1;
+    else
+        silent_tail_blocks = -1;
+
+    float tankIn alignas(16)[BLOCK_SIZE];
+    float delayOut alignas(16)[BLOCK_SIZE][NUM_BLOCKS];
+    int heads alignas(16)[NUM_BLOCKS], lens alignas(16)[NUM_BLOCKS];
+    int idx1 alignas(16)[NUM_BLOCKS], idx2 alignas(16)[NUM_BLOCKS];
+    int tapsL alignas(16)[NUM_BLOCKS], tapsR alignas(16)[NUM_BLOCKS];
+    float d1 alignas(16)[NUM_BLOCKS], d2 alignas(16)[NUM_BLOCKS];
+
+    for (int b = 0; b < NUM_BLOCKS; b++)
+    {
+        heads[b] = _delay[b].head();
+        lens[b] = _delay[b].length();
+    }
+
+    const auto lenMask = _mm_set1_epi32(DELAY_LEN_MASK);
+    const auto fracMask = _mm_set1_epi32(DELAY_SUBSAMPLE_RANGE - 1);
+    const auto fracRange = _mm_set1_epi32(DELAY_SUBSAMPLE_RANGE);
+    const auto one = _mm_set1_epi32(1);
+    const auto multiplier = _mm_set1_ps(1.f / (float)(DELAY_SUBSAMPLE_RANGE));
+    const auto lenv = _mm_load_si128((const __m128i *)lens);
+    const auto tapLv = _mm_loadu_si128((const __m128i *)_tap_timeL);
+    const auto tapRv = _mm_loadu_si128((const __m128i *)_tap_timeR);
+    auto headv = _mm_load_si128((const __m128i *)heads);
+
+    // Nothing the input chain or the delay reads depend on comes out of the tank, so run them
+    // for the whole block first, with the four delay lines as SIMD lanes.
     for (int k = 0; k < BLOCK_SIZE; k++)
     {
         float in = (dataL[k] + dataR[k]) * 0.5f;
@@ -211,22 +224,59 @@ void Reverb2Effect::process(float *dataL, float *dataR)
         in = _input_allpass[1].process(in, _diffusion.v);
         in = _input_allpass[2].process(in, _diffusion.v);
         in = _input_allpass[3].process(in, _diffusion.v);
-        float x = _state;
+        tankIn[k] = in;
+
+        auto lfos = _mm_setr_ps(_lfo.r, _lfo.i, -_lfo.r, -_lfo.i);
+        auto modulation = _mm_cvttps_epi32(
+            _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(_modulation.v), lfos),
+                       _mm_set1_ps((float)DELAY_SUBSAMPLE_RANGE)));
+
+        headv = _mm_and_si128(_mm_add_epi32(headv, one), lenMask);
+
+        auto modulation_int = _mm_srai_epi32(modulation, DELAY_SUBSAMPLE_BITS);
+        auto modulation_frac1 = _mm_and_si128(modulation, fracMask);
+        auto modulation_frac2 = _mm_sub_epi32(fracRange, modulation_frac1);
+        auto base = _mm_add_epi32(_mm_sub_epi32(headv, lenv), modulation_int);
+
+        _mm_store_si128((__m128i *)idx1, _mm_and_si128(_mm_add_epi32(base, one), lenMask));
+        _mm_store_si128((__m128i *)idx2, _mm_and_si128(base, lenMask));
+        _mm_store_si128((__m128i *)tapsL, _mm_and_si128(_mm_sub_epi32(headv, tapLv), lenMask));
+        _mm_store_si128((__m128i *)tapsR, _mm_and_si128(_mm_sub_epi32(headv, tapRv), lenMask));
 
         float outL = 0.f;
         float outR = 0.f;
 
-        float lfos[NUM_BLOCKS];
-        lfos[0] = _lfo.r;
-        lfos[1] = _lfo.i;
-        lfos[2] = -_lfo.r;
-        lfos[3] = -_lfo.i;
+        for (int b = 0; b < NUM_BLOCKS; b++)
+        {
+            d1[b] = _delay[b].at(idx1[b]);
+            d2[b] = _delay[b].at(idx2[b]);
+            outL += _delay[b].at(tapsL[b]) * _tap_gainL[b];
+            outR += _delay[b].at(tapsR[b]) * _tap_gainR[b];
+        }
+
+        auto result = _mm_mul_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_load_ps(d1), _mm_cvtepi32_ps(modulation_frac1)),
+                       _mm_mul_ps(_mm_load_ps(d2), _mm_cvtepi32_ps(modulation_frac2))),
+            multiplier);
+        _mm_store_ps(delayOut[k], result);
+
+        wetL[k] = outL;
+        wetR[k] = outR;
+        _diffusion.process();
+        _lfo.process();
+        _modulation.process();
+    }
+
+    // which leaves only the feedback loop itself running a sample at a time
+    for (int k = 0; k < BLOCK_SIZE; k++)
+    {
+        float x = _state;
 
         auto hdc = limit_range(_hf_damp_coefficent.v, 0.01f, 0.99f);
         auto ldc = limit_range(_lf_damp_coefficent.v, 0.01f, 0.99f);
         for (int b = 0; b < NUM_BLOCKS; b++)
         {
-            x = x + in;
+            x = x + tankIn[k];
             for (int c = 0; c < NUM_ALLPASSES_PER_BLOCK; c++)
             {
                 x = _allpass[b][c].process(x, _buildup.v);
@@ -235,25 +285,16 @@ void Reverb2Effect::process(float *dataL, float *dataR)
             x = _hf_damper[b].process_lowpass(x, hdc);
             x = _lf_damper[b].process_highpass(x, ldc);
 
-            int modulation = (int)(_modulation.v * lfos[b] * (float)DELAY_SUBSAMPLE_RANGE);
-            float tap_outL = 0.f;
-            float tap_outR = 0.f;
-            x = _delay[b].process(x, _tap_timeL[b], tap_outL, _tap_timeR[b], tap_outR, modulation);
-            outL += tap_outL * _tap_gainL[b];
-            outR += tap_outR * _tap_gainR[b];
+            _delay[b].write(x);
+            x = delayOut[k][b];
 
             x *= _decay_multiply.v;
         }
 
-        wetL[k] = outL;
-        wetR[k] = outR;
         _state = x;
         _decay_multiply.process();
-        _diffusion.process();
         _buildup.process();
         _hf_damp_coefficent.process();
-        _lfo.process();
-        _modulation.process();
     }
 
     // scale width
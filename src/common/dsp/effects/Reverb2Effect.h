@@ -54,13 +54,24 @@ class Reverb2Effect : public Effect
         float _data[MAX_ALLPASS_LEN];
     };
 
+    /*
+     * The tank never reads a delay line less than a block behind its write head (the shortest
+     * tap is tens of milliseconds even at the smallest room size), so process() makes all of a
+     * block's reads up front, four lines at a time, and only the writes stay in the serial loop.
+     */
     class delay
     {
       public:
         delay();
-        float process(float x, int tap1, float &tap_out1, int tap2, float &tap_out2,
-                      int modulation);
+        void write(float x)
+        {
+            _k = (_k + 1) & DELAY_LEN_MASK;
+            _data[_k] = x;
+        }
         void setLen(int len);
+        int head() const { return _k; }
+        int length() const { return _len; }
+        float at(int idx) const { return _data[idx]; }
 
       private:
         int _len;
@@ -117,6 +128,7 @@ class Reverb2Effect : public Effect
     virtual const char *group_label(int id) override;
     virtual int group_label_ypos(int id) override;
     virtual int get_ringout_decay() override { return ringout_time; }
+    virtual int get_silent_tail_blocks() override { return silent_tail_blocks; }
 
     enum rev2_params
     {
@@ -140,6 +152,7 @@ class Reverb2Effect : public Effect
   private:
     void update_rtime();
     int ringout_time;
+    int silent_tail_blocks{-1};
     allpass _input_allpass[NUM_INPUT_ALLPASSES];
     allpass _allpass[NUM_BLOCKS][NUM_ALLPASSES_PER_BLOCK];
     onepole_filter _hf_damper[NUM_BLOCKS];
@@ -138,6 +138,11 @@ void RingModulatorEffect::process(float *dataL, float *dataR)
     for (int i = 0; i < ub; ++i)
     {
         float resL = 0, resR = 0;
+
+        // the carrier mixing is done in double, as it always was, with both channels as lanes
+        auto halfIn = _mm_mul_pd(_mm_set1_pd(0.5),
+                                 _mm_cvtps_pd(_mm_setr_ps(dataOS[0][i], dataOS[1][i], 0.f, 0.f)));
+
         for (int u = 0; u < uni; ++u)
         {
             // TODO efficiency of course
@@ -152,22 +157,27 @@ void RingModulatorEffect::process(float *dataL, float *dataR)
                 phase[u] -= (int)phase[u];
             }
 
-            for (int c = 0; c < 2; ++c)
-            {
-                auto vin = (c == 0 ? dataOS[0][i] : dataOS[1][i]);
-                auto wd = 1.0;
+            auto vcd = _mm_set1_pd(vc);
+            auto A = _mm_cvtpd_ps(_mm_add_pd(halfIn, vcd));
+            auto B = _mm_cvtpd_ps(_mm_sub_pd(vcd, halfIn));
+
+            // lanes are A left, A right, B left, B right
+            auto AB = _mm_movelh_ps(A, B);
+            auto dP = diode_sim(AB);
+            auto dM = diode_sim(_mm_xor_ps(AB, _mm_set1_ps(-0.f)));
 
-                auto A = 0.5 * vin + vc;
-                auto B = vc - 0.5 * vin;
+            // dPA + dMA - dPB - dMB, in that order, for each channel in the low two lanes
+            auto sum = _mm_add_ps(dP, dM);
+            sum = _mm_sub_ps(sum, _mm_movehl_ps(dP, dP));
+            sum = _mm_sub_ps(sum, _mm_movehl_ps(dM, dM));
 
-                float dPA = diode_sim(A);
-                float dMA = diode_sim(-A);
-                float dPB = diode_sim(B);
-                float dMB = diode_sim(-B);
+            float res alignas(16)[4];
+            _mm_store_ps(res, sum);
 
-                float res = dPA + dMA - dPB - dMB;
-                resL += res * panL[u];
-                resR += res * panR[u];
+            for (int c = 0; c < 2; ++c)
+            {
+                resL += res[c] * panL[u];
+                resR += res[c] * panR[u];
             }
         }
 
@@ -322,3 +332,24 @@ float RingModulatorEffect::diode_sim(float v)
     auto vlvb = vl - vb;
     return h * v - h * vl + h * vlvb * vlvb / (2.f * vl - 2.f * vb);
 }
+
+__m128 RingModulatorEffect::diode_sim(__m128 v)
+{
+    auto vb = *(pd_float[rm_diode_fwdbias]);
+    auto vl = *(pd_float[rm_diode_linregion]);
+    vl = std::max(vl, vb + 0.02f);
+
+    auto vlvb = vl - vb;
+    auto den = _mm_set1_ps(2.f * vl - 2.f * vb);
+    auto vbv = _mm_set1_ps(vb), vlv = _mm_set1_ps(vl);
+
+    auto vvb = _mm_sub_ps(v, vbv);
+    auto quad = _mm_div_ps(_mm_mul_ps(vvb, vvb), den);
+    auto lin = _mm_add_ps(_mm_sub_ps(v, vlv),
+                          _mm_div_ps(_mm_set1_ps(vlvb * vlvb), den));
+
+    auto inQuad = _mm_cmplt_ps(v, vlv);
+    auto res = _mm_or_ps(_mm_and_ps(inQuad, quad), _mm_andnot_ps(inQuad, lin));
+
+    return _mm_andnot_ps(_mm_cmplt_ps(v, vbv), res);
+}
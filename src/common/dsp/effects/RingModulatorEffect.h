@@ -54,6 +54,7 @@ class RingModulatorEffect : public Effect
                                            int currentSynthStreamingRevision) override;
 
     float diode_sim(float x);
+    __m128 diode_sim(__m128 x);
 
     enum ringmod_params
     {
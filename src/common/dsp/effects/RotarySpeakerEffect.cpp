@@ -20,6 +20,10 @@
  * https://github.com/surge-synthesizer/surge
  */
 #include "RotarySpeakerEffect.h"
+#include "sst/basic-blocks/mechanics/block-ops.h"
+#include "sst/basic-blocks/mechanics/simd-ops.h"
+
+namespace mech = sst::basic_blocks::mechanics;
 
 using namespace std;
 
@@ -34,7 +38,7 @@ RotarySpeakerEffect::~RotarySpeakerEffect() {}
 
 void RotarySpeakerEffect::init()
 {
-    memset(buffer, 0, max_delay_length * sizeof(float));
+    memset(buffer, 0, sizeof(buffer));
 
     wpos = 0;
 
@@ -66,7 +70,7 @@ void RotarySpeakerEffect::setvars(bool init)
 
 void RotarySpeakerEffect::suspend()
 {
-    memset(buffer, 0, max_delay_length * sizeof(float));
+    memset(buffer, 0, sizeof(buffer));
     xover.suspend();
     lowbass.suspend();
     wpos = 0;
@@ -227,7 +231,7 @@ void RotarySpeakerEffect::process(float *dataL, float *dataR)
     ** This is a set of completely empirical scaling settings to offset gain being too crazy
     ** in the drive cycle. There's no science really, just us playing with it and listening
     */
-    float gain_tweak{1.f}, compensate{1.f}, drive_factor{1.f}, gain_comp_factor{1.0};
+    float gain_tweak{1.f}, compensate{1.f}, gain_comp_factor{1.0};
     float compensateStartsAt = 0.18;
     bool square_drive_comp = false;
 
@@ -278,8 +282,6 @@ void RotarySpeakerEffect::process(float *dataL, float *dataR)
 
     if (!fxdata->p[rot_drive].deactivated)
     {
-        drive_factor = 1.f + (drive.v * drive.v * 15.f);
-
         if (drive.v < compensateStartsAt)
             gain_comp_factor = 1.0;
         else if (square_drive_comp)
@@ -292,90 +294,123 @@ void RotarySpeakerEffect::process(float *dataL, float *dataR)
     bool useSSEShaper = (ws >= sst::waveshapers::WaveshaperType::wst_sine);
     auto wsop = sst::waveshapers::GetQuadWaveshaper(ws);
 
-    for (k = 0; k < BLOCK_SIZE; k++)
+    if (fxdata->p[rot_drive].deactivated)
+    {
+        for (k = 0; k < BLOCK_SIZE; k++)
+            upper[k] = 0.5f * (dataL[k] + dataR[k]);
+    }
+    else
     {
-        float input;
+        float drives alignas(16)[BLOCK_SIZE];
+
+        for (k = 0; k < BLOCK_SIZE; k++)
+        {
+            drives[k] = 1.f + (drive.v * drive.v * 15.f);
+            drive.process();
+        }
 
-        if (!fxdata->p[rot_drive].deactivated)
+        if (useSSEShaper)
         {
-            drive_factor = 1.f + (drive.v * drive.v * 15.f);
-            if (useSSEShaper)
+            // these shapers carry state from sample to sample, so they can't take four at once
+            for (k = 0; k < BLOCK_SIZE; k++)
             {
                 auto inp = _mm_set1_ps(0.5 * (dataL[k] + dataR[k]));
-                auto wsres = wsop(&wsState, inp, _mm_set1_ps(drive_factor));
-                float r[4];
-                _mm_store_ps(r, wsres);
-                input = r[0] * gain_tweak;
-            }
-            else
-            {
-                input = storage->lookup_waveshape(ws, 0.5f * (dataL[k] + dataR[k]) * drive_factor) *
-                        gain_tweak;
+                auto wsres = wsop(&wsState, inp, _mm_set1_ps(drives[k]));
+                upper[k] = _mm_cvtss_f32(wsres);
             }
-            input /= gain_comp_factor;
-
-            drive.process();
         }
         else
         {
-            input = 0.5f * (dataL[k] + dataR[k]);
+            const auto half = _mm_set1_ps(0.5f);
+
+            for (k = 0; k < BLOCK_SIZE; k += 4)
+            {
+                auto inp = _mm_mul_ps(
+                    half, _mm_add_ps(_mm_load_ps(dataL + k), _mm_load_ps(dataR + k)));
+                inp = _mm_mul_ps(inp, _mm_load_ps(drives + k));
+                _mm_store_ps(upper + k, storage->lookup_waveshape(ws, inp));
+            }
         }
 
-        upper[k] = input;
-        lower[k] = input;
+        const auto scale = _mm_set1_ps(gain_tweak / gain_comp_factor);
+
+        for (k = 0; k < BLOCK_SIZE; k += 4)
+            _mm_store_ps(upper + k, _mm_mul_ps(_mm_load_ps(upper + k), scale));
     }
 
+    mech::copy_from_to<BLOCK_SIZE>(upper, lower);
     xover.process_block(lower);
 
+    // the horn gets what the crossover leaves above 800 Hz. Both of its taps sit at least
+    // BLOCK_SIZE back, so the whole block can go into the delay line before either reads
     for (k = 0; k < BLOCK_SIZE; k++)
     {
-        // feed delay input
-        int wp = (wpos + k) & (max_delay_length - 1);
         lower_sub[k] = lower[k];
         upper[k] -= lower[k];
-        buffer[wp] = upper[k];
+        buffer[(wpos + k) & (max_delay_length - 1)] = upper[k];
+    }
+
+    // copy buffer so FIR-core doesn't have to wrap
+    if (wpos == 0)
+        for (k = 0; k < FIRipol_N; k++)
+            buffer[k + max_delay_length] = buffer[k];
+
+    const float *sinc = storage->sinctable1X;
 
+    for (k = 0; k < BLOCK_SIZE; k++)
+    {
         int i_dtimeL = max(BLOCK_SIZE, min((int)dL.v, max_delay_length - FIRipol_N - 1));
         int i_dtimeR = max(BLOCK_SIZE, min((int)dR.v, max_delay_length - FIRipol_N - 1));
 
-        int rpL = (wpos - i_dtimeL + k);
-        int rpR = (wpos - i_dtimeR + k);
+        // the first of the FIRipol_N taps each side reads, oldest first
+        int rpL = (wpos - i_dtimeL + k - (FIRipol_N - 1)) & (max_delay_length - 1);
+        int rpR = (wpos - i_dtimeR + k - (FIRipol_N - 1)) & (max_delay_length - 1);
 
-        int sincL = FIRipol_N *
-                    limit_range((int)(FIRipol_M * (float(i_dtimeL + 1) - dL.v)), 0, FIRipol_M - 1);
-        int sincR = FIRipol_N *
-                    limit_range((int)(FIRipol_M * (float(i_dtimeR + 1) - dR.v)), 0, FIRipol_M - 1);
+        int sincL = 1 + FIRipol_N * limit_range((int)(FIRipol_M * (float(i_dtimeL + 1) - dL.v)),
+                                                0, FIRipol_M - 1);
+        int sincR = 1 + FIRipol_N * limit_range((int)(FIRipol_M * (float(i_dtimeR + 1) - dR.v)),
+                                                0, FIRipol_M - 1);
 
         // get delay output
-        tbufferL[k] = 0;
-        tbufferR[k] = 0;
-        for (int i = 0; i < FIRipol_N; i++)
-        {
-            tbufferL[k] += buffer[(rpL - i) & (max_delay_length - 1)] *
-                           storage->sinctable1X[sincL + FIRipol_N - i];
-            tbufferR[k] += buffer[(rpR - i) & (max_delay_length - 1)] *
-                           storage->sinctable1X[sincR + FIRipol_N - i];
-        }
+        tbufferL[k] = read_horn_tap(&buffer[rpL], &sinc[sincL]);
+        tbufferR[k] = read_horn_tap(&buffer[rpR], &sinc[sincR]);
+
         dL.process();
         dR.process();
     }
 
     lowbass.process_block(lower_sub);
 
+    // the drum's amplitude and the horn's, per sample, so the mix below can take four at once
+    float drumamp alignas(16)[BLOCK_SIZE];
+    float hornampL alignas(16)[BLOCK_SIZE];
+    float hornampR alignas(16)[BLOCK_SIZE];
+
     for (k = 0; k < BLOCK_SIZE; k++)
     {
-        lower[k] -= lower_sub[k];
-
-        float bass = lower_sub[k] + lower[k] * (lf_lfo.r * 0.6f + 0.3f);
-
-        wbL[k] = hornamp[0].v * tbufferL[k] + bass;
-        wbR[k] = hornamp[1].v * tbufferR[k] + bass;
+        drumamp[k] = lf_lfo.r * 0.6f + 0.3f;
+        hornampL[k] = hornamp[0].v;
+        hornampR[k] = hornamp[1].v;
 
         lf_lfo.process();
         hornamp[0].process();
         hornamp[1].process();
     }
 
+    for (k = 0; k < BLOCK_SIZE; k += 4)
+    {
+        auto sub = _mm_load_ps(lower_sub + k);
+        auto drum = _mm_sub_ps(_mm_load_ps(lower + k), sub);
+        auto bass = _mm_add_ps(sub, _mm_mul_ps(drum, _mm_load_ps(drumamp + k)));
+
+        _mm_store_ps(wbL + k, _mm_add_ps(_mm_mul_ps(_mm_load_ps(hornampL + k),
+                                                    _mm_load_ps(tbufferL + k)),
+                                         bass));
+        _mm_store_ps(wbR + k, _mm_add_ps(_mm_mul_ps(_mm_load_ps(hornampR + k),
+                                                    _mm_load_ps(tbufferR + k)),
+                                         bass));
+    }
+
     // scale width
     applyWidth(wbL, wbR, width);
 
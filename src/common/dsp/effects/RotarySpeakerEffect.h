@@ -31,6 +31,7 @@
 
 #include "sst/waveshapers.h"
 #include "sst/basic-blocks/dsp/QuadratureOscillators.h"
+#include "sst/basic-blocks/mechanics/simd-ops.h"
 
 class RotarySpeakerEffect : public Effect
 {
@@ -69,8 +70,19 @@ class RotarySpeakerEffect : public Effect
         rot_num_params,
     };
 
+    // one Doppler tap of the horn: the FIRipol_N samples from buffer on, oldest first, under the
+    // sinc kernel starting at sinc
+    static inline float read_horn_tap(const float *buffer, const float *sinc)
+    {
+        auto v = _mm_setzero_ps();
+        for (int i = 0; i < FIRipol_N; i += 4)
+            v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(sinc + i), _mm_loadu_ps(buffer + i)));
+
+        return _mm_cvtss_f32(sst::basic_blocks::mechanics::sum_ps_to_ss(v));
+    }
+
   protected:
-    float buffer[max_delay_length];
+    float buffer alignas(16)[max_delay_length + FIRipol_N]; // padded so the taps read with SSE
     int wpos;
     // filter *lp[2],*hp[2];
     // biquadunit rotor_lpL,rotor_lpR;
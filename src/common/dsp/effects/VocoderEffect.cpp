@@ -21,7 +21,10 @@
  */
 #include "VocoderEffect.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include "globals.h"
+#include "pffft.h"
 #include "sst/basic-blocks/mechanics/block-ops.h"
 namespace mech = sst::basic_blocks::mechanics;
 
@@ -45,6 +48,201 @@ const float vocoder_freq_vsm201[n_vocoder_bands] = {180,  219,  266,  324,  394,
 
 //------------------------------------------------------------------------------------------------
 
+/*
+ * STFT state for the FFT engine. Frames are N samples long with a hop of N/4, and a square root
+ * Hann window on both analysis and resynthesis, so the overlapped windows add up to a constant.
+ * The modulator's bands are measured with triangular weights between band centres and the
+ * carrier's bins are scaled by interpolating between the band levels, so the work per frame
+ * only depends on the number of bins.
+ */
+struct VocoderEffect::Spectral
+{
+    explicit Spectral(float sampleRate)
+    {
+        N = 1024;
+        while (N < 8192 && sampleRate > 50000.f * N / 1024)
+            N *= 2;
+        hop = N / 4;
+
+        setup = pffft_new_setup(N, PFFFT_REAL);
+
+        for (auto *b : {&window, &frame, &spec, &work})
+            *b = alloc(N);
+
+        for (int c = 0; c < 2; ++c)
+        {
+            carrierIn[c] = alloc(N);
+            modIn[c] = alloc(N);
+            accum[c] = alloc(N);
+            out[c] = alloc(hop);
+        }
+
+        for (int i = 0; i < N; ++i)
+            window[i] = std::sin(M_PI * i / N);
+
+        binPitch.resize(N / 2);
+        for (int k = 1; k < N / 2; ++k)
+            binPitch[k] = std::log2(std::max(k * sampleRate / N, 1.f));
+
+        clear();
+    }
+
+    ~Spectral()
+    {
+        for (auto *b : {window, frame, spec, work})
+            pffft_aligned_free(b);
+
+        for (int c = 0; c < 2; ++c)
+        {
+            for (auto *b : {carrierIn[c], modIn[c], accum[c], out[c]})
+                pffft_aligned_free(b);
+        }
+
+        if (setup)
+            pffft_destroy_setup(setup);
+    }
+
+    static float *alloc(int n)
+    {
+        auto res = (float *)pffft_aligned_malloc(n * sizeof(float));
+        memset(res, 0, n * sizeof(float));
+        return res;
+    }
+
+    void clear()
+    {
+        for (int c = 0; c < 2; ++c)
+        {
+            memset(carrierIn[c], 0, N * sizeof(float));
+            memset(modIn[c], 0, N * sizeof(float));
+            memset(accum[c], 0, N * sizeof(float));
+            memset(out[c], 0, hop * sizeof(float));
+        }
+
+        memset(env, 0, sizeof(env));
+        ringPos = 0;
+        collected = 0;
+    }
+
+    // unwrap the last N samples of a ring, oldest first, and window them
+    void windowFrom(const float *ring)
+    {
+        for (int i = 0; i < N; ++i)
+            frame[i] = ring[(ringPos + i) & (N - 1)] * window[i];
+    }
+
+    void runFrame(int nMods, float envRate, float gateLevel, float maxLevel);
+
+    int N, hop;
+    PFFFT_Setup *setup{nullptr};
+    float *window, *frame, *spec, *work;
+    float *carrierIn[2], *modIn[2], *accum[2], *out[2];
+    std::vector<float> binPitch; // log2 Hz of each bin
+
+    int ringPos, collected;
+    float env[2][n_vocoder_bands];
+
+    // set by setvars; band centres are carrierLo + i * carrierStep, in log2 Hz
+    int bands{0};
+    float carrierLo{0}, carrierStep{1}, modLo{0}, modStep{1};
+    float sharpness{1};
+};
+
+void VocoderEffect::Spectral::runFrame(int nMods, float envRate, float gateLevel, float maxLevel)
+{
+    // energy of a frame's bins in terms of the mean square of the signal under the window
+    const float powerNorm = 4.f / ((float)N * N);
+
+    for (int m = 0; m < nMods; ++m)
+    {
+        float energy[n_vocoder_bands]{};
+
+        windowFrom(modIn[m]);
+        pffft_transform_ordered(setup, frame, spec, work, PFFFT_FORWARD);
+
+        for (int k = 1; k < N / 2; ++k)
+        {
+            auto t = (binPitch[k] - modLo) / modStep;
+
+            if (t <= -1.f || t >= bands)
+                continue;
+
+            auto p = spec[2 * k] * spec[2 * k] + spec[2 * k + 1] * spec[2 * k + 1];
+            auto b = (int)std::floor(t);
+            auto fr = t - b;
+
+            if (b >= 0)
+                energy[b] += (1.f - fr) * p;
+            if (b + 1 < bands)
+                energy[b + 1] += fr * p;
+        }
+
+        for (int b = 0; b < bands; ++b)
+        {
+            auto e = std::min(energy[b] * powerNorm, maxLevel);
+
+            if (e < gateLevel)
+                e = 0.f;
+
+            env[m][b] += envRate * (e - env[m][b]);
+        }
+    }
+
+    // the ifft is unscaled, and the overlapped windows sum to two
+    const float outNorm = 0.5f / N;
+
+    for (int c = 0; c < 2; ++c)
+    {
+        float level[n_vocoder_bands];
+        auto &e = env[nMods == 2 ? c : 0];
+
+        for (int b = 0; b < bands; ++b)
+            level[b] = std::sqrt(e[b]);
+
+        windowFrom(carrierIn[c]);
+        pffft_transform_ordered(setup, frame, spec, work, PFFFT_FORWARD);
+
+        // DC and nyquist are never inside a band
+        spec[0] = 0.f;
+        spec[1] = 0.f;
+
+        for (int k = 1; k < N / 2; ++k)
+        {
+            auto t = (binPitch[k] - carrierLo) / carrierStep;
+            float g = 0.f;
+
+            if (t <= -1.f || t >= bands)
+                g = 0.f;
+            else if (t < 0.f)
+                g = level[0] * (1.f + t);
+            else if (t >= bands - 1)
+                g = level[bands - 1] * (bands - t);
+            else
+            {
+                auto b = (int)t;
+                auto fr = std::clamp(0.5f + (t - b - 0.5f) * sharpness, 0.f, 1.f);
+                g = level[b] + (level[b + 1] - level[b]) * fr;
+            }
+
+            spec[2 * k] *= g;
+            spec[2 * k + 1] *= g;
+        }
+
+        pffft_transform_ordered(setup, spec, frame, work, PFFFT_BACKWARD);
+
+        auto a = accum[c];
+
+        for (int i = 0; i < N; ++i)
+            a[i] += frame[i] * window[i] * outNorm;
+
+        memcpy(out[c], a, hop * sizeof(float));
+        memmove(a, a + hop, (N - hop) * sizeof(float));
+        memset(a + N - hop, 0, hop * sizeof(float));
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+
 VocoderEffect::VocoderEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
     : Effect(storage, fxdata, pd), mBI(0)
 {
@@ -61,6 +259,8 @@ VocoderEffect::VocoderEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd
         mEnvF[i] = vZero;
         mEnvFR[i] = vZero;
     }
+
+    spectral = std::make_unique<Spectral>(storage->samplerate);
 }
 
 //------------------------------------------------------------------------------------------------
@@ -69,7 +269,19 @@ VocoderEffect::~VocoderEffect() {}
 
 //------------------------------------------------------------------------------------------------
 
-void VocoderEffect::init() { setvars(true); }
+void VocoderEffect::init()
+{
+    setvars(true);
+    spectral->clear();
+}
+
+//------------------------------------------------------------------------------------------------
+
+void VocoderEffect::sampleRateReset()
+{
+    spectral = std::make_unique<Spectral>(storage->samplerate);
+    setvars(true);
+}
 
 //------------------------------------------------------------------------------------------------
 
@@ -133,6 +345,17 @@ void VocoderEffect::setvars(bool init)
         mdhz = pow(2.f, dM / 12.f);
     }
 
+    if (spectral)
+    {
+        spectral->bands = std::clamp(active_bands, 0, n_vocoder_bands);
+        spectral->carrierLo = std::log2(fb);
+        spectral->carrierStep = std::max(std::log2(dhz), 1e-4f);
+        spectral->modLo = std::log2(mb);
+        spectral->modStep = std::max(std::log2(mdhz), 1e-4f);
+        // the Q control moves the FFT bands between blending into each other and stepping
+        spectral->sharpness = std::pow(2.f, 2.f * *pd_float[voc_q]);
+    }
+
     for (int i = 0; i < active_bands && i < n_vocoder_bands; i++)
     {
         Freq[i & 3] = fb * storage->samplerate_inv;
@@ -187,6 +410,16 @@ void VocoderEffect::process(float *dataL, float *dataR)
     }
     modulator_mode = *(pd_int[voc_mod_input]); // fxdata->p[voc_mod_input].val.i;
     wet = *pd_float[voc_mix];
+
+    auto engine = *pd_int[voc_engine];
+
+    if (engine != last_engine)
+    {
+        // whatever the FFT engine had in flight belongs to another time
+        spectral->clear();
+        last_engine = engine;
+    }
+
     float EnvFRate = 0.001f * powf(2.f, 4.f * *pd_float[voc_envfollow]);
 
     // the left channel variables are used for mono when stereo is disabled
@@ -219,6 +452,26 @@ void VocoderEffect::process(float *dataL, float *dataR)
 
     const vFloat MaxLevel = vLoad1(6.f);
 
+    if (engine == vce_fft)
+    {
+        auto &sp = *spectral;
+        float *mod[2] = {modulator_in, modulator_inR};
+
+        if (modulator_mode == vim_right)
+            mod[0] = modulator_inR;
+
+        processSpectral(dataL, dataR, mod[0], mod[1]);
+
+        if (sp.collected >= sp.hop)
+        {
+            sp.collected = 0;
+            sp.runFrame(modulator_mode == vim_stereo ? 2 : 1,
+                        1.f - std::pow(1.f - EnvFRate, (float)sp.hop), Gate * Gate, 6.f);
+        }
+
+        return;
+    }
+
     // Voiced / Unvoiced detection
     /*   mVoicedDetect.process_block_to(modulator_in, modulator_tbuf);
        float a = min(4.f, get_squaremax(modulator_tbuf,BLOCK_SIZE_QUAD));
@@ -319,8 +572,46 @@ void VocoderEffect::process(float *dataL, float *dataR)
 
 //------------------------------------------------------------------------------------------------
 
+void VocoderEffect::processSpectral(float *dataL, float *dataR, float *modL, float *modR)
+{
+    auto &sp = *spectral;
+    auto mask = sp.N - 1;
+    float *data[2] = {dataL, dataR};
+    float *mod[2] = {modL, modR};
+    float inMul = 1.f - wet;
+
+    for (int c = 0; c < 2; ++c)
+    {
+        auto pos = sp.ringPos;
+        auto wetOut = sp.out[c] + sp.collected;
+
+        for (int k = 0; k < BLOCK_SIZE; k++)
+        {
+            // the ring is exactly one frame long, so what it gives back is the dry signal
+            // delayed to line up with the resynthesis
+            auto dry = sp.carrierIn[c][pos];
+
+            sp.carrierIn[c][pos] = data[c][k];
+            sp.modIn[c][pos] = mod[c][k];
+            data[c][k] = dry * inMul + wet * wetOut[k];
+
+            pos = (pos + 1) & mask;
+        }
+    }
+
+    sp.ringPos = (sp.ringPos + BLOCK_SIZE) & mask;
+    sp.collected += BLOCK_SIZE;
+}
+
+//------------------------------------------------------------------------------------------------
+
 void VocoderEffect::suspend() { init(); }
 
+int VocoderEffect::get_latency_samples()
+{
+    return (fxdata->p[voc_engine].val.i == vce_fft && spectral) ? spectral->N : 0;
+}
+
 //------------------------------------------------------------------------------------------------
 
 void VocoderEffect::init_default_values()
@@ -329,6 +620,7 @@ void VocoderEffect::init_default_values()
     fxdata->p[voc_input_gate].val.f = -96.f;
     fxdata->p[voc_envfollow].val.f = 0.f;
     fxdata->p[voc_q].val.f = 0.f;
+    fxdata->p[voc_engine].val.i = vce_filterbank;
 
     fxdata->p[voc_num_bands].val.i = n_vocoder_bands;
 
@@ -409,6 +701,10 @@ void VocoderEffect::init_ctrltypes()
     fxdata->p[voc_q].set_type(ct_percent_bipolar);
     fxdata->p[voc_q].posy_offset = 3;
 
+    fxdata->p[voc_engine].set_name("Engine");
+    fxdata->p[voc_engine].set_type(ct_vocoder_engine);
+    fxdata->p[voc_engine].posy_offset = 3;
+
     fxdata->p[voc_num_bands].set_name("Bands");
     fxdata->p[voc_num_bands].set_type(ct_vocoder_bandcount);
     fxdata->p[voc_num_bands].posy_offset = 3;
@@ -29,6 +29,7 @@
 
 #include "VectorizedSVFilter.h"
 
+#include <memory>
 #include <vembertech/lipol.h>
 
 const int n_vocoder_bands = 20;
@@ -45,6 +46,12 @@ class VocoderEffect : public Effect
         vim_stereo,
     };
 
+    enum vocoder_engines
+    {
+        vce_filterbank,
+        vce_fft,
+    };
+
     enum vocoder_params
     {
         voc_input_gain,
@@ -52,7 +59,7 @@ class VocoderEffect : public Effect
 
         voc_envfollow,
         voc_q,
-        voc_shift,
+        voc_engine,
 
         voc_num_bands,
         voc_minfreq,
@@ -75,7 +82,9 @@ class VocoderEffect : public Effect
     virtual void init() override;
     virtual void process(float *dataL, float *dataR) override;
     virtual void suspend() override;
+    virtual void sampleRateReset() override;
     virtual int get_ringout_decay() override { return 500; }
+    virtual int get_latency_samples() override;
     void setvars(bool init);
     virtual void init_ctrltypes() override;
     virtual void init_default_values() override;
@@ -99,6 +108,18 @@ class VocoderEffect : public Effect
     int mBI; // block increment (to keep track of events not occurring every n blocks)
     int active_bands;
 
+    /*
+     * The FFT engine works on overlapping STFT frames, so its cost is a handful of FFTs per
+     * hop whatever the band count. It's built for the current sample rate off the audio thread.
+     * Its output, dry signal included, comes a whole frame late: 1024 samples up to 50 kHz,
+     * doubling with each doubling of the rate above that. The filter bank has no latency.
+     */
+    struct Spectral;
+    std::unique_ptr<Spectral> spectral;
+    int last_engine{vce_filterbank};
+    Surge::Storage::AudioInputClient audioInputClient{storage};
+    void processSpectral(float *dataL, float *dataR, float *modL, float *modR);
+
     /*
     float mVoicedLevel;
     float mUnvoicedLevel;
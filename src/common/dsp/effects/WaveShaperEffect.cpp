@@ -31,9 +31,10 @@ namespace mech = sst::basic_blocks::mechanics;
 // http://recherche.ircam.fr/pub/dafx11/Papers/66_e.pdf
 
 WaveShaperEffect::WaveShaperEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
-    : Effect(storage, fxdata, pd), halfbandIN(6, true), halfbandOUT(6, true), lpPre(storage),
-      hpPre(storage), lpPost(storage), hpPost(storage)
+    : Effect(storage, fxdata, pd), lpPre(storage), hpPre(storage), lpPost(storage),
+      hpPost(storage)
 {
+    os.setOSFactor(default_OS_bits);
     mix.set_blocksize(BLOCK_SIZE);
     boost.set_blocksize(BLOCK_SIZE);
 }
@@ -46,8 +47,8 @@ void WaveShaperEffect::setvars(bool init)
 {
     if (init)
     {
-        halfbandOUT.reset();
-        halfbandIN.reset();
+        os.setOSFactor(os.factorForChoice(fxdata->p[ws_drive].deform_type, defaultOSBits()));
+        os.reset();
 
         lpPre.suspend();
         hpPre.suspend();
@@ -97,8 +98,13 @@ void WaveShaperEffect::process(float *dataL, float *dataR)
      * halfband filter dropping our amplitude. Moreover, we need to do
      * that in the db calculation also, which we replicate here to change
      * the clip limits.
+     *
+     * Each halfband stage halves the level, so the compensation is the
+     * oversampling ratio; that is 2 at the default 2x.
      */
-    const auto scalef = 3.f, oscalef = 1.f / 3.f, hbfComp = 2.f;
+    os.setOSFactor(os.factorForChoice(fxdata->p[ws_drive].deform_type, defaultOSBits()));
+
+    const auto scalef = 3.f, oscalef = 1.f / 3.f, hbfComp = (float)os.getOSRatio();
 
     auto x = scalef * *pd_float[ws_drive];
     auto dnv = limit_range(powf(2.f, x / 18.f), 0.f, 8.f);
@@ -142,14 +148,15 @@ void WaveShaperEffect::process(float *dataL, float *dataR)
     auto wsptr = sst::waveshapers::GetQuadWaveshaper(lastShape);
 
     // Now upsample
-    float dataOS alignas(16)[2][BLOCK_SIZE_OS];
-    halfbandIN.process_block_U2(wetL, wetR, dataOS[0], dataOS[1], BLOCK_SIZE_OS);
+    os.upsample(wetL, wetR);
+    float *dataOS[2] = {os.leftUp, os.rightUp};
+    const int upBlockSize = os.getUpBlockSize();
 
     if (wsptr)
     {
         float din alignas(16)[4] = {0, 0, 0, 0};
 
-        for (int i = 0; i < BLOCK_SIZE_OS; ++i)
+        for (int i = 0; i < upBlockSize; ++i)
         {
             din[0] = hbfComp * scalef * dataOS[0][i] + bias.v;
             din[1] = hbfComp * scalef * dataOS[1][i] + bias.v;
@@ -171,10 +178,7 @@ void WaveShaperEffect::process(float *dataL, float *dataR)
         }
     }
 
-    halfbandOUT.process_block_D2(dataOS[0], dataOS[1], BLOCK_SIZE_OS);
-
-    mech::copy_from_to<BLOCK_SIZE>(dataOS[0], wetL);
-    mech::copy_from_to<BLOCK_SIZE>(dataOS[1], wetR);
+    os.downsample(wetL, wetR);
 
     // Apply the filters
     hpPost.coeff_HP(hpPre.calc_omega(*pd_float[ws_postlowcut] / 12.0), 0.707);
@@ -245,7 +249,7 @@ void WaveShaperEffect::init_ctrltypes()
     fxdata->p[ws_bias].set_name("Bias");
     fxdata->p[ws_bias].set_type(ct_percent_bipolar);
     fxdata->p[ws_drive].set_name("Drive");
-    fxdata->p[ws_drive].set_type(ct_decibel_narrow_short_extendable);
+    fxdata->p[ws_drive].set_type(ct_waveshaper_drive);
 
     fxdata->p[ws_postlowcut].set_name("Low Cut");
     fxdata->p[ws_postlowcut].set_type(ct_freq_audible_deactivatable_hp);
@@ -30,7 +30,7 @@
 #include <vembertech/lipol.h>
 
 #include "sst/waveshapers.h"
-#include <sst/filters/HalfRateFilter.h>
+#include "chowdsp/shared/Oversampling.h"
 
 class WaveShaperEffect : public Effect
 {
@@ -66,7 +66,14 @@ class WaveShaperEffect : public Effect
   private:
     sst::waveshapers::WaveshaperType lastShape{sst::waveshapers::WaveshaperType::wst_none};
     sst::waveshapers::QuadWaveshaperState wss;
-    sst::filters::HalfRate::HalfRateFilter halfbandOUT, halfbandIN;
+    // up to 8x; the drive parameter's deform_type picks the ratio and the default is 2x
+    static constexpr int max_OS_bits = 3, default_OS_bits = 1;
+    // rendering offline, the default choice goes as high as we can
+    int defaultOSBits() const
+    {
+        return storage->useHighestQuality() ? max_OS_bits : default_OS_bits;
+    }
+    chowdsp::VariableOversampling<max_OS_bits, BLOCK_SIZE, 6, true> os;
     BiquadFilter lpPre, hpPre, lpPost, hpPost;
     lipol_ps_blocksz mix alignas(16), boost alignas(16);
     lag<float> drive, bias;
@@ -248,6 +248,54 @@ void AirWindowsEffect::process(float *dataL, float *dataR)
     constexpr int QBLOCK = BLOCK_SIZE >> subblock_factor;
     float outL alignas(16)[BLOCK_SIZE], outR alignas(16)[BLOCK_SIZE];
 
+    /*
+     * We split the block up so the parameter lags can move during it. Each processReplacing
+     * call recomputes everything its algorithm derives from its parameters though, which
+     * for a lot of them costs as much as the samples do, so once every lag has arrived we
+     * hand the algorithm the whole block in one go.
+     */
+    bool settled = true;
+
+    for (int i = 0; i < airwin->paramCount && i < n_fx_params - 1; ++i)
+    {
+        if (fxdata->p[i + 1].ctrltype == ct_airwindows_param_integral)
+            continue;
+
+        param_lags[i].newValue(clamp01(*pd_float[i + 1]));
+
+        if (std::fabs(param_lags[i].v - clamp01(*pd_float[i + 1])) > 1e-6f)
+        {
+            settled = false;
+            break;
+        }
+    }
+
+    if (settled)
+    {
+        for (int i = 0; i < airwin->paramCount && i < n_fx_params - 1; ++i)
+        {
+            if (fxdata->p[i + 1].ctrltype == ct_airwindows_param_integral)
+            {
+                airwin->setParameter(i, fxdata->p[i + 1].get_value_f01());
+            }
+            else
+            {
+                param_lags[i].instantize();
+                airwin->setParameter(i, param_lags[i].v);
+            }
+        }
+
+        float *in[2] = {dataL, dataR};
+        float *out[2] = {outL, outR};
+
+        airwin->processReplacing(in, out, BLOCK_SIZE);
+
+        mech::copy_from_to<BLOCK_SIZE>(outL, dataL);
+        mech::copy_from_to<BLOCK_SIZE>(outR, dataR);
+
+        return;
+    }
+
     for (int subb = 0; subb < 1 << subblock_factor; ++subb)
     {
         for (int i = 0; i < airwin->paramCount && i < n_fx_params - 1; ++i)
@@ -37,6 +37,8 @@ NeuronEffect::~NeuronEffect() {}
 
 void NeuronEffect::init()
 {
+    modLFO.seed(storage->rand_u32());
+
     Wf.reset(numSteps);
     Wh.reset(numSteps);
     Uf.reset(numSteps);
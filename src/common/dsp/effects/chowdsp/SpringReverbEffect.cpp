@@ -35,6 +35,7 @@ SpringReverbEffect::SpringReverbEffect(SurgeStorage *storage, FxStorage *fxdata,
 void SpringReverbEffect::init()
 {
     proc.prepare(storage->samplerate, BLOCK_SIZE);
+    proc.seed(storage->rand_u32());
 
     mix.set_target(1.f);
     mix.instantize();
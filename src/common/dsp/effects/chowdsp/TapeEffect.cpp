@@ -48,7 +48,9 @@ void TapeEffect::init()
     mech::clear_block<BLOCK_SIZE>(R);
 
     degrade.prepareToPlay((float)storage->samplerate, BLOCK_SIZE);
+    degrade.seed(storage->rand_u32());
     chew.prepare((float)storage->samplerate, BLOCK_SIZE);
+    chew.seed(storage->rand_u32());
 
     mix.set_target(1.f);
     mix.instantize();
@@ -68,10 +70,12 @@ void TapeEffect::process(float *dataL, float *dataR)
         auto ths = clamp01(*pd_float[tape_saturation]);
         auto thb = clamp01(*pd_float[tape_bias]);
         auto tht = clamp1bp(*pd_float[tape_tone]);
-        const auto hysteresisMode = fxdata->p[tape_drive].deform_type;
+        const auto driveDeform = fxdata->p[tape_drive].deform_type;
 
         hysteresis.set_params(thd, ths, thb);
-        hysteresis.set_solver(hysteresisMode);
+        hysteresis.set_solver(driveDeform & tdd_solver_mask);
+        hysteresis.set_adaptive_oversampling((driveDeform & tdd_adaptive_oversampling) &&
+                                             !storage->useHighestQuality());
         toneControl.set_params(tht);
 
         toneControl.processBlockIn(L, R);
@@ -68,6 +68,13 @@ class TapeEffect : public Effect
         tape_num_ctrls,
     };
 
+    // The drive's deform_type carries the hysteresis solver in its low bits and flags above
+    enum tape_drive_deform
+    {
+        tdd_solver_mask = 0x0F,
+        tdd_adaptive_oversampling = 0x10,
+    };
+
     TapeEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd);
     virtual ~TapeEffect();
 
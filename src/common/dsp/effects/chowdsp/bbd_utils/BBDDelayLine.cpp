@@ -21,14 +21,22 @@
  */
 #include "BBDDelayLine.h"
 
-template <size_t STAGES> void BBDDelayLine<STAGES>::prepare(double sampleRate)
+template <size_t STAGES, size_t CHANNELS>
+void BBDDelayLine<STAGES, CHANNELS>::prepare(double sampleRate)
 {
     evenOn = true;
     FS = (float)sampleRate;
     Ts = 1.0f / FS;
 
     bufferPtr = 0;
-    std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+    for (size_t c = 0; c < CHANNELS; ++c)
+    {
+        std::fill(buffer[c].begin(), buffer[c].end(), 0.0f);
+        xIn[c] = SSEComplex();
+        xOut[c] = SSEComplex();
+        yBBD_old[c] = 0.0f;
+    }
 
     tn = 0.0f;
     evenOn = true;
@@ -38,7 +46,8 @@ template <size_t STAGES> void BBDDelayLine<STAGES>::prepare(double sampleRate)
     H0 = outputFilter->calcH0();
 }
 
-template <size_t STAGES> void BBDDelayLine<STAGES>::setFilterFreq(float freqHz)
+template <size_t STAGES, size_t CHANNELS>
+void BBDDelayLine<STAGES, CHANNELS>::setFilterFreq(float freqHz)
 {
     inputFilter->set_freq(freqHz);
     inputFilter->set_time(tn);
@@ -55,3 +64,10 @@ template class BBDDelayLine<1024>;
 template class BBDDelayLine<2048>;
 template class BBDDelayLine<4096>;
 template class BBDDelayLine<8192>;
+
+template class BBDDelayLine<128, 2>;
+template class BBDDelayLine<256, 2>;
+template class BBDDelayLine<512, 2>;
+template class BBDDelayLine<1024, 2>;
+template class BBDDelayLine<2048, 2>;
+template class BBDDelayLine<4096, 2>;
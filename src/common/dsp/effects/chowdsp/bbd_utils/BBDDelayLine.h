@@ -30,7 +30,12 @@
 
 #include "BBDFilterBank.h"
 
-template <size_t STAGES> class BBDDelayLine
+/*
+ * CHANNELS delay lines which always share a delay time can share one clock and one set of
+ * filter coefficients, so the clocking loop and the filter updates run once for all of them.
+ * Each channel keeps its own filter state and bucket buffer.
+ */
+template <size_t STAGES, size_t CHANNELS = 1> class BBDDelayLine
 {
   public:
     BBDDelayLine() = default;
@@ -50,23 +55,39 @@ template <size_t STAGES> class BBDDelayLine
 
     inline float process(float u) noexcept
     {
-        SSEComplex xOutAccum;
+        static_assert(CHANNELS == 1, "Use the multichannel process with more than one channel");
+
+        float y;
+        process(&u, &y);
+        return y;
+    }
+
+    inline void process(const float *u, float *y) noexcept
+    {
+        SSEComplex xOutAccum[CHANNELS];
         while (tn < Ts)
         {
             if (evenOn)
             {
                 inputFilter->calcG();
-                auto sum = vSum(SSEComplexMulReal(inputFilter->Gcalc, inputFilter->x));
-                buffer[bufferPtr++] = sum;
+
+                for (size_t c = 0; c < CHANNELS; ++c)
+                    buffer[c][bufferPtr] = vSum(SSEComplexMulReal(inputFilter->Gcalc, xIn[c]));
+
+                bufferPtr++;
                 bufferPtr = (bufferPtr < STAGES) ? bufferPtr : 0;
             }
             else
             {
-                auto yBBD = buffer[bufferPtr];
-                auto delta = yBBD - yBBD_old;
-                yBBD_old = yBBD;
                 outputFilter->calcG();
-                xOutAccum += outputFilter->Gcalc * delta;
+
+                for (size_t c = 0; c < CHANNELS; ++c)
+                {
+                    auto yBBD = buffer[c][bufferPtr];
+                    auto delta = yBBD - yBBD_old[c];
+                    yBBD_old[c] = yBBD;
+                    xOutAccum[c] += outputFilter->Gcalc * delta;
+                }
             }
 
             evenOn = !evenOn;
@@ -74,10 +95,13 @@ template <size_t STAGES> class BBDDelayLine
         }
         tn -= Ts;
 
-        inputFilter->process(u);
-        outputFilter->process(xOutAccum);
-        float sum = vSum(xOutAccum._r);
-        return H0 * yBBD_old + sum;
+        for (size_t c = 0; c < CHANNELS; ++c)
+        {
+            inputFilter->process(xIn[c], u[c]);
+            outputFilter->process(xOut[c], xOutAccum[c]);
+            float sum = vSum(xOutAccum[c]._r);
+            y[c] = H0 * yBBD_old[c] + sum;
+        }
     }
 
   private:
@@ -89,13 +113,12 @@ template <size_t STAGES> class BBDDelayLine
     std::unique_ptr<OutputFilterBank> outputFilter;
     float H0 = 1.0f;
 
-    std::array<std::complex<float>, FilterSpec::N_filt> xIn;
-    std::array<std::complex<float>, FilterSpec::N_filt> xOut;
+    SSEComplex xIn[CHANNELS], xOut[CHANNELS];
 
-    std::array<float, STAGES> buffer;
+    std::array<float, STAGES> buffer[CHANNELS];
     size_t bufferPtr = 0;
 
-    float yBBD_old = 0.0f;
+    float yBBD_old[CHANNELS]{};
     float tn = 0.0f;
     bool evenOn = true;
 };
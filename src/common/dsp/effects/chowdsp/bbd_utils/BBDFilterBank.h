@@ -105,12 +105,12 @@ struct InputFilterBank
 
     inline void calcG() noexcept { Gcalc = Aplus * Gcalc; }
 
-    inline void process(float u)
+    // the state lives with the delay line, so channels on one clock can share a bank
+    inline void process(SSEComplex &x, float u) const
     {
         x = pole_corr * x + SSEComplex(_mm_set1_ps(u), _mm_set1_ps(0.0f));
     }
 
-    SSEComplex x;
     SSEComplex Gcalc{{1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f, 0.0f}};
 
   private:
@@ -174,9 +174,8 @@ struct OutputFilterBank
 
     inline void calcG() noexcept { Gcalc = Aplus * Gcalc; }
 
-    inline void process(SSEComplex u) { x = pole_corr * x + u; }
+    inline void process(SSEComplex &x, SSEComplex u) const { x = pole_corr * x + u; }
 
-    SSEComplex x;
     SSEComplex Gcalc{{1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f, 0.0f}};
 
   private:
@@ -127,6 +127,128 @@ class Oversampling
     float rightUp alignas(16)[up_block_size];
 };
 
+/*
+** Like Oversampling, but the ratio can be changed at runtime, anywhere from 1x up to
+** 2^MaxOSFactor. Every stage is a polyphase IIR halfband. The stage nearest the base rate
+** is always steep; the ones above it only need to be when steepOuter is set, since whatever
+** they let through is removed again on the way down.
+**
+** Each upsampling stage halves the level, so the upsampled signal is getOSRatio() times
+** quieter than the input, exactly as with Oversampling.
+**
+** Effects which let the user pick a ratio keep the choice in a parameter's deform_type, as
+** a Choice. os_default is whatever the effect did before it offered one, so patches saved
+** before then still sound the same.
+*/
+template <size_t MaxOSFactor, size_t block_size, size_t FilterOrd = 3, bool steepOuter = false>
+class VariableOversampling
+{
+    std::unique_ptr<sst::filters::HalfRate::HalfRateFilter> hr_filts_up alignas(16)[MaxOSFactor];
+    std::unique_ptr<sst::filters::HalfRate::HalfRateFilter> hr_filts_down alignas(16)[MaxOSFactor];
+
+    static constexpr size_t max_up_block_size = block_size << MaxOSFactor;
+
+    size_t osFactor{0};
+
+  public:
+    enum Choice
+    {
+        os_default = 0,
+        os_off,
+        os_2x,
+        os_4x,
+        os_8x,
+    };
+
+    /** The factor (as a power of two) for a Choice, given the one os_default stands for */
+    static size_t factorForChoice(int choice, size_t defaultFactor)
+    {
+        if (choice <= os_default || choice > os_8x)
+            return std::min(defaultFactor, MaxOSFactor);
+
+        return std::min((size_t)(choice - os_off), MaxOSFactor);
+    }
+
+    VariableOversampling()
+    {
+        for (size_t i = 0; i < MaxOSFactor; ++i)
+        {
+            auto steep = (i == 0) || steepOuter;
+
+            hr_filts_up[i] =
+                std::make_unique<sst::filters::HalfRate::HalfRateFilter>(FilterOrd, steep);
+            hr_filts_down[i] =
+                std::make_unique<sst::filters::HalfRate::HalfRateFilter>(FilterOrd, steep);
+        }
+    }
+
+    /** Changes the ratio, resetting the filters if it actually changed. Returns true if so */
+    bool setOSFactor(size_t factor)
+    {
+        factor = std::min(factor, MaxOSFactor);
+
+        if (factor == osFactor)
+            return false;
+
+        osFactor = factor;
+        reset();
+
+        return true;
+    }
+
+    /** Resets the processing pipeline */
+    void reset()
+    {
+        for (size_t i = 0; i < MaxOSFactor; ++i)
+        {
+            hr_filts_up[i]->reset();
+            hr_filts_down[i]->reset();
+        }
+
+        std::fill(leftUp, &leftUp[max_up_block_size], 0.0f);
+        std::fill(rightUp, &rightUp[max_up_block_size], 0.0f);
+    }
+
+    /** Upsamples the audio in the input arrays, and stores the upsampled audio internally */
+    inline void upsample(float *leftIn, float *rightIn) noexcept
+    {
+        sst::basic_blocks::mechanics::copy_from_to<block_size>(leftIn, leftUp);
+        sst::basic_blocks::mechanics::copy_from_to<block_size>(rightIn, rightUp);
+
+        for (size_t i = 0; i < osFactor; ++i)
+        {
+            auto numSamples = block_size * (1 << (i + 1));
+            hr_filts_up[i]->process_block_U2(leftUp, rightUp, leftUp, rightUp, numSamples);
+        }
+    }
+
+    /** Downsamples that audio in the internal buffers, and stores the downsampled audio in the
+     * input arrays */
+    inline void downsample(float *leftOut, float *rightOut) noexcept
+    {
+        for (size_t i = osFactor; i > 0; --i)
+        {
+            auto numSamples = block_size * (1 << i);
+            hr_filts_down[i - 1]->process_block_D2(leftUp, rightUp, numSamples);
+        }
+
+        sst::basic_blocks::mechanics::copy_from_to<block_size>(leftUp, leftOut);
+        sst::basic_blocks::mechanics::copy_from_to<block_size>(rightUp, rightOut);
+    }
+
+    /** Returns the current ratio, as a power of two */
+    inline size_t getOSFactor() const noexcept { return osFactor; }
+
+    /** Returns the current oversampling ratio */
+    inline size_t getOSRatio() const noexcept { return (size_t)1 << osFactor; }
+
+    /** Returns the size of the upsampled blocks at the current ratio */
+    inline size_t getUpBlockSize() const noexcept { return block_size << osFactor; }
+
+    float leftUp alignas(16)[max_up_block_size];
+    float rightUp alignas(16)[max_up_block_size];
+};
+
 } // namespace chowdsp
 
 #endif // SURGE_SRC_COMMON_DSP_EFFECTS_CHOWDSP_SHARED_OVERSAMPLING_H
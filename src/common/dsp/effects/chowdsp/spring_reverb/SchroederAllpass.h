@@ -22,6 +22,10 @@
 #ifndef SURGE_SRC_COMMON_DSP_EFFECTS_CHOWDSP_SPRING_REVERB_SCHROEDERALLPASS_H
 #define SURGE_SRC_COMMON_DSP_EFFECTS_CHOWDSP_SPRING_REVERB_SCHROEDERALLPASS_H
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "../shared/chowdsp_DelayLine.h"
 
 #ifdef __GNUC__ // GCC doesn't like "ignored-attributes"...
@@ -97,6 +101,104 @@ template <typename T> class SchroederAllpass<T, 1>
     DelayLine<T, DelayLineInterpolationTypes::Thiran> delay{1 << 18};
     T g;
 };
+
+/*
+** A chain of identical SchroederAllpass<__m128, order> sections, processed together. It
+** computes the same thing as a std::array of them, but every delay line shares the same
+** length and write position, so they live interleaved in one ring buffer sized for the
+** longest delay actually needed. A sample's reads and writes for the whole chain then sit
+** next to each other in memory, rather than in 2 * stages * order separate 1 << 18 sample
+** buffers.
+*/
+template <int stages, int order = 1> class SchroederAllpassCascade
+{
+  public:
+    static constexpr int lines = stages * order;
+
+    void prepare(int maxDelaySamples)
+    {
+        int size = 4;
+        while (size < maxDelaySamples + 2)
+            size <<= 1;
+
+        mask = size - 1;
+        buffer.assign((size_t)size * lines, _mm_setzero_ps());
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(buffer.begin(), buffer.end(), _mm_setzero_ps());
+
+        for (auto &s : state)
+            s = _mm_setzero_ps();
+
+        writePos = 0;
+    }
+
+    void setParams(float delaySamp, __m128 feedback)
+    {
+        // this matches what DelayLine and its Thiran interpolator do with the delay
+        auto delay = std::clamp(delaySamp, 0.f, (float)(mask - 1));
+        delayInt = (int)std::floor(delay);
+        auto delayFrac = delay - (float)delayInt;
+
+        if (delayFrac < 0.618f && delayInt >= 1)
+        {
+            delayFrac++;
+            delayInt--;
+        }
+
+        alpha = (float)double((1 - delayFrac) / (1 + delayFrac));
+        g = feedback;
+    }
+
+    inline __m128 processSample(__m128 x) noexcept
+    {
+        const auto *v1 = &buffer[(size_t)((writePos - delayInt) & mask) * lines];
+        const auto *v2 = &buffer[(size_t)((writePos - delayInt - 1) & mask) * lines];
+        auto *w = &buffer[(size_t)writePos * lines];
+        const auto a = _mm_set1_ps(alpha);
+
+        for (int s = 0; s < stages; ++s)
+        {
+            const auto l0 = s * order;
+            __m128 p[order];
+
+            // p[k] is what the delay of the (k + 1)th nesting level gives back
+            for (int k = 0; k < order; ++k)
+            {
+                auto &st = state[l0 + k];
+                auto d = _mm_add_ps(v2[l0 + k], _mm_mul_ps(a, _mm_sub_ps(v1[l0 + k], st)));
+                st = d;
+                p[k] = d;
+            }
+
+            auto out = p[0];
+
+            for (int k = 0; k < order; ++k)
+            {
+                auto in = (k + 1 < order) ? p[k + 1] : x;
+                auto xk = _mm_add_ps(in, _mm_mul_ps(g, out));
+                w[l0 + k] = xk;
+                out = _mm_sub_ps(out, _mm_mul_ps(g, xk));
+            }
+
+            x = out;
+        }
+
+        writePos = (writePos + 1) & mask;
+
+        return x;
+    }
+
+  private:
+    std::vector<__m128> buffer; // [position][line]
+    int mask{3}, writePos{0}, delayInt{0};
+    float alpha{0.f};
+    __m128 g{_mm_setzero_ps()};
+    __m128 state[lines];
+};
 } // namespace chowdsp
 
 #ifdef __GNUC__
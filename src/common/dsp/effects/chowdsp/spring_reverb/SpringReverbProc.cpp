@@ -40,6 +40,12 @@ SpringReverbProc::SpringReverbProc()
     urng01 = std::bind(distro01, gen01);
 }
 
+void SpringReverbProc::seed(uint32_t s)
+{
+    std::uniform_real_distribution<float> distro01(0.0f, 1.0f);
+    urng01 = std::bind(distro01, std::minstd_rand(s));
+}
+
 void SpringReverbProc::prepare(float sampleRate, int samplesPerBlock)
 {
     fs = sampleRate;
@@ -49,8 +55,7 @@ void SpringReverbProc::prepare(float sampleRate, int samplesPerBlock)
     dcBlocker.prepare(sampleRate, 2);
     dcBlocker.setCutoffFrequency(40.0f);
 
-    for (auto &apf : vecAPFs)
-        apf.prepare(sampleRate);
+    vecAPFs.prepare((int)std::ceil(maxAllpassDelayMs / 1000.0f * sampleRate));
 
     lpf.prepare(sampleRate, 2);
 
@@ -103,11 +108,7 @@ void SpringReverbProc::setParams(const Params &params, int numSamples)
 
     auto apfG = 0.5f - 0.4f * params.spin;
     float apfGVec alignas(16)[4] = {apfG, -apfG, apfG, -apfG};
-    VecType apfGVecAsVecType = 0;
-    for (int i = 0; i < 4; ++i)
-        apfGVecAsVecType[i] = apfGVec[i];
-    for (auto &apf : vecAPFs)
-        apf.setParams(msToSamples(0.35f + 3.0f * params.size), apfGVecAsVecType);
+    vecAPFs.setParams(msToSamples(0.35f + 3.0f * params.size), _mm_load_ps(apfGVec));
 
     constexpr float dampFreqLow = 4000.0f;
     constexpr float dampFreqHigh = 18000.0f;
@@ -138,10 +139,9 @@ void SpringReverbProc::processBlock(float *left, float *right, const int numSamp
     };
 
     auto doAPFProcess = [&]() {
-        auto yVec = VecType::fromRawArray(simdState);
-        for (auto &apf : vecAPFs)
-            yVec = apf.processSample(yVec);
-        yVec.copyToRawArray(simdState);
+        auto yVec = _mm_load_ps(simdState);
+        yVec = vecAPFs.processSample(yVec);
+        _mm_store_ps(simdState, yVec);
     };
 
     auto doSpringOutput = [&](int ch) {
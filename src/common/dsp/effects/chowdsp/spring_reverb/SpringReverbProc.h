@@ -38,6 +38,9 @@ class SpringReverbProc
   public:
     SpringReverbProc();
 
+    /** Reseeds the random shakes (the constructor seeds them from the system) */
+    void seed(uint32_t s);
+
     struct Params
     {
         float size = 0.5f;
@@ -60,9 +63,8 @@ class SpringReverbProc
     StateVariableFilter<float> dcBlocker;
 
     static constexpr int allpassStages = 16;
-    using VecType = juce::dsp::SIMDRegister<float>;
-    using APFCascade = std::array<SchroederAllpass<VecType, 2>, allpassStages>;
-    APFCascade vecAPFs;
+    static constexpr float maxAllpassDelayMs = 0.35f + 3.0f;
+    SchroederAllpassCascade<allpassStages, 2> vecAPFs;
 
     std::function<float()> urng01; // A uniform 0,1 RNG
     SmoothedValue<float, ValueSmoothingTypes::Linear> chaosSmooth;
@@ -37,6 +37,15 @@ ChewProcessor::ChewProcessor()
     urng01 = std::bind(distro01, gen01);
 }
 
+void ChewProcessor::seed(uint32_t s)
+{
+    std::uniform_real_distribution<float> distro02(0.0f, 2.0f);
+    urng02 = std::bind(distro02, std::minstd_rand(s));
+
+    std::uniform_real_distribution<float> distro01(0.0f, 1.0f);
+    urng01 = std::bind(distro01, std::minstd_rand(s ^ 0x5bd1e995));
+}
+
 void ChewProcessor::set_params(float new_freq, float new_depth, float new_var)
 {
     freq = new_freq;
@@ -34,6 +34,9 @@ class ChewProcessor
   public:
     ChewProcessor();
 
+    /** Reseeds the dropout timing (the constructor seeds it from the system) */
+    void seed(uint32_t s);
+
     void set_params(float freq, float depth, float var);
     void prepare(double sr, int samplesPerBlock);
     void process_block(float *dataL, float *dataR);
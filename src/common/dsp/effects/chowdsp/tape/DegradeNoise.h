@@ -42,6 +42,12 @@ class DegradeNoise
 
     ~DegradeNoise() {}
 
+    void seed(uint32_t s)
+    {
+        std::uniform_real_distribution<float> distro(-0.5f, 0.5f);
+        urng = std::bind(distro, std::minstd_rand(s));
+    }
+
     void setGain(float newGain) { curGain = newGain; }
 
     void prepare() { prevGain = curGain; }
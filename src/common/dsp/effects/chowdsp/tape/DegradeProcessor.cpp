@@ -35,6 +35,15 @@ DegradeProcessor::DegradeProcessor()
     gain.set_target(1.0f);
 }
 
+void DegradeProcessor::seed(uint32_t s)
+{
+    std::uniform_real_distribution<float> distro(-0.5f, 0.5f);
+    urng = std::bind(distro, std::minstd_rand(s));
+
+    for (int ch = 0; ch < 2; ++ch)
+        noiseProc[ch].seed(s + ch + 1);
+}
+
 void DegradeProcessor::set_params(float depthParam, float amtParam, float varParam)
 {
     float freqHz = 200.0f * std::pow(20000.0f / 200.0f, 1.0f - amtParam);
@@ -34,6 +34,9 @@ class DegradeProcessor
   public:
     DegradeProcessor();
 
+    /** Reseeds the variance and noise generators (the constructor seeds them from the system) */
+    void seed(uint32_t s);
+
     void set_params(float depthParam, float amtParam, float varParam);
     void prepareToPlay(double sampleRate, int samplesPerBlock);
     void process_block(float *dataL, float *dataR);
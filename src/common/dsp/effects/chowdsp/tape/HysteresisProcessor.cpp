@@ -23,10 +23,10 @@
 
 namespace
 {
-static void typeConvert(const float *input, double *output, int numSamples)
+static void typeConvert(const float *input, double *output, int numSamples, double gain)
 {
     for (int i = 0; i < numSamples; ++i)
-        output[i] = (double)input[i];
+        output[i] = (double)input[i] * gain;
 }
 
 static void typeConvert(const double *input, float *output, int numSamples)
@@ -67,6 +67,10 @@ void HysteresisProcessor::reset(double sample_rate)
     makeup.reset(numSteps);
 
     os.reset();
+    osLow.reset();
+    lowRate = false;
+    sampleRate = sample_rate;
+
     dc_blocker.setBlockSize(BLOCK_SIZE);
     dc_blocker.suspend();
     dc_blocker.coeff_HP(35.0f / sample_rate, 0.707);
@@ -102,20 +106,104 @@ void HysteresisProcessor::set_params(float driveVal, float satVal, float biasVal
 
 void HysteresisProcessor::set_solver(int newSolver) { solver = static_cast<SolverType>(newSolver); }
 
+void HysteresisProcessor::set_model_sample_rate(double sr)
+{
+#if CHOWTAPE_HYSTERESIS_USE_SIMD
+    hProc.setSampleRate(sr);
+#else
+    for (auto &hp : hProcs)
+        hp.setSampleRate(sr);
+#endif
+}
+
 void HysteresisProcessor::process_block(float *dataL, float *dataR)
 {
     bool needsSmoothing = drive.isSmoothing() || width.isSmoothing() || sat.isSmoothing();
 
+    auto threshold = lowRate ? adaptiveDriveUp : adaptiveDriveDown;
+    bool wantLow = adaptive && (sampleRate >= adaptiveHighSampleRate ||
+                                drive.getTargetValue() < threshold);
+
+    if (wantLow != lowRate && !needsSmoothing)
+        switch_rate(wantLow, dataL, dataR);
+    else if (lowRate)
+        process_oversampled(osLow, dataL, dataR);
+    else
+        process_oversampled(os, dataL, dataR);
+
+    dc_blocker.process_block(dataL, dataR);
+}
+
+void HysteresisProcessor::switch_rate(bool toLow, float *dataL, float *dataR)
+{
+    float oldL alignas(16)[BLOCK_SIZE], oldR alignas(16)[BLOCK_SIZE];
+    sst::basic_blocks::mechanics::copy_from_to<BLOCK_SIZE>(dataL, oldL);
+    sst::basic_blocks::mechanics::copy_from_to<BLOCK_SIZE>(dataR, oldR);
+
+#if CHOWTAPE_HYSTERESIS_USE_SIMD
+    auto saved = hProc;
+#else
+    HysteresisProcessing saved[2] = {hProcs[0], hProcs[1]};
+#endif
+
+    if (lowRate)
+        process_oversampled(osLow, oldL, oldR);
+    else
+        process_oversampled(os, oldL, oldR);
+
+    // the new rate picks the model up where the old one was, before this block
+#if CHOWTAPE_HYSTERESIS_USE_SIMD
+    hProc = saved;
+#else
+    hProcs[0] = saved[0];
+    hProcs[1] = saved[1];
+#endif
+
+    lowRate = toLow;
+
+    /*
+     * The model was only ever tuned with its clock at the host rate while running at 4x, so
+     * at 2x it runs at half the host rate to keep the same response.
+     */
+    set_model_sample_rate(lowRate ? sampleRate * 0.5 : sampleRate);
+
+    if (lowRate)
+    {
+        osLow.reset();
+        process_oversampled(osLow, dataL, dataR);
+    }
+    else
+    {
+        os.reset();
+        process_oversampled(os, dataL, dataR);
+    }
+
+    for (int i = 0; i < BLOCK_SIZE; ++i)
+    {
+        auto w = (float)(i + 1) / BLOCK_SIZE;
+        dataL[i] = oldL[i] + w * (dataL[i] - oldL[i]);
+        dataR[i] = oldR[i] + w * (dataR[i] - oldR[i]);
+    }
+}
+
+template <typename OS>
+void HysteresisProcessor::process_oversampled(OS &o, float *dataL, float *dataR)
+{
+    bool needsSmoothing = drive.isSmoothing() || width.isSmoothing() || sat.isSmoothing();
+
     // upsample
-    os.upsample(dataL, dataR);
-    static constexpr int blockSizeUp = (int)Oversampling<2, BLOCK_SIZE>::getUpBlockSize();
+    o.upsample(dataL, dataR);
+    static constexpr int blockSizeUp = (int)OS::getUpBlockSize();
+
+    // each halfband stage halves the level, and the model expects what 4x gives it
+    const double upGain = (double)o.getOSRatio() / os.getOSRatio();
 
     // convert from double to float
     double leftUp_d[blockSizeUp];
-    typeConvert(os.leftUp, leftUp_d, blockSizeUp);
+    typeConvert(o.leftUp, leftUp_d, blockSizeUp, upGain);
 
     double rightUp_d[blockSizeUp];
-    typeConvert(os.rightUp, rightUp_d, blockSizeUp);
+    typeConvert(o.rightUp, rightUp_d, blockSizeUp, upGain);
 
 #if CHOWTAPE_HYSTERESIS_USE_SIMD
     double dataInterleaved alignas(16)[2 * blockSizeUp];
@@ -186,13 +274,11 @@ void HysteresisProcessor::process_block(float *dataL, float *dataR)
 #endif
 
     // convert back to float
-    typeConvert(leftUp_d, os.leftUp, blockSizeUp);
-    typeConvert(rightUp_d, os.rightUp, blockSizeUp);
+    typeConvert(leftUp_d, o.leftUp, blockSizeUp);
+    typeConvert(rightUp_d, o.rightUp, blockSizeUp);
 
     // downsample
-    os.downsample(dataL, dataR);
-
-    dc_blocker.process_block(dataL, dataR);
+    o.downsample(dataL, dataR);
 }
 
 #if CHOWTAPE_HYSTERESIS_USE_SIMD
@@ -39,6 +39,13 @@ class HysteresisProcessor
 
     void set_params(float drive, float sat, float bias);
     void set_solver(int newSolver);
+
+    /*
+     * In adaptive mode the model drops from 4x to 2x oversampling while the drive is low, or
+     * the host rate is high, enough that 2x leaves nothing audible to alias. The change is
+     * crossfaded over a block, and only happens while the parameters are steady.
+     */
+    void set_adaptive_oversampling(bool a) { adaptive = a; }
     void process_block(float *dataL, float *dataR);
 
   private:
@@ -47,6 +54,13 @@ class HysteresisProcessor
         numSteps = 500,
     };
 
+    static constexpr float adaptiveDriveDown = 0.3f, adaptiveDriveUp = 0.35f;
+    static constexpr double adaptiveHighSampleRate = 88200.0;
+
+    template <typename OS> void process_oversampled(OS &o, float *dataL, float *dataR);
+    void switch_rate(bool toLow, float *dataL, float *dataR);
+    void set_model_sample_rate(double sr);
+
     SmoothedValue<float, ValueSmoothingTypes::Linear> drive;
     SmoothedValue<float, ValueSmoothingTypes::Linear> width;
     SmoothedValue<float, ValueSmoothingTypes::Linear> sat;
@@ -72,6 +86,9 @@ class HysteresisProcessor
     SolverType solver;
 
     Oversampling<2, BLOCK_SIZE> os;
+    Oversampling<1, BLOCK_SIZE> osLow;
+    bool adaptive{false}, lowRate{false};
+    double sampleRate{48000.0};
     BiquadFilter dc_blocker;
 };
 
@@ -29,6 +29,8 @@
 #include "ModulationSource.h"
 #include "DebugHelpers.h"
 
+#include <limits>
+
 enum ADSRState
 {
     s_attack = 0,
@@ -223,25 +225,11 @@ class ADSRModulationSource : public ModulationSource
             __m128 diff_v_r = _mm_min_ss(_mm_setzero_ps(), _mm_sub_ss(v_release, v_c1));
 
             // calculate coefficients for envelope
-            const float shortest = 6.f;
-            const float longest = -2.f;
-            const float coeff_offset = 2.f - log(storage->samplerate / BLOCK_SIZE) / log(2.f);
-
-            float coef_A =
-                powf(2.f, std::min(0.f, coeff_offset - lc[a].f * (adsr->a.temposync
-                                                                      ? storage->temposyncratio
-                                                                      : 1.f)));
-            float coef_D =
-                powf(2.f, std::min(0.f, coeff_offset - lc[d].f * (adsr->d.temposync
-                                                                      ? storage->temposyncratio
-                                                                      : 1.f)));
-            float coef_R =
-                envstate == s_uberrelease
-                    ? 6.f
-                    : powf(2.f,
-                           std::min(0.f, coeff_offset - lc[r].f * (adsr->r.temposync
-                                                                       ? storage->temposyncratio
-                                                                       : 1.f)));
+            updateAnalogCoefficients();
+
+            float coef_A = analogCoefA;
+            float coef_D = analogCoefD;
+            float coef_R = envstate == s_uberrelease ? 6.f : analogCoefR;
 
             v_c1 = _mm_add_ss(v_c1, _mm_mul_ss(diff_v_a, _mm_load_ss(&coef_A)));
             v_c1 = _mm_add_ss(v_c1, _mm_mul_ss(diff_v_d, _mm_load_ss(&coef_D)));
@@ -387,22 +375,40 @@ class ADSRModulationSource : public ModulationSource
         }
     }
 
-    void doCorrectAnalogMode()
+    /*
+     * Both analog modes turn the attack, decay and release times into per block charge
+     * coefficients with a log and three powf calls. Those only change when the times, the
+     * tempo or the sample rate do, so hold on to them from block to block.
+     */
+    void updateAnalogCoefficients()
     {
+        float tA = lc[a].f * (adsr->a.temposync ? storage->temposyncratio : 1.f);
+        float tD = lc[d].f * (adsr->d.temposync ? storage->temposyncratio : 1.f);
+        float tR = lc[r].f * (adsr->r.temposync ? storage->temposyncratio : 1.f);
+
+        if (tA == analogTimeA && tD == analogTimeD && tR == analogTimeR &&
+            storage->samplerate == analogSampleRate)
+            return;
+
+        analogTimeA = tA;
+        analogTimeD = tD;
+        analogTimeR = tR;
+        analogSampleRate = storage->samplerate;
+
         const float coeff_offset = 2.f - log(storage->samplerate / BLOCK_SIZE) / log(2.f);
 
-        float coef_A = powf(
-            2.f, std::min(0.f, coeff_offset -
-                                   lc[a].f * (adsr->a.temposync ? storage->temposyncratio : 1.f)));
-        float coef_D = powf(
-            2.f, std::min(0.f, coeff_offset -
-                                   lc[d].f * (adsr->d.temposync ? storage->temposyncratio : 1.f)));
-        float coef_R =
-            envstate == s_uberrelease
-                ? 6.f
-                : powf(2.f, std::min(0.f, coeff_offset - lc[r].f * (adsr->r.temposync
-                                                                        ? storage->temposyncratio
-                                                                        : 1.f)));
+        analogCoefA = powf(2.f, std::min(0.f, coeff_offset - tA));
+        analogCoefD = powf(2.f, std::min(0.f, coeff_offset - tD));
+        analogCoefR = powf(2.f, std::min(0.f, coeff_offset - tR));
+    }
+
+    void doCorrectAnalogMode()
+    {
+        updateAnalogCoefficients();
+
+        float coef_A = analogCoefA;
+        float coef_D = analogCoefD;
+        float coef_R = envstate == s_uberrelease ? 6.f : analogCoefR;
 
         const float v_cc = 1.01f;
         auto gate = (envstate == s_attack) || (envstate == s_decay);
@@ -459,6 +465,11 @@ class ADSRModulationSource : public ModulationSource
     float corr_v_c1{0.f};
     float corr_v_c1_delayed{0.f};
     bool corr_discharge{false};
+
+    // NaN never compares equal, so the first analog block always computes the coefficients
+    float analogTimeA{std::numeric_limits<float>::quiet_NaN()}, analogTimeD{0.f},
+        analogTimeR{0.f}, analogSampleRate{0.f};
+    float analogCoefA{0.f}, analogCoefD{0.f}, analogCoefR{0.f};
 };
 
 #endif // SURGE_SRC_COMMON_DSP_MODULATORS_ADSRMODULATIONSOURCE_H
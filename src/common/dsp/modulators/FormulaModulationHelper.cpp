@@ -34,11 +34,147 @@ namespace Formula
 {
 
 void setupStorage(SurgeStorage *s) { s->formulaGlobalData = std::make_unique<GlobalData>(); }
+
+void beginAudioBlock(SurgeStorage *s) { s->formulaGlobalData->audioSecondsThisBlock = 0.0; }
+
+#if HAS_LUA
+/*
+ * The modstate fields valueAt reads and writes on every call. Their names are interned once
+ * per lua state into a table in the registry, so the per-voice path fetches each key with a
+ * rawgeti rather than hashing a C string for every field of every voice.
+ */
+enum ModStateKey
+{
+    msk_intphase = 1,
+    msk_phase,
+    msk_delay,
+    msk_decay,
+    msk_attack,
+    msk_hold,
+    msk_sustain,
+    msk_release,
+    msk_rate,
+    msk_amplitude,
+    msk_startphase,
+    msk_deform,
+    msk_tempo,
+    msk_songpos,
+    msk_released,
+    msk_is_voice,
+    msk_key,
+    msk_velocity,
+    msk_channel,
+    msk_retrigger_AEG,
+    msk_retrigger_FEG,
+    msk_macros,
+    msk_output,
+    msk_use_envelope,
+    msk_clamp_output,
+
+    n_modstate_keys
+};
+
+static const char *modStateKeyNames[n_modstate_keys] = {
+    nullptr,         "intphase",      "phase",    "delay",        "decay",     "attack",
+    "hold",          "sustain",       "release",  "rate",         "amplitude", "startphase",
+    "deform",        "tempo",         "songpos",  "released",     "is_voice",  "key",
+    "velocity",      "channel",       "retrigger_AEG", "retrigger_FEG", "macros", "output",
+    "use_envelope",  "clamp_output"};
+
+static int internModStateKeys(lua_State *L)
+{
+    lua_createtable(L, n_modstate_keys - 1, 0);
+    for (int i = 1; i < n_modstate_keys; ++i)
+    {
+        lua_pushstring(L, modStateKeyNames[i]);
+        lua_rawseti(L, -2, i);
+    }
+    return luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+static void releaseRegistryRefs(EvaluatorState &s)
+{
+    if (s.L)
+    {
+        luaL_unref(s.L, LUA_REGISTRYINDEX, s.funcRef);
+        luaL_unref(s.L, LUA_REGISTRYINDEX, s.stateRef);
+        luaL_unref(s.L, LUA_REGISTRYINDEX, s.blockFuncRef);
+    }
+    s.funcRef = noLuaRef;
+    s.stateRef = noLuaRef;
+    s.keysRef = noLuaRef;
+    s.blockFuncRef = noLuaRef;
+}
+
+/*
+ * How long a call into a formula may run. On the audio thread every formula shares one
+ * block's worth of time, so a call gets whatever the earlier ones this block left over; the
+ * display is more forgiving and gives each call its own allowance.
+ */
+static double evaluationBudgetSeconds(SurgeStorage *storage, lua_State *L)
+{
+    auto &gd = *storage->formulaGlobalData;
+
+    if (L == gd.audioState)
+        return std::max(BLOCK_SIZE * storage->dsamplerate_inv - gd.audioSecondsThisBlock, 0.0);
+
+    return 0.1;
+}
+
+/*
+ * The top level of the script and init run once as the formula is set up rather than every
+ * block, so they get an allowance of their own and the default instruction cap.
+ */
+static constexpr double setupBudgetSeconds{0.1};
+
+// a process call which gets through this many VM instructions is a runaway, however fast
+static constexpr int64_t maxProcessInstructions{1000000};
+
+static void chargeEvaluation(SurgeStorage *storage, lua_State *L,
+                             const Surge::LuaSupport::ScopedEvaluationBudget &budget)
+{
+    auto &gd = *storage->formulaGlobalData;
+
+    if (L == gd.audioState)
+        gd.audioSecondsThisBlock += budget.elapsedSeconds();
+}
+
+/*
+ * Running past the instruction cap is down to the formula, so it is disabled and
+ * remembered as bad. Running out of time may just be a busy machine or a heavy block, so
+ * that only disables this evaluator, and only once it has happened maxBudgetOverruns calls
+ * in a row. A call which started with no time left at all isn't counted against it.
+ */
+static void noteBudgetOverrun(SurgeStorage *storage, EvaluatorState *s,
+                              const Surge::LuaSupport::ScopedEvaluationBudget &budget)
+{
+    if (budget.exceededInstructions())
+    {
+        s->isvalid = false;
+        s->exceededBudget = true;
+        storage->formulaGlobalData->knownBadFunctions.insert(s->funcName);
+        return;
+    }
+
+    if (budget.maxSeconds > 0 && ++s->budgetOverruns >= maxBudgetOverruns)
+    {
+        s->isvalid = false;
+        s->exceededBudget = true;
+    }
+}
+#endif
+
 bool prepareForEvaluation(SurgeStorage *storage, FormulaModulatorStorage *fs, EvaluatorState &s,
                           bool is_display)
 {
     auto &stateData = *storage->formulaGlobalData;
     bool firstTimeThrough = false;
+
+#if HAS_LUA
+    // we may be re-preparing a live evaluator, so drop our hold on the old function and state
+    releaseRegistryRefs(s);
+#endif
+
     if (!is_display)
     {
         static int aid = 1;
@@ -93,20 +229,33 @@ end
         {
             lua_setglobal(s.L, "surge_reserved_formula_error_stub");
         }
+
+        auto keysRef = internModStateKeys(s.L);
+        if (is_display)
+            stateData.displayKeysRef = keysRef;
+        else
+            stateData.audioKeysRef = keysRef;
     }
 
+    s.keysRef = is_display ? stateData.displayKeysRef : stateData.audioKeysRef;
+
     // OK so now evaluate the formula. This is a mistake - the loading and
     // compiling can be expensive so lets look it up by hash first
     auto h = fs->formulaHash;
     auto pvn = std::string("pvn") + std::to_string(is_display) + "_" + std::to_string(h);
     auto pvf = pvn + "_f";
     auto pvfInit = pvn + "_fInit";
+    auto pvfBlock = pvn + "_fBlock";
     snprintf(s.funcName, TXT_SIZE, "%s", pvf.c_str());
     snprintf(s.funcNameInit, TXT_SIZE, "%s", pvfInit.c_str());
+    snprintf(s.funcNameBlock, TXT_SIZE, "%s", pvfBlock.c_str());
 
     // Handle hash collisions
     lua_getglobal(s.L, pvn.c_str());
     s.isvalid = false;
+    s.hasBlockProcess = false;
+    s.exceededBudget = false;
+    s.budgetOverruns = 0;
 
     bool hasString = false;
     if (lua_isstring(s.L, -1))
@@ -130,6 +279,10 @@ end
         s.isvalid = lua_isfunction(s.L, -1);
         lua_pop(s.L, 1);
 
+        lua_getglobal(s.L, s.funcNameBlock);
+        s.hasBlockProcess = lua_isfunction(s.L, -1);
+        lua_pop(s.L, 1);
+
         if (stateData.knownBadFunctions.find(s.funcName) != stateData.knownBadFunctions.end())
         {
             s.isvalid = false;
@@ -138,8 +291,22 @@ end
     else
     {
         std::string emsg;
-        int res = Surge::LuaSupport::parseStringDefiningMultipleFunctions(
-            s.L, fs->formulaString, {"process", "init"}, emsg);
+        int res;
+        // a top level which merely ran out of time is parsed again next time rather than cached
+        bool retryParse = false;
+        {
+            // the top level of the script runs here, so it gets a budget too
+            Surge::LuaSupport::ScopedEvaluationBudget budget(s.L, setupBudgetSeconds);
+            res = Surge::LuaSupport::parseStringDefiningMultipleFunctions(
+                s.L, fs->formulaString, {"process", "init", "process_block"}, emsg);
+            chargeEvaluation(storage, s.L, budget);
+
+            if (budget.exceeded())
+            {
+                s.exceededBudget = true;
+                retryParse = !budget.exceededInstructions();
+            }
+        }
 
         if (res >= 1)
         {
@@ -162,8 +329,22 @@ end
             Surge::LuaSupport::setSurgeFunctionEnvironment(s.L);
             lua_pop(s.L, 1);
 
+            // process_block is optional, so this may well be binding a nil
+            lua_setglobal(s.L, s.funcNameBlock);
+            lua_pushnil(s.L);
+            lua_setglobal(s.L, "process_block");
+
+            lua_getglobal(s.L, s.funcNameBlock);
+            if (lua_isfunction(s.L, -1))
+            {
+                Surge::LuaSupport::setSurgeFunctionEnvironment(s.L);
+                s.hasBlockProcess = true;
+            }
+            lua_pop(s.L, 1);
+
             stateData.functionsPerFMS[fs].insert(s.funcName);
             stateData.functionsPerFMS[fs].insert(s.funcNameInit);
+            stateData.functionsPerFMS[fs].insert(s.funcNameBlock);
 
             s.isvalid = true;
         }
@@ -171,13 +352,19 @@ end
         {
             s.adderror("Unable to determine 'process' or 'init' function : " + emsg);
             lua_pop(s.L, 1); // process
-            lua_pop(s.L, 1); // process
-            stateData.knownBadFunctions.insert(s.funcName);
+            lua_pop(s.L, 1); // init
+            lua_pop(s.L, 1); // process_block
+
+            if (!retryParse)
+                stateData.knownBadFunctions.insert(s.funcName);
         }
 
         // this happens here because we did parse it at least. Don't parse again until it is changed
-        lua_pushstring(s.L, fs->formulaString.c_str());
-        lua_setglobal(s.L, pvn.c_str());
+        if (!retryParse)
+        {
+            lua_pushstring(s.L, fs->formulaString.c_str());
+            lua_setglobal(s.L, pvn.c_str());
+        }
     }
 
     if (s.isvalid)
@@ -247,7 +434,9 @@ end
             addn("tempo", s.tempo);
             addn("songpos", s.songpos);
 
+            Surge::LuaSupport::ScopedEvaluationBudget budget(s.L, setupBudgetSeconds);
             auto cres = lua_pcall(s.L, 1, 1, 0);
+            chargeEvaluation(storage, s.L, budget);
             if (cres == LUA_OK)
             {
                 if (!lua_istable(s.L, -1))
@@ -265,7 +454,12 @@ end
                 std::ostringstream oss;
                 oss << "Failed to evaluate 'init' function. " << lua_tostring(s.L, -1);
                 s.adderror(oss.str());
-                stateData.knownBadFunctions.insert(s.funcName);
+
+                // an init which only ran out of time gets another go with the next voice
+                if (budget.exceeded())
+                    s.exceededBudget = true;
+                if (!budget.exceeded() || budget.exceededInstructions())
+                    stateData.knownBadFunctions.insert(s.funcName);
             }
         }
 
@@ -276,6 +470,7 @@ end
         lua_pop(s.L, -1);
 
         s.useEnvelope = true;
+        s.shareAcrossVoices = false;
 
         {
             auto sub = Surge::LuaSupport::SGLD("prepareForEvaluation::subscriptions", s.L);
@@ -298,6 +493,15 @@ end
                         s.useEnvelope = lua_toboolean(s.L, -1);
                     }
                     lua_pop(s.L, 1);
+
+                    // see SharedEvaluations; nothing is shared unless the formula asks
+                    lua_pushstring(s.L, "share_across_voices");
+                    lua_gettable(s.L, -2);
+                    if (lua_isboolean(s.L, -1))
+                    {
+                        s.shareAcrossVoices = lua_toboolean(s.L, -1);
+                    }
+                    lua_pop(s.L, 1);
                 }
 
                 // now let's read off those subscriptions
@@ -354,6 +558,21 @@ end
         }
     }
 
+    if (s.isvalid)
+    {
+        // Hold the function and modstate in the registry so valueAt doesn't look them up by name
+        lua_getglobal(s.L, s.funcName);
+        s.funcRef = luaL_ref(s.L, LUA_REGISTRYINDEX);
+        lua_getglobal(s.L, s.stateName);
+        s.stateRef = luaL_ref(s.L, LUA_REGISTRYINDEX);
+
+        if (s.hasBlockProcess)
+        {
+            lua_getglobal(s.L, s.funcNameBlock);
+            s.blockFuncRef = luaL_ref(s.L, LUA_REGISTRYINDEX);
+        }
+    }
+
     if (is_display)
     {
         // Move to support
@@ -436,6 +655,7 @@ bool cleanEvaluatorState(EvaluatorState &s)
         lua_setglobal(s.L, s.stateName);
         s.stateName[0] = 0;
     }
+    releaseRegistryRefs(s);
 #endif
     return true;
 }
@@ -446,135 +666,290 @@ bool initEvaluatorState(EvaluatorState &s)
     s.funcNameInit[0] = 0;
     s.stateName[0] = 0;
     s.L = nullptr;
+    s.funcNameBlock[0] = 0;
+    s.funcRef = noLuaRef;
+    s.stateRef = noLuaRef;
+    s.keysRef = noLuaRef;
+    s.blockFuncRef = noLuaRef;
     return true;
 }
-void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
-             FormulaModulatorStorage *fs, EvaluatorState *s, float output[max_formula_outputs])
-{
-#if HAS_LUA
-    s->activeoutputs = 1;
-    memset(output, 0, max_formula_outputs * sizeof(float));
-    if (s->L == nullptr)
-        return;
-
-    if (!s->isvalid)
-        return;
 
-    auto gs = Surge::LuaSupport::SGLD("valueAt", s->L);
-    struct OnErrorReplaceWithZero
-    {
-        OnErrorReplaceWithZero(lua_State *L, std::string fn) : L(L), fn(fn) {}
-        ~OnErrorReplaceWithZero()
-        {
-            if (replace)
-            {
-                // std::cout << "Would nuke " << fn << std::endl;
-                lua_getglobal(L, "surge_reserved_formula_error_stub");
-                lua_setglobal(L, fn.c_str());
-            }
-        }
-        lua_State *L;
-        std::string fn;
-        bool replace = true;
-    } onerr(s->L, s->funcName);
-    /*
-     * So: make the stack my evaluation func then my table; then push my table
-     * values; then call my function; then update my global
-     */
-    lua_getglobal(s->L, s->funcName);
-    if (!lua_isfunction(s->L, -1))
-    {
-        s->isvalid = false;
-        lua_pop(s->L, 1);
-        return;
-    }
-    lua_getglobal(s->L, s->stateName);
-
-    lua_pushstring(s->L, "av");
-    lua_gettable(s->L, -2);
-    lua_pop(s->L, 1);
+#if HAS_LUA
+/*
+ * Write this block's values into the modstate table on top of the stack. keys is the
+ * absolute stack index of the interned keys table.
+ */
+static void writeModStateFields(EvaluatorState *s, int keys, int phaseIntPart,
+                                float phaseFracPart)
+{
+    auto L = s->L;
 
-    // Stack is now func > table  so we can update the table
-    lua_pushstring(s->L, "intphase");
-    lua_pushinteger(s->L, phaseIntPart);
-    lua_settable(s->L, -3);
+    lua_rawgeti(L, keys, msk_intphase);
+    lua_pushinteger(L, phaseIntPart);
+    lua_settable(L, -3);
 
-    auto addn = [s](const char *q, float f) {
-        lua_pushstring(s->L, q);
-        lua_pushnumber(s->L, f);
-        lua_settable(s->L, -3);
+    auto addn = [L, keys](int k, float f) {
+        lua_rawgeti(L, keys, k);
+        lua_pushnumber(L, f);
+        lua_settable(L, -3);
     };
 
-    auto addb = [s](const char *q, bool b) {
-        lua_pushstring(s->L, q);
-        lua_pushboolean(s->L, b);
-        lua_settable(s->L, -3);
+    auto addb = [L, keys](int k, bool b) {
+        lua_rawgeti(L, keys, k);
+        lua_pushboolean(L, b);
+        lua_settable(L, -3);
     };
 
-    auto addnil = [s](const char *q) {
-        lua_pushstring(s->L, q);
-        lua_pushnil(s->L);
-        lua_settable(s->L, -3);
+    auto addnil = [L, keys](int k) {
+        lua_rawgeti(L, keys, k);
+        lua_pushnil(L);
+        lua_settable(L, -3);
     };
 
-    addn("phase", phaseFracPart);
+    addn(msk_phase, phaseFracPart);
 
     if (s->subLfoEnvelope)
     {
-        addn("delay", s->del);
-        addn("decay", s->dec);
-        addn("attack", s->a);
-        addn("hold", s->h);
-        addn("sustain", s->s);
-        addn("release", s->r);
+        addn(msk_delay, s->del);
+        addn(msk_decay, s->dec);
+        addn(msk_attack, s->a);
+        addn(msk_hold, s->h);
+        addn(msk_sustain, s->s);
+        addn(msk_release, s->r);
     }
     if (s->subLfoParams)
     {
-        addn("rate", s->rate);
-        addn("amplitude", s->amp);
-        addn("startphase", s->phase);
-        addn("deform", s->deform);
+        addn(msk_rate, s->rate);
+        addn(msk_amplitude, s->amp);
+        addn(msk_startphase, s->phase);
+        addn(msk_deform, s->deform);
     }
 
     if (s->subTiming)
     {
-        addn("tempo", s->tempo);
-        addn("songpos", s->songpos);
-        addb("released", s->released);
+        addn(msk_tempo, s->tempo);
+        addn(msk_songpos, s->songpos);
+        addb(msk_released, s->released);
     }
 
     if (s->subVoice && s->isVoice)
     {
-        addb("is_voice", s->isVoice);
-        addn("key", s->key);
-        addn("velocity", s->velocity);
-        addn("channel", s->channel);
+        addb(msk_is_voice, s->isVoice);
+        addn(msk_key, s->key);
+        addn(msk_velocity, s->velocity);
+        addn(msk_channel, s->channel);
     }
 
-    addnil("retrigger_AEG");
-    addnil("retrigger_FEG");
+    addnil(msk_retrigger_AEG);
+    addnil(msk_retrigger_FEG);
 
     if (s->subAnyMacro)
     {
-        // load the macros
-        lua_pushstring(s->L, "macros");
-        lua_createtable(s->L, n_customcontrollers, 0);
+        // load the macros, reusing the table from the last call if process left it alone
+        lua_rawgeti(L, keys, msk_macros);
+        lua_gettable(L, -2);
+        if (!lua_istable(L, -1))
+        {
+            lua_pop(L, 1);
+            lua_createtable(L, n_customcontrollers, 0);
+            lua_rawgeti(L, keys, msk_macros);
+            lua_pushvalue(L, -2);
+            lua_settable(L, -4);
+        }
         for (int i = 0; i < n_customcontrollers; ++i)
         {
             if (s->subMacros[i])
             {
-                lua_pushinteger(s->L, i + 1);
-                lua_pushnumber(s->L, s->macrovalues[i]);
-                lua_settable(s->L, -3);
+                lua_pushnumber(L, s->macrovalues[i]);
+                lua_rawseti(L, -2, i + 1);
             }
         }
-        lua_settable(s->L, -3);
+        lua_pop(L, 1);
     }
+}
 
+/*
+ * Read the outputs and flags back out of the modstate table on top of the stack, which
+ * is left in place.
+ */
+static void readModStateResult(SurgeStorage *storage, EvaluatorState *s,
+                               float output[max_formula_outputs])
+{
+    auto L = s->L;
+    auto checkFinite = [s](float f) {
+        if (!std::isfinite(f))
+        {
+            s->isFinite = false;
+            return 0.f;
+        }
+        return f;
+    };
+
+    // Stack is now table > keys
+    lua_rawgeti(L, LUA_REGISTRYINDEX, s->keysRef);
+
+    lua_rawgeti(L, -1, msk_output);
+    lua_gettable(L, -3);
+    // top of stack is now the result
+    float res = 0.0;
+    if (lua_isnumber(s->L, -1))
+    {
+        output[0] = checkFinite(lua_tonumber(s->L, -1));
+    }
+    else if (lua_istable(s->L, -1))
+    {
+        auto len = 0;
+
+        lua_pushnil(s->L);
+        while (lua_next(s->L, -2)) // because we pushed nil
+        {
+            int idx = -1;
+            // now key is -2, value is -1
+            if (lua_isnumber(s->L, -2))
+            {
+                idx = lua_tointeger(s->L, -2);
+            }
+            if (idx <= 0 || idx > max_formula_outputs)
+            {
+                std::ostringstream oss;
+                oss << "Error with vector output. The vector output must be"
+                    << " an array with size up to 8. Your table contained"
+                    << " index " << idx;
+                if (idx == -1)
+                    oss << " which is not an integer array index.";
+                if (idx > max_formula_outputs)
+                    oss << " which means your result is too long.";
+                s->adderror(oss.str());
+                auto &stateData = *storage->formulaGlobalData;
+                stateData.knownBadFunctions.insert(s->funcName);
+                s->isvalid = false;
+
+                idx = 0;
+            }
+
+            // Remember - LUA is 0 based
+            if (idx > 0)
+                output[idx - 1] = checkFinite(lua_tonumber(s->L, -1));
+            lua_pop(s->L, 1);
+            len = std::max(len, idx - 1);
+        }
+        s->activeoutputs = len + 1;
+    }
+    else
+    {
+        auto &stateData = *storage->formulaGlobalData;
+
+        if (stateData.knownBadFunctions.find(s->funcName) != stateData.knownBadFunctions.end())
+            s->adderror(
+                "You must define the 'output' field in the returned table as a number or "
+                "float array");
+        stateData.knownBadFunctions.insert(s->funcName);
+        s->isvalid = false;
+    };
+    // pop the output
+    lua_pop(s->L, 1);
+
+    auto getBoolDefault = [L](int k, bool def) -> bool {
+        auto res = def;
+        lua_rawgeti(L, -1, k);
+        lua_gettable(L, -3);
+        if (lua_isboolean(L, -1))
+        {
+            res = lua_toboolean(L, -1);
+        }
+        lua_pop(L, 1);
+        return res;
+    };
+
+    s->useEnvelope = getBoolDefault(msk_use_envelope, true);
+    s->retrigger_AEG = getBoolDefault(msk_retrigger_AEG, false);
+    s->retrigger_FEG = getBoolDefault(msk_retrigger_FEG, false);
+
+    auto doClamp = getBoolDefault(msk_clamp_output, true);
+    if (doClamp)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            output[i] = limitpm1(output[i]);
+        }
+    }
+
+    // pop the keys
+    lua_pop(L, 1);
+}
+#endif
+
+void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
+             FormulaModulatorStorage *fs, EvaluatorState *s, float output[max_formula_outputs])
+{
+#if HAS_LUA
+    s->activeoutputs = 1;
+    memset(output, 0, max_formula_outputs * sizeof(float));
+    if (s->L == nullptr)
+        return;
+
+    if (!s->isvalid)
+        return;
+
+    auto L = s->L;
+    auto gs = Surge::LuaSupport::SGLD("valueAt", L);
+    struct OnErrorReplaceWithZero
+    {
+        OnErrorReplaceWithZero(lua_State *L, const char *fn, int ref) : L(L), fn(fn), ref(ref) {}
+        ~OnErrorReplaceWithZero()
+        {
+            if (replace)
+            {
+                // std::cout << "Would nuke " << fn << std::endl;
+                lua_getglobal(L, "surge_reserved_formula_error_stub");
+                if (ref >= 0)
+                {
+                    lua_pushvalue(L, -1);
+                    lua_rawseti(L, LUA_REGISTRYINDEX, ref);
+                }
+                lua_setglobal(L, fn);
+            }
+        }
+        lua_State *L;
+        const char *fn;
+        int ref;
+        bool replace = true;
+    } onerr(L, s->funcName, s->funcRef);
+    /*
+     * So: make the stack the interned keys, my evaluation func then my table; then push my
+     * table values; then drop the keys and call my function
+     */
+    lua_rawgeti(L, LUA_REGISTRYINDEX, s->keysRef);
+    auto keys = lua_gettop(L);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, s->funcRef);
+    if (!lua_isfunction(L, -1))
+    {
+        s->isvalid = false;
+        lua_pop(L, 2);
+        return;
+    }
+    lua_rawgeti(L, LUA_REGISTRYINDEX, s->stateRef);
+    if (!lua_istable(L, -1))
+    {
+        s->isvalid = false;
+        lua_pop(L, 3);
+        return;
+    }
+
+    // Stack is now keys > func > table so we can update the table
+    writeModStateFields(s, keys, phaseIntPart, phaseFracPart);
+
+    lua_remove(L, keys);
+
+    Surge::LuaSupport::ScopedEvaluationBudget budget(L, evaluationBudgetSeconds(storage, L),
+                                                     maxProcessInstructions);
     auto lres = lua_pcall(s->L, 1, 1, 0);
+    chargeEvaluation(storage, L, budget);
     // stack is now just the result
     if (lres == LUA_OK)
     {
+        s->budgetOverruns = 0;
+
         s->isFinite = true;
         auto checkFinite = [s](float f) {
             if (!std::isfinite(f))
@@ -602,112 +977,262 @@ void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
             lua_pop(s->L, 1);
             return;
         }
-        // Store the value and keep it on top of the stack
-        lua_setglobal(s->L, s->stateName);
-        lua_getglobal(s->L, s->stateName);
+        /*
+         * The returned table becomes our modstate. Almost every process function returns the
+         * modstate it was given, so only rebind the reference and the global when it is new.
+         */
+        lua_rawgeti(L, LUA_REGISTRYINDEX, s->stateRef);
+        bool sameState = lua_rawequal(L, -1, -2);
+        lua_pop(L, 1);
+        if (!sameState)
+        {
+            lua_pushvalue(L, -1);
+            lua_rawseti(L, LUA_REGISTRYINDEX, s->stateRef);
+            lua_pushvalue(L, -1);
+            lua_setglobal(L, s->stateName);
+        }
 
-        lua_pushstring(s->L, "output");
-        lua_gettable(s->L, -2);
-        // top of stack is now the result
-        float res = 0.0;
-        if (lua_isnumber(s->L, -1))
+        readModStateResult(storage, s, output);
+
+        // Finally pop the table result
+        lua_pop(L, 1);
+        onerr.replace = false;
+        return;
+    }
+    else if (budget.exceeded() && !budget.exceededInstructions())
+    {
+        // out of time; this block's output is zero but the formula survives unless it keeps
+        // happening, so leave process in place rather than stubbing it out
+        lua_pop(s->L, 1);
+        onerr.replace = false;
+        noteBudgetOverrun(storage, s, budget);
+
+        if (!s->isvalid)
+            s->adderror("The 'process' function ran out of time repeatedly and was stopped.");
+        return;
+    }
+    else
+    {
+        s->isvalid = false;
+        std::ostringstream oss;
+        oss << "Failed to evaluate 'process' function." << lua_tostring(s->L, -1);
+        s->adderror(oss.str());
+        lua_pop(s->L, 1);
+
+        if (budget.exceeded())
+            noteBudgetOverrun(storage, s, budget);
+        return;
+    }
+#else
+#endif
+}
+
+bool deferToBlockBatch(BlockBatch &batch, int phaseIntPart, float phaseFracPart,
+                       FormulaModulatorStorage *fs, EvaluatorState *s, BlockBatch::finish_t finish,
+                       void *ctx)
+{
+#if HAS_LUA
+    if (s->L == nullptr || !s->isvalid || !s->hasBlockProcess)
+        return false;
+
+    if (batch.count >= (int)batch.entries.size())
+        return false;
+
+    batch.entries[batch.count++] = {s, fs, phaseIntPart, phaseFracPart, finish, ctx};
+    return true;
+#else
+    return false;
+#endif
+}
+
+void evaluateBlockBatch(SurgeStorage *storage, BlockBatch &batch)
+{
+#if HAS_LUA
+    auto &stateData = *storage->formulaGlobalData;
+
+    bool done[MAX_VOICES * n_lfos_voice] = {};
+    int members[MAX_VOICES * n_lfos_voice];
+    float output[max_formula_outputs];
+
+    // The batch is at most a few dozen entries, so just sweep it once per distinct formula
+    for (int i = 0; i < batch.count; ++i)
+    {
+        if (done[i])
+            continue;
+
+        auto lead = batch.entries[i].state;
+        auto L = lead->L;
+        auto gs = Surge::LuaSupport::SGLD("evaluateBlockBatch", L);
+
+        if (stateData.audioBatchRef == noLuaRef)
         {
-            output[0] = checkFinite(lua_tonumber(s->L, -1));
+            lua_createtable(L, MAX_VOICES, 0);
+            stateData.audioBatchRef = luaL_ref(L, LUA_REGISTRYINDEX);
         }
-        else if (lua_istable(s->L, -1))
+
+        // Stack is keys > process_block > modstates
+        lua_rawgeti(L, LUA_REGISTRYINDEX, lead->keysRef);
+        auto keys = lua_gettop(L);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, lead->blockFuncRef);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, stateData.audioBatchRef);
+
+        int n = 0;
+        for (int j = i; j < batch.count; ++j)
         {
-            auto len = 0;
+            auto &e = batch.entries[j];
 
-            lua_pushnil(s->L);
-            while (lua_next(s->L, -2)) // because we pushed nil
-            {
-                int idx = -1;
-                // now key is -2, value is -1
-                if (lua_isnumber(s->L, -2))
-                {
-                    idx = lua_tointeger(s->L, -2);
-                }
-                if (idx <= 0 || idx > max_formula_outputs)
-                {
-                    std::ostringstream oss;
-                    oss << "Error with vector output. The vector output must be"
-                        << " an array with size up to 8. Your table contained"
-                        << " index " << idx;
-                    if (idx == -1)
-                        oss << " which is not an integer array index.";
-                    if (idx > max_formula_outputs)
-                        oss << " which means your result is too long.";
-                    s->adderror(oss.str());
-                    auto &stateData = *storage->formulaGlobalData;
-                    stateData.knownBadFunctions.insert(s->funcName);
-                    s->isvalid = false;
+            if (done[j] || e.state->L != L || strcmp(e.state->funcName, lead->funcName) != 0)
+                continue;
 
-                    idx = 0;
-                }
+            lua_rawgeti(L, LUA_REGISTRYINDEX, e.state->stateRef);
+            writeModStateFields(e.state, keys, e.phaseIntPart, e.phaseFracPart);
+            lua_rawseti(L, -2, n + 1);
 
-                // Remember - LUA is 0 based
-                if (idx > 0)
-                    output[idx - 1] = checkFinite(lua_tonumber(s->L, -1));
-                lua_pop(s->L, 1);
-                len = std::max(len, idx - 1);
-            }
-            s->activeoutputs = len + 1;
+            members[n++] = j;
+            done[j] = true;
         }
-        else
+
+        // the modstates array is reused, so clear out whatever a bigger batch left behind
+        for (int k = n + 1;; ++k)
         {
-            auto &stateData = *storage->formulaGlobalData;
+            lua_rawgeti(L, -1, k);
+            bool stale = !lua_isnil(L, -1);
+            lua_pop(L, 1);
 
-            if (stateData.knownBadFunctions.find(s->funcName) != stateData.knownBadFunctions.end())
-                s->adderror(
-                    "You must define the 'output' field in the returned table as a number or "
-                    "float array");
-            stateData.knownBadFunctions.insert(s->funcName);
-            s->isvalid = false;
-        };
-        // pop the result and the function
-        lua_pop(s->L, 1);
+            if (!stale)
+                break;
+
+            lua_pushnil(L);
+            lua_rawseti(L, -2, k);
+        }
+
+        lua_remove(L, keys);
 
-        auto getBoolDefault = [s](const char *n, bool def) -> bool {
-            auto res = def;
-            lua_pushstring(s->L, n);
-            lua_gettable(s->L, -2);
-            if (lua_isboolean(s->L, -1))
+        // one call covers the whole batch, so it gets each member's instructions
+        Surge::LuaSupport::ScopedEvaluationBudget budget(L, evaluationBudgetSeconds(storage, L),
+                                                         maxProcessInstructions * n);
+        auto lres = lua_pcall(L, 1, 0, 0);
+        chargeEvaluation(storage, L, budget);
+        bool outOfTime = budget.exceeded() && !budget.exceededInstructions();
+        if (lres != LUA_OK)
+        {
+            if (!outOfTime)
             {
-                res = lua_toboolean(s->L, -1);
+                std::ostringstream oss;
+                oss << "Failed to evaluate 'process_block' function. " << lua_tostring(L, -1);
+                lead->adderror(oss.str());
             }
-            lua_pop(s->L, 1);
-            return res;
-        };
-
-        s->useEnvelope = getBoolDefault("use_envelope", true);
-        s->retrigger_AEG = getBoolDefault("retrigger_AEG", false);
-        s->retrigger_FEG = getBoolDefault("retrigger_FEG", false);
+            lua_pop(L, 1);
+        }
 
-        auto doClamp = getBoolDefault("clamp_output", true);
-        if (doClamp)
+        for (int m = 0; m < n; ++m)
         {
-            for (int i = 0; i < 8; ++i)
+            auto &e = batch.entries[members[m]];
+            auto s = e.state;
+
+            s->activeoutputs = 1;
+            memset(output, 0, max_formula_outputs * sizeof(float));
+
+            if (lres != LUA_OK)
             {
-                output[i] = limitpm1(output[i]);
+                if (budget.exceeded())
+                    noteBudgetOverrun(storage, s, budget);
+
+                if (!outOfTime)
+                    s->isvalid = false;
             }
+            else
+            {
+                s->budgetOverruns = 0;
+                s->isFinite = true;
+                lua_rawgeti(L, LUA_REGISTRYINDEX, s->stateRef);
+                readModStateResult(storage, s, output);
+                lua_pop(L, 1);
+            }
+
+            e.finish(e.ctx, output);
         }
+    }
+#endif
 
-        // Finally pop the table result
-        lua_pop(s->L, 1);
-        onerr.replace = false;
-        return;
+    batch.clear();
+}
+
+static bool canShareEvaluation(const EvaluatorState *s)
+{
+    return s->L && s->isvalid && s->shareAcrossVoices && !s->subVoice && !s->raisedError;
+}
+
+static bool sameFormulaInputs(const EvaluatorState *a, const EvaluatorState *b)
+{
+    if (a->L != b->L || strcmp(a->funcName, b->funcName) != 0)
+        return false;
+
+    if (a->subLfoEnvelope != b->subLfoEnvelope || a->subLfoParams != b->subLfoParams ||
+        a->subTiming != b->subTiming || a->subAnyMacro != b->subAnyMacro)
+        return false;
+
+    if (a->del != b->del || a->a != b->a || a->h != b->h || a->dec != b->dec || a->s != b->s ||
+        a->r != b->r)
+        return false;
+
+    if (a->rate != b->rate || a->amp != b->amp || a->phase != b->phase || a->deform != b->deform)
+        return false;
+
+    if (a->tempo != b->tempo || a->songpos != b->songpos || a->released != b->released)
+        return false;
+
+    for (int i = 0; i < n_customcontrollers; ++i)
+    {
+        if (a->subMacros[i] != b->subMacros[i] || a->macrovalues[i] != b->macrovalues[i])
+            return false;
     }
-    else
+
+    return true;
+}
+
+bool findSharedEvaluation(SharedEvaluations &shared, int phaseIntPart, float phaseFracPart,
+                          EvaluatorState *s, float output[max_formula_outputs])
+{
+    if (!canShareEvaluation(s))
+        return false;
+
+    for (int i = 0; i < shared.count; ++i)
     {
-        s->isvalid = false;
-        std::ostringstream oss;
-        oss << "Failed to evaluate 'process' function." << lua_tostring(s->L, -1);
-        s->adderror(oss.str());
-        lua_pop(s->L, 1);
-        return;
+        const auto &r = shared.results[i];
+
+        if (r.phaseIntPart != phaseIntPart || r.phaseFracPart != phaseFracPart ||
+            !sameFormulaInputs(r.source, s))
+            continue;
+
+        memcpy(output, r.output, max_formula_outputs * sizeof(float));
+        s->activeoutputs = r.activeoutputs;
+        s->useEnvelope = r.useEnvelope;
+        s->retrigger_AEG = r.retrigger_AEG;
+        s->retrigger_FEG = r.retrigger_FEG;
+        s->isFinite = r.isFinite;
+        return true;
     }
-#else
-#endif
+
+    return false;
+}
+
+void publishSharedEvaluation(SharedEvaluations &shared, int phaseIntPart, float phaseFracPart,
+                             const EvaluatorState *s, const float output[max_formula_outputs])
+{
+    if (!canShareEvaluation(s) || shared.count >= (int)shared.results.size())
+        return;
+
+    auto &r = shared.results[shared.count++];
+    r.source = s;
+    r.phaseIntPart = phaseIntPart;
+    r.phaseFracPart = phaseFracPart;
+    memcpy(r.output, output, max_formula_outputs * sizeof(float));
+    r.activeoutputs = s->activeoutputs;
+    r.useEnvelope = s->useEnvelope;
+    r.retrigger_AEG = s->retrigger_AEG;
+    r.retrigger_FEG = s->retrigger_FEG;
+    r.isFinite = s->isFinite;
 }
 
 std::vector<DebugRow> createDebugDataOfModState(const EvaluatorState &es)
@@ -26,6 +26,7 @@
 #include "SurgeStorage.h"
 #include "StringOps.h"
 #include "LuaSupport.h"
+#include <array>
 #include <variant>
 
 class SurgeVoice;
@@ -40,21 +41,49 @@ struct GlobalData
     std::unordered_set<std::string> knownBadFunctions; // these are functions which cause an error
     std::unordered_map<FormulaModulatorStorage *, std::unordered_set<std::string>> functionsPerFMS;
     void *audioState{nullptr}, *displayState{nullptr};
+
+    // the interned modstate key tables for each lua state; see internModStateKeys
+    int audioKeysRef{-2}, displayKeysRef{-2};
+
+    // the modstates array evaluateBlockBatch hands to process_block, reused every block
+    int audioBatchRef{-2};
+
+    // wall clock spent in the audio state's formulas so far this block; see beginAudioBlock
+    double audioSecondsThisBlock{0.0};
 };
 
+// the value of LUA_NOREF, which we need even when building without lua
+static constexpr int noLuaRef{-2};
+
 static constexpr int max_formula_outputs{max_lfo_indices};
 
+// how many evaluations in a row may run out of time before we give up on a formula
+static constexpr int maxBudgetOverruns{8};
+
 struct EvaluatorState
 {
     bool released;
     char funcName[TXT_SIZE];
     char funcNameInit[TXT_SIZE];
     char stateName[TXT_SIZE];
+    char funcNameBlock[TXT_SIZE];
 
     bool isvalid = false;
+    bool hasBlockProcess = false;
     bool useEnvelope = true;
     bool isFinite = true;
 
+    /*
+     * set when an evaluation ran past its LuaSupport::ScopedEvaluationBudget and was disabled.
+     * Running past the instruction cap disables a formula at once; running out of time only
+     * does so after maxBudgetOverruns evaluations in a row, which budgetOverruns counts.
+     */
+    bool exceededBudget = false;
+    int budgetOverruns{0};
+
+    // set by init returning modstate["share_across_voices"] = true; see SharedEvaluations
+    bool shareAcrossVoices{false};
+
     bool subVoice{false}, subLfoParams{true}, subLfoEnvelope{false}, subTiming{true};
     bool subMacros[n_customcontrollers], subAnyMacro{false};
 
@@ -82,10 +111,25 @@ struct EvaluatorState
     int activeoutputs;
 
     lua_State *L; // This is assigned by prepareForEvaluation to be one per thread
+
+    /*
+     * Registry references to our process function, our modstate table and the interned keys
+     * table for L. valueAt uses these rather than looking the globals up by name on every
+     * call. The function and state references are owned by this evaluator and released
+     * by cleanEvaluatorState; the keys table is shared by every evaluator on L.
+     */
+    int funcRef{noLuaRef}, stateRef{noLuaRef}, keysRef{noLuaRef};
+    int blockFuncRef{noLuaRef};
 };
 
 void setupStorage(SurgeStorage *s);
 
+/*
+ * Every formula on the audio state shares one block's worth of wall clock, so call this at
+ * the top of each block to hand that budget back out. Audio thread only.
+ */
+void beginAudioBlock(SurgeStorage *s);
+
 bool initEvaluatorState(EvaluatorState &s);
 bool cleanEvaluatorState(EvaluatorState &s);
 void removeFunctionsAssociatedWith(SurgeStorage *,
@@ -99,6 +143,90 @@ void setupEvaluatorStateFrom(EvaluatorState &s, const SurgeVoice *v);
 void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *, FormulaModulatorStorage *fs,
              EvaluatorState *state, float output[max_formula_outputs]);
 
+/*
+ * A formula can opt in to evaluating all of a scene's voices at once by defining
+ *
+ *   function process_block(modstates)
+ *
+ * next to process. modstates is an array holding the modstate of every voice running the
+ * formula this block, each filled in just as it would be for process, and process_block
+ * sets output (and any of the other result fields) on each of them in place. The synth
+ * then enters the interpreter once per block rather than once per voice. process is still
+ * required, since it is used wherever there is no batch, such as at note on and in the
+ * display.
+ *
+ * The audio thread gathers deferred evaluations into a BlockBatch, evaluates it, and each
+ * entry's finish callback receives its outputs exactly as valueAt would have returned them.
+ */
+struct BlockBatch
+{
+    typedef void (*finish_t)(void *ctx, float output[max_formula_outputs]);
+
+    struct Entry
+    {
+        EvaluatorState *state;
+        FormulaModulatorStorage *fs;
+        int phaseIntPart;
+        float phaseFracPart;
+        finish_t finish;
+        void *ctx;
+    };
+
+    std::array<Entry, MAX_VOICES * n_lfos_voice> entries;
+    int count{0};
+
+    void clear() { count = 0; }
+};
+
+/*
+ * Queue an evaluation on the batch. Returns false, leaving the caller to use valueAt, if the
+ * state has no process_block or the batch is full.
+ */
+bool deferToBlockBatch(BlockBatch &batch, int phaseIntPart, float phaseFracPart,
+                       FormulaModulatorStorage *fs, EvaluatorState *state,
+                       BlockBatch::finish_t finish, void *ctx);
+void evaluateBlockBatch(SurgeStorage *, BlockBatch &batch);
+
+/*
+ * A formula which doesn't subscribe to voice features only sees the phase, the LFO
+ * parameters, timing and macros. Voices whose LFOs agree on all of those in a block (free
+ * running or song synced LFOs with the same settings, say) may well compute the same thing,
+ * in which case within a scene the first voice's result can be handed to the rest for that
+ * block. We can't tell that from outside, though, since a formula which draws random numbers
+ * or keeps its own state in modstate gives a different answer per voice. So this is opt in:
+ * a formula whose init sets
+ *
+ *   modstate["share_across_voices"] = true
+ *
+ * and which doesn't subscribe to voice is shared; everything else runs for each voice.
+ */
+struct SharedEvaluations
+{
+    struct Result
+    {
+        const EvaluatorState *source;
+        int phaseIntPart;
+        float phaseFracPart;
+        float output[max_formula_outputs];
+        int activeoutputs;
+        bool useEnvelope, retrigger_AEG, retrigger_FEG, isFinite;
+    };
+
+    std::array<Result, n_lfos_voice * 8> results;
+    int count{0};
+
+    void clear() { count = 0; }
+};
+
+/*
+ * If a voice earlier in this block evaluated the same formula on the same inputs, copy its
+ * outputs and flags into state and output and return true.
+ */
+bool findSharedEvaluation(SharedEvaluations &shared, int phaseIntPart, float phaseFracPart,
+                          EvaluatorState *state, float output[max_formula_outputs]);
+void publishSharedEvaluation(SharedEvaluations &shared, int phaseIntPart, float phaseFracPart,
+                             const EvaluatorState *state, const float output[max_formula_outputs]);
+
 struct DebugRow
 {
     explicit DebugRow(int r, const std::string &s, const std::string &v)
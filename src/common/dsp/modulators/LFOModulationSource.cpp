@@ -93,6 +93,8 @@ void LFOModulationSource::assign(SurgeStorage *storage, LFOStorage *lfo, pdata *
         gen.seed(storage->rand_u32());
         distro = std::uniform_real_distribution<float>(-1.f, 1.f);
         urng = [this]() -> float { return distro(gen); };
+
+        msegstate.seed(storage->rand_u32());
     }
 
     noise = 0.f;
@@ -486,6 +488,9 @@ void LFOModulationSource::attackFrom(float start)
 
         formulastate.isVoice = isVoice;
 
+        Surge::Profiling::PatchLoadProfile::Scope ps(
+            storage->patchLoadProfile, Surge::Profiling::PatchLoadProfile::lp_formulas,
+            !is_display);
         Surge::Formula::prepareForEvaluation(storage, fs, formulastate, is_display);
     }
     break;
@@ -535,6 +540,47 @@ void LFOModulationSource::retriggerEnvelopeFrom(float start)
     }
 }
 
+void LFOModulationSource::finishFormulaJob(void *ctx, float output[])
+{
+    static_cast<LFOModulationSource *>(ctx)->finishFormula(output);
+}
+
+void LFOModulationSource::finishFormula(float tmpout[])
+{
+    if (!formulastate.useEnvelope)
+    {
+        formulaEnvVal = 1.0;
+    }
+
+    retrigger_AEG = formulastate.retrigger_AEG;
+    retrigger_FEG = formulastate.retrigger_FEG;
+
+    if (formulastate.raisedError)
+    {
+        auto em = formulastate.error;
+        formulastate.error = "";
+        formulastate.raisedError = false;
+        storage->noteBlockEvent(SurgeStorage::be_formulaError);
+        storage->reportError(em, "Formula Evaluator Error");
+        std::cout << "ERROR: " << em << std::endl;
+    }
+
+    // Since I'm (right now) the only vector valued modulator just do a little
+    // chute and ladder dance here on the output and return
+    auto magnf = limit_range(lfo->magnitude.get_extended(localcopy[magn].f), -3.f, 3.f);
+    auto uni = lfo->unipolar.val.b;
+
+    for (auto i = 0; i < formulastate.activeoutputs; ++i)
+    {
+        if (uni)
+        {
+            tmpout[i] = 0.5f + 0.5f * tmpout[i];
+        }
+
+        output_multi[i] = formulaEnvVal * magnf * tmpout[i];
+    }
+}
+
 void LFOModulationSource::process_block()
 {
     if ((!phaseInitialized) || (lfo->trigmode.val.i == lm_keytrigger && lfo->rate.deactivated))
@@ -1214,42 +1260,32 @@ void LFOModulationSource::process_block()
 
         formulastate.isVoice = isVoice;
 
-        float tmpout[Surge::Formula::max_formula_outputs] = {0, 0, 0, 0, 0, 0, 0, 0};
-
-        Surge::Formula::valueAt(unwrappedphase_intpart, phase, storage, fs, &formulastate, tmpout);
+        formulaEnvVal = useenvval;
 
-        if (!formulastate.useEnvelope)
+        if (formulaBatch &&
+            Surge::Formula::deferToBlockBatch(*formulaBatch, unwrappedphase_intpart, phase, fs,
+                                              &formulastate, finishFormulaJob, this))
         {
-            useenvval = 1.0;
+            // the batch calls finishFormula once the scene's voices have all been gathered
+            return;
         }
 
-        retrigger_AEG = formulastate.retrigger_AEG;
-        retrigger_FEG = formulastate.retrigger_FEG;
-
-        if (formulastate.raisedError)
-        {
-            auto em = formulastate.error;
-            formulastate.error = "";
-            formulastate.raisedError = false;
-            storage->reportError(em, "Formula Evaluator Error");
-            std::cout << "ERROR: " << em << std::endl;
-        }
-
-        // Since I'm (right now) the only vector valued modulator just do a little
-        // chute and ladder dance here on the output and return
-        auto magnf = limit_range(lfo->magnitude.get_extended(localcopy[magn].f), -3.f, 3.f);
-        auto uni = lfo->unipolar.val.b;
+        float tmpout[Surge::Formula::max_formula_outputs] = {0, 0, 0, 0, 0, 0, 0, 0};
 
-        for (auto i = 0; i < formulastate.activeoutputs; ++i)
+        if (!formulaShare ||
+            !Surge::Formula::findSharedEvaluation(*formulaShare, unwrappedphase_intpart, phase,
+                                                  &formulastate, tmpout))
         {
-            if (uni)
-            {
-                tmpout[i] = 0.5f + 0.5f * tmpout[i];
-            }
+            Surge::Formula::valueAt(unwrappedphase_intpart, phase, storage, fs, &formulastate,
+                                    tmpout);
 
-            output_multi[i] = useenvval * magnf * tmpout[i];
+            if (formulaShare)
+                Surge::Formula::publishSharedEvaluation(*formulaShare, unwrappedphase_intpart,
+                                                        phase, &formulastate, tmpout);
         }
 
+        finishFormula(tmpout);
+
         return;
     }
     };
@@ -115,6 +115,15 @@ class LFOModulationSource : public ModulationSource
     Surge::MSEG::EvaluatorState msegstate;
     Surge::Formula::EvaluatorState formulastate;
 
+    /*
+     * When set, a formula with a process_block is queued on this batch rather than evaluated
+     * in process_block, and its outputs land once the owner runs the batch.
+     */
+    Surge::Formula::BlockBatch *formulaBatch{nullptr};
+
+    // When set, results are shared with other voices' LFOs running the same formula this block
+    Surge::Formula::SharedEvaluations *formulaShare{nullptr};
+
     inline float getPhase() { return phase; }
     inline int getIntPhase() { return unwrappedphase_intpart; }
     inline int getEnvState() { return env_state; }
@@ -127,6 +136,8 @@ class LFOModulationSource : public ModulationSource
     bool phaseInitialized;
     void initPhaseFromStartPhase();
     void msegEnvelopePhaseAdjustment();
+    void finishFormula(float output[]);
+    static void finishFormulaJob(void *ctx, float output[]);
 
     float phase, target, noise, noised1, env_phase, priorPhase;
     int unwrappedphase_intpart;
@@ -134,6 +145,7 @@ class LFOModulationSource : public ModulationSource
     float ratemult;
     float env_releasestart;
     float iout;
+    float formulaEnvVal;
     float wf_history[4];
     bool is_display;
     int step, shuffle_id;
@@ -32,6 +32,83 @@ namespace Surge
 namespace MSEG
 {
 
+/*
+ * The parts of each curve which only depend on the segment's own shape. These are the exact
+ * expressions valueAt used to evaluate inline, so caching them doesn't change any output.
+ */
+static void rebuildCurveTerms(MSEGStorage *ms, int i)
+{
+    const auto &r = ms->segments[i];
+
+    switch (r.type)
+    {
+    case MSEGStorage::segment::LINEAR:
+    case MSEGStorage::segment::SCURVE:
+    {
+        // See the derivation in valueAt
+        float V = 0.5 * r.cpv + 0.5;
+        float amul = 1;
+
+        if (V < 0.5)
+        {
+            amul = -1;
+            V = 1 - V;
+        }
+
+        float disc = (1 - 4 * V * (1 - V));
+        float a = 0;
+
+        if (fabs(V) > 1e-3)
+        {
+            float Q = limit_range((1 - sqrt(disc)) / (2 * V), 0.00001f, 1000000.f);
+            a = amul * 2 * log(Q);
+        }
+
+        ms->segmentCurveA[i] = a;
+        break;
+    }
+    case MSEGStorage::segment::QUAD_BEZIER:
+    {
+        float cpt = r.cpduration * r.duration;
+
+        if (fabs(cpt - r.duration * 0.5) < 1e-5)
+        {
+            cpt += 1e-4;
+        }
+
+        float tp = r.duration / 2;
+        float dt = (cpt - tp);
+
+        ms->segmentBezierCp[i] = tp + 2 * dt;
+        break;
+    }
+    case MSEGStorage::segment::SINE:
+    case MSEGStorage::segment::SAWTOOTH:
+    case MSEGStorage::segment::TRIANGLE:
+    case MSEGStorage::segment::SQUARE:
+    {
+        float pct = (r.cpv + 1) * 0.5;
+        float as = 5.0;
+        float scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
+
+        ms->segmentSteps[i] = (int)(scaledpct * 100);
+        break;
+    }
+    case MSEGStorage::segment::STAIRS:
+    case MSEGStorage::segment::SMOOTH_STAIRS:
+    {
+        auto pct = (r.cpv + 1) * 0.5;
+        auto as = 5.0;
+        auto scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
+
+        ms->segmentSteps[i] = (int)(scaledpct * 100) + 2;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
 void rebuildCache(MSEGStorage *ms)
 {
     if (ms->loop_start > ms->n_activeSegments - 1)
@@ -93,9 +170,18 @@ void rebuildCache(MSEGStorage *ms)
         ms->segmentEnd[ms->n_activeSegments - 1] = 1.0;
     }
 
+    ms->segmentEndsSorted = true;
+
     for (int i = 0; i < ms->n_activeSegments; ++i)
     {
         constrainControlPointAt(ms, i);
+        rebuildCurveTerms(ms, i);
+
+        if (i > 0 && (ms->segmentEnd[i] < ms->segmentEnd[i - 1] ||
+                      ms->segmentStart[i] < ms->segmentStart[i - 1]))
+        {
+            ms->segmentEndsSorted = false;
+        }
     }
 
     ms->durationToLoopEnd = ms->totalDuration;
@@ -114,6 +200,49 @@ void rebuildCache(MSEGStorage *ms)
     }
 }
 
+/*
+ * The first segment with start <= t < end, or start <= t <= end if endInclusive. Once
+ * rebuildCache has run, segmentStart and segmentEnd are non decreasing, so we can binary
+ * search rather than walk every segment. The walk is kept for the odd LFO mode MSEG whose
+ * last end was clamped below the one before it.
+ */
+static int findSegment(const MSEGStorage *ms, double t, bool endInclusive)
+{
+    int n = ms->n_activeSegments;
+
+    if (!ms->segmentEndsSorted)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            if (t >= ms->segmentStart[i] &&
+                (endInclusive ? t <= ms->segmentEnd[i] : t < ms->segmentEnd[i]))
+            {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    int lo = 0, hi = n;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi) >> 1;
+        bool endsBefore = endInclusive ? ms->segmentEnd[mid] < t : ms->segmentEnd[mid] <= t;
+
+        if (endsBefore)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < n && t >= ms->segmentStart[lo])
+        return lo;
+
+    return -1;
+}
+
 float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es, bool forceOneShot)
 {
     if (ms->n_activeSegments <= 0)
@@ -180,15 +309,7 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
             double adjustedPhase = up - es->releaseStartPhase + ms->segmentEnd[ms->loop_end];
 
             // so now find the index
-            idx = -1;
-
-            for (int ai = 0; ai < ms->n_activeSegments && idx < 0; ai++)
-            {
-                if (ms->segmentStart[ai] <= adjustedPhase && ms->segmentEnd[ai] > adjustedPhase)
-                {
-                    idx = ai;
-                }
-            }
+            idx = findSegment(ms, adjustedPhase, false);
 
             if (idx < 0)
             {
@@ -349,23 +470,8 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
          *
          */
 
-        float V = 0.5 * r.cpv + 0.5;
-        float amul = 1;
-
-        if (V < 0.5)
-        {
-            amul = -1;
-            V = 1 - V;
-        }
-
-        float disc = (1 - 4 * V * (1 - V));
-        float a = 0;
-
-        if (fabs(V) > 1e-3)
-        {
-            float Q = limit_range((1 - sqrt(disc)) / (2 * V), 0.00001f, 1000000.f);
-            a = amul * 2 * log(Q);
-        }
+        // That only depends on the control point, so rebuildCache has worked it out for us
+        float a = ms->segmentCurveA[idx];
 
         // OK so frac is the 0,1 line point
         auto cpline = frac;
@@ -413,24 +519,21 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
         */
 
         float cpv = lcpv;
-        float cpt = r.cpduration * r.duration;
 
-        // If we are positioned exactly at the midpoint our calculation below to find time will fail
-        // so walk off a smidge
-        if (fabs(cpt - r.duration * 0.5) < 1e-5)
-        {
-            cpt += 1e-4;
-        }
+        /*
+         * The time of the pushed out control point only depends on the segment, so it comes
+         * from rebuildCache. (If the control point sits exactly at the midpoint the time
+         * search below would fail, so it walks off a smidge there.)
+         */
+        float cpt = ms->segmentBezierCp[idx];
 
         // here's the midpoint along the connecting curve
-        float tp = r.duration / 2;
         float vp = (lv1 - lv0) / 2 + lv0;
 
-        // The distance from tp,vp to cpt,cpv
-        float dt = (cpt - tp), dy = (cpv - vp);
+        // The distance from vp to cpv
+        float dy = (cpv - vp);
 
         cpv = vp + 2 * dy;
-        cpt = tp + 2 * dt;
 
         // B = (1-t)^2 P0 + 2 t (1-t) P1 + t^2 P2
         float ttarget = timeAlongSegment;
@@ -502,10 +605,7 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
     case MSEGStorage::segment::TRIANGLE:
     case MSEGStorage::segment::SQUARE:
     {
-        float pct = (r.cpv + 1) * 0.5;
-        float as = 5.0;
-        float scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
-        int steps = (int)(scaledpct * 100);
+        int steps = ms->segmentSteps[idx];
         auto frac = timeAlongSegment / r.duration;
         float kernel = 0;
 
@@ -575,10 +675,7 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
 
     case MSEGStorage::segment::STAIRS:
     {
-        auto pct = (r.cpv + 1) * 0.5;
-        auto as = 5.0;
-        auto scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
-        auto steps = (int)(scaledpct * 100) + 2;
+        auto steps = ms->segmentSteps[idx];
         auto frac = (float)((int)(steps * timeAlongSegment / r.duration)) / (steps - 1);
 
         if (df < 0)
@@ -596,10 +693,7 @@ float valueAt(int ip, float fup, float df, MSEGStorage *ms, EvaluatorState *es,
     }
     case MSEGStorage::segment::SMOOTH_STAIRS:
     {
-        auto pct = (r.cpv + 1) * 0.5;
-        auto as = 5.0;
-        auto scaledpct = (exp(as * pct) - 1) / (exp(as) - 1);
-        auto steps = (int)(scaledpct * 100) + 2;
+        auto steps = ms->segmentSteps[idx];
         auto frac = timeAlongSegment / r.duration;
 
         auto c = df < 0.f ? 1.0 + df * 0.7 : 1.0 + df * 3.0;
@@ -747,17 +841,11 @@ int timeToSegment(MSEGStorage *ms, double t, bool ignoreLoops, float &amountAlon
             }
         }
 
-        int idx = -1;
+        int idx = findSegment(ms, t, false);
 
-        for (int i = 0; i < ms->n_activeSegments; ++i)
+        if (idx >= 0)
         {
-            if (t >= ms->segmentStart[i] && t < ms->segmentEnd[i])
-            {
-                idx = i;
-                amountAlongSegment = t - ms->segmentStart[i];
-
-                break;
-            }
+            amountAlongSegment = t - ms->segmentStart[idx];
         }
 
         return idx;
@@ -771,13 +859,14 @@ int timeToSegment(MSEGStorage *ms, double t, bool ignoreLoops, float &amountAlon
         // So are we before the first loop end point
         if (t <= ms->durationToLoopEnd)
         {
-            for (int i = 0; i < ms->n_activeSegments; ++i)
-                if (t >= ms->segmentStart[i] && t <= ms->segmentEnd[i])
-                {
-                    amountAlongSegment = t - ms->segmentStart[i];
+            auto i = findSegment(ms, t, true);
 
-                    return i;
-                }
+            if (i >= 0)
+            {
+                amountAlongSegment = t - ms->segmentStart[i];
+
+                return i;
+            }
         }
         else if (ms->loop_start > ms->loop_end && ms->loop_start >= 0 && ms->loop_end >= 0)
         {
@@ -805,13 +894,14 @@ int timeToSegment(MSEGStorage *ms, double t, bool ignoreLoops, float &amountAlon
             // and we need to offset it by the starting point
             nt += ms->segmentStart[ls];
 
-            for (int i = 0; i < ms->n_activeSegments; ++i)
-                if (nt >= ms->segmentStart[i] && nt <= ms->segmentEnd[i])
-                {
-                    amountAlongSegment = nt - ms->segmentStart[i];
+            auto i = findSegment(ms, nt, true);
 
-                    return i;
-                }
+            if (i >= 0)
+            {
+                amountAlongSegment = nt - ms->segmentStart[i];
+
+                return i;
+            }
         }
 
         return 0;
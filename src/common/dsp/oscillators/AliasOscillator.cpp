@@ -24,6 +24,7 @@
 
 #include "AliasOscillator.h"
 #include "SineOscillator.h"
+#include "SIMDDotProducts.h"
 
 // This linear representation is required for VST3 automation and the like and needs to
 // match the param ID the UI is driven by the remapper code in init_ctrltypes
@@ -85,10 +86,12 @@ void AliasOscillator::init(float pitch, bool is_display, bool nonzero_init_drift
 
         phase[u] = oscdata->retrigger.val.b || is_display ? 0.f : storage->rand_u32();
 
-        driftLFO[u].init(nonzero_init_drift);
+        driftLFO[u].init(nonzero_init_drift, storage);
         // Seed the RNGs in display mode
         if (is_display)
             urng8[u].a = 73;
+        else
+            urng8[u].a = storage->rand_u32() & 0xFF;
     }
 
     charFilt.init(storage->getPatch().character.val.i);
@@ -293,100 +296,217 @@ void AliasOscillator::process_block_internal(const float pitch, const float drif
             two32;
     }
 
-    for (int i = 0; i < BLOCK_SIZE_OS; ++i)
+    if constexpr (wavetype != aow_noise && wavetype != aow_pulse)
     {
-        // int64_t since I can span +/- two32 or beyond
-        int64_t fmPhaseShift = 0;
-
-        if (do_FM)
+        /*
+         * Four unison voices to a register. Lanes past n_unison have no level, so they play
+         * silence, and their phases are local copies which never make it back into phase[].
+         * Noise keeps a generator per voice and pulse runs its phase through a float which
+         * can overflow 32 bits, so those two stay on the voice at a time loop below.
+         */
+        const int n_quads = (n_unison + 3) >> 2;
+
+        alignas(16) uint32_t lanePhase[MAX_UNISON], laneIncrement[MAX_UNISON];
+        alignas(16) float laneL[MAX_UNISON], laneR[MAX_UNISON];
+
+        for (int u = 0; u < n_quads << 2; ++u)
         {
-            fmPhaseShift = (int64_t)(fmdepth.v * master_osc[i] * two32);
+            const bool live = u < n_unison;
+            lanePhase[u] = live ? phase[u] : 0;
+            laneIncrement[u] = live ? phase_increments[u] : 0;
+            laneL[u] = live ? mixL[u] : 0.f;
+            laneR[u] = live ? mixR[u] : 0.f;
         }
 
-        float vL = 0.f, vR = 0.f;
-
-        for (int u = 0; u < n_unison; ++u)
+        const auto mmByte = _mm_set1_epi32(bit_mask);
+        const auto mmMask = _mm_set1_epi32(mask);
+        const auto mmThreshold = _mm_set1_epi32(threshold);
+        const auto mmLift = _mm_set1_epi32(0x7F - threshold);
+        const auto mmWrap = _mm_set1_ps(wrap);
+        const auto mmCentre = _mm_set1_ps((float)0x7F);
+        const auto mmScale = _mm_set1_ps(inv_bit_mask);
+        const auto mmQuant = _mm_set1_ps(quant);
+        const auto mmDequant = _mm_set1_ps(dequant);
+
+        for (int i = 0; i < BLOCK_SIZE_OS; ++i)
         {
-            uint32_t _phase = phase[u]; // default to this
-            if (wavetype == aow_pulse)
-            { // but for pulse...
-                // fake hardsync
-                _phase = (uint32_t)((float)phase[u] * wrap);
+            // the shift only ever lands mod 2^32, as it does on the uint32_t phase below
+            uint32_t fmPhaseShift = 0;
+
+            if (do_FM)
+            {
+                fmPhaseShift = (uint32_t)(int64_t)(fmdepth.v * master_osc[i] * two32);
             }
-            const uint8_t upper = _phase >> 24; // upper 8 bits
-            const uint8_t masked = upper ^ mask;
 
-            uint8_t result = masked; // default to this
+            const auto mmShift = _mm_set1_epi32((int32_t)fmPhaseShift);
+            auto sumL = _mm_setzero_ps(), sumR = _mm_setzero_ps();
 
-            if (wavetype == aow_ramp)
+            for (int q = 0; q < n_quads << 2; q += 4)
             {
-                // flip wave to make a triangle shape (n.b. has a DC offset)
-                if (upper > threshold)
+                auto ph = _mm_load_si128((__m128i *)&lanePhase[q]);
+                const auto upper = _mm_srli_epi32(ph, 24);
+                const auto masked = _mm_xor_si128(upper, mmMask);
+                auto result = masked;
+
+                if (wavetype == aow_ramp)
                 {
-                    if (ramp_unmasked_after_threshold)
-                    {
-                        result = bit_mask - upper;
-                    }
-                    else
-                    {
-                        result = bit_mask - masked;
-                    }
+                    const auto flipped =
+                        _mm_sub_epi32(mmByte, ramp_unmasked_after_threshold ? upper : masked);
+                    const auto over = _mm_cmpgt_epi32(upper, mmThreshold);
+                    result = _mm_or_si128(_mm_and_si128(over, flipped),
+                                          _mm_andnot_si128(over, masked));
                 }
-            }
-            else if (wavetype == aow_pulse)
-            {
-                result = (masked > threshold) ? bit_mask : 0x00;
-            }
-            else if (wavetype == aow_noise)
-            {
-                result = urng8[u].stepTo((upper & 0xFF), threshold | 8U);
-                // OK so we want to wrap towards 255/0 so
-                int32_t shapes = result - 0x7F;
-                shapes = localClamp((int32_t)(shapes * wrap), -0x7F, 0x7F - 1);
-                result = (uint8_t)(shapes + 0x7F);
-            }
 
-            if (wavetype != aow_noise && wavetype != aow_pulse)
-            {
-                // wraparound. scales the result by a float, then casts back down to a byte
-                result = (uint8_t)((float)result * wrap);
-            }
+                // the same truncate and keep the low byte as the scalar cast to uint8_t
+                result = _mm_and_si128(
+                    _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(result), mmWrap)), mmByte);
 
-            // default to this
-            float out = ((float)result - (float)0x7F) * inv_bit_mask;
+                __m128 out;
 
-            // but for wavetable modes, index a table instead
-            if (wavetable_mode) // TODO: maybe move this bool into the template?
-            {
-                if (result > threshold)
+                if (wavetable_mode)
+                {
+                    const auto over = _mm_cmpgt_epi32(result, mmThreshold);
+                    result =
+                        _mm_and_si128(_mm_add_epi32(result, _mm_and_si128(over, mmLift)), mmByte);
+
+                    alignas(16) int32_t idx[4];
+                    _mm_store_si128((__m128i *)idx, result);
+
+                    out = _mm_setr_ps(wavetable[0xFF - idx[0]], wavetable[0xFF - idx[1]],
+                                      wavetable[0xFF - idx[2]], wavetable[0xFF - idx[3]]);
+                }
+                else
+                {
+                    out = _mm_cvtepi32_ps(result);
+                }
+
+                out = _mm_mul_ps(_mm_sub_ps(out, mmCentre), mmScale);
+
+                if (do_bitcrush)
                 {
-                    result += 0x7F - threshold;
+                    out = _mm_mul_ps(mmDequant,
+                                     _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(out, mmQuant))));
                 }
 
-                out = ((float)wavetable[0xFF - result] - (float)0x7F) * inv_bit_mask;
+                sumL = _mm_add_ps(sumL, _mm_mul_ps(out, _mm_load_ps(&laneL[q])));
+                sumR = _mm_add_ps(sumR, _mm_mul_ps(out, _mm_load_ps(&laneR[q])));
+
+                if (do_FM)
+                {
+                    ph = _mm_add_epi32(ph, mmShift);
+                }
+                ph = _mm_add_epi32(ph, _mm_load_si128((__m128i *)&laneIncrement[q]));
+                _mm_store_si128((__m128i *)&lanePhase[q], ph);
             }
 
-            if (do_bitcrush)
+            output[i] = Surge::DSP::hsumF32(sumL);
+            outputR[i] = Surge::DSP::hsumF32(sumR);
+
+            fmdepth.process();
+        }
+
+        for (int u = 0; u < n_unison; ++u)
+        {
+            phase[u] = lanePhase[u];
+        }
+    }
+    else
+    {
+        for (int i = 0; i < BLOCK_SIZE_OS; ++i)
+        {
+            // int64_t since I can span +/- two32 or beyond
+            int64_t fmPhaseShift = 0;
+
+            if (do_FM)
             {
-                // bitcrush
-                out = dequant * (int)(out * quant);
+                fmPhaseShift = (int64_t)(fmdepth.v * master_osc[i] * two32);
             }
 
-            vL += out * mixL[u];
-            vR += out * mixR[u];
+            float vL = 0.f, vR = 0.f;
 
-            // this order actually kinda matters in 32-bit especially
-            if (do_FM)
+            for (int u = 0; u < n_unison; ++u)
             {
-                phase[u] += fmPhaseShift;
+                uint32_t _phase = phase[u]; // default to this
+                if (wavetype == aow_pulse)
+                { // but for pulse...
+                    // fake hardsync
+                    _phase = (uint32_t)((float)phase[u] * wrap);
+                }
+                const uint8_t upper = _phase >> 24; // upper 8 bits
+                const uint8_t masked = upper ^ mask;
+
+                uint8_t result = masked; // default to this
+
+                if (wavetype == aow_ramp)
+                {
+                    // flip wave to make a triangle shape (n.b. has a DC offset)
+                    if (upper > threshold)
+                    {
+                        if (ramp_unmasked_after_threshold)
+                        {
+                            result = bit_mask - upper;
+                        }
+                        else
+                        {
+                            result = bit_mask - masked;
+                        }
+                    }
+                }
+                else if (wavetype == aow_pulse)
+                {
+                    result = (masked > threshold) ? bit_mask : 0x00;
+                }
+                else if (wavetype == aow_noise)
+                {
+                    result = urng8[u].stepTo((upper & 0xFF), threshold | 8U);
+                    // OK so we want to wrap towards 255/0 so
+                    int32_t shapes = result - 0x7F;
+                    shapes = localClamp((int32_t)(shapes * wrap), -0x7F, 0x7F - 1);
+                    result = (uint8_t)(shapes + 0x7F);
+                }
+
+                if (wavetype != aow_noise && wavetype != aow_pulse)
+                {
+                    // wraparound. scales the result by a float, then casts back down to a byte
+                    result = (uint8_t)((float)result * wrap);
+                }
+
+                // default to this
+                float out = ((float)result - (float)0x7F) * inv_bit_mask;
+
+                // but for wavetable modes, index a table instead
+                if (wavetable_mode) // TODO: maybe move this bool into the template?
+                {
+                    if (result > threshold)
+                    {
+                        result += 0x7F - threshold;
+                    }
+
+                    out = ((float)wavetable[0xFF - result] - (float)0x7F) * inv_bit_mask;
+                }
+
+                if (do_bitcrush)
+                {
+                    // bitcrush
+                    out = dequant * (int)(out * quant);
+                }
+
+                vL += out * mixL[u];
+                vR += out * mixR[u];
+
+                // this order actually kinda matters in 32-bit especially
+                if (do_FM)
+                {
+                    phase[u] += fmPhaseShift;
+                }
+                phase[u] += phase_increments[u];
             }
-            phase[u] += phase_increments[u];
-        }
 
-        output[i] = vL;
-        outputR[i] = vR;
+            output[i] = vL;
+            outputR[i] = vR;
 
-        fmdepth.process();
+            fmdepth.process();
+        }
     }
 
     if (!stereo)
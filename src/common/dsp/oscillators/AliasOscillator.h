@@ -142,6 +142,9 @@ class AliasOscillator : public Oscillator
     UInt8RNG urng8[MAX_UNISON];
 
     Surge::Oscillator::DriftLFO driftLFO[MAX_UNISON];
+
+    // for the audio buffer wave
+    Surge::Storage::AudioInputClient audioInputClient{storage};
 };
 
 struct Always255CountedSet
@@ -62,6 +62,7 @@ class AudioInputOscillator : public Oscillator
   private:
     BiquadFilter lp, hp;
     void applyFilter();
+    Surge::Storage::AudioInputClient audioInputClient{storage};
 };
 
 #endif // SURGE_SRC_COMMON_DSP_OSCILLATORS_AUDIOINPUTOSCILLATOR_H
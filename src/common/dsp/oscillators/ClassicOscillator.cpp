@@ -247,7 +247,7 @@ void ClassicOscillator::init(float pitch, bool is_display, bool nonzero_init_dri
         dc_uni[i] = 0.f;
         state[i] = 0.f;
         pwidth[i] = limit_range(l_pw.v, 0.001f, 0.999f);
-        driftLFO[i].init(nonzero_init_drift);
+        driftLFO[i].init(nonzero_init_drift, storage);
     }
 }
 
@@ -281,6 +281,104 @@ void ClassicOscillator::init_default_values()
     oscdata->p[co_unison_voices].val.i = 1;
 }
 
+/*
+** Everything about a sub-voice's pitch is fixed for the length of a block: the drift LFOs
+** step once per block, and the lags, tuning and detune spread are only updated at the top of
+** process_block. So rather than paying for the tuning table lookups (and a reciprocal) at every
+** single impulse, we work them out here for all unison voices at once, in lane-friendly flat
+** arrays, and convolute just reads them back. With 16 unison voices on a high note this is
+** most of the non-convolution work of the oscillator.
+**
+** The convolution itself stays one impulse at a time. Each sub-voice lands its impulses at its
+** own fractional positions, so there's nothing to share across voices there.
+*/
+void ClassicOscillator::update_unison_periods()
+{
+    auto detuneAmount = oscdata->p[co_unison_detune].get_extended(localcopy[id_detune].f);
+    bool absolute = oscdata->p[co_unison_detune].absolute;
+    float sync = min((float)l_sync.v, (12 + 72 + 72) - pitch);
+
+    for (int voice = 0; voice < n_unison; ++voice)
+    {
+        /*
+        ** Detune by a combination of the LFO drift and the unison voice spread.
+        */
+        float detune = drift * driftLFO[voice].val();
+        if (n_unison > 1)
+        {
+            detune += detuneAmount * (detune_bias * (float)voice + detune_offset);
+        }
+
+        // See the extensive comment below
+        if (!absolute)
+        {
+            syncPeriod[voice] = storage->note_to_pitch_inv_tuningctr(detune) * 2;
+        }
+        else
+        {
+            // Copy the mysterious * 2 and drop the +sync
+            syncPeriod[voice] = storage->note_to_pitch_inv_ignoring_tuning(
+                                    detune * storage->note_to_pitch_inv_ignoring_tuning(pitch) *
+                                    16 / 0.9443) *
+                                2;
+        }
+
+        float t;
+
+        if (absolute)
+        {
+            /*
+            ** Oh so this line of code. What is it doing?
+            **
+            **  t = storage->note_to_pitch_inv_tuningctr(detune * pitchmult_inv * (1.f / 440.f) + sync);
+            ** Let's for a moment assume standard tuning. So note_to_pitch_inv will give you, say, 1/32
+            *for note 60 and 1/1 for note 0. Cool.
+            ** It is the inverse of frequency. That's why below with detune = +/- 1 for the extreme 2
+            *voice case we just use it directly.
+            ** It is the time distance of one note.
+            **
+            ** But in absolute mode we want to scale that note. So the calculation here (assume sync is
+            *0 for a second) is
+            ** detune * pitchmult_inv / 440
+            ** pitchmult_inv =  dsamplerate_os / 8.17 * note_to_pitch_inv(pitch)
+            ** so this is using
+            ** detune * 1.0 / 440 * 1.0 / 8.17 * dsamplerate * note_to_pitch_inv(pitch)
+            ** Or:
+            ** detune / note_to_pitch(pitch) * ( 1.0 / (440 * 8.17 ) ) * dsamplerate
+            **
+            ** So there's a couple of things wrong with that. First of all this should not be samplerate
+            *dependent.
+            ** Second of all, what's up with 1.0 / ( 8.17 * 440 )
+            **
+            ** Well the answer is that we want the time to be pushed around in Hz. So it turns out that
+            ** 44100 * 2 / ( 440 * 8.175 ) =~ 24.2 and 24.2 / 16 = 1.447 which is almost how much
+            *absolute is off. So
+            ** let's set the multiplier here so that the regtests exactly match the display frequency.
+            *That is the
+            ** frequency desired spread / 0.9443. 0.9443 is empirically determined by running the 2
+            *unison voices case
+            ** over a bunch of tests.
+            */
+            t = storage->note_to_pitch_inv_ignoring_tuning(
+                detune * storage->note_to_pitch_inv_ignoring_tuning(pitch) * 16 / 0.9443 + sync);
+
+            // With extended range and low frequencies we can have an implied negative frequency; cut
+            // that off by setting a lower bound here.
+            if (t < 0.01)
+            {
+                t = 0.01;
+            }
+        }
+        else
+        {
+            t = storage->note_to_pitch_inv_tuningctr(detune + sync);
+        }
+
+        period[voice] = t;
+        periodInv[voice] = mech::rcp(t);
+    }
+}
+
 template <bool FM> void ClassicOscillator::convolute(int voice, bool stereo)
 {
     /*
@@ -291,16 +389,6 @@ template <bool FM> void ClassicOscillator::convolute(int voice, bool stereo)
     ** the amount just covered.
     */
 
-    /*
-    ** Detune by a combination of the LFO drift and the unison voice spread.
-    */
-    float detune = drift * driftLFO[voice].val();
-    if (n_unison > 1)
-    {
-        detune += oscdata->p[co_unison_detune].get_extended(localcopy[id_detune].f) *
-                  (detune_bias * (float)voice + detune_offset);
-    }
-
     float wf = l_shape.v;
     float sub = l_sub.v;
     const float p24 = (1 << 24);
@@ -322,20 +410,7 @@ template <bool FM> void ClassicOscillator::convolute(int voice, bool stereo)
             ipos = (unsigned int)(p24 * (syncstate[voice] * pitchmult_inv));
         }
 
-        float t;
-
-        // See the extensive comment below
-        if (!oscdata->p[co_unison_detune].absolute)
-        {
-            t = storage->note_to_pitch_inv_tuningctr(detune) * 2;
-        }
-        else
-        {
-            // Copy the mysterious * 2 and drop the +sync
-            t = storage->note_to_pitch_inv_ignoring_tuning(
-                    detune * storage->note_to_pitch_inv_ignoring_tuning(pitch) * 16 / 0.9443) *
-                2;
-        }
+        float t = syncPeriod[voice];
 
         state[voice] = 0;
         last_level[voice] += dc_uni[voice] * (oscstate[voice] - syncstate[voice]);
@@ -388,59 +463,12 @@ template <bool FM> void ClassicOscillator::convolute(int voice, bool stereo)
 
     int k;
     const float s = 0.99952f;
-    float sync = min((float)l_sync.v, (12 + 72 + 72) - pitch);
-    float t;
-
-    if (oscdata->p[co_unison_detune].absolute)
-    {
-        /*
-        ** Oh so this line of code. What is it doing?
-        **
-        **  t = storage->note_to_pitch_inv_tuningctr(detune * pitchmult_inv * (1.f / 440.f) + sync);
-        ** Let's for a moment assume standard tuning. So note_to_pitch_inv will give you, say, 1/32
-        *for note 60 and 1/1 for note 0. Cool.
-        ** It is the inverse of frequency. That's why below with detune = +/- 1 for the extreme 2
-        *voice case we just use it directly.
-        ** It is the time distance of one note.
-        **
-        ** But in absolute mode we want to scale that note. So the calculation here (assume sync is
-        *0 for a second) is
-        ** detune * pitchmult_inv / 440
-        ** pitchmult_inv =  dsamplerate_os / 8.17 * note_to_pitch_inv(pitch)
-        ** so this is using
-        ** detune * 1.0 / 440 * 1.0 / 8.17 * dsamplerate * note_to_pitch_inv(pitch)
-        ** Or:
-        ** detune / note_to_pitch(pitch) * ( 1.0 / (440 * 8.17 ) ) * dsamplerate
-        **
-        ** So there's a couple of things wrong with that. First of all this should not be samplerate
-        *dependent.
-        ** Second of all, what's up with 1.0 / ( 8.17 * 440 )
-        **
-        ** Well the answer is that we want the time to be pushed around in Hz. So it turns out that
-        ** 44100 * 2 / ( 440 * 8.175 ) =~ 24.2 and 24.2 / 16 = 1.447 which is almost how much
-        *absolute is off. So
-        ** let's set the multiplier here so that the regtests exactly match the display frequency.
-        *That is the
-        ** frequency desired spread / 0.9443. 0.9443 is empirically determined by running the 2
-        *unison voices case
-        ** over a bunch of tests.
-        */
-        t = storage->note_to_pitch_inv_ignoring_tuning(
-            detune * storage->note_to_pitch_inv_ignoring_tuning(pitch) * 16 / 0.9443 + sync);
-
-        // With extended range and low frequencies we can have an implied negative frequency; cut
-        // that off by setting a lower bound here.
-        if (t < 0.01)
-        {
-            t = 0.01;
-        }
-    }
-    else
-    {
-        t = storage->note_to_pitch_inv_tuningctr(detune + sync);
-    }
-
-    float t_inv = mech::rcp(t);
+    /*
+    ** The time to the next impulse only depends on this sub-voice's detune, which is fixed
+    ** for the block, so it comes from update_unison_periods rather than being recomputed here.
+    */
+    float t = period[voice];
+    float t_inv = periodInv[voice];
     float g = 0.0, gR = 0.0;
 
     /*
@@ -634,6 +662,8 @@ void ClassicOscillator::process_block(float pitch0, float drift, bool stereo, bo
             driftLFO[l].next();
         }
 
+        update_unison_periods();
+
         for (int s = 0; s < BLOCK_SIZE_OS; s++)
         {
             float fmmul = limit_range(1.f + depth * master_osc[s], 0.1f, 1.9f);
@@ -672,7 +702,12 @@ void ClassicOscillator::process_block(float pitch0, float drift, bool stereo, bo
         for (l = 0; l < n_unison; l++)
         {
             driftLFO[l].next();
+        }
+
+        update_unison_periods();
 
+        for (l = 0; l < n_unison; l++)
+        {
             /*
             ** Either while sync is active and we need to fill syncstate traversal,
             ** or while we need to fill oscstate traversal to cover the expected request,
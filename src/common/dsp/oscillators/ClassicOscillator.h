@@ -57,6 +57,10 @@ class ClassicOscillator : public AbstractBlitOscillator
     float dc, dc_uni[MAX_UNISON], elapsed_time[MAX_UNISON], last_level[MAX_UNISON],
         pwidth[MAX_UNISON], pwidth2[MAX_UNISON];
     template <bool is_init> void update_lagvals();
+    void update_unison_periods();
+    // per sub-voice impulse spacing for the current block; see update_unison_periods
+    float period alignas(16)[MAX_UNISON], periodInv alignas(16)[MAX_UNISON],
+        syncPeriod alignas(16)[MAX_UNISON];
     float pitch;
     lipol_ps li_hpf, li_DC;
     lag<float> FMdepth, integrator_mult, l_pw, l_pw2, l_shape, l_sub, l_sync;
@@ -38,7 +38,7 @@ void FM2Oscillator::init(float pitch, bool is_display, bool nonzero_init_drift)
     phase =
         (is_display || oscdata->retrigger.val.b) ? 0.f : (2.0 * M_PI * storage->rand_01() - M_PI);
     lastoutput = 0.0;
-    driftLFO.init(nonzero_init_drift);
+    driftLFO.init(nonzero_init_drift, storage);
     fb_val = 0.0;
     double ph = (localcopy[oscdata->p[fm2_m12phase].param_id_in_scene].f + phase) * 2.0 * M_PI;
     RM1.set_phase(ph);
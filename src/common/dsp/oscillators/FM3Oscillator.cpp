@@ -36,7 +36,7 @@ void FM3Oscillator::init(float pitch, bool is_display, bool nonzero_init_drift)
     phase =
         (is_display || oscdata->retrigger.val.b) ? 0.f : (2.0 * M_PI * storage->rand_01() - M_PI);
     lastoutput = 0.f;
-    driftLFO.init(nonzero_init_drift);
+    driftLFO.init(nonzero_init_drift, storage);
     fb_val = 0.f;
     AM.set_phase(phase);
     RM1.set_phase(phase);
@@ -147,7 +147,7 @@ void ModernOscillator::init(float pitch, bool is_display, bool nonzero_init_drif
         sprior[u] = 0;
         sTurnVal[u] = 0;
 
-        driftLFO[u].init(nonzero_init_drift);
+        driftLFO[u].init(nonzero_init_drift, storage);
 
         sReset[u] = false;
     }
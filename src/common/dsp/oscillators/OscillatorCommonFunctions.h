@@ -30,23 +30,37 @@ namespace Surge
 {
 namespace Oscillator
 {
+/*
+ * Voices can render on several threads at once, so each drift LFO draws its per-block noise
+ * from its own small xorshift generator. Only init touches the storage generator, to seed it,
+ * which also keeps an LFO's drift the same however the voices happen to be spread over threads
+ * (and makes it follow the seed under seeded rendering).
+ */
 struct DriftLFO
 {
     DriftLFO() noexcept : d(0), d2(0) {}
 
-    inline void init(bool nzi)
+    inline void init(bool nzi, SurgeStorage *storage)
     {
         d = 0;
         d2 = 0;
         if (nzi)
-            d2 = 0.0005 * ((float)rand() / (float)(RAND_MAX));
+            d2 = 0.0005 * storage->rand_01();
+
+        rngState = storage->rand_u32() * 2654435761u;
+        if (rngState == 0)
+            rngState = 0x9E3779B9;
     }
 
     inline float drift_noise(float &lastval)
     {
         constexpr float filter = 0.00001f;
         constexpr float m = 316.227766017f; // 1.f / sqrt(filter);
-        float rand11 = (((float)rand() / (float)RAND_MAX) * 2.f - 1.f);
+
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        float rand11 = (float)(rngState >> 8) * (2.f / 16777215.f) - 1.f;
 
         lastval = lastval * (1.f - filter) + rand11 * filter;
 
@@ -62,6 +76,7 @@ struct DriftLFO
     inline float val() const { return d; }
 
     float d, d2;
+    uint32_t rngState{0x9E3779B9};
 };
 
 /*
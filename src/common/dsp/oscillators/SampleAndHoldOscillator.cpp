@@ -85,7 +85,7 @@ void SampleAndHoldOscillator::init(float pitch, bool is_display, bool nonzero_in
     {
         std::uniform_real_distribution<float> distro(-1.f, 1.f);
 #ifdef STORAGE_USES_INDEPENDENT_RNG
-        urng = std::bind(distro, storage->rngGen.g);
+        urng = std::bind(distro, storage->activeRNG().g);
 #else
         std::minstd_rand gen(std::rand());
         urng = std::bind(distro, gen);
@@ -124,7 +124,7 @@ void SampleAndHoldOscillator::init(float pitch, bool is_display, bool nonzero_in
         state[i] = 0;
         last_level[i] = 0.0;
         pwidth[i] = limit_range(l_pw.v, 0.001, 0.999);
-        driftLFO[i].init(nonzero_init_drift);
+        driftLFO[i].init(nonzero_init_drift, storage);
     }
 
     hp.coeff_instantize();
@@ -121,7 +121,7 @@ void SineOscillator::init(float pitch, bool is_display, bool nonzero_init_drift)
         phase[i] = // phase in range -PI to PI
             (oscdata->retrigger.val.b || is_display) ? 0.f : 2.0 * M_PI * storage->rand_01() - M_PI;
         lastvalue[i] = 0.f;
-        driftLFO[i].init(nonzero_init_drift);
+        driftLFO[i].init(nonzero_init_drift, storage);
         sine[i].set_phase(phase[i]);
     }
 
@@ -666,6 +666,62 @@ void SineOscillator::process_block_internal(float pitch, float drift, float fmde
         }
     }
     firstblock = false;
+
+    /*
+     * With a single unison voice and no feedback each sample depends only on its own phase,
+     * so rather than using one lane of the unison loop below we can run four consecutive
+     * samples through the SSE shape at once. The phase is still accumulated in double a
+     * sample at a time, exactly as below, so the output is unchanged. The first unison
+     * voice never ramps in, so there is no play ramp to apply either.
+     */
+    if (n_unison == 1 && fb_val == 0 && FB.v == 0 && lastvalue[0] == 0)
+    {
+        auto pl = _mm_set1_ps(panL[0]);
+        auto pr = _mm_set1_ps(panR[0]);
+        const auto half = _mm_set1_ps(0.5f);
+
+        for (int k = 0; k < BLOCK_SIZE_OS; k += 4)
+        {
+            float fph alignas(16)[4], fmv alignas(16)[4];
+
+            for (int i = 0; i < 4; ++i)
+            {
+                fph[i] = (float)phase[0];
+                fmv[i] = FM ? FMdepth.v * master_osc[k + i] : 0.f;
+
+                phase[0] += omega[0];
+                phase[0] -= (phase[0] > M_PI) * 2.0 * M_PI;
+
+                FMdepth.process();
+                FB.process();
+            }
+
+            auto x = _mm_add_ps(_mm_load_ps(fph), _mm_load_ps(fmv));
+            x = sst::basic_blocks::dsp::clampToPiRangeSSE(x);
+
+            auto sxl = sst::basic_blocks::dsp::fastsinSSE(x);
+            auto cxl = sst::basic_blocks::dsp::fastcosSSE(x);
+
+            auto out_local = valueFromSinAndCosForMode<mode>(sxl, cxl, 4);
+
+            auto l = _mm_mul_ps(_mm_mul_ps(pl, out_local), outattensse);
+            auto r = _mm_mul_ps(_mm_mul_ps(pr, out_local), outattensse);
+
+            if (stereo)
+            {
+                _mm_storeu_ps(&output[k], l);
+                _mm_storeu_ps(&outputR[k], r);
+            }
+            else
+            {
+                _mm_storeu_ps(&output[k], _mm_mul_ps(_mm_add_ps(l, r), half));
+            }
+        }
+
+        applyFilter();
+        return;
+    }
+
     for (int k = 0; k < BLOCK_SIZE_OS; k++)
     {
         float outL = 0.f, outR = 0.f;
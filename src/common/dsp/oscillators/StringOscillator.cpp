@@ -120,10 +120,15 @@ void StringOscillator::init(float pitch, bool is_display, bool nzi)
     else
     {
         ownDelayLines = false;
-        if (!delayLine[0])
-            delayLine[0] = storage->memoryPools->stringDelayLines.getItem(storage->sinctable);
-        if (!delayLine[1])
-            delayLine[1] = storage->memoryPools->stringDelayLines.getItem(storage->sinctable);
+        for (int i = 0; i < 2; ++i)
+        {
+            if (!delayLine[i])
+            {
+                // the pool hands its lines out cleared
+                delayLine[i] = storage->memoryPools->stringDelayLines.getItem(storage->sinctable);
+                delayLineClear[i] = true;
+            }
+        }
     }
 
     memset((void *)dustBuffer, 0, 2 * (BLOCK_SIZE_OS) * sizeof(float));
@@ -185,8 +190,10 @@ void StringOscillator::init(float pitch, bool is_display, bool nzi)
 
     for (int i = 0; i < 2; ++i)
     {
-        delayLine[i]->clear();
-        driftLFO[i].init(nzi);
+        if (!delayLineClear[i])
+            delayLine[i]->clear();
+        delayLineClear[i] = false;
+        driftLFO[i].init(nzi, storage);
     }
 
     auto mode = (exciter_modes)oscdata->p[str_exciter_mode].val.i;
@@ -111,6 +111,7 @@ class StringOscillator : public Oscillator
 
     std::array<SSESincDelayLine<16384> *, 2> delayLine{nullptr, nullptr};
     bool ownDelayLines{false};
+    std::array<bool, 2> delayLineClear{false, false};
     float priorSample[2] = {0, 0};
     Surge::Oscillator::DriftLFO driftLFO[2];
     Surge::Oscillator::CharacterFilter<float> charFilt;
@@ -132,4 +133,6 @@ class StringOscillator : public Oscillator
 
   private:
     int id_exciterlvl, id_str1decay, id_str2decay, id_str2detune, id_strbalance, id_stiffness;
+    // for the audio in exciter modes
+    Surge::Storage::AudioInputClient audioInputClient{storage};
 };
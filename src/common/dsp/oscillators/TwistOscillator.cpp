@@ -22,6 +22,7 @@
 
 #include "TwistOscillator.h"
 #include "DebugHelpers.h"
+#include "SurgeMemoryPools.h"
 
 #define TEST
 #ifndef _MSC_VER
@@ -275,9 +276,7 @@ static struct EngineDynamicDeact : public ParameterDynamicDeactivationFunction
     }
 } etDynamicDeact;
 
-TwistOscillator::TwistOscillator(SurgeStorage *storage, OscillatorStorage *oscdata,
-                                 pdata *localcopy)
-    : Oscillator(storage, oscdata, localcopy), charFilt(storage)
+TwistEngineMemory::TwistEngineMemory(SurgeStorage *storage)
 {
 #if SAMPLERATE_LANCZOS
     lancRes = std::make_unique<sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>>(
@@ -293,20 +292,64 @@ TwistOscillator::TwistOscillator(SurgeStorage *storage, OscillatorStorage *oscda
     }
 #endif
     voice = std::make_unique<plaits::Voice>();
-    shared_buffer = new char[16384];
-    alloc = std::make_unique<stmlib::BufferAllocator>(shared_buffer, 16384);
+    shared_buffer = new char[bufferSize];
+    alloc = std::make_unique<stmlib::BufferAllocator>(shared_buffer, bufferSize);
     patch = std::make_unique<plaits::Patch>();
     mod = std::make_unique<plaits::Modulations>();
 
     // FM downsampling with a linear interpolator is absolutely fine
-    int error;
-    fmdownsamplestate = src_new(SRC_LINEAR, 1, &error);
-    if (error != 0)
+    int fmerror;
+    fmdownsamplestate = src_new(SRC_LINEAR, 1, &fmerror);
+    if (fmerror != 0)
     {
         fmdownsamplestate = nullptr;
     }
 }
 
+TwistEngineMemory::~TwistEngineMemory()
+{
+    if (shared_buffer)
+        delete[] shared_buffer;
+
+    if (srcstate)
+        srcstate = src_delete(srcstate);
+
+    if (fmdownsamplestate)
+        fmdownsamplestate = src_delete(fmdownsamplestate);
+}
+
+void TwistEngineMemory::restart(SurgeStorage *storage)
+{
+    // the engines carve their state out of the buffer again in Voice::Init
+    alloc->Init(shared_buffer, bufferSize);
+
+#if SAMPLERATE_LANCZOS
+    // rebuild in place, which also picks up a samplerate change since this was last used
+    using resampler_t = sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>;
+    lancRes->~resampler_t();
+    new (lancRes.get()) resampler_t(48000, storage->dsamplerate_os);
+#else
+    if (srcstate)
+        src_reset(srcstate);
+#endif
+
+    if (fmdownsamplestate)
+        src_reset(fmdownsamplestate);
+}
+
+void TwistEngineMemory::prepare(SurgeStorage *storage)
+{
+    restart(storage);
+    voice->Init(alloc.get());
+    preparedForSampleRate = storage->dsamplerate_os;
+}
+
+TwistOscillator::TwistOscillator(SurgeStorage *storage, OscillatorStorage *oscdata,
+                                 pdata *localcopy)
+    : Oscillator(storage, oscdata, localcopy), charFilt(storage)
+{
+}
+
 float TwistOscillator::tuningAwarePitch(float pitch)
 {
     if (storage->tuningApplicationMode == SurgeStorage::RETUNE_ALL &&
@@ -324,15 +367,27 @@ float TwistOscillator::tuningAwarePitch(float pitch)
 
 void TwistOscillator::init(float pitch, bool is_display, bool nonzero_drift)
 {
-    voice->Init(alloc.get());
+    // As with the string delay lines, the display builds its own rather than race the pool
+    if (!engine)
+    {
+        ownEngine = is_display;
+        if (ownEngine)
+            engine = new TwistEngineMemory(storage);
+        else
+            engine = storage->memoryPools->twistEngines.getItem(storage);
+    }
+
+    if (engine->preparedForSampleRate != storage->dsamplerate_os)
+        engine->prepare(storage);
+    engine->preparedForSampleRate = 0;
 
     charFilt.init(storage->getPatch().character.val.i);
 
     float tpitch = tuningAwarePitch(pitch);
-    memset((void *)patch.get(), 0, sizeof(plaits::Patch));
-    memset((void *)mod.get(), 0, sizeof(plaits::Modulations));
+    memset((void *)engine->patch.get(), 0, sizeof(plaits::Patch));
+    memset((void *)engine->mod.get(), 0, sizeof(plaits::Modulations));
 
-    driftLFO.init(nonzero_drift);
+    driftLFO.init(nonzero_drift, storage);
 
     // Lets run forward a cycle
     int throwaway = 0;
@@ -354,23 +409,33 @@ void TwistOscillator::init(float pitch, bool is_display, bool nonzero_drift)
 }
 TwistOscillator::~TwistOscillator()
 {
-    if (shared_buffer)
-        delete[] shared_buffer;
-
-    if (srcstate)
-        srcstate = src_delete(srcstate);
+    if (!engine)
+        return;
 
-    if (fmdownsamplestate)
-        fmdownsamplestate = src_delete(fmdownsamplestate);
+    if (ownEngine)
+        delete engine;
+    else
+        storage->memoryPools->twistEngines.returnItem(engine);
 }
 
 template <bool FM, bool throwaway>
 void TwistOscillator::process_block_internal(float pitch, float drift, bool stereo, float FMdepth,
                                              int throwawayBlocks)
 {
+    if (!engine)
+        return;
+
+    auto &voice = engine->voice;
+    auto &patch = engine->patch;
+    auto &mod = engine->mod;
+    auto fmdownsamplestate = engine->fmdownsamplestate;
+
 #if SAMPLERATE_SRC
+    auto srcstate = engine->srcstate;
     if (!srcstate)
         return;
+#else
+    auto &lancRes = engine->lancRes;
 #endif
 
     if (FM && !fmdownsamplestate)
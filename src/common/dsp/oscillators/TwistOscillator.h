@@ -20,6 +20,9 @@
  * https://github.com/surge-synthesizer/surge
  */
 
+#ifndef SURGE_SRC_COMMON_DSP_OSCILLATORS_TWISTOSCILLATOR_H
+#define SURGE_SRC_COMMON_DSP_OSCILLATORS_TWISTOSCILLATOR_H
+
 /*
  * What's our samplerate strategy
  */
@@ -52,6 +55,39 @@ class BufferAllocator;
 
 struct SRC_STATE_tag;
 
+/*
+ * Everything a single plaits voice needs: the voice with its engines, their scratch memory and
+ * the resamplers from the plaits rate to ours. Voices get these from the memory pools rather
+ * than building one every time a note starts on the audio thread; see SurgeMemoryPools.
+ * restart puts one back into the state a freshly constructed one would be in.
+ */
+struct TwistEngineMemory
+{
+    static constexpr int bufferSize = 16384;
+
+    explicit TwistEngineMemory(SurgeStorage *storage);
+    ~TwistEngineMemory();
+
+    void restart(SurgeStorage *storage);
+
+    // restart and init the plaits voice ahead of use; init skips that if the rate still matches
+    void prepare(SurgeStorage *storage);
+    double preparedForSampleRate{0};
+
+    std::unique_ptr<plaits::Voice> voice;
+    std::unique_ptr<plaits::Patch> patch;
+    std::unique_ptr<plaits::Modulations> mod;
+    std::unique_ptr<stmlib::BufferAllocator> alloc;
+    char *shared_buffer{nullptr};
+
+    // Keep this here for now even if using lanczos since I'm using SRC for FM still
+    SRC_STATE_tag *srcstate{nullptr}, *fmdownsamplestate{nullptr};
+
+#if SAMPLERATE_LANCZOS
+    std::unique_ptr<sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>> lancRes;
+#endif
+};
+
 class TwistOscillator : public Oscillator
 {
   public:
@@ -88,23 +124,15 @@ class TwistOscillator : public Oscillator
         return clamp01((localcopy[oscdata->p[ps].param_id_in_scene].f + 1) * 0.5f);
     }
 
-    std::unique_ptr<plaits::Voice> voice;
-    std::unique_ptr<plaits::Patch> patch;
-    std::unique_ptr<plaits::Modulations> mod;
-    std::unique_ptr<stmlib::BufferAllocator> alloc;
-    char *shared_buffer{nullptr};
+    // pooled unless we are a display oscillator, in which case we own it
+    TwistEngineMemory *engine{nullptr};
+    bool ownEngine{false};
 
-    // Keep this here for now even if using lanczos since I'm using SRC for FM still
-    SRC_STATE_tag *srcstate, *fmdownsamplestate;
     float fmlagbuffer[BLOCK_SIZE_OS << 1];
     int fmwp, fmrp;
 
     bool useCorrectLPGBlockSize{false}; // See #6760
 
-#if SAMPLERATE_LANCZOS
-    std::unique_ptr<sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>> lancRes;
-#endif
-
     float carryover[BLOCK_SIZE_OS][2];
     int carrover_size = 0;
 
@@ -113,3 +141,5 @@ class TwistOscillator : public Oscillator
     Surge::Oscillator::DriftLFO driftLFO;
     Surge::Oscillator::CharacterFilter<float> charFilt;
 };
+
+#endif // SURGE_SRC_COMMON_DSP_OSCILLATORS_TWISTOSCILLATOR_H
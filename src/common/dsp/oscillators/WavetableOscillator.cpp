@@ -119,8 +119,16 @@ void WavetableOscillator::init(float pitch, bool is_display, bool nonzero_init_d
         last_level[i] = 0.0;
         mipmap[i] = 0;
         mipmap_ofs[i] = 0;
-        driftLFO[i].init(nonzero_init_drift);
+        driftLFO[i].init(nonzero_init_drift, storage);
     }
+
+    levelCacheMipmap = -1;
+    levelCacheTableid = -1;
+    levelCacheNointerp = -1;
+    levelCacheLipol = 0.f;
+    levelCacheVSkew = 0.f;
+    levelCacheClip = 0.f;
+    levelCacheRevision = oscdata->wt.dataRevision;
 }
 
 void WavetableOscillator::init_ctrltypes()
@@ -166,15 +174,93 @@ float WavetableOscillator::distort_level(float x)
     return x;
 }
 
+// As in ClassicOscillator, the sub-voice detune is fixed for a block, so do the tuning lookups
+// once per block for every unison voice instead of once per impulse
+void WavetableOscillator::update_unison_periods()
+{
+    auto detuneAmount = oscdata->p[wt_unison_detune].get_extended(localcopy[id_detune].f);
+    bool absolute = oscdata->p[wt_unison_detune].absolute;
+
+    for (int voice = 0; voice < n_unison; ++voice)
+    {
+        double detune = drift * driftLFO[voice].val();
+        if (n_unison > 1)
+            detune += detuneAmount * (detune_bias * float(voice) + detune_offset);
+
+        float tempt;
+        if (absolute)
+        {
+            // See the comment in ClassicOscillator.cpp at the absolute treatment
+            tempt = storage->note_to_pitch_inv_ignoring_tuning(
+                detune * storage->note_to_pitch_inv_ignoring_tuning(pitch_t) * 16 / 0.9443);
+            if (tempt < 0.1)
+                tempt = 0.1;
+        }
+        else
+        {
+            tempt = storage->note_to_pitch_inv_tuningctr(detune);
+        }
+
+        period[voice] = tempt;
+    }
+}
+
+/*
+ * Each impulse reads one level from the morphed frame and runs it through the skew and
+ * saturation shaper. When the morph position, skew and saturation have all held still since
+ * the last block those levels are the same every period, so we render the period once for the
+ * mipmap the voices are playing and convolute just reads it back. Anything else (a moving
+ * morph, a voice on another mipmap, sample playback) takes the usual path, so the output is
+ * identical either way. We only fill once the key has survived a whole block so a modulated
+ * morph never pays for a fill it won't use.
+ */
+void WavetableOscillator::update_level_cache()
+{
+    float lipol = (1 - nointerp) * tableipol;
+    bool sameKey = tableid == levelCacheTableid && nointerp == levelCacheNointerp &&
+                   lipol == levelCacheLipol && l_vskew.v == levelCacheVSkew &&
+                   l_clip.v == levelCacheClip && oscdata->wt.dataRevision == levelCacheRevision;
+    bool holding = !(oscdata->wt.flags & wtf_is_sample) && tableid == last_tableid &&
+                   tableipol == last_tableipol;
+
+    if (!sameKey || !holding)
+    {
+        levelCacheMipmap = -1;
+        levelCacheTableid = tableid;
+        levelCacheNointerp = nointerp;
+        levelCacheLipol = lipol;
+        levelCacheVSkew = l_vskew.v;
+        levelCacheClip = l_clip.v;
+        levelCacheRevision = oscdata->wt.dataRevision;
+        return;
+    }
+
+    int mm = mipmap[0];
+
+    if (mm == levelCacheMipmap)
+        return;
+
+    int wtsize = oscdata->wt.size >> mm;
+
+    if (wtsize < 1 || wtsize > levelCacheSize)
+        return;
+
+    const float *a = oscdata->wt.TableF32WeakPointers[mm][tableid];
+    const float *b = oscdata->wt.TableF32WeakPointers[mm][tableid + 1 - nointerp];
+
+    if (!a || !b)
+        return;
+
+    for (int i = 0; i < wtsize; ++i)
+        levelCache[i] = distort_level((a[i] * (1.f - lipol)) + (b[i] * lipol));
+
+    levelCacheMipmap = mm;
+}
+
 void WavetableOscillator::convolute(int voice, bool FM, bool stereo)
 {
     float block_pos = oscstate[voice] * BLOCK_SIZE_OS_INV * pitchmult_inv;
 
-    double detune = drift * driftLFO[voice].val();
-    if (n_unison > 1)
-        detune += oscdata->p[wt_unison_detune].get_extended(localcopy[id_detune].f) *
-                  (detune_bias * float(voice) + detune_offset);
-
     const float p24 = (1 << 24);
     unsigned int ipos;
 
@@ -251,19 +337,7 @@ void WavetableOscillator::convolute(int voice, bool FM, bool stereo)
     float dt = (oscdata->wt.dt) * wt_inc;
 
     // add time until next statechange
-    float tempt;
-    if (oscdata->p[wt_unison_detune].absolute)
-    {
-        // See the comment in ClassicOscillator.cpp at the absolute treatment
-        tempt = storage->note_to_pitch_inv_ignoring_tuning(
-            detune * storage->note_to_pitch_inv_ignoring_tuning(pitch_t) * 16 / 0.9443);
-        if (tempt < 0.1)
-            tempt = 0.1;
-    }
-    else
-    {
-        tempt = storage->note_to_pitch_inv_tuningctr(detune);
-    }
+    float tempt = period[voice];
 
     float t;
     float xt = ((float)state[voice] + 0.5f) * dt;
@@ -300,10 +374,18 @@ void WavetableOscillator::convolute(int voice, bool FM, bool stereo)
 
     // that 1 - nointerp makes sure we don't read the table off memory, keeps us bounded
     // and since it gets multiplied by lipol, in morph mode ends up being zero - no sweat!
-    newlevel = distort_level(
-        (oscdata->wt.TableF32WeakPointers[mipmap[voice]][tableid][state[voice]] * (1.f - lipol)) +
-        (oscdata->wt.TableF32WeakPointers[mipmap[voice]][tableid + 1 - nointerp][state[voice]] *
-         lipol));
+    if (mipmap[voice] == levelCacheMipmap && lipol == levelCacheLipol)
+    {
+        newlevel = levelCache[state[voice]];
+    }
+    else
+    {
+        newlevel = distort_level(
+            (oscdata->wt.TableF32WeakPointers[mipmap[voice]][tableid][state[voice]] *
+             (1.f - lipol)) +
+            (oscdata->wt.TableF32WeakPointers[mipmap[voice]][tableid + 1 - nointerp][state[voice]] *
+             lipol));
+    }
 
     g = newlevel - last_level[voice];
     last_level[voice] = newlevel;
@@ -461,6 +543,8 @@ void WavetableOscillator::process_block(float pitch0, float drift, bool stereo,
         }
     }
 
+    update_level_cache();
+
     if (FM)
     {
         for (int l = 0; l < n_unison; l++)
@@ -468,6 +552,8 @@ void WavetableOscillator::process_block(float pitch0, float drift, bool stereo,
             driftLFO[l].next();
         }
 
+        update_unison_periods();
+
         for (int s = 0; s < BLOCK_SIZE_OS; s++)
         {
             float fmmul = limit_range(1.f + depth * master_osc[s], 0.1f, 1.9f);
@@ -490,8 +576,12 @@ void WavetableOscillator::process_block(float pitch0, float drift, bool stereo,
     {
         float a = (float)BLOCK_SIZE_OS * pitchmult;
         for (int l = 0; l < n_unison; l++)
-        {
             driftLFO[l].next();
+
+        update_unison_periods();
+
+        for (int l = 0; l < n_unison; l++)
+        {
             while (oscstate[l] < a)
                 convolute(l, false, stereo);
             oscstate[l] -= a;
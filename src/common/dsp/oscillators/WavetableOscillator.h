@@ -57,6 +57,9 @@ class WavetableOscillator : public AbstractBlitOscillator
   private:
     void convolute(int voice, bool FM, bool stereo);
     template <bool is_init> void update_lagvals();
+    void update_unison_periods();
+    void update_level_cache();
+    float period alignas(16)[MAX_UNISON]; // per sub-voice, see update_unison_periods
     inline float distort_level(float);
     bool first_run;
     float oscpitch[MAX_UNISON];
@@ -72,6 +75,14 @@ class WavetableOscillator : public AbstractBlitOscillator
     int nointerp;
     float FMmul_inv;
     int sampleloop;
+
+    // One period of distorted frame levels at the current mipmap, morph, skew and saturation,
+    // kept while those hold still. See update_level_cache.
+    static constexpr int levelCacheSize = 1024;
+    float levelCache alignas(16)[levelCacheSize];
+    int levelCacheMipmap, levelCacheTableid, levelCacheNointerp;
+    float levelCacheLipol, levelCacheVSkew, levelCacheClip;
+    uint32_t levelCacheRevision;
 };
 
 #endif // SURGE_SRC_COMMON_DSP_OSCILLATORS_WAVETABLEOSCILLATOR_H
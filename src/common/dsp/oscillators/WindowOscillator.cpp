@@ -22,6 +22,7 @@
 
 #include "WindowOscillator.h"
 #include "DSPUtils.h"
+#include "SIMDDotProducts.h"
 
 #include <cstdint>
 #include "DebugHelpers.h"
@@ -97,7 +98,7 @@ void WindowOscillator::init(float pitch, bool is_display, bool nonzero_init_drif
                 (storage->WindowWT.size + (storage->rand() & (storage->WindowWT.size - 1))) << 16;
         }
 
-        Window.driftLFO[0].init(nonzero_init_drift);
+        Window.driftLFO[0].init(nonzero_init_drift, storage);
     }
     else
     {
@@ -132,7 +133,8 @@ void WindowOscillator::init(float pitch, bool is_display, bool nonzero_init_drif
                     << 16;
             }
 
-            Window.driftLFO[i].init(true); // Window has always started uni voices with non zero
+            // Window has always started uni voices with non zero
+            Window.driftLFO[i].init(true, storage);
         }
     }
 
@@ -297,54 +299,27 @@ void WindowOscillator::ProcessWindowOscs(bool stereo, bool FM)
                 unsigned int MPos = FPos >> (16 + MipMapB);
                 unsigned int MSPos = ((FPos >> (8 + MipMapB)) & 0xFF);
 
-                __m128i Wave =
-                    _mm_madd_epi16(_mm_load_si128(((__m128i *)storage->sinctableI16 + MSPos)),
-                                   _mm_loadu_si128((__m128i *)&WaveAdr[MPos]));
-                __m128i WaveP1 =
-                    _mm_madd_epi16(_mm_load_si128(((__m128i *)storage->sinctableI16 + MSPos)),
-                                   _mm_loadu_si128((__m128i *)&WaveAdrP1[MPos]));
-
-                __m128i Win =
-                    _mm_madd_epi16(_mm_load_si128(((__m128i *)storage->sinctableI16 + WinSPos)),
-                                   _mm_loadu_si128((__m128i *)&WinAdr[WinPos]));
-
-                // Sum
-                int iWin alignas(16)[4], iWaveP1 alignas(16)[4], iWave alignas(16)[4];
-#if MAC
-                // this should be very fast on C2D/C1D (and there are no macs with K8's)
-                iWin[0] = _mm_cvtsi128_si32(Win);
-                iWin[1] = _mm_cvtsi128_si32(_mm_shuffle_epi32(Win, _MM_SHUFFLE(1, 1, 1, 1)));
-                iWin[2] = _mm_cvtsi128_si32(_mm_shuffle_epi32(Win, _MM_SHUFFLE(2, 2, 2, 2)));
-                iWin[3] = _mm_cvtsi128_si32(_mm_shuffle_epi32(Win, _MM_SHUFFLE(3, 3, 3, 3)));
-                iWave[0] = _mm_cvtsi128_si32(Wave);
-                iWave[1] = _mm_cvtsi128_si32(_mm_shuffle_epi32(Wave, _MM_SHUFFLE(1, 1, 1, 1)));
-                iWave[2] = _mm_cvtsi128_si32(_mm_shuffle_epi32(Wave, _MM_SHUFFLE(2, 2, 2, 2)));
-                iWave[3] = _mm_cvtsi128_si32(_mm_shuffle_epi32(Wave, _MM_SHUFFLE(3, 3, 3, 3)));
-                iWaveP1[0] = _mm_cvtsi128_si32(WaveP1);
-                iWaveP1[1] = _mm_cvtsi128_si32(_mm_shuffle_epi32(WaveP1, _MM_SHUFFLE(1, 1, 1, 1)));
-                iWaveP1[2] = _mm_cvtsi128_si32(_mm_shuffle_epi32(WaveP1, _MM_SHUFFLE(2, 2, 2, 2)));
-                iWaveP1[3] = _mm_cvtsi128_si32(_mm_shuffle_epi32(WaveP1, _MM_SHUFFLE(3, 3, 3, 3)));
+                auto *sinc = storage->sinctableI16;
+                int iWave = Surge::DSP::dotI16x8(sinc + (MSPos << 3), &WaveAdr[MPos]) >> 13;
+                int iWin = Surge::DSP::dotI16x8(sinc + (WinSPos << 3), &WinAdr[WinPos]) >> 13;
 
-#else
-                _mm_store_si128((__m128i *)&iWin, Win);
-                _mm_store_si128((__m128i *)&iWave, Wave);
-                _mm_store_si128((__m128i *)&iWaveP1, WaveP1);
-#endif
-
-                iWin[0] = (iWin[0] + iWin[1] + iWin[2] + iWin[3]) >> 13;
-                iWave[0] = (iWave[0] + iWave[1] + iWave[2] + iWave[3]) >> 13;
-                iWaveP1[0] = (iWaveP1[0] + iWaveP1[1] + iWaveP1[2] + iWaveP1[3]) >> 13;
-
-                iWave[0] = (int)((1.f - FTable) * iWave[0] + FTable * iWaveP1[0]);
+                // with no morph between tables the blend gives back iWave exactly, so the
+                // second table's lookup can be skipped altogether
+                if (FTable != 0.f)
+                {
+                    int iWaveP1 =
+                        Surge::DSP::dotI16x8(sinc + (MSPos << 3), &WaveAdrP1[MPos]) >> 13;
+                    iWave = (int)((1.f - FTable) * iWave + FTable * iWaveP1);
+                }
 
                 if (stereo)
                 {
-                    int Out = (iWin[0] * iWave[0]) >> 7;
+                    int Out = (iWin * iWave) >> 7;
                     IOutputL[i] += (Out * (int)Window.Gain[so][0]) >> 6;
                     IOutputR[i] += (Out * (int)Window.Gain[so][1]) >> 6;
                 }
                 else
-                    IOutputL[i] += (iWin[0] * iWave[0]) >> 6;
+                    IOutputL[i] += (iWin * iWave) >> 6;
             }
 
             Window.Pos[so] = Pos;
@@ -399,11 +374,10 @@ void WindowOscillator::process_block(float pitch, float drift, bool stereo, bool
         {
             FMdepth[l].newValue(fmstrength);
 
+            // the pitch is the one worked out above; only the modulation changes per sample
             for (int i = 0; i < BLOCK_SIZE_OS; ++i)
             {
                 float fmadj = (1.0 + FMdepth[l].v * master_osc[i]);
-                float f = storage->note_to_pitch(pitch + drift * Window.driftLFO[l].val() +
-                                                 Detune * (DetuneOffset + DetuneBias * (float)l));
                 int Ratio =
                     Float2Int(8.175798915f * 32768.f * f * fmadj * (float)(storage->WindowWT.size) *
                               storage->samplerate_inv); // (65536.f*0.5f), 0.5 for oversampling
@@ -0,0 +1,361 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "PartitionedConvolver.h"
+
+#include <cstring>
+
+#include "pffft.h"
+
+namespace Surge
+{
+namespace DSP
+{
+void PartitionedConvolver::AlignedFree::operator()(float *p) const { pffft_aligned_free(p); }
+
+PartitionedConvolver::AlignedFloats PartitionedConvolver::makeAligned(size_t n)
+{
+    auto res = AlignedFloats((float *)pffft_aligned_malloc(n * sizeof(float)));
+    memset(res.get(), 0, n * sizeof(float));
+    return res;
+}
+
+PartitionedConvolver::Stage::Stage(int partition, int offset, int nParts)
+    : partition(partition), fftSize(2 * partition), offset(offset), nParts(nParts)
+{
+    setup = pffft_new_setup(fftSize, PFFFT_REAL);
+
+    for (int c = 0; c < 2; ++c)
+    {
+        spectra[c] = makeAligned(nParts * fftSize);
+        fdl[c] = makeAligned(nParts * fftSize);
+        history[c] = makeAligned(fftSize);
+        accum[c] = makeAligned(fftSize);
+    }
+
+    work = makeAligned(fftSize);
+    scratch = makeAligned(fftSize);
+
+    // the head runs straight from the audio thread, so it needs none of the job buffers
+    if (offset > 0)
+    {
+        for (int c = 0; c < 2; ++c)
+        {
+            collect[c] = makeAligned(partition);
+            jobIn[c] = makeAligned(partition);
+            jobOut[c] = makeAligned(partition);
+            playout[c] = makeAligned(partition);
+        }
+
+        totalJobCost = 4 * transformCost + 2 * nParts;
+    }
+}
+
+PartitionedConvolver::Stage::~Stage()
+{
+    if (setup)
+        pffft_destroy_setup(setup);
+}
+
+void PartitionedConvolver::Stage::convolve(int channel, const float *in, float *out)
+{
+    auto h = history[channel].get();
+
+    // overlap-save, so the transform always sees the previous partition ahead of this one
+    memmove(h, h + partition, partition * sizeof(float));
+    memcpy(h + partition, in, partition * sizeof(float));
+
+    auto line = fdl[channel].get();
+    pffft_transform(setup, h, line + fdlPos * fftSize, work.get(), PFFFT_FORWARD);
+
+    auto acc = accum[channel].get();
+    memset(acc, 0, fftSize * sizeof(float));
+
+    const float scale = 1.f / fftSize;
+
+    for (int k = 0; k < nParts; ++k)
+    {
+        auto idx = fdlPos - k;
+
+        if (idx < 0)
+            idx += nParts;
+
+        pffft_zconvolve_accumulate(setup, line + idx * fftSize,
+                                   spectra[channel].get() + k * fftSize, acc, scale);
+    }
+
+    pffft_transform(setup, acc, scratch.get(), work.get(), PFFFT_BACKWARD);
+    memcpy(out, scratch.get() + partition, partition * sizeof(float));
+}
+
+void PartitionedConvolver::Stage::advanceJob(int blocksDone, int blocksPerPartition)
+{
+    auto target = totalJobCost * blocksDone / blocksPerPartition;
+    auto nProducts = 2 * nParts;
+
+    while (jobCost < target)
+    {
+        runJobStep(jobStep);
+
+        auto isTransform = jobStep < 2 || jobStep >= 2 + nProducts;
+        jobCost += isTransform ? transformCost : 1;
+        jobStep++;
+    }
+}
+
+void PartitionedConvolver::Stage::runJobStep(int step)
+{
+    auto nProducts = 2 * nParts;
+
+    if (step < 2)
+    {
+        // the same as the start of convolve, for one channel of the partition we just collected
+        auto c = step;
+        auto h = history[c].get();
+
+        memmove(h, h + partition, partition * sizeof(float));
+        memcpy(h + partition, jobIn[c].get(), partition * sizeof(float));
+
+        pffft_transform(setup, h, fdl[c].get() + fdlPos * fftSize, work.get(), PFFFT_FORWARD);
+        memset(accum[c].get(), 0, fftSize * sizeof(float));
+    }
+    else if (step < 2 + nProducts)
+    {
+        auto c = (step - 2) & 1;
+        auto k = (step - 2) >> 1;
+        auto idx = fdlPos - k;
+
+        if (idx < 0)
+            idx += nParts;
+
+        pffft_zconvolve_accumulate(setup, fdl[c].get() + idx * fftSize,
+                                   spectra[c].get() + k * fftSize, accum[c].get(),
+                                   1.f / fftSize);
+    }
+    else
+    {
+        auto c = step - 2 - nProducts;
+
+        pffft_transform(setup, accum[c].get(), scratch.get(), work.get(), PFFFT_BACKWARD);
+        memcpy(jobOut[c].get(), scratch.get() + partition, partition * sizeof(float));
+
+        if (c == 1)
+            fdlPos = (fdlPos + 1) % nParts;
+    }
+}
+
+void PartitionedConvolver::Stage::clear()
+{
+    for (int c = 0; c < 2; ++c)
+    {
+        memset(fdl[c].get(), 0, nParts * fftSize * sizeof(float));
+        memset(history[c].get(), 0, fftSize * sizeof(float));
+
+        for (auto *b : {&collect[c], &jobIn[c], &jobOut[c], &playout[c]})
+        {
+            if (*b)
+                memset(b->get(), 0, partition * sizeof(float));
+        }
+    }
+
+    fdlPos = 0;
+    collected = 0;
+    jobStep = 0;
+    jobCost = 0;
+}
+
+PartitionedConvolver::PartitionedConvolver() = default;
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    freeRetiredResponses();
+
+    delete active;
+    delete pending.exchange(nullptr);
+}
+
+void PartitionedConvolver::freeRetiredResponses()
+{
+    auto k = retired.exchange(nullptr, std::memory_order_acq_rel);
+
+    while (k)
+    {
+        auto next = k->nextRetired;
+        delete k;
+        k = next;
+    }
+}
+
+void PartitionedConvolver::setImpulseResponse(const std::vector<float> &left,
+                                              const std::vector<float> &right)
+{
+    freeRetiredResponses();
+
+    auto k = new Kernel();
+    auto &r = right.empty() ? left : right;
+    auto len = (int)std::max(left.size(), r.size());
+
+    k->length = len;
+
+    auto addStage = [&](int partition, int offset, int end) {
+        end = std::min(end, len);
+
+        auto nParts = (end - offset + partition - 1) / partition;
+        auto st = std::make_unique<Stage>(partition, offset, nParts);
+        auto tmp = makeAligned(st->fftSize);
+
+        for (int c = 0; c < 2; ++c)
+        {
+            auto &ir = (c == 0) ? left : r;
+
+            for (int p = 0; p < nParts; ++p)
+            {
+                memset(tmp.get(), 0, st->fftSize * sizeof(float));
+
+                for (int i = 0; i < partition; ++i)
+                {
+                    auto src = offset + p * partition + i;
+
+                    if (src < end && src < (int)ir.size())
+                        tmp[i] = ir[src];
+                }
+
+                pffft_transform(st->setup, tmp.get(), st->spectra[c].get() + p * st->fftSize,
+                                st->work.get(), PFFFT_FORWARD);
+            }
+        }
+
+        k->stages.push_back(std::move(st));
+    };
+
+    if (len > 0)
+    {
+        auto partition = firstTailPartition;
+        auto offset = 2 * partition;
+
+        addStage(headPartition, 0, offset);
+
+        for (int s = 0; s < maxTailStages && offset < len; ++s)
+        {
+            // each stage ends where the next one, with longer partitions, can take over
+            auto end = (s == maxTailStages - 1) ? len : 2 * partition * tailPartitionGrowth;
+
+            addStage(partition, offset, end);
+
+            offset = end;
+            partition *= tailPartitionGrowth;
+        }
+    }
+
+    // a response the audio thread never got round to is still ours to free
+    delete pending.exchange(k);
+}
+
+void PartitionedConvolver::swapInPendingKernel()
+{
+    if (!pending.load(std::memory_order_acquire))
+        return;
+
+    auto k = pending.exchange(nullptr, std::memory_order_acq_rel);
+
+    if (!k)
+        return;
+
+    // a lock free push, so setting a new response never has to wait for the last to be freed
+    if (active)
+    {
+        auto head = retired.load(std::memory_order_relaxed);
+
+        do
+        {
+            active->nextRetired = head;
+        } while (!retired.compare_exchange_weak(head, active, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
+    }
+
+    active = k;
+    activeLength = k->length;
+}
+
+void PartitionedConvolver::process(const float *inL, const float *inR, float *outL, float *outR)
+{
+    swapInPendingKernel();
+
+    if (!active || active->stages.empty())
+    {
+        memset(outL, 0, BLOCK_SIZE * sizeof(float));
+        memset(outR, 0, BLOCK_SIZE * sizeof(float));
+        return;
+    }
+
+    auto &head = *active->stages[0];
+
+    head.convolve(0, inL, outL);
+    head.convolve(1, inR, outR);
+    head.fdlPos = (head.fdlPos + 1) % head.nParts;
+
+    for (int s = 1; s < (int)active->stages.size(); ++s)
+    {
+        auto &st = *active->stages[s];
+        const float *in[2] = {inL, inR};
+        float *out[2] = {outL, outR};
+
+        for (int c = 0; c < 2; ++c)
+        {
+            auto play = st.playout[c].get() + st.collected;
+
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+                out[c][i] += play[i];
+
+            memcpy(st.collect[c].get() + st.collected, in[c], BLOCK_SIZE * sizeof(float));
+        }
+
+        st.collected += BLOCK_SIZE;
+        st.advanceJob(st.collected / BLOCK_SIZE, st.partition / BLOCK_SIZE);
+
+        if (st.collected < st.partition)
+            continue;
+
+        // the last block finished the previous partition's job, which plays through the next
+        for (int c = 0; c < 2; ++c)
+        {
+            std::swap(st.playout[c], st.jobOut[c]);
+            std::swap(st.collect[c], st.jobIn[c]);
+        }
+
+        st.collected = 0;
+        st.jobStep = 0;
+        st.jobCost = 0;
+    }
+}
+
+void PartitionedConvolver::reset()
+{
+    if (!active)
+        return;
+
+    for (auto &st : active->stages)
+        st->clear();
+}
+
+} // namespace DSP
+} // namespace Surge
@@ -0,0 +1,145 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_DSP_UTILITIES_PARTITIONEDCONVOLVER_H
+#define SURGE_SRC_COMMON_DSP_UTILITIES_PARTITIONEDCONVOLVER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "globals.h"
+
+struct PFFFT_Setup;
+
+namespace Surge
+{
+namespace DSP
+{
+/*
+ * A stereo, zero latency FFT convolver for long impulse responses.
+ *
+ * The response is split non-uniformly. The head is cut into BLOCK_SIZE partitions which are
+ * convolved on the audio thread every block, so the output has no latency. Each later stage
+ * uses partitions eight times longer than the last and starts at twice its own partition
+ * length into the response, which leaves a whole partition of time between collecting a
+ * stage's input and needing its output. The audio thread spends that time working through
+ * the stage's transforms and spectral products a slice per block, so each block costs about
+ * the same and there is no thread to wait for.
+ *
+ * Every stage is uniformly partitioned overlap-save on pffft, with a frequency domain delay
+ * line of input spectra.
+ *
+ * setImpulseResponse builds everything off the audio thread and process() picks the new
+ * response up at the start of its next block. Nothing in process() allocates, locks or waits.
+ */
+struct PartitionedConvolver
+{
+    PartitionedConvolver();
+    ~PartitionedConvolver();
+
+    /*
+     * Any one thread but the audio thread. If right is empty, left is used on both channels.
+     */
+    void setImpulseResponse(const std::vector<float> &left, const std::vector<float> &right);
+
+    /*
+     * The audio thread can't free the response it swaps out, so it leaves it for whichever
+     * thread calls setImpulseResponse to free here, once hasRetiredResponses says there is one.
+     */
+    bool hasRetiredResponses() const { return retired.load(std::memory_order_acquire); }
+    void freeRetiredResponses();
+
+    // Audio thread. Convolves one block; the output replaces whatever is in outL and outR.
+    void process(const float *inL, const float *inR, float *outL, float *outR);
+
+    // Audio thread. Forget all input history, so the tail stops immediately.
+    void reset();
+
+    // The length of the response in use, or 0 if there is none yet
+    int impulseResponseLength() const { return activeLength; }
+
+    static constexpr int headPartition = BLOCK_SIZE;
+    static constexpr int firstTailPartition = 512;
+    static constexpr int tailPartitionGrowth = 8;
+    static constexpr int maxTailStages = 2;
+
+    static_assert(BLOCK_SIZE >= 16 && firstTailPartition % BLOCK_SIZE == 0,
+                  "pffft needs transforms of at least 32 points and the tails whole blocks");
+
+  private:
+    struct AlignedFree
+    {
+        void operator()(float *p) const;
+    };
+    using AlignedFloats = std::unique_ptr<float[], AlignedFree>;
+    static AlignedFloats makeAligned(size_t n);
+
+    // roughly what one transform costs next to one spectral product of the same size
+    static constexpr int transformCost = 4;
+
+    struct Stage
+    {
+        Stage(int partition, int offset, int nParts);
+        ~Stage();
+
+        int partition, fftSize, offset, nParts;
+        PFFFT_Setup *setup{nullptr};
+
+        AlignedFloats spectra[2], fdl[2], history[2];
+        AlignedFloats accum[2], work, scratch;
+        int fdlPos{0};
+
+        void convolve(int channel, const float *in, float *out);
+
+        /*
+         * These are only used by the tail stages. The job is the previous partition of input,
+         * convolved as a sequence of steps: both forward transforms, every spectral product
+         * and both inverse transforms. advanceJob runs as many as are due by the given point
+         * in the partition, and the last block of the partition finishes it.
+         */
+        AlignedFloats collect[2], jobIn[2], jobOut[2], playout[2];
+        int collected{0};
+        int jobStep{0}, jobCost{0}, totalJobCost{0};
+
+        void advanceJob(int blocksDone, int blocksPerPartition);
+        void runJobStep(int step);
+        void clear();
+    };
+
+    struct Kernel
+    {
+        int length{0};
+        std::vector<std::unique_ptr<Stage>> stages;
+        Kernel *nextRetired{nullptr};
+    };
+
+    void swapInPendingKernel();
+
+    Kernel *active{nullptr};
+    std::atomic<Kernel *> pending{nullptr}, retired{nullptr};
+    int activeLength{0};
+};
+} // namespace DSP
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_DSP_UTILITIES_PARTITIONEDCONVOLVER_H
@@ -0,0 +1,173 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "PolyphaseResampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace Surge
+{
+namespace DSP
+{
+// zeroth order modified Bessel function of the first kind, for the Kaiser window
+static double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+
+    for (int k = 1; k < 32; ++k)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+
+    return sum;
+}
+
+bool PolyphaseResampler::setRates(int inRate, int outRate)
+{
+    L = 0;
+    M = 0;
+    taps = 0;
+    kernel.clear();
+
+    if (inRate <= 0 || outRate <= 0)
+        return false;
+
+    auto g = std::gcd(inRate, outRate);
+    auto up = outRate / g, down = inRate / g;
+
+    if (up > maxPhases)
+        return false;
+
+    L = up;
+    M = down;
+    taps = baseTaps * std::max(1, (M + L - 1) / L);
+
+    for (auto &h : history)
+        h.assign(2 * taps, 0.f);
+
+    if (!isBypass())
+    {
+        static constexpr double beta = 8.0;
+
+        // at the upsampled rate, with a little guard band below the lower of the two nyquists
+        auto N = L * taps;
+        auto fc = 0.45 / std::max(L, M);
+        auto centre = (N - 1) * 0.5;
+        auto norm = besselI0(beta);
+
+        std::vector<double> h(N);
+        double sum = 0;
+
+        for (int i = 0; i < N; ++i)
+        {
+            auto x = i - centre;
+            auto sinc = (x == 0) ? 1.0 : std::sin(2.0 * M_PI * fc * x) / (2.0 * M_PI * fc * x);
+            auto r = x / centre;
+            auto w = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+
+            h[i] = sinc * w;
+            sum += h[i];
+        }
+
+        // every phase then has a DC gain of about one
+        kernel.resize(N);
+
+        for (int p = 0; p < L; ++p)
+        {
+            for (int j = 0; j < taps; ++j)
+                kernel[p * taps + taps - 1 - j] = (float)(h[p + j * L] * L / sum);
+        }
+    }
+
+    reset();
+
+    return true;
+}
+
+void PolyphaseResampler::reset()
+{
+    for (auto &h : history)
+        std::fill(h.begin(), h.end(), 0.f);
+
+    phase = 0;
+    histPos = 0;
+}
+
+int PolyphaseResampler::process(const float *in, int nIn, float *out, int maxOut)
+{
+    if (!isValid())
+        return 0;
+
+    if (isBypass())
+    {
+        auto n = std::min(nIn, maxOut);
+        memcpy(out, in, n * 2 * sizeof(float));
+        return n;
+    }
+
+    int nOut = 0;
+
+    for (int i = 0; i < nIn; ++i)
+    {
+        for (int c = 0; c < 2; ++c)
+        {
+            history[c][histPos] = in[2 * i + c];
+            history[c][histPos + taps] = in[2 * i + c];
+        }
+
+        histPos = (histPos + 1) % taps;
+
+        // every output whose upsampled position falls between this input and the next
+        while (phase < L)
+        {
+            if (nOut < maxOut)
+            {
+                auto k = &kernel[phase * taps];
+                auto hL = &history[0][histPos], hR = &history[1][histPos];
+                float yL = 0.f, yR = 0.f;
+
+                for (int j = 0; j < taps; ++j)
+                {
+                    yL += k[j] * hL[j];
+                    yR += k[j] * hR[j];
+                }
+
+                out[2 * nOut] = yL;
+                out[2 * nOut + 1] = yR;
+                nOut++;
+            }
+
+            phase += M;
+        }
+
+        phase -= L;
+    }
+
+    return nOut;
+}
+
+} // namespace DSP
+} // namespace Surge
@@ -0,0 +1,83 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_DSP_UTILITIES_POLYPHASERESAMPLER_H
+#define SURGE_SRC_COMMON_DSP_UTILITIES_POLYPHASERESAMPLER_H
+
+#include <vector>
+
+namespace Surge
+{
+namespace DSP
+{
+/*
+ * A fixed ratio stereo resampler between two integer sample rates.
+ *
+ * The ratio is reduced to L/M and the signal is conceptually upsampled by L, lowpassed and
+ * decimated by M. The lowpass is a Kaiser windowed sinc, precomputed once per rate pair and
+ * split into L phases, so each output frame costs one short dot product per channel and
+ * nothing else. Each phase has baseTaps taps, times the decimation ratio when going down, so
+ * the latency stays around baseTaps / 2 frames at the lower rate; a little over half a
+ * millisecond at 32k.
+ *
+ * Equal rates are a straight copy.
+ */
+struct PolyphaseResampler
+{
+    /*
+     * Off the audio thread, since this builds the kernel. Returns false, and leaves the
+     * resampler unusable, if the reduced ratio needs more phases than maxPhases; the common
+     * host rates against 32k are all well inside that.
+     */
+    bool setRates(int inRate, int outRate);
+
+    bool isValid() const { return L > 0; }
+    bool isBypass() const { return L == 1 && M == 1; }
+
+    void reset();
+
+    /*
+     * Process nIn interleaved stereo input frames, writing at most maxOut interleaved stereo
+     * frames. Returns the number of frames written. maxOut should be at least
+     * nIn * L / M + 1, or output is dropped.
+     */
+    int process(const float *in, int nIn, float *out, int maxOut);
+
+    static constexpr int baseTaps = 32;
+    static constexpr int maxPhases = 1024;
+
+  private:
+    int L{0}, M{0};
+    int taps{0};
+    int phase{0};
+    int histPos{0};
+
+    // one phase after another, each reversed so it lines up with the history window
+    std::vector<float> kernel;
+
+    // each channel's history is written twice so the last taps frames are contiguous
+    std::vector<float> history[2];
+};
+} // namespace DSP
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_DSP_UTILITIES_POLYPHASERESAMPLER_H
@@ -0,0 +1,148 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_DSP_UTILITIES_SIMDDOTPRODUCTS_H
+#define SURGE_SRC_COMMON_DSP_UTILITIES_SIMDDOTPRODUCTS_H
+
+#include "globals.h"
+#include <cstdint>
+
+/*
+ * On 64 bit ARM every SSE intrinsic goes through simde, which is mostly a one to one mapping
+ * but not for the horizontal idioms: a madd_epi16 becomes a widen, multiply and pairwise add,
+ * and the shuffle/movehl reductions become lane shuffles NEON has no use for. The handful of
+ * dot products and horizontal sums in the oscillator and wavetable inner loops are written
+ * natively here instead; everything else keeps going through simde.
+ *
+ * The portable versions are the original SSE code and are always compiled, so the tests and
+ * the --simd-kernels benchmark can hold the native ones against them on the same machine.
+ * Integer results are exact on both paths; the float sums add lanes in the same order.
+ */
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define SURGE_NATIVE_NEON_KERNELS 1
+#include <arm_neon.h>
+#endif
+
+namespace Surge
+{
+namespace DSP
+{
+namespace Portable
+{
+// sum of a[i] * b[i] for 8 shorts, neither pointer needs to be aligned
+inline int32_t dotI16x8(const short *a, const short *b)
+{
+    auto m = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)a),
+                            _mm_loadu_si128((const __m128i *)b));
+    m = _mm_add_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_add_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(m);
+}
+
+// as above for n shorts, n a multiple of 8
+inline int32_t dotI16(const short *a, const short *b, int n)
+{
+    auto acc = _mm_setzero_si128();
+    for (int i = 0; i < n; i += 8)
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(a + i)),
+                                                _mm_loadu_si128((const __m128i *)(b + i))));
+
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+}
+
+// (x0 + x2) + (x1 + x3)
+inline float hsumF32(__m128 x)
+{
+    auto a = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    a = _mm_add_ss(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(a);
+}
+
+// sum of a[i] * b[i] for n floats, n a multiple of 4, accumulated per lane then hsumF32'd
+inline float dotF32(const float *a, const float *b, int n)
+{
+    auto acc = _mm_setzero_ps();
+    for (int i = 0; i < n; i += 4)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+
+    return hsumF32(acc);
+}
+} // namespace Portable
+
+#if SURGE_NATIVE_NEON_KERNELS
+namespace Native
+{
+inline int32_t dotI16x8(const short *a, const short *b)
+{
+    auto va = vld1q_s16(a), vb = vld1q_s16(b);
+    auto m = vmull_s16(vget_low_s16(va), vget_low_s16(vb));
+    m = vmlal_high_s16(m, va, vb);
+    return vaddvq_s32(m);
+}
+
+inline int32_t dotI16(const short *a, const short *b, int n)
+{
+    auto acc0 = vdupq_n_s32(0), acc1 = vdupq_n_s32(0);
+    for (int i = 0; i < n; i += 8)
+    {
+        auto va = vld1q_s16(a + i), vb = vld1q_s16(b + i);
+        acc0 = vmlal_s16(acc0, vget_low_s16(va), vget_low_s16(vb));
+        acc1 = vmlal_high_s16(acc1, va, vb);
+    }
+    return vaddvq_s32(vaddq_s32(acc0, acc1));
+}
+
+inline float hsumF32x4(float32x4_t x)
+{
+    auto p = vadd_f32(vget_low_f32(x), vget_high_f32(x));
+    return vget_lane_f32(p, 0) + vget_lane_f32(p, 1);
+}
+
+inline float hsumF32(__m128 x) { return hsumF32x4(simde__m128_to_neon_f32(x)); }
+
+inline float dotF32(const float *a, const float *b, int n)
+{
+    auto acc = vdupq_n_f32(0.f);
+    // mul then add rather than vmlaq/vfmaq, so the lanes round exactly as the SSE path does
+    for (int i = 0; i < n; i += 4)
+        acc = vaddq_f32(acc, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+
+    return hsumF32x4(acc);
+}
+} // namespace Native
+
+using Native::dotF32;
+using Native::dotI16;
+using Native::dotI16x8;
+using Native::hsumF32;
+#else
+using Portable::dotF32;
+using Portable::dotI16;
+using Portable::dotI16x8;
+using Portable::hsumF32;
+#endif
+} // namespace DSP
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_DSP_UTILITIES_SIMDDOTPRODUCTS_H
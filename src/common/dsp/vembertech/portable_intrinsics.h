@@ -26,6 +26,8 @@
 #include <immintrin.h>
 #endif
 
+#include "SIMDDotProducts.h"
+
 #define vFloat __m128
 
 #define vZero _mm_setzero_ps()
@@ -51,14 +53,6 @@ inline vFloat vLoad1(float f) { return _mm_load1_ps(&f); }
 
 inline vFloat vSqrtFast(vFloat v) { return _mm_rcp_ps(_mm_rsqrt_ps(v)); }
 
-inline float vSum(vFloat x)
-{
-    __m128 a = _mm_add_ps(x, _mm_movehl_ps(x, x));
-    a = _mm_add_ss(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 1)));
-    float f;
-    _mm_store_ss(&f, a);
-
-    return f;
-}
+inline float vSum(vFloat x) { return Surge::DSP::hsumF32(x); }
 
 #endif // SURGE_SRC_COMMON_DSP_VEMBERTECH_PORTABLE_INTRINSICS_H
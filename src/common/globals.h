@@ -84,6 +84,10 @@ const int BASE_WINDOW_SIZE_X = 913;
 const int BASE_WINDOW_SIZE_Y = 569;
 const int NAMECHARS = 64;
 const int BLOCK_SIZE = SURGE_COMPILE_BLOCK_SIZE;
+// the quad and 8-sample block operations, and the sample position masks in the plugin wrappers,
+// all depend on this
+static_assert(BLOCK_SIZE >= 8 && BLOCK_SIZE <= 128 && (BLOCK_SIZE & (BLOCK_SIZE - 1)) == 0,
+              "SURGE_COMPILE_BLOCK_SIZE must be a power of two between 8 and 128");
 const int OSC_OVERSAMPLING = 2;
 const int BLOCK_SIZE_OS = OSC_OVERSAMPLING * BLOCK_SIZE;
 const int BLOCK_SIZE_QUAD = BLOCK_SIZE >> 2;
@@ -94,7 +98,18 @@ const float BLOCK_SIZE_INV = (1.f / BLOCK_SIZE);
 const float BLOCK_SIZE_OS_INV = (1.f / BLOCK_SIZE_OS);
 const int MAX_FB_COMB = 2048;               // must be 2^n
 const int MAX_FB_COMB_EXTENDED = 2048 * 64; // Only exposed in Combulator
-const int MAX_VOICES = 64;
+
+/*
+ * MAX_VOICES is the most voices per scene any engine can be configured for; each engine
+ * allocates SurgeStorage::voiceCapacity of them. Raising it widens the fixed size voice
+ * lists and masks, so keep it to what you ship.
+ */
+#ifndef SURGE_COMPILE_MAX_VOICES
+#define SURGE_COMPILE_MAX_VOICES 64
+#endif
+const int MAX_VOICES = SURGE_COMPILE_MAX_VOICES;
+static_assert(MAX_VOICES >= 8 && MAX_VOICES <= 256 && (MAX_VOICES & (MAX_VOICES - 1)) == 0,
+              "SURGE_COMPILE_MAX_VOICES must be a power of two from 8 to 256");
 const int MAX_UNISON = 16;
 const int N_OUTPUTS = 2;
 const int N_INPUTS = 2;
@@ -103,4 +118,5 @@ const int DEFAULT_POLYLIMIT = 16;
 
 const int DEFAULT_OSC_PORT_IN = 53280;
 const int DEFAULT_OSC_PORT_OUT = 53281;
+const int DEFAULT_OSC_OUTPUT_INTERVAL_MS = 20;
 #endif // SURGE_SRC_COMMON_GLOBALS_H
@@ -0,0 +1,844 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#include "Benchmarks.h"
+#include "HeadlessUtils.h"
+#include "Player.h"
+#include "ClassicOscillator.h"
+#include "Oscillator.h"
+#include "version.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace Surge
+{
+namespace Benchmarks
+{
+namespace
+{
+using benchClock = std::chrono::steady_clock;
+volatile float benchmarkSink{0};
+
+double nsSince(const benchClock::time_point &t0)
+{
+    return std::chrono::duration<double, std::nano>(benchClock::now() - t0).count();
+}
+
+std::string slug(const std::string &s)
+{
+    std::string res;
+    for (auto c : s)
+    {
+        if (std::isalnum((unsigned char)c))
+            res += (char)std::tolower((unsigned char)c);
+        else if (!res.empty() && res.back() != '-')
+            res += '-';
+    }
+    while (!res.empty() && res.back() == '-')
+        res.pop_back();
+    return res;
+}
+
+// a filter like fx-reverb or osc-classic narrows a sweep to the matching entries
+bool narrowedOut(const Options &opt, const std::string &suite, const std::string &name)
+{
+    return opt.filter.rfind(suite + "-", 0) == 0 && name.find(opt.filter) == std::string::npos;
+}
+
+std::string rateTag(float sr)
+{
+    std::ostringstream oss;
+    oss << sr / 1000 << "k";
+    return oss.str();
+}
+
+Result summarize(const std::string &name, const std::string &kind, std::vector<double> ns,
+                 float sampleRate, bool perBlock)
+{
+    Result r;
+    r.name = name;
+    r.kind = kind;
+    r.count = ns.size();
+
+    if (ns.empty())
+        return r;
+
+    std::sort(ns.begin(), ns.end());
+    auto pct = [&ns](double p) { return ns[std::min(ns.size() - 1, (size_t)(p * ns.size()))]; };
+
+    double sum = 0;
+    for (auto v : ns)
+        sum += v;
+
+    r.meanNs = sum / ns.size();
+    r.p50Ns = pct(0.5);
+    r.p90Ns = pct(0.9);
+    r.p99Ns = pct(0.99);
+    r.maxNs = ns.back();
+
+    if (perBlock && r.meanNs > 0)
+    {
+        r.nsPerSample = r.meanNs / BLOCK_SIZE;
+        r.blocksPerSecond = 1e9 / r.meanNs;
+        r.realtimeFactor = (1e9 * BLOCK_SIZE / sampleRate) / r.meanNs;
+    }
+
+    return r;
+}
+
+/*
+ * Every workload starts from a factory template on a minimal engine (no user defaults or
+ * directory scans) with a fixed random seed, so two runs render the same audio.
+ */
+std::shared_ptr<SurgeSynthesizer> engineOn(const std::string &templateName, const Options &opt)
+{
+    auto surge = Surge::Headless::createMinimalSurge(opt.sampleRate);
+    auto path = surge->storage.datapath / "patches_factory" / "Templates" / (templateName + ".fxp");
+
+    if (!surge->loadPatchByPath(path_to_string(path).c_str(), -1, templateName.c_str()))
+        throw std::runtime_error("Unable to load '" + path_to_string(path) +
+                                 "'; run from the root of the source tree");
+
+    surge->setRandomSeed(1);
+    surge->process();
+    return surge;
+}
+
+void setValue(SurgeSynthesizer *surge, Parameter &p, float v)
+{
+    surge->setParameter01(surge->idForParameter(&p), p.value_to_normalized(v), false);
+
+    // type changes and the like land on the next block
+    surge->process();
+}
+
+Result timeBlocks(const std::string &name, SurgeSynthesizer *surge, const Options &opt,
+                  const std::function<void()> &beforeBlock = nullptr)
+{
+    auto nBlocks = std::max(1, (int)(opt.seconds * opt.sampleRate / BLOCK_SIZE));
+    auto warmup = std::max(1, nBlocks / 10);
+
+    for (int i = 0; i < warmup; ++i)
+    {
+        if (beforeBlock)
+            beforeBlock();
+        surge->process();
+    }
+
+    std::vector<double> ns(nBlocks);
+    Fingerprint output;
+    for (int i = 0; i < nBlocks; ++i)
+    {
+        if (beforeBlock)
+            beforeBlock();
+
+        auto t0 = benchClock::now();
+        surge->process();
+        ns[i] = nsSince(t0);
+
+        output.add(surge->output[0], BLOCK_SIZE);
+        output.add(surge->output[1], BLOCK_SIZE);
+    }
+
+    auto res = summarize(name, "render", std::move(ns), opt.sampleRate, true);
+    output.finish();
+    res.output = std::move(output);
+    return res;
+}
+
+std::vector<Result> unisonSaw(const Options &opt)
+{
+    auto surge = engineOn("Init Saw", opt);
+    auto &osc = surge->storage.getPatch().scene[0].osc[0];
+    setValue(surge.get(), osc.p[ClassicOscillator::co_unison_voices], 16);
+
+    for (int i = 0; i < 8; ++i)
+        surge->playNote(0, 48 + 3 * i, 100, 0);
+
+    return {timeBlocks("unison-saw-16x8", surge.get(), opt)};
+}
+
+std::vector<Result> wavetablePad(const Options &opt)
+{
+    auto surge = engineOn("Init Wavetable", opt);
+    setValue(surge.get(), surge->storage.getPatch().polylimit, 64);
+
+    for (int i = 0; i < 64; ++i)
+        surge->playNote(0, 24 + i, 100, 0);
+
+    return {timeBlocks("wavetable-pad-64", surge.get(), opt)};
+}
+
+/*
+ * Each effect in the first A insert slot, fed pink noise through the audio input oscillator
+ * so that every type sees the same broadband signal.
+ */
+std::vector<Result> everyFX(const Options &opt)
+{
+    std::vector<Result> res;
+
+    for (int t = fxt_off + 1; t < n_fx_types; ++t)
+    {
+        auto name = "fx-" + slug(fx_type_shortnames[t]);
+        if (narrowedOut(opt, "fx", name))
+            continue;
+
+        auto surge = engineOn("Init Saw", opt);
+        auto &patch = surge->storage.getPatch();
+        surge->process_input = true;
+        setValue(surge.get(), patch.scene[0].osc[0].type, ot_audioinput);
+        setValue(surge.get(), patch.fx[0].type, t);
+        surge->playNote(0, 60, 100, 0);
+
+        // Paul Kellett's economy pink filter over a fixed seed white source
+        std::minstd_rand gen(t);
+        std::uniform_real_distribution<float> white(-1.f, 1.f);
+        float b0 = 0, b1 = 0, b2 = 0;
+        auto pink = [&]() {
+            auto w = white(gen);
+            b0 = 0.99765f * b0 + w * 0.0990460f;
+            b1 = 0.96300f * b1 + w * 0.2965164f;
+            b2 = 0.57000f * b2 + w * 1.0526913f;
+            return 0.05f * (b0 + b1 + b2 + w * 0.1848f);
+        };
+
+        res.push_back(timeBlocks(name, surge.get(), opt, [&]() {
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                surge->input[0][s] = pink();
+                surge->input[1][s] = pink();
+            }
+        }));
+    }
+
+    return res;
+}
+
+/*
+ * All six voice LFOs of scene A as formula modulators, each modulating something, under
+ * eight voices. That is 48 Lua evaluations per block.
+ */
+std::vector<Result> formulaLFOs(const Options &opt)
+{
+    auto surge = engineOn("Init Saw", opt);
+    auto &scene = surge->storage.getPatch().scene[0];
+
+    Parameter *targets[n_lfos_voice] = {&scene.osc[0].pitch,         &scene.filterunit[0].cutoff,
+                                        &scene.filterunit[0].resonance, &scene.pan,
+                                        &scene.width,                 &scene.osc[0].p[0]};
+
+    for (int l = 0; l < n_lfos_voice; ++l)
+    {
+        scene.lfo[l].shape.val.i = lt_formula;
+        surge->storage.getPatch().formulamods[0][l].setFormula(R"FN(
+function process(modstate)
+    local p = modstate["phase"]
+    modstate["output"] = math.sin(p * 2 * math.pi) * 0.5 + math.sin(p * 6 * math.pi) * 0.25
+    return modstate
+end)FN");
+        surge->setModDepth01(targets[l]->id, (modsources)(ms_lfo1 + l), 0, 0, 0.1);
+    }
+
+    for (int i = 0; i < 8; ++i)
+        surge->playNote(0, 48 + 3 * i, 100, 0);
+
+    return {timeBlocks("formula-lfo-6x8", surge.get(), opt)};
+}
+
+/*
+ * patch-load is the first load of each of the first patchCount factory patches; patch-switch
+ * cycles through the same set again, now warm, rendering a block with a note held between
+ * loads as a host switching programs would.
+ */
+std::vector<Result> patchLoads(const Options &opt)
+{
+    auto surge = engineOn("Init Saw", opt);
+
+    std::vector<fs::path> patches;
+    for (auto &d : fs::recursive_directory_iterator(surge->storage.datapath / "patches_factory"))
+    {
+        if (d.is_regular_file() && path_to_string(d.path().extension()) == ".fxp")
+            patches.push_back(d.path());
+    }
+    std::sort(patches.begin(), patches.end());
+    if (patches.size() > (size_t)opt.patchCount)
+        patches.resize(opt.patchCount);
+
+    auto loadAll = [&](std::vector<double> &ns) {
+        for (auto &p : patches)
+        {
+            auto name = path_to_string(p.stem());
+            auto t0 = benchClock::now();
+            surge->loadPatchByPath(path_to_string(p).c_str(), -1, name.c_str());
+            ns.push_back(nsSince(t0));
+
+            surge->playNote(0, 60, 100, 0);
+            surge->process();
+            surge->releaseNote(0, 60, 0);
+        }
+    };
+
+    std::vector<double> cold, warm;
+    loadAll(cold);
+    for (int i = 0; i < 4; ++i)
+        loadAll(warm);
+
+    return {summarize("patch-load", "patch", std::move(cold), opt.sampleRate, false),
+            summarize("patch-switch", "patch", std::move(warm), opt.sampleRate, false)};
+}
+/*
+ * patch-breakdown plays a short note on every factory patch through the test runner's
+ * playOnEveryPatch and reports each phase of the engine's patch load profile across them, so
+ * we can see which part of a program change to go after. The phases overlap: load contains
+ * parse, fx and embedded wavetables, and since nothing loads off the audio thread here the
+ * first block contains referenced wavetables and oscillator changes. The slowest patches go
+ * to stderr with their split.
+ */
+std::vector<Result> patchBreakdown(const Options &opt)
+{
+    using PLP = Surge::Profiling::PatchLoadProfile;
+
+    auto surge = Surge::Headless::createSurge(opt.sampleRate, true);
+    surge->setRandomSeed(1);
+
+    std::vector<std::vector<double>> ns(PLP::n_load_phases);
+    std::vector<std::pair<double, std::string>> slowest;
+
+    auto events = Surge::Headless::makeHoldMiddleC(8 * BLOCK_SIZE, 4 * BLOCK_SIZE);
+
+    Surge::Headless::playOnEveryPatch(
+        surge, events,
+        [&](const Patch &p, const PatchCategory &c, const float *, int, int) {
+            if (!c.isFactory)
+                return;
+
+            auto &profile = surge->storage.patchLoadProfile;
+            std::ostringstream split;
+
+            for (int i = 0; i < PLP::n_load_phases; ++i)
+            {
+                auto t = (double)profile.getNs((PLP::Phase)i);
+                ns[i].push_back(t);
+                split << " " << PLP::phaseName(i) << "=" << std::fixed << std::setprecision(2)
+                      << t * 1e-6;
+            }
+
+            slowest.emplace_back(profile.getNs(PLP::lp_load) + profile.getNs(PLP::lp_firstBlock),
+                                 c.name + "/" + p.name + split.str());
+        });
+
+    if (ns[PLP::lp_load].empty())
+        throw std::runtime_error("No factory patches found; run from the root of the source tree");
+
+    std::sort(slowest.rbegin(), slowest.rend());
+    for (size_t i = 0; i < std::min(slowest.size(), (size_t)10); ++i)
+        std::cerr << "#   slow load " << std::fixed << std::setprecision(2)
+                  << slowest[i].first * 1e-6 << "ms " << slowest[i].second << std::endl;
+
+    std::vector<Result> res;
+    for (int i = 0; i < PLP::n_load_phases; ++i)
+        res.push_back(summarize(std::string("patch-breakdown-") + PLP::phaseName(i), "patch",
+                                std::move(ns[i]), opt.sampleRate, false));
+    return res;
+}
+
+/*
+ * Host automation as a dense session sends it: automationParams continuous parameters on each
+ * of automationInstances engines, every one set every block, as the plugin sets them. Only the
+ * setParameter01 calls are timed, and each result is one block's worth of them across all the
+ * engines. automation-ramp moves every value each block; automation-steady resends the values
+ * the engines already have, which hosts do for any lane which isn't moving.
+ */
+std::vector<Result> automation(const Options &opt)
+{
+    std::vector<std::shared_ptr<SurgeSynthesizer>> engines;
+    for (int i = 0; i < std::max(1, opt.automationInstances); ++i)
+        engines.push_back(engineOn("Init Saw", opt));
+
+    // the same parameters on each: the first continuous ones in the patch, whatever they are
+    std::vector<SurgeSynthesizer::ID> ids;
+    for (auto *p : engines[0]->storage.getPatch().param_ptr)
+    {
+        if ((int)ids.size() == opt.automationParams)
+            break;
+        if (p->valtype == vt_float && p->ctrltype != ct_none && !p->affect_other_parameters)
+            ids.push_back(engines[0]->idForParameter(p));
+    }
+
+    auto nBlocks = std::max(1, opt.microBlocks);
+    auto name = std::to_string(ids.size()) + "x" + std::to_string(engines.size());
+
+    auto run = [&](bool moving) {
+        std::vector<double> ns(nBlocks);
+
+        for (int b = 0; b < nBlocks; ++b)
+        {
+            auto t0 = benchClock::now();
+
+            for (auto &e : engines)
+            {
+                for (size_t i = 0; i < ids.size(); ++i)
+                {
+                    auto v = moving ? (float)((b + i) % 256) / 255.f : 0.5f;
+                    e->setParameter01(ids[i], v, true);
+                }
+            }
+
+            ns[b] = nsSince(t0);
+
+            for (auto &e : engines)
+                e->process();
+        }
+
+        return summarize(std::string("automation-") + (moving ? "ramp-" : "steady-") + name,
+                         "automation", std::move(ns), opt.sampleRate, false);
+    };
+
+    return {run(true), run(false)};
+}
+
+/*
+ * Every oscillator type run on its own, outside a voice, at each unison count its unison
+ * parameter (if it has one) allows from {1, 4, 16}. The types all share scene A oscillator 1
+ * of an Init Wavetable engine, so the wavetable based ones have a table to play.
+ */
+std::vector<Result> everyOscillator(const Options &opt)
+{
+    std::vector<Result> res;
+
+    for (auto sr : opt.microRates)
+    {
+        auto o = opt;
+        o.sampleRate = sr;
+        auto surge = engineOn("Init Wavetable", o);
+        auto &patch = surge->storage.getPatch();
+        auto &osc = patch.scene[0].osc[0];
+
+        for (int t = 0; t < n_osc_types; ++t)
+        {
+            setValue(surge.get(), osc.type, t);
+
+            Parameter *unison = nullptr;
+            for (auto &p : osc.p)
+                if (p.ctrltype == ct_osccount)
+                    unison = &p;
+
+            for (auto u : {1, 4, 16})
+            {
+                if (u > 1 && (!unison || u > unison->val_max.i))
+                    break;
+
+                auto name = "osc-" + slug(osc_type_shortnames[t]) + "-u" + std::to_string(u) +
+                            "-" + rateTag(sr);
+                if (narrowedOut(opt, "osc", name))
+                    continue;
+
+                if (unison)
+                    setValue(surge.get(), *unison, u);
+
+                pdata localcopy[n_scene_params];
+                memcpy(localcopy, patch.scenedata[0], sizeof(localcopy));
+                unsigned char buffer alignas(16)[oscillator_buffer_size];
+
+                auto *so = spawn_osc(t, &surge->storage, &osc, localcopy, buffer);
+                if (!so)
+                    continue;
+                so->init(60.f, false, false);
+
+                std::vector<double> ns(opt.microBlocks);
+                Fingerprint output;
+                for (auto &n : ns)
+                {
+                    auto t0 = benchClock::now();
+                    so->process_block(60.f, 0.f, true);
+                    n = nsSince(t0);
+
+                    output.add(so->output, BLOCK_SIZE_OS);
+                    output.add(so->outputR, BLOCK_SIZE_OS);
+                }
+                so->~Oscillator();
+
+                res.push_back(summarize(name, "osc", std::move(ns), sr, true));
+                output.finish();
+                res.back().output = std::move(output);
+            }
+        }
+    }
+
+    return res;
+}
+
+/*
+ * Every filter type and subtype through GetQFPtrFilterUnit, four voices wide as the voice
+ * filter block runs them, on white noise at an open cutoff with some resonance. Times are per
+ * voice.
+ */
+std::vector<Result> everyFilter(const Options &opt)
+{
+    using namespace sst::filters;
+    std::vector<Result> res;
+
+    for (auto sr : opt.microRates)
+    {
+        auto o = opt;
+        o.sampleRate = sr;
+        auto surge = engineOn("Init Saw", o);
+        auto storage = &surge->storage;
+
+        std::minstd_rand gen(1);
+        std::uniform_real_distribution<float> white(-1.f, 1.f);
+        float input alignas(16)[BLOCK_SIZE_OS];
+        for (auto &f : input)
+            f = white(gen);
+
+        for (int t = fut_none + 1; t < num_filter_types; ++t)
+        {
+            for (int st = 0; st < std::max(1, fut_subcount[t]); ++st)
+            {
+                auto name = "filter-" + slug(filter_type_names[t]) + "-" + std::to_string(st) +
+                            "-" + rateTag(sr);
+                if (narrowedOut(opt, "filter", name))
+                    continue;
+
+                auto fptr = GetQFPtrFilterUnit((FilterType)t, (FilterSubType)st);
+                if (!fptr)
+                    continue;
+
+                auto qfu = std::make_unique<QuadFilterUnitState>();
+                std::vector<float> delay[4];
+                FilterCoefficientMaker<SurgeStorage> cm;
+                cm.setSampleRateAndBlockSize((float)storage->dsamplerate_os, BLOCK_SIZE_OS);
+                cm.MakeCoeffs(0.f, 0.5f, (FilterType)t, (FilterSubType)st, storage, false);
+
+                for (int e = 0; e < 4; ++e)
+                {
+                    delay[e].assign(utilities::MAX_FB_COMB + utilities::SincTable::FIRipol_N, 0.f);
+                    cm.updateState(*qfu, e);
+                    qfu->DB[e] = delay[e].data();
+                    qfu->WP[e] = 0;
+                    qfu->active[e] = 0xFFFFFFFF;
+                }
+
+                auto sum = _mm_setzero_ps();
+                std::vector<double> ns(opt.microBlocks);
+                Fingerprint output;
+                float keep alignas(16)[4];
+                for (auto &n : ns)
+                {
+                    auto t0 = benchClock::now();
+                    for (int s = 0; s < BLOCK_SIZE_OS; ++s)
+                        sum = _mm_add_ps(sum, fptr(qfu.get(), _mm_set1_ps(input[s])));
+                    n = nsSince(t0) / 4;
+
+                    // the running sum of each voice's output stands in for what it rendered
+                    _mm_store_ps(keep, sum);
+                    output.add(keep, 4);
+                }
+
+                // keep the filter output live so none of the above is optimized away
+                benchmarkSink = keep[0];
+
+                res.push_back(summarize(name, "filter", std::move(ns), sr, true));
+                output.finish();
+                res.back().output = std::move(output);
+            }
+        }
+    }
+
+    return res;
+}
+} // namespace
+
+void Fingerprint::add(const float *data, int n)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        uint32_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        for (int b = 0; b < 4; ++b)
+        {
+            hash ^= (bits >> (8 * b)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+
+        windowSquares += (double)data[i] * data[i];
+        if (++windowFill == windowSize)
+        {
+            windowRMS.push_back((float)std::sqrt(windowSquares / windowSize));
+            windowSquares = 0;
+            windowFill = 0;
+        }
+    }
+    samples += n;
+}
+
+void Fingerprint::finish()
+{
+    if (windowFill > 0)
+        windowRMS.push_back((float)std::sqrt(windowSquares / windowFill));
+    windowSquares = 0;
+    windowFill = 0;
+}
+
+std::vector<Workload> allWorkloads()
+{
+    return {{"unison-saw-16x8", unisonSaw},
+            {"wavetable-pad-64", wavetablePad},
+            {"fx", everyFX},
+            {"formula-lfo-6x8", formulaLFOs},
+            {"patch", patchLoads},
+            {"patch-breakdown", patchBreakdown},
+            {"automation", automation},
+            {"osc", everyOscillator},
+            {"filter", everyFilter}};
+}
+
+double baselineCost(const Result &r) { return r.nsPerSample > 0 ? r.nsPerSample : r.meanNs; }
+
+bool saveBaseline(const std::vector<Result> &results, const std::string &path)
+{
+    std::ofstream ofs(path);
+    if (!ofs)
+        return false;
+
+    ofs << "# surge-benchmarks baseline from " << Surge::Build::FullVersionStr << "\n";
+    ofs << std::fixed << std::setprecision(3);
+    for (const auto &r : results)
+        ofs << r.name << "\t" << baselineCost(r) << "\n";
+
+    return (bool)ofs;
+}
+
+bool checkBaseline(const std::vector<Result> &results, const std::string &path, double tolerance,
+                   std::ostream &report)
+{
+    std::ifstream ifs(path);
+    if (!ifs)
+    {
+        report << "# unable to read baseline '" << path << "'" << std::endl;
+        return false;
+    }
+
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        auto tab = line.find('\t');
+        if (line.empty() || line[0] == '#' || tab == std::string::npos)
+            continue;
+        baseline[line.substr(0, tab)] = std::atof(line.c_str() + tab + 1);
+    }
+
+    int regressions = 0, missing = 0;
+    report << std::fixed << std::setprecision(1);
+    for (const auto &r : results)
+    {
+        auto b = baseline.find(r.name);
+        if (b == baseline.end() || b->second <= 0)
+        {
+            missing++;
+            continue;
+        }
+
+        auto ratio = baselineCost(r) / b->second;
+        if (ratio > 1 + tolerance)
+        {
+            report << "# REGRESSION " << r.name << ": " << baselineCost(r) << " vs "
+                   << b->second << " (+" << (ratio - 1) * 100 << "%)" << std::endl;
+            regressions++;
+        }
+    }
+
+    report << "# baseline check: " << results.size() - missing << " compared, " << regressions
+           << " slower than " << tolerance * 100 << "% over, " << missing
+           << " with no baseline entry" << std::endl;
+
+    return regressions == 0;
+}
+
+bool saveGolden(const std::vector<Result> &results, const std::string &path)
+{
+    std::ofstream ofs(path);
+    if (!ofs)
+        return false;
+
+    ofs << "# surge-benchmarks golden output from " << Surge::Build::FullVersionStr << "\n";
+    ofs << std::setprecision(9);
+    for (const auto &r : results)
+    {
+        if (r.output.empty())
+            continue;
+
+        ofs << r.name << "\t" << std::hex << r.output.hash << std::dec << "\t" << r.output.samples
+            << "\t";
+        for (auto v : r.output.windowRMS)
+            ofs << v << " ";
+        ofs << "\n";
+    }
+
+    return (bool)ofs;
+}
+
+bool checkGolden(const std::vector<Result> &results, const std::string &path, double tolerance,
+                 bool exact, std::ostream &report)
+{
+    std::ifstream ifs(path);
+    if (!ifs)
+    {
+        report << "# unable to read golden output '" << path << "'" << std::endl;
+        return false;
+    }
+
+    std::map<std::string, Fingerprint> golden;
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream iss(line);
+        std::string name;
+        Fingerprint f;
+        if (!std::getline(iss, name, '\t') || !(iss >> std::hex >> f.hash >> std::dec >> f.samples))
+            continue;
+
+        float v;
+        while (iss >> v)
+            f.windowRMS.push_back(v);
+        golden[name] = std::move(f);
+    }
+
+    int compared = 0, identical = 0, failed = 0, missing = 0;
+    for (const auto &r : results)
+    {
+        if (r.output.empty())
+            continue;
+
+        auto g = golden.find(r.name);
+        if (g == golden.end())
+        {
+            missing++;
+            continue;
+        }
+
+        compared++;
+        const auto &want = g->second;
+        if (r.output.hash == want.hash && r.output.samples == want.samples)
+        {
+            identical++;
+            continue;
+        }
+
+        if (r.output.samples != want.samples ||
+            r.output.windowRMS.size() != want.windowRMS.size())
+        {
+            report << "# OUTPUT CHANGED " << r.name << ": " << r.output.samples << " samples vs "
+                   << want.samples << std::endl;
+            failed++;
+            continue;
+        }
+
+        double worst = 0;
+        for (size_t i = 0; i < want.windowRMS.size(); ++i)
+            worst = std::max(worst, (double)std::fabs(r.output.windowRMS[i] - want.windowRMS[i]));
+
+        if (exact || !(worst <= tolerance))
+        {
+            report << "# OUTPUT CHANGED " << r.name << ": not bit exact, window rms off by "
+                   << worst << std::endl;
+            failed++;
+        }
+    }
+
+    report << "# golden check: " << compared << " compared, " << identical << " bit exact, "
+           << compared - identical - failed << " within " << tolerance << " rms, " << failed
+           << " changed, " << missing << " with no golden entry" << std::endl;
+
+    return failed == 0;
+}
+
+void writeJSON(const std::vector<Result> &results, const Options &opt, std::ostream &os)
+{
+    auto q = [](const std::string &s) { return "\"" + s + "\""; };
+
+    os << std::fixed << std::setprecision(3);
+    os << "{\n"
+       << "  \"version\": " << q(Surge::Build::FullVersionStr) << ",\n"
+       << "  \"sample_rate\": " << opt.sampleRate << ",\n"
+       << "  \"block_size\": " << BLOCK_SIZE << ",\n"
+       << "  \"results\": [";
+
+    bool first = true;
+    for (const auto &r : results)
+    {
+        os << (first ? "\n" : ",\n") << "    {\"name\": " << q(r.name)
+           << ", \"kind\": " << q(r.kind) << ", \"count\": " << r.count
+           << ", \"mean_ns\": " << r.meanNs << ", \"p50_ns\": " << r.p50Ns
+           << ", \"p90_ns\": " << r.p90Ns << ", \"p99_ns\": " << r.p99Ns
+           << ", \"max_ns\": " << r.maxNs;
+        if (r.kind == "render")
+            os << ", \"ns_per_sample\": " << r.nsPerSample
+               << ", \"blocks_per_second\": " << r.blocksPerSecond
+               << ", \"realtime_factor\": " << r.realtimeFactor;
+        if (!r.output.empty())
+            os << ", \"output_hash\": \"" << std::hex << r.output.hash << std::dec << "\"";
+        os << "}";
+        first = false;
+    }
+
+    os << "\n  ]\n}" << std::endl;
+}
+
+void writeText(const std::vector<Result> &results, const Options &opt, std::ostream &os)
+{
+    os << "# surge-benchmarks " << Surge::Build::FullVersionStr << " at " << opt.sampleRate
+       << "Hz, block size " << BLOCK_SIZE << "\n";
+    os << std::left << std::setw(28) << "name" << std::right << std::setw(12) << "ns/sample"
+       << std::setw(12) << "blocks/s" << std::setw(10) << "x rt" << std::setw(14) << "p50 us"
+       << std::setw(14) << "p99 us" << std::setw(14) << "max us" << "\n";
+
+    os << std::fixed;
+    for (const auto &r : results)
+    {
+        os << std::left << std::setw(28) << r.name << std::right << std::setprecision(2);
+        if (r.kind == "render")
+            os << std::setw(12) << r.nsPerSample << std::setw(12) << std::setprecision(0)
+               << r.blocksPerSecond << std::setw(10) << std::setprecision(1) << r.realtimeFactor;
+        else
+            os << std::setw(12) << "-" << std::setw(12) << "-" << std::setw(10) << "-";
+        os << std::setprecision(2) << std::setw(14) << r.p50Ns / 1000 << std::setw(14)
+           << r.p99Ns / 1000 << std::setw(14) << r.maxNs / 1000 << "\n";
+    }
+    os << std::flush;
+}
+
+} // namespace Benchmarks
+} // namespace Surge
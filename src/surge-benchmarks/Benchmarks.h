@@ -0,0 +1,122 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#ifndef SURGE_SRC_SURGE_BENCHMARKS_BENCHMARKS_H
+#define SURGE_SRC_SURGE_BENCHMARKS_BENCHMARKS_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Surge
+{
+namespace Benchmarks
+{
+struct Options
+{
+    float sampleRate{48000};
+    double seconds{5};       // of audio rendered per render workload
+    int patchCount{32};      // factory patches cycled by the patch workload
+    std::string filter{""};  // only run workloads whose name contains this
+
+    // the oscillator and filter sweeps run at each of these for microBlocks blocks
+    std::vector<float> microRates{44100, 48000, 96000};
+    int microBlocks{2000};
+
+    // the automation workload moves this many parameters on this many engines every block
+    int automationParams{50};
+    int automationInstances{30};
+};
+
+/*
+ * What a workload rendered while it was timed: an FNV-1a hash over the bits of every sample,
+ * which only survives a bit exact change, and the RMS of each window of windowSize samples,
+ * which lets a change that moves the rounding be held to a bounded error instead.
+ */
+struct Fingerprint
+{
+    static constexpr int windowSize{4096};
+
+    uint64_t hash{14695981039346656037ULL};
+    size_t samples{0};
+    std::vector<float> windowRMS;
+
+    void add(const float *data, int n);
+    void finish();
+    bool empty() const { return samples == 0; }
+
+  private:
+    double windowSquares{0};
+    int windowFill{0};
+};
+
+/*
+ * One measurement. Render workloads time every block and report per sample and per block
+ * figures; patch workloads time every load and leave those at zero. Anything which renders
+ * audio also fingerprints it.
+ */
+struct Result
+{
+    std::string name;
+    std::string kind;
+    size_t count{0};
+    double meanNs{0}, p50Ns{0}, p90Ns{0}, p99Ns{0}, maxNs{0};
+    double nsPerSample{0}, blocksPerSecond{0}, realtimeFactor{0};
+    Fingerprint output;
+};
+
+struct Workload
+{
+    std::string name;
+    std::function<std::vector<Result>(const Options &)> run;
+};
+
+std::vector<Workload> allWorkloads();
+
+/*
+ * A baseline is one "name<TAB>cost" line per result, cost being ns per sample for anything
+ * which renders and mean ns per operation otherwise. checkBaseline reports every result more
+ * than tolerance (0.1 is 10%) slower than its baseline and returns false if there are any.
+ */
+double baselineCost(const Result &r);
+bool saveBaseline(const std::vector<Result> &results, const std::string &path);
+bool checkBaseline(const std::vector<Result> &results, const std::string &path, double tolerance,
+                   std::ostream &report);
+
+/*
+ * A golden file is one "name<TAB>hash<TAB>samples<TAB>window RMS..." line per result with
+ * output. checkGolden compares each result's output against it: identical hashes pass, and
+ * otherwise so do outputs whose window RMS all lie within tolerance of the golden ones, unless
+ * exact is set. It reports every failure and returns false if there are any.
+ */
+bool saveGolden(const std::vector<Result> &results, const std::string &path);
+bool checkGolden(const std::vector<Result> &results, const std::string &path, double tolerance,
+                 bool exact, std::ostream &report);
+
+void writeJSON(const std::vector<Result> &results, const Options &opt, std::ostream &os);
+void writeText(const std::vector<Result> &results, const Options &opt, std::ostream &os);
+
+} // namespace Benchmarks
+} // namespace Surge
+
+#endif // SURGE_SRC_SURGE_BENCHMARKS_BENCHMARKS_H
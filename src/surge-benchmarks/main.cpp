@@ -0,0 +1,202 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#include "Benchmarks.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static void usage(const char *argv0)
+{
+    std::cerr << "Usage: " << argv0 << " [options]\n\n"
+              << "Renders fixed engine workloads and reports per block timing as JSON.\n"
+              << "Run from the root of the source tree so the factory data is found.\n\n"
+              << "   --list                 # list the workloads and exit\n"
+              << "   --filter name          # only run workloads whose name contains name\n"
+              << "                          # (fx-reverb picks one effect from the fx set)\n"
+              << "   --sample-rate sr       # default 48000\n"
+              << "   --seconds s            # audio rendered per render workload, default 5\n"
+              << "   --patches n            # factory patches cycled by the patch workload\n"
+              << "                          # (patch-breakdown always plays every one)\n"
+              << "   --micro-rates a,b,c    # rates for the osc and filter sweeps\n"
+              << "   --micro-blocks n       # blocks timed per osc and filter entry, and for\n"
+              << "                          # the automation workload\n"
+              << "   --automation p,i       # p parameters on i engines, default 50,30\n"
+              << "   --output file          # write the results there instead of stdout\n"
+              << "   --text                 # a table for people rather than JSON\n"
+              << "   --save-baseline file   # store these results as a baseline\n"
+              << "   --check-baseline file  # exit 3 if anything is slower than the baseline\n"
+              << "   --tolerance pct        # how much slower is too slow, default 10\n"
+              << "   --save-golden file     # store a fingerprint of what each workload rendered\n"
+              << "   --check-golden file    # exit 4 if any output moved from the golden one\n"
+              << "   --golden-tolerance x   # largest window rms difference allowed where the\n"
+              << "                          # output is not bit exact, default 1e-5\n"
+              << "   --golden-exact         # only bit exact output passes the golden check\n\n"
+              << "With --check-baseline and --check-golden together a change is checked for\n"
+              << "speed and output in one run; both are reported before either exit code.\n";
+}
+
+int main(int argc, char **argv)
+{
+    Surge::Benchmarks::Options opt;
+    bool list{false}, text{false}, goldenExact{false};
+    std::string output, saveBaseline, checkBaseline, saveGolden, checkGolden;
+    double tolerance{10}, goldenTolerance{1e-5};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string(argv[i]);
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc)
+            {
+                usage(argv[0]);
+                exit(1);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--list")
+            list = true;
+        else if (arg == "--text")
+            text = true;
+        else if (arg == "--filter")
+            opt.filter = next();
+        else if (arg == "--sample-rate")
+            opt.sampleRate = std::stof(next());
+        else if (arg == "--seconds")
+            opt.seconds = std::stod(next());
+        else if (arg == "--patches")
+            opt.patchCount = std::stoi(next());
+        else if (arg == "--micro-rates")
+        {
+            opt.microRates.clear();
+            std::istringstream iss(next());
+            std::string r;
+            while (std::getline(iss, r, ','))
+                opt.microRates.push_back(std::stof(r));
+        }
+        else if (arg == "--micro-blocks")
+            opt.microBlocks = std::stoi(next());
+        else if (arg == "--automation")
+        {
+            auto a = next();
+            auto comma = a.find(',');
+            opt.automationParams = std::stoi(a.substr(0, comma));
+            if (comma != std::string::npos)
+                opt.automationInstances = std::stoi(a.substr(comma + 1));
+        }
+        else if (arg == "--output")
+            output = next();
+        else if (arg == "--save-baseline")
+            saveBaseline = next();
+        else if (arg == "--check-baseline")
+            checkBaseline = next();
+        else if (arg == "--tolerance")
+            tolerance = std::stod(next());
+        else if (arg == "--save-golden")
+            saveGolden = next();
+        else if (arg == "--check-golden")
+            checkGolden = next();
+        else if (arg == "--golden-tolerance")
+            goldenTolerance = std::stod(next());
+        else if (arg == "--golden-exact")
+            goldenExact = true;
+        else
+        {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    auto workloads = Surge::Benchmarks::allWorkloads();
+
+    if (list)
+    {
+        for (const auto &w : workloads)
+            std::cout << w.name << "\n";
+        return 0;
+    }
+
+    std::vector<Surge::Benchmarks::Result> results;
+    for (const auto &w : workloads)
+    {
+        // fx-reverb and patch-switch both select their parent workload
+        if (!opt.filter.empty() && w.name.find(opt.filter) == std::string::npos &&
+            opt.filter.rfind(w.name, 0) != 0)
+            continue;
+
+        std::cerr << "# running " << w.name << std::endl;
+        try
+        {
+            for (auto &r : w.run(opt))
+                results.push_back(r);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "# " << w.name << " failed: " << e.what() << std::endl;
+            return 2;
+        }
+    }
+
+    std::ofstream ofs;
+    if (!output.empty())
+    {
+        ofs.open(output);
+        if (!ofs)
+        {
+            std::cerr << "# unable to open '" << output << "' for writing" << std::endl;
+            return 1;
+        }
+    }
+    auto &os = output.empty() ? std::cout : ofs;
+
+    if (text)
+        Surge::Benchmarks::writeText(results, opt, os);
+    else
+        Surge::Benchmarks::writeJSON(results, opt, os);
+
+    if (!saveBaseline.empty() && !Surge::Benchmarks::saveBaseline(results, saveBaseline))
+    {
+        std::cerr << "# unable to write baseline '" << saveBaseline << "'" << std::endl;
+        return 1;
+    }
+
+    if (!saveGolden.empty() && !Surge::Benchmarks::saveGolden(results, saveGolden))
+    {
+        std::cerr << "# unable to write golden output '" << saveGolden << "'" << std::endl;
+        return 1;
+    }
+
+    namespace sb = Surge::Benchmarks;
+    bool fast = checkBaseline.empty() ||
+                sb::checkBaseline(results, checkBaseline, tolerance / 100, std::cerr);
+    bool same = checkGolden.empty() ||
+                sb::checkGolden(results, checkGolden, goldenTolerance, goldenExact, std::cerr);
+
+    if (!fast)
+        return 3;
+    if (!same)
+        return 4;
+
+    return 0;
+}
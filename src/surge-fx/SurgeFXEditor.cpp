@@ -522,6 +522,8 @@ void SurgefxAudioProcessorEditor::showMenu()
     auto sm = juce::PopupMenu();
     sm.addItem(Surge::GUI::toOSCase("Zero Latency Mode"), true, processor.nonLatentBlockMode,
                [this]() { toggleLatencyMode(); });
+    sm.addItem(Surge::GUI::toOSCase("Render Ahead On Worker Threads"), true,
+               processor.anticipativeMode, [this]() { toggleAnticipativeMode(); });
 
     p.addSubMenu("Options", sm);
 
@@ -599,6 +601,26 @@ void SurgefxAudioProcessorEditor::toggleLatencyMode()
                                            "Latency Setting Changed", oss.str());
 }
 
+void SurgefxAudioProcessorEditor::toggleAnticipativeMode()
+{
+    auto am = processor.anticipativeMode;
+    Surge::Storage::updateUserDefaultValue(processor.storage.get(),
+                                           Surge::Storage::FXUnitAnticipativeRendering, !am);
+    processor.anticipativeMode = !am;
+
+    std::ostringstream oss;
+    oss << "Please restart the DAW transport or reload your DAW project for this setting to take "
+           "effect!\n\n"
+        << (am ? "Effects are now processed when the DAW asks for them, with the latency set by "
+                 "the Zero Latency Mode option."
+               : "Effects are now rendered one audio buffer ahead on worker threads shared by all "
+                 "Surge XT Effects instances. This adds the DAW's buffer size plus 32 samples of "
+                 "latency, which is reported to the DAW.");
+
+    juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon,
+                                           "Rendering Setting Changed", oss.str());
+}
+
 struct FxFocusTrav : public juce::ComponentTraverser
 {
     FxFocusTrav(SurgefxAudioProcessorEditor *ed) : editor(ed) {}
@@ -48,6 +48,9 @@ SurgefxAudioProcessor::SurgefxAudioProcessor()
 
     setLatencySamples(nonLatentBlockMode ? 0 : BLOCK_SIZE);
 
+    anticipativeMode = Surge::Storage::getUserDefaultValue(
+        storage.get(), Surge::Storage::FXUnitAnticipativeRendering, false);
+
     effectNum = fxt_off;
 
     fxstorage = &(storage->getPatch().fx[0]);
@@ -112,7 +115,11 @@ SurgefxAudioProcessor::SurgefxAudioProcessor()
     resettingFx = false;
 }
 
-SurgefxAudioProcessor::~SurgefxAudioProcessor() {}
+SurgefxAudioProcessor::~SurgefxAudioProcessor()
+{
+    if (anticipativePool)
+        anticipativePool->finish();
+}
 
 //==============================================================================
 const juce::String SurgefxAudioProcessor::getName() const { return JucePlugin_Name; }
@@ -145,7 +152,42 @@ void SurgefxAudioProcessor::prepareToPlay(double sr, int samplesPerBlock)
     storage->setSamplerate(sr);
     storage->songpos = 0.;
 
-    setLatencySamples(nonLatentBlockMode ? 0 : BLOCK_SIZE);
+    if (anticipativePool)
+        anticipativePool->finish();
+
+    anticipativeActive = anticipativeMode;
+
+    if (!anticipativeActive)
+        anticipativePool.reset();
+
+    if (anticipativeActive)
+    {
+        if (!anticipativePool)
+            anticipativePool = std::make_unique<Surge::Threading::RenderWorkerPool>(1, false);
+
+        antMaxBlock = std::max(samplesPerBlock, BLOCK_SIZE);
+
+        // a job only renders whole blocks, so up to BLOCK_SIZE - 1 samples can wait a round
+        antLatency = antMaxBlock + BLOCK_SIZE;
+
+        int cap = BLOCK_SIZE;
+
+        while (cap < 2 * (antLatency + antMaxBlock))
+            cap *= 2;
+
+        for (int c = 0; c < 2; ++c)
+        {
+            antIn[c].assign(cap, 0.f);
+            antSide[c].assign(cap, 0.f);
+            antOut[c].assign(cap, 0.f);
+        }
+
+        antMask = cap - 1;
+        antWritten = 0;
+        antRendered = 0;
+    }
+
+    reportLatency();
 
     if (effectNum == fxt_off)
     {
@@ -153,6 +195,14 @@ void SurgefxAudioProcessor::prepareToPlay(double sr, int samplesPerBlock)
     }
 }
 
+void SurgefxAudioProcessor::reportLatency()
+{
+    int blockLatency = anticipativeActive ? antLatency : (nonLatentBlockMode ? 0 : BLOCK_SIZE);
+
+    reportedEffectLatency = surge_effect ? surge_effect->get_latency_samples() : 0;
+    setLatencySamples(blockLatency + reportedEffectLatency);
+}
+
 void SurgefxAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
@@ -178,9 +228,16 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                          juce::MidiBuffer &midiMessages)
 {
     audioRunning = true;
+
+    // collect the blocks we asked for last time before we touch anything they use
+    if (anticipativeActive)
+        anticipativePool->finish();
+
     if (resettingFx || !surge_effect)
         return;
 
+    storage->renderingOffline = isNonRealtime();
+
     juce::ScopedNoDenormals noDenormals;
 
     float thisBPM = 120.0;
@@ -207,7 +264,7 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     }
 
     auto sampl = buffer.getNumSamples();
-    if (nonLatentBlockMode && ((sampl & ~(BLOCK_SIZE - 1)) != sampl))
+    if (!anticipativeActive && nonLatentBlockMode && ((sampl & ~(BLOCK_SIZE - 1)) != sampl))
     {
         nonLatentBlockMode = false;
         input_position = 0;
@@ -216,7 +273,7 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
         memset(input_buffer, 0, sizeof(input_buffer));
         memset(sidechain_buffer, 0, sizeof(sidechain_buffer));
 
-        setLatencySamples(BLOCK_SIZE);
+        reportLatency();
         updateHostDisplay(ChangeDetails().withLatencyChanged(true));
     }
 
@@ -244,7 +301,26 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
         audio_thread_surge_effect = surge_effect;
     }
 
-    if (nonLatentBlockMode)
+    if (surge_effect->get_latency_samples() != reportedEffectLatency)
+    {
+        reportLatency();
+        updateHostDisplay(ChangeDetails().withLatencyChanged(true));
+    }
+
+    if (anticipativeActive)
+    {
+        auto sideChainBus = getBus(true, 1);
+        const float *sideL = nullptr, *sideR = nullptr;
+
+        if (effectNum == fxt_vocoder && sideChainBus && sideChainBus->isEnabled())
+        {
+            sideL = sideChainInput.getReadPointer(0, 0);
+            sideR = sideChainInput.getReadPointer(1, 0);
+        }
+
+        processAnticipated(mainInput, mainOutput, sideL, sideR, inChanL, inChanR);
+    }
+    else if (nonLatentBlockMode)
     {
         auto sideChainBus = getBus(true, 1);
 
@@ -371,6 +447,90 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     }
 }
 
+void SurgefxAudioProcessor::processAnticipated(const juce::AudioBuffer<float> &mainInput,
+                                               juce::AudioBuffer<float> &mainOutput,
+                                               const float *sideL, const float *sideR,
+                                               int inChanL, int inChanR)
+{
+    auto inL = mainInput.getReadPointer(inChanL, 0);
+    auto inR = mainInput.getReadPointer(inChanR, 0);
+    auto outL = mainOutput.getWritePointer(0, 0);
+    auto outR = mainOutput.getWritePointer(1, 0);
+    auto n = mainOutput.getNumSamples();
+
+    // a host which hands us more than it promised in prepareToPlay gets it in promised pieces
+    for (int start = 0; start < n; start += antMaxBlock)
+    {
+        auto len = std::min(antMaxBlock, n - start);
+
+        for (int s = 0; s < len; ++s)
+        {
+            auto w = (antWritten + s) & antMask;
+
+            antIn[0][w] = inL[start + s];
+            antIn[1][w] = inR[start + s];
+            antSide[0][w] = sideL ? sideL[start + s] : 0.f;
+            antSide[1][w] = sideR ? sideR[start + s] : 0.f;
+        }
+
+        antWritten += len;
+
+        // the job queued last time has normally left nothing for us to do here
+        while (antRendered + antLatency < antWritten && antRendered + BLOCK_SIZE <= antWritten)
+            renderAnticipatedBlock();
+
+        for (int s = 0; s < len; ++s)
+        {
+            auto src = antWritten - len + s - antLatency;
+
+            outL[start + s] = src < 0 ? 0.f : antOut[0][src & antMask];
+            outR[start + s] = src < 0 ? 0.f : antOut[1][src & antMask];
+        }
+    }
+
+    if (antRendered + BLOCK_SIZE <= antWritten)
+        anticipativePool->start(1, renderAnticipatedBlocks, this);
+}
+
+void SurgefxAudioProcessor::renderAnticipatedBlocks(void *ctx, int)
+{
+    auto that = static_cast<SurgefxAudioProcessor *>(ctx);
+
+    while (that->antRendered + BLOCK_SIZE <= that->antWritten)
+        that->renderAnticipatedBlock();
+}
+
+void SurgefxAudioProcessor::renderAnticipatedBlock()
+{
+    // the rings are a whole number of blocks long, so a block never wraps
+    auto pos = antRendered & antMask;
+    float bufferL alignas(16)[BLOCK_SIZE], bufferR alignas(16)[BLOCK_SIZE];
+
+    memcpy(bufferL, &antIn[0][pos], BLOCK_SIZE * sizeof(float));
+    memcpy(bufferR, &antIn[1][pos], BLOCK_SIZE * sizeof(float));
+
+    // while the UI swaps the effect out, pass the input through as the other modes do
+    if (!resettingFx && audio_thread_surge_effect)
+    {
+        memcpy(storage->audio_in_nonOS[0], &antSide[0][pos], BLOCK_SIZE * sizeof(float));
+        memcpy(storage->audio_in_nonOS[1], &antSide[1][pos], BLOCK_SIZE * sizeof(float));
+
+        for (int i = 0; i < n_fx_params; ++i)
+        {
+            fxstorage->p[fx_param_remap[i]].set_value_f01(*fxParams[i]);
+            paramFeatureOntoParam(&(fxstorage->p[fx_param_remap[i]]), paramFeatures[i]);
+        }
+        copyGlobaldataSubset(storage_id_start, storage_id_end);
+
+        audio_thread_surge_effect->process_ringout(bufferL, bufferR, true);
+    }
+
+    memcpy(&antOut[0][pos], bufferL, BLOCK_SIZE * sizeof(float));
+    memcpy(&antOut[1][pos], bufferR, BLOCK_SIZE * sizeof(float));
+
+    antRendered += BLOCK_SIZE;
+}
+
 //==============================================================================
 bool SurgefxAudioProcessor::hasEditor() const
 {
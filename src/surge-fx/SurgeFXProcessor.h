@@ -25,6 +25,7 @@
 
 #include "SurgeStorage.h"
 #include "Effect.h"
+#include "RenderWorkerPool.h"
 
 #include "juce_audio_processors/juce_audio_processors.h"
 
@@ -52,6 +53,14 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
 
     bool nonLatentBlockMode{true};
 
+    /*
+     * In anticipative mode each block is rendered on a worker thread while the host runs
+     * everything else, and handed back on the next processBlock. That costs the host's
+     * block size plus one of our blocks of latency, which is reported to the host. The setting
+     * is read from the user defaults and takes effect at the next prepareToPlay.
+     */
+    bool anticipativeMode{false};
+
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
@@ -365,6 +374,28 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
 
     std::atomic<bool> audioRunning{false};
 
+    void processAnticipated(const juce::AudioBuffer<float> &mainInput,
+                            juce::AudioBuffer<float> &mainOutput, const float *sideL,
+                            const float *sideR, int inChanL, int inChanR);
+    static void renderAnticipatedBlocks(void *ctx, int);
+    void renderAnticipatedBlock();
+
+    /*
+     * One worker which sleeps until the end of a processBlock starts the next round, and the
+     * start of the following one finishes it, running it here if the worker never got to it.
+     */
+    bool anticipativeActive{false};
+    std::unique_ptr<Surge::Threading::RenderWorkerPool> anticipativePool;
+
+    // rings of input, sidechain and rendered output, indexed by sample count modulo their size
+    std::vector<float> antIn[2], antSide[2], antOut[2];
+    int antMask{0}, antMaxBlock{0}, antLatency{0};
+    int64_t antWritten{0}, antRendered{0};
+
+    // the delay the effect adds itself, like the vocoder's FFT engine, on top of our own
+    int reportedEffectLatency{0};
+    void reportLatency();
+
   public:
     void prepareParametersAbsentAudio();
     void setParameterByString(int i, const std::string &s);
@@ -23,6 +23,14 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
 #include <utility>
 
@@ -30,8 +38,11 @@
 #include "SurgeStorage.h"
 #include "version.h"
 #include "filesystem/import.h"
+#include "WavetableLoader.h"
+#include "sst/basic-blocks/mechanics/endian-ops.h"
 
 namespace py = pybind11;
+namespace mech = sst::basic_blocks::mechanics;
 
 class PythonPluginLayerProxy : public SurgeSynthesizer::PluginLayer
 {
@@ -130,6 +141,92 @@ struct SurgePyModRouting
     float normalizedDepth;
 };
 
+/*
+ * A patch read and parsed once, which loadPatchImmediate can apply to any engine without going
+ * back to the file system or the xml parser. The chunk and document are shared and only read
+ * when applied, so one prepared patch can go to many engines, including those of a SurgePool.
+ */
+struct SurgePyPreparedPatch
+{
+    std::string name, path;
+    std::shared_ptr<std::vector<char>> chunk;
+    std::shared_ptr<TiXmlDocument> xml;
+
+    std::string getName() const { return name; }
+    std::string getPath() const { return path; }
+    std::string toString() const
+    {
+        return std::string("<SurgePreparedPatch '") + name + "' " + std::to_string(chunk->size()) +
+               " bytes>";
+    }
+
+    // Accepts either a whole .fxp file or the bare patch chunk inside one
+    static std::shared_ptr<SurgePyPreparedPatch> fromBytes(const char *d, size_t sz,
+                                                           const std::string &name)
+    {
+#pragma pack(push, 1)
+        struct fxChunkSetCustom
+        {
+            int chunkMagic; // 'CcnK'
+            int byteSize;   // of this chunk, excl. magic + byteSize
+
+            int fxMagic; // 'FPCh'
+            int version;
+            int fxID; // fx unique id
+            int fxVersion;
+
+            int numPrograms;
+            char prgName[28];
+
+            int chunkSize;
+        };
+#pragma pack(pop)
+
+        if (sz >= sizeof(fxChunkSetCustom) && !memcmp(d, "CcnK", 4))
+        {
+            auto fxp = (const fxChunkSetCustom *)d;
+
+            if ((mech::endian_read_int32BE(fxp->fxMagic) != 'FPCh') ||
+                (mech::endian_read_int32BE(fxp->fxID) != 'cjs3'))
+                throw std::invalid_argument(name + " is not a Surge XT patch");
+
+            auto cs = (size_t)mech::endian_read_int32BE(fxp->chunkSize);
+
+            if (cs > sz - sizeof(fxChunkSetCustom))
+                throw std::invalid_argument(name + " is truncated");
+
+            d += sizeof(fxChunkSetCustom);
+            sz = cs;
+        }
+
+        auto res = std::make_shared<SurgePyPreparedPatch>();
+        res->name = name;
+        res->chunk = std::make_shared<std::vector<char>>(d, d + sz);
+        res->xml = std::make_shared<TiXmlDocument>();
+
+        if (!SurgePatch::parse_patch_xml(res->chunk->data(), (int)sz, *res->xml))
+            throw std::invalid_argument(name + " does not contain a readable patch");
+
+        return res;
+    }
+
+    static std::shared_ptr<SurgePyPreparedPatch> fromPath(const std::string &path)
+    {
+        auto p = string_to_path(path);
+        std::ifstream f(p, std::ios::binary);
+
+        if (!f)
+            throw std::invalid_argument((std::string("File not found: ") + path).c_str());
+
+        std::vector<char> contents((std::istreambuf_iterator<char>(f)),
+                                   std::istreambuf_iterator<char>());
+        auto res = fromBytes(contents.data(), contents.size(), path_to_string(p.stem()));
+        res->path = path;
+
+        return res;
+    }
+};
+
 class SurgePyPatchConverter
 {
   public:
@@ -360,7 +457,9 @@ static std::unordered_map<modsources, SurgePyModSource> spysetup_msMap;
 class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
 {
   public:
-    explicit SurgeSynthesizerWithPythonExtensions(PluginLayer *sparent) : SurgeSynthesizer(sparent)
+    explicit SurgeSynthesizerWithPythonExtensions(PluginLayer *sparent,
+                                                  const SurgeStorage::SurgeStorageConfig &config)
+        : SurgeSynthesizer(sparent, config)
     {
         std::lock_guard<std::mutex> lg(spysetup_mutex);
         if (spysetup_cgMap.empty())
@@ -621,6 +720,29 @@ class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
         loadPatchByPath(s.c_str(), -1, "Python");
     }
 
+    /*
+     * Apply a prepared patch right now, on this thread: no file read, no xml parse and no trip
+     * through the patch load thread. Notes are stopped as for any load.
+     */
+    void loadPreparedPatch(const SurgePyPreparedPatch &p)
+    {
+        loadPatchFromChunk(p.chunk->data(), (int)p.chunk->size(), -1, p.name.c_str(), false,
+                           p.xml.get());
+    }
+
+    void loadPatchImmediate(const py::object &o)
+    {
+        if (py::isinstance<py::bytes>(o))
+        {
+            auto b = o.cast<std::string>();
+            loadPreparedPatch(*SurgePyPreparedPatch::fromBytes(b.data(), b.size(), "Python"));
+        }
+        else
+        {
+            loadPreparedPatch(o.cast<const SurgePyPreparedPatch &>());
+        }
+    }
+
     void savePatchPy(const std::string &s) { savePatchToPath(string_to_path(s)); }
 
     std::string factoryDataPath() const { return storage.datapath.u8string(); }
@@ -673,7 +795,218 @@ class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
         return res;
     }
 
-    void processMultiBlock(const py::array_t<float> &arr, int startBlock = 0, int nBlocks = -1)
+    /*
+     * Events for processMultiBlock, parsed from the Python tuples up front so the render
+     * itself can run without the GIL.
+     */
+    struct MultiBlockEvent
+    {
+        enum Type
+        {
+            NOTE_ON,
+            NOTE_OFF,
+            PITCH_BEND,
+            CONTROLLER,
+            PARAM
+        } type;
+        int64_t atSample;
+        int channel{0}, data1{0}, data2{0};
+        SurgeSynthesizer::ID param;
+        float value{0};
+    };
+
+    std::vector<MultiBlockEvent> parseMultiBlockEvents(const py::list &events)
+    {
+        std::vector<MultiBlockEvent> res;
+        res.reserve(events.size());
+
+        for (auto &e : events)
+        {
+            auto t = e.cast<py::tuple>();
+
+            if (t.size() < 3)
+                throw std::invalid_argument(
+                    "Each event must be a tuple of (sample, type, ...); see processMultiBlock");
+
+            MultiBlockEvent ev;
+            ev.atSample = t[0].cast<int64_t>();
+            auto type = t[1].cast<std::string>();
+
+            auto needs = [&](size_t n) {
+                if (t.size() != n)
+                {
+                    std::ostringstream oss;
+                    oss << "Event type '" << type << "' needs " << n << " entries; you provided "
+                        << t.size();
+                    throw std::invalid_argument(oss.str().c_str());
+                }
+            };
+
+            if (type == "note_on" || type == "note_off")
+            {
+                needs(5);
+                ev.type = type == "note_on" ? MultiBlockEvent::NOTE_ON : MultiBlockEvent::NOTE_OFF;
+                ev.channel = t[2].cast<int>();
+                ev.data1 = t[3].cast<int>();
+                ev.data2 = t[4].cast<int>();
+            }
+            else if (type == "pitch_bend")
+            {
+                needs(4);
+                ev.type = MultiBlockEvent::PITCH_BEND;
+                ev.channel = t[2].cast<int>();
+                ev.data1 = t[3].cast<int>();
+            }
+            else if (type == "cc")
+            {
+                needs(5);
+                ev.type = MultiBlockEvent::CONTROLLER;
+                ev.channel = t[2].cast<int>();
+                ev.data1 = t[3].cast<int>();
+                ev.data2 = t[4].cast<int>();
+            }
+            else if (type == "param")
+            {
+                needs(4);
+                ev.type = MultiBlockEvent::PARAM;
+                ev.param = t[2].cast<SurgePyNamedParam>().getID();
+                ev.value = t[3].cast<float>();
+            }
+            else
+            {
+                throw std::invalid_argument("Unknown event type '" + type +
+                                            "'; use note_on, note_off, pitch_bend, cc or param");
+            }
+
+            res.push_back(ev);
+        }
+
+        std::stable_sort(res.begin(), res.end(),
+                         [](auto &a, auto &b) { return a.atSample < b.atSample; });
+
+        return res;
+    }
+
+    void applyMultiBlockEvent(const MultiBlockEvent &ev)
+    {
+        // a run of note-ons plays as one batch (see queueNoteOn); anything else ends the run
+        if (ev.type != MultiBlockEvent::NOTE_ON)
+            flushNoteOns();
+
+        switch (ev.type)
+        {
+        case MultiBlockEvent::NOTE_ON:
+            queueNoteOn(ev.channel, ev.data1, ev.data2, 0);
+            break;
+        case MultiBlockEvent::NOTE_OFF:
+            releaseNote(ev.channel, ev.data1, ev.data2);
+            break;
+        case MultiBlockEvent::PITCH_BEND:
+            pitchBend(ev.channel, ev.data1);
+            break;
+        case MultiBlockEvent::CONTROLLER:
+            channelController(ev.channel, ev.data1, ev.data2);
+            break;
+        case MultiBlockEvent::PARAM:
+        {
+            auto p = storage.getPatch().param_ptr[ev.param.getSynthSideId()];
+            if (p)
+                setParameter01(ev.param, p->value_to_normalized(ev.value));
+        }
+        break;
+        }
+    }
+
+    /*
+     * An automation lane for processMultiBlock: one value, in the parameter's own units, per
+     * sample or per block rendered. The engine reads parameters once per block, so a per sample
+     * lane sets the value at the end of each block as the smoothing target and the control
+     * interpolator ramps through the block towards it, just as it does for MIDI learned
+     * controls. Only the first block jumps straight to the lane's first value.
+     */
+    struct MultiBlockAutomation
+    {
+        SurgeSynthesizer::ID id;
+        long synthId;
+        Parameter *param;
+        const char *data;
+        ptrdiff_t stride;
+        bool perSample;
+        py::array_t<float, py::array::forcecast> keepAlive;
+    };
+
+    std::vector<MultiBlockAutomation> parseMultiBlockAutomation(const py::list &automation,
+                                                                int blockIterations)
+    {
+        std::vector<MultiBlockAutomation> res;
+        res.reserve(automation.size());
+
+        if (automation.size() > num_controlinterpolators)
+        {
+            std::ostringstream oss;
+            oss << "At most " << num_controlinterpolators
+                << " parameters can be automated at once; you provided " << automation.size();
+            throw std::invalid_argument(oss.str().c_str());
+        }
+
+        for (auto &a : automation)
+        {
+            auto t = a.cast<py::tuple>();
+
+            if (t.size() != 2)
+                throw std::invalid_argument(
+                    "Each automation lane must be a tuple of (SurgeNamedParamId, values)");
+
+            MultiBlockAutomation lane;
+            lane.id = t[0].cast<SurgePyNamedParam>().getID();
+            lane.synthId = lane.id.getSynthSideId();
+            lane.param = storage.getPatch().param_ptr[lane.synthId];
+            lane.keepAlive = t[1].cast<py::array_t<float, py::array::forcecast>>();
+
+            auto info = lane.keepAlive.request();
+            auto n = blockIterations;
+            if (info.ndim != 1 || (info.shape[0] != n * BLOCK_SIZE && info.shape[0] != n))
+            {
+                std::ostringstream oss;
+                oss << "Automation values must be a 1 dimensional array of " << n * BLOCK_SIZE
+                    << " (per sample) or " << n << " (per block) entries";
+                throw std::invalid_argument(oss.str().c_str());
+            }
+
+            lane.data = static_cast<const char *>(info.ptr);
+            lane.stride = info.strides[0];
+            lane.perSample = info.shape[0] == n * BLOCK_SIZE;
+            res.push_back(std::move(lane));
+        }
+
+        return res;
+    }
+
+    void applyMultiBlockAutomation(const MultiBlockAutomation &lane, int block)
+    {
+        auto at = [&lane](int64_t i) { return *(const float *)(lane.data + i * lane.stride); };
+        auto p = lane.param;
+
+        if (block == 0)
+        {
+            setParameter01(lane.id, p->value_to_normalized(at(0)));
+            return;
+        }
+
+        auto v = p->value_to_normalized(
+            at(lane.perSample ? (int64_t)block * BLOCK_SIZE + BLOCK_SIZE - 1 : block));
+
+        // stepped parameters have side effects (oscillator types and so on) which only
+        // setParameter01 runs, and nothing to smooth anyway
+        if (p->valtype == vt_float)
+            setParameterSmoothed(lane.synthId, v);
+        else if (v != p->get_value_f01())
+            setParameter01(lane.id, v);
+    }
+
+    void processMultiBlock(const py::array_t<float> &arr, int startBlock = 0, int nBlocks = -1,
+                           const py::list &events = py::list(),
+                           const py::list &automation = py::list())
     {
         auto buf = arr.request(true);
 
@@ -731,19 +1064,73 @@ class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
             throw std::invalid_argument(oss.str().c_str());
         }
 
-        auto ptr = static_cast<float *>(buf.ptr);
-        float *dL = ptr + startBlock * BLOCK_SIZE;
-        float *dR = ptr + buf.shape[1] + startBlock * BLOCK_SIZE;
+        auto evs = parseMultiBlockEvents(events);
+        auto lanes = parseMultiBlockAutomation(automation, blockIterations);
+
+        /*
+         * The array can be any strided view (a slice, or the transpose of a (m, 2) array) and we
+         * write straight into it, so the caller never needs a contiguous copy. Nothing in
+         * renderMultiBlock touches Python, so other Python threads run while we render.
+         */
+        auto ptr = static_cast<char *>(buf.ptr);
+        auto rowStride = buf.strides[0], colStride = buf.strides[1];
+        char *dL = ptr + startBlock * BLOCK_SIZE * colStride;
+
+        py::gil_scoped_release release;
+
+        renderMultiBlock(dL, dL + rowStride, colStride, blockIterations, evs, lanes);
+    }
+
+    // No Python in here; see processMultiBlock
+    void renderMultiBlock(char *dL, char *dR, ptrdiff_t colStride, int blockIterations,
+                          const std::vector<MultiBlockEvent> &evs,
+                          const std::vector<MultiBlockAutomation> &lanes = {})
+    {
+        bool contiguous = colStride == sizeof(float);
+        size_t ev = 0;
 
         for (auto i = 0; i < blockIterations; ++i)
         {
+            int64_t blockStart = (int64_t)i * BLOCK_SIZE;
+
+            // automation first, so a param event in the same block has the last word
+            for (const auto &lane : lanes)
+                applyMultiBlockAutomation(lane, i);
+
+            // offsets are from the first block rendered; note ons start on their own sample
+            while (ev < evs.size() && evs[ev].atSample < blockStart + BLOCK_SIZE)
+            {
+                eventOffsetInBlock = (int)std::clamp<int64_t>(evs[ev].atSample - blockStart, 0,
+                                                              BLOCK_SIZE - 1);
+                applyMultiBlockEvent(evs[ev]);
+                ev++;
+            }
+            eventOffsetInBlock = 0;
+
             process();
-            memcpy((void *)dL, (void *)(output[0]), BLOCK_SIZE * sizeof(float));
-            memcpy((void *)dR, (void *)(output[1]), BLOCK_SIZE * sizeof(float));
 
-            dL += BLOCK_SIZE;
-            dR += BLOCK_SIZE;
+            if (contiguous)
+            {
+                memcpy((void *)dL, (void *)(output[0]), BLOCK_SIZE * sizeof(float));
+                memcpy((void *)dR, (void *)(output[1]), BLOCK_SIZE * sizeof(float));
+            }
+            else
+            {
+                for (int s = 0; s < BLOCK_SIZE; ++s)
+                {
+                    *(float *)(dL + s * colStride) = output[0][s];
+                    *(float *)(dR + s * colStride) = output[1][s];
+                }
+            }
+
+            dL += BLOCK_SIZE * colStride;
+            dR += BLOCK_SIZE * colStride;
         }
+
+        // anything after the last block still lands, as it would have with separate calls
+        while (ev < evs.size())
+            applyMultiBlockEvent(evs[ev++]);
+        flushNoteOns();
     }
 
     py::dict getPatchAsPy()
@@ -764,6 +1151,80 @@ class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
         return s;
     }
 
+    py::dict getProfilingStats()
+    {
+        auto res = py::dict();
+
+        for (int i = 0; i < Surge::Profiling::n_profile_sections; ++i)
+        {
+            auto sec = py::dict();
+            sec["load"] = blockProfiler.getLoad(i);
+            sec["peak"] = blockProfiler.getPeak(i);
+            res[py::str(Surge::Profiling::BlockProfiler::sectionName(i))] = sec;
+        }
+
+        res["total"] = blockProfiler.getTotalLoad();
+        res["blocks"] = blockProfiler.getBlocksProfiled();
+
+        return res;
+    }
+
+    py::list getLateBlocks()
+    {
+        auto res = py::list();
+
+        for (const auto &m : deadlineMonitor.getHistory())
+        {
+            auto d = py::dict();
+            d["sequence"] = m.sequence;
+            d["block"] = m.block;
+            d["load"] = m.load;
+            d["voices"] = m.voices;
+
+            auto fxl = py::dict();
+            for (int i = 0; i < n_fx_slots; ++i)
+                if (m.fxTypes[i] > fxt_off && m.fxTypes[i] < n_fx_types)
+                    fxl[py::str(fxslot_shortnames[i])] = py::str(fx_type_names[m.fxTypes[i]]);
+            d["fx"] = fxl;
+
+            d["patchLoad"] = (bool)(m.events & SurgeStorage::be_patchLoad);
+            d["wavetableLoad"] = (bool)(m.events & SurgeStorage::be_wavetableLoad);
+            d["formulaError"] = (bool)(m.events & SurgeStorage::be_formulaError);
+
+            if (m.topSection >= 0)
+            {
+                d["topSection"] = Surge::Profiling::BlockProfiler::sectionName(m.topSection);
+                d["topLoad"] = m.topLoad;
+            }
+            else
+            {
+                d["topSection"] = py::none();
+                d["topLoad"] = py::none();
+            }
+
+            d["description"] = m.describe();
+            res.append(d);
+        }
+
+        return res;
+    }
+
+    py::dict getMemoryFootprint()
+    {
+        auto res = py::dict();
+
+        for (const auto &s : SurgeSynthesizer::getMemoryFootprint().subsystems)
+        {
+            auto d = py::dict();
+            d["bytes"] = s.bytes;
+            d["shared"] = s.shared;
+            d["detail"] = s.detail;
+            res[py::str(s.name)] = d;
+        }
+
+        return res;
+    }
+
     py::dict getAllModRoutings()
     {
         auto res = py::dict();
@@ -892,17 +1353,378 @@ class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
     }
 };
 
-SurgeSynthesizer *createSurge(float sr)
+/*
+ * A minimal engine skips the work only the plugin needs at startup: it reads and writes no
+ * user defaults, makes no user directory, ignores the user MIDI defaults and leaves the patch
+ * and wavetable scans until something browses them. Patches loaded by path work as ever.
+ * voices sets the voice capacity per scene, with 0 meaning the user default or MAX_VOICES.
+ */
+SurgeSynthesizer *createSurge(float sr, bool minimal, int voices)
 {
     if (spysetup_parent == nullptr)
         spysetup_parent = std::make_unique<PythonPluginLayerProxy>();
-    auto surge = new SurgeSynthesizerWithPythonExtensions(spysetup_parent.get());
+    auto config = minimal ? SurgeStorage::SurgeStorageConfig::minimal()
+                          : SurgeStorage::SurgeStorageConfig::fromDataPath("");
+    config.voiceCapacity = voices;
+    auto surge = new SurgeSynthesizerWithPythonExtensions(spysetup_parent.get(), config);
     surge->setSamplerate(sr);
     surge->time_data.tempo = 120;
     surge->time_data.ppqPos = 0;
+    surge->stageEffectsInline = true;
     return surge;
 }
 
+/*
+ * A set of engines for rendering batches of jobs on native threads. Engines in one process
+ * already share the sinc tables, patch scans and built wavetables (see SharedStorageCore), so
+ * making K of them up front costs K sets of per engine state and nothing more. Each render
+ * hands the jobs out one at a time to one thread per engine, with the GIL released.
+ */
+class SurgePool
+{
+  public:
+    SurgePool(float sr, int nEngines, bool minimal, int voices)
+    {
+        if (nEngines <= 0)
+            nEngines = std::max(1u, std::thread::hardware_concurrency());
+
+        for (int i = 0; i < nEngines; ++i)
+            engines.emplace_back(static_cast<SurgeSynthesizerWithPythonExtensions *>(
+                createSurge(sr, minimal, voices)));
+    }
+
+    int size() const { return (int)engines.size(); }
+    float getSampleRate() const { return engines[0]->storage.samplerate; }
+
+    std::vector<py::array_t<float>> render(const py::list &jobs, std::optional<uint64_t> seed)
+    {
+        struct Job
+        {
+            std::string patch;
+            std::shared_ptr<SurgePyPreparedPatch> prepared;
+            std::vector<SurgeSynthesizerWithPythonExtensions::MultiBlockEvent> events;
+            int nBlocks{0};
+            float *out{nullptr};
+        };
+
+        std::vector<Job> parsed;
+        std::vector<py::array_t<float>> res;
+
+        for (auto &j : jobs)
+        {
+            auto t = j.cast<py::tuple>();
+
+            if (t.size() != 3)
+                throw std::invalid_argument(
+                    "Each job must be a tuple of (patchPath, events, nBlocks)");
+
+            Job job;
+            if (py::isinstance<SurgePyPreparedPatch>(t[0]))
+                job.prepared = t[0].cast<std::shared_ptr<SurgePyPreparedPatch>>();
+            else
+                job.patch = t[0].cast<std::string>();
+            job.events = engines[0]->parseMultiBlockEvents(t[1].cast<py::list>());
+            job.nBlocks = t[2].cast<int>();
+
+            if (!job.patch.empty() && !fs::exists(string_to_path(job.patch)))
+                throw std::invalid_argument((std::string("File not found: ") + job.patch).c_str());
+
+            if (job.nBlocks <= 0)
+                throw std::invalid_argument("nBlocks must be positive");
+
+            auto arr = py::array_t<float>({2, BLOCK_SIZE * job.nBlocks});
+            job.out = static_cast<float *>(arr.request(true).ptr);
+
+            res.push_back(arr);
+            parsed.push_back(std::move(job));
+        }
+
+        {
+            py::gil_scoped_release release;
+
+            std::atomic<int> next{0};
+            auto worker = [&](SurgeSynthesizerWithPythonExtensions *s) {
+                for (int j = next++; j < (int)parsed.size(); j = next++)
+                {
+                    auto &job = parsed[j];
+
+                    s->allNotesOff();
+
+                    // reseed per job, before the patch sets up its effects and LFOs, so a job
+                    // renders the same whichever engine picks it up and whatever ran before
+                    if (seed)
+                        s->setRandomSeed(*seed);
+
+                    if (job.prepared)
+                        s->loadPreparedPatch(*job.prepared);
+                    else if (!job.patch.empty())
+                        s->loadPatchByPath(job.patch.c_str(), -1, "Python");
+
+                    // let wavetables the patch loads in the background land before we start
+                    for (int w = 0; s->storage.wavetableLoader &&
+                                    s->storage.wavetableLoader->hasOutstandingLoads() && w < 10000;
+                         ++w)
+                    {
+                        s->process();
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+
+                    auto dL = reinterpret_cast<char *>(job.out);
+                    auto dR = reinterpret_cast<char *>(job.out + BLOCK_SIZE * job.nBlocks);
+                    s->renderMultiBlock(dL, dR, sizeof(float), job.nBlocks, job.events);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < engines.size() && i < parsed.size(); ++i)
+                threads.emplace_back(worker, engines[i].get());
+
+            worker(engines[0].get());
+
+            for (auto &t : threads)
+                t.join();
+        }
+
+        return res;
+    }
+
+  private:
+    std::vector<std::unique_ptr<SurgeSynthesizerWithPythonExtensions>> engines;
+};
+
+/*
+ * A render thread for interactive use, such as notebook audio widgets or a live rig driven from
+ * Python. The thread renders ahead into a ring of bufferBlocks blocks; Python sends events into
+ * a queue the thread drains before each block and reads the audio back out of the ring. Both
+ * rings have one writer and one reader and move on atomic counters, so neither side ever waits
+ * on the other to get at the data, and a slow or jittery Python side only ever costs it the
+ * headroom the ring holds. The condition variable just saves the two sides from polling.
+ *
+ * Event times are stream frames, counted from start; an event whose frame is already rendered
+ * plays at the start of the next block. While the stream runs it owns the engine, so nothing
+ * else may call into it (process, playNote and so on) until stop.
+ */
+class SurgeStream
+{
+  public:
+    using Event = SurgeSynthesizerWithPythonExtensions::MultiBlockEvent;
+
+    SurgeStream(SurgeSynthesizerWithPythonExtensions *s, int bufferBlocks, int eventCapacity)
+        : surge(s)
+    {
+        if (bufferBlocks < 2)
+            throw std::invalid_argument("bufferBlocks must be at least 2");
+
+        if (eventCapacity <= 0)
+            throw std::invalid_argument("eventCapacity must be positive");
+
+        capacity = (size_t)bufferBlocks * BLOCK_SIZE;
+        ring[0].resize(capacity);
+        ring[1].resize(capacity);
+        events.resize(eventCapacity);
+    }
+
+    ~SurgeStream() { stop(); }
+
+    void start()
+    {
+        if (renderThread.joinable())
+            return;
+
+        running = true;
+        renderThread = std::thread([this]() { render(); });
+    }
+
+    void stop()
+    {
+        if (!renderThread.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lg(wakeMutex);
+            running = false;
+        }
+        wake.notify_all();
+        renderThread.join();
+    }
+
+    bool isRunning() const { return renderThread.joinable(); }
+
+    void send(const py::list &evs)
+    {
+        auto parsed = surge->parseMultiBlockEvents(evs);
+        auto written = eventsWritten.load(std::memory_order_relaxed);
+        auto taken = eventsTaken.load(std::memory_order_acquire);
+
+        // all of the list or none of it, so a full queue never drops half a chord
+        if (written - taken + parsed.size() > events.size())
+        {
+            std::ostringstream oss;
+            oss << "The stream's event queue has room for " << events.size() - (written - taken)
+                << " events; you sent " << parsed.size();
+            throw std::runtime_error(oss.str().c_str());
+        }
+
+        for (auto &e : parsed)
+            events[written++ % events.size()] = e;
+
+        eventsWritten.store(written, std::memory_order_release);
+    }
+
+    size_t available() const
+    {
+        return framesWritten.load(std::memory_order_acquire) -
+               framesRead.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Reads nFrames of audio as a (2, nFrames) array. A blocking read releases the GIL and waits
+     * up to timeout seconds (forever if negative) for the frames, so it can run in an executor
+     * from asyncio. Whatever is still missing after that, or at once for a non blocking read,
+     * reads as silence and counts as an underrun.
+     */
+    py::array_t<float> read(int nFrames, bool blocking, double timeout)
+    {
+        if (nFrames < 0)
+            throw std::invalid_argument("nFrames must not be negative");
+
+        auto res = py::array_t<float>({2, nFrames});
+        auto out = static_cast<float *>(res.request(true).ptr);
+
+        {
+            py::gil_scoped_release release;
+
+            auto want = (size_t)nFrames;
+            auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(std::max(timeout, 0.0)));
+            size_t got = 0;
+
+            /*
+             * A read longer than the ring takes it in pieces. The render thread only writes
+             * whole blocks, so the ring need not ever fill completely; a block short of full is
+             * as much as a piece can count on.
+             */
+            while (got < want)
+            {
+                auto chunk = std::min(want - got, capacity - BLOCK_SIZE);
+
+                if (blocking && available() < chunk)
+                {
+                    auto enough = [&]() { return !running || available() >= chunk; };
+                    std::unique_lock<std::mutex> lk(wakeMutex);
+
+                    if (timeout < 0)
+                        wake.wait(lk, enough);
+                    else
+                        wake.wait_until(lk, deadline, enough);
+                }
+
+                auto from = framesRead.load(std::memory_order_relaxed);
+                auto n = std::min(available(), want - got);
+
+                if (n == 0)
+                    break;
+
+                for (size_t i = 0; i < n; ++i)
+                {
+                    auto at = (from + i) % capacity;
+                    out[got + i] = ring[0][at];
+                    out[want + got + i] = ring[1][at];
+                }
+
+                framesRead.store(from + n, std::memory_order_release);
+                wake.notify_all();
+                got += n;
+            }
+
+            if (got < want)
+            {
+                std::fill(out + got, out + want, 0.f);
+                std::fill(out + want + got, out + 2 * want, 0.f);
+                underruns++;
+            }
+        }
+
+        return res;
+    }
+
+    uint64_t getFramesRendered() const { return framesWritten.load(); }
+    uint64_t getFramesRead() const { return framesRead.load(); }
+    int getUnderruns() const { return underruns; }
+
+  private:
+    // No Python in here
+    void render()
+    {
+        while (running)
+        {
+            auto written = framesWritten.load(std::memory_order_relaxed);
+
+            if (written - framesRead.load(std::memory_order_acquire) + BLOCK_SIZE > capacity)
+            {
+                std::unique_lock<std::mutex> lk(wakeMutex);
+                wake.wait_for(lk, std::chrono::milliseconds(1), [&]() {
+                    return !running ||
+                           written - framesRead.load(std::memory_order_acquire) + BLOCK_SIZE <=
+                               capacity;
+                });
+                continue;
+            }
+
+            auto blockStart = (int64_t)written;
+            auto taken = eventsTaken.load(std::memory_order_relaxed);
+            auto avail = eventsWritten.load(std::memory_order_acquire);
+
+            while (taken < avail)
+            {
+                auto &ev = events[taken % events.size()];
+
+                if (ev.atSample >= blockStart + BLOCK_SIZE)
+                    break;
+
+                surge->eventOffsetInBlock =
+                    (int)std::clamp<int64_t>(ev.atSample - blockStart, 0, BLOCK_SIZE - 1);
+                surge->applyMultiBlockEvent(ev);
+                taken++;
+            }
+            surge->eventOffsetInBlock = 0;
+            eventsTaken.store(taken, std::memory_order_release);
+
+            surge->process();
+
+            // the capacity is whole blocks, so a block never wraps
+            auto at = written % capacity;
+            memcpy(&ring[0][at], surge->output[0], BLOCK_SIZE * sizeof(float));
+            memcpy(&ring[1][at], surge->output[1], BLOCK_SIZE * sizeof(float));
+
+            framesWritten.store(written + BLOCK_SIZE, std::memory_order_release);
+
+            // a reader between checking its predicate and sleeping holds the mutex, so passing
+            // through it here means the notify can't fall into that gap
+            {
+                std::lock_guard<std::mutex> lg(wakeMutex);
+            }
+            wake.notify_all();
+        }
+    }
+
+    SurgeSynthesizerWithPythonExtensions *surge;
+
+    size_t capacity{0};
+    std::vector<float> ring[2];
+    std::atomic<uint64_t> framesWritten{0}, framesRead{0};
+
+    std::vector<Event> events;
+    std::atomic<uint64_t> eventsWritten{0}, eventsTaken{0};
+
+    std::atomic<bool> running{false};
+    std::atomic<int> underruns{0};
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::thread renderThread;
+};
+
 // Prefix _ if using shared object within a Python package built with scikit-build
 #ifdef SKBUILD
 PYBIND11_MODULE(_surgepy, m)
@@ -911,9 +1733,93 @@ PYBIND11_MODULE(surgepy, m)
 #endif
 {
     m.doc() = "Python bindings for Surge XT Synthesizer";
-    m.def("createSurge", &createSurge, "Create a Surge XT instance", py::arg("sampleRate"));
+    m.def("createSurge", &createSurge,
+          "Create a Surge XT instance. With minimal=True the engine skips user defaults, the "
+          "user\ndirectory and the patch and wavetable scans, which suits batch rendering from "
+          "patch paths.\nvoices is how many voices per scene the engine allocates, up to "
+          "MAX_VOICES; 0 takes the\nvoiceCapacity user default.",
+          py::arg("sampleRate"), py::arg("minimal") = false, py::arg("voices") = 0);
+
+    py::class_<SurgePool>(m, "SurgePool")
+        .def(py::init<float, int, bool, int>(),
+             "Create a pool of Surge XT engines for batch rendering; nEngines of 0 means one per "
+             "hardware thread\nand minimal and voices create the engines as createSurge does",
+             py::arg("sampleRate"), py::arg("nEngines") = 0, py::arg("minimal") = false,
+             py::arg("voices") = 0)
+        .def("size", &SurgePool::size, "How many engines (and threads) the pool renders with")
+        .def("getSampleRate", &SurgePool::getSampleRate)
+        .def("render", &SurgePool::render,
+             "Render a list of (patchPath, events, nBlocks) jobs across the pool's engines, "
+             "returning one\n"
+             "(2, nBlocks*BLOCK_SIZE) numpy array per job, in order. An empty patchPath keeps "
+             "whatever patch\n"
+             "the engine which picks the job up has, and a SurgePreparedPatch is applied "
+             "without any file\n"
+             "access. events are as for processMultiBlock. With a seed, every job is rendered "
+             "from that seed\n"
+             "(see setRandomSeed), so identical jobs give identical output.",
+             py::arg("jobs"), py::arg("seed") = py::none());
+    py::class_<SurgeStream>(m, "SurgeStream")
+        .def("start", &SurgeStream::start, "Start the render thread")
+        .def("stop", &SurgeStream::stop,
+             "Stop the render thread, after which the engine may be used directly again")
+        .def("isRunning", &SurgeStream::isRunning)
+        .def("send", &SurgeStream::send,
+             "Queue a list of events for the render thread. Events are as for "
+             "processMultiBlock, with the
+"
+             "sample counted in stream frames from start; anything already rendered plays at "
+             "the next block.
+"
+             "Raises if the queue can't take the whole list.",
+             py::arg("events"))
+        .def("available", &SurgeStream::available, "How many rendered frames are ready to read")
+        .def("read", &SurgeStream::read,
+             "Read nFrames of audio as a (2, nFrames) numpy array. A blocking read waits, "
+             "without the GIL, up to
+"
+             "timeout seconds (forever if negative) for the frames, so from asyncio it can be "
+             "awaited through
+"
+             "asyncio.to_thread or run_in_executor. Frames still missing read as silence and "
+             "count as an underrun.",
+             py::arg("nFrames"), py::arg("blocking") = true, py::arg("timeout") = -1.0)
+        .def("getFramesRendered", &SurgeStream::getFramesRendered)
+        .def("getFramesRead", &SurgeStream::getFramesRead)
+        .def("getUnderruns", &SurgeStream::getUnderruns,
+             "How many reads came up short and were padded with silence")
+        .def("__enter__",
+             [](SurgeStream &s) -> SurgeStream & {
+                 s.start();
+                 return s;
+             })
+        .def("__exit__", [](SurgeStream &s, py::args) { s.stop(); });
+    py::class_<SurgePyPreparedPatch, std::shared_ptr<SurgePyPreparedPatch>>(m,
+                                                                          "SurgePreparedPatch")
+        .def("getName", &SurgePyPreparedPatch::getName)
+        .def("getPath", &SurgePyPreparedPatch::getPath)
+        .def("__repr__", &SurgePyPreparedPatch::toString);
+    m.def("preparePatch", &SurgePyPreparedPatch::fromPath,
+          "Read and parse an .fxp patch once, for loadPatchImmediate or SurgePool.render",
+          py::arg("path"));
+    m.def(
+        "preparePatches",
+        [](const std::vector<std::string> &paths) {
+            py::gil_scoped_release release;
+
+            std::vector<std::shared_ptr<SurgePyPreparedPatch>> res;
+            res.reserve(paths.size());
+            for (auto &p : paths)
+                res.push_back(SurgePyPreparedPatch::fromPath(p));
+            return res;
+        },
+        "preparePatch for each of a list of paths", py::arg("paths"));
     m.def(
         "getVersion", []() { return Surge::Build::FullVersionStr; }, "Get the version of Surge XT");
+    m.def(
+        "getBlockSize", []() { return BLOCK_SIZE; },
+        "Get the internal block size this module was built with (see SURGE_COMPILE_BLOCK_SIZE), "
+        "so a script can pick between builds before creating an instance");
     py::class_<SurgeSynthesizer::ID>(m, "SurgeSynthesizer_ID")
         .def(py::init<>())
         .def("getSynthSideId", &SurgeSynthesizer::ID::getSynthSideId)
@@ -982,6 +1888,19 @@ PYBIND11_MODULE(surgepy, m)
 
         .def("loadPatch", &SurgeSynthesizerWithPythonExtensions::loadPatchPy,
              "Load a Surge XT .fxp patch from the file system.", py::arg("path"))
+        .def("loadPatchImmediate", &SurgeSynthesizerWithPythonExtensions::loadPatchImmediate,
+             "Load a SurgePreparedPatch, or the bytes of an .fxp, synchronously and without "
+             "touching the\n"
+             "file system or reparsing the patch.",
+             py::arg("patch"))
+        .def("setRandomSeed", &SurgeSynthesizer::setRandomSeed,
+             "Derive every random source (drift, noise, S&H, random LFOs and modulators, "
+             "effects) from this\n"
+             "seed, so the same calls always render the same output. Seed before loading the "
+             "patch.",
+             py::arg("seed"))
+        .def("clearRandomSeed", &SurgeSynthesizer::clearRandomSeed,
+             "Go back to unseeded random sources for voices started from now on")
         .def("savePatch", &SurgeSynthesizerWithPythonExtensions::savePatchPy,
              "Save the current state of Surge XT to an .fxp file.", py::arg("path"))
 
@@ -1010,6 +1929,72 @@ PYBIND11_MODULE(surgepy, m)
 
         .def("process", &SurgeSynthesizer::process,
              "Run Surge XT for one block and update the internal output buffer.")
+        .def(
+            "setProfilingEnabled",
+            [](SurgeSynthesizerWithPythonExtensions &s, bool b) { s.blockProfiler.setEnabled(b); },
+            "Turn the per-block CPU profiler on or off.", py::arg("enabled"))
+        .def("getProfilingStats", &SurgeSynthesizerWithPythonExtensions::getProfilingStats,
+             "Get the smoothed and peak load of each part of the block, as a fraction of the "
+             "block's deadline.")
+        .def(
+            "setTracingEnabled",
+            [](SurgeSynthesizerWithPythonExtensions &s, bool b) { s.traceRecorder.setEnabled(b); },
+            "Turn the engine trace recorder on or off. Engine scopes are only recorded in a "
+            "build with SURGE_BUILD_WITH_TRACING; see isTracingCompiledIn.",
+            py::arg("enabled"))
+        .def_static(
+            "isTracingCompiledIn",
+            []() { return Surge::Profiling::TraceRecorder::isCompiledIn(); },
+            "Whether this build records the engine's block, scene, voice and FX scopes.")
+        .def(
+            "clearTrace", [](SurgeSynthesizerWithPythonExtensions &s) { s.traceRecorder.clear(); },
+            "Drop everything the trace recorder holds.")
+        .def(
+            "writeTrace",
+            [](SurgeSynthesizerWithPythonExtensions &s, const std::string &path) {
+                return s.traceRecorder.writeChromeTrace(path);
+            },
+            "Write the recorded trace as Chrome trace JSON, which chrome://tracing and "
+            "ui.perfetto.dev open. Returns False if the file can't be written.",
+            py::arg("path"))
+        .def(
+            "setLateBlockThreshold",
+            [](SurgeSynthesizerWithPythonExtensions &s, float t) {
+                s.deadlineMonitor.setThreshold(t);
+            },
+            "Blocks which take longer than this fraction of their deadline are remembered as "
+            "late.",
+            py::arg("threshold"))
+        .def(
+            "getLateBlockCount",
+            [](SurgeSynthesizerWithPythonExtensions &s) {
+                return s.deadlineMonitor.getMissCount();
+            },
+            "How many blocks have been late since the last clearLateBlocks.")
+        .def("getLateBlocks", &SurgeSynthesizerWithPythonExtensions::getLateBlocks,
+             "The most recent late blocks, oldest first, with what the engine was doing at the "
+             "time. The costliest section is only known while the profiler is on.")
+        .def(
+            "clearLateBlocks",
+            [](SurgeSynthesizerWithPythonExtensions &s) { s.deadlineMonitor.clear(); },
+            "Forget the late blocks seen so far.")
+        .def(
+            "setLateBlockLog",
+            [](SurgeSynthesizerWithPythonExtensions &s, const std::string &path) {
+                return s.deadlineMonitor.setLogFile(path);
+            },
+            "Append each late block to this file as it happens; an empty path stops. Returns "
+            "False if the file can't be opened.",
+            py::arg("path"))
+        .def("getMemoryFootprint", &SurgeSynthesizerWithPythonExtensions::getMemoryFootprint,
+             "What this instance holds in memory, as a dict from subsystem to its bytes, whether "
+             "it is shared with other instances, and what it covers.")
+        .def(
+            "getMemoryTotal",
+            [](SurgeSynthesizerWithPythonExtensions &s) {
+                return s.SurgeSynthesizer::getMemoryFootprint().total();
+            },
+            "The bytes this instance holds on its own, leaving out anything shared.")
         .def("getOutput", &SurgeSynthesizerWithPythonExtensions::getOutput,
              "Retrieve the internal output buffer as a 2 * BLOCK_SIZE numpy array.")
 
@@ -1020,8 +2005,36 @@ PYBIND11_MODULE(surgepy, m)
         .def("processMultiBlock", &SurgeSynthesizerWithPythonExtensions::processMultiBlock,
              "Run the Surge XT engine for multiple blocks, updating the value in the numpy array. "
              "Either populate the\n"
-             "entire array, or starting at startBlock position in the output, populate nBlocks.",
-             py::arg("val"), py::arg("startBlock") = 0, py::arg("nBlocks") = -1)
+             "entire array, or starting at startBlock position in the output, populate nBlocks.\n"
+             "The array may be any strided (2, m*BLOCK_SIZE) float32 view, and is written in "
+             "place. The GIL is released while rendering.\n"
+             "events is an optional list of tuples, each starting with a sample offset from the "
+             "first block rendered:\n"
+             "  (sample, 'note_on', channel, note, velocity), (sample, 'note_off', channel, note, "
+             "velocity),\n"
+             "  (sample, 'pitch_bend', channel, bend), (sample, 'cc', channel, cc, value),\n"
+             "  (sample, 'param', SurgeNamedParamId, value)\n"
+             "automation is an optional list of (SurgeNamedParamId, values) tuples, values being "
+             "a 1D numpy array in\n"
+             "the parameter's units with one entry per sample or per block rendered. Values are "
+             "applied once per\n"
+             "block through the engine's parameter smoothing, as MIDI learned controls are.",
+             py::arg("val"), py::arg("startBlock") = 0, py::arg("nBlocks") = -1,
+             py::arg("events") = py::list(), py::arg("automation") = py::list())
+
+        .def(
+            "createStream",
+            [](SurgeSynthesizerWithPythonExtensions *s, int bufferBlocks, int eventCapacity) {
+                return std::make_unique<SurgeStream>(s, bufferBlocks, eventCapacity);
+            },
+            "Create a SurgeStream, which renders this engine on a native thread into a ring of "
+            "bufferBlocks blocks
+"
+            "for Python to read from. Start it with start() or a with block; while it runs, "
+            "drive the engine only
+"
+            "through the stream.",
+            py::arg("bufferBlocks") = 64, py::arg("eventCapacity") = 1024, py::keep_alive<0, 1>())
 
         .def("getPatch", &SurgeSynthesizerWithPythonExtensions::getPatchAsPy,
              "Get a Python dictionary with the Surge XT parameters laid out in the logical patch "
@@ -27,6 +27,41 @@ def test_render_note():
     assert not np.all(buf == 0.0)
 
 
+def test_render_events_into_strided_view():
+    """
+    Test rendering a phrase from an event list straight into a transposed view.
+    """
+    s = surgepy.createSurge(44100)
+    bs = s.getBlockSize()
+    n_blocks = 64
+    out = np.zeros((n_blocks * bs, 2), dtype=np.float32)
+    events = [
+        (3 * bs + 5, "note_on", 0, 60, 127),
+        (40 * bs, "note_off", 0, 60, 0),
+    ]
+    s.processMultiBlock(out.T, events=events)
+    assert np.all(out[: 3 * bs + 5] == 0.0)
+    assert not np.all(out == 0.0)
+
+
+def test_render_with_automation():
+    """
+    Test that a per sample automation lane drives a parameter across a render.
+    """
+    s = surgepy.createSurge(44100)
+    bs = s.getBlockSize()
+    n_blocks = 128
+    vol = s.getPatch()["volume"]
+    ramp = np.linspace(s.getParamMin(vol), s.getParamMax(vol), n_blocks * bs)
+    buf = s.createMultiBlock(n_blocks)
+    s.processMultiBlock(
+        buf, events=[(0, "note_on", 0, 60, 127)], automation=[(vol, ramp)]
+    )
+    quarter = n_blocks * bs // 4
+    assert np.abs(buf[:, quarter : 2 * quarter]).max() < np.abs(buf[:, -quarter:]).max()
+    assert abs(s.getParamVal(vol) - ramp[-1]) < 0.1 * (ramp[-1] - ramp[0])
+
+
 def test_default_mpeEnabled():
     """
     Test that mpeEnabled flag is False by default.
@@ -53,3 +88,66 @@ def test_set_tuningApplicationMode():
     s = surgepy.createSurge(44100)
     s.tuningApplicationMode = surgepy.TuningApplicationMode.RETUNE_ALL
     assert s.tuningApplicationMode == surgepy.TuningApplicationMode.RETUNE_ALL
+
+
+def test_pool_render():
+    """
+    Test rendering a batch of jobs across a pool of engines.
+    """
+    pool = surgepy.SurgePool(44100, 2)
+    assert pool.size() == 2
+    bs = surgepy.getBlockSize()
+    jobs = [("", [(0, "note_on", 0, 48 + 12 * i, 127)], 32) for i in range(4)]
+    outs = pool.render(jobs)
+    assert len(outs) == 4
+    for o in outs:
+        assert o.shape == (2, 32 * bs)
+        assert not np.all(o == 0.0)
+
+
+def test_prepared_patch_roundtrip(tmp_path):
+    """
+    Test that a saved patch prepares and loads immediately, from the handle and from bytes.
+    """
+    s = surgepy.createSurge(44100)
+    path = str(tmp_path / "prepared.fxp")
+    s.savePatch(path)
+    p = surgepy.preparePatch(path)
+    assert p.getName() == "prepared"
+    s.loadPatchImmediate(p)
+    with open(path, "rb") as f:
+        s.loadPatchImmediate(f.read())
+    pool = surgepy.SurgePool(44100, 2)
+    outs = pool.render([(p, [(0, "note_on", 0, 60, 127)], 16)] * 2)
+    for o in outs:
+        assert o.shape == (2, 16 * surgepy.getBlockSize())
+        assert not np.all(o == 0.0)
+
+
+def test_seeded_pool_render():
+    """
+    Test that seeded renders of the same job are identical whichever engine renders them.
+    """
+    pool = surgepy.SurgePool(44100, 2)
+    jobs = [("", [(0, "note_on", 0, 60, 127)], 32)] * 4
+    outs = pool.render(jobs, seed=42)
+    for o in outs[1:]:
+        assert np.array_equal(o, outs[0])
+
+
+def test_stream_render():
+    """
+    Test that a stream renders events sent to it on its own thread.
+    """
+    s = surgepy.createSurge(44100)
+    bs = s.getBlockSize()
+    with s.createStream(bufferBlocks=16) as stream:
+        stream.send([(0, "note_on", 0, 60, 127)])
+        out = stream.read(64 * bs)
+        assert out.shape == (2, 64 * bs)
+        assert not np.all(out == 0.0)
+        stream.send([(stream.getFramesRendered(), "note_off", 0, 60, 0)])
+        stream.read(bs, timeout=5.0)
+    assert not stream.isRunning()
+    assert stream.getFramesRead() == 65 * bs
+    assert stream.getUnderruns() == 0
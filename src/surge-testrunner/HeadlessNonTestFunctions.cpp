@@ -21,11 +21,17 @@
  */
 #include "HeadlessUtils.h"
 #include "Player.h"
+#include "SIMDDotProducts.h"
 #include "filesystem/import.h"
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
 
 namespace Surge
 {
@@ -146,6 +152,68 @@ void statsFromPlayingEveryPatch()
     Surge::Headless::playOnEveryPatch(surge, scale, callBack);
 }
 
+void renderEveryPatch(const std::string &outDir, int nThreads)
+{
+    /*
+     * Render a small grid of notes and velocities on every factory patch across nThreads
+     * engines, writing each render as interleaved stereo raw floats at 48k.
+     */
+    static constexpr int sr = 48000;
+    auto notes = {36, 48, 60, 72, 84};
+    auto velocities = {64, 127};
+
+    std::vector<Surge::Headless::playerEvents_t> sets;
+    std::vector<std::string> setNames;
+
+    for (auto n : notes)
+    {
+        for (auto v : velocities)
+        {
+            auto events = Surge::Headless::makeHoldNoteFor(n, sr, sr);
+            events[0].data2 = v;
+            sets.push_back(events);
+            setNames.push_back("n" + std::to_string(n) + "_v" + std::to_string(v));
+        }
+    }
+
+    if (nThreads <= 0)
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto dir = string_to_path(outDir);
+    fs::create_directories(dir);
+
+    auto safeName = [](std::string s) {
+        for (auto &c : s)
+            if (!isalnum((unsigned char)c) && c != '-' && c != '_')
+                c = '_';
+        return s;
+    };
+
+    std::mutex coutMutex;
+    std::atomic<int> done{0};
+    auto start = std::chrono::steady_clock::now();
+
+    auto callBack = [&](const Patch &p, const PatchCategory &pc, int es, const float *data,
+                        int nSamples, int nChannels) {
+        auto fn = dir / (safeName(pc.name) + "__" + safeName(p.name) + "__" + setNames[es] +
+                         ".f32");
+        std::ofstream ofs(fn, std::ios::binary);
+        ofs.write((const char *)data, sizeof(float) * nSamples * nChannels);
+
+        std::lock_guard<std::mutex> g(coutMutex);
+        std::cout << path_to_string(fn) << std::endl;
+        done++;
+    };
+
+    Surge::Headless::playOnEveryPatchInParallel(
+        []() { return Surge::Headless::createSurge(sr, true); }, nThreads, sets, callBack);
+
+    auto secs =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "# Rendered " << done << " files on " << nThreads << " threads in " << secs
+              << "s" << std::endl;
+}
+
 void standardCutoffCurve(int ft, int sft, std::ostream &os)
 {
     /*
@@ -743,6 +811,61 @@ void generateNLFeedbackNorms()
               << "      if (useNormalization) normNumerator = lpNormTable[subtype];\n";
 }
 
+void simdKernels()
+{
+    /*
+     * Times the dot product kernels in SIMDDotProducts.h against the portable SSE versions,
+     * which on ARM is the simde translation. On x86 both columns run the same code.
+     */
+#if SURGE_NATIVE_NEON_KERNELS
+    std::cout << "# native NEON kernels against simde" << std::endl;
+#else
+    std::cout << "# no native kernels on this target; both columns are SSE" << std::endl;
+#endif
+
+    constexpr int n = 4096, iterations = 20000;
+    alignas(16) short ia[n + 64], ib[n + 64];
+    alignas(16) float fa[n + 64], fb[n + 64];
+    for (int i = 0; i < n + 64; ++i)
+    {
+        ia[i] = (short)(rand() % 65536 - 32768);
+        ib[i] = (short)(rand() % 65536 - 32768);
+        fa[i] = (float)rand() / (float)RAND_MAX - 0.5f;
+        fb[i] = (float)rand() / (float)RAND_MAX - 0.5f;
+    }
+
+    auto time = [&](const char *name, auto portable, auto native) {
+        double sink = 0;
+        auto run = [&](auto f) {
+            auto start = std::chrono::steady_clock::now();
+            for (int it = 0; it < iterations; ++it)
+                for (int i = 0; i < n; i += 64)
+                    sink += f(i + (it & 7));
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() -
+                                                            start)
+                       .count() /
+                   (iterations * (n / 64));
+        };
+        auto tp = run(portable), tn = run(native);
+        std::cout << name << " portable=" << tp << "ns native=" << tn << "ns ratio=" << tp / tn
+                  << " (" << sink << ")" << std::endl;
+    };
+
+    namespace sd = Surge::DSP;
+    time(
+        "dotI16x8 x8", [&](int o) { return sd::Portable::dotI16x8(ia + o, ib + o); },
+        [&](int o) { return sd::dotI16x8(ia + o, ib + o); });
+    time(
+        "dotI16 64", [&](int o) { return sd::Portable::dotI16(ia + o, ib + o, 64); },
+        [&](int o) { return sd::dotI16(ia + o, ib + o, 64); });
+    time(
+        "dotF32 64", [&](int o) { return sd::Portable::dotF32(fa + o, fb + o, 64); },
+        [&](int o) { return sd::dotF32(fa + o, fb + o, 64); });
+    time(
+        "hsumF32", [&](int o) { return sd::Portable::hsumF32(_mm_loadu_ps(fa + o)); },
+        [&](int o) { return sd::hsumF32(_mm_loadu_ps(fa + o)); });
+}
+
 } // namespace NonTest
 } // namespace Headless
 } // namespace Surge
@@ -35,6 +35,8 @@ void statsFromPlayingEveryPatch();
 void filterAnalyzer(int ft, int fst, std::ostream &os);
 void generateNLFeedbackNorms();
 [[noreturn]] void performancePlay(const std::string &patchName, int mode);
+void renderEveryPatch(const std::string &outDir, int nThreads);
+void simdKernels();
 } // namespace NonTest
 } // namespace Headless
 } // namespace Surge
@@ -30,34 +30,51 @@ namespace Surge
 namespace Headless
 {
 static std::unique_ptr<HeadlessPluginLayerProxy> parent = nullptr;
-std::shared_ptr<SurgeSynthesizer> createSurge(int sr, bool loadAllPatches)
-{
-    if (parent.get() == nullptr)
-        parent.reset(new HeadlessPluginLayerProxy());
 
-    std::string defaultPath = "";
-    if (loadAllPatches)
+static std::string localDataPath()
+{
+    try
     {
-        try
-        {
-            auto pt = fs::path{"resources/data/patches_factory"};
-            if (fs::exists(pt) && fs::is_directory(pt))
-            {
-                defaultPath = "resources/data";
-            }
-        }
-        catch (const fs::filesystem_error &)
+        auto pt = fs::path{"resources/data/patches_factory"};
+        if (fs::exists(pt) && fs::is_directory(pt))
         {
+            return "resources/data";
         }
     }
-    auto surge = std::shared_ptr<SurgeSynthesizer>(new SurgeSynthesizer(
-        parent.get(), loadAllPatches ? defaultPath : SurgeStorage::skipPatchLoadDataPathSentinel));
+    catch (const fs::filesystem_error &)
+    {
+    }
+    return "";
+}
+
+static std::shared_ptr<SurgeSynthesizer>
+createSurgeFromConfig(int sr, const SurgeStorage::SurgeStorageConfig &config)
+{
+    if (parent.get() == nullptr)
+        parent.reset(new HeadlessPluginLayerProxy());
+
+    auto surge = std::shared_ptr<SurgeSynthesizer>(new SurgeSynthesizer(parent.get(), config));
     surge->setSamplerate(sr);
     surge->time_data.tempo = 120;
     surge->time_data.ppqPos = 0;
+    surge->stageEffectsInline = true;
     return surge;
 }
 
+std::shared_ptr<SurgeSynthesizer> createSurge(int sr, bool loadAllPatches)
+{
+    return createSurgeFromConfig(
+        sr, SurgeStorage::SurgeStorageConfig::fromDataPath(
+                loadAllPatches ? localDataPath() : SurgeStorage::skipPatchLoadDataPathSentinel));
+}
+
+std::shared_ptr<SurgeSynthesizer> createMinimalSurge(int sr, int voiceCapacity)
+{
+    auto config = SurgeStorage::SurgeStorageConfig::minimal(localDataPath());
+    config.voiceCapacity = voiceCapacity;
+    return createSurgeFromConfig(sr, config);
+}
+
 void writeToStream(const float *data, int nSamples, int nChannels, std::ostream &str)
 {
     int overSample = 8;
@@ -31,6 +31,13 @@ namespace Headless
 
 std::shared_ptr<SurgeSynthesizer> createSurge(int sr, bool loadAllPatches = false);
 
+/*
+** A surge which reads no user defaults, makes no user directory and defers the patch and
+** wavetable scans until something asks to browse them. Patches still load by path. A
+** voiceCapacity of 0 gives MAX_VOICES voices per scene.
+*/
+std::shared_ptr<SurgeSynthesizer> createMinimalSurge(int sr, int voiceCapacity = 0);
+
 void writeToStream(const float *data, int nSamples, int nChannels, std::ostream &str);
 
 /*
@@ -21,6 +21,9 @@
  */
 #include "Player.h"
 
+#include <atomic>
+#include <thread>
+
 namespace Surge
 {
 namespace Headless
@@ -171,7 +174,7 @@ void playOnEveryPatch(std::shared_ptr<SurgeSynthesizer> surge, const playerEvent
                 float *data = NULL;
                 int nSamples, nChannels;
 
-                playOnPatch(surge, i, events, &data, &nSamples, &nChannels);
+                playOnPatch(surge, idx, events, &data, &nSamples, &nChannels);
                 cb(p, pc, data, nSamples, nChannels);
 
                 if (data)
@@ -207,5 +210,51 @@ void playOnNRandomPatches(std::shared_ptr<SurgeSynthesizer> surge, const playerE
     }
 }
 
+void playOnEveryPatchInParallel(
+    std::function<std::shared_ptr<SurgeSynthesizer>()> makeSurge, int nThreads,
+    const std::vector<playerEvents_t> &eventSets,
+    std::function<void(const Patch &p, const PatchCategory &c, int eventSet, const float *data,
+                       int nSamples, int nChannels)>
+        cb)
+{
+    if (eventSets.empty() || nThreads < 1)
+        return;
+
+    std::vector<std::shared_ptr<SurgeSynthesizer>> surges;
+    for (int t = 0; t < nThreads; ++t)
+        surges.push_back(makeSurge());
+
+    int nPresets = surges[0]->storage.patch_list.size();
+    int nJobs = nPresets * eventSets.size();
+    std::atomic<int> next{0};
+
+    auto worker = [&](std::shared_ptr<SurgeSynthesizer> surge) {
+        for (int j = next++; j < nJobs; j = next++)
+        {
+            int idx = j / eventSets.size(), es = j % eventSets.size();
+            Patch p = surge->storage.patch_list[idx];
+            PatchCategory pc = surge->storage.patch_category[p.category];
+
+            float *data = NULL;
+            int nSamples, nChannels;
+
+            playOnPatch(surge, idx, eventSets[es], &data, &nSamples, &nChannels);
+            cb(p, pc, es, data, nSamples, nChannels);
+
+            if (data)
+                delete[] data;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < nThreads; ++t)
+        threads.emplace_back(worker, surges[t]);
+
+    worker(surges[0]);
+
+    for (auto &t : threads)
+        t.join();
+}
+
 } // namespace Headless
 } // namespace Surge
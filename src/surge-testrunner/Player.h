@@ -112,6 +112,25 @@ void playOnNRandomPatches(std::shared_ptr<SurgeSynthesizer> synth, const playerE
                                              const float *data, int nSamples, int nChannels)>
                               completedCallback);
 
+/**
+ * playOnEveryPatchInParallel
+ *
+ * Play each of the event sets on every patch, sharding the (patch, event set) pairs across
+ * one engine per thread. Each engine comes from makeSurge, which is called up front on the
+ * calling thread; engines made by createSurge share the sinc tables, patch scans and built
+ * wavetables, so only the per engine state is duplicated. Pairs are handed out one at a time,
+ * so a slow patch doesn't hold the rest of its shard up.
+ *
+ * The callback is called from the worker threads, in no particular order, with the index of
+ * the event set played.
+ */
+void playOnEveryPatchInParallel(
+    std::function<std::shared_ptr<SurgeSynthesizer>()> makeSurge, int nThreads,
+    const std::vector<playerEvents_t> &eventSets,
+    std::function<void(const Patch &p, const PatchCategory &c, int eventSet, const float *data,
+                       int nSamples, int nChannels)>
+        completedCallback);
+
 } // namespace Headless
 } // namespace Surge
 
@@ -21,6 +21,7 @@
  */
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -30,8 +31,18 @@
 #include "UnitTestUtilities.h"
 
 #include "samplerate.h"
+#include "SurgeMemoryPools.h"
+#include "OscillatorCommonFunctions.h"
 
 #include "SSEComplex.h"
+#include "PartitionedConvolver.h"
+#include "PolyphaseResampler.h"
+#include "SIMDDotProducts.h"
+#include "portable_intrinsics.h"
+#include "RenderWorkerPool.h"
+#include "NoteRenderCache.h"
+#include "TableWaveshapers.h"
+#include <thread>
 #include <complex>
 #include "sst/basic-blocks/mechanics/simd-ops.h"
 
@@ -725,4 +736,953 @@ TEST_CASE("Don't Fear The Reaper", "[dsp]")
             }
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Alias Unison Lanes Match A Single Voice", "[dsp]")
+{
+    // With no detune and retriggered phases every unison voice plays the same wave, so five
+    // voices (a full lane group and a partial one) have to be one voice scaled by the mix
+    auto render = [](int unison) {
+        auto surge = Surge::Headless::createSurge(44100);
+        auto &scene = surge->storage.getPatch().scene[0];
+        auto &osc = scene.osc[0];
+        osc.queue_type = ot_alias;
+
+        // only this oscillator sounds, and everything after it is linear
+        scene.mute_o2.val.b = true;
+        scene.mute_o3.val.b = true;
+        scene.mute_noise.val.b = true;
+        scene.filterunit[0].type.deactivated = true;
+        scene.filterunit[1].type.deactivated = true;
+        scene.wsunit.type.deactivated = true;
+
+        for (int q = 0; q < 10; ++q)
+            surge->process();
+
+        osc.retrigger.val.b = true;
+        for (auto &p : osc.p)
+        {
+            if (p.ctrltype == ct_osccount)
+                p.val.i = unison;
+            if (p.ctrltype == ct_oscspread)
+                p.val.f = 0.f;
+        }
+
+        surge->playNote(0, 60, 127, 0);
+
+        std::vector<float> res;
+        for (int b = 0; b < 64; ++b)
+        {
+            surge->process();
+            res.insert(res.end(), surge->output[0], surge->output[0] + BLOCK_SIZE);
+        }
+        return res;
+    };
+
+    auto one = render(1), five = render(5);
+    REQUIRE(one.size() == five.size());
+
+    size_t peak = 0;
+    for (size_t i = 0; i < one.size(); ++i)
+        if (fabs(one[i]) > fabs(one[peak]))
+            peak = i;
+
+    REQUIRE(fabs(one[peak]) > 0.01);
+    auto ratio = five[peak] / one[peak];
+
+    for (size_t i = 0; i < one.size(); ++i)
+    {
+        INFO("Sample " << i);
+        REQUIRE(five[i] == Approx(one[i] * ratio).margin(1e-4));
+    }
+}
+
+TEST_CASE("Scenes Render In Parallel", "[dsp]")
+{
+    auto render = [](bool parallel) {
+        auto surge = Surge::Headless::createSurge(44100, true);
+        REQUIRE(surge);
+
+        surge->setRandomSeed(2023);
+        surge->setRenderScenesInParallel(parallel);
+        REQUIRE(surge->getRenderScenesInParallel() == parallel);
+
+        surge->storage.getPatch().scenemode.val.i = sm_dual;
+
+        for (int q = 0; q < 10; ++q)
+            surge->process();
+
+        surge->playNote(0, 60, 127, 0);
+        surge->playNote(0, 64, 127, 0);
+
+        std::vector<float> out;
+        auto run = [&](int blocks) {
+            for (int q = 0; q < blocks; ++q)
+            {
+                REQUIRE(surge->canRenderScenesInParallel());
+                surge->process();
+                out.insert(out.end(), surge->output[0], surge->output[0] + BLOCK_SIZE);
+                out.insert(out.end(), surge->output[1], surge->output[1] + BLOCK_SIZE);
+            }
+        };
+
+        run(100);
+        REQUIRE(surge->voices[0].size() == 2);
+        REQUIRE(surge->voices[1].size() == 2);
+
+        surge->releaseNote(0, 60, 0);
+        surge->releaseNote(0, 64, 0);
+        run(2000);
+
+        REQUIRE(surge->voices[0].empty());
+        REQUIRE(surge->voices[1].empty());
+
+        surge->setRenderScenesInParallel(false);
+        REQUIRE(!surge->getRenderScenesInParallel());
+
+        return out;
+    };
+
+    auto serial = render(false);
+    REQUIRE(std::all_of(serial.begin(), serial.end(), [](auto f) { return std::isfinite(f); }));
+    REQUIRE(std::any_of(serial.begin(), serial.end(), [](auto f) { return f != 0.f; }));
+
+    // the same patch and notes, sample for sample, whichever thread renders each scene
+    auto parallel = render(true);
+    REQUIRE(parallel.size() == serial.size());
+    REQUIRE(memcmp(parallel.data(), serial.data(), serial.size() * sizeof(float)) == 0);
+}
+
+TEST_CASE("Scenes Render On A Host Executor", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge);
+
+    // stand in for a host thread pool: run the round from a couple of threads of our own
+    static std::atomic<int> rounds{0};
+    rounds = 0;
+    auto exec = [](void *, Surge::Threading::RenderWorkerPool *pool, int n) {
+        std::thread a([pool]() { pool->runPending(); }), b([pool]() { pool->runPending(); });
+        a.join();
+        b.join();
+        rounds++;
+        return true;
+    };
+
+    surge->setRenderScenesInParallel(true);
+    surge->setRenderExecutor(exec, nullptr);
+    REQUIRE(surge->getRenderScenesInParallel());
+    REQUIRE(surge->sceneRenderPool->numWorkers() == 0);
+
+    surge->storage.getPatch().scenemode.val.i = sm_dual;
+
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    surge->playNote(0, 60, 127, 0);
+
+    float sumAbsOut = 0;
+    for (int q = 0; q < 100; ++q)
+    {
+        REQUIRE(surge->canRenderScenesInParallel());
+        surge->process();
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+            sumAbsOut += fabs(surge->output[0][s]);
+    }
+    REQUIRE(sumAbsOut > 1);
+    REQUIRE(rounds > 0);
+
+    surge->setRenderExecutor(nullptr, nullptr);
+    REQUIRE(surge->sceneRenderPool->numWorkers() == n_scenes - 1);
+}
+
+TEST_CASE("Seeded Renders Are Repeatable At Any Thread Count", "[dsp]")
+{
+    auto render = [](uint64_t seed, bool parallel) {
+        auto surge = Surge::Headless::createSurge(44100, true);
+        REQUIRE(surge);
+
+        surge->setRandomSeed(seed);
+        surge->setRenderScenesInParallel(parallel);
+        surge->setRenderFXInParallel(parallel);
+
+        auto &patch = surge->storage.getPatch();
+        patch.scenemode.val.i = sm_dual;
+
+        // noise and drift in both scenes, so both draw from the generators every block
+        for (int s = 0; s < n_scenes; ++s)
+        {
+            patch.scene[s].level_noise.val.f = 0.f;
+            patch.scene[s].mute_noise.val.b = false;
+            patch.scene[s].drift.val.f = 1.f;
+        }
+
+        for (int q = 0; q < 10; ++q)
+            surge->process();
+
+        for (auto n : {48, 55, 60, 67})
+            surge->playNote(0, n, 100, 0);
+
+        std::vector<float> out;
+        for (int q = 0; q < 200; ++q)
+        {
+            surge->process();
+            out.insert(out.end(), surge->output[0], surge->output[0] + BLOCK_SIZE);
+            out.insert(out.end(), surge->output[1], surge->output[1] + BLOCK_SIZE);
+        }
+        return out;
+    };
+
+    auto serial = render(1234, false);
+    REQUIRE(std::any_of(serial.begin(), serial.end(), [](auto f) { return f != 0.f; }));
+    REQUIRE(render(1234, false) == serial);
+    REQUIRE(render(1234, true) == serial);
+    REQUIRE(render(4321, false) != serial);
+}
+
+TEST_CASE("Forked Engines Render Variants From The Same State", "[dsp]")
+{
+    struct Quiet : SurgeSynthesizer::PluginLayer
+    {
+        void surgeParameterUpdated(const SurgeSynthesizer::ID &, float) override {}
+        void surgeMacroUpdated(long, float) override {}
+    } quiet;
+
+    auto surge = Surge::Headless::createSurge(48000, true);
+    REQUIRE(surge);
+    surge->setRandomSeed(1234);
+
+    auto &patch = surge->storage.getPatch();
+    patch.scene[0].level_noise.val.f = 0.f;
+    patch.scene[0].mute_noise.val.b = false;
+    patch.scene[0].drift.val.f = 1.f;
+    patch.scene[0].filterunit[0].cutoff.val.f = -20.f;
+    surge->pitchBend(0, 4096);
+
+    for (int q = 0; q < 50; ++q)
+        surge->process();
+
+    auto render = [](SurgeSynthesizer *s, int note) {
+        s->playNote(0, note, 100, 0);
+        std::vector<float> out;
+        for (int q = 0; q < 100; ++q)
+        {
+            s->process();
+            out.insert(out.end(), s->output[0], s->output[0] + BLOCK_SIZE);
+            out.insert(out.end(), s->output[1], s->output[1] + BLOCK_SIZE);
+        }
+        return out;
+    };
+
+    auto a = surge->fork(&quiet);
+    auto b = surge->fork(&quiet);
+    auto c = surge->fork(&quiet);
+    REQUIRE(a);
+
+    REQUIRE(a->storage.samplerate == 48000);
+    REQUIRE(a->storage.getPatch().scene[0].filterunit[0].cutoff.val.f == -20.f);
+    REQUIRE(a->storage.getPatch().scene[0].modsources[ms_pitchbend]->get_output(0) ==
+            Approx(surge->storage.getPatch().scene[0].modsources[ms_pitchbend]->get_output(0))
+                .margin(1e-3));
+    REQUIRE(a->storage.getPatch().scene[0].modsources[ms_pitchbend]->get_output(0) > 0.f);
+
+    // the forks run on their own threads, and the same events give the same render
+    std::vector<float> ra, rb, rc;
+    std::thread ta([&]() { ra = render(a.get(), 60); });
+    std::thread tb([&]() { rb = render(b.get(), 60); });
+    std::thread tc([&]() { rc = render(c.get(), 67); });
+    ta.join();
+    tb.join();
+    tc.join();
+
+    REQUIRE(std::any_of(ra.begin(), ra.end(), [](auto f) { return f != 0.f; }));
+    REQUIRE(ra == rb);
+    REQUIRE(ra != rc);
+
+    // and the engine they came from is left as it was
+    REQUIRE(surge->storage.getPatch().scene[0].filterunit[0].cutoff.val.f == -20.f);
+}
+
+TEST_CASE("FX Render In Parallel", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge);
+
+    surge->setRenderFXInParallel(true);
+    REQUIRE(surge->getRenderFXInParallel());
+
+    auto &patch = surge->storage.getPatch();
+    patch.scenemode.val.i = sm_dual;
+
+    // an insert on each scene and three sends, so both stages have work to share
+    for (auto slot : {fxslot_ains1, fxslot_bins1, fxslot_send1, fxslot_send2, fxslot_send3})
+    {
+        auto *pt = &(patch.fx[slot].type);
+        surge->setParameter01(surge->idForParameter(pt),
+                              1.f * fxt_delay / (pt->val_max.i - pt->val_min.i), false);
+    }
+
+    for (int s = 0; s < n_scenes; ++s)
+        for (int send = 0; send < 3; ++send)
+            surge->setParameter01(surge->idForParameter(&patch.scene[s].send_level[send]), 0.5f,
+                                  false);
+
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    for (auto slot : {fxslot_ains1, fxslot_bins1, fxslot_send1, fxslot_send2, fxslot_send3})
+    {
+        REQUIRE(surge->fx[slot]);
+        REQUIRE(surge->fx[slot]->fxdata->type.val.i == fxt_delay);
+    }
+
+    REQUIRE(surge->sceneHasActiveInserts(0));
+    REQUIRE(surge->sceneHasActiveInserts(1));
+
+    surge->playNote(0, 60, 127, 0);
+
+    float sumAbsOut = 0;
+    for (int q = 0; q < 100; ++q)
+    {
+        surge->process();
+        REQUIRE(surge->fxRenderState.nSends == 3);
+
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+        {
+            REQUIRE(std::isfinite(surge->output[0][s]));
+            REQUIRE(std::isfinite(surge->output[1][s]));
+            sumAbsOut += fabs(surge->output[0][s]);
+        }
+    }
+    REQUIRE(sumAbsOut > 1);
+
+    surge->releaseNote(0, 60, 0);
+
+    for (int q = 0; q < 2000; ++q)
+        surge->process();
+
+    REQUIRE(surge->voices[0].empty());
+    REQUIRE(surge->voices[1].empty());
+
+    surge->setRenderFXInParallel(false);
+    REQUIRE(!surge->getRenderFXInParallel());
+}
+
+TEST_CASE("Voices Render In Parallel", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge);
+
+    surge->setRenderVoicesInParallel(true);
+    REQUIRE(surge->getRenderVoicesInParallel());
+
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    for (int k = 0; k < 14; ++k)
+        surge->playNote(0, 48 + k, 127, 0);
+
+    float sumAbsOut = 0;
+    for (int q = 0; q < 100; ++q)
+    {
+        REQUIRE(surge->canRenderVoicesInParallel(0));
+        surge->process();
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+        {
+            REQUIRE(std::isfinite(surge->output[0][s]));
+            sumAbsOut += fabs(surge->output[0][s]);
+        }
+    }
+    REQUIRE(sumAbsOut > 1);
+    REQUIRE(surge->voices[0].size() == 14);
+
+    for (int k = 0; k < 14; ++k)
+        surge->releaseNote(0, 48 + k, 0);
+
+    for (int q = 0; q < 2000; ++q)
+        surge->process();
+
+    REQUIRE(surge->voices[0].empty());
+}
+
+TEST_CASE("Voices Of Both Scenes Render In One Round", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge);
+
+    surge->storage.getPatch().scenemode.val.i = sm_dual;
+    surge->setRenderVoicesInParallel(true);
+
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    // three voices a scene is a single group each, which only pays off when they share a round
+    for (auto k : {48, 52, 55})
+        surge->playNote(0, k, 127, 0);
+
+    REQUIRE(surge->voices[0].size() == 3);
+    REQUIRE(surge->voices[1].size() == 3);
+    REQUIRE(!surge->canRenderVoicesInParallel(0));
+    REQUIRE(surge->estimateVoiceCost(0) > 0);
+
+    float sumAbsOut = 0;
+    for (int q = 0; q < 100; ++q)
+    {
+        surge->process();
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+        {
+            REQUIRE(std::isfinite(surge->output[0][s]));
+            sumAbsOut += fabs(surge->output[0][s]);
+        }
+    }
+    REQUIRE(sumAbsOut > 1);
+
+    for (auto k : {48, 52, 55})
+        surge->releaseNote(0, k, 0);
+
+    for (int q = 0; q < 2000; ++q)
+        surge->process();
+
+    REQUIRE(surge->voices[0].empty());
+    REQUIRE(surge->voices[1].empty());
+}
+
+TEST_CASE("Voices Keep Their Filter Lane", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge);
+
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    for (auto k : {60, 64, 67})
+        surge->playNote(0, k, 127, 0);
+
+    for (int q = 0; q < 20; ++q)
+        surge->process();
+
+    int lane = 0;
+    for (auto v : surge->voices[0])
+    {
+        REQUIRE(v->isResidentInQFB());
+        REQUIRE(v->getQFBLane() == lane++);
+    }
+
+    // retiring the oldest voice shifts the others down a lane, so they have to be evicted
+    surge->releaseNote(0, 60, 0);
+
+    int blocks = 0;
+    while (surge->voices[0].size() == 3 && blocks++ < 5000)
+        surge->process();
+
+    REQUIRE(surge->voices[0].size() == 2);
+    for (auto v : surge->voices[0])
+        REQUIRE(!v->isResidentInQFB());
+
+    float sumAbsOut = 0;
+    for (int q = 0; q < 20; ++q)
+    {
+        surge->process();
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+        {
+            REQUIRE(std::isfinite(surge->output[0][s]));
+            sumAbsOut += fabs(surge->output[0][s]);
+        }
+    }
+    REQUIRE(sumAbsOut > 1);
+
+    lane = 0;
+    for (auto v : surge->voices[0])
+    {
+        REQUIRE(v->isResidentInQFB());
+        REQUIRE(v->getQFBLane() == lane++);
+    }
+}
+
+TEST_CASE("Inaudible Voices Skip Their Oscillators", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge);
+
+    auto &sc = surge->storage.getPatch().scene[0];
+    sc.adsr[0].d.val.f = -5;
+    sc.adsr[0].s.val.f = 0;
+    sc.adsr[0].r.val.f = 2;
+
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    surge->playNote(0, 60, 127, 0);
+
+    for (int q = 0; q < 5; ++q)
+        surge->process();
+
+    REQUIRE(surge->voices[0].size() == 1);
+    REQUIRE(!surge->voices[0].front()->isInaudible());
+
+    for (int q = 0; q < 1000; ++q)
+        surge->process();
+
+    // a held voice with nothing left in its envelope stays alive, but quietly
+    REQUIRE(surge->voices[0].size() == 1);
+    REQUIRE(surge->voices[0].front()->isInaudible());
+
+    for (int s = 0; s < BLOCK_SIZE; ++s)
+        REQUIRE(fabs(surge->output[0][s]) < 1e-4);
+
+    surge->releaseNote(0, 60, 0);
+
+    for (int q = 0; q < 20; ++q)
+        surge->process();
+
+    REQUIRE(surge->voices[0].empty());
+}
+
+TEST_CASE("Note Render Cache Replays Repeated One Shots", "[dsp]")
+{
+    auto setup = [](bool retrigger) {
+        auto surge = Surge::Headless::createSurge(44100, true);
+        REQUIRE(surge);
+
+        auto &sc = surge->storage.getPatch().scene[0];
+        sc.adsr[0].d.val.f = -3;
+        sc.adsr[0].s.val.f = 0;
+        sc.osc[0].retrigger.val.b = retrigger;
+        sc.mute_noise.val.b = true;
+        sc.drift.val.f = 0.f;
+        surge->setNoteRenderCache(true);
+
+        for (int q = 0; q < 10; ++q)
+            surge->process();
+
+        return surge;
+    };
+
+    auto hit = [](SurgeSynthesizer *surge, SurgeVoice::NoteCacheRole &role) {
+        std::vector<float> out;
+
+        surge->playNote(0, 60, 100, 0);
+        surge->process();
+        role = surge->voices[0].front()->noteCacheRole;
+        surge->releaseNote(0, 60, 0);
+
+        for (int q = 0; q < 400; ++q)
+        {
+            out.insert(out.end(), surge->output[0], surge->output[0] + BLOCK_SIZE);
+            surge->process();
+        }
+
+        REQUIRE(surge->voices[0].empty());
+        return out;
+    };
+
+    SECTION("A Deterministic Patch Replays")
+    {
+        auto surge = setup(true);
+        SurgeVoice::NoteCacheRole r1, r2, r3;
+
+        auto live = hit(surge.get(), r1);
+        hit(surge.get(), r2);
+        auto replayed = hit(surge.get(), r3);
+
+        REQUIRE(r1 == SurgeVoice::nc_recording);
+        REQUIRE(r2 == SurgeVoice::nc_recording);
+        REQUIRE(r3 == SurgeVoice::nc_replaying);
+        REQUIRE(surge->noteRenderCache->getReplays() == 1);
+
+        float peak = 0.f;
+        for (auto f : live)
+            peak = std::max(peak, std::fabs(f));
+        REQUIRE(peak > 0.01f);
+
+        for (size_t i = 0; i < live.size(); ++i)
+            REQUIRE(replayed[i] == Approx(live[i]).margin(peak * 2e-3));
+    }
+
+    SECTION("Changing A Patch Global Misses The Cache")
+    {
+        auto surge = setup(true);
+        SurgeVoice::NoteCacheRole r1, r2, r3, r4;
+
+        hit(surge.get(), r1);
+        hit(surge.get(), r2);
+        hit(surge.get(), r3);
+        REQUIRE(r3 == SurgeVoice::nc_replaying);
+
+        // the oscillators read character at note on, so the trusted entry no longer applies
+        auto &character = surge->storage.getPatch().character;
+        character.val.i = (character.val.i + 1) % (character.val_max.i + 1);
+
+        hit(surge.get(), r4);
+        REQUIRE(r4 == SurgeVoice::nc_recording);
+        REQUIRE(surge->noteRenderCache->getReplays() == 1);
+    }
+
+    SECTION("A Random Phase Patch Stays Live")
+    {
+        auto surge = setup(false);
+        SurgeVoice::NoteCacheRole r1, r2, r3;
+
+        hit(surge.get(), r1);
+        hit(surge.get(), r2);
+        hit(surge.get(), r3);
+
+        REQUIRE(r1 == SurgeVoice::nc_recording);
+        REQUIRE(r3 == SurgeVoice::nc_live);
+        REQUIRE(surge->noteRenderCache->getReplays() == 0);
+    }
+}
+
+TEST_CASE("Polyphony Governor Lowers And Restores The Voice Limit", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge);
+
+    auto &sc = surge->storage.getPatch().scene[0];
+    sc.adsr[0].r.val.f = 2;
+
+    auto patchLimit = surge->storage.getPatch().polylimit.val.i;
+
+    surge->setPolyphonyGovernorEnabled(true);
+    REQUIRE(surge->getEffectivePolyphonyLimit() == patchLimit);
+
+    // a high water mark below zero means we are always over budget
+    surge->setPolyphonyGovernorWaterMarks(-2.f, -1.f);
+
+    for (int n = 0; n < 12; ++n)
+        surge->playNote(0, 48 + n, 127, 0);
+
+    for (int q = 0; q < 3000; ++q)
+        surge->process();
+
+    REQUIRE(surge->getEffectivePolyphonyLimit() == 4);
+
+    // the governor never takes held notes
+    REQUIRE(surge->getNonUltrareleaseVoices(0) == 12);
+
+    for (int n = 0; n < 12; ++n)
+        surge->releaseNote(0, 48 + n, 0);
+
+    surge->process();
+
+    REQUIRE(surge->getNonUltrareleaseVoices(0) <= 4);
+
+    surge->setPolyphonyGovernorWaterMarks(10.f, 20.f);
+
+    for (int q = 0; q < 6000; ++q)
+        surge->process();
+
+    REQUIRE(surge->getEffectivePolyphonyLimit() == patchLimit);
+
+    surge->setPolyphonyGovernorEnabled(false);
+}
+
+TEST_CASE("Twist Voices Use Pooled Engines", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge);
+
+    surge->storage.getPatch().scene[0].osc[0].queue_type = ot_twist;
+
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    auto &pool = surge->storage.memoryPools->twistEngines;
+    auto before = pool.position;
+    REQUIRE(before > 0);
+
+    surge->playNote(0, 60, 127, 0);
+    surge->playNote(0, 64, 127, 0);
+
+    float sumAbsOut = 0;
+    for (int q = 0; q < 50; ++q)
+    {
+        surge->process();
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+            sumAbsOut += fabs(surge->output[0][s]);
+    }
+
+    REQUIRE(sumAbsOut > 1);
+    REQUIRE(pool.position == before - 2);
+
+    surge->releaseNote(0, 60, 0);
+    surge->releaseNote(0, 64, 0);
+
+    for (int q = 0; q < 1000 && !surge->voices[0].empty(); ++q)
+        surge->process();
+
+    REQUIRE(surge->voices[0].empty());
+    REQUIRE(pool.position == before);
+}
+
+TEST_CASE("Drift LFOs Run Their Own Generator", "[osc]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    Surge::Oscillator::DriftLFO a, b;
+
+    surge->setRandomSeed(1234);
+    a.init(true, &surge->storage);
+    surge->setRandomSeed(1234);
+    b.init(true, &surge->storage);
+
+    float maxDrift = 0;
+    for (int i = 0; i < 10000; ++i)
+    {
+        // other users of the storage generator in between must not change what the drift does
+        surge->storage.rand();
+
+        auto av = a.next();
+        REQUIRE(av == b.next());
+        maxDrift = std::max(maxDrift, std::fabs(av));
+    }
+
+    REQUIRE(maxDrift > 0);
+    REQUIRE(maxDrift < 4);
+}
+
+TEST_CASE("Partitioned Convolution Matches Direct Convolution", "[dsp]")
+{
+    // long enough to reach every stage, and not a whole number of partitions
+    for (auto len : {20, 900, 5000, 20000})
+    {
+        DYNAMIC_SECTION("Response Length " << len)
+        {
+            std::vector<float> irL(len), irR(len);
+            for (int i = 0; i < len; ++i)
+            {
+                irL[i] = ((std::rand() % 2000) - 1000) * 1e-3f / std::sqrt((float)len);
+                irR[i] = ((std::rand() % 2000) - 1000) * 1e-3f / std::sqrt((float)len);
+            }
+
+            auto conv = std::make_unique<Surge::DSP::PartitionedConvolver>();
+            conv->setImpulseResponse(irL, irR);
+
+            static constexpr int nBlocks = 24000 / BLOCK_SIZE;
+            std::vector<float> inL(nBlocks * BLOCK_SIZE), inR(nBlocks * BLOCK_SIZE);
+            for (int i = 0; i < (int)inL.size(); ++i)
+            {
+                inL[i] = ((std::rand() % 2000) - 1000) * 1e-3f;
+                inR[i] = ((std::rand() % 2000) - 1000) * 1e-3f;
+            }
+
+            float maxErr = 0;
+            for (int b = 0; b < nBlocks; ++b)
+            {
+                float outL alignas(16)[BLOCK_SIZE], outR alignas(16)[BLOCK_SIZE];
+                conv->process(&inL[b * BLOCK_SIZE], &inR[b * BLOCK_SIZE], outL, outR);
+
+                if (b == 0)
+                    REQUIRE(conv->impulseResponseLength() == len);
+
+                // only check a few blocks exactly, direct convolution of the lot is slow
+                if (b % 7 != 0)
+                    continue;
+
+                for (int i = 0; i < BLOCK_SIZE; ++i)
+                {
+                    auto n = b * BLOCK_SIZE + i;
+                    double dL = 0, dR = 0;
+                    for (int k = 0; k < len && k <= n; ++k)
+                    {
+                        dL += (double)irL[k] * inL[n - k];
+                        dR += (double)irR[k] * inR[n - k];
+                    }
+                    maxErr = std::max(maxErr, (float)std::fabs(dL - outL[i]));
+                    maxErr = std::max(maxErr, (float)std::fabs(dR - outR[i]));
+                }
+            }
+
+            REQUIRE(maxErr < 1e-4);
+
+            conv->reset();
+            std::vector<float> zero(BLOCK_SIZE, 0.f);
+            float outL alignas(16)[BLOCK_SIZE], outR alignas(16)[BLOCK_SIZE];
+            conv->process(zero.data(), zero.data(), outL, outR);
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                REQUIRE(outL[i] == 0.f);
+                REQUIRE(outR[i] == 0.f);
+            }
+        }
+    }
+}
+
+TEST_CASE("Polyphase Resampler Keeps Rate And Level", "[dsp]")
+{
+    for (auto sr : {44100, 48000, 88200, 96000})
+    {
+        DYNAMIC_SECTION("From " << sr << " To 32k")
+        {
+            Surge::DSP::PolyphaseResampler rs;
+            REQUIRE(rs.setRates(sr, 32000));
+            REQUIRE(!rs.isBypass());
+
+            std::vector<float> in(2 * sr), out(2 * 32000 + 64);
+            for (int i = 0; i < sr; ++i)
+            {
+                in[2 * i] = std::sin(2.0 * M_PI * 1000.0 * i / sr);
+                in[2 * i + 1] = -in[2 * i];
+            }
+
+            int nOut = 0;
+            for (int i = 0; i < sr; i += BLOCK_SIZE)
+            {
+                auto n = std::min(BLOCK_SIZE, sr - i);
+                nOut += rs.process(&in[2 * i], n, &out[2 * nOut], 2 * BLOCK_SIZE);
+            }
+
+            REQUIRE(nOut == 32000);
+
+            // past the filter's latency, a 1k tone comes out at the same level
+            float peak = 0;
+            for (int i = 1000; i < nOut; ++i)
+            {
+                peak = std::max(peak, std::fabs(out[2 * i]));
+                REQUIRE(out[2 * i] == Approx(-out[2 * i + 1]).margin(1e-6));
+            }
+            REQUIRE(peak == Approx(1.f).margin(0.01));
+        }
+    }
+
+    SECTION("32k Is A Copy")
+    {
+        Surge::DSP::PolyphaseResampler rs;
+        REQUIRE(rs.setRates(32000, 32000));
+        REQUIRE(rs.isBypass());
+
+        float in[2 * BLOCK_SIZE], out[2 * BLOCK_SIZE];
+        for (int i = 0; i < 2 * BLOCK_SIZE; ++i)
+            in[i] = i * 0.01f;
+
+        REQUIRE(rs.process(in, BLOCK_SIZE, out, BLOCK_SIZE) == BLOCK_SIZE);
+        for (int i = 0; i < 2 * BLOCK_SIZE; ++i)
+            REQUIRE(out[i] == in[i]);
+    }
+}
+
+TEST_CASE("SIMD Dot Products Match The Portable Kernels", "[dsp]")
+{
+    namespace sd = Surge::DSP;
+
+    short ia alignas(16)[80], ib alignas(16)[80];
+    float fa alignas(16)[80], fb alignas(16)[80];
+    for (int i = 0; i < 80; ++i)
+    {
+        ia[i] = (short)(std::rand() % 65536 - 32768);
+        ib[i] = (short)(std::rand() % 65536 - 32768);
+        fa[i] = ((std::rand() % 2000) - 1000) * 1e-3f;
+        fb[i] = ((std::rand() % 2000) - 1000) * 1e-3f;
+    }
+    // the extremes, where a madd pair sums right up to the int32 limit
+    ia[0] = ia[1] = ib[0] = ib[1] = -32768;
+
+    // every offset, since none of the callers hand in aligned samples
+    for (int o = 0; o < 16; ++o)
+    {
+        INFO("Offset " << o);
+        int64_t ref = 0;
+        for (int i = 0; i < 8; ++i)
+            ref += ia[o + i] * ib[o + i];
+        REQUIRE(sd::dotI16x8(ia + o, ib + o) == (int32_t)(uint32_t)ref);
+        REQUIRE(sd::dotI16x8(ia + o, ib + o) == sd::Portable::dotI16x8(ia + o, ib + o));
+
+        REQUIRE(sd::dotI16(ia + o, ib + o, 64) == sd::Portable::dotI16(ia + o, ib + o, 64));
+        REQUIRE(sd::dotF32(fa + o, fb + o, 64) == sd::Portable::dotF32(fa + o, fb + o, 64));
+
+        auto v = _mm_loadu_ps(fa + o);
+        REQUIRE(sd::hsumF32(v) == sd::Portable::hsumF32(v));
+        REQUIRE(vSum(v) == sd::Portable::hsumF32(v));
+    }
+}
+
+TEST_CASE("Table Waveshapers Follow Their Exact Shapes", "[dsp]")
+{
+    namespace sw = sst::waveshapers;
+    Surge::DSP::prepareTableWaveshapers();
+
+    auto freshState = [](sw::WaveshaperType wst) {
+        sw::QuadWaveshaperState s;
+        float R[sw::n_waveshaper_registers];
+        sw::initializeWaveshaperRegister(wst, R);
+        for (int i = 0; i < sw::n_waveshaper_registers; ++i)
+            s.R[i] = _mm_set1_ps(R[i]);
+        s.init = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+        return s;
+    };
+    auto lane0 = [](__m128 v) { return _mm_cvtss_f32(v); };
+
+    SECTION("Tables Match Exact Evaluation")
+    {
+        int tabulated = 0;
+
+        for (int t = 0; t < (int)sw::WaveshaperType::n_ws_types; ++t)
+        {
+            auto wst = (sw::WaveshaperType)t;
+            auto table = Surge::DSP::GetTableQuadWaveshaper(wst, false);
+
+            if (!table)
+                continue;
+
+            auto exact = sw::GetQuadWaveshaper(wst);
+            tabulated++;
+            INFO("Shape " << sw::wst_names[t]);
+
+            for (int i = 0; i < 500; ++i)
+            {
+                float x = ((std::rand() % 2000) - 1000) * 4e-3f;
+                float d = 0.1f + (std::rand() % 1000) * 1.6e-2f;
+                auto es = freshState(wst), ts = freshState(wst);
+                auto ye = lane0(exact(&es, _mm_set1_ps(x), _mm_set1_ps(d)));
+                auto yt = lane0(table(&ts, _mm_set1_ps(x), _mm_set1_ps(d)));
+                REQUIRE(yt == Approx(ye).margin(2e-3).epsilon(2e-3));
+            }
+        }
+
+        REQUIRE(tabulated > 0);
+        REQUIRE(Surge::DSP::isTableWaveshaper(sw::WaveshaperType::wst_soft));
+    }
+
+    SECTION("ADAA Tracks Slow Input And Lowers Aliasing")
+    {
+        auto wst = sw::WaveshaperType::wst_soft;
+        auto table = Surge::DSP::GetTableQuadWaveshaper(wst, false);
+        auto adaa = Surge::DSP::GetTableQuadWaveshaper(wst, true);
+        REQUIRE(table);
+        REQUIRE(adaa);
+
+        // on a ramp the antiderivative quotient is the curve half a step back
+        auto ts = freshState(wst), as = freshState(wst);
+        auto d = _mm_set1_ps(1.5f);
+        lane0(adaa(&as, _mm_set1_ps(-4.f), d));
+        for (int i = 1; i < 400; ++i)
+        {
+            auto x = -4.f + i * 2e-2f;
+            auto mid = _mm_set1_ps(x - 1e-2f);
+            REQUIRE(lane0(adaa(&as, _mm_set1_ps(x), d)) ==
+                    Approx(lane0(table(&ts, mid, d))).margin(1e-3));
+        }
+
+        // a hard driven tone whose third harmonic folds back onto a bin of its own
+        constexpr int N = 4096, k0 = 1001, kAlias = N - 3 * k0;
+        auto spectrum = [&](sw::QuadWaveshaperPtr fn, int k) {
+            auto s = freshState(wst);
+            std::complex<double> acc{0, 0};
+            for (int n = 0; n < 2 * N; ++n)
+            {
+                auto x = 0.9f * std::sin(2.0 * M_PI * k0 * n / N);
+                auto y = lane0(fn(&s, _mm_set1_ps(x), _mm_set1_ps(8.f)));
+                if (n >= N)
+                    acc += (double)y * std::polar(1.0, -2.0 * M_PI * k * n / N);
+            }
+            return std::abs(acc);
+        };
+
+        auto tableRatio = spectrum(table, kAlias) / spectrum(table, k0);
+        auto adaaRatio = spectrum(adaa, kAlias) / spectrum(adaa, k0);
+        INFO("Table " << tableRatio << " ADAA " << adaaRatio);
+        REQUIRE(adaaRatio < tableRatio);
+        REQUIRE(spectrum(adaa, k0) == Approx(spectrum(table, k0)).epsilon(0.3));
+    }
+}
@@ -26,6 +26,7 @@
 
 #include "HeadlessUtils.h"
 #include "Player.h"
+#include "FilterCoefficientCache.h"
 
 #include "catch2/catch_amalgamated.hpp"
 
@@ -100,3 +101,45 @@ TEST_CASE("Run Every Waveshaper", "[flt]")
         }
     }
 }
+
+TEST_CASE("Cached Filter Targets Match MakeCoeffs", "[flt]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto sr = (float)surge->storage.dsamplerate_os;
+    FilterCoefficientCache cache;
+
+    for (int fn = 1; fn < sst::filters::num_filter_types; fn++)
+    {
+        INFO("Filter type is " << sst::filters::filter_type_names[fn]);
+
+        sst::filters::FilterCoefficientMaker<SurgeStorage> direct, cached;
+        direct.setSampleRateAndBlockSize(sr, BLOCK_SIZE_OS);
+        cached.setSampleRateAndBlockSize(sr, BLOCK_SIZE_OS);
+
+        // hold, move, then hold again so both the hit and the miss paths ease the same way
+        for (float cutoff : {-10.f, -10.f, 5.f, 5.f, 5.f})
+        {
+            FilterCoefficientCache::Key key;
+            key.cutoff = cutoff;
+            key.resonance = 0.4f;
+            key.type = fn;
+            key.sampleRate = sr;
+            key.tuningUpdate = surge->storage.tuningUpdates;
+
+            direct.MakeCoeffs(cutoff, key.resonance, static_cast<sst::filters::FilterType>(fn),
+                              static_cast<sst::filters::FilterSubType>(0), &surge->storage,
+                              false);
+            cached.FromDirect(cache.targetsFor(key, &surge->storage));
+
+            for (int i = 0; i < sst::filters::n_cm_coeffs; ++i)
+            {
+                REQUIRE(cached.C[i] == direct.C[i]);
+                REQUIRE(cached.dC[i] == direct.dC[i]);
+            }
+        }
+    }
+
+    REQUIRE(cache.getHits() > 0);
+}
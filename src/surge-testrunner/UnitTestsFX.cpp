@@ -23,6 +23,9 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <thread>
+#include <chrono>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -32,6 +35,18 @@
 
 #include "UnitTestUtilities.h"
 #include "AudioInputEffect.h"
+#include "ConditionerEffect.h"
+#include "VocoderEffect.h"
+#include "DistortionEffect.h"
+#include "WaveShaperEffect.h"
+#include "GraphicEQ11BandEffect.h"
+#include "PhaserEffect.h"
+#include "Reverb2Effect.h"
+#include "RotarySpeakerEffect.h"
+#include "RingModulatorEffect.h"
+#include "chowdsp/TapeEffect.h"
+#include "chowdsp/bbd_utils/BBDDelayLine.h"
+#include "chowdsp/spring_reverb/SchroederAllpass.h"
 
 using namespace Surge::Test;
 
@@ -276,6 +291,110 @@ TEST_CASE("Move FX With Assigned Modulation", "[fx]")
     }
 }
 
+TEST_CASE("Reordered FX Keep Their Running Instances", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto step = [&surge](int n) {
+        float level = 0.f;
+
+        for (int i = 0; i < n; ++i)
+        {
+            surge->process();
+
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+                level = std::max(level, std::fabs(surge->output[0][s]));
+        }
+
+        return level;
+    };
+
+    step(10);
+    Surge::Test::setFX(surge, 0, fxt_delay);
+    Surge::Test::setFX(surge, 1, fxt_chorus4);
+    step(10);
+
+    auto delay = surge->fx[0].get();
+    auto chorus = surge->fx[1].get();
+    REQUIRE(delay);
+    REQUIRE(chorus);
+
+    surge->playNote(0, 60, 127, 0);
+    step(100);
+    surge->releaseNote(0, 60, 0);
+    step(200);
+
+    SECTION("Swap")
+    {
+        surge->reorderFx(0, 1, SurgeSynthesizer::SWAP);
+        step(1);
+
+        REQUIRE(surge->fx[0].get() == chorus);
+        REQUIRE(surge->fx[1].get() == delay);
+        REQUIRE(surge->storage.getPatch().fx[1].type.val.i == fxt_delay);
+
+        // the delay repeats are still going after the swap
+        REQUIRE(step(100) > 1e-4);
+    }
+
+    SECTION("Move")
+    {
+        surge->reorderFx(0, 2, SurgeSynthesizer::MOVE);
+        step(1);
+
+        REQUIRE(!surge->fx[0]);
+        REQUIRE(surge->fx[2].get() == delay);
+        REQUIRE(step(100) > 1e-4);
+    }
+
+    SECTION("Copy Builds A New Instance")
+    {
+        surge->reorderFx(0, 2, SurgeSynthesizer::COPY);
+        step(1);
+
+        REQUIRE(surge->fx[0].get() == delay);
+        REQUIRE(surge->fx[2]);
+        REQUIRE(surge->fx[2].get() != delay);
+    }
+}
+
+TEST_CASE("FX Type Changes Crossfade From The Old Effect", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    Surge::Test::setFX(surge, 0, fxt_delay);
+    auto delay = surge->fx[0].get();
+
+    surge->playNote(0, 60, 127, 0);
+    for (int i = 0; i < 100; ++i)
+        surge->process();
+    surge->releaseNote(0, 60, 0);
+
+    auto *pt = &(surge->storage.getPatch().fx[0].type);
+    auto awv = 1.f * float(fxt_chorus4) / (pt->val_max.i - pt->val_min.i);
+    surge->setParameter01(surge->idForParameter(pt), awv, false);
+    surge->process();
+
+    // the chorus is in the slot, and the delay is still being faded out beside it
+    REQUIRE(surge->storage.getPatch().fx[0].type.val.i == fxt_chorus4);
+    REQUIRE(surge->fx[0]);
+    REQUIRE(surge->fx[0].get() != delay);
+    REQUIRE(surge->fxCrossfade[0].from.get() == delay);
+
+    for (int i = 1; i < SurgeSynthesizer::fxCrossfadeBlocks; ++i)
+    {
+        REQUIRE(surge->fxCrossfade[0].from);
+        surge->process();
+    }
+
+    REQUIRE(!surge->fxCrossfade[0].from);
+}
+
 TEST_CASE("Reverb 2 at High Sample Rate", "[fx]")
 {
     SECTION("Make Reverb 2")
@@ -444,6 +563,29 @@ TEST_CASE("Scenes Output Data", "[fx]")
         REQUIRE(!scenesOutputData.thereAreClients(0));
         REQUIRE(!scenesOutputData.thereAreClients(1));
     }
+
+    SECTION("Providing a view")
+    {
+        Surge::Storage::ScenesOutputData scenesOutputData{};
+        auto clientDataLeft = scenesOutputData.getSceneData(0, 0);
+        auto clientDataRight = scenesOutputData.getSceneData(0, 1);
+
+        float dataL[BLOCK_SIZE]{1.0f}, dataR[BLOCK_SIZE]{2.0f};
+        scenesOutputData.provideSceneView(0, 0, dataL);
+        scenesOutputData.provideSceneView(0, 1, dataR);
+
+        // a view is not a copy
+        REQUIRE(scenesOutputData.getSceneView(0, 0) == dataL);
+        REQUIRE(scenesOutputData.getSceneView(0, 1) == dataR);
+        REQUIRE(clientDataLeft.get()[0] == 0.0f);
+
+        // but a snapshot survives the provider changing its buffer
+        scenesOutputData.snapshotSceneData(0);
+        dataL[0] = 3.0f;
+        REQUIRE(scenesOutputData.getSceneView(0, 0) == clientDataLeft.get());
+        REQUIRE(scenesOutputData.getSceneView(0, 0)[0] == 1.0f);
+        REQUIRE(scenesOutputData.getSceneView(0, 1)[0] == 2.0f);
+    }
 }
 
 void testExpectedValues(std::shared_ptr<SurgeSynthesizer> surge, int slot, float *leftInput,
@@ -1073,3 +1215,856 @@ TEST_CASE("Audio Input Effect", "[fx]")
         }
     }
 }
+
+TEST_CASE("FX Are Built And Freed Off The Audio Thread", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    // the headless engine builds effects inline, which is exactly what we don't want here
+    surge->stageEffectsInline = false;
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    auto *pt = &(surge->storage.getPatch().fx[0].type);
+    auto did = surge->idForParameter(pt);
+
+    auto waitFor = [](auto cond) {
+        for (int i = 0; i < 2000 && !cond(); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return cond();
+    };
+
+    surge->setParameter01(did, 1.f * fxt_reverb2 / (pt->val_max.i - pt->val_min.i), false);
+
+    // until the background service has built it, the slot keeps what it had
+    surge->process();
+    if (surge->isStagingEffect(0))
+        REQUIRE(surge->storage.getPatch().fx[0].type.val.i != fxt_reverb2);
+
+    REQUIRE(waitFor([&]() { return !surge->isStagingEffect(0); }));
+    REQUIRE(surge->fxStaged[0]);
+    REQUIRE(surge->fxStagedType[0] == fxt_reverb2);
+
+    auto staged = surge->fxStaged[0].get();
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    REQUIRE(surge->fx[0].get() == staged);
+    REQUIRE(!surge->fxStaged[0]);
+
+    surge->setParameter01(did, 1.f * fxt_delay / (pt->val_max.i - pt->val_min.i), false);
+    REQUIRE(waitFor([&]() { return !surge->isStagingEffect(0); }));
+
+    for (int i = 0; i < SurgeSynthesizer::fxCrossfadeBlocks + 10; ++i)
+        surge->process();
+
+    REQUIRE(surge->storage.getPatch().fx[0].type.val.i == fxt_delay);
+    REQUIRE(surge->fx[0].get() != staged);
+    REQUIRE(!surge->fxCrossfade[0].from);
+
+    // nobody calls releaseRetiredEffects; the service frees the reverb on its own
+    REQUIRE(waitFor([&]() { return surge->retiredEffectCount() == 0; }));
+}
+
+TEST_CASE("FX Budget Degrades And Recovers", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    surge->setFXBudgetEnabled(true);
+
+    // a high water mark below zero means we are always over budget
+    surge->setFXBudgetWaterMarks(-2.f, -1.f);
+
+    for (int q = 0; q < 3000; ++q)
+        surge->process();
+
+    REQUIRE(surge->getFXBudgetDegradeLevel() == 1 + n_send_slots);
+    for (int i = 0; i < n_send_slots; ++i)
+        REQUIRE(surge->isSendBypassedByFXBudget(i));
+
+    surge->setFXBudgetWaterMarks(10.f, 20.f);
+
+    for (int q = 0; q < 3000; ++q)
+        surge->process();
+
+    REQUIRE(surge->getFXBudgetDegradeLevel() == 0);
+    for (int i = 0; i < n_send_slots; ++i)
+        REQUIRE(!surge->isSendBypassedByFXBudget(i));
+
+    surge->setFXBudgetEnabled(false);
+}
+
+TEST_CASE("FX Tails Stay Free Of Denormals", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto *pt = &(surge->storage.getPatch().fx[0].type);
+    auto awv = 1.f * float(fxt_reverb2) / (pt->val_max.i - pt->val_min.i);
+    surge->setParameter01(surge->idForParameter(pt), awv, false);
+
+    surge->setDenormalCounterEnabled(true);
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    surge->playNote(0, 60, 127, 0);
+    for (int i = 0; i < 100; ++i)
+        surge->process();
+    surge->releaseNote(0, 60, 0);
+
+    // long enough for the reverb tail to decay all the way into the denormal range
+    for (int i = 0; i < 20000; ++i)
+        surge->process();
+
+    for (int s = 0; s < n_fx_slots; ++s)
+    {
+        INFO("FX slot " << s);
+        REQUIRE(surge->getDenormalCount(s) == 0);
+    }
+
+    surge->resetDenormalCounts();
+    surge->setDenormalCounterEnabled(false);
+}
+
+TEST_CASE("Vocoder FFT Engine", "[fx]")
+{
+    for (auto sr : {48000, 96000})
+    {
+        DYNAMIC_SECTION("Vocoder FFT Engine at " << sr)
+        {
+            auto surge = Surge::Headless::createSurge(sr);
+            REQUIRE(surge);
+
+            Surge::Test::setFX(surge, 0, fxt_vocoder);
+            auto &fxs = surge->storage.getPatch().fx[0];
+            fxs.p[VocoderEffect::voc_engine].val.i = VocoderEffect::vce_fft;
+
+            surge->process_input = true;
+            surge->playNote(0, 60, 127, 0);
+
+            auto run = [&](float inAmp, int blocks) {
+                float maxAmp = 0.f;
+                long phase = 0;
+
+                for (int i = 0; i < blocks; ++i)
+                {
+                    for (int s = 0; s < BLOCK_SIZE; ++s)
+                    {
+                        auto v = inAmp * std::sin(2.0 * M_PI * 1000.0 * phase++ / sr);
+                        surge->input[0][s] = v;
+                        surge->input[1][s] = v;
+                    }
+
+                    surge->process();
+
+                    for (int s = 0; s < BLOCK_SIZE; ++s)
+                    {
+                        REQUIRE(std::isfinite(surge->output[0][s]));
+                        maxAmp = std::max(maxAmp, std::fabs(surge->output[0][s]));
+                    }
+                }
+
+                return maxAmp;
+            };
+
+            // the carrier only comes through where the modulator has something to say
+            REQUIRE(run(0.5f, 4000) > 1e-3);
+            run(0.f, 4000);
+            REQUIRE(run(0.f, 100) < 1e-4);
+
+            surge->releaseNote(0, 60, 0);
+        }
+    }
+}
+
+TEST_CASE("Distortion And Waveshaper Oversampling Choices", "[fx]")
+{
+    struct Case
+    {
+        fx_type type;
+        int driveParam;
+    };
+
+    for (auto c : {Case{fxt_distortion, DistortionEffect::dist_drive},
+                   Case{fxt_waveshaper, WaveShaperEffect::ws_drive}})
+    {
+        DYNAMIC_SECTION("FX Type " << c.type)
+        {
+            auto surge = Surge::Headless::createSurge(48000);
+            REQUIRE(surge);
+
+            Surge::Test::setFX(surge, 0, c.type);
+            auto &drive = surge->storage.getPatch().fx[0].p[c.driveParam];
+            drive.set_value_f01(0.8f);
+
+            surge->playNote(0, 60, 127, 0);
+
+            // 0 is the effect's original factor, then off, 2x, 4x and 8x
+            for (int choice = 0; choice <= 4; ++choice)
+            {
+                drive.deform_type = choice;
+                float maxAmp = 0.f;
+
+                for (int i = 0; i < 200; ++i)
+                {
+                    surge->process();
+
+                    for (int s = 0; s < BLOCK_SIZE; ++s)
+                    {
+                        REQUIRE(std::isfinite(surge->output[0][s]));
+                        maxAmp = std::max(maxAmp, std::fabs(surge->output[0][s]));
+                    }
+                }
+
+                INFO("Oversampling choice " << choice);
+                REQUIRE(maxAmp > 1e-3);
+                REQUIRE(maxAmp < 4.f);
+            }
+
+            surge->releaseNote(0, 60, 0);
+        }
+    }
+}
+
+TEST_CASE("Effect Parameter Change Tracking", "[fx]")
+{
+    struct Tracked : public Effect
+    {
+        using Effect::Effect;
+        using Effect::anyParamChanged;
+        using Effect::paramChanged;
+        using Effect::resetParamChanges;
+        using Effect::updateParamChanges;
+    };
+
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    auto *fxs = &patch.fx[0];
+    auto *pd = patch.globaldata;
+    Tracked t(&surge->storage, fxs, pd);
+
+    // everything is new the first time round
+    t.updateParamChanges();
+    for (int i = 0; i < n_fx_params; ++i)
+        REQUIRE(t.paramChanged(i));
+
+    t.updateParamChanges();
+    for (int i = 0; i < n_fx_params; ++i)
+        REQUIRE(!t.paramChanged(i));
+
+    pd[fxs->p[3].id].f += 0.25f;
+    t.updateParamChanges();
+    for (int i = 0; i < n_fx_params; ++i)
+        REQUIRE(t.paramChanged(i) == (i == 3));
+    REQUIRE(t.anyParamChanged(1, 3));
+    REQUIRE(!t.anyParamChanged(1, 2));
+
+    t.resetParamChanges();
+    t.updateParamChanges();
+    REQUIRE(t.anyParamChanged(0, n_fx_params - 1));
+
+    surge->setSamplerate(96000);
+    t.updateParamChanges();
+    REQUIRE(t.paramChanged(5));
+}
+
+TEST_CASE("Graphic EQ Skips Flat Bands", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    Surge::Test::setFX(surge, 0, fxt_geq11);
+
+    auto &patch = surge->storage.getPatch();
+    auto *fxs = &patch.fx[0];
+    auto *pd = patch.globaldata;
+
+    for (int i = 0; i < n_fx_params; ++i)
+        pd[fxs->p[i].id].f = fxs->p[i].val.f;
+
+    std::unique_ptr<Effect> eq(spawn_effect(fxt_geq11, &surge->storage, fxs, pd));
+    REQUIRE(eq);
+    eq->init();
+
+    long phase = 0;
+    auto run = [&](int blocks) {
+        float maxDiff = 0.f;
+
+        for (int b = 0; b < blocks; ++b)
+        {
+            float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE], in[BLOCK_SIZE];
+
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                in[s] = 0.5f * std::sin(2.0 * M_PI * 440.0 * phase++ / 48000.0);
+                L[s] = in[s];
+                R[s] = in[s];
+            }
+
+            eq->process(L, R);
+
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+                maxDiff = std::max(maxDiff, std::fabs(L[s] - in[s]));
+        }
+
+        return maxDiff;
+    };
+
+    // with every band and the output gain at 0 dB the whole cascade is a wire
+    run(64);
+    REQUIRE(run(64) < 1e-4);
+
+    pd[fxs->p[GraphicEQ11BandEffect::geq11_500].id].f = 9.f;
+    run(64);
+    REQUIRE(run(64) > 0.05);
+
+    pd[fxs->p[GraphicEQ11BandEffect::geq11_500].id].f = 0.f;
+    run(64);
+    REQUIRE(run(64) < 1e-4);
+}
+
+TEST_CASE("Phaser Cascade Stays All-Pass", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    Surge::Test::setFX(surge, 0, fxt_phaser);
+
+    auto &patch = surge->storage.getPatch();
+    auto *fxs = &patch.fx[0];
+    auto *pd = patch.globaldata;
+
+    for (int i = 0; i < n_fx_params; ++i)
+        pd[fxs->p[i].id] = fxs->p[i].val;
+
+    // no feedback, no sweep and no tone filter leaves a pure all-pass cascade
+    pd[fxs->p[PhaserEffect::ph_feedback].id].f = 0.f;
+    pd[fxs->p[PhaserEffect::ph_mod_depth].id].f = 0.f;
+    pd[fxs->p[PhaserEffect::ph_mix].id].f = 1.f;
+    fxs->p[PhaserEffect::ph_tone].deactivated = true;
+
+    std::unique_ptr<Effect> phaser(spawn_effect(fxt_phaser, &surge->storage, fxs, pd));
+    REQUIRE(phaser);
+    phaser->init();
+
+    long phase = 0;
+    auto rmsRatio = [&](int blocks) {
+        double in2 = 0, out2 = 0;
+
+        for (int b = 0; b < blocks; ++b)
+        {
+            float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                // 480 Hz, so the windows below hold whole cycles
+                L[s] = 0.5f * std::sin(2.0 * M_PI * 480.0 * phase++ / 48000.0);
+                R[s] = L[s];
+                in2 += L[s] * L[s];
+            }
+
+            phaser->process(L, R);
+
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                REQUIRE(std::isfinite(L[s]));
+                REQUIRE(std::isfinite(R[s]));
+                out2 += L[s] * L[s];
+            }
+        }
+
+        return std::sqrt(out2 / in2);
+    };
+
+    for (auto stages : {16, 4, 1, 12})
+    {
+        INFO("Stages " << stages);
+        pd[fxs->p[PhaserEffect::ph_stages].id].i = stages;
+        rmsRatio(200);
+        REQUIRE(rmsRatio(200) == Approx(1.0).margin(0.01));
+    }
+}
+
+TEST_CASE("Tape Adaptive Oversampling", "[fx]")
+{
+    for (auto driveVal : {0.1f, 0.85f})
+    {
+        DYNAMIC_SECTION("Tape Drive " << driveVal)
+        {
+            auto render = [driveVal](bool adaptive) {
+                auto surge = Surge::Headless::createSurge(48000);
+                REQUIRE(surge);
+
+                Surge::Test::setFX(surge, 0, fxt_tape);
+                auto &drive = surge->storage.getPatch().fx[0].p[chowdsp::TapeEffect::tape_drive];
+                drive.set_value_f01(driveVal);
+
+                if (adaptive)
+                    drive.deform_type |= chowdsp::TapeEffect::tdd_adaptive_oversampling;
+
+                surge->playNote(0, 60, 127, 0);
+
+                double rms = 0.0;
+
+                for (int i = 0; i < 1000; ++i)
+                {
+                    surge->process();
+
+                    for (int s = 0; s < BLOCK_SIZE; ++s)
+                    {
+                        REQUIRE(std::isfinite(surge->output[0][s]));
+                        rms += surge->output[0][s] * surge->output[0][s];
+                    }
+                }
+
+                return std::sqrt(rms / (1000 * BLOCK_SIZE));
+            };
+
+            auto fixedRMS = render(false);
+            auto adaptiveRMS = render(true);
+
+            // whichever rate the model ends up at, it should sound about the same
+            REQUIRE(fixedRMS > 1e-3);
+            REQUIRE(adaptiveRMS == Approx(fixedRMS).epsilon(0.25));
+        }
+    }
+}
+
+TEST_CASE("FX Swap Waits For The UI Without Blocking", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    Surge::Test::setFX(surge, 0, fxt_delay);
+    auto *before = surge->fx[0].get();
+    REQUIRE(before);
+
+    auto *pt = &(surge->storage.getPatch().fx[0].type);
+    auto did = surge->idForParameter(pt);
+
+    {
+        // the UI is looking at the slot, so the audio thread leaves it alone
+        std::lock_guard<std::mutex> g(surge->fxSpawnMutex);
+        surge->setParameter01(did, 1.f * fxt_reverb2 / (pt->val_max.i - pt->val_min.i), false);
+
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        REQUIRE(surge->fx[0].get() == before);
+    }
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    REQUIRE(surge->fx[0].get() != before);
+    REQUIRE(surge->storage.getPatch().fx[0].type.val.i == fxt_reverb2);
+}
+
+TEST_CASE("Reverb2 Sleeps On A Silent Tail", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    Surge::Test::setFX(surge, 0, fxt_reverb2);
+
+    auto &patch = surge->storage.getPatch();
+    auto *fxs = &patch.fx[0];
+    auto *pd = patch.globaldata;
+
+    auto run = [&](float mix) {
+        for (int i = 0; i < n_fx_params; ++i)
+            pd[fxs->p[i].id].f = fxs->p[i].val.f;
+        pd[fxs->p[Reverb2Effect::rev2_mix].id].f = mix;
+
+        std::unique_ptr<Effect> fx(spawn_effect(fxt_reverb2, &surge->storage, fxs, pd));
+        REQUIRE(fx);
+        fx->init();
+
+        float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+
+        // an impulse which is already below the sleep threshold, so the tail is silent throughout
+        memset(L, 0, sizeof(L));
+        memset(R, 0, sizeof(R));
+        L[0] = R[0] = 1e-7f;
+        REQUIRE(fx->process_ringout(L, R, true));
+
+        int blocks = 1;
+
+        while (blocks < 100000)
+        {
+            memset(L, 0, sizeof(L));
+            memset(R, 0, sizeof(R));
+
+            if (!fx->process_ringout(L, R, false))
+                break;
+
+            blocks++;
+        }
+
+        auto res = std::make_pair(blocks, fx->get_ringout_decay());
+
+        // and any input wakes it straight back up
+        L[0] = R[0] = 0.5f;
+        REQUIRE(fx->process_ringout(L, R, true));
+
+        return res;
+    };
+
+    auto [wetBlocks, wetRingout] = run(1.f);
+    REQUIRE(wetBlocks > 48000 / BLOCK_SIZE);
+    REQUIRE(wetBlocks < wetRingout);
+
+    // with no wet signal at the output it can't tell, so it runs the whole ring out
+    auto [dryBlocks, dryRingout] = run(0.f);
+    REQUIRE(dryBlocks == dryRingout);
+}
+
+TEST_CASE("Audio Input Is Only Conditioned For Its Readers", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    auto &storage = surge->storage;
+    surge->process_input = true;
+
+    auto feed = [&](int blocks) {
+        for (int b = 0; b < blocks; ++b)
+        {
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                surge->input[0][s] = 0.3f;
+                surge->input[1][s] = -0.3f;
+            }
+            surge->process();
+        }
+    };
+    auto inputEnergy = [&]() {
+        float e = 0.f;
+        for (int c = 0; c < 2; ++c)
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+                e += std::fabs(storage.audio_in_nonOS[c][s]);
+        return e;
+    };
+
+    feed(10);
+    REQUIRE(storage.audio_in_clients == 0);
+    REQUIRE(inputEnergy() == 0.f);
+
+    Surge::Test::setFX(surge, 0, fxt_vocoder);
+    feed(10);
+    REQUIRE(storage.audio_in_clients > 0);
+    REQUIRE(inputEnergy() > 0.f);
+
+    Surge::Test::setFX(surge, 0, fxt_off);
+    feed(10);
+    REQUIRE(storage.audio_in_clients == 0);
+    REQUIRE(inputEnergy() == 0.f);
+}
+
+TEST_CASE("A Two Channel BBD Line Matches Two Separate Lines", "[fx]")
+{
+    // the ensemble's L2 and R1 used to be two single channel lines at the same delay time
+    auto check = [](auto &left, auto &right, auto &both) {
+        left.prepare(48000.0);
+        right.prepare(48000.0);
+        both.prepare(48000.0);
+        left.setFilterFreq(9000.f);
+        right.setFilterFreq(9000.f);
+        both.setFilterFreq(9000.f);
+
+        int mismatches = 0;
+
+        for (int b = 0; b < 400; ++b)
+        {
+            // sweep the delay time and the filter a block at a time, as the ensemble does
+            auto t = 0.004f + 0.003f * std::sin(b * 0.05f);
+            left.setDelayTime(t);
+            right.setDelayTime(t);
+            both.setDelayTime(t);
+
+            if (b % 4 == 3)
+            {
+                auto f = 6000.f + 4000.f * std::cos(b * 0.02f);
+                left.setFilterFreq(f);
+                right.setFilterFreq(f);
+                both.setFilterFreq(f);
+            }
+
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                float in[2], out[2];
+                in[0] = (float)rand() / (float)RAND_MAX - 0.5f;
+                in[1] = (float)rand() / (float)RAND_MAX - 0.5f;
+
+                both.process(in, out);
+                auto l = left.process(in[0]);
+                auto r = right.process(in[1]);
+
+                if (out[0] != l || out[1] != r)
+                    mismatches++;
+            }
+        }
+
+        REQUIRE(mismatches == 0);
+    };
+
+    SECTION("128 Stages")
+    {
+        auto l = std::make_unique<BBDDelayLine<128>>();
+        auto r = std::make_unique<BBDDelayLine<128>>();
+        auto c = std::make_unique<BBDDelayLine<128, 2>>();
+        check(*l, *r, *c);
+    }
+
+    SECTION("4096 Stages")
+    {
+        auto l = std::make_unique<BBDDelayLine<4096>>();
+        auto r = std::make_unique<BBDDelayLine<4096>>();
+        auto c = std::make_unique<BBDDelayLine<4096, 2>>();
+        check(*l, *r, *c);
+    }
+}
+
+TEST_CASE("The Spring Reverb Allpass Cascade Matches The Nested Allpasses", "[fx]")
+{
+    // the spring runs 16 stages, but each of the old nested allpasses holds two delay lines of
+    // 1 << 18 vectors, so two stages are plenty to compare against
+    using VecType = juce::dsp::SIMDRegister<float>;
+    static constexpr int stages = 2;
+    const float sr = 48000.f;
+
+    std::array<chowdsp::SchroederAllpass<VecType, 2>, stages> reference;
+    chowdsp::SchroederAllpassCascade<stages, 2> cascade;
+
+    for (auto &apf : reference)
+        apf.prepare(sr);
+    cascade.prepare((int)std::ceil((0.35f + 3.0f) / 1000.0f * sr));
+
+    int mismatches = 0;
+
+    for (int b = 0; b < 400; ++b)
+    {
+        // sweep the size and the spin, as the spring's setParams maps them
+        auto size = 0.5f + 0.5f * std::sin(b * 0.03f);
+        auto spin = 0.5f + 0.5f * std::cos(b * 0.07f);
+        auto delay = (0.35f + 3.0f * size) / 1000.0f * sr;
+        auto g = 0.5f - 0.4f * spin;
+        float gv alignas(16)[4] = {g, -g, g, -g};
+
+        for (auto &apf : reference)
+            apf.setParams(delay, VecType::fromRawArray(gv));
+        cascade.setParams(delay, _mm_load_ps(gv));
+
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+        {
+            float x alignas(16)[4], ref alignas(16)[4], res alignas(16)[4];
+
+            for (auto &v : x)
+                v = (float)rand() / (float)RAND_MAX - 0.5f;
+
+            auto y = VecType::fromRawArray(x);
+            for (auto &apf : reference)
+                y = apf.processSample(y);
+            y.copyToRawArray(ref);
+
+            _mm_store_ps(res, cascade.processSample(_mm_load_ps(x)));
+
+            if (memcmp(ref, res, sizeof(ref)) != 0)
+                mismatches++;
+        }
+    }
+
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Four Lane Waveshapes And Diodes Match The Scalar Ones", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    // a platform may fuse a multiply and add in the scalar code but not in the intrinsics
+    auto same = [](float a, float b) {
+        return std::fabs(a - b) <= 1e-6f * std::max(1.f, std::fabs(a));
+    };
+
+    auto randomLanes = [](float range, float *x) {
+        for (int i = 0; i < 4; ++i)
+            x[i] = ((float)rand() / (float)RAND_MAX - 0.5f) * 2.f * range;
+    };
+
+    SECTION("Resonator Waveshapes")
+    {
+        using sst::waveshapers::WaveshaperType;
+
+        for (auto ws : {WaveshaperType::wst_asym, WaveshaperType::wst_soft})
+        {
+            int mismatches = 0;
+
+            // wide enough to reach both ends of the table, where the lookup clips
+            for (int n = 0; n < 20000; ++n)
+            {
+                float x alignas(16)[4], res alignas(16)[4];
+                randomLanes(20.f, x);
+                _mm_store_ps(res, surge->storage.lookup_waveshape(ws, _mm_load_ps(x)));
+
+                for (int i = 0; i < 4; ++i)
+                    if (!same(surge->storage.lookup_waveshape(ws, x[i]), res[i]))
+                        mismatches++;
+            }
+
+            INFO("Waveshaper " << (int)ws);
+            REQUIRE(mismatches == 0);
+        }
+    }
+
+    SECTION("Ring Modulator Diode")
+    {
+        Surge::Test::setFX(surge, 0, fxt_ringmod);
+
+        auto &patch = surge->storage.getPatch();
+        auto *fxs = &patch.fx[0];
+        auto *pd = patch.globaldata;
+
+        for (int i = 0; i < n_fx_params; ++i)
+            pd[fxs->p[i].id] = fxs->p[i].val;
+
+        std::unique_ptr<Effect> fx(spawn_effect(fxt_ringmod, &surge->storage, fxs, pd));
+        auto *ringmod = dynamic_cast<RingModulatorEffect *>(fx.get());
+        REQUIRE(ringmod);
+        ringmod->init();
+
+        // the defaults, a linear region below the bias, and a very narrow quadratic region
+        for (auto [bias, linear] :
+             {std::pair{0.3f, 0.7f}, std::pair{0.6f, 0.2f}, std::pair{0.f, 0.01f}})
+        {
+            pd[fxs->p[RingModulatorEffect::rm_diode_fwdbias].id].f = bias;
+            pd[fxs->p[RingModulatorEffect::rm_diode_linregion].id].f = linear;
+
+            int mismatches = 0;
+
+            for (int n = 0; n < 20000; ++n)
+            {
+                float x alignas(16)[4], res alignas(16)[4];
+                randomLanes(2.f, x);
+                _mm_store_ps(res, ringmod->diode_sim(_mm_load_ps(x)));
+
+                for (int i = 0; i < 4; ++i)
+                    if (!same(ringmod->diode_sim(x[i]), res[i]))
+                        mismatches++;
+            }
+
+            INFO("Bias " << bias << " linear region " << linear);
+            REQUIRE(mismatches == 0);
+        }
+    }
+}
+
+TEST_CASE("The Conditioner's Idle Limiter Matches The Per Sample One", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    Surge::Test::setFX(surge, 0, fxt_conditioner);
+
+    auto &patch = surge->storage.getPatch();
+    auto *fxs = &patch.fx[0];
+    auto *pd = patch.globaldata;
+
+    for (int i = 0; i < n_fx_params; ++i)
+        pd[fxs->p[i].id] = fxs->p[i].val;
+
+    std::unique_ptr<Effect> blockwise(spawn_effect(fxt_conditioner, &surge->storage, fxs, pd));
+    std::unique_ptr<Effect> perSample(spawn_effect(fxt_conditioner, &surge->storage, fxs, pd));
+    REQUIRE(blockwise);
+    REQUIRE(perSample);
+
+    dynamic_cast<ConditionerEffect *>(perSample.get())->force_per_sample_limiter = true;
+    blockwise->init();
+    perSample->init();
+
+    long phase = 0;
+    int mismatches = 0;
+
+    // quiet enough to leave the limiter idle, then loud enough to make it work and recover
+    for (auto [amp, blocks] : {std::pair{0.05f, 300}, std::pair{3.f, 100}, std::pair{0.05f, 600}})
+    {
+        for (int b = 0; b < blocks; ++b)
+        {
+            float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+            float pL alignas(16)[BLOCK_SIZE], pR alignas(16)[BLOCK_SIZE];
+
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                L[s] = amp * std::sin(2.0 * M_PI * 220.0 * phase / 48000.0);
+                R[s] = amp * std::sin(2.0 * M_PI * 330.0 * phase / 48000.0);
+                pL[s] = L[s];
+                pR[s] = R[s];
+                phase++;
+            }
+
+            blockwise->process(L, R);
+            perSample->process(pL, pR);
+
+            if (memcmp(L, pL, sizeof(L)) != 0 || memcmp(R, pR, sizeof(R)) != 0 ||
+                blockwise->vu[2] != perSample->vu[2])
+                mismatches++;
+        }
+    }
+
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("The Rotary Horn Taps Match The Scalar Sinc Read", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    REQUIRE(surge);
+
+    const float *sinc = surge->storage.sinctable1X;
+    const int mask = max_delay_length - 1;
+
+    // a delay line padded and mirrored at the wrap, as the horn keeps it
+    std::vector<float> buffer(max_delay_length + FIRipol_N);
+    for (int i = 0; i < max_delay_length; ++i)
+        buffer[i] = (float)rand() / (float)RAND_MAX - 0.5f;
+    for (int i = 0; i < FIRipol_N; ++i)
+        buffer[i + max_delay_length] = buffer[i];
+
+    int mismatches = 0;
+
+    for (int n = 0; n < 20000; ++n)
+    {
+        int wpos = (rand() % (max_delay_length / BLOCK_SIZE)) * BLOCK_SIZE;
+        int k = rand() % BLOCK_SIZE;
+        float dtime = BLOCK_SIZE + (float)rand() / (float)RAND_MAX * 20000.f;
+
+        // short delays straddle the wrap, which is where the padding has to stand in
+        if (n % 4 == 0)
+            wpos = 0;
+
+        int i_dtime = std::max(BLOCK_SIZE, std::min((int)dtime, max_delay_length - FIRipol_N - 1));
+        int sincIdx = FIRipol_N * limit_range((int)(FIRipol_M * (float(i_dtime + 1) - dtime)), 0,
+                                              FIRipol_M - 1);
+
+        // the read as it was, one tap at a time backwards from the newest
+        int rp = wpos - i_dtime + k;
+        float ref = 0.f;
+        for (int i = 0; i < FIRipol_N; i++)
+            ref += buffer[(rp - i) & mask] * sinc[sincIdx + FIRipol_N - i];
+
+        auto res = RotarySpeakerEffect::read_horn_tap(&buffer[(rp - (FIRipol_N - 1)) & mask],
+                                                      &sinc[sincIdx + 1]);
+
+        // the vector sums the taps in a different order
+        if (std::fabs(res - ref) > 1e-5f)
+            mismatches++;
+    }
+
+    REQUIRE(mismatches == 0);
+}
@@ -21,10 +21,20 @@
  */
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <thread>
 
 #include "HeadlessUtils.h"
+#include "UnitTestUtilities.h"
 #include "BiquadFilter.h"
 #include "MemoryPool.h"
+#include "BlockProfiler.h"
+#include "EngineServer.h"
+#include "LargeBuffers.h"
+#include "RealtimeChecker.h"
+#include "ScopeTap.h"
+#include "TraceRecorder.h"
 
 #include "sst/plugininfra/strnatcmp.h"
 
@@ -180,6 +190,86 @@ TEST_CASE("Memory Pool Works", "[infra]")
         REQUIRE(CountAlloc<3>::alloc == 160);
         REQUIRE(CountAlloc<3>::ct == 0);
     }
+
+    SECTION("Reserve Covers The Grow")
+    {
+        {
+            auto pool = std::make_unique<Surge::Memory::MemoryPool<CountAlloc<4>, 8, 4, 500>>();
+            std::deque<CountAlloc<4> *> tmp;
+
+            // nothing has asked for a reserve yet
+            REQUIRE(pool->replenishReserve() == 0);
+
+            while (pool->position > pool->reserveLowWater)
+                tmp.push_back(pool->getItem());
+
+            REQUIRE(pool->replenishReserve() == pool->reserveHighWater);
+            REQUIRE(pool->reserveCount() == pool->reserveHighWater);
+
+            auto allocBefore = CountAlloc<4>::alloc;
+            auto available = pool->position + pool->reserveCount();
+            for (size_t i = 0; i < available; ++i)
+                tmp.push_back(pool->getItem());
+
+            REQUIRE(CountAlloc<4>::alloc == allocBefore);
+            REQUIRE(pool->reserveCount() == 0);
+
+            // dry on both sides falls back to growing in place
+            tmp.push_back(pool->getItem());
+            REQUIRE(CountAlloc<4>::alloc > allocBefore);
+
+            for (auto q : tmp)
+                pool->returnItem(q);
+        }
+        REQUIRE(CountAlloc<4>::ct == 0);
+    }
+
+    SECTION("Handed Out Items Are Scrubbed")
+    {
+        struct Scrubbable
+        {
+            bool used{false};
+        };
+        auto pool = std::make_unique<Surge::Memory::MemoryPool<Scrubbable, 8, 4, 500>>();
+        int scrubs{0};
+        pool->setScrubber([&scrubs](auto *s) {
+            s->used = false;
+            scrubs++;
+        });
+        REQUIRE(scrubs == 8);
+
+        std::vector<Scrubbable *> out;
+        for (int i = 0; i < 6; ++i)
+        {
+            out.push_back(pool->getItem());
+            REQUIRE(!out.back()->used);
+            out.back()->used = true;
+        }
+
+        // with the pool this low they go straight back and get scrubbed on the way out
+        for (auto *q : out)
+            pool->returnItem(q);
+        out.clear();
+
+        for (int i = 0; i < 6; ++i)
+        {
+            out.push_back(pool->getItem());
+            REQUIRE(!out.back()->used);
+        }
+        for (auto *q : out)
+            pool->returnItem(q);
+
+        // with spare in the pool a returned item is scrubbed by the replenisher instead
+        pool->setupPoolToSize(20);
+        auto *q = pool->getItem();
+        q->used = true;
+        pool->returnItem(q);
+        REQUIRE(pool->position == 19);
+        REQUIRE(q->used);
+
+        pool->replenishReserve();
+        REQUIRE(!q->used);
+    }
 }
 
 TEST_CASE("strnatcmp With Spaces", "[infra]")
@@ -233,4 +323,590 @@ TEST_CASE("strnatcmp With Spaces", "[infra]")
     }
 
     SECTION("Doubled Spaces") { REQUIRE(strnatcmp("Spa  Day", "Spa Day") == 0); }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Block Profiler Reports Sections", "[infra]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &prof = surge->blockProfiler;
+    REQUIRE(!prof.isEnabled());
+
+    for (int q = 0; q < 20; ++q)
+        surge->process();
+    REQUIRE(prof.getBlocksProfiled() == 0);
+
+    prof.setEnabled(true);
+    surge->playNote(0, 60, 127, 0);
+
+    for (int q = 0; q < 200; ++q)
+        surge->process();
+
+    REQUIRE(prof.getBlocksProfiled() == 200);
+    REQUIRE(prof.getPeak(Surge::Profiling::ps_voices) > 0);
+    REQUIRE(prof.getPeak(Surge::Profiling::ps_modulation) > 0);
+    REQUIRE(prof.getTotalLoad() > 0);
+
+    for (int i = 0; i < Surge::Profiling::n_profile_sections; ++i)
+    {
+        REQUIRE(std::isfinite(prof.getLoad(i)));
+        REQUIRE(prof.getLoad(i) >= 0);
+    }
+
+    REQUIRE(Surge::Profiling::BlockProfiler::sectionName(Surge::Profiling::ps_fx_first +
+                                                         fxslot_send1) == "fx/send/1");
+}
+
+TEST_CASE("Deadline Monitor Keeps Late Blocks", "[infra]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &dm = surge->deadlineMonitor;
+
+    for (int q = 0; q < 20; ++q)
+        surge->process();
+    REQUIRE(dm.getMissCount() == 0);
+
+    // with no threshold every block is late, which lets us look at what gets recorded
+    dm.setThreshold(0.f);
+    surge->blockProfiler.setEnabled(true);
+    surge->playNote(0, 60, 127, 0);
+    surge->storage.noteBlockEvent(SurgeStorage::be_wavetableLoad);
+
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    REQUIRE(dm.getMissCount() == 10);
+
+    auto h = dm.getHistory();
+    REQUIRE(h.size() == 10);
+    REQUIRE(h.front().sequence == 1);
+    REQUIRE(h.back().sequence == 10);
+    REQUIRE(h.back().block == h.front().block + 9);
+    REQUIRE(h.back().voices > 0);
+
+    // the event lands on the block it happened before, and only that one
+    REQUIRE(h.front().events == SurgeStorage::be_wavetableLoad);
+    REQUIRE(h.back().events == 0);
+    REQUIRE(h.front().describe().find("wavetable load") != std::string::npos);
+
+    for (int q = 0; q < (int)Surge::Profiling::DeadlineMonitor::historySize; ++q)
+        surge->process();
+
+    h = dm.getHistory();
+    REQUIRE(h.size() == Surge::Profiling::DeadlineMonitor::historySize);
+    REQUIRE(h.back().sequence == dm.getMissCount());
+    REQUIRE(h.back().topSection >= 0);
+
+    dm.clear();
+    REQUIRE(dm.getMissCount() == 0);
+    REQUIRE(dm.getHistory().empty());
+
+    // and nothing is late when rendering offline
+    surge->storage.renderingOffline = true;
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+    REQUIRE(dm.getMissCount() == 0);
+}
+
+TEST_CASE("Patch Load Profile Splits A Load", "[infra]")
+{
+    using PLP = Surge::Profiling::PatchLoadProfile;
+
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &profile = surge->storage.patchLoadProfile;
+    auto loads = profile.getLoadCount();
+
+    REQUIRE(surge->loadPatchByPath(
+        "resources/data/patches_factory/Tutorials/Formula Modulator/01 A Simple Formula.fxp", -1,
+        "Tutorials"));
+    REQUIRE(profile.getLoadCount() == loads + 1);
+
+    REQUIRE(profile.getNs(PLP::lp_load) > 0);
+    REQUIRE(profile.getNs(PLP::lp_parse) > 0);
+    REQUIRE(profile.getNs(PLP::lp_fx) > 0);
+    REQUIRE(profile.getNs(PLP::lp_parse) + profile.getNs(PLP::lp_fx) <=
+            profile.getNs(PLP::lp_load));
+    REQUIRE(profile.getNs(PLP::lp_firstBlock) == 0);
+
+    // only the first block after the load counts
+    surge->process();
+    auto firstBlock = profile.getNs(PLP::lp_firstBlock);
+    REQUIRE(firstBlock > 0);
+    surge->process();
+    REQUIRE(profile.getNs(PLP::lp_firstBlock) == firstBlock);
+
+#if HAS_LUA
+    // the formula compiles when a voice starts its LFO, and that still belongs to this load
+    surge->playNote(0, 60, 127, 0);
+    for (int q = 0; q < 4; ++q)
+        surge->process();
+    REQUIRE(profile.getNs(PLP::lp_formulas) > 0);
+#endif
+
+    REQUIRE(std::string(PLP::phaseName(PLP::lp_firstBlock)) == "first-block");
+}
+
+TEST_CASE("Memory Footprint Reports Subsystems", "[infra]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto bytesOf = [](const Surge::Profiling::MemoryFootprint &fp, const std::string &name) {
+        for (const auto &s : fp.subsystems)
+            if (s.name == name)
+                return s.bytes;
+        return (size_t)0;
+    };
+
+    auto fp = surge->getMemoryFootprint();
+    REQUIRE(bytesOf(fp, "voices") ==
+            n_scenes * surge->voiceCapacity() * sizeof(SurgeVoice));
+    REQUIRE(bytesOf(fp, "patch") == sizeof(SurgePatch));
+    REQUIRE(bytesOf(fp, "wavetables") + bytesOf(fp, "shared wavetables") > 0);
+    REQUIRE(fp.total() > bytesOf(fp, "voices") + bytesOf(fp, "storage"));
+    REQUIRE(fp.describe().find("total") != std::string::npos);
+
+    // loading an effect adds at least its instance
+    auto fxBefore = bytesOf(fp, "effects");
+    Surge::Test::setFX(surge, 0, fxt_delay);
+    fp = surge->getMemoryFootprint();
+    REQUIRE(bytesOf(fp, "effects") > fxBefore);
+
+    // shared entries are listed but not part of the total
+    size_t unshared = 0;
+    for (const auto &s : fp.subsystems)
+        if (!s.shared)
+            unshared += s.bytes;
+    REQUIRE(fp.total() == unshared);
+}
+
+TEST_CASE("Editor Change Bus Marks What Moved", "[infra]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+    surge->editorChanges.take();
+
+    SECTION("Nothing Moves, Nothing Is Marked")
+    {
+        surge->process();
+        REQUIRE(!surge->editorChanges.take().any());
+    }
+
+    SECTION("Host Automation Marks Its Parameter Range")
+    {
+        auto *cutoff = &surge->storage.getPatch().scene[0].filterunit[0].cutoff;
+        surge->setParameter01(surge->idForParameter(cutoff), 0.3f, true);
+
+        auto c = surge->editorChanges.take();
+        REQUIRE(c.has(EditorChangeBus::ch_parameters));
+        REQUIRE(c.hasParameterInRange(cutoff->id, n_total_params));
+        REQUIRE(!c.has(EditorChangeBus::ch_meters));
+        REQUIRE(!surge->editorChanges.take().any());
+    }
+
+    SECTION("Notes Mark Keys, Voices And Meters")
+    {
+        surge->playNote(0, 60, 100, 0);
+        for (int i = 0; i < 4; ++i)
+            surge->process();
+
+        auto c = surge->editorChanges.take();
+        REQUIRE(c.has(EditorChangeBus::ch_midiKeys));
+        REQUIRE(c.has(EditorChangeBus::ch_voices));
+        REQUIRE(c.has(EditorChangeBus::ch_meters));
+        REQUIRE(!c.has(EditorChangeBus::ch_parameters));
+    }
+}
+
+TEST_CASE("Scope Tap Keeps Every Peak", "[infra]")
+{
+    SECTION("Runs Fold To Min And Max In Order")
+    {
+        ScopeTap tap;
+        tap.decimation = 4;
+
+        float L[8] = {0, 0.9f, 0, 0, 0, 0, -0.8f, 0.5f};
+        float R[8] = {0, -0.3f, 0.2f, 0, 0.1f, 0.1f, 0.1f, 0.1f};
+        float oL[10], oR[10];
+
+        REQUIRE(tap.process(L, R, 8, oL, oR) == 4);
+        REQUIRE(oL[0] == 0.f);
+        REQUIRE(oL[1] == 0.9f);
+        REQUIRE(oL[2] == -0.8f);
+        REQUIRE(oL[3] == 0.5f);
+        REQUIRE(oR[0] == -0.3f);
+        REQUIRE(oR[1] == 0.2f);
+        REQUIRE(oR[2] == 0.1f);
+        REQUIRE(oR[3] == 0.1f);
+
+        // a run can straddle two calls
+        tap.decimation = 8;
+        REQUIRE(tap.process(L, R, 5, oL, oR) == 0);
+        REQUIRE(tap.process(L + 5, R + 5, 3, oL, oR) == 2);
+        REQUIRE(oL[0] == 0.9f);
+        REQUIRE(oL[1] == -0.8f);
+    }
+
+    SECTION("The Engine Pushes Folded Blocks")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+
+        surge->storage.audioOut.subscribe();
+        surge->storage.audioOutTap.decimation = 8;
+        surge->playNote(0, 60, 100, 0);
+
+        for (int i = 0; i < 4; ++i)
+            surge->process();
+
+        auto data = surge->storage.audioOut.popall();
+        REQUIRE(data.first.size() == 4 * BLOCK_SIZE * 2 / 8);
+        REQUIRE(data.second.size() == data.first.size());
+        REQUIRE(std::any_of(data.first.begin(), data.first.end(),
+                            [](float f) { return std::fabs(f) > 1e-4; }));
+
+        surge->storage.audioOutTap.decimation = 1;
+        surge->process();
+        REQUIRE(surge->storage.audioOut.popall().first.size() == BLOCK_SIZE);
+        surge->storage.audioOut.unsubscribe();
+    }
+
+    SECTION("Triple Buffer Hands Over The Latest")
+    {
+        TripleBuffer<int> tb;
+        REQUIRE(!tb.update());
+
+        tb.back() = 1;
+        tb.publish();
+        tb.back() = 2;
+        tb.publish();
+
+        REQUIRE(tb.update());
+        REQUIRE(tb.front() == 2);
+        REQUIRE(!tb.update());
+        REQUIRE(tb.front() == 2);
+
+        tb.back() = 3;
+        tb.publish();
+        REQUIRE(tb.update());
+        REQUIRE(tb.front() == 3);
+    }
+}
+
+TEST_CASE("Trace Recorder Writes Chrome Traces", "[infra]")
+{
+    using Surge::Profiling::TraceRecorder;
+
+    SECTION("Nothing Is Kept While Disabled")
+    {
+        TraceRecorder tr;
+        tr.record("nope", -1, 0, 10);
+        REQUIRE(tr.snapshot().empty());
+    }
+
+    SECTION("The Ring Keeps The Newest Events")
+    {
+        TraceRecorder tr;
+        tr.setEnabled(true);
+
+        auto n = TraceRecorder::defaultCapacity + 100;
+        for (size_t i = 0; i < n; ++i)
+            tr.record("event", (int)i, i, i + 5);
+
+        auto ev = tr.snapshot();
+        REQUIRE(ev.size() == TraceRecorder::defaultCapacity);
+        REQUIRE(ev.front().index == 100);
+        REQUIRE(ev.back().index == (int)n - 1);
+        REQUIRE(ev.back().durationNs == 5);
+
+        tr.clear();
+        REQUIRE(tr.snapshot().empty());
+    }
+
+    SECTION("Scopes Export As Complete Events")
+    {
+        TraceRecorder tr;
+        tr.setEnabled(true);
+        {
+            TraceRecorder::Scope s(tr, "outer \"quoted\"", 3);
+            TraceRecorder::Scope t(tr, "inner");
+        }
+
+        std::ostringstream oss;
+        tr.writeChromeTrace(oss);
+        auto json = oss.str();
+
+        REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+        REQUIRE(json.find("\"name\":\"outer \\\"quoted\\\"\"") != std::string::npos);
+        REQUIRE(json.find("\"name\":\"inner\"") != std::string::npos);
+        REQUIRE(json.find("\"args\":{\"index\":3}") != std::string::npos);
+        REQUIRE(json.find("\"ph\":\"X\"") != std::string::npos);
+    }
+
+    SECTION("The Engine Records Its Blocks")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+
+        surge->traceRecorder.setEnabled(true);
+        surge->playNote(0, 60, 127, 0);
+        for (int q = 0; q < 20; ++q)
+            surge->process();
+
+        auto ev = surge->traceRecorder.snapshot();
+        auto count = [&ev](const std::string &name) {
+            return std::count_if(ev.begin(), ev.end(),
+                                 [&name](auto &e) { return name == e.name; });
+        };
+
+        if (TraceRecorder::isCompiledIn())
+        {
+            REQUIRE(count("process") == 20);
+            REQUIRE(count("scene") > 0);
+        }
+        else
+        {
+            REQUIRE(ev.empty());
+        }
+    }
+}
+
+TEST_CASE("Instances Share Their Immutable Core", "[infra]")
+{
+    auto a = Surge::Headless::createSurge(44100, true);
+    auto b = Surge::Headless::createSurge(48000, true);
+    REQUIRE(a);
+    REQUIRE(b);
+
+    // one copy of the sinc tables, but the rate dependent tables stay per instance
+    REQUIRE(a->storage.sincTableProvider == b->storage.sincTableProvider);
+    REQUIRE(a->storage.sinctable == b->storage.sinctable);
+    REQUIRE(a->storage.table_envrate_linear[100] != b->storage.table_envrate_linear[100]);
+
+    // as are the lookup tables which don't depend on the rate, and they still hold their values
+    REQUIRE(a->storage.table_dB == b->storage.table_dB);
+    REQUIRE(a->storage.table_pitch_ignoring_tuning == b->storage.table_pitch_ignoring_tuning);
+    REQUIRE(a->storage.table_two_to_the == b->storage.table_two_to_the);
+    REQUIRE(a->storage.db_to_linear(0.f) == Approx(1.f));
+    REQUIRE(a->storage.note_to_pitch_ignoring_tuning(12.f) == Approx(2.f));
+    REQUIRE(a->storage.note_to_pitch_inv_ignoring_tuning(12.5f) == Approx(pow(2.0, -12.5 / 12)));
+    REQUIRE(a->storage.note_to_pitch(12.f) == b->storage.note_to_pitch(12.f));
+
+    // and the shared factory scan gives the second instance the same library as the first
+    REQUIRE(a->storage.patch_list.size() == b->storage.patch_list.size());
+    REQUIRE(a->storage.patch_category.size() == b->storage.patch_category.size());
+    REQUIRE(a->storage.wt_list.size() == b->storage.wt_list.size());
+
+    for (int i = 0; i < a->storage.patch_list.size(); ++i)
+    {
+        REQUIRE(a->storage.patch_list[i].path == b->storage.patch_list[i].path);
+        REQUIRE(a->storage.patch_list[i].category == b->storage.patch_list[i].category);
+    }
+
+    for (int i = 0; i < a->storage.patch_category.size(); ++i)
+        REQUIRE(a->storage.patch_category[i].internalid == i);
+
+    // an explicit refresh rescans and still sees the same thing
+    b->storage.refresh_patchlist();
+    REQUIRE(a->storage.patch_list.size() == b->storage.patch_list.size());
+}
+
+TEST_CASE("Engine Server Renders Linked Engines", "[infra]")
+{
+    using namespace Surge::EngineServer;
+
+    EngineServer server(2);
+    std::vector<std::unique_ptr<LinkClient>> clients;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        auto region = SharedMemoryRegion::local(EngineServer::regionSize());
+        auto *r = region.get();
+        REQUIRE(server.addEngine(Surge::Headless::createSurge(44100), std::move(region)) == i);
+        clients.push_back(std::make_unique<LinkClient>(*r));
+        REQUIRE(clients.back()->valid());
+    }
+
+    // only the middle engine gets a note
+    LinkEvent on;
+    on.midi[0] = 0x90;
+    on.midi[1] = 60;
+    on.midi[2] = 100;
+    REQUIRE(clients[1]->pushEvent(on));
+
+    float outL[BLOCK_SIZE], outR[BLOCK_SIZE];
+    float rms[3]{};
+
+    for (int b = 0; b < 200; ++b)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            REQUIRE(clients[c]->exchangeBlock(nullptr, nullptr, outL, outR));
+
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+                rms[c] += outL[s] * outL[s] + outR[s] * outR[s];
+        }
+
+        REQUIRE(server.renderPending() == 3);
+    }
+
+    REQUIRE(rms[0] == 0.f);
+    REQUIRE(rms[1] > 0.f);
+    REQUIRE(rms[2] == 0.f);
+
+    // the reply to a block comes back with the next one, so only the first block is silent
+    for (auto &c : clients)
+        REQUIRE(c->underruns() == 1);
+
+    // an engine which has nothing to do is skipped
+    server.removeEngine(0);
+    REQUIRE(clients[1]->exchangeBlock(nullptr, nullptr, outL, outR));
+    REQUIRE(server.renderPending() == 1);
+}
+
+TEST_CASE("Large Buffers Come Back Zeroed", "[infra]")
+{
+    using namespace Surge::Memory;
+
+    auto before = largeBufferHugePageBytes();
+
+    for (size_t bytes : {(size_t)1000, hugePageBytes, 3 * hugePageBytes + 100})
+    {
+        INFO("Allocating " << bytes);
+        auto *p = static_cast<uint8_t *>(allocateLargeBuffer(bytes));
+        REQUIRE(p);
+        REQUIRE((uintptr_t)p % 64 == 0);
+
+        for (size_t i = 0; i < bytes; i += 997)
+            REQUIRE(p[i] == 0);
+
+        p[bytes - 1] = 1;
+
+#if LINUX
+        if (bytes >= hugePageBytes)
+        {
+            REQUIRE((uintptr_t)p % hugePageBytes == 0);
+            REQUIRE(largeBufferHugePageBytes() >= before + bytes);
+        }
+#endif
+
+        freeLargeBuffer(p, bytes);
+    }
+
+    static int alive = 0;
+    struct Counted
+    {
+        Counted() { alive++; }
+        ~Counted() { alive--; }
+        float data[1024];
+    };
+
+    {
+        auto a = makeLargeArray<Counted>(1000);
+        REQUIRE(alive == 1000);
+        REQUIRE(a[999].data[1023] == 0.f);
+    }
+    REQUIRE(alive == 0);
+}
+
+TEST_CASE("Realtime Checker Flags Allocations In Scope", "[infra]")
+{
+    using Surge::Debug::RealtimeChecker;
+
+    RealtimeChecker::clear();
+
+    auto outside = std::make_unique<std::vector<int>>(100);
+
+    {
+        RealtimeChecker::Scope s;
+        auto inside = std::make_unique<std::vector<int>>(100);
+
+        {
+            RealtimeChecker::Allow a;
+            auto allowed = std::make_unique<std::vector<int>>(100);
+        }
+    }
+
+    if (RealtimeChecker::isCompiledIn())
+    {
+        // two news (the vector and its storage) and the two matching deletes
+        REQUIRE(RealtimeChecker::getViolationCount(RealtimeChecker::rt_allocation) >= 4);
+        REQUIRE(!RealtimeChecker::report().empty());
+    }
+    else
+    {
+        REQUIRE(RealtimeChecker::getViolationCount() == 0);
+    }
+
+    RealtimeChecker::clear();
+    REQUIRE(RealtimeChecker::getViolationCount() == 0);
+    REQUIRE(RealtimeChecker::report().empty());
+}
+
+/*
+ * Hidden, since it only means something in a SURGE_BUILD_WITH_RT_CHECKS build and takes a
+ * while: run it there with "[realtime]". Every factory patch is reached with a program change,
+ * as a host would, then played with an FX swap, and anything the audio path did which it
+ * shouldn't fails the test with the stacks which did it.
+ */
+TEST_CASE("Factory Patches Play Realtime Safely", "[.realtime]")
+{
+    using Surge::Debug::RealtimeChecker;
+
+    if (!RealtimeChecker::isCompiledIn())
+    {
+        SKIP("Build with SURGE_BUILD_WITH_RT_CHECKS to check the audio path");
+    }
+
+    auto surge = Surge::Headless::createSurge(48000, true);
+    REQUIRE(surge);
+
+    for (int q = 0; q < 100; ++q)
+        surge->process();
+
+    RealtimeChecker::clear();
+
+    auto nPatches = (int)surge->storage.patch_list.size();
+    for (int i = 0; i < nPatches; ++i)
+    {
+        surge->channelController(0, 0, i >> 7);
+        surge->programChange(0, i & 127);
+
+        // the load itself runs off the audio thread, so let it finish
+        for (int b = 0; b < 5000; ++b)
+        {
+            surge->process();
+            if (surge->patchid_queue < 0 && !surge->halt_engine)
+                break;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+
+        surge->playNote(0, 60, 100, 0);
+        for (int b = 0; b < 50; ++b)
+            surge->process();
+
+        Surge::Test::setFX(surge, 0, (fx_type)(1 + i % (n_fx_types - 1)));
+
+        surge->releaseNote(0, 60, 0);
+        for (int b = 0; b < 50; ++b)
+            surge->process();
+    }
+
+    auto report = RealtimeChecker::report();
+    for (const auto &r : report)
+        UNSCOPED_INFO(r);
+
+    INFO(RealtimeChecker::getViolationCount(RealtimeChecker::rt_allocation)
+         << " allocations, " << RealtimeChecker::getViolationCount(RealtimeChecker::rt_lock)
+         << " locks and " << RealtimeChecker::getViolationCount(RealtimeChecker::rt_fileIO)
+         << " file operations on the audio path over " << nPatches << " patches");
+    REQUIRE(RealtimeChecker::getViolationCount() == 0);
+}
@@ -34,6 +34,12 @@
 #include <thread>
 
 #include "UserDefaults.h"
+#include "WavetableLoader.h"
+#include "WavetableScriptEvaluator.h"
+#include "DirectoryManifest.h"
+#include "WavetableDiskCache.h"
+#include "RenderWorkerPool.h"
+#include <fstream>
 #include <unordered_map>
 
 using namespace Surge::Test;
@@ -95,6 +101,214 @@ TEST_CASE("All Factory Wavetables Are Loadable", "[io]")
     }
 }
 
+TEST_CASE("Identical Wavetables Share Their Tables", "[io]")
+{
+    auto a = Surge::Headless::createSurge(44100, true);
+    auto b = Surge::Headless::createSurge(44100, true);
+    REQUIRE(a);
+    REQUIRE(b);
+
+    std::string wtPath;
+    for (const auto &w : a->storage.wt_list)
+    {
+        if (path_to_string(w.path.extension()) == ".wt")
+        {
+            wtPath = path_to_string(w.path);
+            break;
+        }
+    }
+    REQUIRE(!wtPath.empty());
+
+    auto &wa = a->storage.getPatch().scene[0].osc[0].wt;
+    auto &wb = b->storage.getPatch().scene[1].osc[2].wt;
+    a->storage.load_wt(wtPath, &wa, nullptr);
+    b->storage.load_wt(wtPath, &wb, nullptr);
+
+    REQUIRE(wa.hasSharedTables());
+    REQUIRE(wa.TableF32Data == wb.TableF32Data);
+    REQUIRE(wa.TableF32WeakPointers[1][0] == wb.TableF32WeakPointers[1][0]);
+
+    SECTION("Copies Share Too")
+    {
+        Wavetable c;
+        c.Copy(&wa);
+        REQUIRE(c.TableF32Data == wa.TableF32Data);
+        REQUIRE(c.size == wa.size);
+    }
+
+    SECTION("Writing Takes A Private Copy")
+    {
+        auto before = wb.TableF32WeakPointers[0][0][10];
+
+        wa.makeTablesUnique();
+        REQUIRE(!wa.hasSharedTables());
+        REQUIRE(wa.TableF32Data != wb.TableF32Data);
+        REQUIRE(wa.TableF32WeakPointers[0][0][10] == before);
+
+        wa.TableF32WeakPointers[0][0][10] = before + 1.f;
+        REQUIRE(wb.TableF32WeakPointers[0][0][10] == before);
+    }
+}
+
+TEST_CASE("Wavetables Load Off The Audio Thread", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+    REQUIRE(surge->storage.wt_list.size() > 0);
+
+    surge->storage.setLoadWavetablesOffAudioThread(true);
+    REQUIRE(surge->storage.isLoadingWavetablesOffAudioThread());
+
+    auto &osc = surge->storage.getPatch().scene[0].osc[0];
+    osc.queue_type = ot_wavetable;
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    int idx = -1, ct = 0;
+    for (const auto &w : surge->storage.wt_list)
+    {
+        if (w.name == "Sine Power HQ")
+            idx = ct;
+        ct++;
+    }
+    REQUIRE(idx >= 0);
+
+    osc.wt.queue_id = idx;
+    surge->process();
+
+    // the request has been taken from the queue but the table is built elsewhere
+    REQUIRE(osc.wt.queue_id == -1);
+
+    int blocks = 0;
+    while (osc.wavetable_display_name != "Sine Power HQ" && blocks < 10000)
+    {
+        surge->process();
+        std::this_thread::sleep_for(1ms);
+        blocks++;
+    }
+
+    REQUIRE(osc.wavetable_display_name == "Sine Power HQ");
+    REQUIRE(osc.wt.current_id == idx);
+    REQUIRE(osc.wt.everBuilt);
+    REQUIRE(osc.wt.n_tables > 0);
+    REQUIRE(!surge->storage.wavetableLoader->hasOutstandingLoads());
+
+    float sumAbsOut = 0;
+    surge->playNote(0, 60, 127, 0);
+    for (int q = 0; q < 100; ++q)
+    {
+        surge->process();
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+            sumAbsOut += fabs(surge->output[0][s]);
+    }
+    REQUIRE(sumAbsOut > 1);
+}
+
+TEST_CASE("Scripted Wavetables Generate Off The Audio Thread", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+
+    surge->storage.setLoadWavetablesOffAudioThread(true);
+
+    auto &osc = surge->storage.getPatch().scene[0].osc[1];
+    osc.queue_type = ot_wavetable;
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    auto loader = surge->storage.wavetableLoader.get();
+    loader->requestScriptedTable(0, 1, Surge::WavetableScript::defaultWavetableFormula(), 256, 8);
+    REQUIRE(loader->hasOutstandingLoads());
+
+    int done = 0, total = 0, blocks = 0;
+    std::vector<float> latest;
+    while (loader->scriptedTableProgress(0, 1, done, total, latest) && blocks < 10000)
+    {
+        surge->process();
+        std::this_thread::sleep_for(1ms);
+        blocks++;
+    }
+
+    REQUIRE(total == 8);
+    REQUIRE(done == 8);
+    REQUIRE(latest.size() == 256);
+    REQUIRE(osc.wavetable_display_name == "Scripted Wavetable");
+    REQUIRE(osc.wt.n_tables == 8);
+    REQUIRE(osc.wt.size == 256);
+    REQUIRE(!loader->hasOutstandingLoads());
+}
+
+TEST_CASE("Long Samples Load Head First", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+
+    // a mono float wav with no loop or wavetable metadata, so it loads as a sample
+    const int samples = 300000;
+    auto fn = fs::temp_directory_path() / "surge-long-sample-test.wav";
+    {
+        std::ofstream of(fn, std::ios::binary);
+        auto w4 = [&of](uint32_t v) { of.write(reinterpret_cast<const char *>(&v), 4); };
+        auto w2 = [&of](uint16_t v) { of.write(reinterpret_cast<const char *>(&v), 2); };
+
+        of.write("RIFF", 4);
+        w4(36 + samples * 4);
+        of.write("WAVEfmt ", 8);
+        w4(16);
+        w2(3);
+        w2(1);
+        w4(44100);
+        w4(44100 * 4);
+        w2(4);
+        w2(32);
+        of.write("data", 4);
+        w4(samples * 4);
+        for (int i = 0; i < samples; ++i)
+        {
+            float f = 0.5f * std::sin(i * 0.01f);
+            of.write(reinterpret_cast<const char *>(&f), 4);
+        }
+    }
+
+    auto head = std::make_unique<Wavetable>();
+    bool headOnly = false;
+    surge->storage.load_wt(path_to_string(fn), head.get(), nullptr, 16, &headOnly);
+    REQUIRE(headOnly);
+    REQUIRE(head->n_tables == 16 + 3);
+
+    auto full = std::make_unique<Wavetable>();
+    surge->storage.load_wt(path_to_string(fn), full.get(), nullptr, 0, &headOnly);
+    REQUIRE(!headOnly);
+    REQUIRE(full->n_tables > 2 * Surge::Storage::WavetableLoader::sampleHeadWindows);
+
+    // the head is exactly the start of the whole sample
+    REQUIRE(head->size == full->size);
+    for (int t = 0; t < 16; ++t)
+        REQUIRE(memcmp(head->TableF32WeakPointers[0][t], full->TableF32WeakPointers[0][t],
+                       full->size * sizeof(float)) == 0);
+
+    surge->storage.setLoadWavetablesOffAudioThread(true);
+
+    auto &osc = surge->storage.getPatch().scene[0].osc[0];
+    osc.wt.queue_filename = path_to_string(fn);
+
+    int blocks = 0;
+    while ((osc.wt.n_tables != full->n_tables ||
+            surge->storage.wavetableLoader->hasOutstandingLoads()) &&
+           blocks < 10000)
+    {
+        surge->process();
+        std::this_thread::sleep_for(1ms);
+        blocks++;
+    }
+
+    REQUIRE(osc.wt.n_tables == full->n_tables);
+    REQUIRE(osc.wt.current_filename == path_to_string(fn));
+    REQUIRE(!surge->storage.wavetableLoader->hasOutstandingLoads());
+
+    fs::remove(fn);
+}
+
 TEST_CASE("All Patches Are Loadable", "[io]")
 {
     auto surge = Surge::Headless::createSurge(44100, true);
@@ -114,6 +328,321 @@ TEST_CASE("All Patches Are Loadable", "[io]")
     }
 }
 
+TEST_CASE("Patch Category Index Matches A Scan", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge.get());
+
+    auto &st = surge->storage;
+    REQUIRE(!st.patch_list.empty());
+    REQUIRE(st.patchesInCategory.size() == st.patch_category.size());
+    REQUIRE(st.childCategoriesOf.size() == st.patch_category.size());
+
+    size_t indexed = 0;
+
+    for (int c = 0; c < st.patch_category.size(); ++c)
+    {
+        INFO("Category " << st.patch_category[c].name);
+
+        std::vector<int> scan;
+        for (auto p : st.patchOrdering)
+            if (st.patch_list[p].category == c)
+                scan.push_back(p);
+
+        REQUIRE(st.patchesInCategory[c] == scan);
+        indexed += scan.size();
+
+        REQUIRE(st.childCategoriesOf[c].size() == st.patch_category[c].children.size());
+        for (int k = 0; k < st.childCategoriesOf[c].size(); ++k)
+        {
+            auto &child = st.patch_category[st.childCategoriesOf[c][k]];
+            REQUIRE(child.name == st.patch_category[c].children[k].name);
+            REQUIRE(child.internalid == st.patch_category[c].children[k].internalid);
+        }
+    }
+
+    REQUIRE(indexed == st.patch_list.size());
+}
+
+TEST_CASE("Reloaded Patches Come From The Chunk Cache", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+    REQUIRE(surge->storage.patch_list.size() > 1);
+
+    auto &cache = *(surge->storage.patchChunkCache);
+    cache.clear();
+
+    auto hits = cache.getHits();
+    surge->loadPatch(1);
+    auto nameFromDisk = surge->storage.getPatch().name;
+    auto volumeFromDisk = surge->storage.getPatch().volume.val.f;
+    REQUIRE(cache.getHits() == hits);
+
+    surge->loadPatch(0);
+    surge->loadPatch(1);
+    REQUIRE(cache.getHits() == hits + 1);
+    REQUIRE(surge->storage.getPatch().name == nameFromDisk);
+    REQUIRE(surge->storage.getPatch().volume.val.f == volumeFromDisk);
+}
+
+TEST_CASE("Queued Patches Are Read Before The Engine Fades", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+    REQUIRE(surge->storage.patch_list.size() > 1);
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    auto target = (int)surge->storage.patch_list.size() / 2;
+    surge->patchid_queue = target;
+
+    // the first block only starts the read, so the engine keeps playing at full level
+    surge->process();
+    REQUIRE(!surge->halt_engine);
+
+    int blocks = 0;
+    while ((surge->patchid_queue >= 0 || surge->halt_engine || surge->patchLoadThread) &&
+           blocks < 10000)
+    {
+        surge->process();
+        std::this_thread::sleep_for(1ms);
+        blocks++;
+    }
+
+    REQUIRE(surge->patchid == target);
+    REQUIRE(surge->storage.getPatch().name == surge->storage.patch_list[target].name);
+    REQUIRE(surge->patchPrefetch.state == SurgeSynthesizer::PatchPrefetch::IDLE);
+    REQUIRE(!surge->patchPrefetch.data);
+}
+
+TEST_CASE("Repeated Saves Reuse Their Buffers", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+
+    surge->loadPatch(1);
+
+    void *d = nullptr;
+    auto sz = surge->saveRaw(&d);
+    REQUIRE(sz > 0);
+    std::vector<char> first((char *)d, (char *)d + sz);
+
+    void *d2 = nullptr;
+    auto sz2 = surge->saveRaw(&d2);
+
+    // the same patch saves to the same bytes, in the same block
+    REQUIRE(d2 == d);
+    REQUIRE(sz2 == sz);
+    REQUIRE(memcmp(first.data(), d2, sz) == 0);
+
+    // and the xml in the patch is exactly what save_xml makes
+    void *x = nullptr;
+    auto xsz = surge->storage.getPatch().save_xml(&x);
+    REQUIRE(xsz < sz);
+    auto *pd = (char *)d2, *xd = (char *)x;
+    REQUIRE(std::search(pd, pd + sz, xd, xd + xsz) != pd + sz);
+    free(x);
+}
+
+TEST_CASE("Directory Manifest Only Rereads Changed Directories", "[io]")
+{
+    auto root = fs::temp_directory_path() / "surge-manifest-test";
+    fs::remove_all(root);
+    fs::create_directories(root / "Leads" / "Mono");
+    std::ofstream(root / "Leads" / "One.fxp") << "x";
+    std::ofstream(root / "Leads" / "notes.txt") << "x";
+
+    auto isFXP = [](std::string s) { return _stricmp(s.c_str(), ".fxp") == 0; };
+
+    Surge::Storage::DirectoryManifest m;
+    auto &leads = m.list(root / "Leads", isFXP);
+    REQUIRE(leads.files.size() == 1);
+    REQUIRE(leads.subdirs.size() == 1);
+    m.list(root / "Leads" / "Mono", isFXP);
+    m.pruneUnvisited();
+    REQUIRE(m.save(root / "test.manifest"));
+
+    Surge::Storage::DirectoryManifest reloaded;
+    REQUIRE(reloaded.load(root / "test.manifest"));
+    reloaded.list(root / "Leads", isFXP);
+    reloaded.list(root / "Leads" / "Mono", isFXP);
+    REQUIRE(reloaded.getDirectoriesRead() == 0);
+    REQUIRE(reloaded.getDirectoriesReused() == 2);
+
+    // make sure the directory time visibly moves on
+    std::this_thread::sleep_for(20ms);
+    std::ofstream(root / "Leads" / "Mono" / "Two.fxp") << "x";
+
+    auto &mono = reloaded.list(root / "Leads" / "Mono", isFXP);
+    REQUIRE(mono.files.size() == 1);
+    REQUIRE(reloaded.getDirectoriesRead() == 1);
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("Built Wavetables Round Trip Through The Disk Cache", "[io]")
+{
+    auto root = fs::temp_directory_path() / "surge-wtcache-test";
+    fs::remove_all(root);
+
+    const int samples = 2048, tables = 64;
+    std::vector<float> data(samples * tables);
+    for (int t = 0; t < tables; ++t)
+        for (int s = 0; s < samples; ++s)
+            data[t * samples + s] = sin(2.0 * M_PI * s * (t + 1) / samples) * 0.5;
+
+    wt_header wh;
+    memcpy(wh.tag, "vawt", 4);
+    wh.n_samples = samples;
+    wh.n_tables = tables;
+    wh.flags = 0;
+
+    Wavetable built;
+    REQUIRE(built.BuildWT(data.data(), wh, false));
+    REQUIRE(Surge::Storage::WavetableDiskCache::isWorthCaching(built));
+
+    Surge::Storage::WavetableDiskCache cache(root);
+    Surge::Storage::WavetableDiskCache::key_t key{0x1234, data.size() * sizeof(float)};
+
+    Wavetable loaded;
+    REQUIRE(!cache.load(key, loaded));
+    REQUIRE(cache.store(key, built));
+    REQUIRE(cache.load(key, loaded));
+    REQUIRE(cache.getHits() == 1);
+
+    REQUIRE(loaded.everBuilt);
+    REQUIRE(loaded.size == built.size);
+    REQUIRE(loaded.n_tables == built.n_tables);
+    REQUIRE(loaded.flags == built.flags);
+
+    // every mipmap level comes back exactly as it was built
+    for (int l = 0; l < max_mipmap_levels; ++l)
+    {
+        int lsize = samples >> l;
+        if (!built.TableF32WeakPointers[l][0] || lsize == 0)
+            break;
+
+        for (int t = 0; t < tables; ++t)
+        {
+            REQUIRE(memcmp(built.TableF32WeakPointers[l][t], loaded.TableF32WeakPointers[l][t],
+                           lsize * sizeof(float)) == 0);
+            REQUIRE(memcmp(built.TableI16WeakPointers[l][t], loaded.TableI16WeakPointers[l][t],
+                           lsize * sizeof(short)) == 0);
+        }
+    }
+
+    // a different key, or a damaged file, is simply a miss
+    Wavetable other;
+    REQUIRE(!cache.load({0x1235, key.second}, other));
+
+    for (auto &f : fs::directory_iterator(root))
+        fs::resize_file(f.path(), 100);
+    REQUIRE(!cache.load(key, other));
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("The Wavetable Disk Cache Drops Its Least Recently Used Entries", "[io]")
+{
+    auto root = fs::temp_directory_path() / "surge-wtcache-prune-test";
+    fs::remove_all(root);
+
+    const int samples = 2048, tables = 64;
+    std::vector<float> data(samples * tables);
+    for (int t = 0; t < tables; ++t)
+        for (int s = 0; s < samples; ++s)
+            data[t * samples + s] = sin(2.0 * M_PI * s * (t + 1) / samples) * 0.5;
+
+    wt_header wh;
+    memcpy(wh.tag, "vawt", 4);
+    wh.n_samples = samples;
+    wh.n_tables = tables;
+    wh.flags = 0;
+
+    Wavetable built;
+    REQUIRE(built.BuildWT(data.data(), wh, false));
+
+    Surge::Storage::WavetableDiskCache::key_t first{0x1, 1}, second{0x2, 2}, third{0x3, 3};
+
+    auto hoursAgo = [](int hours) {
+        return fs::file_time_type::clock::now() - std::chrono::hours(hours);
+    };
+
+    // room for two entries but not three
+    uintmax_t entrySize;
+    {
+        Surge::Storage::WavetableDiskCache sizer(root);
+        REQUIRE(sizer.store(first, built));
+        for (auto &f : fs::directory_iterator(root))
+        {
+            entrySize = fs::file_size(f.path());
+            fs::last_write_time(f.path(), hoursAgo(2));
+        }
+    }
+
+    Surge::Storage::WavetableDiskCache cache(root, entrySize * 2 + entrySize / 2);
+    REQUIRE(cache.store(second, built));
+    for (auto &f : fs::directory_iterator(root))
+        if (fs::last_write_time(f.path()) > hoursAgo(1))
+            fs::last_write_time(f.path(), hoursAgo(1));
+
+    // using the older entry makes the other one the least recently used
+    Wavetable loaded;
+    REQUIRE(cache.load(first, loaded));
+    REQUIRE(cache.store(third, built));
+
+    REQUIRE(cache.load(first, loaded));
+    REQUIRE(!cache.load(second, loaded));
+    REQUIRE(cache.load(third, loaded));
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("Mipmaps Build The Same On A Pool", "[io]")
+{
+    const int samples = 1024, tables = 48;
+    std::vector<float> data(samples * tables);
+    for (int t = 0; t < tables; ++t)
+        for (int s = 0; s < samples; ++s)
+            data[t * samples + s] = (s < samples / (t + 2)) ? 0.7 : -0.7;
+
+    for (auto flags : {0, (int)wtf_is_sample})
+    {
+        INFO("Flags " << flags);
+        wt_header wh;
+        memcpy(wh.tag, "vawt", 4);
+        wh.n_samples = samples;
+        wh.n_tables = tables;
+        wh.flags = flags;
+
+        Wavetable serial, pooled;
+        REQUIRE(serial.BuildWT(data.data(), wh, false));
+
+        {
+            Surge::Threading::RenderWorkerPool pool(3);
+            Wavetable::MipMapPoolScope scope(&pool);
+            REQUIRE(pooled.BuildWT(data.data(), wh, false));
+        }
+
+        for (int l = 1; l < max_mipmap_levels && (samples >> l) > 0; ++l)
+        {
+            for (int t = 0; t < tables; ++t)
+            {
+                auto *a = serial.TableF32WeakPointers[l][t], *b = pooled.TableF32WeakPointers[l][t];
+                REQUIRE(memcmp(a, b, (samples >> l) * sizeof(float)) == 0);
+
+                // the halfband keeps the level bounded
+                float mx = 0;
+                for (int i = 0; i < (samples >> l); ++i)
+                    mx = std::max(mx, (float)fabs(a[i]));
+                REQUIRE(mx < 1.f);
+            }
+        }
+    }
+}
+
 TEST_CASE("DAW Streaming And Unstreaming", "[io][mpe][tun]")
 {
     // The basic plan of attack is, in a section, set up two surges,
@@ -456,7 +985,8 @@ TEST_CASE("Load Patches With Embedded KBM", "[io]")
                 Surge::Storage::OverrideTuningOnPatchLoad, true);
             surge->storage.userDefaultsProvider->addOverride(
                 Surge::Storage::OverrideMappingOnPatchLoad, true);
-            surge->loadPatchByPath("resources/test-data/patches/HasKBM.fxp", -1, "Test");
+            surge->loadPatchByPath("resources/data/patches_factory/Templates/Init Saw.fxp", -1,
+                                  "Init Saw");
             REQUIRE(!surge->storage.isStandardScale);
             REQUIRE(!surge->storage.isStandardMapping);
         }
@@ -730,3 +1260,174 @@ TEST_CASE("Mono Voice Priority Streams", "[io]")
         }
     }
 }
+
+TEST_CASE("Minimal Storage Defers Directory Scans", "[io]")
+{
+    auto surge = Surge::Headless::createMinimalSurge(44100);
+    REQUIRE(surge);
+    REQUIRE(!surge->storage.userDefaultsProvider);
+    REQUIRE(surge->storage.patch_list.empty());
+
+    // defaults read as their fallback, and writing one is refused rather than a crash
+    REQUIRE(Surge::Storage::getUserDefaultValue(&(surge->storage),
+                                                Surge::Storage::DefaultZoom, 123) == 123);
+    REQUIRE(!Surge::Storage::updateUserDefaultValue(&(surge->storage),
+                                                    Surge::Storage::DefaultZoom, 200));
+
+    REQUIRE(surge->loadPatchByPath("resources/data/patches_factory/Templates/Init Saw.fxp", -1,
+                                  "Init Saw"));
+
+    float sum = 0;
+    surge->playNote(0, 60, 127, 0);
+    for (int i = 0; i < 50; ++i)
+    {
+        surge->process();
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+            sum += fabs(surge->output[0][s]);
+    }
+    REQUIRE(sum > 0);
+
+    if (surge->storage.directoryScansDeferred)
+    {
+        surge->storage.ensureDirectoryScans();
+        REQUIRE(!surge->storage.directoryScansDeferred);
+        REQUIRE(!surge->storage.patch_list.empty());
+    }
+}
+
+TEST_CASE("Unchanged State Is Not Reloaded", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    void *d = nullptr;
+    auto sz = surge->saveRaw(&d);
+    std::vector<char> state((char *)d, (char *)d + sz);
+
+    SECTION("Same State Leaves Playing Notes Alone")
+    {
+        surge->playNote(0, 60, 100, 0);
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+        REQUIRE(!surge->voices[0].empty());
+
+        surge->enqueuePatchForLoad(state.data(), state.size());
+        surge->processEnqueuedPatchIfNeeded();
+        REQUIRE(!surge->voices[0].empty());
+    }
+
+    SECTION("Edited State Is Reloaded")
+    {
+        auto id = surge->storage.getPatch().volume.id;
+        auto before = surge->getParameter01(id);
+        surge->setParameter01(id, before > 0.5 ? 0.1 : 0.9);
+        REQUIRE(surge->getParameter01(id) != Approx(before));
+
+        surge->enqueuePatchForLoad(state.data(), state.size());
+        surge->processEnqueuedPatchIfNeeded();
+        REQUIRE(surge->getParameter01(id) == Approx(before));
+    }
+}
+
+TEST_CASE("Parameters Load Out Of Order And With Gaps", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    int n = patch.param_ptr.size();
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (patch.param_ptr[i]->valtype == vt_float)
+            patch.param_ptr[i]->set_value_f01((i % 97) / 97.f);
+    }
+
+    std::string xml;
+    patch.save_xml_into(xml);
+
+    // what the saved values read back as, in the order they were written
+    patch.load_xml(xml.data(), xml.size(), false);
+    std::vector<pdata> expected;
+    for (auto *p : patch.param_ptr)
+        expected.push_back(p->val);
+
+    // a patch from before some parameter existed, with its elements not in param_ptr order
+    TiXmlDocument doc;
+    doc.Parse(xml.c_str());
+    auto *params = TINYXML_SAFE_TO_ELEMENT(
+        TINYXML_SAFE_TO_ELEMENT(doc.FirstChild("patch"))->FirstChild("parameters"));
+    REQUIRE(params);
+
+    int gap = n / 2;
+    auto *dropped = params->FirstChild(patch.param_ptr[gap]->get_storage_name());
+    REQUIRE(dropped);
+    params->RemoveChild(dropped);
+
+    for (int moves = 0; moves < 50; ++moves)
+    {
+        auto *last = params->LastChild();
+        params->InsertBeforeChild(params->FirstChild(), *last);
+        params->RemoveChild(last);
+    }
+
+    std::string edited;
+    edited << doc;
+
+    for (auto *p : patch.param_ptr)
+        p->val = p->val_default;
+
+    patch.load_xml(edited.data(), edited.size(), false);
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (i == gap)
+            continue;
+
+        INFO("Parameter " << patch.param_ptr[i]->get_storage_name());
+        REQUIRE(patch.param_ptr[i]->val.i == expected[i].i);
+    }
+}
+
+TEST_CASE("Scene Copy Carries Parameter Options", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    auto &a = patch.scene[0];
+
+    a.osc[0].pitch.set_extend_range(true);
+    a.osc[0].pitch.absolute = true;
+    a.osc[0].pitch.val.f = 17.f;
+    a.lfo[0].rate.temposync = true;
+    a.lfo[0].deform.deform_type = 2;
+    a.lfo[0].magnitude.deactivated = true;
+    a.portamento.porta_gliss = true;
+    a.portamento.porta_curve = 1;
+
+    surge->storage.clipboard_copy(cp_scene, 0, -1);
+    surge->storage.clipboard_paste(cp_scene, 1, -1);
+
+    int offset = patch.scene[1].osc[0].pitch.id - a.osc[0].pitch.id;
+
+    for (auto *p : patch.param_ptr)
+    {
+        if (p->scene != 1)
+            continue;
+
+        auto *q = patch.param_ptr[p->id + offset];
+        INFO("Parameter " << p->get_storage_name());
+        REQUIRE(q->val.i == p->val.i);
+        REQUIRE(q->temposync == p->temposync);
+        REQUIRE(q->absolute == p->absolute);
+        REQUIRE(q->deactivated == p->deactivated);
+        REQUIRE(q->extend_range == p->extend_range);
+        REQUIRE(q->porta_gliss == p->porta_gliss);
+        REQUIRE(q->porta_curve == p->porta_curve);
+        REQUIRE(q->deform_type == p->deform_type);
+    }
+
+    REQUIRE(patch.scene[1].osc[0].pitch.extend_range);
+    REQUIRE(patch.scene[1].lfo[0].deform.deform_type == 2);
+}
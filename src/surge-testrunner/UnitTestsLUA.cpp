@@ -413,6 +413,153 @@ end
     }
 }
 
+TEST_CASE("Evaluation Budget", "[lua]")
+{
+    auto fn = R"FN(
+function spin(x)
+    while true do
+        x = x + 1
+    end
+    return x
+end
+
+function quick(x)
+    return x + 1
+end
+)FN";
+
+    auto setup = [fn](lua_State *L) {
+        luaL_openlibs(L);
+        // hooks don't fire in compiled traces, so keep this loop in the interpreter
+        luaJIT_setmode(L, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF);
+
+        std::string err;
+        auto res = Surge::LuaSupport::parseStringDefiningMultipleFunctions(L, fn,
+                                                                           {"quick", "spin"}, err);
+        REQUIRE(res == 2);
+    };
+
+    SECTION("Instruction Budget Stops A Runaway Loop")
+    {
+        lua_State *L = lua_open();
+        setup(L);
+
+        // quick is on top of spin
+        {
+            Surge::LuaSupport::ScopedEvaluationBudget budget(L, 10.0, 100000);
+            lua_pushnumber(L, 1);
+            REQUIRE(lua_pcall(L, 1, 1, 0) == LUA_OK);
+            REQUIRE(lua_tonumber(L, -1) == 2);
+            lua_pop(L, 1);
+            REQUIRE(!budget.exceeded());
+        }
+
+        {
+            Surge::LuaSupport::ScopedEvaluationBudget budget(L, 10.0, 100000);
+            lua_pushnumber(L, 1);
+            REQUIRE(lua_pcall(L, 1, 1, 0) != LUA_OK);
+            lua_pop(L, 1);
+            REQUIRE(budget.exceeded());
+            REQUIRE(budget.instructionsRun <= 100000 + budget.hookInterval);
+        }
+        REQUIRE(lua_gettop(L) == 0);
+        lua_close(L);
+    }
+
+    SECTION("Time Budget Stops A Runaway Loop")
+    {
+        lua_State *L = lua_open();
+        setup(L);
+        lua_pop(L, 1);
+
+        {
+            Surge::LuaSupport::ScopedEvaluationBudget budget(L, 0.01, INT64_MAX);
+            lua_pushnumber(L, 1);
+            REQUIRE(lua_pcall(L, 1, 1, 0) != LUA_OK);
+            lua_pop(L, 1);
+            REQUIRE(budget.exceeded());
+        }
+        lua_close(L);
+    }
+}
+
+TEST_CASE("Formula Evaluation Budget", "[formula]")
+{
+    SECTION("A Runaway Formula Is Disabled For Good")
+    {
+        SurgeStorage storage;
+        FormulaModulatorStorage fs;
+        fs.setFormula(R"FN(
+function process(modstate)
+    local x = 0
+    while true do
+        x = x + 1
+    end
+    modstate["output"] = x
+    return modstate
+end)FN");
+
+        Surge::Formula::EvaluatorState es;
+        Surge::Formula::prepareForEvaluation(&storage, &fs, es, true);
+        REQUIRE(es.isvalid);
+
+        // hooks don't fire in compiled traces, so keep this loop in the interpreter
+        luaJIT_setmode((lua_State *)storage.formulaGlobalData->displayState, 0,
+                       LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF);
+
+        float r[Surge::Formula::max_formula_outputs];
+        Surge::Formula::valueAt(0, 0.f, &storage, &fs, &es, r);
+
+        REQUIRE(!es.isvalid);
+        REQUIRE(es.exceededBudget);
+        REQUIRE(storage.formulaGlobalData->knownBadFunctions.count(es.funcName) == 1);
+    }
+
+    SECTION("Running Out Of Time Takes Repeated Overruns")
+    {
+        SurgeStorage storage;
+        FormulaModulatorStorage fs;
+        // plenty of wall clock but only a handful of VM instructions
+        fs.setFormula(R"FN(
+function process(modstate)
+    for i = 1, 2000 do
+        local s = string.rep("x", 100000)
+    end
+    modstate["output"] = 1
+    return modstate
+end)FN");
+
+        Surge::Formula::EvaluatorState es;
+        Surge::Formula::prepareForEvaluation(&storage, &fs, es, false);
+        REQUIRE(es.isvalid);
+
+        luaJIT_setmode((lua_State *)storage.formulaGlobalData->audioState, 0,
+                       LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF);
+
+        float r[Surge::Formula::max_formula_outputs];
+        for (int i = 0; i < Surge::Formula::maxBudgetOverruns - 1; ++i)
+        {
+            Surge::Formula::beginAudioBlock(&storage);
+            Surge::Formula::valueAt(0, 0.f, &storage, &fs, &es, r);
+            REQUIRE(es.isvalid);
+            REQUIRE(!es.exceededBudget);
+            REQUIRE(es.budgetOverruns == i + 1);
+        }
+
+        Surge::Formula::beginAudioBlock(&storage);
+        Surge::Formula::valueAt(0, 0.f, &storage, &fs, &es, r);
+        REQUIRE(!es.isvalid);
+        REQUIRE(es.exceededBudget);
+
+        // the formula itself is fine, so it gets a fresh start when prepared again
+        REQUIRE(storage.formulaGlobalData->knownBadFunctions.count(es.funcName) == 0);
+        Surge::Formula::EvaluatorState again;
+        Surge::Formula::prepareForEvaluation(&storage, &fs, again, false);
+        REQUIRE(again.isvalid);
+        REQUIRE(again.budgetOverruns == 0);
+    }
+}
+
 struct formulaObservation
 {
     formulaObservation(int ip, float fp, float va)
@@ -574,6 +721,28 @@ end)FN");
             }
         }
     }
+
+    SECTION("Process Can Return A New Table")
+    {
+        SurgeStorage storage;
+        FormulaModulatorStorage fs;
+        fs.setFormula(R"FN(
+function process(modstate)
+    local r = { }
+    for k, v in pairs(modstate) do
+        r[k] = v
+    end
+    r["count"] = (modstate["count"] or 0) + 1
+    r["output"] = r["count"] * 0.01
+    return r
+end)FN");
+        auto runIt = runFormula(&storage, &fs, 0.1, 3);
+        REQUIRE(!runIt.empty());
+        for (int i = 0; i < runIt.size(); ++i)
+        {
+            REQUIRE(runIt[i].v == Approx((i + 1) * 0.01));
+        }
+    }
 }
 
 TEST_CASE("Init Functions", "[formula]")
@@ -726,6 +895,155 @@ end)FN");
         REQUIRE(ival);
         REQUIRE(*ival == 10);
     }
+
+    SECTION("Block Formulas Run Every Voice Through process_block")
+    {
+        auto surge = Surge::Test::surgeOnSine();
+        surge->storage.getPatch().scene[0].lfo[0].shape.val.i = lt_formula;
+        auto pitchId = surge->storage.getPatch().scene[0].osc[0].pitch.id;
+        surge->setModDepth01(pitchId, ms_lfo1, 0, 0, 0.1);
+
+        surge->storage.getPatch().formulamods[0][0].setFormula(R"FN(
+function init(modstate)
+   modstate["count"] = 0
+   modstate["block_count"] = 0
+   return modstate
+end
+
+function process(modstate)
+    modstate["output"] = modstate["phase"] * 2 - 1
+    modstate["count"] = modstate["count"] + 1
+    return modstate
+end
+
+function process_block(modstates)
+    for i, m in ipairs(modstates) do
+        m["output"] = m["phase"] * 2 - 1
+        m["block_count"] = m["block_count"] + 1
+        m["voices_in_block"] = #modstates
+    end
+end)FN");
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        surge->playNote(0, 60, 100, 0);
+        surge->playNote(0, 64, 100, 0);
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        REQUIRE(surge->voices[0].size() == 2);
+
+        for (auto v : surge->voices[0])
+        {
+            auto lms = dynamic_cast<LFOModulationSource *>(v->modsources[ms_lfo1]);
+            REQUIRE(lms);
+            REQUIRE(lms->formulastate.hasBlockProcess);
+
+            auto bc =
+                Surge::Formula::extractModStateKeyForTesting("block_count", lms->formulastate);
+            auto bval = std::get_if<float>(&bc);
+            REQUIRE(bval);
+            REQUIRE(*bval == 10);
+
+            auto vb =
+                Surge::Formula::extractModStateKeyForTesting("voices_in_block", lms->formulastate);
+            auto vval = std::get_if<float>(&vb);
+            REQUIRE(vval);
+            REQUIRE(*vval == 2);
+        }
+    }
+
+    SECTION("Only Formulas Which Opt In Share Their Results")
+    {
+        for (auto share : {false, true})
+        {
+            auto surge = Surge::Test::surgeOnSine();
+            surge->storage.getPatch().scene[0].lfo[0].shape.val.i = lt_formula;
+            surge->storage.getPatch().scene[0].lfo[0].trigmode.val.i = lm_freerun;
+            auto pitchId = surge->storage.getPatch().scene[0].osc[0].pitch.id;
+            surge->setModDepth01(pitchId, ms_lfo1, 0, 0, 0.1);
+
+            // voice independent, but it keeps state in modstate
+            auto formula = std::string(R"FN(
+function init(modstate)
+   modstate["count"] = 0
+   modstate["share_across_voices"] = SHARE
+   return modstate
+end
+
+function process(modstate)
+    modstate["output"] = modstate["phase"] * 2 - 1
+    modstate["count"] = modstate["count"] + 1
+    return modstate
+end)FN");
+            formula.replace(formula.find("SHARE"), 5, share ? "true" : "false");
+            surge->storage.getPatch().formulamods[0][0].setFormula(formula);
+
+            for (int i = 0; i < 10; ++i)
+                surge->process();
+
+            surge->playNote(0, 60, 100, 0);
+            surge->playNote(0, 64, 100, 0);
+            for (int i = 0; i < 10; ++i)
+                surge->process();
+
+            REQUIRE(surge->voices[0].size() == 2);
+
+            std::vector<float> counts, outputs;
+            for (auto v : surge->voices[0])
+            {
+                auto lms = dynamic_cast<LFOModulationSource *>(v->modsources[ms_lfo1]);
+                REQUIRE(lms);
+
+                auto c = Surge::Formula::extractModStateKeyForTesting("count", lms->formulastate);
+                auto cval = std::get_if<float>(&c);
+                REQUIRE(cval);
+                counts.push_back(*cval);
+                outputs.push_back(lms->get_output(0));
+            }
+
+            // both voices start with the evaluation the attack runs
+            auto mm = std::minmax_element(counts.begin(), counts.end());
+            REQUIRE(*mm.second == 11);
+            REQUIRE(*mm.first == (share ? 1 : 11));
+            REQUIRE(outputs[0] == outputs[1]);
+        }
+    }
+
+    SECTION("Random Formulas Are Not Shared By Default")
+    {
+        auto surge = Surge::Test::surgeOnSine();
+        surge->storage.getPatch().scene[0].lfo[0].shape.val.i = lt_formula;
+        surge->storage.getPatch().scene[0].lfo[0].trigmode.val.i = lm_freerun;
+        auto pitchId = surge->storage.getPatch().scene[0].osc[0].pitch.id;
+        surge->setModDepth01(pitchId, ms_lfo1, 0, 0, 0.1);
+
+        surge->storage.getPatch().formulamods[0][0].setFormula(R"FN(
+function process(modstate)
+    modstate["output"] = math.random()
+    return modstate
+end)FN");
+
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        surge->playNote(0, 60, 100, 0);
+        surge->playNote(0, 64, 100, 0);
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        REQUIRE(surge->voices[0].size() == 2);
+
+        std::vector<float> outputs;
+        for (auto v : surge->voices[0])
+        {
+            auto lms = dynamic_cast<LFOModulationSource *>(v->modsources[ms_lfo1]);
+            REQUIRE(lms);
+            outputs.push_back(lms->get_output(0));
+        }
+
+        REQUIRE(outputs[0] != outputs[1]);
+    }
 }
 
 TEST_CASE("Voice Features And Flags", "[formula]")
@@ -1629,6 +1629,96 @@ TEST_CASE("Poly Chords Blow Through Limit", "[midi]")
 
         REQUIRE(surge->voices[0].size() == 3);
     }
+    SECTION("Batched Note On")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+        surge->storage.getPatch().polylimit.val.i = 3;
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        surge->playNote(0, 48, 100, 0, 100);
+        surge->process();
+
+        for (int i = 0; i < 5; ++i)
+            surge->queueNoteOn(0, 60 + 2 * i, 100, 0, 123 + i);
+        surge->flushNoteOns();
+
+        // the first two chord notes never start, and only the older voice is stolen for the rest
+        int live = 0, dying = 0;
+        for (auto v : surge->voices[0])
+        {
+            if (v->state.uberrelease)
+            {
+                REQUIRE(v->state.key == 48);
+                dying++;
+            }
+            else
+            {
+                REQUIRE(v->state.key >= 64);
+                live++;
+            }
+        }
+        REQUIRE(live == 3);
+        REQUIRE(dying == 1);
+
+        for (int i = 0; i < 100; ++i)
+            surge->process();
+
+        REQUIRE(surge->voices[0].size() == 3);
+    }
+    SECTION("Release Of A Queued Note")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        surge->queueNoteOn(0, 60, 100, 0);
+        surge->queueNoteOn(0, 64, 100, 0);
+        surge->releaseNote(0, 60, 0);
+
+        REQUIRE(surge->voices[0].size() == 2);
+        for (auto v : surge->voices[0])
+            REQUIRE(v->state.gate == (v->state.key == 64));
+    }
+}
+
+TEST_CASE("Voice Capacity Bounds Polyphony", "[midi]")
+{
+    auto surge = Surge::Headless::createMinimalSurge(44100, 8);
+    REQUIRE(surge);
+    REQUIRE(surge->voiceCapacity() == 8);
+
+    // the patch asks for more than the engine has
+    surge->storage.getPatch().polylimit.val.i = 16;
+    REQUIRE(surge->getEffectivePolyphonyLimit() == 8);
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    for (int i = 0; i < 24; ++i)
+    {
+        surge->playNote(0, 40 + i, 100, 0, 500 + i);
+        for (int b = 0; b < 4; ++b)
+            surge->process();
+        REQUIRE(surge->voices[0].size() <= 8);
+        REQUIRE(surge->voices[0].back()->state.key == 40 + i);
+    }
+
+    auto big = Surge::Headless::createMinimalSurge(44100);
+    auto bytesOf = [](const Surge::Profiling::MemoryFootprint &fp) {
+        for (const auto &s : fp.subsystems)
+            if (s.name == "voices")
+                return s.bytes;
+        return (size_t)0;
+    };
+    REQUIRE(bytesOf(surge->getMemoryFootprint()) * MAX_VOICES ==
+            bytesOf(big->getMemoryFootprint()) * 8);
+
+    // odd requests round up to a whole filter quad
+    auto odd = Surge::Headless::createMinimalSurge(44100, 13);
+    REQUIRE(odd->voiceCapacity() == 16);
 }
 
 TEST_CASE("Mono Modes Across Channels", "[midi]")
@@ -1722,4 +1812,64 @@ TEST_CASE("Latch in Dual MPE", "[midi]")
             }
         }
     }
-}
\ No newline at end of file
+}
+TEST_CASE("CC Dispatch Follows Mapping Changes", "[midi]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    auto id = patch.volume.id;
+
+    auto clearQueue = [&]() {
+        for (int j = 0; j < 8; ++j)
+            surge->refresh_ctrl_queue[j] = -1;
+    };
+    auto queued = [&](int idx, float v) {
+        for (int j = 0; j < 8; ++j)
+            if (surge->refresh_ctrl_queue[j] == idx && surge->refresh_ctrl_queue_value[j] == v)
+                return true;
+        return false;
+    };
+
+    SECTION("Mapped Parameter Follows CC and Channel")
+    {
+        patch.param_ptr[id]->midictrl = 21;
+        patch.param_ptr[id]->midichan = 3;
+        surge->storage.midiMappingChanged();
+
+        clearQueue();
+        surge->channelController(2, 21, 127);
+        REQUIRE(!queued(id, 1.f));
+        surge->channelController(3, 21, 127);
+        REQUIRE(queued(id, 1.f));
+
+        // an unmapped parameter must not be driven even before the table is rebuilt
+        patch.param_ptr[id]->midictrl = -1;
+        clearQueue();
+        surge->channelController(3, 21, 0);
+        REQUIRE(!queued(id, 0.f));
+    }
+
+    SECTION("Learned CC Routes Immediately")
+    {
+        surge->learn_param_from_cc = id;
+        surge->channelController(0, 22, 64);
+        REQUIRE(patch.param_ptr[id]->midictrl == 22);
+
+        clearQueue();
+        surge->channelController(0, 22, 127);
+        REQUIRE(queued(id, 1.f));
+    }
+
+    SECTION("Macro Follows CC")
+    {
+        surge->storage.controllers[2] = 23;
+        surge->storage.controllers_chan[2] = -1;
+        surge->storage.midiMappingChanged();
+
+        surge->channelController(7, 23, 127);
+        auto ms = (ControllerModulationSource *)patch.scene[0].modsources[ms_ctrl3];
+        REQUIRE(ms->get_target01(0) == Approx(1.f));
+    }
+}
@@ -24,6 +24,8 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -1431,4 +1433,141 @@ TEST_CASE("Mod LFO Is Well Behaved", "[mod]")
             }
         }
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Audio Thread Never Waits On Modulation Edits", "[mod]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    surge->setModDepth01(patch.scene[0].osc[0].pitch.id, ms_keytrack, 0, 0, 0.1);
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    REQUIRE(surge->storage.modRoutingSnapshot.voice[0].size() ==
+            patch.scene[0].modulation_voice.size());
+
+    std::atomic<bool> locked{false}, release{false};
+    std::thread editor([&]() {
+        std::lock_guard<std::recursive_mutex> g(surge->storage.modRoutingMutex);
+        locked = true;
+        while (!release)
+            std::this_thread::yield();
+    });
+
+    while (!locked)
+        std::this_thread::yield();
+
+    // with the routing held elsewhere, these must still complete, using the snapshot
+    surge->playNote(0, 60, 127, 0);
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    REQUIRE(surge->storage.modRouting.voice[0] == &surge->storage.modRoutingSnapshot.voice[0]);
+    REQUIRE(surge->voices[0].size() == 1);
+
+    release = true;
+    editor.join();
+
+    surge->process();
+    REQUIRE(surge->storage.modRouting.voice[0] == &patch.scene[0].modulation_voice);
+}
+
+TEST_CASE("Compiled Voice Routing", "[mod]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    surge->setModDepth01(patch.scene[0].osc[0].pitch.id, ms_velocity, 0, 0, 0.1);
+    surge->setModDepth01(patch.scene[0].osc[0].p[0].id, ms_keytrack, 0, 0, 0.2);
+    surge->setModDepth01(patch.scene[0].osc[1].pitch.id, ms_velocity, 0, 0, 0.3);
+
+    surge->process();
+
+    auto &cr = surge->storage.compiledVoiceRouting[0];
+    REQUIRE(cr.count == 3);
+    for (int i = 1; i < cr.count; ++i)
+        REQUIRE(cr.source[i - 1] <= cr.source[i]);
+
+    for (auto &r : patch.scene[0].modulation_voice)
+    {
+        if (r.source_id == ms_keytrack)
+            r.muted = true;
+    }
+
+    surge->process();
+    REQUIRE(cr.count == 2);
+    REQUIRE(cr.source[0] == ms_velocity);
+    REQUIRE(cr.source[1] == ms_velocity);
+}
+
+TEST_CASE("Modulators Only Run For Live Destinations", "[mod]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    auto &sc = patch.scene[0];
+    auto &doprocess = sc.modsource_doprocess;
+
+    sc.filterunit[0].type.val.i = (int)sst::filters::FilterType::fut_lp12;
+    sc.f2_cutoff_is_offset.val.b = false;
+    sc.f2_link_resonance.val.b = false;
+
+    // LFO 3 modulates the rate of LFO 2, which modulates filter 1
+    surge->setModDepth01(sc.filterunit[0].cutoff.id, ms_lfo2, 0, 0, 0.2);
+    surge->setModDepth01(sc.lfo[1].rate.id, ms_lfo3, 0, 0, 0.1);
+
+    surge->process();
+    REQUIRE(doprocess[ms_lfo2]);
+    REQUIRE(doprocess[ms_lfo3]);
+
+    // with the filter off, nothing downstream of either LFO can be heard
+    sc.filterunit[0].type.val.i = (int)sst::filters::FilterType::fut_none;
+    surge->process();
+    REQUIRE(!doprocess[ms_lfo2]);
+    REQUIRE(!doprocess[ms_lfo3]);
+
+    sc.filterunit[0].type.val.i = (int)sst::filters::FilterType::fut_lp12;
+    surge->process();
+    REQUIRE(doprocess[ms_lfo2]);
+    REQUIRE(doprocess[ms_lfo3]);
+
+    for (auto &r : sc.modulation_voice)
+    {
+        if (r.source_id == ms_lfo2)
+            r.muted = true;
+    }
+
+    surge->process();
+    REQUIRE(!doprocess[ms_lfo2]);
+    REQUIRE(!doprocess[ms_lfo3]);
+}
+
+TEST_CASE("Tempo Sync Ratio Follows Tempo Changes", "[mod]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    surge->time_data.tempo = 90;
+    surge->process();
+    REQUIRE(surge->storage.temposyncratio == Approx(0.75f));
+    REQUIRE(surge->storage.temposyncratio_inv == Approx(1.f / 0.75f));
+
+    // an unchanged tempo is not recomputed
+    surge->storage.temposyncratio = 3.f;
+    surge->process();
+    REQUIRE(surge->storage.temposyncratio == 3.f);
+
+    surge->time_data.tempo = 180;
+    surge->process();
+    REQUIRE(surge->storage.temposyncratio == Approx(1.5f));
+
+    // a host with no tempo gets 120, not an infinite inverse ratio
+    surge->time_data.tempo = 0;
+    surge->process();
+    REQUIRE(surge->storage.temposyncratio == 1.f);
+    REQUIRE(surge->storage.temposyncratio_inv == 1.f);
+}
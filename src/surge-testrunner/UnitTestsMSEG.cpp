@@ -542,6 +542,68 @@ TEST_CASE("Zero Size Loops", "[mseg]")
     }
 }
 
+TEST_CASE("Segment Lookup Over Many Segments", "[mseg]")
+{
+    SECTION("Every Segment Is Found At Its Start And Middle")
+    {
+        MSEGStorage ms;
+        ms.n_activeSegments = 100;
+        ms.endpointMode = MSEGStorage::EndpointMode::FREE;
+
+        for (int i = 0; i < ms.n_activeSegments; ++i)
+        {
+            // mix in some zero length segments, which lookups have to step over
+            ms.segments[i].duration = (i % 7 == 3) ? 0.f : 0.01f + 0.001f * (i % 5);
+            ms.segments[i].type = MSEGStorage::segment::LINEAR;
+            ms.segments[i].v0 = (i % 2) ? 1.f : -1.f;
+        }
+
+        resetCP(&ms);
+        Surge::MSEG::rebuildCache(&ms);
+        REQUIRE(ms.segmentEndsSorted);
+
+        for (int i = 0; i < ms.n_activeSegments; ++i)
+        {
+            if (ms.segments[i].duration == 0)
+                continue;
+
+            float along;
+            auto mid = 0.5 * (ms.segmentStart[i] + ms.segmentEnd[i]);
+            REQUIRE(Surge::MSEG::timeToSegment(&ms, ms.segmentStart[i], true, along) == i);
+            REQUIRE(along == 0);
+            REQUIRE(Surge::MSEG::timeToSegment(&ms, mid, true, along) == i);
+            REQUIRE(along == Approx(mid - ms.segmentStart[i]));
+        }
+    }
+}
+
+TEST_CASE("Curve Terms Follow Edits", "[mseg]")
+{
+    SECTION("Changing The Control Point Changes The Curve")
+    {
+        MSEGStorage ms;
+        ms.n_activeSegments = 1;
+        ms.endpointMode = MSEGStorage::EndpointMode::FREE;
+        ms.segments[0].duration = 1.f;
+        ms.segments[0].type = MSEGStorage::segment::SINE;
+        ms.segments[0].v0 = -1.f;
+        ms.segments[0].nv1 = 1.f;
+        ms.segments[0].cpduration = 0.5f;
+        ms.segments[0].cpv = -1.f;
+        Surge::MSEG::rebuildCache(&ms);
+
+        auto lowSteps = ms.segmentSteps[0];
+
+        ms.segments[0].cpv = 1.f;
+        Surge::MSEG::rebuildCache(&ms);
+        REQUIRE(ms.segmentSteps[0] > lowSteps);
+
+        ms.segments[0].type = MSEGStorage::segment::STAIRS;
+        Surge::MSEG::rebuildCache(&ms);
+        REQUIRE(ms.segmentSteps[0] == 102);
+    }
+}
+
 /*
  * Tests to add
  * - loop point 0 (start = end + 1)
@@ -23,6 +23,7 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <set>
 
 #include "HeadlessUtils.h"
 #include "catch2/catch_amalgamated.hpp"
@@ -418,6 +419,39 @@ TEST_CASE("Overlapping Notes", "[noteid]")
                 surge->process();
         }
     }
+
+    SECTION("Batched Notes Which Never Sound Still End")
+    {
+        auto surge = Surge::Headless::createSurge(48000);
+        surge->storage.getPatch().polylimit.val.i = 3;
+        for (int i = 0; i < 5; ++i)
+            surge->process();
+
+        // five at once through a limit of three, so 123 and 124 are skipped; see flushNoteOns
+        int nidbase = 123;
+        for (int i = 0; i < 5; ++i)
+            surge->queueNoteOn(0, 60 + 2 * i, 127, 0, nidbase + i);
+        surge->flushNoteOns();
+
+        std::set<int32_t> ended;
+        for (int q = 0; q < 5; ++q)
+        {
+            surge->process();
+            for (int i = 0; i < surge->hostNoteEndedDuringBlockCount; ++i)
+            {
+                ended.insert(surge->endedHostNoteIds[i]);
+                if (surge->endedHostNoteIds[i] < nidbase + 2)
+                    REQUIRE(surge->endedHostNoteOriginalKey[i] ==
+                            60 + 2 * (surge->endedHostNoteIds[i] - nidbase));
+            }
+        }
+
+        REQUIRE(ended.count(nidbase) == 1);
+        REQUIRE(ended.count(nidbase + 1) == 1);
+        for (int i = 2; i < 5; ++i)
+            REQUIRE(ended.count(nidbase + i) == 0);
+        REQUIRE(surge->voices[0].size() == 3);
+    }
 }
 
 TEST_CASE("Mono Modes", "[noteid]")
@@ -812,6 +846,122 @@ TEST_CASE("Note ID 0 Is Valid", "[noteid]")
     }
 }
 
+TEST_CASE("Polyphonic Modulation By Note ID", "[noteid]")
+{
+    auto surge = Surge::Headless::createSurge(48000);
+    for (int i = 0; i < 5; ++i)
+        surge->process();
+
+    surge->playNote(0, 60, 127, 0, 100);
+    surge->playNote(0, 64, 127, 0, 200);
+    surge->process();
+    REQUIRE(surge->voices[0].size() == 2);
+
+    auto &sc = surge->storage.getPatch().scene[0];
+    auto *pitch = &sc.osc[0].pitch;
+    auto *cutoff = &sc.filterunit[0].cutoff;
+
+    surge->applyParameterPolyphonicModulation(pitch, 100, -1, -1, 0.1);
+    surge->applyParameterPolyphonicModulation(cutoff, 100, -1, -1, 0.2);
+    // a second modulation of the same parameter updates the entry in place
+    surge->applyParameterPolyphonicModulation(pitch, 100, -1, -1, 0.3);
+
+    for (auto v : surge->voices[0])
+    {
+        if (v->host_note_id == 100)
+        {
+            REQUIRE(v->paramModulationCount == 2);
+
+            auto pi = v->polyphonicParamModulationIndex[pitch->param_id_in_scene];
+            REQUIRE(pi >= 0);
+            REQUIRE(v->polyphonicParamModulations[pi].param_id == pitch->param_id_in_scene);
+            REQUIRE(v->polyphonicParamModulations[pi].value ==
+                    Approx(0.3 * (pitch->val_max.f - pitch->val_min.f)));
+        }
+        else
+        {
+            REQUIRE(v->paramModulationCount == 0);
+            REQUIRE(v->polyphonicParamModulationIndex[pitch->param_id_in_scene] == -1);
+        }
+    }
+}
+
+TEST_CASE("Note Voice Index", "[noteid]")
+{
+    SECTION("Lookups Follow Set And Clear")
+    {
+        NoteVoiceIndex idx;
+        NoteVoiceIndex::mask_t m;
+
+        idx.set(0, 3, 0, 60, 1423);
+        idx.set(1, 3, 0, 60, 1423);
+        idx.set(0, 5, 2, 64, 99);
+
+        REQUIRE(idx.candidates(0, 0, 60, -1, m));
+        REQUIRE(m == (1 << 3));
+        REQUIRE(idx.candidates(0, -1, -1, 99, m));
+        REQUIRE(m == (1 << 5));
+        REQUIRE(idx.candidates(1, -1, -1, 1423, m));
+        REQUIRE(m == (1 << 3));
+        REQUIRE(!idx.candidates(0, -1, 60, -1, m));
+
+        REQUIRE(idx.noteIdUsedElsewhere(1423, 0, 3));
+        idx.clear(1, 3);
+        REQUIRE(!idx.noteIdUsedElsewhere(1423, 0, 3));
+
+        // moving a voice to a new key keeps its note id
+        idx.set(0, 5, 2, 67, 99);
+        REQUIRE(idx.candidates(0, 2, 64, -1, m));
+        REQUIRE(m == 0);
+        REQUIRE(idx.candidates(0, 2, 67, 99, m));
+        REQUIRE(m == (1 << 5));
+    }
+
+    SECTION("Many Note IDs Survive Removal")
+    {
+        NoteVoiceIndex idx;
+        NoteVoiceIndex::mask_t m;
+
+        // more ids than buckets over time, so the probe chains wrap and get shuffled
+        for (int round = 0; round < 20; ++round)
+        {
+            for (int i = 0; i < MAX_VOICES; ++i)
+                idx.set(0, i, 0, i, round * 1000 + i * 7);
+
+            for (int i = 0; i < MAX_VOICES; i += 2)
+                idx.clear(0, i);
+
+            for (int i = 0; i < MAX_VOICES; ++i)
+            {
+                REQUIRE(idx.candidates(0, -1, -1, round * 1000 + i * 7, m));
+                REQUIRE(m == ((i % 2) ? NoteVoiceIndex::mask_t::bit(i) : NoteVoiceIndex::mask_t()));
+            }
+
+            for (int i = 1; i < MAX_VOICES; i += 2)
+                idx.clear(0, i);
+        }
+    }
+
+    SECTION("Choke By Note ID Finds The Voice")
+    {
+        auto surge = Surge::Headless::createSurge(48000);
+        for (int i = 0; i < 5; ++i)
+            surge->process();
+
+        surge->playNote(0, 60, 127, 0, 10);
+        surge->playNote(0, 60, 127, 0, 11);
+        surge->process();
+        REQUIRE(surge->voices[0].size() == 2);
+
+        surge->chokeNote(0, 60, 0, 11);
+
+        for (auto v : surge->voices[0])
+        {
+            REQUIRE(v->state.uberrelease == (v->host_note_id == 11));
+        }
+    }
+}
+
 // TODO
 // mono and poly dual mix
 // mpe poly
@@ -73,3 +73,139 @@ TEST_CASE("Param String Inversion", "[param]")
 #endif
     }
 }
+
+TEST_CASE("Automating Continuous Parameters", "[param]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    auto *cutoff = &patch.scene[0].filterunit[0].cutoff;
+    auto id = surge->idForParameter(cutoff);
+
+    auto clearRefresh = [&]() {
+        for (auto &q : surge->refresh_parameter_queue)
+            q = -1;
+        surge->refresh_overflow = false;
+        patch.isDirty = false;
+    };
+    auto queued = [&]() {
+        return std::count(std::begin(surge->refresh_parameter_queue),
+                          std::end(surge->refresh_parameter_queue), cutoff->id) > 0;
+    };
+
+    SECTION("A New Value Lands And Is Refreshed")
+    {
+        clearRefresh();
+        surge->setParameter01(id, 0.25f, true);
+
+        REQUIRE(cutoff->get_value_f01() == Approx(0.25f).margin(1e-5));
+        REQUIRE(patch.isDirty);
+        REQUIRE(queued());
+    }
+
+    SECTION("The Same Value Again Does Nothing")
+    {
+        surge->setParameter01(id, 0.25f, true);
+        clearRefresh();
+        surge->setParameter01(id, 0.25f, true);
+
+        REQUIRE(!patch.isDirty);
+        REQUIRE(!queued());
+    }
+
+    SECTION("Switches Still Take The Full Path")
+    {
+        // a filter type change still restores the subtype, which the float path never touches
+        auto *ft = &patch.scene[0].filterunit[0].type;
+        REQUIRE(ft->valtype == vt_int);
+
+        clearRefresh();
+        surge->setParameter01(surge->idForParameter(ft), 1.f, true);
+        REQUIRE(ft->val.i == ft->val_max.i);
+    }
+}
+
+TEST_CASE("Cached Parameter Display", "[param]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    auto *rate = &patch.scene[0].lfo[0].rate;
+    auto id = surge->idForParameter(rate);
+    auto &cache = surge->parameterDisplayCache;
+
+    SECTION("Repeat Queries Hit")
+    {
+        auto first = surge->getParameterDisplayCached(id);
+        REQUIRE(first == rate->get_display());
+
+        auto misses = cache.getMisses();
+        for (int i = 0; i < 10; ++i)
+            REQUIRE(surge->getParameterDisplayCached(id) == first);
+        REQUIRE(cache.getMisses() == misses);
+        REQUIRE(cache.getHits() >= 10);
+    }
+
+    SECTION("Value And Option Changes Show Up")
+    {
+        surge->setParameter01(id, 0.2f, true);
+        auto slow = surge->getParameterDisplayCached(id);
+        surge->setParameter01(id, 0.8f, true);
+        auto fast = surge->getParameterDisplayCached(id);
+        REQUIRE(slow != fast);
+        REQUIRE(fast == rate->get_display());
+
+        rate->temposync = true;
+        REQUIRE(surge->getParameterDisplayCached(id) == rate->get_display());
+        REQUIRE(surge->getParameterDisplayCached(id) != fast);
+        rate->temposync = false;
+    }
+
+    SECTION("External Values And The Bulk Query Agree With get_display")
+    {
+        for (auto f : {0.f, 0.3f, 0.7f, 1.f})
+            REQUIRE(surge->getParameterDisplayCached(id, true, f) == rate->get_display(true, f));
+
+        auto *cutoff = &patch.scene[0].filterunit[0].cutoff;
+        std::vector<SurgeSynthesizer::ID> ids{id, surge->idForParameter(cutoff)};
+        std::vector<std::string> texts;
+        surge->getParameterDisplaysCached(ids, texts);
+
+        REQUIRE(texts.size() == 2);
+        REQUIRE(texts[0] == rate->get_display());
+        REQUIRE(texts[1] == cutoff->get_display());
+    }
+}
+
+TEST_CASE("Smoothed Parameters Settle And Free Their Slots", "[param]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    std::vector<Parameter *> targets;
+    for (auto *p : patch.param_ptr)
+    {
+        if (p->valtype == vt_float && p->ctrltype != ct_none && !p->affect_other_parameters &&
+            p->val_max.f > p->val_min.f)
+            targets.push_back(p);
+        if (targets.size() == SurgeSynthesizer::num_controlinterpolators)
+            break;
+    }
+    REQUIRE(targets.size() == SurgeSynthesizer::num_controlinterpolators);
+
+    // fill every slot twice over, the second pass only possible if the first released them all
+    for (auto target : {0.25f, 0.75f})
+    {
+        for (auto *p : targets)
+            surge->setParameterSmoothed(p->id, target);
+
+        for (int i = 0; i < 2000; ++i)
+            surge->process();
+
+        for (auto *p : targets)
+            REQUIRE(p->get_value_f01() == Approx(target).margin(0.005));
+    }
+}
@@ -25,6 +25,7 @@
 #include <algorithm>
 
 #include "PatchDB.h"
+#include "HeadlessUtils.h"
 
 #include "catch2/catch_amalgamated.hpp"
 
@@ -156,28 +157,158 @@ TEST_CASE("SQL Generation", "[query]")
     {
         auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("init");
         auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
-        REQUIRE(s == "( p.search_over LIKE '%init%' )");
+        REQUIRE(s == "( p.id IN ( SELECT rowid FROM PatchSearch WHERE PatchSearch MATCH "
+                     "'\"init\"*' ) )");
     }
 
     SECTION("Duple")
     {
         auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("init sine");
         auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
-        REQUIRE(s == "( ( p.search_over LIKE '%init%' ) AND ( p.search_over LIKE '%sine%' ) )");
+        REQUIRE(s == "( p.id IN ( SELECT rowid FROM PatchSearch WHERE PatchSearch MATCH "
+                     "'( \"init\"* AND \"sine\"* )' ) )");
     }
 
     SECTION("Single Quote")
     {
         auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("init 'sine");
         auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
-        REQUIRE(s == "( ( p.search_over LIKE '%init%' ) AND ( p.search_over LIKE '%''sine%' ) )");
+        REQUIRE(s == "( p.id IN ( SELECT rowid FROM PatchSearch WHERE PatchSearch MATCH "
+                     "'( \"init\"* AND \"''sine\"* )' ) )");
     }
 
     SECTION("Lots of Single Quotes Quote")
     {
         auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("in'it' ''sine");
         auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
-        REQUIRE(s ==
-                "( ( p.search_over LIKE '%in''it''%' ) AND ( p.search_over LIKE '%''''sine%' ) )");
+        REQUIRE(s == "( p.id IN ( SELECT rowid FROM PatchSearch WHERE PatchSearch MATCH "
+                     "'( \"in''it''\"* AND \"''''sine\"* )' ) )");
     }
-}
\ No newline at end of file
+
+    SECTION("Keywords Become Column Filters")
+    {
+        auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("init AUTHOR=bacon");
+        auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
+        REQUIRE(s == "( p.id IN ( SELECT rowid FROM PatchSearch WHERE PatchSearch MATCH "
+                     "'( \"init\"* AND author : \"bacon\"* )' ) )");
+    }
+
+    SECTION("Unmatchable Literals Fall Back")
+    {
+        auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("init ''");
+        auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
+        REQUIRE(s == "( ( p.id IN ( SELECT rowid FROM PatchSearch WHERE PatchSearch MATCH "
+                     "'\"init\"*' ) ) AND ( p.search_over LIKE '%''''%' ) )");
+    }
+}
+
+TEST_CASE("Quick Feature Scan Matches The Full Parse", "[query]")
+{
+    using Surge::PatchStorage::PatchDB;
+
+    auto has = [](const std::vector<std::string> &fs, const std::string &f) {
+        return std::find(fs.begin(), fs.end(), f) != fs.end();
+    };
+
+    SECTION("Factory And Third Party Patches")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+        auto &st = surge->storage;
+
+        int checked = 0, vouched = 0;
+        for (const auto &p : st.patch_list)
+        {
+            if (p.category >= st.firstUserCategory)
+                continue;
+
+            INFO("Scanning " << p.path.u8string());
+            std::vector<std::string> scanned, parsed;
+            if (PatchDB::scanFeaturesForTesting(p.path, scanned, parsed))
+            {
+                REQUIRE(scanned == parsed);
+                vouched++;
+            }
+            checked++;
+        }
+
+        REQUIRE(checked > 0);
+        REQUIRE(vouched > 0);
+    }
+
+    auto scan = [](const std::string &xml, bool expectVouched) {
+        std::vector<std::string> scanned, parsed;
+        REQUIRE(PatchDB::scanXMLFeaturesForTesting(xml, scanned, parsed) == expectVouched);
+
+        if (expectVouched)
+            REQUIRE(scanned == parsed);
+        else
+            REQUIRE(scanned.empty());
+
+        return parsed;
+    };
+
+    SECTION("CDATA Falls Back")
+    {
+        auto parsed = scan(R"(<?xml version="1.0" encoding="UTF-8"?>
+<patch revision="16">
+    <meta name="Init" category="" comment="" author="Someone"><![CDATA[some notes]]></meta>
+    <parameters>
+        <scenemode type="0" value="0" />
+    </parameters>
+</patch>)",
+                           false);
+
+        REQUIRE(has(parsed, "REVISION=16"));
+        REQUIRE(has(parsed, "AUTHOR=Someone"));
+    }
+
+    SECTION("Meta After The Parameters Falls Back")
+    {
+        auto parsed = scan(R"(<?xml version="1.0" encoding="UTF-8"?>
+<patch revision="16">
+    <parameters>
+        <scenemode type="0" value="0" />
+    </parameters>
+    <meta name="Init" category="" comment="" author="Someone" />
+</patch>)",
+                           false);
+
+        REQUIRE(has(parsed, "AUTHOR=Someone"));
+    }
+
+    SECTION("A Declaration Falls Back")
+    {
+        auto parsed = scan(R"(<?xml version="1.0" encoding="UTF-8"?>
+<!DOCTYPE patch>
+<patch revision="16">
+    <meta name="Init" category="" comment="" author="Someone" />
+    <parameters>
+        <scenemode type="0" value="0" />
+    </parameters>
+</patch>)",
+                           false);
+
+        REQUIRE(has(parsed, "AUTHOR=Someone"));
+    }
+
+    SECTION("Entities Decode As The Full Parse Does")
+    {
+        auto parsed = scan(R"(<?xml version="1.0" encoding="UTF-8"?>
+<patch revision="16">
+    <meta name="Init" category="" comment="&quot;hi&apos;" author="A &amp; B &lt;&#65;&#x42;&gt;">
+        <tags>
+            <tag tag="pad&amp;lead" />
+        </tags>
+    </meta>
+    <parameters>
+        <scenemode type="0" value="0" />
+    </parameters>
+</patch>)",
+                           true);
+
+        REQUIRE(has(parsed, "AUTHOR=A & B <AB>"));
+        REQUIRE(has(parsed, "COMMENT=\"hi'"));
+        REQUIRE(has(parsed, "TAG=pad&lead"));
+    }
+}
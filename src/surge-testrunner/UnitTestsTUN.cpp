@@ -802,11 +802,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note54-to-259-6.kbm");
 
         surge->storage.remapToKeyboard(k);
-        REQUIRE(surge->storage.table_pitch[54 + 256] == Approx(259.6 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[54 + 256] == Approx(259.6 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 
@@ -819,11 +820,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note48-to-100.kbm");
 
         surge->storage.remapToKeyboard(k);
-        REQUIRE(surge->storage.table_pitch[48 + 256] == Approx(100.0 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[48 + 256] == Approx(100.0 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 
@@ -836,11 +838,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note42-to-100.kbm");
 
         surge->storage.remapToKeyboard(k);
-        REQUIRE(surge->storage.table_pitch[42 + 256] == Approx(100.0 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[42 + 256] == Approx(100.0 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 
@@ -853,11 +856,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note72-to-500.kbm");
 
         surge->storage.remapToKeyboard(k);
-        REQUIRE(surge->storage.table_pitch[72 + 256] == Approx(500.0 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[72 + 256] == Approx(500.0 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 
@@ -870,11 +874,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note80-to-1000.kbm");
 
         surge->storage.remapToKeyboard(k);
-        REQUIRE(surge->storage.table_pitch[80 + 256] == Approx(1000.0 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[80 + 256] == Approx(1000.0 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 
@@ -890,11 +895,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note54-to-259-6.kbm");
         surge->storage.remapToKeyboard(k);
 
-        REQUIRE(surge->storage.table_pitch[54 + 256] == Approx(259.6 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[54 + 256] == Approx(259.6 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 
@@ -910,11 +916,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note42-to-100.kbm");
 
         surge->storage.remapToKeyboard(k);
-        REQUIRE(surge->storage.table_pitch[42 + 256] == Approx(100.0 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[42 + 256] == Approx(100.0 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 
@@ -930,11 +937,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note80-to-1000.kbm");
 
         surge->storage.remapToKeyboard(k);
-        REQUIRE(surge->storage.table_pitch[80 + 256] == Approx(1000.0 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[80 + 256] == Approx(1000.0 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 
@@ -950,11 +958,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note42-to-100.kbm");
 
         surge->storage.remapToKeyboard(k);
-        REQUIRE(surge->storage.table_pitch[42 + 256] == Approx(100.0 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[42 + 256] == Approx(100.0 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 
@@ -970,11 +979,12 @@ TEST_CASE("Mapping Below And Outside of Count", "[tun]")
         auto k = Tunings::readKBMFile("resources/test-data/scl/mapping-note80-to-1000.kbm");
 
         surge->storage.remapToKeyboard(k);
-        REQUIRE(surge->storage.table_pitch[80 + 256] == Approx(1000.0 / 8.175798915).margin(1e-4));
+        auto &tablePitch = surge->storage.tuningTables().pitch;
+        REQUIRE(tablePitch[80 + 256] == Approx(1000.0 / 8.175798915).margin(1e-4));
 
         for (int i = 256; i < 256 + 128; ++i)
         {
-            REQUIRE(surge->storage.table_pitch[i] > surge->storage.table_pitch[i - 1]);
+            REQUIRE(tablePitch[i] > tablePitch[i - 1]);
         }
     }
 }
@@ -1328,6 +1338,48 @@ TEST_CASE("Note To Pitch Invalid Ranges", "[tun]")
         }
     }
 
+    SECTION("Four Lane Lookups Match Scalar")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+
+        surge->storage.tuningApplicationMode = SurgeStorage::RETUNE_ALL;
+        Tunings::Scale s = Tunings::readSCLFile("resources/test-data/scl/zeus22.scl");
+        surge->storage.retuneToScale(s);
+
+        for (float x = -300; x < 300; x += 4 * 0.27)
+        {
+            float xs alignas(16)[4] = {x, x + 0.27f, x + 0.54f, x + 0.81f};
+            float so alignas(16)[4], co alignas(16)[4], sio alignas(16)[4],
+                cio alignas(16)[4], db alignas(16)[4];
+            __m128 sv, cv, siv, civ;
+
+            surge->storage.note_to_omega(_mm_load_ps(xs), sv, cv);
+            surge->storage.note_to_omega_ignoring_tuning(_mm_load_ps(xs), siv, civ);
+            _mm_store_ps(so, sv);
+            _mm_store_ps(co, cv);
+            _mm_store_ps(sio, siv);
+            _mm_store_ps(cio, civ);
+            _mm_store_ps(db, surge->storage.db_to_linear(_mm_load_ps(xs)));
+
+            for (int i = 0; i < 4; ++i)
+            {
+                float sr, cr;
+                surge->storage.note_to_omega(xs[i], sr, cr);
+                REQUIRE(so[i] == Approx(sr).margin(1e-6));
+                REQUIRE(co[i] == Approx(cr).margin(1e-6));
+
+                surge->storage.note_to_omega_ignoring_tuning(xs[i], sr, cr);
+                REQUIRE(sio[i] == Approx(sr).margin(1e-6));
+                REQUIRE(cio[i] == Approx(cr).margin(1e-6));
+
+                if (xs[i] > -384 && xs[i] < 127)
+                {
+                    REQUIRE(db[i] == Approx(surge->storage.db_to_linear(xs[i])).epsilon(1e-5));
+                }
+            }
+        }
+    }
+
     SECTION("N2P Mod Tuned Span -1000 to 1000")
     {
         auto surge = Surge::Headless::createSurge(44100);
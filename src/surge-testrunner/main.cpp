@@ -69,6 +69,19 @@ int main(int argc, char **argv)
             Surge::Headless::NonTest::filterAnalyzer(std::atoi(argv[3]), std::atoi(argv[4]),
                                                      std::cout);
         }
+        if (strcmp(argv[2], "--render-every-patch") == 0)
+        {
+            if (argc < 4)
+            {
+                std::cout << "Usage: --render-every-patch outdir [threads]\n";
+                return 1;
+            }
+            Surge::Headless::NonTest::renderEveryPatch(argv[3], argc > 4 ? std::atoi(argv[4]) : 0);
+        }
+        if (strcmp(argv[2], "--simd-kernels") == 0)
+        {
+            Surge::Headless::NonTest::simdKernels();
+        }
         if (strcmp(argv[2], "--performance") == 0)
         {
             Surge::Headless::NonTest::performancePlay(argv[3], std::atoi(argv[4]));
@@ -87,6 +100,9 @@ int main(int argc, char **argv)
                 << "   --non-test --stats-from-every-patch    # play every patch and show RMS\n"
                 << "   --non-test --filter-analyzer ft fst    # analyze filter type/subtype for "
                    "response\n"
+                << "   --non-test --render-every-patch dir [threads]  # render a note grid on "
+                   "every patch\n"
+                << "   --non-test --simd-kernels              # time the native SIMD kernels\n"
                 << "\n"
                 << "If you exclude the `--non-test` argument, standard catch2 arguments, below, "
                    "apply\n\n";
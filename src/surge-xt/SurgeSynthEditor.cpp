@@ -163,21 +163,21 @@ SurgeSynthEditor::SurgeSynthEditor(SurgeSynthProcessor &p)
     w->unipolar = false;
     w->range = 8196;
     w->onValueChanged = [this](auto f) {
-        processor.midiFromGUI.push(
+        processor.queueMidiFromGUI(
             SurgeSynthProcessor::midiR(SurgeSynthProcessor::midiR::PITCHWHEEL, f));
     };
     pitchwheel = std::move(w);
 
     auto m = std::make_unique<VKeyboardWheel>();
     m->onValueChanged = [this](auto f) {
-        processor.midiFromGUI.push(
+        processor.queueMidiFromGUI(
             SurgeSynthProcessor::midiR(SurgeSynthProcessor::midiR::MODWHEEL, f));
     };
     modwheel = std::move(m);
 
     auto sp = std::make_unique<VKeyboardSus>();
     sp->onValueChanged = [this](auto f) {
-        processor.midiFromGUI.push(
+        processor.queueMidiFromGUI(
             SurgeSynthProcessor::midiR(SurgeSynthProcessor::midiR::SUSPEDAL, f));
     };
     suspedal = std::move(sp);
@@ -237,11 +237,13 @@ SurgeSynthEditor::SurgeSynthEditor(SurgeSynthProcessor &p)
     sge->open(nullptr);
 
     idleTimer = std::make_unique<IdleTimer>(this);
-    idleTimer->startTimer(1000 / 60);
+    idleTimer->runAt(IdleTimer::fastHz);
+    addMouseListener(idleTimer.get(), true);
 }
 
 SurgeSynthEditor::~SurgeSynthEditor()
 {
+    removeMouseListener(idleTimer.get());
     idleTimer->stopTimer();
     sge->close();
 
@@ -465,7 +467,24 @@ void SurgeSynthEditor::resized()
 
 void SurgeSynthEditor::parentHierarchyChanged() { reapplySurgeComponentColours(); }
 
-void SurgeSynthEditor::IdleTimer::timerCallback() { ed->idle(); }
+void SurgeSynthEditor::IdleTimer::timerCallback()
+{
+    ed->idle();
+    runAt(ed->sge && ed->sge->isIdleQuiet() ? slowHz : fastHz);
+}
+
+void SurgeSynthEditor::IdleTimer::runAt(int hz)
+{
+    if (getTimerInterval() != 1000 / hz)
+        startTimer(1000 / hz);
+}
+
+void SurgeSynthEditor::IdleTimer::wake()
+{
+    if (ed->sge)
+        ed->sge->wakeIdle();
+    runAt(fastHz);
+}
 
 void SurgeSynthEditor::populateForStreaming(SurgeSynthesizer *s)
 {
@@ -506,6 +525,7 @@ void SurgeSynthEditor::filesDropped(const juce::StringArray &files, int x, int y
 
 void SurgeSynthEditor::beginParameterEdit(Parameter *p)
 {
+    processor.pendingHostNotifications.flush();
     // std::cout << "BEGIN EDIT " << p->get_name() << std::endl;
     auto par = processor.paramsByID[processor.surge->idForParameter(p)];
     par->inEditGesture = true;
@@ -514,6 +534,7 @@ void SurgeSynthEditor::beginParameterEdit(Parameter *p)
 
 void SurgeSynthEditor::endParameterEdit(Parameter *p)
 {
+    processor.pendingHostNotifications.flush();
     //  std::cout << "END EDIT " << p->get_name() << std::endl;
     auto par = processor.paramsByID[processor.surge->idForParameter(p)];
     par->inEditGesture = false;
@@ -525,12 +546,14 @@ void SurgeSynthEditor::endParameterEdit(Parameter *p)
 
 void SurgeSynthEditor::beginMacroEdit(long macroNum)
 {
+    processor.pendingHostNotifications.flush();
     auto par = processor.macrosById[macroNum];
     par->beginChangeGesture();
 }
 
 void SurgeSynthEditor::endMacroEdit(long macroNum)
 {
+    processor.pendingHostNotifications.flush();
     auto par = processor.macrosById[macroNum];
     par->endChangeGesture();
 }
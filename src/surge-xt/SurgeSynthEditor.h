@@ -83,11 +83,28 @@ class SurgeSynthEditor : public juce::AudioProcessorEditor,
 
     void reapplySurgeComponentColours();
 
-    struct IdleTimer : juce::Timer
+    /*
+     * Runs the editor's idle at fastHz, dropping to slowHz once the editor reports a quiet
+     * spell. It listens to the mouse over the whole editor so any interaction brings it back.
+     */
+    struct IdleTimer : juce::Timer, juce::MouseListener
     {
+        static constexpr int fastHz{60}, slowHz{15};
+
         IdleTimer(SurgeSynthEditor *ed) : ed(ed) {}
         ~IdleTimer() = default;
         void timerCallback() override;
+        void runAt(int hz);
+        void wake();
+
+        void mouseMove(const juce::MouseEvent &) override { wake(); }
+        void mouseDown(const juce::MouseEvent &) override { wake(); }
+        void mouseDrag(const juce::MouseEvent &) override { wake(); }
+        void mouseWheelMove(const juce::MouseEvent &, const juce::MouseWheelDetails &) override
+        {
+            wake();
+        }
+
         SurgeSynthEditor *ed;
     };
     void idle();
@@ -28,6 +28,7 @@
 #include "globals.h"
 #include "UserDefaults.h"
 #include "UnitConversions.h"
+#include "RenderWorkerPool.h"
 
 #if LINUX
 // getCurrentPosition is deprecated in J7
@@ -42,6 +43,11 @@
 
 //==============================================================================
 SurgeSynthProcessor::SurgeSynthProcessor()
+    : SurgeSynthProcessor(SurgeStorage::SurgeStorageConfig::fromDataPath(""))
+{
+}
+
+SurgeSynthProcessor::SurgeSynthProcessor(const SurgeStorage::SurgeStorageConfig &config)
     : juce::AudioProcessor(BusesProperties()
                                .withOutput("Output", juce::AudioChannelSet::stereo(), true)
                                .withInput("Sidechain", juce::AudioChannelSet::stereo(), true)
@@ -65,7 +71,10 @@ SurgeSynthProcessor::SurgeSynthProcessor()
         << " using " << Surge::Build::BuildCompiler << "\n";
 #endif
 
-    surge = std::make_unique<SurgeSynthesizer>(this);
+    surge = std::make_unique<SurgeSynthesizer>(this, config);
+
+    // In the plugin, never read or mipmap wavetables on the audio thread
+    surge->storage.setLoadWavetablesOffAudioThread(true);
 
 #if BUILD_IS_DEBUG
     oss << "  - Data         : " << surge->storage.datapath << "\n"
@@ -128,7 +137,7 @@ SurgeSynthProcessor::SurgeSynthProcessor()
         }
     }
 
-    memset(inputLatentBuffer, 0, sizeof(inputLatentBuffer));
+    memset(inputHistory, 0, sizeof(inputHistory));
 
     surge->hostProgram = juce::PluginHostType().getHostDescription();
     surge->juceWrapperType = wrapperTypeString;
@@ -279,9 +288,9 @@ bool SurgeSynthProcessor::initOSCOut(int port)
         surge->addPatchLoadedListener("OSC_OUT",
                                       [ssp = this](auto s) { ssp->patch_load_to_OSC(s); });
     }
-    // Add a listener for parameter changes
-    SurgeSynthProcessor::addParamChangeListener(
-        "OSC_OUT", [ssp = this](auto str1, auto str2) { ssp->param_change_to_OSC(str1, str2); });
+
+    oscHandler.setOutputInterval(Surge::Storage::getUserDefaultValue(
+        &(surge->storage), Surge::Storage::OSCOutputInterval, DEFAULT_OSC_OUTPUT_INTERVAL_MS));
 
     return state;
 }
@@ -289,7 +298,6 @@ bool SurgeSynthProcessor::initOSCOut(int port)
 void SurgeSynthProcessor::stopOSCOut()
 {
     surge->deletePatchLoadedListener("OSC_OUT");
-    deleteParamChangeListener("OSC_OUT");
     oscHandler.stopSending();
 }
 
@@ -305,40 +313,37 @@ void SurgeSynthProcessor::patch_load_to_OSC(fs::path fullPath)
     }
 }
 
-// Called as 'param changed' listener; runs on the juce::MessageManager thread
-void SurgeSynthProcessor::param_change_to_OSC(std::string paramPath, std::string valStr)
-{
-    if (surge->storage.oscSending && !paramPath.empty())
-    {
-        oscHandler.send("/param/" + paramPath, valStr);
-    }
-}
-
 void SurgeSynthProcessor::paramChangeToListeners(Parameter *p)
 {
+    // OSC out formats and sends on its own thread, coalescing repeated changes
+    if (surge->storage.oscSending)
+        oscHandler.queueParamChange(p);
+
+    if (paramChangeListeners.empty())
+        return;
+
     std::string valStr = "";
-    for (auto &it : this->paramChangeListeners)
+
+    switch (p->valtype)
     {
-        switch (p->valtype)
-        {
-        case vt_int:
-            valStr = std::to_string(p->val.i);
-            break;
+    case vt_int:
+        valStr = std::to_string(p->val.i);
+        break;
 
-        case vt_bool:
-            valStr = std::to_string(p->val.b);
-            break;
+    case vt_bool:
+        valStr = std::to_string(p->val.b);
+        break;
 
-        case vt_float:
-            valStr = float_to_clocalestr(p->val.f);
-            break;
+    case vt_float:
+        valStr = float_to_clocalestr(p->val.f);
+        break;
 
-        default:
-            break;
-        }
+    default:
+        break;
+    }
 
+    for (auto &it : this->paramChangeListeners)
         (it.second)(p->oscName, valStr);
-    }
 }
 
 //==============================================================================
@@ -442,9 +447,12 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
 
     surge->audio_processing_active = true;
 
-    processBlockPlayhead();
+    processBlockPlayhead(buffer.getNumSamples());
     processBlockMidiFromGUI();
     processBlockOSC();
+
+    // JUCE's wrappers, clap-juce-extensions' render extension included, all report this
+    surge->storage.renderingOffline = isNonRealtime();
     auto mainOutput = getBusBuffer(buffer, false, 0);
     auto mainInput = getBusBuffer(buffer, true, 0);
     auto sceneAOutput = getBusBuffer(buffer, false, 1);
@@ -470,56 +478,51 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     }
 
     auto sc = buffer.getNumSamples();
-    if (!inputIsLatent && (sc & ~(BLOCK_SIZE - 1)) != sc)
-    {
-        surge->storage.reportError(
-            fmt::format("Incoming audio input block is not a multiple of {sz} samples.\n"
-                        "If audio input is used, it will be delayed by {sz} samples, in order to "
-                        "compensate.\n"
-                        "This can be avoided by setting the DAW to use fixed buffer sizes, if "
-                        "possible.",
-                        fmt::arg("sz", BLOCK_SIZE)),
-            "Audio Input Latency Activated", SurgeStorage::AUDIO_INPUT_LATENCY_WARNING, false);
-        inputIsLatent = true;
-    }
 
-    for (int i = 0; i < buffer.getNumSamples(); i++)
+    /*
+     * Walk the buffer in spans rather than samples. A span ends at the end of a surge block
+     * or at the end of the buffer, so each span is one contiguous copy out of the surge output.
+     * MIDI is applied when the surge block it falls in starts, with its offset into the block
+     * so note-ons still start on their own sample. MIDI landing in a block which was already
+     * rendered in the previous buffer starts at the next block edge instead.
+     */
+    auto *sAL = sceneAOutput.getNumChannels() == 2 ? sceneAOutput.getWritePointer(0) : nullptr;
+    auto *sAR = sceneAOutput.getNumChannels() == 2 ? sceneAOutput.getWritePointer(1) : nullptr;
+    auto *sBL = sceneBOutput.getNumChannels() == 2 ? sceneBOutput.getWritePointer(0) : nullptr;
+    auto *sBR = sceneBOutput.getNumChannels() == 2 ? sceneBOutput.getWritePointer(1) : nullptr;
+    auto *outL = mainOutput.getWritePointer(0);
+    auto *outR = mainOutput.getWritePointer(1);
+
+    int i = 0;
+
+    while (i < sc)
     {
-        while (i == nextMidi)
-        {
-            applyMidi(*midiIt);
-            midiIt++;
+        auto spanEnd = std::min(sc, i + BLOCK_SIZE - blockPos);
+        auto span = spanEnd - i;
 
-            if (midiIt == midiMessages.cend())
-            {
-                nextMidi = -1;
-            }
-            else
+        if (blockPos == 0)
+        {
+            while (nextMidi >= 0 && nextMidi < i + BLOCK_SIZE)
             {
-                nextMidi = (*midiIt).samplePosition;
+                surge->eventOffsetInBlock = std::max(0, nextMidi - i);
+                applyMidi(*midiIt);
+                midiIt++;
+
+                if (midiIt == midiMessages.cend())
+                {
+                    nextMidi = -1;
+                }
+                else
+                {
+                    nextMidi = (*midiIt).samplePosition;
+                }
             }
         }
 
-        auto outL = mainOutput.getWritePointer(0, i);
-        auto outR = mainOutput.getWritePointer(1, i);
-
         if (blockPos == 0 && incL && incR)
         {
             surge->process_input = true;
-
-            if (inputIsLatent)
-            {
-                memcpy(&(surge->input[0][0]), inputLatentBuffer[0], BLOCK_SIZE * sizeof(float));
-                memcpy(&(surge->input[1][0]), inputLatentBuffer[1], BLOCK_SIZE * sizeof(float));
-            }
-            else
-            {
-                auto inL = incL + i;
-                auto inR = incR + i;
-
-                memcpy(&(surge->input[0][0]), inL, BLOCK_SIZE * sizeof(float));
-                memcpy(&(surge->input[1][0]), inR, BLOCK_SIZE * sizeof(float));
-            }
+            readBlockInput(incL, incR, i, sc);
         }
         else
         {
@@ -528,51 +531,46 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
 
         if (blockPos == 0)
         {
+            if (tempoGlideBlocks > 0)
+            {
+                surge->time_data.tempo = --tempoGlideBlocks == 0
+                                             ? tempoGlideTarget
+                                             : surge->time_data.tempo + tempoGlideStep;
+            }
+
             surge->process();
             surge->time_data.ppqPos +=
                 (double)BLOCK_SIZE * surge->time_data.tempo / (60. * surge->storage.samplerate);
         }
 
-        if (inputIsLatent && incL && incR)
-        {
-            inputLatentBuffer[0][blockPos] = incL[i];
-            inputLatentBuffer[1][blockPos] = incR[i];
-        }
-
-        *outL = surge->output[0][blockPos];
-        *outR = surge->output[1][blockPos];
+        memcpy(outL + i, &surge->output[0][blockPos], span * sizeof(float));
+        memcpy(outR + i, &surge->output[1][blockPos], span * sizeof(float));
 
         if (surge->activateExtraOutputs)
         {
-            if (sceneAOutput.getNumChannels() == 2)
+            if (sAL && sAR)
             {
-                auto sAL = sceneAOutput.getWritePointer(0, i);
-                auto sAR = sceneAOutput.getWritePointer(1, i);
-
-                if (sAL && sAR)
-                {
-                    *sAL = surge->sceneout[0][0][blockPos];
-                    *sAR = surge->sceneout[0][1][blockPos];
-                }
+                memcpy(sAL + i, &surge->sceneout[0][0][blockPos], span * sizeof(float));
+                memcpy(sAR + i, &surge->sceneout[0][1][blockPos], span * sizeof(float));
             }
 
-            if (sceneBOutput.getNumChannels() == 2)
+            if (sBL && sBR)
             {
-                auto sBL = sceneBOutput.getWritePointer(0, i);
-                auto sBR = sceneBOutput.getWritePointer(1, i);
-
-                if (sBL && sBR)
-                {
-                    *sBL = surge->sceneout[1][0][blockPos];
-                    *sBR = surge->sceneout[1][1][blockPos];
-                }
+                memcpy(sBL + i, &surge->sceneout[1][0][blockPos], span * sizeof(float));
+                memcpy(sBR + i, &surge->sceneout[1][1][blockPos], span * sizeof(float));
             }
         }
 
-        blockPos = (blockPos + 1) & (BLOCK_SIZE - 1);
+        blockPos = (blockPos + span) & (BLOCK_SIZE - 1);
+        i = spanEnd;
     }
 
-    // This should, in theory, never happen, but better safe than sorry
+    if (incL && incR)
+        rememberInput(incL, incR, sc);
+
+    // a buffer too short to reach a block start leaves its MIDI for the edge of the next block
+    surge->eventOffsetInBlock = 0;
+
     while (midiIt != midiMessages.cend())
     {
         applyMidi(*midiIt);
@@ -582,7 +580,84 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     processBlockPostFunction();
 }
 
-void SurgeSynthProcessor::processBlockPlayhead()
+void SurgeSynthProcessor::readBlockInput(const float *inL, const float *inR, int i, int frames)
+{
+    auto shortBy = BLOCK_SIZE - (frames - i);
+
+    if (shortBy > inputDelay)
+    {
+        if (!inputIsLatent)
+        {
+            surge->storage.reportError(
+                fmt::format("Incoming audio input block is not a multiple of {sz} samples.\n"
+                            "If audio input is used, it will be delayed by as few samples as "
+                            "the host's buffer sizes allow, and at most {sz}, in order to "
+                            "compensate.\n"
+                            "This can be avoided by setting the DAW to use fixed buffer sizes, "
+                            "if possible.",
+                            fmt::arg("sz", BLOCK_SIZE)),
+                "Audio Input Latency Activated", SurgeStorage::AUDIO_INPUT_LATENCY_WARNING,
+                false);
+        }
+
+        inputDelay = shortBy;
+        inputIsLatent = true;
+    }
+
+    // the first samples of the block may still be in the last buffer
+    auto start = i - inputDelay;
+    auto fromHistory = std::clamp(-start, 0, BLOCK_SIZE);
+    const float *in[2] = {inL, inR};
+
+    for (int c = 0; c < 2; ++c)
+    {
+        if (fromHistory > 0)
+            memcpy(&(surge->input[c][0]), &inputHistory[c][BLOCK_SIZE - fromHistory],
+                   fromHistory * sizeof(float));
+
+        memcpy(&(surge->input[c][fromHistory]), in[c] + start + fromHistory,
+               (BLOCK_SIZE - fromHistory) * sizeof(float));
+    }
+}
+
+void SurgeSynthProcessor::rememberInput(const float *inL, const float *inR, int frames)
+{
+    const float *in[2] = {inL, inR};
+
+    for (int c = 0; c < 2; ++c)
+    {
+        if (frames >= BLOCK_SIZE)
+        {
+            memcpy(inputHistory[c], in[c] + frames - BLOCK_SIZE, BLOCK_SIZE * sizeof(float));
+        }
+        else
+        {
+            memmove(inputHistory[c], &inputHistory[c][frames],
+                    (BLOCK_SIZE - frames) * sizeof(float));
+            memcpy(&inputHistory[c][BLOCK_SIZE - frames], in[c], frames * sizeof(float));
+        }
+    }
+}
+
+void SurgeSynthProcessor::setBlockTempo(double bpm, int samples)
+{
+    auto &tempo = surge->time_data.tempo;
+    auto blocks = samples / BLOCK_SIZE;
+
+    if (!surge->storage.glideHostTempo || blocks < 2 || bpm == tempo || !(bpm > 0 && tempo > 0))
+    {
+        tempo = bpm;
+        tempoGlideBlocks = 0;
+        return;
+    }
+
+    // each block of the buffer steps towards the new tempo, the last one lands on it
+    tempoGlideTarget = bpm;
+    tempoGlideStep = (bpm - tempo) / blocks;
+    tempoGlideBlocks = blocks;
+}
+
+void SurgeSynthProcessor::processBlockPlayhead(int samples)
 {
     auto playhead = getPlayHead();
 
@@ -590,7 +665,7 @@ void SurgeSynthProcessor::processBlockPlayhead()
     {
         juce::AudioPlayHead::CurrentPositionInfo cp;
         playhead->getCurrentPosition(cp);
-        surge->time_data.tempo = cp.bpm;
+        setBlockTempo(cp.bpm, samples);
 
         // isRecording should always imply isPlaying but better safe than sorry
         if (cp.isPlaying || cp.isRecording)
@@ -604,19 +679,45 @@ void SurgeSynthProcessor::processBlockPlayhead()
     }
     else
     {
-        surge->time_data.tempo = standaloneTempo;
+        setBlockTempo(standaloneTempo, samples);
         surge->time_data.timeSigNumerator = 4;
         surge->time_data.timeSigDenominator = 4;
         surge->resetStateFromTimeData();
     }
 }
 
+bool SurgeSynthProcessor::queueMidiFromGUI(midiR rec)
+{
+    rec.queuedAt = processCallCount;
+
+    if (midiFromGUI.push(rec))
+        return true;
+
+    queueStats.midiFromGUIOverflows++;
+    return false;
+}
+
+bool SurgeSynthProcessor::queueOSCToAudio(oscToAudio om)
+{
+    om.queuedAt = processCallCount;
+
+    if (oscRingBuf.push(om))
+        return true;
+
+    queueStats.oscOverflows++;
+    return false;
+}
+
 void SurgeSynthProcessor::processBlockMidiFromGUI()
 {
     midiR rec;
+    int budget = maxMidiFromGUIPerProcess;
 
-    while (midiFromGUI.pop(rec))
+    while (budget > 0 && midiFromGUI.pop(rec))
     {
+        budget--;
+        queueStats.noteWait(processCallCount - rec.queuedAt);
+
         if (rec.type == midiR::NOTE)
         {
             if (rec.on)
@@ -637,24 +738,40 @@ void SurgeSynthProcessor::processBlockMidiFromGUI()
             surge->channelController(rec.ch, 64, rec.cval);
         }
     }
+
+    if (budget == 0 && midiFromGUI.af.getNumReady() > 0)
+        queueStats.carriedOverProcessCalls++;
 }
 
 void SurgeSynthProcessor::processBlockOSC()
 {
-    auto messages = oscRingBuf.popall();
-    for (const auto &om : messages)
+    auto applyParam = [this](Parameter *p, float pval) {
+        if (p->valtype == vt_int)
+            pval = Parameter::intScaledToFloat(pval, p->val_max.i, p->val_min.i);
+        surge->setParameter01(surge->idForParameter(p), pval, true);
+        surge->storage.getPatch().isDirty = true;
+    };
+
+    oscToAudio om;
+    int budget = maxOSCPerProcess;
+
+    // a batch counts for all its values, but is always applied whole
+    while (budget > 0 && oscRingBuf.pop(om))
     {
+        budget -= (om.type == oscToAudio::PARAMETER_BATCH) ? om.batch->size : 1;
+        queueStats.noteWait(processCallCount - om.queuedAt);
+
         switch (om.type)
         {
         case oscToAudio::PARAMETER:
-        {
-            float pval = om.fval;
-            if (om.param->valtype == vt_int)
-                pval = Parameter::intScaledToFloat(pval, om.param->val_max.i, om.param->val_min.i);
-            surge->setParameter01(surge->idForParameter(om.param), pval, true);
-            surge->storage.getPatch().isDirty = true;
+            applyParam(om.param, om.fval);
+            break;
+
+        case oscToAudio::PARAMETER_BATCH:
+            for (int i = 0; i < om.batch->size; ++i)
+                applyParam(om.batch->items[i].first, om.batch->items[i].second);
+            om.batch->inUse = false;
             break;
-        }
 
         case oscToAudio::MNOTE:
             if (om.on)
@@ -677,10 +794,15 @@ void SurgeSynthProcessor::processBlockOSC()
             break;
         }
     }
+
+    if (budget <= 0 && oscRingBuf.af.getNumReady() > 0)
+        queueStats.carriedOverProcessCalls++;
 }
 
 void SurgeSynthProcessor::processBlockPostFunction()
 {
+    processCallCount++;
+
     if (checkNamesEvery++ > 10)
     {
         checkNamesEvery = 0;
@@ -719,6 +841,10 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
 
     processBlockPlayhead();
     processBlockMidiFromGUI();
+    processBlockOSC();
+
+    // JUCE's wrappers, clap-juce-extensions' render extension included, all report this
+    surge->storage.renderingOffline = isNonRealtime();
 
     auto ev = process->in_events;
     auto evtsz = ev->size(ev);
@@ -731,9 +857,8 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
         nextevtime = evt->time;
     }
 
-    // TO DO: Sidechain Input
-
-    float *outL{nullptr}, *outR{nullptr}, *inL{nullptr}, *inR{nullptr};
+    float *outL{nullptr}, *outR{nullptr};
+    const float *inL{nullptr}, *inR{nullptr};
     outL = process->audio_outputs[0].data32[0];
     outR = outL;
     if (process->audio_outputs[0].channel_count == 2)
@@ -742,9 +867,8 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
     float *sceneAL{nullptr}, *sceneAR{nullptr}, *sceneBL{nullptr}, *sceneBR{nullptr};
     bool haveSceneOut{false};
 
-    if (process->audio_inputs_count == 1)
+    if (process->audio_inputs_count == 1 && process->audio_inputs[0].channel_count > 0)
     {
-        surge->process_input = true;
         inL = process->audio_inputs[0].data32[0];
         inR = inL;
         if (process->audio_inputs[0].channel_count == 2)
@@ -763,14 +887,29 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
             haveSceneOut = false;
     }
 
-    for (int s = 0; s < process->frames_count; ++s)
+    int sc = process->frames_count;
+
+    /*
+     * Walk the buffer in spans which end at the end of a surge block or the end of the buffer,
+     * as the JUCE path does. Events are applied when the surge block they fall in starts,
+     * with their offset into it so note-ons still start on their own sample; and when the host
+     * buffer is a multiple of BLOCK_SIZE, every span is a whole block copied straight out of
+     * the synth.
+     */
+    int i = 0;
+
+    while (i < sc)
     {
+        auto spanEnd = std::min(sc, i + BLOCK_SIZE - blockPos);
+        auto span = spanEnd - i;
+
         if (blockPos == 0)
         {
-            while (nextevtime >= 0 && nextevtime < s + BLOCK_SIZE && currev < evtsz)
+            while (nextevtime >= 0 && nextevtime < i + BLOCK_SIZE && currev < evtsz)
             {
                 auto evt = ev->get(ev, currev);
 
+                surge->eventOffsetInBlock = std::max(0, nextevtime - i);
                 process_clap_event(evt);
 
                 currev++;
@@ -783,17 +922,19 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
                     nextevtime = -1;
                 }
             }
-        }
 
-        if (blockPos == 0)
-        {
+            flushPendingNoteEvents();
+
             if (inL && inR)
             {
-                memcpy(&(surge->input[0][0]), inL, BLOCK_SIZE * sizeof(float));
-                memcpy(&(surge->input[1][0]), inR, BLOCK_SIZE * sizeof(float));
-                inL += BLOCK_SIZE;
-                inR += BLOCK_SIZE;
+                surge->process_input = true;
+                readBlockInput(inL, inR, i, sc);
             }
+            else
+            {
+                surge->process_input = false;
+            }
+
             surge->process();
             surge->time_data.ppqPos +=
                 (double)BLOCK_SIZE * surge->time_data.tempo / (60. * surge->storage.samplerate);
@@ -806,7 +947,7 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
                     auto evt = clap_event_note();
                     evt.header.size = sizeof(clap_event_note);
                     evt.header.type = (uint16_t)CLAP_EVENT_NOTE_END;
-                    evt.header.time = s;
+                    evt.header.time = i;
                     evt.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
                     evt.header.flags = 0;
 
@@ -820,36 +961,35 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
                 }
             }
         }
-        *outL = surge->output[0][blockPos];
-        *outR = surge->output[1][blockPos];
-        outL++;
-        outR++;
+
+        memcpy(outL + i, &surge->output[0][blockPos], span * sizeof(float));
+        memcpy(outR + i, &surge->output[1][blockPos], span * sizeof(float));
 
         if (haveSceneOut)
         {
-            *sceneAL = surge->sceneout[0][0][blockPos];
-            *sceneAR = surge->sceneout[0][1][blockPos];
-            *sceneBL = surge->sceneout[1][0][blockPos];
-            *sceneBR = surge->sceneout[1][1][blockPos];
-
-            sceneAL++;
-            sceneAR++;
-            sceneBL++;
-            sceneBR++;
+            memcpy(sceneAL + i, &surge->sceneout[0][0][blockPos], span * sizeof(float));
+            memcpy(sceneAR + i, &surge->sceneout[0][1][blockPos], span * sizeof(float));
+            memcpy(sceneBL + i, &surge->sceneout[1][0][blockPos], span * sizeof(float));
+            memcpy(sceneBR + i, &surge->sceneout[1][1][blockPos], span * sizeof(float));
         }
 
-        // TO DO: Scene Output
-
-        blockPos = (blockPos + 1) & (BLOCK_SIZE - 1);
+        blockPos = (blockPos + span) & (BLOCK_SIZE - 1);
+        i = spanEnd;
     }
 
+    if (inL && inR)
+        rememberInput(inL, inR, sc);
+
     // just in case
+    surge->eventOffsetInBlock = 0;
+
     while (currev < evtsz)
     {
         auto evt = ev->get(ev, currev);
         process_clap_event(evt);
         currev++;
     }
+    flushPendingNoteEvents();
 
     processBlockPostFunction();
     return CLAP_PROCESS_CONTINUE;
@@ -872,6 +1012,8 @@ void SurgeSynthProcessor::clap_direct_paramsFlush(const clap_input_events *in,
             jp->processorParam->setValue(pevt->value);
         }
     }
+    flushPendingNoteEvents();
+
     if (!is_clap_processing)
     {
         // Setting params can change internal state so give the synth a chance to react
@@ -886,14 +1028,26 @@ void SurgeSynthProcessor::process_clap_event(const clap_event_header_t *evt)
     if (evt->space_id != CLAP_CORE_EVENT_SPACE_ID)
         return;
 
+    // anything else ends a run of gathered expressions, so nothing is applied out of order
+    if (evt->type != CLAP_EVENT_NOTE_EXPRESSION && evt->type != CLAP_EVENT_PARAM_MOD)
+        flushPendingNoteEvents();
+
+    // and anything but another note-on ends a run of gathered note-ons
+    if (evt->type != CLAP_EVENT_NOTE_ON && evt->type != CLAP_EVENT_MIDI)
+        surge->flushNoteOns();
+
     switch (evt->type)
     {
     case CLAP_EVENT_NOTE_ON:
     {
         auto nevt = reinterpret_cast<const clap_event_note *>(evt);
 
+        // note offs always get through, so changing the channels never leaves a note hanging
+        if (nevt->velocity != 0 && !surge->receivesMidiChannel(nevt->channel))
+            break;
+
         if (nevt->velocity != 0)
-            surge->playNote(nevt->channel, nevt->key, 127 * nevt->velocity, 0, nevt->note_id);
+            surge->queueNoteOn(nevt->channel, nevt->key, 127 * nevt->velocity, 0, nevt->note_id);
         else
             surge->releaseNote(nevt->channel, nevt->key, 127 * nevt->velocity, nevt->note_id);
 
@@ -958,13 +1112,15 @@ void SurgeSynthProcessor::process_clap_event(const clap_event_header_t *evt)
         if ((pevt->note_id == -1 && pevt->channel == -1 && pevt->key == -1) ||
             !jp->supportsPolyphonicModulation())
         {
+            // poly modulation backs out the mono amount underneath it, so apply those first
+            flushPendingNoteEvents();
             jassert(jp->supportsMonophonicModulation());
             jp->applyMonophonicModulation(pevt->amount);
         }
         else
         {
             jassert(jp->supportsPolyphonicModulation());
-            jp->applyPolyphonicModulation(pevt->note_id, pevt->key, pevt->channel, pevt->amount);
+            queuePolyMod(jp, pevt->note_id, pevt->key, pevt->channel, pevt->amount);
         }
     }
     break;
@@ -999,8 +1155,8 @@ void SurgeSynthProcessor::process_clap_event(const clap_event_header_t *evt)
         case CLAP_NOTE_EXPRESSION_EXPRESSION:
             break;
         }
-        if (net != SurgeVoice::UNKNOWN)
-            surge->setNoteExpression(net, pevt->note_id, pevt->key, pevt->channel, pevt->value);
+        if (net != SurgeVoice::UNKNOWN && surge->receivesMidiChannel(pevt->channel))
+            queueNoteExpression(net, pevt->note_id, pevt->key, pevt->channel, pevt->value);
     }
     break;
 
@@ -1025,14 +1181,21 @@ void SurgeSynthProcessor::applyMidi(const juce::MidiMessage &m)
 {
     const int ch = m.getChannel() - 1;
 
+    if (!surge->receivesMidiChannel(ch) && !m.isNoteOff())
+        return;
+
     juce::ScopedValueSetter<bool> midiAdd(isAddingFromMidi, true);
     midiKeyboardState.processNextMidiEvent(m);
 
+    // note-ons gather into one batch until anything else comes along
+    if (!m.isNoteOn() || m.getVelocity() == 0)
+        surge->flushNoteOns();
+
     if (m.isNoteOn())
     {
         // no note ids coming from juce- or ui- land
         if (m.getVelocity() != 0)
-            surge->playNote(ch, m.getNoteNumber(), m.getVelocity(), 0, -1);
+            surge->queueNoteOn(ch, m.getNoteNumber(), m.getVelocity(), 0, -1);
         else
             surge->releaseNote(ch, m.getNoteNumber(), m.getVelocity(), -1);
     }
@@ -1106,7 +1269,7 @@ void SurgeSynthProcessor::surgeParameterUpdated(const SurgeSynthesizer::ID &id,
     auto spar = paramsByID[id];
     if (spar)
     {
-        spar->setValueNotifyingHost(f);
+        pendingHostNotifications.add(spar, f);
     }
 }
 
@@ -1114,7 +1277,44 @@ void SurgeSynthProcessor::surgeMacroUpdated(const long id, float f)
 {
     auto spar = macrosById[id];
     if (spar)
-        spar->setValueNotifyingHost(f);
+        pendingHostNotifications.add(spar, f);
+}
+
+void SurgeSynthProcessor::PendingHostNotifications::add(SurgeBaseParam *par, float value)
+{
+    bool first;
+    {
+        std::lock_guard<std::mutex> g(lock);
+        first = pending.empty();
+
+        auto it = pendingIndex.find(par);
+        if (it != pendingIndex.end())
+        {
+            pending[it->second].second = value;
+        }
+        else
+        {
+            pendingIndex[par] = pending.size();
+            pending.emplace_back(par, value);
+        }
+    }
+
+    if (first)
+        triggerAsyncUpdate();
+}
+
+void SurgeSynthProcessor::PendingHostNotifications::flush()
+{
+    {
+        std::lock_guard<std::mutex> g(lock);
+        sending.clear();
+        std::swap(sending, pending);
+        pendingIndex.clear();
+    }
+
+    // outside the lock, as the host may well call back into us with the value
+    for (auto &[par, value] : sending)
+        par->setValueNotifyingHost(value);
 }
 
 std::string SurgeSynthProcessor::paramClumpName(int clumpid)
@@ -1157,14 +1357,14 @@ void SurgeSynthProcessor::handleNoteOn(juce::MidiKeyboardState *source, int midi
                                        int midiNoteNumber, float velocity)
 {
     if (!isAddingFromMidi)
-        midiFromGUI.push(midiR(midiChannel - 1, midiNoteNumber, (int)(127.f * velocity), true));
+        queueMidiFromGUI(midiR(midiChannel - 1, midiNoteNumber, (int)(127.f * velocity), true));
 }
 
 void SurgeSynthProcessor::handleNoteOff(juce::MidiKeyboardState *source, int midiChannel,
                                         int midiNoteNumber, float velocity)
 {
     if (!isAddingFromMidi)
-        midiFromGUI.push(midiR(midiChannel - 1, midiNoteNumber, (int)(127.f * velocity), false));
+        queueMidiFromGUI(midiR(midiChannel - 1, midiNoteNumber, (int)(127.f * velocity), false));
 }
 
 juce::AudioProcessorParameter *SurgeSynthProcessor::getBypassParameter() const
@@ -1181,6 +1381,115 @@ uint32_t SurgeSynthProcessor::remoteControlsPageCount() noexcept
     return 5; // macros + scene a and b mixer and filters
 }
 
+void SurgeSynthProcessor::queueNoteExpression(SurgeVoice::NoteExpressionType net,
+                                              int32_t note_id, int16_t key, int16_t channel,
+                                              float value)
+{
+    for (int i = 0; i < nPendingExpressions; ++i)
+    {
+        auto &pe = pendingExpressions[i];
+        if (pe.note_id == note_id && pe.key == key && pe.channel == channel)
+        {
+            pe.values[net] = value;
+            pe.which |= 1 << net;
+            return;
+        }
+    }
+
+    if (nPendingExpressions == maxPendingNoteEvents)
+        flushPendingNoteEvents();
+
+    auto &pe = pendingExpressions[nPendingExpressions++];
+    pe.note_id = note_id;
+    pe.key = key;
+    pe.channel = channel;
+    pe.values[net] = value;
+    pe.which = 1 << net;
+}
+
+void SurgeSynthProcessor::queuePolyMod(SurgeBaseParam *param, int32_t note_id, int16_t key,
+                                       int16_t channel, double value)
+{
+    for (int i = 0; i < nPendingPolyMods; ++i)
+    {
+        auto &pm = pendingPolyMods[i];
+        if (pm.param == param && pm.note_id == note_id && pm.key == key && pm.channel == channel)
+        {
+            pm.value = value;
+            return;
+        }
+    }
+
+    if (nPendingPolyMods == maxPendingNoteEvents)
+        flushPendingNoteEvents();
+
+    pendingPolyMods[nPendingPolyMods++] = {param, note_id, key, channel, value};
+}
+
+void SurgeSynthProcessor::flushPendingNoteEvents()
+{
+    // expressions may be for notes which are still queued
+    if (nPendingExpressions > 0 || nPendingPolyMods > 0)
+        surge->flushNoteOns();
+
+    for (int i = 0; i < nPendingExpressions; ++i)
+    {
+        auto &pe = pendingExpressions[i];
+        surge->setNoteExpressions(pe.note_id, pe.key, pe.channel, pe.values.data(), pe.which);
+    }
+
+    for (int i = 0; i < nPendingPolyMods; ++i)
+    {
+        auto &pm = pendingPolyMods[i];
+        pm.param->applyPolyphonicModulation(pm.note_id, pm.key, pm.channel, pm.value);
+    }
+
+    nPendingExpressions = 0;
+    nPendingPolyMods = 0;
+}
+
+void SurgeSynthProcessor::useHostThreadPool(const clap_host *host)
+{
+    clapHost = host;
+    hostThreadPool = nullptr;
+
+    if (host && host->get_extension)
+    {
+        hostThreadPool = static_cast<const clap_host_thread_pool *>(
+            host->get_extension(host, CLAP_EXT_THREAD_POOL));
+    }
+
+    if (hostThreadPool && hostThreadPool->request_exec)
+    {
+        surge->setRenderExecutor(hostThreadPoolExecutor, this);
+    }
+    else
+    {
+        hostThreadPool = nullptr;
+        surge->setRenderExecutor(nullptr, nullptr);
+    }
+}
+
+bool SurgeSynthProcessor::hostThreadPoolExecutor(void *ctx,
+                                                 Surge::Threading::RenderWorkerPool *pool, int n)
+{
+    // the pools only run inside process, which is the one place request_exec is allowed
+    auto that = static_cast<SurgeSynthProcessor *>(ctx);
+
+    that->hostThreadPoolRound = pool;
+    auto res = that->hostThreadPool->request_exec(that->clapHost, (uint32_t)n);
+    that->hostThreadPoolRound = nullptr;
+
+    return res;
+}
+
+void SurgeSynthProcessor::threadPoolExec(uint32_t /*taskIndex*/) noexcept
+{
+    // indices are handed out by the pool, so any task can take any of them
+    if (auto pool = hostThreadPoolRound.load())
+        pool->runPending();
+}
+
 bool SurgeSynthProcessor::remoteControlsPageFill(
     uint32_t pageIndex, juce::String &sectionName, uint32_t &pageID, juce::String &pageName,
     std::array<juce::AudioProcessorParameter *, CLAP_REMOTE_CONTROLS_COUNT> &params) noexcept
@@ -35,6 +35,7 @@
 #include "clap-juce-extensions/clap-juce-extensions.h"
 #endif
 
+#include <mutex>
 #include <unordered_map>
 
 #if MAC
@@ -148,10 +149,13 @@ struct SurgeParamToJuceParamAdapter : SurgeBaseParam
         }
         return 0;
     }
-    juce::String getCurrentValueAsText() const override { return p->get_display(); }
+    juce::String getCurrentValueAsText() const override
+    {
+        return s->getParameterDisplayCached(s->idForParameter(p));
+    }
     juce::String getText(float normalisedValue, int i) const override
     {
-        return p->get_display(true, normalisedValue);
+        return s->getParameterDisplayCached(s->idForParameter(p), true, normalisedValue);
     }
     bool isMetaParameter() const override { return true; }
     const juce::NormalisableRange<float> &getNormalisableRange() const override { return range; }
@@ -283,6 +287,8 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
   public:
     //==============================================================================
     SurgeSynthProcessor();
+    // hosts outside a DAW, like the CLI, use this to size the engine (its voice capacity)
+    explicit SurgeSynthProcessor(const SurgeStorage::SurgeStorageConfig &config);
     ~SurgeSynthProcessor();
 
     //==============================================================================
@@ -296,7 +302,11 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
     bool priorCallWasProcessBlockNotBypassed{true};
     int bypassCountdown{-1};
 
-    void processBlockPlayhead();
+    void processBlockPlayhead(int samples);
+    void setBlockTempo(double bpm, int samples);
+    // a host tempo change being spread over the blocks of a buffer, see glideHostTempo
+    double tempoGlideStep{0}, tempoGlideTarget{0};
+    int tempoGlideBlocks{0};
     void processBlockMidiFromGUI();
     void processBlockOSC();
     void processBlockPostFunction();
@@ -322,11 +332,13 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
         int ch{0}, note{0}, vel{0};
         bool on{false};
         int cval{0};
+        uint64_t queuedAt{0};
         midiR() {}
         midiR(int c, int n, int v, bool o) : type(NOTE), ch(c), note(n), vel(v), on(o) {}
         midiR(Type type, int cval) : type(type), cval(cval) {}
     };
     LockFreeStack<midiR, 4096> midiFromGUI;
+    bool queueMidiFromGUI(midiR rec);
     bool isAddingFromMidi{false};
     void handleNoteOn(juce::MidiKeyboardState *source, int midiChannel, int midiNoteNumber,
                       float velocity) override;
@@ -335,22 +347,30 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
 
     //==============================================================================
     // Open Sound Control
+
+    static constexpr int n_oscParamBatches = 8;
+    std::array<Surge::OSC::ParamBatch, n_oscParamBatches> oscParamBatches;
+
     struct oscToAudio
     {
         enum Type
         {
             MNOTE,
             FREQNOTE,
-            PARAMETER
+            PARAMETER,
+            PARAMETER_BATCH
         } type{PARAMETER};
         Parameter *param;
+        Surge::OSC::ParamBatch *batch{nullptr};
         float fval{0.0};
         char mnote, vel;
         bool on{false};
         int32_t noteid;
+        uint64_t queuedAt{0};
 
         oscToAudio() {}
         oscToAudio(Parameter *p, float f) : type(PARAMETER), param(p), fval(f) {}
+        oscToAudio(Surge::OSC::ParamBatch *b) : type(PARAMETER_BATCH), batch(b) {}
         oscToAudio(float freq, char velocity, bool noteon, int32_t nid)
             : type(FREQNOTE), fval(freq), vel(velocity), on(noteon), noteid(nid)
         {
@@ -360,9 +380,30 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
         {
         }
     };
-    LockFreeStack<oscToAudio, 4096> oscInput;
+    LockFreeStack<oscToAudio, 4096> oscRingBuf;
+    bool queueOSCToAudio(oscToAudio om);
+
+    /*
+     * The GUI and OSC queues are drained a bounded amount per process call, so a burst can't
+     * push one call past its deadline; whatever is left waits, in order, for the next call.
+     * Entries are stamped with the process call they were queued in, and these counters show
+     * how well the queues are keeping up.
+     */
+    static constexpr int maxMidiFromGUIPerProcess = 128;
+    static constexpr int maxOSCPerProcess = 256;
+    std::atomic<uint64_t> processCallCount{0};
+    struct QueueStats
+    {
+        std::atomic<uint32_t> midiFromGUIOverflows{0}, oscOverflows{0};
+        std::atomic<uint32_t> carriedOverProcessCalls{0};
+        std::atomic<uint32_t> maxWaitProcessCalls{0};
 
-    sst::cpputils::SimpleRingBuffer<oscToAudio, 4096> oscRingBuf;
+        void noteWait(uint64_t waited)
+        {
+            if (waited > maxWaitProcessCalls)
+                maxWaitProcessCalls = (uint32_t)waited;
+        }
+    } queueStats;
 
     Surge::OSC::OpenSoundControl oscHandler;
 
@@ -373,13 +414,12 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
     void stopOSCOut();
 
     void patch_load_to_OSC(fs::path newpath);
-    void param_change_to_OSC(std::string paramPath, std::string valStr);
     void paramChangeToListeners(Parameter *p);
 
     // --- 'param change' listener(s) ----
     // Listeners are notified whenever a parameter finishes changing, along with the new value.
-    // Listeners should do any significant work on their own thread; for example, the OSC
-    // paramChangeListener calls OSCSender::send(), which runs on a juce::MessageManager thread.
+    // Listeners should do any significant work on their own thread. OSC out isn't one of these;
+    // it coalesces changes and sends them from its own thread, see OpenSoundControl.
     //
     // Be sure to delete any added listeners in the destructor of the class that added them.
     std::unordered_map<std::string, std::function<void(const std::string &, const std::string &)>>
@@ -413,6 +453,28 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
     void surgeParameterUpdated(const SurgeSynthesizer::ID &id, float value) override;
     void surgeMacroUpdated(long macroNum, float d) override;
 
+    /*
+     * The editor tells the host about every value it sets, so a drag, a macro sweep or a
+     * menu action touching a whole section would otherwise call setValueNotifyingHost for
+     * every intermediate value. These are gathered here, the last value for each parameter
+     * winning, and sent in one go from the message thread. Gesture edges flush first, so the
+     * host sees the final value inside the gesture it belongs to.
+     */
+    struct PendingHostNotifications : juce::AsyncUpdater
+    {
+        ~PendingHostNotifications() override { cancelPendingUpdate(); }
+
+        void add(SurgeBaseParam *par, float value);
+        void flush();
+        void handleAsyncUpdate() override { flush(); }
+
+      private:
+        std::mutex lock;
+        std::vector<std::pair<SurgeBaseParam *, float>> pending;
+        std::unordered_map<SurgeBaseParam *, size_t> pendingIndex;
+        std::vector<std::pair<SurgeBaseParam *, float>> sending;
+    } pendingHostNotifications;
+
     std::unique_ptr<SurgeSynthesizer> surge;
     std::unordered_map<SurgeSynthesizer::ID, SurgeParamToJuceParamAdapter *> paramsByID;
     std::vector<SurgeMacroToJuceParamAdapter *> macrosById;
@@ -434,6 +496,37 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
     void clap_direct_paramsFlush(const clap_input_events * /*in*/,
                                  const clap_output_events * /*out*/) noexcept override;
     void process_clap_event(const clap_event_header_t *evt);
+
+    /*
+     * Dense MPE input is mostly note expressions and polyphonic modulations. A run of those
+     * with nothing else between them is gathered here and applied when the run ends (at the
+     * latest when the block they fall in starts). Both set a value rather than add to one, so
+     * only the last per note, or per parameter and note, matters; and each note's expressions
+     * reach its voices in one pass.
+     */
+    struct PendingNoteExpression
+    {
+        int32_t note_id;
+        int16_t key, channel;
+        uint32_t which;
+        std::array<float, SurgeVoice::numNoteExpressionTypes> values;
+    };
+    struct PendingPolyMod
+    {
+        SurgeBaseParam *param;
+        int32_t note_id;
+        int16_t key, channel;
+        double value;
+    };
+    static constexpr int maxPendingNoteEvents = 64;
+    std::array<PendingNoteExpression, maxPendingNoteEvents> pendingExpressions;
+    std::array<PendingPolyMod, maxPendingNoteEvents> pendingPolyMods;
+    int nPendingExpressions{0}, nPendingPolyMods{0};
+    void queueNoteExpression(SurgeVoice::NoteExpressionType net, int32_t note_id, int16_t key,
+                             int16_t channel, float value);
+    void queuePolyMod(SurgeBaseParam *param, int32_t note_id, int16_t key, int16_t channel,
+                      double value);
+    void flushPendingNoteEvents();
     bool supportsVoiceInfo() override { return true; }
     bool voiceInfoGet(clap_voice_info *info) override
     {
@@ -449,6 +542,20 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
                            uint32_t & /*pageID*/, juce::String & /*pageName*/,
                            std::array<juce::AudioProcessorParameter *, CLAP_REMOTE_CONTROLS_COUNT>
                                & /*params*/) noexcept override;
+
+    /*
+     * CLAP thread pool. Given the host, and if it offers CLAP_EXT_THREAD_POOL, the engine's
+     * render pools stop running threads of their own and hand each round to the host with
+     * request_exec; threadPoolExec is our side of that, clap_plugin_thread_pool::exec.
+     * Both are for the wrapper to call; useHostThreadPool only while processing is stopped.
+     */
+    void useHostThreadPool(const clap_host *host);
+    void threadPoolExec(uint32_t taskIndex) noexcept;
+    static bool hostThreadPoolExecutor(void *ctx, Surge::Threading::RenderWorkerPool *pool,
+                                       int n);
+    const clap_host *clapHost{nullptr};
+    const clap_host_thread_pool *hostThreadPool{nullptr};
+    std::atomic<Surge::Threading::RenderWorkerPool *> hostThreadPoolRound{nullptr};
 #endif
 
   private:
@@ -463,8 +570,18 @@ class SurgeSynthProcessor : public juce::AudioProcessor,
 
     int32_t non_clap_noteid{1};
 
-    // For non-block-size uniform blocks we need to lag input
-    float inputLatentBuffer alignas(16)[2][BLOCK_SIZE];
+    /*
+     * A surge block needs all of its input when it starts, so a block which runs past the end
+     * of the host buffer can't have it. Rather than a whole block, we lag the input by just
+     * what the buffers the host has sent so far need: the most any block start has been short
+     * by. Hosts with buffers which are a multiple of BLOCK_SIZE never need any, and at worst
+     * it is a block. The last BLOCK_SIZE input samples of earlier buffers are kept here for
+     * the lagged reads which reach back past the start of the current one.
+     */
+    int inputDelay{0};
+    float inputHistory alignas(16)[2][BLOCK_SIZE];
+    void readBlockInput(const float *inL, const float *inR, int i, int frames);
+    void rememberInput(const float *inL, const float *inR, int frames);
 
   public:
     bool inputIsLatent{false};
@@ -20,16 +20,41 @@
  * https://github.com/surge-synthesizer/surge
  */
 
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#if WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
 #include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
 #include <CLI11/CLI11.hpp>
 
 #include "version.h"
 
 #include "SurgeSynthProcessor.h"
+#include "WavetableLoader.h"
+#include "sst/plugininfra/cpufeatures.h"
 
 // Thanks
 // https://stackoverflow.com/questions/16077299/how-to-print-current-time-with-milliseconds-using-c-c11
@@ -58,11 +83,13 @@ enum LogLevels
     VERBOSE = 2
 };
 int logLevel{BASIC};
+// streaming to stdout moves the log to stderr
+std::ostream *logStream{&std::cout};
 #define LOG(lev, x)                                                                                \
     {                                                                                              \
         if (lev >= logLevel)                                                                       \
         {                                                                                          \
-            std::cout << logTimestamp() << " - " << x << std::endl;                                \
+            *logStream << logTimestamp() << " - " << x << std::endl;                               \
         }                                                                                          \
     }
 #define PRINT(x) LOG(logLevel + 1, x);
@@ -104,10 +131,20 @@ void listMidiDevices()
     juce::MessageManager::deleteInstance();
 }
 
+// voices per scene for every engine we make; 0 takes the voiceCapacity user default
+static int voiceCapacity{0};
+
+static std::unique_ptr<SurgeSynthProcessor> makeProcessor()
+{
+    auto config = SurgeStorage::SurgeStorageConfig::fromDataPath("");
+    config.voiceCapacity = voiceCapacity;
+    return std::make_unique<SurgeSynthProcessor>(config);
+}
+
 struct SurgePlayback : juce::MidiInputCallback, juce::AudioIODeviceCallback
 {
     std::unique_ptr<SurgeSynthProcessor> proc;
-    SurgePlayback() { proc = std::make_unique<SurgeSynthProcessor>(); }
+    SurgePlayback() { proc = makeProcessor(); }
 
     static constexpr int midiBufferSz{4096}, midiBufferSzMask{midiBufferSz - 1};
     std::array<juce::MidiMessage, midiBufferSz> midiBuffer;
@@ -119,16 +156,13 @@ struct SurgePlayback : juce::MidiInputCallback, juce::AudioIODeviceCallback
         midiWP = (midiWP + 1) & midiBufferSzMask;
     }
 
+    // render numSamples into L and R, copying whole runs of each engine block at a time
     int pos = BLOCK_SIZE;
-    void
-    audioDeviceIOCallbackWithContext(const float *const *inputChannelData, int numInputChannels,
-                                     float *const *outputChannelData, int numOutputChannels,
-                                     int numSamples,
-                                     const juce::AudioIODeviceCallbackContext &context) override
+    void render(float *L, float *R, int numSamples)
     {
         proc->processBlockOSC();
 
-        for (int i = 0; i < numSamples; ++i)
+        for (int i = 0; i < numSamples;)
         {
             if (pos >= BLOCK_SIZE)
             {
@@ -142,67 +176,1652 @@ struct SurgePlayback : juce::MidiInputCallback, juce::AudioIODeviceCallback
                 proc->surge->process();
                 pos = 0;
             }
-            outputChannelData[0][i] = proc->surge->output[0][pos];
-            outputChannelData[1][i] = proc->surge->output[1][pos];
-            pos++;
+
+            auto n = std::min(numSamples - i, BLOCK_SIZE - pos);
+            memcpy(L + i, &proc->surge->output[0][pos], n * sizeof(float));
+            memcpy(R + i, &proc->surge->output[1][pos], n * sizeof(float));
+            pos += n;
+            i += n;
         }
     }
 
+    void
+    audioDeviceIOCallbackWithContext(const float *const *inputChannelData, int numInputChannels,
+                                     float *const *outputChannelData, int numOutputChannels,
+                                     int numSamples,
+                                     const juce::AudioIODeviceCallbackContext &context) override
+    {
+        render(outputChannelData[0], outputChannelData[1], numSamples);
+    }
+
     void audioDeviceStopped() override {}
     void audioDeviceAboutToStart(juce::AudioIODevice *device) override
     {
         LOG(BASIC, "Audio Starting      : SampleRate=" << device->getCurrentSampleRate()
                                                        << " BufferSize="
-                                                       << device->getCurrentBufferSizeSamples());
+                                                       << device->getCurrentBufferSizeSamples()
+                                                       << " BlockSize=" << BLOCK_SIZE);
         proc->surge->setSamplerate(device->getCurrentSampleRate());
     }
 };
 
-int main(int argc, char **argv)
+// best effort: pin the calling thread to a core and/or give it realtime priority
+void configureRenderThread(int core, bool realtime)
 {
-    // juce::ConsoleApplication is just such a mess.
-    CLI::App app("surge-xt-CLI : a command line player for surge-xt");
+#if WINDOWS
+    if (core >= 0 && !SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core))
+        LOG(BASIC, "Unable to pin a render thread to core " << core);
+    if (realtime && !SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+        LOG(BASIC, "Unable to raise a render thread to realtime priority");
+#else
+#if LINUX
+    if (core >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            LOG(BASIC, "Unable to pin a render thread to core " << core);
+    }
+#else
+    // macOS only takes affinity hints, so cores are left to the scheduler there
+    if (core >= 0)
+        LOG(VERBOSE, "Thread pinning is not supported on this platform");
+#endif
+    if (realtime)
+    {
+        sched_param sp{};
+        sp.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) != 0)
+            LOG(BASIC, "Unable to raise a render thread to realtime priority (try rtprio limits "
+                       "or CAP_SYS_NICE)");
+    }
+#endif
+}
 
-    app.set_version_flag("--version", Surge::Build::FullVersionStr);
+/*
+ * Several engines on one multichannel device, like a rack of hardware synths. Each part owns
+ * a MIDI channel range and the output pair at twice its index, and renders on a thread of its
+ * own which can be pinned to a core. The device callback publishes a round, renders the first
+ * part itself, and waits on a fan-in counter for the rest. As in RenderWorkerPool the workers
+ * spin briefly between rounds before they sleep, and the callback takes over any part whose
+ * worker hasn't picked it up in time, so a descheduled worker costs time, never a lockup.
+ */
+struct SurgeRack : juce::MidiInputCallback, juce::AudioIODeviceCallback
+{
+    struct Part
+    {
+        std::unique_ptr<SurgePlayback> engine;
+        int firstChannel{0}, lastChannel{15}; // zero based, inclusive
 
-    bool listDevices{false};
-    app.add_flag("-l,--list-devices", listDevices,
-                 "List all devices available on this system, then exit");
+        float *L{nullptr}, *R{nullptr};
+        std::atomic<uint32_t> claimed{0};
+        std::thread thread;
+    };
+    std::vector<std::unique_ptr<Part>> parts;
 
-    std::string audioInterface{};
-    app.add_flag("-a,--audio-interface", audioInterface,
-                 "Select an audio interface, using index (like '0.2') as shown in list-devices");
+    std::atomic<uint32_t> round{0};
+    std::atomic<int> remaining{0};
+    int numSamples{0};
+    std::vector<float> scratch;
 
-    int midiInput{0};
-    app.add_flag("-m,--midi-input", midiInput,
-                 "Select an midi input using the index from list-devices");
+    std::atomic<bool> keepRunning{true};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCV;
 
-    int oscInputPort{0};
-    app.add_flag("--osc-in-port", oscInputPort, "Port for OSC Input; unspecified means no OSC");
+    // idle yields before a worker sleeps, and the callback's yields before it takes a part over
+    static constexpr int spinsBeforeSleep{20000}, spinsBeforeSteal{2000};
 
-    int oscOutputPort{0};
-    app.add_flag("--osc-out-port", oscOutputPort,
-                 "Port for OSC Output; unspecified means input only; input required");
+    SurgeRack(int n, const std::vector<std::pair<int, int>> &channels, int firstCore,
+              bool realtime)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            auto p = std::make_unique<Part>();
+            p->engine = std::make_unique<SurgePlayback>();
+            std::tie(p->firstChannel, p->lastChannel) = channels[i];
+            parts.push_back(std::move(p));
+        }
 
-    std::string initPatch{};
-    app.add_flag("--init-patch", initPatch, "Choose this file (by path) as the initial patch");
+        auto nCores = (int)std::max(1u, std::thread::hardware_concurrency());
 
-    CLI11_PARSE(app, argc, argv);
+        // the first part renders on the device's thread, so the workers start at the second
+        for (int i = 1; i < n; ++i)
+        {
+            auto core = firstCore < 0 ? -1 : (firstCore + i - 1) % nCores;
+            parts[i]->thread = std::thread([this, i, core, realtime]() {
+                configureRenderThread(core, realtime);
+                workerLoop(i);
+            });
+        }
+    }
 
-    if (listDevices)
+    ~SurgeRack() override
     {
-        listAudioDevices();
-        listMidiDevices();
-        exit(0);
+        keepRunning = false;
+        sleepCV.notify_all();
+
+        for (auto &p : parts)
+            if (p->thread.joinable())
+                p->thread.join();
     }
 
-    /*
-     * This is the default runloop. Basically this main thread acts as the message queue
-     */
-    auto engine = std::make_unique<SurgePlayback>();
-    if (!initPatch.empty())
+    void handleIncomingMidiMessage(juce::MidiInput *source,
+                                   const juce::MidiMessage &message) override
+    {
+        auto ch = message.getChannel() - 1;
+
+        for (auto &p : parts)
+        {
+            // system messages (channel 0 from juce) go to every part
+            if (ch < 0 || (ch >= p->firstChannel && ch <= p->lastChannel))
+                p->engine->handleIncomingMidiMessage(source, message);
+        }
+    }
+
+    bool renderPart(int i, uint32_t r)
+    {
+        auto &p = *parts[i];
+
+        if (p.claimed.exchange(r, std::memory_order_acq_rel) == r)
+            return false;
+
+        p.engine->render(p.L, p.R, numSamples);
+        remaining.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void workerLoop(int i)
+    {
+        auto fpuguard = sst::plugininfra::cpufeatures::FPUStateGuard();
+
+        uint32_t seen = 0;
+        int idle = 0;
+
+        while (keepRunning)
+        {
+            auto r = round.load(std::memory_order_acquire);
+
+            if (r != seen)
+            {
+                renderPart(i, r);
+                seen = r;
+                idle = 0;
+                continue;
+            }
+
+            if (idle < spinsBeforeSleep)
+            {
+                idle++;
+                std::this_thread::yield();
+                continue;
+            }
+
+            // the callback notifies without the lock, so a wakeup can be missed; the timeout
+            // bounds that, and the callback takes the part over well before it runs out
+            std::unique_lock<std::mutex> lk(sleepMutex);
+            sleepCV.wait_for(lk, std::chrono::milliseconds(1));
+        }
+    }
+
+    void
+    audioDeviceIOCallbackWithContext(const float *const *inputChannelData, int numInputChannels,
+                                     float *const *outputChannelData, int numOutputChannels,
+                                     int n,
+                                     const juce::AudioIODeviceCallbackContext &context) override
+    {
+        numSamples = n;
+
+        // parts beyond the device's outputs still run, so they keep time, into a pair of their own
+        if (scratch.size() < 2 * (size_t)n * parts.size())
+            scratch.resize(2 * (size_t)n * parts.size());
+
+        for (int i = 0; i < (int)parts.size(); ++i)
+        {
+            auto c = 2 * i;
+            auto sp = scratch.data() + 2 * (size_t)n * i;
+            bool has =
+                c + 1 < numOutputChannels && outputChannelData[c] && outputChannelData[c + 1];
+
+            parts[i]->L = has ? outputChannelData[c] : sp;
+            parts[i]->R = has ? outputChannelData[c + 1] : sp + n;
+        }
+
+        for (int c = 2 * (int)parts.size(); c < numOutputChannels; ++c)
+            if (outputChannelData[c])
+                memset(outputChannelData[c], 0, n * sizeof(float));
+
+        remaining.store((int)parts.size(), std::memory_order_relaxed);
+        auto r = round.load(std::memory_order_relaxed) + 1;
+        round.store(r, std::memory_order_release);
+
+        if (parts.size() > 1)
+            sleepCV.notify_all();
+
+        renderPart(0, r);
+
+        for (int spins = 0; remaining.load(std::memory_order_acquire) > 0; ++spins)
+        {
+            if (spins >= spinsBeforeSteal)
+                for (int i = 1; i < (int)parts.size(); ++i)
+                    renderPart(i, r);
+
+            std::this_thread::yield();
+        }
+    }
+
+    void audioDeviceStopped() override {}
+    void audioDeviceAboutToStart(juce::AudioIODevice *device) override
+    {
+        scratch.resize(2 * (size_t)device->getCurrentBufferSizeSamples() * parts.size());
+
+        for (auto &p : parts)
+            p->engine->audioDeviceAboutToStart(device);
+    }
+};
+
+/*
+ * Streaming. Rather than drive an audio device, render on a thread of our own and write
+ * interleaved stereo to stdout, a file or named pipe, or a UDP socket, either as raw frames or
+ * as RTP (L24, as RFC 3190 describes, which is what AES67 style receivers expect). Unless the
+ * sink is left to pace us by blocking, the render thread keeps to the sample clock.
+ */
+struct StreamSink
+{
+    virtual ~StreamSink() = default;
+    // false once the far end has gone away
+    virtual bool write(const uint8_t *data, size_t bytes) = 0;
+};
+
+struct FileStreamSink : StreamSink
+{
+    FILE *f{nullptr};
+    bool ownsFile{false};
+
+    explicit FileStreamSink(const std::string &path)
+    {
+        if (path == "-")
+        {
+            f = stdout;
+#if WINDOWS
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        }
+        else
+        {
+            // a named pipe blocks here until a reader opens it
+            f = fopen(path.c_str(), "wb");
+            ownsFile = true;
+        }
+    }
+    ~FileStreamSink() override
+    {
+        if (f && ownsFile)
+            fclose(f);
+    }
+
+    bool write(const uint8_t *data, size_t bytes) override
+    {
+        if (!f || fwrite(data, 1, bytes, f) != bytes)
+            return false;
+
+        return fflush(f) == 0;
+    }
+};
+
+struct UDPStreamSink : StreamSink
+{
+    juce::DatagramSocket socket;
+    juce::String host;
+    int port{0};
+
+    // RTP adds a header per packet and counts its timestamp in frames
+    bool rtp{false};
+    int bytesPerFrame{0};
+    uint16_t sequence{0};
+    uint32_t timestamp{0}, ssrc{0};
+    std::vector<uint8_t> packet;
+
+    // keep packets (and RTP's 1ms AES67 packet time at 48k) inside one ethernet frame
+    static constexpr size_t maxPayload{1152};
+
+    UDPStreamSink(const juce::String &h, int p, bool isRTP, int bpf)
+        : host(h), port(p), rtp(isRTP), bytesPerFrame(bpf)
+    {
+        ssrc = (uint32_t)juce::Random::getSystemRandom().nextInt();
+        sequence = (uint16_t)juce::Random::getSystemRandom().nextInt();
+    }
+
+    bool write(const uint8_t *data, size_t bytes) override
+    {
+        auto framesPerPacket = std::max<size_t>(1, maxPayload / bytesPerFrame);
+
+        while (bytes > 0)
+        {
+            auto chunk = std::min(bytes, framesPerPacket * bytesPerFrame);
+
+            packet.clear();
+
+            if (rtp)
+            {
+                uint8_t hdr[12] = {0x80, 96, // v2, dynamic payload type
+                                   (uint8_t)(sequence >> 8), (uint8_t)sequence,
+                                   (uint8_t)(timestamp >> 24), (uint8_t)(timestamp >> 16),
+                                   (uint8_t)(timestamp >> 8), (uint8_t)timestamp,
+                                   (uint8_t)(ssrc >> 24), (uint8_t)(ssrc >> 16),
+                                   (uint8_t)(ssrc >> 8), (uint8_t)ssrc};
+                packet.insert(packet.end(), hdr, hdr + sizeof(hdr));
+
+                sequence++;
+                timestamp += (uint32_t)(chunk / bytesPerFrame);
+            }
+
+            packet.insert(packet.end(), data, data + chunk);
+
+            if (socket.write(host, port, packet.data(), (int)packet.size()) < 0)
+                return false;
+
+            data += chunk;
+            bytes -= chunk;
+        }
+
+        return true;
+    }
+};
+
+enum class StreamFormat
+{
+    Float32LE,
+    Int24LE,
+    Int24BE, // RTP L24 is network order
+};
+
+struct StreamSettings
+{
+    std::string sink;
+    StreamFormat format{StreamFormat::Float32LE};
+    double sampleRate{48000};
+    int bufferFrames{256};
+    bool paced{true};
+};
+
+std::unique_ptr<StreamSink> makeStreamSink(StreamSettings &settings, std::string &err)
+{
+    auto &s = settings.sink;
+
+    for (auto scheme : {"udp://", "rtp://"})
+    {
+        if (s.rfind(scheme, 0) != 0)
+            continue;
+
+        auto hp = s.substr(strlen(scheme));
+        auto colon = hp.rfind(':');
+        auto port = colon == std::string::npos ? 0 : std::atoi(hp.substr(colon + 1).c_str());
+
+        if (port <= 0 || port > 65535)
+        {
+            err = "Stream sink " + s + " needs a host:port";
+            return nullptr;
+        }
+
+        bool rtp = scheme[0] == 'r';
+        if (rtp)
+            settings.format = StreamFormat::Int24BE;
+
+        int bpf = settings.format == StreamFormat::Float32LE ? 8 : 6;
+        return std::make_unique<UDPStreamSink>(hp.substr(0, colon), port, rtp, bpf);
+    }
+
+    auto res = std::make_unique<FileStreamSink>(s);
+    if (!res->f)
+    {
+        err = "Unable to open stream sink " + s;
+        return nullptr;
+    }
+    return res;
+}
+
+void runStream(SurgePlayback &engine, StreamSink &sink, const StreamSettings &settings,
+               std::atomic<bool> &running)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto n = settings.bufferFrames;
+    std::vector<float> L(n), R(n);
+    std::vector<uint8_t> out(n * 8);
+
+    auto period = std::chrono::duration<double>(n / settings.sampleRate);
+    auto next = clock::now();
+
+    while (running)
+    {
+        engine.render(L.data(), R.data(), n);
+
+        size_t bytes = 0;
+        switch (settings.format)
+        {
+        case StreamFormat::Float32LE:
+            for (int i = 0; i < n; ++i)
+            {
+                memcpy(&out[bytes], &L[i], 4);
+                memcpy(&out[bytes + 4], &R[i], 4);
+                bytes += 8;
+            }
+            break;
+        case StreamFormat::Int24LE:
+        case StreamFormat::Int24BE:
+        {
+            bool be = settings.format == StreamFormat::Int24BE;
+            for (int i = 0; i < n; ++i)
+            {
+                for (auto v : {L[i], R[i]})
+                {
+                    auto q = (int32_t)std::lround(std::clamp(v, -1.f, 1.f) * 8388607.f);
+                    uint8_t b0 = q & 0xFF, b1 = (q >> 8) & 0xFF, b2 = (q >> 16) & 0xFF;
+                    out[bytes++] = be ? b2 : b0;
+                    out[bytes++] = b1;
+                    out[bytes++] = be ? b0 : b2;
+                }
+            }
+            break;
+        }
+        }
+
+        if (!sink.write(out.data(), bytes))
+        {
+            LOG(BASIC, "Stream sink closed");
+            running = false;
+            break;
+        }
+
+        if (settings.paced)
+        {
+            next += std::chrono::duration_cast<clock::duration>(period);
+            auto now = clock::now();
+
+            // if we fell more than a second behind, start the clock again rather than race
+            if (now - next > std::chrono::seconds(1))
+            {
+                LOG(BASIC, "Stream fell behind the clock; resynchronizing");
+                next = now;
+            }
+
+            std::this_thread::sleep_until(next);
+        }
+    }
+}
+
+/*
+ * Offline rendering. Each job plays a MIDI file through its own engine as fast as it can and
+ * writes a WAV, with no audio or MIDI device involved, so several jobs can run side by side
+ * on their own threads. Events land on their own sample within the block, as in the plugin.
+ */
+struct OfflineRenderJob
+{
+    std::string midiFile, patch, outFile;
+    // if set, the engine trace for this render is written here; see --trace
+    std::string traceFile;
+};
+
+struct OfflineRenderSettings
+{
+    double sampleRate{48000};
+    float tailSeconds{2.f};
+    int bitDepth{24};
+    // seeded renders are bitwise repeatable; see SurgeSynthesizer::setRandomSeed
+    bool seeded{false};
+    uint64_t seed{0};
+};
+
+// construction reads user defaults and the shared storage caches, so do one at a time
+static std::mutex offlineConstructionMutex;
+
+// how long we let a patch's wavetables land before we give up waiting on them
+static constexpr int offlineLoadWaitMs = 10000;
+
+// every track of a standard MIDI file, merged and timestamped in seconds
+static bool readMidiSequence(juce::InputStream &in, juce::MidiMessageSequence &seq)
+{
+    juce::MidiFile midiFile;
+
+    if (!midiFile.readFrom(in))
+        return false;
+
+    midiFile.convertTimestampTicksToSeconds();
+
+    for (int t = 0; t < midiFile.getNumTracks(); ++t)
+        seq.addSequence(*midiFile.getTrack(t), 0.0);
+
+    return true;
+}
+
+/*
+ * Render seq through an engine of its own and write it to out as a WAV. loadPatch, if given,
+ * is called once the engine is set up and returns false, filling in err, if it can't load.
+ */
+typedef std::function<bool(SurgeSynthesizer &, std::string &)> OfflinePatchLoader;
+
+static bool renderSequenceOffline(const juce::MidiMessageSequence &seq,
+                                  const OfflinePatchLoader &loadPatch,
+                                  const OfflineRenderSettings &settings,
+                                  std::unique_ptr<juce::OutputStream> out,
+                                  const std::string &traceFile, std::string &err)
+{
+    std::unique_ptr<SurgeSynthProcessor> proc;
+    {
+        std::lock_guard<std::mutex> g(offlineConstructionMutex);
+        proc = makeProcessor();
+    }
+
+    auto &surge = proc->surge;
+    auto sr = settings.sampleRate;
+
+    surge->setSamplerate(sr);
+    surge->storage.renderingOffline = true;
+
+    if (!traceFile.empty())
+        surge->traceRecorder.setEnabled(true);
+
+    if (settings.seeded)
+        surge->setRandomSeed(settings.seed);
+
+    if (loadPatch && !loadPatch(*surge, err))
+        return false;
+
+    // run silence until anything the patch queued in the background has landed
+    surge->audio_processing_active = true;
+
+    for (int waited = 0; surge->storage.wavetableLoader &&
+                         surge->storage.wavetableLoader->hasOutstandingLoads() &&
+                         waited < offlineLoadWaitMs;
+         ++waited)
+    {
+        surge->process();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    if (out)
+        writer.reset(wav.createWriterFor(out.get(), sr, 2, settings.bitDepth, {}, 0));
+
+    if (!writer)
+    {
+        err = "Unable to write the WAV";
+        return false;
+    }
+
+    // the writer owns the stream now
+    out.release();
+
+    auto totalSamples = (int64_t)std::ceil((seq.getEndTime() + settings.tailSeconds) * sr);
+
+    static constexpr int chunkBlocks = 64;
+    juce::AudioBuffer<float> chunk(2, chunkBlocks * BLOCK_SIZE);
+    int chunkPos = 0;
+
+    int ev = 0, nev = seq.getNumEvents();
+
+    for (int64_t pos = 0; pos < totalSamples; pos += BLOCK_SIZE)
     {
-        engine->proc->surge->loadPatchByPath(initPatch.c_str(), -1, "Loaded Patch");
+        while (ev < nev)
+        {
+            auto &m = seq.getEventPointer(ev)->message;
+            auto at = (int64_t)(m.getTimeStamp() * sr);
+
+            if (at >= pos + BLOCK_SIZE)
+                break;
+
+            if (!m.isMetaEvent())
+            {
+                surge->eventOffsetInBlock = (int)std::clamp<int64_t>(at - pos, 0, BLOCK_SIZE - 1);
+                proc->applyMidi(m);
+            }
+
+            ev++;
+        }
+
+        surge->eventOffsetInBlock = 0;
+        surge->process();
+
+        auto n = (int)std::min<int64_t>(BLOCK_SIZE, totalSamples - pos);
+        chunk.copyFrom(0, chunkPos, surge->output[0], n);
+        chunk.copyFrom(1, chunkPos, surge->output[1], n);
+        chunkPos += n;
+
+        if (chunkPos == chunk.getNumSamples() || pos + BLOCK_SIZE >= totalSamples)
+        {
+            writer->writeFromAudioSampleBuffer(chunk, 0, chunkPos);
+            chunkPos = 0;
+        }
+    }
+
+    if (!traceFile.empty() && !surge->traceRecorder.writeChromeTrace(traceFile))
+    {
+        err = "Unable to write trace " + traceFile;
+        return false;
+    }
+
+    return true;
+}
+
+bool renderMidiFileOffline(const OfflineRenderJob &job, const OfflineRenderSettings &settings,
+                           std::string &err)
+{
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+
+    juce::FileInputStream fis(cwd.getChildFile(job.midiFile));
+    juce::MidiMessageSequence seq;
+
+    if (!fis.openedOk() || !readMidiSequence(fis, seq))
+    {
+        err = "Unable to read MIDI file " + job.midiFile;
+        return false;
+    }
+
+    OfflinePatchLoader loadPatch;
+    if (!job.patch.empty())
+    {
+        loadPatch = [&job](SurgeSynthesizer &surge, std::string &e) {
+            if (surge.loadPatchByPath(job.patch.c_str(), -1, "Offline Render"))
+                return true;
+
+            e = "Unable to load patch " + job.patch;
+            return false;
+        };
+    }
+
+    auto outFile = cwd.getChildFile(job.outFile);
+    outFile.deleteFile();
+
+    std::unique_ptr<juce::OutputStream> fos = outFile.createOutputStream();
+    if (!fos)
+    {
+        err = "Unable to write " + job.outFile;
+        return false;
+    }
+
+    return renderSequenceOffline(seq, loadPatch, settings, std::move(fos), job.traceFile, err);
+}
+
+/*
+ * --trace for the live modes. There is no clean way out of those, so the trace is written
+ * when we are told to stop (and, on posix, on SIGUSR1 without stopping). The signal handler
+ * only raises a flag; a watcher thread does the writing.
+ */
+static std::atomic<int> traceSignal{0};
+
+static void traceSignalHandler(int sig) { traceSignal.store(sig); }
+
+static void writeEngineTrace(const std::string &path,
+                             const std::vector<const Surge::Profiling::TraceRecorder *> &rs)
+{
+    if (Surge::Profiling::TraceRecorder::writeChromeTrace(path, rs))
+    {
+        LOG(BASIC, "Wrote engine trace  : [" << path << "]");
+    }
+    else
+    {
+        PRINTERR("Unable to write trace " << path);
+    }
+}
+
+static bool startLateBlockLog(SurgeSynthesizer &surge, const std::string &path, float threshold)
+{
+    surge.deadlineMonitor.setThreshold(threshold);
+
+    if (!surge.deadlineMonitor.setLogFile(path))
+    {
+        PRINTERR("Unable to open late block log " << path);
+        return false;
+    }
+
+    // so the log can name the costliest part of each late block
+    surge.blockProfiler.setEnabled(true);
+    LOG(BASIC, "Logging late blocks : [" << path << "] over " << threshold << " of the deadline");
+    return true;
+}
+
+static void startTraceWatcher(const std::string &path,
+                              std::vector<const Surge::Profiling::TraceRecorder *> rs)
+{
+    std::signal(SIGINT, traceSignalHandler);
+    std::signal(SIGTERM, traceSignalHandler);
+#if !WINDOWS
+    std::signal(SIGUSR1, traceSignalHandler);
+#endif
+
+    std::thread([path, rs]() {
+        while (true)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            auto sig = traceSignal.exchange(0);
+            if (sig == 0)
+                continue;
+
+            writeEngineTrace(path, rs);
+
+#if !WINDOWS
+            if (sig == SIGUSR1)
+                continue;
+#endif
+            // what the default handler would have done, now that the trace is out
+            std::_Exit(128 + sig);
+        }
+    }).detach();
+}
+
+int renderOffline(const std::vector<OfflineRenderJob> &jobs, const OfflineRenderSettings &settings,
+                  int nThreads)
+{
+    std::atomic<int> next{0}, failed{0};
+
+    auto worker = [&]() {
+        for (int j = next++; j < (int)jobs.size(); j = next++)
+        {
+            auto &job = jobs[j];
+            auto start = std::chrono::steady_clock::now();
+            std::string err;
+
+            if (renderMidiFileOffline(job, settings, err))
+            {
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+                LOG(BASIC, "Rendered            : [" << job.midiFile << "] to [" << job.outFile
+                                                     << "] in " << ms << "ms");
+            }
+            else
+            {
+                PRINTERR(err);
+                failed++;
+            }
+        }
+    };
+
+    nThreads = std::clamp(nThreads, 1, (int)jobs.size());
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < nThreads; ++i)
+        threads.emplace_back(worker);
+
+    worker();
+
+    for (auto &t : threads)
+        t.join();
+
+    return failed;
+}
+
+/*
+ * Render nodes. --render-server listens on a TCP port and renders jobs sent to it, and
+ * --render-midi with --render-nodes hands its jobs out to a list of servers rather than render
+ * them here. With --seed a job renders to the same bits on whichever node takes it.
+ *
+ * Every message is a little endian uint32 byte count and then that many bytes. A request is
+ *   "SXRJ", uint32 version, double sample rate, float tail seconds, int32 bit depth,
+ *   uint8 seeded, uint64 seed, then the patch (an .fxp, or nothing) and the MIDI file
+ * and a reply is
+ *   "SXRR", uint8 ok, then the WAV, or why it failed as text
+ * with each byte string sent as a uint32 size and the bytes. A connection carries any number
+ * of requests, one at a time.
+ *
+ * There is no authentication, and a patch can carry Lua, so a server only listens on the
+ * loopback interface unless --render-server-bind says otherwise. It takes at most
+ * renderServerMaxConnections at once, drops one which sits idle for renderServerIdleTimeoutMs
+ * and won't take a request bigger than a patch, with its wavetables and samples, and a MIDI
+ * file can reasonably be. Replies are the coordinator's to bound, and a long WAV is big.
+ */
+static constexpr uint32_t renderNodeVersion{1};
+static constexpr uint32_t renderNodeMaxRequest{64u << 20};
+static constexpr uint32_t renderNodeMaxReply{1u << 30};
+static constexpr int renderNodeReplyTimeoutMs{10 * 60 * 1000};
+static constexpr int renderNodeConnectTimeoutMs{5000};
+static constexpr int renderServerMaxConnections{32};
+static constexpr int renderServerIdleTimeoutMs{5 * 60 * 1000};
+
+struct RenderNodeRequest
+{
+    juce::MemoryBlock patch, midi;
+    OfflineRenderSettings settings;
+};
+
+static bool sendRenderNodeMessage(juce::StreamingSocket &s, const juce::MemoryBlock &m)
+{
+    auto n = juce::ByteOrder::swapIfBigEndian((uint32_t)m.getSize());
+    return s.write(&n, 4) == 4 && s.write(m.getData(), (int)m.getSize()) == (int)m.getSize();
+}
+
+static bool receiveRenderNodeMessage(juce::StreamingSocket &s, juce::MemoryBlock &m,
+                                     int timeoutMs, uint32_t maxBytes)
+{
+    uint32_t n{0};
+    if (s.waitUntilReady(true, timeoutMs) != 1 || s.read(&n, 4, true) != 4)
+        return false;
+
+    n = juce::ByteOrder::swapIfBigEndian(n);
+    if (n > maxBytes)
+        return false;
+
+    m.setSize(n);
+    return n == 0 || s.read(m.getData(), (int)n, true) == (int)n;
+}
+
+static void writeRenderNodeBytes(juce::MemoryOutputStream &o, const void *d, size_t n)
+{
+    o.writeInt((int)n);
+    o.write(d, n);
+}
+
+static bool readRenderNodeBytes(juce::MemoryInputStream &i, juce::MemoryBlock &m)
+{
+    auto n = (uint32_t)i.readInt();
+    if (n > i.getNumBytesRemaining())
+        return false;
+
+    m.setSize(n);
+    return i.read(m.getData(), (int)n) == (int)n;
+}
+
+static juce::MemoryBlock encodeRenderNodeRequest(const RenderNodeRequest &r)
+{
+    juce::MemoryOutputStream o;
+    o.write("SXRJ", 4);
+    o.writeInt((int)renderNodeVersion);
+    o.writeDouble(r.settings.sampleRate);
+    o.writeFloat(r.settings.tailSeconds);
+    o.writeInt(r.settings.bitDepth);
+    o.writeByte(r.settings.seeded ? 1 : 0);
+    o.writeInt64((juce::int64)r.settings.seed);
+    writeRenderNodeBytes(o, r.patch.getData(), r.patch.getSize());
+    writeRenderNodeBytes(o, r.midi.getData(), r.midi.getSize());
+    return o.getMemoryBlock();
+}
+
+static bool decodeRenderNodeRequest(const juce::MemoryBlock &m, RenderNodeRequest &r,
+                                    std::string &err)
+{
+    juce::MemoryInputStream i(m, false);
+    char magic[4]{};
+
+    if (i.read(magic, 4) != 4 || memcmp(magic, "SXRJ", 4) != 0)
+    {
+        err = "Not a render request";
+        return false;
+    }
+
+    if (auto v = (uint32_t)i.readInt(); v != renderNodeVersion)
+    {
+        err = "Render request version " + std::to_string(v) + "; this node speaks " +
+              std::to_string(renderNodeVersion);
+        return false;
+    }
+
+    r.settings.sampleRate = i.readDouble();
+    r.settings.tailSeconds = std::max(0.f, i.readFloat());
+    r.settings.bitDepth = i.readInt();
+    r.settings.seeded = i.readByte() != 0;
+    r.settings.seed = (uint64_t)i.readInt64();
+
+    if (!readRenderNodeBytes(i, r.patch) || !readRenderNodeBytes(i, r.midi))
+    {
+        err = "Truncated render request";
+        return false;
+    }
+
+    auto bd = r.settings.bitDepth;
+    if (r.settings.sampleRate < 8000 || r.settings.sampleRate > 768000 ||
+        (bd != 16 && bd != 24 && bd != 32))
+    {
+        err = "Render request has an unusable sample rate or bit depth";
+        return false;
+    }
+
+    return true;
+}
+
+static juce::MemoryBlock encodeRenderNodeReply(bool ok, const void *d, size_t n)
+{
+    juce::MemoryOutputStream o;
+    o.write("SXRR", 4);
+    o.writeByte(ok ? 1 : 0);
+    writeRenderNodeBytes(o, d, n);
+    return o.getMemoryBlock();
+}
+
+// the patch chunk of an .fxp held in memory; loadPatchByPath does the same from a file
+static bool loadPatchFromFXP(SurgeSynthesizer &surge, const juce::MemoryBlock &fxp,
+                             std::string &err)
+{
+    static constexpr size_t headerSize = 60, chunkSizeAt = 56;
+    auto d = (const uint8_t *)fxp.getData();
+
+    if (fxp.getSize() < headerSize || memcmp(d, "CcnK", 4) != 0 ||
+        memcmp(d + 8, "FPCh", 4) != 0 || memcmp(d + 16, "cjs3", 4) != 0)
+    {
+        err = "The patch is not a Surge XT .fxp";
+        return false;
+    }
+
+    auto cs = (size_t)juce::ByteOrder::bigEndianInt(d + chunkSizeAt);
+    if (cs > fxp.getSize() - headerSize)
+    {
+        err = "The patch is truncated";
+        return false;
+    }
+
+    return surge.loadPatchFromChunk(d + headerSize, (int)cs, -1, "Offline Render", true);
+}
+
+struct RenderServer
+{
+    // renders at once; further requests wait for a slot
+    int slots{1};
+    std::mutex slotMutex;
+    std::condition_variable slotFree;
+
+    // connections being served, which the accept loop keeps below renderServerMaxConnections
+    std::atomic<int> connections{0};
+
+    void serve(std::unique_ptr<juce::StreamingSocket> conn)
+    {
+        auto peer = conn->getHostName().toStdString();
+        juce::MemoryBlock m;
+
+        while (receiveRenderNodeMessage(*conn, m, renderServerIdleTimeoutMs, renderNodeMaxRequest))
+        {
+            auto start = std::chrono::steady_clock::now();
+            RenderNodeRequest req;
+            std::string err;
+            juce::MemoryBlock wav;
+            bool ok = decodeRenderNodeRequest(m, req, err);
+
+            if (ok)
+            {
+                juce::MidiMessageSequence seq;
+                juce::MemoryInputStream mis(req.midi, false);
+
+                OfflinePatchLoader loadPatch;
+                if (req.patch.getSize() > 0)
+                    loadPatch = [&req](SurgeSynthesizer &surge, std::string &e) {
+                        return loadPatchFromFXP(surge, req.patch, e);
+                    };
+
+                if (!readMidiSequence(mis, seq))
+                {
+                    err = "Unable to read the MIDI file";
+                    ok = false;
+                }
+                else
+                {
+                    {
+                        std::unique_lock<std::mutex> g(slotMutex);
+                        slotFree.wait(g, [this]() { return slots > 0; });
+                        slots--;
+                    }
+
+                    auto out = std::make_unique<juce::MemoryOutputStream>(wav, false);
+                    ok = renderSequenceOffline(seq, loadPatch, req.settings, std::move(out), {},
+                                               err);
+
+                    {
+                        std::lock_guard<std::mutex> g(slotMutex);
+                        slots++;
+                    }
+                    slotFree.notify_one();
+                }
+            }
+
+            auto reply = ok ? encodeRenderNodeReply(true, wav.getData(), wav.getSize())
+                            : encodeRenderNodeReply(false, err.data(), err.size());
+
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+            if (ok)
+            {
+                LOG(BASIC, "Rendered for        : [" << peer << "] " << wav.getSize()
+                                                     << " bytes in " << ms << "ms");
+            }
+            else
+            {
+                LOG(BASIC, "Failed a render for : [" << peer << "] " << err);
+            }
+
+            if (!sendRenderNodeMessage(*conn, reply))
+                break;
+        }
+    }
+};
+
+int runRenderServer(int port, const std::string &bindAddress, int nSlots)
+{
+    juce::StreamingSocket listener;
+
+    if (!listener.createListener(port, bindAddress))
+    {
+        PRINTERR("Unable to listen for render jobs on " << bindAddress << " port " << port);
+        return 2;
+    }
+
+    LOG(BASIC, "Render server       : " << bindAddress << " port " << port << ", " << nSlots
+                                         << " renders at once");
+
+    if (bindAddress != "127.0.0.1" && bindAddress != "localhost" && bindAddress != "::1")
+    {
+        LOG(BASIC, "Render server       : anyone who can reach this address can run patches, "
+                   "and their Lua, here");
+    }
+
+    RenderServer server;
+    server.slots = std::max(1, nSlots);
+
+    while (true)
+    {
+        std::unique_ptr<juce::StreamingSocket> conn(listener.waitForNextConnection());
+
+        if (!conn)
+            continue;
+
+        if (server.connections >= renderServerMaxConnections)
+        {
+            LOG(BASIC, "Refused a connection: [" << conn->getHostName()
+                                                 << "] already serving the most we take");
+            continue;
+        }
+
+        server.connections++;
+        std::thread([&server, c = std::move(conn)]() mutable {
+            server.serve(std::move(c));
+            server.connections--;
+        }).detach();
+    }
+}
+
+/*
+ * The coordinator end. Each node gets connectionsPerNode workers, each with a connection of
+ * its own, taking jobs from one shared queue. A job whose node fails to answer goes back on the
+ * queue for any node to take, up to renderNodeAttempts times. A node which fails
+ * renderNodeStrikes jobs running is left out from then on. A node which answers that the render
+ * failed (a bad patch, say) is believed; that would fail on any node.
+ */
+static constexpr int renderNodeAttempts{3}, renderNodeStrikes{3};
+
+int renderOnNodes(const std::vector<OfflineRenderJob> &jobs, const OfflineRenderSettings &settings,
+                  const std::vector<std::string> &nodes, int connectionsPerNode)
+{
+    std::mutex qMutex;
+    std::condition_variable qChanged;
+    std::deque<std::pair<int, int>> queue; // job and attempts so far
+    int remaining{(int)jobs.size()}, liveWorkers{0}, failed{0};
+
+    for (int j = 0; j < (int)jobs.size(); ++j)
+        queue.emplace_back(j, 0);
+
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+
+    auto finish = [&](bool ok) {
+        std::lock_guard<std::mutex> g(qMutex);
+        if (!ok)
+            failed++;
+        remaining--;
+        qChanged.notify_all();
+    };
+
+    auto worker = [&](const std::string &node) {
+        auto colon = node.rfind(':');
+        auto host = node.substr(0, colon);
+        auto port = colon == std::string::npos ? 0 : std::atoi(node.substr(colon + 1).c_str());
+
+        std::unique_ptr<juce::StreamingSocket> sock;
+        int strikes{0};
+
+        while (port > 0 && strikes < renderNodeStrikes)
+        {
+            std::pair<int, int> item;
+            {
+                std::unique_lock<std::mutex> g(qMutex);
+                qChanged.wait(g, [&]() { return !queue.empty() || remaining == 0; });
+                if (remaining == 0)
+                    break;
+                item = queue.front();
+                queue.pop_front();
+            }
+
+            auto &job = jobs[item.first];
+            RenderNodeRequest req;
+            req.settings = settings;
+
+            if (!cwd.getChildFile(job.midiFile).loadFileAsData(req.midi) ||
+                (!job.patch.empty() && !cwd.getChildFile(job.patch).loadFileAsData(req.patch)))
+            {
+                PRINTERR("Unable to read " << job.midiFile << " or its patch");
+                finish(false);
+                continue;
+            }
+
+            if (!sock)
+            {
+                sock = std::make_unique<juce::StreamingSocket>();
+                if (!sock->connect(host, port, renderNodeConnectTimeoutMs))
+                    sock.reset();
+            }
+
+            juce::MemoryBlock m;
+            bool answered = sock && sendRenderNodeMessage(*sock, encodeRenderNodeRequest(req)) &&
+                            receiveRenderNodeMessage(*sock, m, renderNodeReplyTimeoutMs,
+                                                     renderNodeMaxReply);
+
+            juce::MemoryInputStream reply(m, false);
+            char magic[4]{};
+            juce::MemoryBlock body;
+            bool ok{false};
+
+            answered = answered && reply.read(magic, 4) == 4 && memcmp(magic, "SXRR", 4) == 0;
+            if (answered)
+            {
+                ok = reply.readByte() != 0;
+                answered = readRenderNodeBytes(reply, body);
+            }
+
+            if (!answered)
+            {
+                sock.reset();
+                strikes++;
+                LOG(BASIC, "Render node         : [" << node << "] did not answer for ["
+                                                     << job.midiFile << "]");
+
+                std::lock_guard<std::mutex> g(qMutex);
+                if (item.second + 1 < renderNodeAttempts)
+                {
+                    queue.emplace_back(item.first, item.second + 1);
+                }
+                else
+                {
+                    PRINTERR("Giving up on " << job.midiFile << " after " << renderNodeAttempts
+                                             << " attempts");
+                    failed++;
+                    remaining--;
+                }
+                qChanged.notify_all();
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(250 * strikes));
+                continue;
+            }
+
+            strikes = 0;
+
+            if (!ok)
+            {
+                PRINTERR(node << " failed to render " << job.midiFile << ": "
+                              << body.toString().toStdString());
+                finish(false);
+                continue;
+            }
+
+            auto outFile = cwd.getChildFile(job.outFile);
+            if (!outFile.replaceWithData(body.getData(), body.getSize()))
+            {
+                PRINTERR("Unable to write " << job.outFile);
+                finish(false);
+                continue;
+            }
+
+            LOG(BASIC, "Rendered            : [" << job.midiFile << "] to [" << job.outFile
+                                                 << "] on [" << node << "]");
+            finish(true);
+        }
+
+        if (port <= 0)
+        {
+            PRINTERR("Render node " << node << " needs a host:port");
+        }
+        else if (strikes >= renderNodeStrikes)
+        {
+            PRINTERR("Leaving out render node " << node);
+        }
+
+        // with nobody left to take them, whatever is still queued has failed
+        std::lock_guard<std::mutex> g(qMutex);
+        if (--liveWorkers == 0 && remaining > 0)
+        {
+            failed += remaining;
+            remaining = 0;
+            queue.clear();
+            qChanged.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    liveWorkers = (int)nodes.size() * std::max(1, connectionsPerNode);
+
+    for (auto &n : nodes)
+        for (int i = 0; i < std::max(1, connectionsPerNode); ++i)
+            threads.emplace_back(worker, n);
+
+    for (auto &t : threads)
+        t.join();
+
+    return failed;
+}
+
+int main(int argc, char **argv)
+{
+    // juce::ConsoleApplication is just such a mess.
+    CLI::App app("surge-xt-CLI : a command line player for surge-xt");
+
+    app.set_version_flag("--version", Surge::Build::FullVersionStr);
+
+    bool listDevices{false};
+    app.add_flag("-l,--list-devices", listDevices,
+                 "List all devices available on this system, then exit");
+
+    std::string audioInterface{};
+    app.add_flag("-a,--audio-interface", audioInterface,
+                 "Select an audio interface, using index (like '0.2') as shown in list-devices");
+
+    int midiInput{0};
+    app.add_flag("-m,--midi-input", midiInput,
+                 "Select an midi input using the index from list-devices");
+
+    int oscInputPort{0};
+    app.add_flag("--osc-in-port", oscInputPort,
+                 "Port for OSC Input; unspecified means no OSC. OSC drives the first engine");
+
+    int oscOutputPort{0};
+    app.add_flag("--osc-out-port", oscOutputPort,
+                 "Port for OSC Output; unspecified means input only; input required");
+
+    std::string initPatch{};
+    app.add_flag("--init-patch", initPatch, "Choose this file (by path) as the initial patch");
+
+    int engineCount{1};
+    app.add_option("--engines", engineCount,
+                   "Run this many engines (up to 16) on the one device, engine i playing out of "
+                   "channels 2i and 2i+1");
+
+    std::vector<std::string> engineChannels;
+    app.add_option("--engine-channels", engineChannels,
+                   "MIDI channel range per engine, like 1-4, once per engine; by default the 16 "
+                   "channels are shared out evenly");
+
+    std::vector<std::string> enginePatches;
+    app.add_option("--engine-patch", enginePatches,
+                   "Initial patch per engine, once per engine; otherwise every engine loads "
+                   "--init-patch");
+
+    int pinFirstCore{-1};
+    app.add_option("--pin-threads", pinFirstCore,
+                   "Pin the render thread of each engine after the first to its own core, "
+                   "starting at this one (the first engine renders on the device's thread)");
+
+    bool realtimeThreads{false};
+    app.add_flag("--realtime-threads", realtimeThreads,
+                 "Give the engine render threads realtime priority");
+
+    app.add_option("--voices", voiceCapacity,
+                   "Voices per scene each engine allocates, up to " +
+                       std::to_string(MAX_VOICES) + "; by default the voiceCapacity user setting");
+
+    int blockSize{BLOCK_SIZE};
+    app.add_option("--block-size", blockSize,
+                   "Require this internal block size; the engine block size is chosen at build "
+                   "time with SURGE_COMPILE_BLOCK_SIZE, so this checks you are running the right "
+                   "build");
+
+    std::vector<std::string> renderMidi, renderPatch, renderOut;
+    app.add_option("--render-midi", renderMidi,
+                   "Render this MIDI file offline, with no audio device, rather than play live; "
+                   "give it more than once to render several files");
+    app.add_option("--patch", renderPatch,
+                   "Patch for --render-midi, either one for every file or one per file");
+    app.add_option("--out", renderOut, "WAV file to write, one per --render-midi");
+
+    double renderSampleRate{48000};
+    app.add_option("--sample-rate", renderSampleRate,
+                   "Sample rate for --render-midi and --stream");
+
+    float renderTail{2.f};
+    app.add_option("--tail", renderTail,
+                   "Seconds to keep rendering after the last MIDI event for --render-midi");
+
+    int renderBitDepth{24};
+    app.add_option("--bit-depth", renderBitDepth, "16, 24 or 32 (float) bit WAV output");
+
+    int renderJobs{(int)std::max(1u, std::thread::hardware_concurrency())};
+    app.add_option("-j,--jobs", renderJobs, "How many --render-midi files to render at once");
+
+    std::string streamSink;
+    app.add_option("--stream", streamSink,
+                   "Stream interleaved stereo here rather than play through an audio device: "
+                   "'-' for stdout, a file or named pipe, udp://host:port or rtp://host:port");
+
+    std::string streamFormat{"f32"};
+    app.add_option("--stream-format", streamFormat,
+                   "f32 (float little endian) or s24 (24 bit little endian) for --stream; rtp "
+                   "always sends L24");
+
+    int streamBuffer{256};
+    app.add_option("--stream-buffer", streamBuffer, "Frames rendered and written at a time");
+
+    bool streamUnpaced{false};
+    app.add_flag("--stream-unpaced", streamUnpaced,
+                 "Render as fast as the sink takes the audio rather than keeping to the sample "
+                 "clock, for sinks which pace themselves");
+
+    std::string tracePath;
+    app.add_option("--trace", tracePath,
+                   "Record a timeline of the engine (blocks, scenes, voice groups, FX slots) and "
+                   "write it here as Chrome trace JSON, for chrome://tracing or ui.perfetto.dev. "
+                   "Offline renders write one per file; live engines write on exit or SIGUSR1. "
+                   "Only records anything in a build with SURGE_BUILD_WITH_TRACING");
+
+    std::string lateBlockLog;
+    app.add_option("--late-block-log", lateBlockLog,
+                   "Log each block which takes more than --late-block-threshold of its deadline "
+                   "to this file, with what the engine was doing at the time. With several "
+                   "--engines, engine i logs to this file with -i added to its name");
+
+    float lateBlockThreshold{Surge::Profiling::DeadlineMonitor::defaultThreshold};
+    app.add_option("--late-block-threshold", lateBlockThreshold,
+                   "Fraction of the block's deadline beyond which --late-block-log logs it");
+
+    bool memoryReport{false};
+    app.add_flag("--memory-report", memoryReport,
+                 "Print what one engine holds in memory, subsystem by subsystem, with the "
+                 "--init-patch loaded if there is one, and exit");
+
+    int renderServerPort{0};
+    app.add_option("--render-server", renderServerPort,
+                   "Listen on this TCP port and render jobs sent by --render-nodes, --jobs at "
+                   "once, rather than play live");
+
+    std::string renderServerBind{"127.0.0.1"};
+    app.add_option("--render-server-bind", renderServerBind,
+                   "The address --render-server listens on. It defaults to loopback only, since "
+                   "the server has no authentication; use 0.0.0.0 for every interface");
+
+    std::vector<std::string> renderNodes;
+    app.add_option("--render-nodes", renderNodes,
+                   "Send the --render-midi jobs to these --render-server nodes (host:port, give it "
+                   "once per node) rather than render them here, with --jobs connections to each");
+
+    uint64_t renderSeed{0};
+    auto seedOpt =
+        app.add_option("--seed", renderSeed,
+                       "Seed every random source for --render-midi, so the same inputs always "
+                       "render the same output");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (!renderMidi.empty())
+    {
+        if (renderOut.size() != renderMidi.size() ||
+            (renderPatch.size() > 1 && renderPatch.size() != renderMidi.size()))
+        {
+            PRINTERR("Each --render-midi needs an --out, and either one --patch or one per file");
+            exit(7);
+        }
+
+        if (renderBitDepth != 16 && renderBitDepth != 24 && renderBitDepth != 32)
+        {
+            PRINTERR("--bit-depth must be 16, 24 or 32");
+            exit(7);
+        }
+
+        std::vector<OfflineRenderJob> jobs;
+        for (size_t i = 0; i < renderMidi.size(); ++i)
+        {
+            auto patch = renderPatch.empty() ? std::string()
+                                             : renderPatch[renderPatch.size() == 1 ? 0 : i];
+            jobs.push_back({renderMidi[i], patch, renderOut[i], {}});
+
+            if (!tracePath.empty())
+            {
+                // one trace per render; number them if there is more than one
+                auto tf = juce::File::getCurrentWorkingDirectory().getChildFile(tracePath);
+                if (renderMidi.size() > 1)
+                    tf = tf.getSiblingFile(tf.getFileNameWithoutExtension() + "-" +
+                                           juce::String((int)i) + tf.getFileExtension());
+                jobs.back().traceFile = tf.getFullPathName().toStdString();
+            }
+        }
+
+        OfflineRenderSettings settings;
+        settings.sampleRate = renderSampleRate;
+        settings.tailSeconds = std::max(0.f, renderTail);
+        settings.bitDepth = renderBitDepth;
+        settings.seeded = seedOpt->count() > 0;
+        settings.seed = renderSeed;
+
+        juce::ScopedJuceInitialiser_GUI juceInit;
+
+        if (!renderNodes.empty())
+        {
+            if (!tracePath.empty())
+                LOG(BASIC, "--trace is not written for renders on --render-nodes");
+
+            exit(renderOnNodes(jobs, settings, renderNodes, renderJobs) ? 8 : 0);
+        }
+
+        auto failed = renderOffline(jobs, settings, renderJobs);
+
+        exit(failed ? 8 : 0);
+    }
+
+    if (renderServerPort > 0)
+    {
+        juce::ScopedJuceInitialiser_GUI juceInit;
+        exit(runRenderServer(renderServerPort, renderServerBind, renderJobs));
+    }
+
+    if (blockSize != BLOCK_SIZE)
+    {
+        PRINTERR("This build of surge-xt-cli uses a block size of "
+                 << BLOCK_SIZE << " samples, not " << blockSize
+                 << ". Use a build configured with -DSURGE_COMPILE_BLOCK_SIZE=" << blockSize);
+        exit(6);
+    }
+
+    if (listDevices)
+    {
+        listAudioDevices();
+        listMidiDevices();
+        exit(0);
+    }
+
+    if (memoryReport)
+    {
+        auto engine = std::make_unique<SurgePlayback>();
+        auto &surge = *engine->proc->surge;
+        if (!initPatch.empty())
+        {
+            surge.loadPatchByPath(initPatch.c_str(), -1, "Loaded Patch");
+        }
+
+        // queued oscillator and wavetable changes land with the first block
+        surge.process();
+
+        std::cout << surge.getMemoryFootprint().describe();
+        exit(0);
+    }
+
+    if (!streamSink.empty())
+    {
+        if (streamSink == "-")
+            logStream = &std::cerr;
+
+        StreamSettings settings;
+        settings.sink = streamSink;
+        settings.sampleRate = renderSampleRate;
+        settings.bufferFrames = std::max(1, streamBuffer);
+        settings.paced = !streamUnpaced;
+
+        if (streamFormat == "s24")
+            settings.format = StreamFormat::Int24LE;
+        else if (streamFormat != "f32")
+        {
+            PRINTERR("--stream-format must be f32 or s24");
+            exit(7);
+        }
+
+        std::string err;
+        auto sink = makeStreamSink(settings, err);
+        if (!sink)
+        {
+            PRINTERR(err);
+            exit(2);
+        }
+
+        auto engine = std::make_unique<SurgePlayback>();
+        engine->proc->surge->setSamplerate(settings.sampleRate);
+        if (!tracePath.empty())
+        {
+            engine->proc->surge->traceRecorder.setEnabled(true);
+            startTraceWatcher(tracePath, {&engine->proc->surge->traceRecorder});
+        }
+        if (!lateBlockLog.empty() &&
+            !startLateBlockLog(*engine->proc->surge, lateBlockLog, lateBlockThreshold))
+        {
+            exit(2);
+        }
+        if (!initPatch.empty())
+        {
+            engine->proc->surge->loadPatchByPath(initPatch.c_str(), -1, "Loaded Patch");
+        }
+
+        auto *mm = juce::MessageManager::getInstance();
+        mm->setCurrentThreadAsMessageThread();
+
+        // with no sound card there may well be no MIDI either, so MIDI is optional here
+        std::unique_ptr<juce::MidiInput> inp;
+        auto items = juce::MidiInput::getAvailableDevices();
+        if (midiInput >= 0 && midiInput < items.size())
+        {
+            inp = juce::MidiInput::openDevice(items[midiInput].identifier, engine.get());
+            if (inp)
+            {
+                LOG(BASIC, "Opened Midi Input   : [" << items[midiInput].name << "] ");
+                inp->start();
+            }
+        }
+        if (!inp)
+        {
+            LOG(BASIC, "No Midi Input; streaming with OSC control only");
+        }
+
+        if (oscInputPort > 0)
+        {
+            LOG(BASIC, "Starting OSC Input on " << oscInputPort);
+            engine->proc->initOSCIn(oscInputPort);
+            if (oscOutputPort > 0)
+            {
+                LOG(BASIC, "Starting OSC Output on " << oscOutputPort);
+                engine->proc->initOSCOut(oscOutputPort);
+            }
+        }
+
+        LOG(BASIC, "Streaming           : [" << streamSink << "] SampleRate="
+                                             << settings.sampleRate << " Format=" << streamFormat
+                                             << " BlockSize=" << BLOCK_SIZE);
+
+        std::atomic<bool> running{true};
+        std::thread streamThread([&]() {
+            runStream(*engine, *sink, settings, running);
+            mm->stopDispatchLoop();
+        });
+
+        // the message loop serves OSC until the sink goes away
+        mm->runDispatchLoop();
+        running = false;
+        streamThread.join();
+
+        if (!tracePath.empty())
+            writeEngineTrace(tracePath, {&engine->proc->surge->traceRecorder});
+
+        if (inp)
+            inp->stop();
+        juce::MessageManager::deleteInstance();
+        exit(0);
+    }
+
+    /*
+     * This is the default runloop. Basically this main thread acts as the message queue
+     */
+    engineCount = std::clamp(engineCount, 1, 16);
+
+    if (!engineChannels.empty() && (int)engineChannels.size() != engineCount)
+    {
+        PRINTERR("Give --engine-channels once per engine, or not at all");
+        exit(7);
+    }
+
+    std::vector<std::pair<int, int>> channels;
+    for (int i = 0; i < engineCount; ++i)
+    {
+        if (engineChannels.empty())
+        {
+            auto per = 16 / engineCount;
+            channels.emplace_back(i * per, i == engineCount - 1 ? 15 : (i + 1) * per - 1);
+            continue;
+        }
+
+        int lo{0}, hi{0};
+        auto &ec = engineChannels[i];
+        auto dash = ec.find('-');
+        lo = std::atoi(ec.substr(0, dash).c_str());
+        hi = dash == std::string::npos ? lo : std::atoi(ec.substr(dash + 1).c_str());
+
+        if (lo < 1 || hi > 16 || lo > hi)
+        {
+            PRINTERR("--engine-channels takes ranges of MIDI channels 1-16, like 1-4; you gave "
+                     << ec);
+            exit(7);
+        }
+        channels.emplace_back(lo - 1, hi - 1);
+    }
+
+    auto engine = std::make_unique<SurgeRack>(engineCount, channels, pinFirstCore, realtimeThreads);
+
+    if (!tracePath.empty())
+    {
+        std::vector<const Surge::Profiling::TraceRecorder *> rs;
+        for (auto &p : engine->parts)
+        {
+            p->engine->proc->surge->traceRecorder.setEnabled(true);
+            rs.push_back(&p->engine->proc->surge->traceRecorder);
+        }
+        startTraceWatcher(tracePath, rs);
+    }
+
+    for (int i = 0; !lateBlockLog.empty() && i < engineCount; ++i)
+    {
+        auto lf = juce::File::getCurrentWorkingDirectory().getChildFile(lateBlockLog);
+        if (engineCount > 1)
+            lf = lf.getSiblingFile(lf.getFileNameWithoutExtension() + "-" + juce::String(i) +
+                                   lf.getFileExtension());
+
+        if (!startLateBlockLog(*engine->parts[i]->engine->proc->surge,
+                               lf.getFullPathName().toStdString(), lateBlockThreshold))
+        {
+            exit(2);
+        }
+    }
+
+    for (int i = 0; i < engineCount; ++i)
+    {
+        auto &patch = i < (int)enginePatches.size() ? enginePatches[i] : initPatch;
+        if (!patch.empty())
+        {
+            engine->parts[i]->engine->proc->surge->loadPatchByPath(patch.c_str(), -1,
+                                                                   "Loaded Patch");
+        }
+
+        LOG(BASIC, "Engine " << i << "            : MIDI channels " << channels[i].first + 1
+                              << "-" << channels[i].second + 1 << ", outputs " << 2 * i + 1
+                              << "/" << 2 * i + 2);
     }
 
     auto *mm = juce::MessageManager::getInstance();
@@ -281,7 +1900,9 @@ int main(int argc, char **argv)
     }
     LOG(BASIC, "Audio Output        : [" << device->getName() << "]");
 
-    auto res = device->open(0, 3 /* bitset - careful */, 48000, 256);
+    juce::BigInteger outputChannels;
+    outputChannels.setRange(0, 2 * engineCount, true);
+    auto res = device->open(0, outputChannels, 48000, 256);
     if (!res.isEmpty())
     {
         PRINTERR("Unable to open audio device: " << res);
@@ -296,11 +1917,11 @@ int main(int argc, char **argv)
     {
         needsMessageLoop = true;
         LOG(BASIC, "Starting OSC Input on " << oscInputPort);
-        engine->proc->initOSCIn(oscInputPort);
+        engine->parts[0]->engine->proc->initOSCIn(oscInputPort);
         if (oscOutputPort > 0)
         {
             LOG(BASIC, "Starting OSC Output on " << oscOutputPort);
-            engine->proc->initOSCOut(oscOutputPort);
+            engine->parts[0]->engine->proc->initOSCOut(oscOutputPort);
         }
     }
 
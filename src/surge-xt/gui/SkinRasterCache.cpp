@@ -0,0 +1,144 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "SkinRasterCache.h"
+
+#include "fmt/core.h"
+
+SkinRasterCache::SkinRasterCache() = default;
+
+SkinRasterCache::~SkinRasterCache() { pool.removeAllJobs(true, 5000); }
+
+bool SkinRasterCache::request(const key_t &key, std::unique_ptr<juce::Drawable> copy, int width,
+                              int height)
+{
+    auto scale = key.second / 100.f;
+    auto pw = (int)std::ceil(width * scale);
+    auto ph = (int)std::ceil(height * scale);
+
+    if (!copy || pw <= 0 || ph <= 0 || (int64_t)pw * ph > maxPixels)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> g(lock);
+        if (!requested.insert(key).second)
+            return true;
+    }
+
+    // std::function wants a copyable callable, so the drawable travels as a shared_ptr
+    std::shared_ptr<juce::Drawable> drawable{std::move(copy)};
+
+    pool.addJob([this, key, drawable, scale, pw, ph]() {
+        auto img = loadFromDisk(key);
+
+        if (img.isNull())
+        {
+            // Software images so the render is not tied to the message thread's context
+            img = juce::Image(juce::Image::ARGB, pw, ph, true, juce::SoftwareImageType());
+            {
+                juce::Graphics g(img);
+                drawable->draw(g, 1.f, juce::AffineTransform::scale(scale));
+            }
+            storeToDisk(key, img);
+        }
+
+        std::lock_guard<std::mutex> g(lock);
+        if (requested.count(key))
+            ready[key] = img;
+    });
+
+    return true;
+}
+
+juce::Image SkinRasterCache::fetch(const key_t &key)
+{
+    std::lock_guard<std::mutex> g(lock);
+    auto it = ready.find(key);
+
+    if (it == ready.end())
+        return {};
+
+    return it->second;
+}
+
+void SkinRasterCache::dropAllBut(int physicalZoomFactor)
+{
+    std::lock_guard<std::mutex> g(lock);
+
+    auto other = [physicalZoomFactor](const key_t &k) { return k.second != physicalZoomFactor; };
+
+    for (auto it = requested.begin(); it != requested.end();)
+        it = other(*it) ? requested.erase(it) : std::next(it);
+    for (auto it = ready.begin(); it != ready.end();)
+        it = other(it->first) ? ready.erase(it) : std::next(it);
+}
+
+fs::path SkinRasterCache::pathFor(const key_t &key) const
+{
+    return dir / fs::path{fmt::format("{:016x}-{}.png", key.first, key.second)};
+}
+
+juce::Image SkinRasterCache::loadFromDisk(const key_t &key) const
+{
+    if (dir.empty())
+        return {};
+
+    auto f = juce::File(path_to_string(pathFor(key)));
+
+    if (!f.existsAsFile())
+        return {};
+
+    return juce::ImageFileFormat::loadFrom(f);
+}
+
+void SkinRasterCache::storeToDisk(const key_t &key, const juce::Image &img) const
+{
+    if (dir.empty())
+        return;
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+        return;
+
+    // write to the side and rename, so another instance never reads a half written file
+    auto p = pathFor(key);
+    auto tmp = p;
+    tmp += ".tmp";
+
+    {
+        auto f = juce::File(path_to_string(tmp));
+        f.deleteFile();
+        juce::FileOutputStream out(f);
+
+        if (!out.openedOk() || !juce::PNGImageFormat().writeImageToStream(img, out))
+        {
+            out.flush();
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+
+    fs::rename(tmp, p, ec);
+    if (ec)
+        fs::remove(tmp, ec);
+}
@@ -0,0 +1,88 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2023, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#ifndef SURGE_SRC_SURGE_XT_GUI_SKINRASTERCACHE_H
+#define SURGE_SRC_SURGE_XT_GUI_SKINRASTERCACHE_H
+
+#include "juce_gui_basics/juce_gui_basics.h"
+
+#include "filesystem/import.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+
+/*
+ * Pre-rasterized skin images. A vector skin image which is drawn at a physical zoom gets
+ * rendered to a bitmap once, on a background thread, and is drawn from that bitmap from then
+ * on; until the bitmap arrives the image keeps drawing as a vector, so nothing ever waits.
+ *
+ * Entries are keyed by a hash of the image's source bytes and the physical zoom factor. That
+ * covers the skin and the image id at once and means an edited skin simply misses. When a
+ * directory is set the bitmaps are also kept there as PNGs, so opening the same skin at the
+ * same zoom again, in this session or the next, only has to decode them.
+ */
+class SkinRasterCache
+{
+  public:
+    typedef std::pair<uint64_t, int> key_t; // source hash, physical zoom factor
+
+    SkinRasterCache();
+    ~SkinRasterCache();
+
+    void setDirectory(const fs::path &d) { dir = d; }
+
+    /*
+     * Queue a rasterization of the drawable, which the cache takes ownership of and only
+     * touches from its worker. Requests for a key already queued or done are ignored, since
+     * identical sources share one bitmap. Returns false if the key will never have a bitmap.
+     */
+    bool request(const key_t &key, std::unique_ptr<juce::Drawable> copy, int width,
+                 int height);
+
+    // The finished bitmap for a key, or a null image if it isn't ready yet
+    juce::Image fetch(const key_t &key);
+
+    // Forget the bitmaps for every other zoom, after the editor zoom changes
+    void dropAllBut(int physicalZoomFactor);
+
+    // Images larger than this many pixels at their zoom are left to draw as vectors
+    static constexpr int maxPixels{2048 * 2048};
+
+  private:
+    fs::path pathFor(const key_t &key) const;
+    juce::Image loadFromDisk(const key_t &key) const;
+    void storeToDisk(const key_t &key, const juce::Image &img) const;
+
+    fs::path dir;
+    juce::ThreadPool pool{1};
+
+    std::mutex lock;
+    std::set<key_t> requested;
+    std::map<key_t, juce::Image> ready;
+
+    JUCE_DECLARE_NON_COPYABLE(SkinRasterCache);
+};
+
+#endif // SURGE_SRC_SURGE_XT_GUI_SKINRASTERCACHE_H
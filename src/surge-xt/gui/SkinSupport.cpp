@@ -32,6 +32,8 @@
 #include <set>
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <iterator>
 #include "SurgeXTBinary.h"
 #include "RuntimeFont.h"
 
@@ -142,7 +144,10 @@ void SkinDB::rescanForSkins(SurgeStorage *storage)
                         if (fs::is_directory(d))
                         {
                             alldirs.push_back(d);
-                            workStack.push_back(d);
+
+                            // a skin's own image and font folders never hold skins
+                            if (d.path().extension() != ".surge-skin")
+                                workStack.push_back(d);
                         }
                     }
                 }
@@ -204,11 +209,9 @@ void SkinDB::rescanForSkins(SurgeStorage *storage)
     {
         auto x = e.root + e.name + PATH_SEPARATOR + "skin.xml";
 
-        TiXmlDocument doc;
-        // Obviously fix this
-        doc.SetTabSize(4);
+        auto doc = parseXmlFile(string_to_path(x));
 
-        if (!doc.LoadFile(string_to_path(x)))
+        if (doc->Error())
         {
             if (e.rootType == MEMORY)
             {
@@ -222,7 +225,7 @@ void SkinDB::rescanForSkins(SurgeStorage *storage)
             continue;
         }
         e.parseable = true;
-        TiXmlElement *surgeskin = TINYXML_SAFE_TO_ELEMENT(doc.FirstChild("surge-skin"));
+        TiXmlElement *surgeskin = TINYXML_SAFE_TO_ELEMENT(doc->FirstChild("surge-skin"));
         if (!surgeskin)
         {
             e.displayName = e.name + " (no skin element)";
@@ -252,6 +255,39 @@ void SkinDB::rescanForSkins(SurgeStorage *storage)
               });
 }
 
+std::shared_ptr<TiXmlDocument> SkinDB::parseXmlFile(const fs::path &p)
+{
+    std::string contents;
+    {
+        std::ifstream ifs(p, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+    auto key = path_to_string(p);
+    auto h = std::hash<std::string>()(contents);
+    auto cached = parsedXml.find(key);
+
+    if (cached != parsedXml.end() && cached->second.contentHash == h && !contents.empty())
+    {
+        return cached->second.doc;
+    }
+
+    auto doc = std::make_shared<TiXmlDocument>();
+    // Obviously fix this
+    doc->SetTabSize(4);
+
+    if (doc->LoadFile(p))
+    {
+        parsedXml[key] = {h, doc};
+    }
+    else
+    {
+        parsedXml.erase(key);
+    }
+
+    return doc;
+}
+
 // Define the inverse maps
 #include "SkinImageMaps.h"
 
@@ -300,30 +336,30 @@ bool Skin::reloadSkin(std::shared_ptr<SurgeImageStore> bitmapStore)
     Surge::Debug::TimeThisBlock _trs_("Skin::reloadSkin");
 #endif
     // std::cout << "Reloading skin " << _D(name) << std::endl;
-    TiXmlDocument doc;
+    std::shared_ptr<TiXmlDocument> doc;
     if (useInMemorySkin)
     {
         auto memSkin =
             std::string(SurgeXTBinary::memoryskin_xml, SurgeXTBinary::memoryskin_xmlSize);
-        doc.Parse(memSkin.c_str());
+        doc = std::make_shared<TiXmlDocument>();
+        doc->Parse(memSkin.c_str());
     }
     else
     {
-        // Obviously fix this
-        doc.SetTabSize(4);
+        doc = SkinDB::get()->parseXmlFile(string_to_path(resourceName("skin.xml")));
 
-        if (!doc.LoadFile(string_to_path(resourceName("skin.xml"))))
+        if (doc->Error())
         {
             FIXMEERROR << "Unable to load skin.xml resource '" << resourceName("skin.xml") << "'"
                        << std::endl;
             FIXMEERROR << "Unable to parse skin.xml\nError is:\n"
-                       << doc.ErrorDesc() << " at row " << doc.ErrorRow() << ", column "
-                       << doc.ErrorCol() << std::endl;
+                       << doc->ErrorDesc() << " at row " << doc->ErrorRow() << ", column "
+                       << doc->ErrorCol() << std::endl;
             return false;
         }
     }
 
-    TiXmlElement *surgeskin = TINYXML_SAFE_TO_ELEMENT(doc.FirstChild("surge-skin"));
+    TiXmlElement *surgeskin = TINYXML_SAFE_TO_ELEMENT(doc->FirstChild("surge-skin"));
     if (!surgeskin)
     {
         FIXMEERROR << "There is no top level surge-skin node in skin.xml" << std::endl;
@@ -459,6 +495,7 @@ bool Skin::reloadSkin(std::shared_ptr<SurgeImageStore> bitmapStore)
     }
 
     componentClasses.clear();
+    classPropertyTable.clear();
     for (auto gchild = componentclassesxml->FirstChild(); gchild; gchild = gchild->NextSibling())
     {
         auto lkid = TINYXML_SAFE_TO_ELEMENT(gchild);
@@ -1368,6 +1405,48 @@ void Surge::GUI::Skin::Control::copyFromConnector(const Surge::Skin::Connector &
     }
 }
 
+std::optional<std::string>
+Surge::GUI::Skin::classPropertyValue(const std::string &classname,
+                                     Surge::Skin::Component::Properties pkey,
+                                     const std::vector<std::string> &stringNames)
+{
+    auto key = std::make_pair(classname, (int)pkey);
+    auto cached = classPropertyTable.find(key);
+
+    if (cached != classPropertyTable.end())
+        return cached->second;
+
+    /*
+    ** Traverse class hierarchy looking for value
+    */
+    std::optional<std::string> res;
+    auto cl = componentClasses.find(classname);
+
+    while (cl != componentClasses.end() && cl->second && !res)
+    {
+        auto &props = cl->second->allprops;
+
+        for (auto const &k : stringNames)
+        {
+            auto v = props.find(k);
+            if (v != props.end())
+            {
+                res = v->second;
+                break;
+            }
+        }
+
+        auto parent = props.find("parent");
+        if (res || parent == props.end())
+            break;
+
+        cl = componentClasses.find(parent->second);
+    }
+
+    classPropertyTable[key] = res;
+    return res;
+}
+
 void Surge::GUI::Skin::resolveBaseParentOffsets(Skin::Control::ptr_t c)
 {
     if (c->parentResolved)
@@ -26,6 +26,7 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <map>
 #include <unordered_set>
 #include <vector>
 #include <memory>
@@ -57,6 +58,7 @@ class SurgeStorage;
 class SurgeImageStore;
 class SurgeImage;
 class TiXmlElement;
+class TiXmlDocument;
 
 #define FIXMEERROR SkinDB::get()->errorStream
 
@@ -292,36 +294,16 @@ class Skin
         if (!c->defaultComponent.hasProperty(pkey))
             return {};
 
-        auto stringNames = c->defaultComponent.payload->propertyNamesMap[pkey];
-
-        /*
-        ** Traverse class hierarchy looking for value
-        */
+        const auto &stringNames = c->defaultComponent.payload->propertyNamesMap[pkey];
 
         for (auto const &key : stringNames)
-            if (c->allprops.find(key) != c->allprops.end())
-                return c->allprops[key];
-
-        auto cl = componentClasses[c->classname];
-        if (!cl)
-            return {};
-
-        do
         {
-            for (auto const &key : stringNames)
-                if (cl->allprops.find(key) != cl->allprops.end())
-                    return cl->allprops[key];
-
-            if (cl->allprops.find("parent") != cl->allprops.end() &&
-                componentClasses.find(cl->allprops["parent"]) != componentClasses.end())
-            {
-                cl = componentClasses[cl->allprops["parent"]];
-            }
-            else
-                return {};
-        } while (cl);
+            auto v = c->allprops.find(key);
+            if (v != c->allprops.end())
+                return v->second;
+        }
 
-        return {};
+        return classPropertyValue(c->classname, pkey, stringNames);
     }
 
     std::string propertyValue(Skin::Control::ptr_t c, Surge::Skin::Component::Properties key,
@@ -414,6 +396,15 @@ class Skin
     ControlGroup::ptr_t rootControl;
     std::vector<Control::ptr_t> controls;
     std::unordered_map<std::string, ComponentClass::ptr_t> componentClasses;
+
+    /*
+     * What each class resolves a property to through its parent chain, flattened on first
+     * lookup. The class table only changes in reloadSkin, which clears this.
+     */
+    std::map<std::pair<std::string, int>, std::optional<std::string>> classPropertyTable;
+    std::optional<std::string> classPropertyValue(const std::string &classname,
+                                                  Surge::Skin::Component::Properties pkey,
+                                                  const std::vector<std::string> &stringNames);
     std::vector<int> zooms;
     bool recursiveGroupParse(ControlGroup::ptr_t parent, TiXmlElement *groupList,
                              bool topLevel = true);
@@ -493,6 +484,19 @@ class SkinDB : public juce::DeletedAtShutdown
 
     static std::ostringstream errorStream;
 
+    /*
+     * Parsed skin.xml files are kept between reloads and rescans, keyed by path and checked
+     * against a hash of the contents, so an unchanged skin is only parsed once per session.
+     * A failed parse isn't kept; the returned document then carries the error.
+     */
+    struct ParsedXml
+    {
+        size_t contentHash{0};
+        std::shared_ptr<TiXmlDocument> doc;
+    };
+    std::unordered_map<std::string, ParsedXml> parsedXml;
+    std::shared_ptr<TiXmlDocument> parseXmlFile(const fs::path &p);
+
     friend class Skin;
 };
 
@@ -77,6 +77,7 @@
 #include <iomanip>
 #include <sstream>
 #include <stack>
+#include <chrono>
 #include <numeric>
 #include <unordered_map>
 #include <codecvt>
@@ -422,12 +423,7 @@ SurgeGUIEditor::SurgeGUIEditor(SurgeSynthEditor *jEd, SurgeSynthesizer *synth)
     patchSelectorComment = std::make_unique<Surge::Widgets::PatchSelectorCommentTooltip>();
     patchSelectorComment->setVisible(false);
 
-    typeinParamEditor = std::make_unique<Surge::Overlays::TypeinParamEditor>();
-    typeinParamEditor->setVisible(false);
-    typeinParamEditor->setSurgeGUIEditor(this);
-
-    miniEdit = std::make_unique<Surge::Overlays::MiniEdit>();
-    miniEdit->setVisible(false);
+    // typeinParamEditor and miniEdit are made on first use, in their prompt functions
 
     synth->addModulationAPIListener(this);
 
@@ -575,8 +571,15 @@ void SurgeGUIEditor::idle()
         }
     }
 
+    // stay at full rate while the engine is loading or there is no editor to update
+    auto quietSoFar = quietIdles;
+    quietIdles = 0;
+
     if (editor_open && frame && !synth->halt_engine)
     {
+        auto changes = synth->editorChanges.take();
+        bool paramsChanged = changes.has(EditorChangeBus::ch_parameters);
+
         if (lastObservedMidiNoteEventCount != synth->midiNoteEvents)
         {
             lastObservedMidiNoteEventCount = synth->midiNoteEvents;
@@ -894,7 +897,7 @@ void SurgeGUIEditor::idle()
             }
         }
 
-        for (int i = 0; i < n_fx_slots; i++)
+        for (int i = 0; i < n_fx_slots && changes.has(EditorChangeBus::ch_meters); i++)
         {
             assert(i + 1 < Effect::KNumVuSlots);
 
@@ -906,7 +909,7 @@ void SurgeGUIEditor::idle()
             }
         }
 
-        for (int i = 0; i < 8; i++)
+        for (int i = 0; paramsChanged && i < 8; i++)
         {
             if (synth->refresh_ctrl_queue[i] >= 0)
             {
@@ -977,11 +980,20 @@ void SurgeGUIEditor::idle()
 
         std::vector<int> refreshIndices;
 
-        if (synth->refresh_overflow)
+        if (!paramsChanged)
         {
-            refreshIndices.resize(n_total_params);
-            std::iota(std::begin(refreshIndices), std::end(refreshIndices), 0);
-            frame->repaint();
+            // nothing was queued since the last idle
+        }
+        else if (synth->refresh_overflow)
+        {
+            // more changed than the queue holds, so refresh the ranges of parameters they hit
+            for (int j = 0; j < n_total_params; ++j)
+            {
+                if (changes.hasParameterInRange(j, n_total_params))
+                {
+                    refreshIndices.push_back(j);
+                }
+            }
         }
         else
         {
@@ -994,11 +1006,14 @@ void SurgeGUIEditor::idle()
             }
         }
 
-        synth->refresh_overflow = false;
-
-        for (int i = 0; i < 8; ++i)
+        if (paramsChanged)
         {
-            synth->refresh_parameter_queue[i] = -1;
+            synth->refresh_overflow = false;
+
+            for (int i = 0; i < 8; ++i)
+            {
+                synth->refresh_parameter_queue[i] = -1;
+            }
         }
 
         for (auto j : refreshIndices)
@@ -1195,7 +1210,8 @@ void SurgeGUIEditor::idle()
 #endif
         }
 
-        for (int i = 0; i < n_customcontrollers; i++)
+        for (int i = 0; i < n_customcontrollers && changes.has(EditorChangeBus::ch_controllers);
+             i++)
         {
             if (((ControllerModulationSource *)synth->storage.getPatch()
                      .scene[current_scene]
@@ -1209,6 +1225,13 @@ void SurgeGUIEditor::idle()
                         ->get_target01(0));
             }
         }
+
+        bool pending = changes.any() || queue_refresh || synth->refresh_editor ||
+                       firstIdleCountdown > 0 || lfoDisplayRepaintCountdown > 0 ||
+                       patchCountdown >= 0 || !accAnnounceStrings.empty() ||
+                       sendStructureChangeIn > 0 || zoomInvalid || !overlaysForNextIdle.empty() ||
+                       getOverlayIfOpenAs<Surge::Overlays::Oscilloscope>(OSCILLOSCOPE);
+        quietIdles = pending ? 0 : quietSoFar + 1;
     }
 
     // refresh waveform display if the mute state of the currently displayed osc changes
@@ -2324,6 +2347,7 @@ void SurgeGUIEditor::close_editor()
 
 bool SurgeGUIEditor::open(void *parent)
 {
+    auto openStart = std::chrono::steady_clock::now();
     int platformType = 0;
     float fzf = getZoomFactor() / 100.0;
 
@@ -2336,6 +2360,7 @@ bool SurgeGUIEditor::open(void *parent)
 
     // TODO: SET UP JUCE EDITOR BETTER!
     bitmapStore.reset(new SurgeImageStore());
+    setupRasterCache();
     bitmapStore->setupBuiltinBitmaps();
 
     if (!currentSkin->reloadSkin(bitmapStore))
@@ -2370,6 +2395,10 @@ bool SurgeGUIEditor::open(void *parent)
         showOverlay(SurgeGUIEditor::MSEG_EDITOR);
     }
 
+    lastOpenMilliseconds = std::chrono::duration<float, std::milli>(
+                               std::chrono::steady_clock::now() - openStart)
+                               .count();
+
     return true;
 }
 
@@ -2409,6 +2438,7 @@ void SurgeGUIEditor::setParameter(long index, float value)
 
         synth->refresh_ctrl_queue[j] = index;
         synth->refresh_ctrl_queue_value[j] = value;
+        synth->editorChanges.markParameter(index, n_total_params);
     }
 }
 
@@ -3015,6 +3045,69 @@ void SurgeGUIEditor::showSettingsMenu(const juce::Point<int> &where,
 
     settingsMenu.addSeparator();
 
+    bool offlineHQ = synth->storage.offlineHighestQuality;
+
+    settingsMenu.addItem(Surge::GUI::toOSCase("Use Highest Quality When Rendering Offline"), true,
+                         offlineHQ, [this, offlineHQ]() {
+                             synth->storage.offlineHighestQuality = !offlineHQ;
+                             Surge::Storage::updateUserDefaultValue(
+                                 &(this->synth->storage),
+                                 Surge::Storage::OfflineRenderHighestQuality, !offlineHQ);
+                         });
+
+    bool glideTempo = synth->storage.glideHostTempo;
+
+    settingsMenu.addItem(Surge::GUI::toOSCase("Glide Host Tempo Changes Across Blocks"), true,
+                         glideTempo, [this, glideTempo]() {
+                             synth->storage.glideHostTempo = !glideTempo;
+                             Surge::Storage::updateUserDefaultValue(&(this->synth->storage),
+                                                                    Surge::Storage::GlideHostTempo,
+                                                                    !glideTempo);
+                         });
+
+    auto halfbandMenu = juce::PopupMenu();
+    std::pair<SurgeStorage::HalfbandProfile, std::string> halfbandProfiles[] = {
+        {SurgeStorage::HALFBAND_LOW_CPU, "Low CPU"},
+        {SurgeStorage::HALFBAND_STANDARD, "Standard"},
+        {SurgeStorage::HALFBAND_HIGH, "High Quality"}};
+
+    for (auto &[profile, name] : halfbandProfiles)
+    {
+        auto p = profile;
+        halfbandMenu.addItem(Surge::GUI::toOSCase(name), true,
+                             synth->storage.halfbandProfile == p, [this, p]() {
+                                 synth->storage.halfbandProfile = p;
+                                 Surge::Storage::updateUserDefaultValue(
+                                     &(this->synth->storage), Surge::Storage::HalfbandProfile,
+                                     (int)p);
+                             });
+    }
+
+    settingsMenu.addSubMenu(Surge::GUI::toOSCase("Oversampling Filter Quality"), halfbandMenu);
+
+    // voice storage is allocated when an instance is made, so this applies to new ones
+    auto voiceCapMenu = juce::PopupMenu();
+    auto defaultCap = Surge::Storage::getUserDefaultValue(
+        &(synth->storage), Surge::Storage::VoiceCapacity, MAX_VOICES);
+
+    for (int cap = 8; cap <= MAX_VOICES; cap *= 2)
+    {
+        voiceCapMenu.addItem(fmt::format("{} Voices", cap), true, cap == defaultCap, [this, cap]() {
+            Surge::Storage::updateUserDefaultValue(&(this->synth->storage),
+                                                   Surge::Storage::VoiceCapacity, cap);
+        });
+    }
+
+    voiceCapMenu.addSeparator();
+    voiceCapMenu.addItem(
+        fmt::format("This instance has {} voices per scene", synth->voiceCapacity()), false,
+        false, []() {});
+
+    settingsMenu.addSubMenu(Surge::GUI::toOSCase("Voice Capacity for New Instances"),
+                            voiceCapMenu);
+
+    settingsMenu.addSeparator();
+
 #if BUILD_IS_DEBUG
     useDevMenu = true;
 #endif
@@ -4739,6 +4832,31 @@ juce::PopupMenu SurgeGUIEditor::makeMidiMenu(const juce::Point<int> &where)
                 !useMIDICh2Ch3);
         });
 
+    auto recvSubMenu = juce::PopupMenu();
+    auto recvMask = synth->storage.midiReceiveChannelMask;
+
+    recvSubMenu.addItem(Surge::GUI::toOSCase("All Channels"), true, recvMask == 0xFFFF, [this]() {
+        synth->storage.midiReceiveChannelMask = 0xFFFF;
+        synth->storage.getPatch().isDirty = true;
+    });
+
+    recvSubMenu.addSeparator();
+
+    for (int ch = 0; ch < 16; ++ch)
+    {
+        bool isOn = recvMask & (1 << ch);
+
+        recvSubMenu.addItem(Surge::GUI::toOSCase("Channel ") + std::to_string(ch + 1), true,
+                            isOn, [this, ch]() {
+                                auto m = synth->storage.midiReceiveChannelMask ^ (1 << ch);
+                                // receiving nothing at all is never what anyone wants
+                                synth->storage.midiReceiveChannelMask = m ? m : 0xFFFF;
+                                synth->storage.getPatch().isDirty = true;
+                            });
+    }
+
+    midiSubMenu.addSubMenu(Surge::GUI::toOSCase("Receive on MIDI Channels"), recvSubMenu);
+
     midiSubMenu.addSeparator();
     bool igMID = Surge::Storage::getUserDefaultValue(
         &(this->synth->storage), Surge::Storage::IgnoreMIDIProgramChange, false);
@@ -4807,6 +4925,8 @@ juce::PopupMenu SurgeGUIEditor::makeMidiMenu(const juce::Point<int> &where)
             this->synth->storage.getPatch().dawExtraState.customcontrol_map[i] = -1;
             this->synth->storage.getPatch().dawExtraState.customcontrol_chan_map[i] = -1;
         }
+
+        this->synth->storage.midiMappingChanged();
     });
 
     midiSubMenu.addSeparator();
@@ -5150,6 +5270,39 @@ juce::PopupMenu SurgeGUIEditor::makeDevMenu(const juce::Point<int> &where)
     devSubMenu.addItem(Surge::GUI::toOSCase("Dump Undo/Redo Stack to stdout"), true, false,
                        [this]() { undoManager()->dumpStack(); });
 
+    devSubMenu.addSeparator();
+
+    auto &tr = synth->traceRecorder;
+
+    // without SURGE_BUILD_WITH_TRACING the engine records nothing, so don't pretend otherwise
+    devSubMenu.addItem(Surge::GUI::toOSCase("Record Engine Trace"),
+                       Surge::Profiling::TraceRecorder::isCompiledIn(), tr.isEnabled(),
+                       [&tr]() { tr.setEnabled(!tr.isEnabled()); });
+
+    devSubMenu.addItem(
+        Surge::GUI::toOSCase("Save Engine Trace..."), tr.isEnabled(), false, [this]() {
+            fileChooser = std::make_unique<juce::FileChooser>("Save Engine Trace", juce::File(),
+                                                              "*.json");
+            fileChooser->launchAsync(juce::FileBrowserComponent::saveMode |
+                                         juce::FileBrowserComponent::canSelectFiles |
+                                         juce::FileBrowserComponent::warnAboutOverwriting,
+                                     [this](const juce::FileChooser &c) {
+                                         auto result = c.getResults();
+
+                                         if (result.isEmpty() || result.size() > 1)
+                                             return;
+
+                                         auto path = result[0].getFullPathName().toStdString();
+
+                                         if (!synth->traceRecorder.writeChromeTrace(path))
+                                         {
+                                             synth->storage.reportError(
+                                                 "Unable to write engine trace to " + path,
+                                                 "Save Engine Trace");
+                                         }
+                                     });
+        });
+
 #ifdef INSTRUMENT_UI
     devSubMenu.addItem(Surge::GUI::toOSCase("Show UI Instrumentation..."),
                        []() { Surge::Debug::report(); });
@@ -5219,6 +5372,13 @@ bool SurgeGUIEditor::promptForUserValueEntry(Surge::Widgets::ModulatableControlI
 void SurgeGUIEditor::promptForUserValueEntry(Parameter *p, juce::Component *c, int ms, int modScene,
                                              int modidx)
 {
+    if (!typeinParamEditor)
+    {
+        typeinParamEditor = std::make_unique<Surge::Overlays::TypeinParamEditor>();
+        typeinParamEditor->setVisible(false);
+        typeinParamEditor->setSurgeGUIEditor(this);
+    }
+
     if (typeinParamEditor->isVisible())
     {
         typeinParamEditor->setReturnFocusTarget(nullptr);
@@ -5542,12 +5702,25 @@ std::string SurgeGUIEditor::fullyResolvedHelpURL(const string &helpurl)
     return lurl;
 }
 
+void SurgeGUIEditor::setupRasterCache()
+{
+    // Only when the user data folder is already there; don't create it for a cache
+    std::error_code ec;
+    auto &udp = synth->storage.userDataPath;
+
+    if (fs::is_directory(udp, ec))
+    {
+        bitmapStore->setRasterCacheDirectory(udp / fs::path{"SkinCache"});
+    }
+}
+
 void SurgeGUIEditor::setupSkinFromEntry(const Surge::GUI::SkinDB::Entry &entry)
 {
     auto *db = Surge::GUI::SkinDB::get();
     auto s = db->getSkin(entry);
     this->currentSkin = s;
     this->bitmapStore.reset(new SurgeImageStore());
+    setupRasterCache();
     this->bitmapStore->setupBuiltinBitmaps();
     if (!this->currentSkin->reloadSkin(this->bitmapStore))
     {
@@ -5691,6 +5864,12 @@ void SurgeGUIEditor::promptForMiniEdit(const std::string &value, const std::stri
                                        std::function<void(const std::string &)> onOK,
                                        juce::Component *returnFocusTo)
 {
+    if (!miniEdit)
+    {
+        miniEdit = std::make_unique<Surge::Overlays::MiniEdit>();
+        miniEdit->setVisible(false);
+    }
+
     miniEdit->setSkin(currentSkin, bitmapStore);
     miniEdit->setEditor(this);
     miniEdit->setDescription(title);
@@ -7447,6 +7626,9 @@ bool SurgeGUIEditor::isAHiddenSendOrReturn(Parameter *p)
 
 void SurgeGUIEditor::hideTypeinParamEditor()
 {
+    if (!typeinParamEditor)
+        return;
+
     typeinParamEditor->setReturnFocusTarget(nullptr);
     typeinParamEditor->setVisible(false);
 }
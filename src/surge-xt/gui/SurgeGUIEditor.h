@@ -137,6 +137,16 @@ class SurgeGUIEditor : public Surge::GUI::IComponentTagValue::Listener,
     void idle();
     int slowIdleCounter{0};
     bool queue_refresh;
+
+    /*
+     * How many idles in a row found nothing changed in the engine and nothing pending here.
+     * Once that passes quietIdlesBeforeBackoff the plugin editor's timer slows down, and any
+     * change or mouse activity (wakeIdle) brings it back.
+     */
+    static constexpr int quietIdlesBeforeBackoff{30};
+    int quietIdles{0};
+    bool isIdleQuiet() const { return quietIdles > quietIdlesBeforeBackoff; }
+    void wakeIdle() { quietIdles = 0; }
     virtual void toggle_mod_editing();
 
     void forceLFODisplayRebuild();
@@ -147,6 +157,9 @@ class SurgeGUIEditor : public Surge::GUI::IComponentTagValue::Listener,
     bool open(void *parent);
     void close();
 
+    // Wall time of the last open(), shown in the About screen so regressions are visible
+    float lastOpenMilliseconds{0.f};
+
     bool pause_idle_updates = false;
     int enqueuePatchId = -1;
     void flushEnqueuedPatchId()
@@ -660,6 +673,10 @@ class SurgeGUIEditor : public Surge::GUI::IComponentTagValue::Listener,
                                           int modidx, const std::string &s, std::string &errMsg);
     bool setControlFromString(modsources ms, const std::string &s);
     void hideTypeinParamEditor();
+    bool isTypeinParamEditorVisible() const
+    {
+        return typeinParamEditor && typeinParamEditor->isVisible();
+    }
     friend struct Surge::Overlays::TypeinParamEditor;
     friend struct Surge::Overlays::PatchStoreDialog;
     friend struct Surge::Widgets::MainFrame;
@@ -913,6 +930,7 @@ class SurgeGUIEditor : public Surge::GUI::IComponentTagValue::Listener,
 
   private:
     void setupSkinFromEntry(const Surge::GUI::SkinDB::Entry &entry);
+    void setupRasterCache();
     void reloadFromSkin();
     Surge::GUI::IComponentTagValue *
     layoutComponentForSkin(std::shared_ptr<Surge::GUI::Skin::Control> skinCtrl, long tag,
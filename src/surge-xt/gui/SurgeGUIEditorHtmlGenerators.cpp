@@ -821,7 +821,33 @@ code {
                             <td>none</td>
                         </tr>
                         <tr>
-                            <td class="center" colspan="3">Initiates a dump of all parameters listed below.</td>
+                            <td><b>† </b>/snapshot</td>
+                            <td>request all parameters in one message</td>
+                            <td>none</td>
+                        </tr>
+                        <tr>
+                            <td class="center" colspan="3">/send_all_params initiates a dump of all parameters listed below.
+                                /snapshot replies with one /snapshot message holding a /param_batch blob of every parameter.</td>
+                        </tr>
+                    </table>
+                </div>
+                <div class="tablewrap cr cl" style="margin: 8px auto;">
+                    <div class="heading"><h3>Parameter Batches:</h3></div>
+                    <table style="border: 2px solid black;">
+                        <tr>
+                            <th>Address</th>
+                            <th>Description</th>
+                            <th>Appropriate Values</th>
+                        </tr>
+                        <tr>
+                            <td><b>† </b>/param_batch</td>
+                            <td>set many parameters at once</td>
+                            <td>pairs of parameter index and value</td>
+                        </tr>
+                        <tr>
+                            <td class="center" colspan="3">The index is the parameter's position in the /send_all_params dump.
+                                The pairs may also be sent as one blob of big-endian (int32, float32) pairs.
+                                All values in a batch, or all /param messages in a bundle, are applied together.</td>
                         </tr>
                     </table>
                 </div>
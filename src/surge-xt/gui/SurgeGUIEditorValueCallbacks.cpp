@@ -30,6 +30,8 @@
 
 #include "ModernOscillator.h"
 #include "StringOscillator.h"
+#include "TableWaveshapers.h"
+#include "chowdsp/TapeEffect.h"
 
 #include "widgets/EffectChooser.h"
 #include "widgets/LFOAndStepDisplay.h"
@@ -173,6 +175,7 @@ void SurgeGUIEditor::createMIDILearnMenuEntries(juce::PopupMenu &parentMenu,
                     currentSub.addItem(name, isEnabled, isChecked, [this, idx, mc, learnChan]() {
                         synth->storage.controllers[idx] = mc;
                         synth->storage.controllers_chan[idx] = learnChan;
+                        synth->storage.midiMappingChanged();
                     });
                     break;
                 }
@@ -198,6 +201,8 @@ void SurgeGUIEditor::createMIDILearnMenuEntries(juce::PopupMenu &parentMenu,
                                 synth->storage.getPatch().param_ptr[ptag]->midictrl = mc;
                                 synth->storage.getPatch().param_ptr[ptag]->midichan = learnChan;
                             }
+
+                            synth->storage.midiMappingChanged();
                         });
 
                     break;
@@ -225,6 +230,8 @@ void SurgeGUIEditor::createMIDILearnMenuEntries(juce::PopupMenu &parentMenu,
                 p->midichan = -1;
             else
                 this->synth->storage.getPatch().param_ptr[ptag]->midichan = -1;
+
+            this->synth->storage.midiMappingChanged();
         });
 
         for (int ch = 0; ch < 16; ch++)
@@ -237,6 +244,8 @@ void SurgeGUIEditor::createMIDILearnMenuEntries(juce::PopupMenu &parentMenu,
                                     p->midichan = ch;
                                 else
                                     this->synth->storage.getPatch().param_ptr[ptag]->midichan = ch;
+
+                                this->synth->storage.midiMappingChanged();
                             });
         }
 
@@ -339,6 +348,7 @@ void SurgeGUIEditor::createMIDILearnMenuEntries(juce::PopupMenu &parentMenu,
             parentMenu.addItem(txt, [this, idx]() {
                 synth->storage.controllers[idx] = -1;
                 synth->storage.controllers_chan[idx] = -1;
+                synth->storage.midiMappingChanged();
 
                 synth->storage.getPatch().dawExtraState.customcontrol_map[idx] = -1;
                 synth->storage.getPatch().dawExtraState.customcontrol_chan_map[idx] = -1;
@@ -373,6 +383,8 @@ void SurgeGUIEditor::createMIDILearnMenuEntries(juce::PopupMenu &parentMenu,
                     synth->storage.getPatch().dawExtraState.midictrl_map[ptag] = -1;
                     synth->storage.getPatch().dawExtraState.midichan_map[ptag] = -1;
                 }
+
+                synth->storage.midiMappingChanged();
             });
         }
 
@@ -605,6 +617,66 @@ int32_t SurgeGUIEditor::controlModifierClicked(Surge::GUI::IComponentTagValue *c
                                         &(synth->storage), Surge::Storage::ShowCPUUsage, !cpumeter);
                                     frame->repaint();
                                 });
+
+            auto &dm = synth->deadlineMonitor;
+            auto misses = dm.getMissCount();
+
+            contextMenu.addItem(
+                Surge::GUI::toOSCase(fmt::format("Show Late Blocks ({})...", misses)), misses > 0,
+                false, [this]() {
+                    auto &dm = synth->deadlineMonitor;
+                    auto history = dm.getHistory();
+
+                    // newest first, and only as many as fit in a message box
+                    static constexpr int maxShown = 16;
+                    auto msg = fmt::format("{} blocks took more than {}% of their deadline.\n",
+                                           dm.getMissCount(),
+                                           (int)std::round(dm.getThreshold() * 100));
+
+                    int shown = 0;
+                    for (auto m = history.rbegin(); m != history.rend() && shown < maxShown;
+                         ++m, ++shown)
+                    {
+                        msg += "\n" + m->describe();
+                    }
+
+                    if (!synth->blockProfiler.isEnabled())
+                    {
+                        msg += "\n\nThe CPU profiler is off, so the costliest part of each block "
+                               "is not known.";
+                    }
+
+                    messageBox("Late Blocks", msg);
+                });
+
+            bool logging = !dm.getLogFile().empty();
+
+            contextMenu.addItem(
+                Surge::GUI::toOSCase("Log Late Blocks to File"), true, logging, [this, logging]() {
+                    auto &dm = synth->deadlineMonitor;
+
+                    if (logging)
+                    {
+                        dm.setLogFile("");
+                        return;
+                    }
+
+                    auto p = path_to_string(synth->storage.userDataPath / "Late Blocks.log");
+
+                    if (!dm.setLogFile(p))
+                    {
+                        synth->storage.reportError("Unable to open " + p + " for writing.",
+                                                   "Log Late Blocks");
+                        return;
+                    }
+
+                    // the profiler is cheap, and without it the log can't say what was slow
+                    synth->blockProfiler.setEnabled(true);
+                    messageBox("Log Late Blocks", "Late blocks will be logged to " + p);
+                });
+
+            contextMenu.addItem(Surge::GUI::toOSCase("Clear Late Blocks"), misses > 0, false,
+                                [this]() { synth->deadlineMonitor.clear(); });
         }
 
 #ifdef DEBUG
@@ -2269,17 +2341,69 @@ int32_t SurgeGUIEditor::controlModifierClicked(Surge::GUI::IComponentTagValue *c
                         Surge::Widgets::MenuCenteredBoldLabel::addToMenuAsSectionHeader(
                             contextMenu, "PRECISION");
 
+                        int solverMask = chowdsp::TapeEffect::tdd_solver_mask;
+                        int adaptiveFlag = chowdsp::TapeEffect::tdd_adaptive_oversampling;
+
                         for (int i = 0; i < tapeHysteresisModes.size(); ++i)
                         {
-                            bool isChecked = p->deform_type == i;
+                            bool isChecked = (p->deform_type & solverMask) == i;
 
-                            contextMenu.addItem(Surge::GUI::toOSCase(tapeHysteresisModes[i]), true,
-                                                isChecked, [this, isChecked, p, i]() {
-                                                    if (p->deform_type != i)
+                            contextMenu.addItem(
+                                Surge::GUI::toOSCase(tapeHysteresisModes[i]), true, isChecked,
+                                [this, isChecked, p, i, solverMask]() {
+                                    if ((p->deform_type & solverMask) != i)
+                                        undoManager()->pushParameterChange(p->id, p, p->val);
+
+                                    p->deform_type = (p->deform_type & ~solverMask) | i;
+                                    if (!isChecked)
+                                    {
+                                        synth->storage.getPatch().isDirty = true;
+                                    }
+                                });
+                        }
+
+                        contextMenu.addSeparator();
+
+                        Surge::Widgets::MenuCenteredBoldLabel::addToMenuAsSectionHeader(
+                            contextMenu, "OVERSAMPLING");
+
+                        bool isAdaptive = p->deform_type & adaptiveFlag;
+
+                        contextMenu.addItem(Surge::GUI::toOSCase("Adaptive"), true, isAdaptive,
+                                            [this, p, adaptiveFlag]() {
+                                                undoManager()->pushParameterChange(p->id, p,
+                                                                                   p->val);
+                                                p->deform_type ^= adaptiveFlag;
+                                                synth->storage.getPatch().isDirty = true;
+                                            });
+
+                        break;
+                    }
+                    case ct_distortion_drive:
+                    case ct_waveshaper_drive:
+                    {
+                        contextMenu.addSeparator();
+
+                        Surge::Widgets::MenuCenteredBoldLabel::addToMenuAsSectionHeader(
+                            contextMenu, "OVERSAMPLING");
+
+                        // deform_type 0 is whatever the effect always used; see Oversampling.h
+                        std::vector<std::string> osModes = {"Off", "2x", "4x", "8x"};
+                        int defaultMode = (p->ctrltype == ct_distortion_drive) ? 3 : 2;
+
+                        for (int i = 0; i < osModes.size(); ++i)
+                        {
+                            int mode = i + 1;
+                            int current = (p->deform_type == 0) ? defaultMode : p->deform_type;
+                            bool isChecked = (current == mode);
+
+                            contextMenu.addItem(osModes[i], true, isChecked,
+                                                [this, isChecked, p, mode]() {
+                                                    if (p->deform_type != mode)
                                                         undoManager()->pushParameterChange(p->id, p,
                                                                                            p->val);
 
-                                                    p->deform_type = i;
+                                                    p->deform_type = mode;
                                                     if (!isChecked)
                                                     {
                                                         synth->storage.getPatch().isDirty = true;
@@ -2995,6 +3119,36 @@ int32_t SurgeGUIEditor::controlModifierClicked(Surge::GUI::IComponentTagValue *c
                                     });
             }
 
+            if (p->ctrltype == ct_wstype && p->ctrlgroup == cg_FILTER)
+            {
+                std::string sc = std::string("Scene ") + (char)('A' + current_scene);
+                auto wst = static_cast<sst::waveshapers::WaveshaperType>(p->val.i);
+                // shapes which can't be tabulated always run exact, so don't offer the others
+                bool tabulated = Surge::DSP::isTableWaveshaper(wst);
+
+                contextMenu.addSeparator();
+
+                auto addEvaluation = [&](const std::string &label,
+                                         SurgeStorage::WaveshaperEvaluation mode) {
+                    bool isChecked =
+                        synth->storage.sceneWaveshaperEvaluation[current_scene] == mode;
+
+                    contextMenu.addItem(Surge::GUI::toOSCase(sc + " " + label),
+                                        tabulated || mode == SurgeStorage::WAVESHAPER_EXACT,
+                                        isChecked, [this, isChecked, mode]() {
+                                            synth->storage
+                                                .sceneWaveshaperEvaluation[current_scene] = mode;
+                                            if (!isChecked)
+                                                synth->storage.getPatch().isDirty = true;
+                                        });
+                };
+
+                addEvaluation("Waveshaper Exact", SurgeStorage::WAVESHAPER_EXACT);
+                addEvaluation("Waveshaper from Table", SurgeStorage::WAVESHAPER_TABLE);
+                addEvaluation("Waveshaper from Table with Antialiasing",
+                              SurgeStorage::WAVESHAPER_TABLE_ADAA);
+            }
+
 #if SURGE_HAS_OSC
             if (synth->storage.oscListenerRunning)
             {
@@ -3217,7 +3371,7 @@ void SurgeGUIEditor::valueChanged(Surge::GUI::IComponentTagValue *control)
 
     long tag = control->getTag();
 
-    if (typeinParamEditor->isVisible())
+    if (isTypeinParamEditorVisible())
     {
         typeinParamEditor->setVisible(false);
         frame->removeChildComponent(typeinParamEditor.get());
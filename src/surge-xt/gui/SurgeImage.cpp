@@ -21,6 +21,7 @@
  */
 
 #include "SurgeImage.h"
+#include "SkinRasterCache.h"
 #include "SurgeXTBinary.h"
 
 #include "fmt/core.h"
@@ -35,8 +36,7 @@ SurgeImage::SurgeImage(int rid)
 
     if (bd)
     {
-        drawable = juce::Drawable::createFromImageData(bd, bds);
-        currentDrawable = drawable.get();
+        loadFromData(bd, bds);
     }
 }
 
@@ -65,11 +65,35 @@ void SurgeImage::forceLoadFromFile()
 {
     if (!drawable)
     {
-        drawable = juce::Drawable::createFromImageFile(juce::File(fname));
-        currentDrawable = drawable.get();
+        juce::MemoryBlock mb;
+        if (juce::File(fname).loadFileAsData(mb))
+        {
+            loadFromData(mb.getData(), mb.getSize());
+        }
+        regionCache.clear();
     }
 }
 
+void SurgeImage::loadFromData(const void *data, size_t size)
+{
+    drawable = juce::Drawable::createFromImageData(data, size);
+    currentDrawable = drawable.get();
+    sourceHash = hashSource(data, size);
+}
+
+uint64_t SurgeImage::hashSource(const void *data, size_t size)
+{
+    // FNV-1a; identical sources, in any skin, share a raster
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto b = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        h ^= b[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
 SurgeImage *SurgeImage::createFromBinaryWithPrefix(const std::string &prefix, int id)
 {
     std::string fn = fmt::format("{:s}{:05d}_svg", prefix, id);
@@ -79,7 +103,9 @@ SurgeImage *SurgeImage::createFromBinaryWithPrefix(const std::string &prefix, in
     if (bd)
     {
         auto q = juce::Drawable::createFromImageData(bd, bds);
-        return new SurgeImage(q);
+        auto res = new SurgeImage(q);
+        res->sourceHash = hashSource(bd, bds);
+        return res;
     }
 
     return nullptr;
@@ -88,7 +114,13 @@ SurgeImage *SurgeImage::createFromBinaryWithPrefix(const std::string &prefix, in
 void SurgeImage::setPhysicalZoomFactor(int zoomFactor)
 {
     resolvePNGForZoomLevel(zoomFactor);
+    if (zoomFactor != currentPhysicalZoomFactor && rasterState != NEVER)
+    {
+        raster = {};
+        rasterState = UNREQUESTED;
+    }
     currentPhysicalZoomFactor = zoomFactor;
+    regionCache.clear();
 
     if (pngZooms.size() > 0)
     {
@@ -153,6 +185,51 @@ juce::AffineTransform SurgeImage::scaleAdjustmentTransform() const
     return res;
 }
 
+bool SurgeImage::drawRaster(juce::Graphics &g, float opacity,
+                            const juce::AffineTransform &transform)
+{
+    if (!rasterCache || rasterState == NEVER || adjustForScale)
+        return false;
+
+    auto key = std::make_pair(sourceHash, currentPhysicalZoomFactor);
+
+    if (rasterState == UNREQUESTED)
+    {
+        auto idr = internalDrawableResolved();
+
+        // Bitmap sources are already rasters, and would only be resampled twice
+        if (!idr || sourceHash == 0 || dynamic_cast<juce::DrawableImage *>(idr))
+        {
+            rasterState = NEVER;
+            return false;
+        }
+
+        rasterState = rasterCache->request(key, idr->createCopy(), idr->getWidth(),
+                                           idr->getHeight())
+                          ? PENDING
+                          : NEVER;
+        return false;
+    }
+
+    if (rasterState == PENDING)
+    {
+        raster = rasterCache->fetch(key);
+        if (raster.isNull())
+            return false;
+        rasterState = READY;
+    }
+
+    // Anything drawn at another scale (an offscreen image, a transformed parent) would resample
+    // the bitmap, so it draws the vector as it always has
+    auto scale = currentPhysicalZoomFactor / 100.f;
+    if (std::fabs(g.getInternalContext().getPhysicalPixelScaleFactor() - scale) > 0.01f)
+        return false;
+
+    g.setOpacity(opacity);
+    g.drawImageTransformed(raster, juce::AffineTransform::scale(1.f / scale).followedBy(transform));
+    return true;
+}
+
 juce::Image SurgeImage::asJuceImage(float scaleBy)
 {
     auto d = internalDrawableResolved();
@@ -163,4 +240,46 @@ juce::Image SurgeImage::asJuceImage(float scaleBy)
     juce::Graphics g(res);
     d->draw(g, 1.f, juce::AffineTransform::scale(scaleBy));
     return res;
-}
\ No newline at end of file
+}
+void SurgeImage::drawRegionCached(juce::Graphics &g, juce::Rectangle<int> source, float opacity)
+{
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    auto key = RegionKey{source.getX(),
+                         source.getY(),
+                         source.getWidth(),
+                         source.getHeight(),
+                         (int)std::round(scale * 1000),
+                         (int)std::round(opacity * 100)};
+
+    auto it = regionCache.find(key);
+
+    if (it == regionCache.end())
+    {
+        auto pw = (int)std::ceil(source.getWidth() * scale);
+        auto ph = (int)std::ceil(source.getHeight() * scale);
+
+        if (pw <= 0 || ph <= 0)
+        {
+            return;
+        }
+
+        if (regionCache.size() >= maxCachedRegions)
+        {
+            regionCache.clear();
+        }
+
+        juce::Image img(juce::Image::ARGB, pw, ph, true);
+
+        {
+            juce::Graphics ig(img);
+            ig.addTransform(juce::AffineTransform::scale(scale));
+            ig.reduceClipRegion(0, 0, source.getWidth(), source.getHeight());
+            draw(ig, opacity,
+                 juce::AffineTransform::translation(-source.getX(), -source.getY()));
+        }
+
+        it = regionCache.emplace(key, img).first;
+    }
+
+    g.drawImage(it->second, source.withZeroOrigin().toFloat());
+}
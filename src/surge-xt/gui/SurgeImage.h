@@ -31,8 +31,10 @@
 #include <vector>
 #include <map>
 #include <atomic>
+#include <tuple>
 
 class SurgeImageStore;
+class SkinRasterCache;
 
 class SurgeImage
 {
@@ -58,6 +60,8 @@ class SurgeImage
     {
         juce::Graphics::ScopedSaveState gs(g);
         g.addTransform(scaleAdjustmentTransform());
+        if (drawRaster(g, opacity, transform))
+            return;
         auto idr = internalDrawableResolved();
         if (idr)
             idr->draw(g, opacity, transform);
@@ -66,6 +70,8 @@ class SurgeImage
     {
         juce::Graphics::ScopedSaveState gs(g);
         g.addTransform(scaleAdjustmentTransform());
+        if (drawRaster(g, opacity, juce::AffineTransform::translation(x, y)))
+            return;
         auto idr = internalDrawableResolved();
         if (idr)
             idr->drawAt(g, x, y, opacity);
@@ -80,6 +86,15 @@ class SurgeImage
             idr->drawWithin(g, destArea, placement, opacity);
     }
 
+    /*
+     * Draw the source rectangle of this image at the origin, from a raster of it kept per
+     * physical pixel scale and opacity. Slider trays are small pieces of a large sprite sheet
+     * and rendering the clipped vector every repaint is most of what a slider costs to draw;
+     * this renders each piece once and blits it after. The rasters are dropped whenever the
+     * zoom resolves the image differently.
+     */
+    void drawRegionCached(juce::Graphics &g, juce::Rectangle<int> source, float opacity);
+
     std::unique_ptr<juce::Drawable> createCopy()
     {
         auto idr = internalDrawableResolved();
@@ -96,7 +111,18 @@ class SurgeImage
 
     juce::Image asJuceImage(float scaleBy = 1.0);
 
+    /*
+     * Vector images with a raster cache draw from a bitmap rendered at the current physical
+     * zoom once the cache has one; see SkinRasterCache. The store sets this on its images.
+     */
+    void setRasterCache(SkinRasterCache *c) { rasterCache = c; }
+    uint64_t sourceHash{0};
+
   private:
+    bool drawRaster(juce::Graphics &g, float opacity, const juce::AffineTransform &transform);
+    void loadFromData(const void *data, size_t size);
+    static uint64_t hashSource(const void *data, size_t size);
+
     juce::Drawable *internalDrawableResolved();
     juce::AffineTransform scaleAdjustmentTransform() const;
 
@@ -109,10 +135,34 @@ class SurgeImage
      * map vs unordered is on purpose here - we need this ordered for our zoom search
      */
     std::map<int, std::pair<std::string, std::unique_ptr<SurgeImage>>> pngZooms;
-    int currentPhysicalZoomFactor;
+    int currentPhysicalZoomFactor{100};
 
     std::unique_ptr<juce::Drawable> drawable;
     juce::Drawable *currentDrawable{nullptr};
+
+    SkinRasterCache *rasterCache{nullptr};
+    enum RasterState
+    {
+        UNREQUESTED,
+        PENDING,
+        READY,
+        NEVER
+    } rasterState{UNREQUESTED};
+    juce::Image raster;
+
+    struct RegionKey
+    {
+        int x, y, w, h, scaleMilli, opacityPercent;
+        bool operator<(const RegionKey &o) const
+        {
+            return std::tie(x, y, w, h, scaleMilli, opacityPercent) <
+                   std::tie(o.x, o.y, o.w, o.h, o.scaleMilli, o.opacityPercent);
+        }
+    };
+    // Continuous window resizing walks through many scales, so this is simply cleared
+    // once it grows past a handful of trays at a handful of scales
+    static constexpr size_t maxCachedRegions{128};
+    std::map<RegionKey, juce::Image> regionCache;
 };
 
 #endif // SURGE_SRC_SURGE_XT_GUI_SURGEIMAGE_H
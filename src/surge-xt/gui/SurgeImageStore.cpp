@@ -21,6 +21,7 @@
  */
 #include "SurgeImageStore.h"
 #include "SurgeImage.h"
+#include "SkinRasterCache.h"
 
 #include "fmt/core.h"
 
@@ -28,7 +29,7 @@
 #include <cassert>
 
 std::atomic<int> SurgeImageStore::instances(0);
-SurgeImageStore::SurgeImageStore()
+SurgeImageStore::SurgeImageStore() : rasterCache(std::make_unique<SkinRasterCache>())
 {
     instances++;
 #ifdef INSTRUMENT_UI
@@ -147,7 +148,7 @@ void SurgeImageStore::addEntry(int id)
 {
     assert(bitmap_registry.find(id) == bitmap_registry.end());
 
-    SurgeImage *bitmap = new SurgeImage(id);
+    SurgeImage *bitmap = adopt(new SurgeImage(id));
 
     bitmap_registry[id] = bitmap;
 
@@ -155,7 +156,7 @@ void SurgeImageStore::addEntry(int id)
         if (auto *h = SurgeImage::createFromBinaryWithPrefix(pfx, id))
         {
             std::string name = fmt::format("DEFAULT/{}{:05d}.svg", pfx, id);
-            bitmap_stringid_registry[name] = h;
+            bitmap_stringid_registry[name] = adopt(h);
         }
     };
 
@@ -165,6 +166,12 @@ void SurgeImageStore::addEntry(int id)
     checkAndAdd("hoverTS");
 }
 
+SurgeImage *SurgeImageStore::adopt(SurgeImage *img)
+{
+    img->setRasterCache(rasterCache.get());
+    return img;
+}
+
 SurgeImage *SurgeImageStore::getImage(int id) { return bitmap_registry.at(id); }
 
 SurgeImage *SurgeImageStore::getImageByPath(const std::string &filename)
@@ -187,7 +194,7 @@ SurgeImage *SurgeImageStore::loadImageByPath(const std::string &filename)
     {
         delete bitmap_file_registry[filename];
     }
-    bitmap_file_registry[filename] = new SurgeImage(filename);
+    bitmap_file_registry[filename] = adopt(new SurgeImage(filename));
     return bitmap_file_registry[filename];
 }
 
@@ -197,7 +204,7 @@ SurgeImage *SurgeImageStore::loadImageByPathForID(const std::string &filename, i
     {
         delete bitmap_registry[id];
     }
-    bitmap_registry[id] = new SurgeImage(filename);
+    bitmap_registry[id] = adopt(new SurgeImage(filename));
     return bitmap_registry[id];
 }
 
@@ -207,12 +214,19 @@ SurgeImage *SurgeImageStore::loadImageByPathForStringID(const std::string &filen
     {
         delete bitmap_stringid_registry[id];
     }
-    bitmap_stringid_registry[id] = new SurgeImage(filename);
+    bitmap_stringid_registry[id] = adopt(new SurgeImage(filename));
     return bitmap_stringid_registry[id];
 }
 
+void SurgeImageStore::setRasterCacheDirectory(const fs::path &dir)
+{
+    rasterCache->setDirectory(dir);
+}
+
 void SurgeImageStore::setPhysicalZoomFactor(int pzf)
 {
+    rasterCache->dropAllBut(pzf);
+
     for (auto pair : bitmap_registry)
         pair.second->setPhysicalZoomFactor(pzf);
     for (auto pair : bitmap_file_registry)
@@ -29,8 +29,12 @@
 #include <algorithm>
 #include <cctype>
 #include <vector>
+#include <memory>
+
+#include "filesystem/import.h"
 
 class SurgeImage;
+class SkinRasterCache;
 
 class SurgeImageStore
 {
@@ -42,6 +46,9 @@ class SurgeImageStore
     void setupBuiltinBitmaps();
     void setPhysicalZoomFactor(int pzf);
 
+    // Keep the pre-rasterized skin images here too, so they outlive this store
+    void setRasterCacheDirectory(const fs::path &dir);
+
     SurgeImage *getImage(int id);
     SurgeImage *getImageByPath(const std::string &filename);
     SurgeImage *getImageByStringID(const std::string &id);
@@ -74,6 +81,9 @@ class SurgeImageStore
     static std::atomic<int> instances;
 
     void addEntry(int id);
+    SurgeImage *adopt(SurgeImage *img);
+
+    std::unique_ptr<SkinRasterCache> rasterCache;
     // I own and am responsible for deleting these
     std::map<int, SurgeImage *> bitmap_registry;
     std::map<std::string, SurgeImage *> bitmap_file_registry;
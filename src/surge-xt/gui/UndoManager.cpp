@@ -23,6 +23,8 @@
 #include "UndoManager.h"
 #include "SurgeGUIEditor.h"
 #include "SurgeSynthesizer.h"
+#include <algorithm>
+#include <memory>
 #include <stack>
 #include <chrono>
 #include <variant>
@@ -35,21 +37,16 @@ namespace GUI
 {
 struct UndoManagerImpl
 {
-    static constexpr int maxUndoStackMem = 1024 * 1024 * 25;
-    static constexpr int maxRedoStackMem = 1024 * 1024 * 25;
+    // each stack's budget, from the UndoHistoryMegabytes user default
+    size_t maxUndoStackMem{1024 * 1024 * 25};
+    size_t maxRedoStackMem{1024 * 1024 * 25};
     SurgeGUIEditor *editor;
     SurgeSynthesizer *synth;
-    UndoManagerImpl(SurgeGUIEditor *ed, SurgeSynthesizer *s) : editor(ed), synth(s) {}
-    ~UndoManagerImpl()
+    UndoManagerImpl(SurgeGUIEditor *ed, SurgeSynthesizer *s) : editor(ed), synth(s)
     {
-        for (auto &r : undoStack)
-        {
-            freeAction(r.action);
-        }
-        for (auto &r : redoStack)
-        {
-            freeAction(r.action);
-        }
+        auto mb = Surge::Storage::getUserDefaultValue(&(synth->storage),
+                                                      Surge::Storage::UndoHistoryMegabytes, 25);
+        maxUndoStackMem = maxRedoStackMem = (size_t)std::clamp(mb, 1, 1024) * 1024 * 1024;
     }
     bool doPush{true};
     struct SelfPushGuard
@@ -81,10 +78,7 @@ struct UndoManagerImpl
         int paramId;
         std::string name;
         std::string formattedValue;
-        bool temposync, absolute, deactivated, extend_range, deform_type;
-        bool porta_constrate, porta_gliss, porta_retrigger;
-        int porta_curve;
-        pdata val;
+        ParameterState state;
     };
     struct UndoModulation
     {
@@ -127,30 +121,38 @@ struct UndoManagerImpl
         int type;
         std::vector<UndoParam> undoParamValues;
     };
+    /*
+     * The modulator storages are large (an MSEG is several kilobytes) and every record in a
+     * stack is as big as the biggest alternative in UndoAction, so they are held by pointer.
+     * Otherwise each parameter tweak would cost as much as an MSEG copy.
+     */
     struct UndoStep
     {
         int scene;
         int lfoid;
-        StepSequencerStorage storageCopy;
+        std::shared_ptr<const StepSequencerStorage> storageCopy;
     };
     struct UndoMSEG
     {
         int scene;
         int lfoid;
-        MSEGStorage storageCopy;
+        std::shared_ptr<const MSEGStorage> storageCopy;
     };
     struct UndoFormula
     {
         int scene;
         int lfoid;
-        FormulaModulatorStorage storageCopy;
+        std::shared_ptr<const FormulaModulatorStorage> storageCopy;
     };
     struct UndoFullLFO
     {
         int scene;
         int lfoid;
         std::vector<UndoParam> undoParamValues;
-        std::variant<bool, MSEGStorage, StepSequencerStorage, FormulaModulatorStorage> extraStorage;
+        std::variant<bool, std::shared_ptr<const MSEGStorage>,
+                     std::shared_ptr<const StepSequencerStorage>,
+                     std::shared_ptr<const FormulaModulatorStorage>>
+            extraStorage;
     };
     struct UndoRename
     {
@@ -167,13 +169,25 @@ struct UndoManagerImpl
     };
     struct UndoTuning
     {
-        Tunings::Tuning tuning;
+        std::shared_ptr<const Tunings::Tuning> tuning;
     };
+    /*
+     * A streamed patch is stored as the bytes which differ from a keyframe: the keyframe's
+     * first prefixSz bytes, then middle, then its last suffixSz bytes. Successive edits of one
+     * patch mostly share their streams, so most records only carry a small middle. A record
+     * which would differ by too much becomes a new keyframe itself (whole stream in base,
+     * nothing else). Records share keyframes, and a keyframe lives as long as any record on
+     * either stack refers to it.
+     */
     struct UndoPatch
     {
-        void *data{nullptr};
-        size_t dataSz{0};
+        std::shared_ptr<const std::vector<char>> base;
+        size_t prefixSz{0}, suffixSz{0};
+        std::vector<char> middle;
+        bool ownsBase{false}; // the record which made a keyframe is charged for it
         fs::path path{};
+
+        size_t dataSz() const { return base ? prefixSz + middle.size() + suffixSz : 0; }
     };
     struct UndoFilterAnalysisMovement
     {
@@ -201,26 +215,43 @@ struct UndoManagerImpl
     {
         auto res = sizeof(a);
 
+        if (auto pt = std::get_if<UndoStep>(&a))
+        {
+            res += sizeof(StepSequencerStorage);
+        }
+        if (auto pt = std::get_if<UndoMSEG>(&a))
+        {
+            res += sizeof(MSEGStorage);
+        }
         if (auto pt = std::get_if<UndoFormula>(&a))
         {
-            res += pt->storageCopy.formulaString.size();
+            res += sizeof(FormulaModulatorStorage) + pt->storageCopy->formulaString.size();
         }
-        if (auto pt = std::get_if<UndoPatch>(&a))
+        if (auto pt = std::get_if<UndoFullLFO>(&a))
         {
-            res += pt->dataSz;
+            res += pt->undoParamValues.size() * sizeof(UndoParam);
+            if (std::holds_alternative<std::shared_ptr<const MSEGStorage>>(pt->extraStorage))
+                res += sizeof(MSEGStorage);
+            else if (auto f = std::get_if<std::shared_ptr<const FormulaModulatorStorage>>(
+                         &pt->extraStorage))
+                res += sizeof(FormulaModulatorStorage) + (*f)->formulaString.size();
+            else if (!std::holds_alternative<bool>(pt->extraStorage))
+                res += sizeof(StepSequencerStorage);
+        }
+        if (auto pt = std::get_if<UndoTuning>(&a))
+        {
+            res += sizeof(Tunings::Tuning);
         }
-        return res;
-    }
-
-    void freeAction(UndoAction &a)
-    {
         if (auto pt = std::get_if<UndoPatch>(&a))
         {
-            free(pt->data);
-            pt->dataSz = 0;
+            res += pt->middle.size() + (pt->ownsBase ? pt->base->size() : 0);
         }
+        return res;
     }
 
+    // the keyframe new patch records are diffed against
+    std::shared_ptr<const std::vector<char>> patchKeyframe;
+
     /* Not same value, but same pair. Used for wheel event compressing for instance */
     bool aboutTheSameThing(const UndoAction &a, const UndoAction &b)
     {
@@ -284,7 +315,7 @@ struct UndoManagerImpl
         if (auto pa = std::get_if<UndoParam>(&a))
         {
             return fmt::format("Parameter {} : {} f={} i={}", pa->name, pa->formattedValue,
-                               pa->val.f, pa->val.i);
+                               pa->state.val.f, pa->state.val.i);
         }
         if (auto pa = std::get_if<UndoModulation>(&a))
         {
@@ -396,10 +427,6 @@ struct UndoManagerImpl
 
     void clearRedo()
     {
-        for (auto &r : redoStack)
-        {
-            freeAction(r.action);
-        }
         redoStack.clear();
         redoStackMem = 0;
     }
@@ -417,16 +444,12 @@ struct UndoManagerImpl
     {
         while (undoStackMem > maxUndoStackMem)
         {
-            auto r = undoStack.front();
-            freeAction(r.action);
-            undoStackMem -= actionSize(r.action);
+            undoStackMem -= actionSize(undoStack.front().action);
             undoStack.pop_front();
         }
         while (redoStackMem > maxRedoStackMem)
         {
-            auto r = redoStack.front();
-            freeAction(r.action);
-            redoStackMem -= actionSize(r.action);
+            redoStackMem -= actionSize(redoStack.front().action);
             redoStack.pop_front();
         }
     }
@@ -438,18 +461,8 @@ struct UndoManagerImpl
         synth->getParameterName(synth->idForParameter(p), buf);
         txt = buf;
         r.name = txt;
-        r.temposync = p->temposync;
-        r.absolute = p->absolute;
-        r.deactivated = p->deactivated;
-        r.extend_range = p->extend_range;
-        r.deform_type = p->deform_type;
-
-        r.porta_constrate = p->porta_constrate;
-        r.porta_gliss = p->porta_gliss;
-        r.porta_retrigger = p->porta_retrigger;
-        r.porta_curve = p->porta_curve;
-
-        r.val = val;
+        r.state = p->get_state();
+        r.state.val = val;
 
         if (p->ctrltype == vt_float)
         {
@@ -470,19 +483,9 @@ struct UndoManagerImpl
 
     void restoreParamToEditor(const UndoParam *pa)
     {
-        editor->setParamFromUndo(pa->paramId, pa->val);
-        editor->applyToParamForUndo(pa->paramId, [pa](Parameter *p) {
-            p->temposync = pa->temposync;
-            p->absolute = pa->absolute;
-            p->deactivated = pa->deactivated;
-            p->set_extend_range(pa->extend_range);
-            p->deform_type = pa->deform_type;
-
-            p->porta_constrate = pa->porta_constrate;
-            p->porta_gliss = pa->porta_gliss;
-            p->porta_retrigger = pa->porta_retrigger;
-            p->porta_curve = pa->porta_curve;
-        });
+        editor->setParamFromUndo(pa->paramId, pa->state.val);
+        editor->applyToParamForUndo(pa->paramId,
+                                    [pa](Parameter *p) { p->set_state(pa->state, false); });
     }
 
     void pushParameterChange(int paramId, const Parameter *p, pdata val, UndoManager::Target to)
@@ -636,7 +639,7 @@ struct UndoManagerImpl
         auto r = UndoStep();
         r.scene = scene;
         r.lfoid = lfoid;
-        r.storageCopy = pushValue;
+        r.storageCopy = std::make_shared<const StepSequencerStorage>(pushValue);
         if (to == UndoManager::UNDO)
             pushUndo(r);
         else
@@ -649,7 +652,7 @@ struct UndoManagerImpl
         auto r = UndoMSEG();
         r.scene = scene;
         r.lfoid = lfoid;
-        r.storageCopy = pushValue;
+        r.storageCopy = std::make_shared<const MSEGStorage>(pushValue);
         if (to == UndoManager::UNDO)
             pushUndo(r);
         else
@@ -664,15 +667,18 @@ struct UndoManagerImpl
         auto lf = &(editor->getPatch().scene[scene].lfo[lfoid]);
         if (lf->shape.val.i == lt_mseg)
         {
-            r.extraStorage = editor->getPatch().msegs[scene][lfoid];
+            r.extraStorage =
+                std::make_shared<const MSEGStorage>(editor->getPatch().msegs[scene][lfoid]);
         }
         else if (lf->shape.val.i == lt_formula)
         {
-            r.extraStorage = editor->getPatch().formulamods[scene][lfoid];
+            r.extraStorage = std::make_shared<const FormulaModulatorStorage>(
+                editor->getPatch().formulamods[scene][lfoid]);
         }
         else if (lf->shape.val.i == lt_stepseq)
         {
-            r.extraStorage = editor->getPatch().stepsequences[scene][lfoid];
+            r.extraStorage = std::make_shared<const StepSequencerStorage>(
+                editor->getPatch().stepsequences[scene][lfoid]);
         }
         else
         {
@@ -702,7 +708,7 @@ struct UndoManagerImpl
         auto r = UndoFormula();
         r.scene = scene;
         r.lfoid = lfoid;
-        r.storageCopy = pushValue;
+        r.storageCopy = std::make_shared<const FormulaModulatorStorage>(pushValue);
         if (to == UndoManager::UNDO)
             pushUndo(r);
         else
@@ -740,7 +746,7 @@ struct UndoManagerImpl
     void pushTuning(const Tunings::Tuning &t, UndoManager::Target to = UndoManager::UNDO)
     {
         auto r = UndoTuning();
-        r.tuning = t;
+        r.tuning = std::make_shared<const Tunings::Tuning>(t);
         if (to == UndoManager::UNDO)
             pushUndo(r);
         else
@@ -750,10 +756,6 @@ struct UndoManagerImpl
     void pushPatch(UndoManager::Target to = UndoManager::UNDO)
     {
         auto r = UndoPatch();
-        r.data = nullptr;
-        r.dataSz = 0;
-        r.path = fs::path{};
-        static int qq = 0;
         bool doStream = editor->getPatch().isDirty;
         if (!doStream)
         {
@@ -772,10 +774,8 @@ struct UndoManagerImpl
             void *data{nullptr};
             auto dsz = editor->getPatch().save_patch(&data);
             // Now the pointer which is returned will be the patches 'patchptr'
-            // which on the lext load will get clobbered so we need to make a copy.
-            r.dataSz = dsz;
-            r.data = malloc(r.dataSz);
-            memcpy(r.data, data, r.dataSz);
+            // which on the lext load will get clobbered so we need to copy out of it.
+            storePatchStream(r, (const char *)data, dsz);
         }
 
         if (to == UndoManager::UNDO)
@@ -784,6 +784,47 @@ struct UndoManagerImpl
             pushRedo(r);
     }
 
+    void storePatchStream(UndoPatch &r, const char *data, size_t dsz)
+    {
+        size_t pre = 0, suf = 0;
+
+        if (patchKeyframe)
+        {
+            auto &k = *patchKeyframe;
+            auto lim = std::min(k.size(), dsz);
+
+            while (pre < lim && k[pre] == data[pre])
+                pre++;
+            while (suf < lim - pre && k[k.size() - 1 - suf] == data[dsz - 1 - suf])
+                suf++;
+        }
+
+        // past a quarter of the stream a diff stops paying for the keyframe it pins
+        if (!patchKeyframe || (dsz - pre - suf) * 4 > dsz)
+        {
+            patchKeyframe = std::make_shared<const std::vector<char>>(data, data + dsz);
+            r.base = patchKeyframe;
+            r.prefixSz = dsz;
+            r.ownsBase = true;
+            return;
+        }
+
+        r.base = patchKeyframe;
+        r.prefixSz = pre;
+        r.suffixSz = suf;
+        r.middle.assign(data + pre, data + dsz - suf);
+    }
+
+    std::vector<char> patchStream(const UndoPatch &r)
+    {
+        std::vector<char> res;
+        res.reserve(r.dataSz());
+        res.insert(res.end(), r.base->begin(), r.base->begin() + r.prefixSz);
+        res.insert(res.end(), r.middle.begin(), r.middle.end());
+        res.insert(res.end(), r.base->end() - r.suffixSz, r.base->end());
+        return res;
+    }
+
     void pushFilterAnalysisMovement(int cutoffParamId, const Parameter *cutoff_p,
                                     int resonanceParamId, const Parameter *resonance_p,
                                     UndoManager::Target to = UndoManager::UNDO)
@@ -923,26 +964,28 @@ struct UndoManagerImpl
             }
             if (lf->shape.val.i == lt_mseg)
             {
-                auto ms = std::get_if<MSEGStorage>(&p->extraStorage);
+                auto ms = std::get_if<std::shared_ptr<const MSEGStorage>>(&p->extraStorage);
                 if (ms)
                 {
-                    editor->setMSEGFromUndo(p->scene, p->lfoid, *ms);
+                    editor->setMSEGFromUndo(p->scene, p->lfoid, **ms);
                 }
             }
             else if (lf->shape.val.i == lt_formula)
             {
-                auto ms = std::get_if<FormulaModulatorStorage>(&p->extraStorage);
+                auto ms =
+                    std::get_if<std::shared_ptr<const FormulaModulatorStorage>>(&p->extraStorage);
                 if (ms)
                 {
-                    editor->setFormulaFromUndo(p->scene, p->lfoid, *ms);
+                    editor->setFormulaFromUndo(p->scene, p->lfoid, **ms);
                 }
             }
             else if (lf->shape.val.i == lt_stepseq)
             {
-                auto ms = std::get_if<StepSequencerStorage>(&p->extraStorage);
+                auto ms =
+                    std::get_if<std::shared_ptr<const StepSequencerStorage>>(&p->extraStorage);
                 if (ms)
                 {
-                    editor->setStepSequencerFromUndo(p->scene, p->lfoid, *ms);
+                    editor->setStepSequencerFromUndo(p->scene, p->lfoid, **ms);
                 }
             }
 
@@ -970,18 +1013,14 @@ struct UndoManagerImpl
                 delete t_fx;
             }
 
+            synth->stageEffectForSlot(cge, synth->fxsync[cge].type.val.i);
+
             synth->switch_toggled_queued = true;
             synth->load_fx_needed = true;
             synth->fx_reload[cge] = true;
             for (int i = 0; i < n_fx_params; ++i)
             {
-                auto *pa = &(synth->fxsync[cge].p[i]);
-                pa->val = p->undoParamValues[i].val;
-                pa->temposync = p->undoParamValues[i].temposync;
-                pa->absolute = p->undoParamValues[i].absolute;
-                pa->deactivated = p->undoParamValues[i].deactivated;
-                pa->set_extend_range(p->undoParamValues[i].extend_range);
-                pa->deform_type = p->undoParamValues[i].deform_type;
+                synth->fxsync[cge].p[i].set_state(p->undoParamValues[i].state);
             }
 
             auto ann = fmt::format("{} FX Type to {}, FX Slot {}", verb, fx_type_names[p->type],
@@ -994,7 +1033,7 @@ struct UndoManagerImpl
             pushStepSequencer(p->scene, p->lfoid,
                               editor->getPatch().stepsequences[p->scene][p->lfoid], opposite);
             auto g = SelfPushGuard(this);
-            editor->setStepSequencerFromUndo(p->scene, p->lfoid, p->storageCopy);
+            editor->setStepSequencerFromUndo(p->scene, p->lfoid, *p->storageCopy);
             auto ann = fmt::format("{} Step Sequencer Setting, Scene {} Modulator {}", verb,
                                    (char)('A' + p->scene), p->lfoid + 1);
             editor->enqueueAccessibleAnnouncement(ann);
@@ -1005,7 +1044,7 @@ struct UndoManagerImpl
         {
             pushMSEG(p->scene, p->lfoid, editor->getPatch().msegs[p->scene][p->lfoid], opposite);
             auto g = SelfPushGuard(this);
-            editor->setMSEGFromUndo(p->scene, p->lfoid, p->storageCopy);
+            editor->setMSEGFromUndo(p->scene, p->lfoid, *p->storageCopy);
             auto ann = fmt::format("{} MSEG, Scene {} Modulator {}", verb, (char)('A' + p->scene),
                                    p->lfoid + 1);
             editor->enqueueAccessibleAnnouncement(ann);
@@ -1017,7 +1056,7 @@ struct UndoManagerImpl
             pushFormula(p->scene, p->lfoid, editor->getPatch().formulamods[p->scene][p->lfoid],
                         opposite);
             auto g = SelfPushGuard(this);
-            editor->setFormulaFromUndo(p->scene, p->lfoid, p->storageCopy);
+            editor->setFormulaFromUndo(p->scene, p->lfoid, *p->storageCopy);
             auto ann = fmt::format("{} Formula, Scene {} Modulator {}", verb,
                                    (char)('A' + p->scene), p->lfoid + 1);
             editor->enqueueAccessibleAnnouncement(ann);
@@ -1065,7 +1104,7 @@ struct UndoManagerImpl
         {
             pushTuning(editor->getTuningForRedo(), opposite);
             auto g = SelfPushGuard(this);
-            editor->setTuningFromUndo(p->tuning);
+            editor->setTuningFromUndo(*p->tuning);
 
             auto ann = fmt::format("{} Tuning Change", verb);
             editor->enqueueAccessibleAnnouncement(ann);
@@ -1075,13 +1114,14 @@ struct UndoManagerImpl
         {
             pushPatch(opposite);
             auto g = SelfPushGuard(this);
-            if (p->dataSz == 0)
+            if (p->dataSz() == 0)
             {
                 editor->queuePatchFileLoad(p->path.u8string());
             }
             else
             {
-                editor->setPatchFromUndo(p->data, p->dataSz);
+                auto stream = patchStream(*p);
+                editor->setPatchFromUndo(stream.data(), stream.size());
             }
 
             auto ann = fmt::format("{} Patch Change", verb);
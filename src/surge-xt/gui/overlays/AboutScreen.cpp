@@ -199,6 +199,17 @@ void AboutScreen::populateData()
         lowerLeft.emplace_back("Sample Rate:", srString, "");
     }
 
+    if (editor && editor->synth)
+    {
+        lowerLeft.emplace_back("Memory:", editor->synth->getMemoryFootprint().summary(), "");
+    }
+
+    if (editor && editor->lastOpenMilliseconds > 0)
+    {
+        lowerLeft.emplace_back("Editor Open:",
+                               fmt::format("{:.0f} ms", editor->lastOpenMilliseconds), "");
+    }
+
     lowerLeft.emplace_back("", "", "");
 
     auto apppath = sst::plugininfra::paths::sharedLibraryBinaryPath();
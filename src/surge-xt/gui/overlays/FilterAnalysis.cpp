@@ -61,44 +61,65 @@ struct FilterAnalysisEvaluator
     {
         uint64_t lastIB = 0;
         auto fp = sst::filters::FilterPlotter(15);
-        while (continueWaiting)
+        while (true)
         {
-            if (lastIB == inboundUpdates)
+            int cty, csu;
+            float ccu, cre, cgn;
             {
                 auto lock = std::unique_lock<std::mutex>(dataLock);
-                cv.wait(lock);
+                cv.wait(lock, [&] { return !continueWaiting || lastIB != inboundUpdates; });
+
+                if (!continueWaiting)
+                    return;
+
+                // Only the latest request matters, so anything pushed while we were
+                // plotting has already been folded into these values
+                cty = type;
+                csu = subtype;
+                ccu = cutoff;
+                cre = resonance;
+                cgn = gain;
+                lastIB = inboundUpdates;
             }
 
-            if (lastIB != inboundUpdates)
+            auto par = sst::filters::FilterPlotParameters();
+            par.inputAmplitude *= cgn;
+            auto data = fp.plotFilterMagnitudeResponse(
+                (sst::filters::FilterType)cty, (sst::filters::FilterSubType)csu, ccu, cre, par);
+
+            // Map the frequency bins onto the log axis here rather than in paint. This is a
+            // plain loop over contiguous floats so the compiler can vectorize it
+            auto &[freqAxis, magResponseDB] = data;
+            const auto nPoints = freqAxis.size();
+            const auto logMin = std::log(GRAPH_MIN_FREQ);
+            const auto logRangeInv = 1.f / std::log(GRAPH_MAX_FREQ / GRAPH_MIN_FREQ);
+
+            std::vector<float> xNorm(nPoints);
+
+            for (size_t i = 0; i < nPoints; ++i)
             {
-                int cty, csu;
-                float ccu, cre, cgn;
-                {
-                    auto lock = std::unique_lock<std::mutex>(dataLock);
-                    cty = type;
-                    csu = subtype;
-                    ccu = cutoff;
-                    cre = resonance;
-                    cgn = gain;
-                    lastIB = inboundUpdates;
-                }
+                xNorm[i] = (std::log(freqAxis[i]) - logMin) * logRangeInv;
+            }
 
-                auto par = sst::filters::FilterPlotParameters();
-                par.inputAmplitude *= cgn;
-                auto data = fp.plotFilterMagnitudeResponse(
-                    (sst::filters::FilterType)cty, (sst::filters::FilterSubType)csu, ccu, cre, par);
+            {
+                auto lock = std::unique_lock<std::mutex>(dataLock);
+                outboundUpdates++;
+                dataCopy.freq = std::move(freqAxis);
+                dataCopy.xNorm = std::move(xNorm);
+                dataCopy.db = std::move(magResponseDB);
+            }
 
-                {
-                    auto lock = std::unique_lock<std::mutex>(dataLock);
-                    outboundUpdates++;
-                    dataCopy = data;
-
-                    juce::MessageManager::getInstance()->callAsync(
-                        [safethat = juce::Component::SafePointer(an)] {
-                            if (safethat)
-                                safethat->repaint();
-                        });
-                }
+            // a drag can outrun the message thread, so keep at most one repaint queued
+            if (!repaintQueued.exchange(true))
+            {
+                juce::MessageManager::getInstance()->callAsync(
+                    [this, safethat = juce::Component::SafePointer(an)] {
+                        if (safethat)
+                        {
+                            repaintQueued = false;
+                            safethat->repaint();
+                        }
+                    });
             }
         }
     }
@@ -118,8 +139,12 @@ struct FilterAnalysisEvaluator
         cv.notify_one();
     }
 
-    std::pair<std::vector<float>, std::vector<float>> dataCopy;
+    struct Response
+    {
+        std::vector<float> freq, xNorm, db;
+    } dataCopy;
     std::atomic<uint64_t> inboundUpdates{1}, outboundUpdates{1};
+    std::atomic<bool> repaintQueued{false};
     int type{0}, subtype{0};
     float cutoff{60}, resonance{0}, gain{1.f};
     std::mutex dataLock;
@@ -257,7 +282,7 @@ void FilterAnalysis::paint(juce::Graphics &g)
     // construct filter response curve
     if (catchUpStore != evaluator->outboundUpdates)
     {
-        std::pair<std::vector<float>, std::vector<float>> data;
+        FilterAnalysisEvaluator::Response data;
         {
             auto lock = std::unique_lock(evaluator->dataLock);
             data = evaluator->dataCopy;
@@ -266,9 +291,8 @@ void FilterAnalysis::paint(juce::Graphics &g)
 
         plotPath = juce::Path();
 
-        auto [freqAxis, magResponseDBSmoothed] = data;
         bool started = false;
-        const auto nPoints = freqAxis.size();
+        const auto nPoints = data.freq.size();
 
         if (nPoints == 0)
         {
@@ -279,15 +303,17 @@ void FilterAnalysis::paint(juce::Graphics &g)
         }
         else
         {
+            plotPath.preallocateSpace(3 * (int)nPoints);
+
             for (int i = 0; i < nPoints; ++i)
             {
-                if (freqAxis[i] < GRAPH_MIN_FREQ / 2.f || freqAxis[i] > GRAPH_MAX_FREQ * 1.01f)
+                if (data.freq[i] < GRAPH_MIN_FREQ / 2.f || data.freq[i] > GRAPH_MAX_FREQ * 1.01f)
                 {
                     continue;
                 }
 
-                auto xDraw = freqToX(freqAxis[i], width);
-                auto yDraw = dbToY(magResponseDBSmoothed[i], height);
+                auto xDraw = data.xNorm[i] * (float)width;
+                auto yDraw = dbToY(data.db[i], height);
 
                 xDraw += dRect.getX();
                 yDraw += dRect.getY();
@@ -27,6 +27,8 @@
 #include "SkinColors.h"
 #include "WavetableScriptEvaluator.h"
 #include "LuaSupport.h"
+#include "RenderWorkerPool.h"
+#include "WavetableLoader.h"
 #include "widgets/MultiSwitch.h"
 #include "widgets/MenuCustomComponents.h"
 #include <fmt/core.h>
@@ -988,10 +990,47 @@ void WavetableEquationEditor::buttonClicked(juce::Button *button)
         for (int i = 1; i < resi; ++i)
             respt *= 2;
 
+        auto script = mainDocument->getAllContent().toStdString();
+
+        if (storage->wavetableLoader)
+        {
+            auto &patch = storage->getPatch();
+
+            for (int sc = 0; sc < n_scenes; ++sc)
+            {
+                for (int o = 0; o < n_oscs; ++o)
+                {
+                    if (&patch.scene[sc].osc[o] == osc)
+                    {
+                        storage->wavetableLoader->requestScriptedTable(sc, o, script, respt, nfr);
+                    }
+                }
+            }
+
+            if (!generationTimer)
+            {
+                struct GenerationTimer : juce::Timer
+                {
+                    GenerationTimer(WavetableEquationEditor *ed) : ed(ed) {}
+                    void timerCallback() override { ed->checkGenerationProgress(); }
+                    WavetableEquationEditor *ed;
+                };
+                generationTimer = std::make_unique<GenerationTimer>(this);
+            }
+
+            generationTimer->startTimerHz(30);
+            checkGenerationProgress();
+
+            return;
+        }
+
         wt_header wh;
         float *wd = nullptr;
-        Surge::WavetableScript::constructWavetable(mainDocument->getAllContent().toStdString(),
-                                                   respt, nfr, wh, &wd);
+        Surge::WavetableScript::constructWavetable(script, respt, nfr, wh, &wd);
+        Surge::Threading::RenderWorkerPool pool(
+            std::max(1, (int)std::thread::hardware_concurrency() / 2 - 1));
+        Wavetable::MipMapPoolScope mipMapScope(&pool);
+
         storage->waveTableDataMutex.lock();
         osc->wt.BuildWT(wd, wh, wh.flags & wtf_is_sample);
         osc->wavetable_display_name = "Scripted Wavetable";
@@ -1005,5 +1044,44 @@ void WavetableEquationEditor::buttonClicked(juce::Button *button)
     CodeEditorContainerWithApply::buttonClicked(button);
 }
 
+void WavetableEquationEditor::checkGenerationProgress()
+{
+    auto &patch = storage->getPatch();
+    bool running = false;
+    int done = 0, total = 0;
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        for (int o = 0; o < n_oscs; ++o)
+        {
+            if (&patch.scene[sc].osc[o] == osc && storage->wavetableLoader)
+            {
+                std::vector<float> latest;
+                running = storage->wavetableLoader->scriptedTableProgress(sc, o, done, total,
+                                                                         latest);
+
+                if (running && !latest.empty())
+                {
+                    renderer->points = std::move(latest);
+                    renderer->frameNumber = done - 1;
+                    renderer->repaint();
+                }
+            }
+        }
+    }
+
+    if (running)
+    {
+        generate->setButtonText(fmt::format("{} / {}", done, total));
+        return;
+    }
+
+    generationTimer->stopTimer();
+    generate->setButtonText("Generate");
+
+    rerenderFromUIState();
+    editor->repaintFrame();
+}
+
 } // namespace Overlays
 } // namespace Surge
@@ -153,6 +153,10 @@ class WavetableEquationEditor : public CodeEditorContainerWithApply,
 
     void buttonClicked(juce::Button *button) override;
 
+    // while the background loader generates the table, preview its frames as they arrive
+    void checkGenerationProgress();
+    std::unique_ptr<juce::Timer> generationTimer;
+
     OscillatorStorage *osc;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableEquationEditor);
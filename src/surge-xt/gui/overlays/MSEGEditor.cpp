@@ -36,6 +36,7 @@
 #include "widgets/Switch.h"
 #include "overlays/TypeinParamEditor.h"
 #include <set>
+#include <limits>
 #include "widgets/MenuCustomComponents.h"
 
 namespace Surge
@@ -1092,6 +1093,114 @@ struct MSEGCanvas : public juce::Component, public Surge::GUI::SkinConsumingComp
         }
     }
 
+    /*
+     * The curve is evaluated once per pixel column and kept between paints, so hovering only
+     * rebuilds the paths and a drag only re-evaluates the columns under the segments which
+     * actually changed. Values are kept unscaled so a vertical resize doesn't invalidate them.
+     */
+    struct CurveColumn
+    {
+        float v, vdef;
+        int seg;
+    };
+    std::vector<CurveColumn> curve;
+    std::vector<MSEGStorage::segment> curveSegmentsAsOf;
+    std::vector<float> curveStartAsOf, curveEndAsOf;
+    float curveAsOf[6] = {-1, -1, -1, -1, -1, -1};
+
+    static bool sameCurveSegment(const MSEGStorage::segment &a, const MSEGStorage::segment &b)
+    {
+        return a.duration == b.duration && a.v0 == b.v0 && a.nv1 == b.nv1 &&
+               a.cpduration == b.cpduration && a.cpv == b.cpv && a.type == b.type &&
+               a.useDeform == b.useDeform && a.invertDeform == b.invertDeform;
+    }
+
+    void updateCurve(const juce::Rectangle<int> &drawArea, const std::function<float(float)> &pxt)
+    {
+        const float asOf[6] = {(float)drawArea.getX(), (float)drawArea.getWidth(),
+                               ms->axisStart,          ms->axisWidth,
+                               lfodata->deform.val.f,  (float)ms->editMode};
+        const int n = ms->n_activeSegments;
+        const int cols = drawArea.getWidth() + 1;
+
+        bool full = !std::equal(asOf, asOf + 6, curveAsOf) || (int)curve.size() != cols ||
+                    (int)curveSegmentsAsOf.size() != n;
+        int lo = n, hi = -1;
+
+        for (int s = 0; s < n && !full; ++s)
+        {
+            // Brownian segments draw from a sequential random state, so nothing can be reused
+            if (ms->segments[s].type == MSEGStorage::segment::Type::BROWNIAN)
+                full = true;
+            else if (!sameCurveSegment(ms->segments[s], curveSegmentsAsOf[s]) ||
+                     ms->segmentStart[s] != curveStartAsOf[s] ||
+                     ms->segmentEnd[s] != curveEndAsOf[s])
+            {
+                lo = std::min(lo, s);
+                hi = s;
+            }
+        }
+
+        if (!full && hi < 0)
+            return;
+
+        // Only the time span covered by the changed segments, before or after the edit
+        float tFrom = -std::numeric_limits<float>::max();
+        float tTo = std::numeric_limits<float>::max();
+
+        if (!full)
+        {
+            if (lo > 0)
+                tFrom = std::min(ms->segmentStart[lo], curveStartAsOf[lo]);
+            if (hi < n - 1)
+                tTo = std::max(ms->segmentEnd[hi], curveEndAsOf[hi]);
+        }
+
+        std::copy(asOf, asOf + 6, curveAsOf);
+        curve.resize(cols);
+        curveSegmentsAsOf.assign(ms->segments.begin(), ms->segments.begin() + n);
+        curveStartAsOf.assign(ms->segmentStart.begin(), ms->segmentStart.begin() + n);
+        curveEndAsOf.assign(ms->segmentEnd.begin(), ms->segmentEnd.begin() + n);
+
+        Surge::MSEG::EvaluatorState es, esdf;
+        // This is different from the number in LFOMS::assign in draw mode on purpose
+        es.seed(8675309);
+        esdf.seed(8675309);
+
+        bool started = false;
+
+        for (int q = 0; q < cols; ++q)
+        {
+            float up = pxt(q + drawArea.getX());
+
+            if (up < tFrom || up > tTo)
+                continue;
+
+            if (!started && q > 0)
+            {
+                // Past the end valueAt leaves lastEval alone, so carry over the column before
+                es.lastEval = curve[q - 1].seg;
+                esdf.lastEval = curve[q - 1].seg;
+            }
+
+            started = true;
+
+            float iup = (int)up;
+            float fup = up - iup;
+            auto &col = curve[q];
+
+            col.v = Surge::MSEG::valueAt(iup, fup, 0, ms, &es, true);
+            col.vdef = Surge::MSEG::valueAt(iup, fup, lfodata->deform.val.f, ms, &esdf, true);
+            col.seg = es.lastEval;
+
+            // Brownian doesn't deform and the second display is confusing since it is
+            // independently random
+            if (col.seg >= 0 && col.seg <= n - 1 &&
+                ms->segments[col.seg].type == MSEGStorage::segment::Type::BROWNIAN)
+                col.vdef = col.v;
+        }
+    }
+
     virtual void paint(juce::Graphics &g) override
     {
         auto uni = lfodata->unipolar.val.b;
@@ -1149,10 +1258,7 @@ struct MSEGCanvas : public juce::Component, public Surge::GUI::SkinConsumingComp
             }
         }
 
-        Surge::MSEG::EvaluatorState es, esdf;
-        // This is different from the number in LFOMS::assign in draw mode on purpose
-        es.seed(8675309);
-        esdf.seed(8675309);
+        updateCurve(drawArea, pxt);
 
         auto path = juce::Path();
         auto highlightPath = juce::Path();
@@ -1186,21 +1292,12 @@ struct MSEGCanvas : public juce::Component, public Surge::GUI::SkinConsumingComp
             int i = q;
             if (!drawnLast)
             {
-                float iup = (int)up;
-
-                float fup = up - iup;
-                float v = Surge::MSEG::valueAt(iup, fup, 0, ms, &es, true);
-                float vdef = Surge::MSEG::valueAt(iup, fup, lfodata->deform.val.f, ms, &esdf, true);
-
-                v = valpx(v);
-                vdef = valpx(vdef);
-                // Brownian doesn't deform and the second display is confusing since it is
-                // independently random
-                if (es.lastEval >= 0 && es.lastEval <= ms->n_activeSegments - 1 &&
-                    ms->segments[es.lastEval].type == MSEGStorage::segment::Type::BROWNIAN)
-                    vdef = v;
+                const auto &col = curve[q];
+                float v = valpx(col.v);
+                float vdef = valpx(col.vdef);
+                int lastEval = col.seg;
 
-                int compareWith = es.lastEval;
+                int compareWith = lastEval;
                 if (up >= ms->totalDuration)
                     compareWith = ms->n_activeSegments - 1;
 
@@ -1220,14 +1317,14 @@ struct MSEGCanvas : public juce::Component, public Surge::GUI::SkinConsumingComp
                     {
                         addP(highlightPath, i, valpx(ms->segments[priorEval].nv1));
                     }
-                    priorEval = es.lastEval;
+                    priorEval = lastEval;
                 }
 
-                if (es.lastEval == hoveredSegment)
+                if (lastEval == hoveredSegment)
                 {
                     bool skipThisAdd = false;
                     // edge case when you go exactly up to 1 evenly. See #3940
-                    if (up < ms->segmentStart[es.lastEval] || up > ms->segmentEnd[es.lastEval])
+                    if (up < ms->segmentStart[lastEval] || up > ms->segmentEnd[lastEval])
                         skipThisAdd = true;
                     if (!hlpathUsed)
                     {
@@ -26,6 +26,8 @@
 #include "SurgeGUIUtils.h"
 #include "RuntimeFont.h"
 #include <sstream>
+#include <map>
+#include <tuple>
 #include "widgets/MenuCustomComponents.h"
 #include "widgets/ModulatableSlider.h"
 #include "widgets/MultiSwitch.h"
@@ -440,7 +442,8 @@ struct ModulationListContents : public juce::Component, public Surge::GUI::SkinC
                                               (modsources)datum.source_id, datum.source_scene,
                                               datum.source_index, !muted);
                     muted = !muted;
-                    contents->rebuildFrom(me->synth);
+                    contents->populateDatum(datum, me->synth);
+                    resetValuesFromDatum();
                 },
                 &c->editor->synth->storage);
             muteButton->setAccessible(true);
@@ -923,9 +926,33 @@ struct ModulationListContents : public juce::Component, public Surge::GUI::SkinC
         d.moddepth = pdisp;
     }
 
+    typedef std::tuple<int, int, int, int> rowKey_t; // target, source, source scene, index
+    static rowKey_t keyFor(const Datum &d)
+    {
+        return {d.destination_id + d.idBase, d.source_id, d.source_scene, d.source_index};
+    }
+
+    bool matches(const Datum &d, long ptag, int source, int scene, int index) const
+    {
+        return d.destination_id + d.idBase == ptag && d.source_id == source &&
+               d.source_index == index && (!d.isPerScene || d.source_scene == scene);
+    }
+
+    /*
+     * Row editors are expensive to make (a slider, three buttons and their accessibility
+     * handlers each), so a rebuild keeps the editor of every routing which survives it and
+     * only creates or deletes the ones which were added or removed.
+     */
     void rebuildFrom(SurgeSynthesizer *synth)
     {
-        removeAllChildren();
+        std::map<rowKey_t, std::unique_ptr<DataRowEditor>> priorRows;
+
+        for (auto &r : rows)
+        {
+            auto k = keyFor(r->datum);
+            priorRows[k] = std::move(r);
+        }
+
         dataRows.clear();
         rows.clear();
         int ypos = 0;
@@ -1017,10 +1044,28 @@ struct ModulationListContents : public juce::Component, public Surge::GUI::SkinC
             {
                 continue;
             }
-            auto l = std::make_unique<DataRowEditor>(d, idx++, this);
-            auto sortName = sortOrder == BY_SOURCE ? d.sname : d.pname;
+            std::unique_ptr<DataRowEditor> l;
+            auto prior = priorRows.find(keyFor(d));
+
+            if (prior != priorRows.end())
+            {
+                l = std::move(prior->second);
+                priorRows.erase(prior);
+
+                l->datum = d;
+                l->idx = idx++;
+                l->muted = d.isMuted;
+                l->firstInSort = false;
+                l->isLast = false;
+                l->resetValuesFromDatum();
+            }
+            else
+            {
+                l = std::make_unique<DataRowEditor>(d, idx++, this);
+                l->setSkin(skin, associatedBitmapStore);
+            }
 
-            l->setSkin(skin, associatedBitmapStore);
+            auto sortName = sortOrder == BY_SOURCE ? d.sname : d.pname;
 
             if (sortName != priorN)
             {
@@ -1039,6 +1084,13 @@ struct ModulationListContents : public juce::Component, public Surge::GUI::SkinC
             rows.push_back(std::move(l));
         }
 
+        for (auto &[k, r] : priorRows)
+        {
+            removeChildComponent(r.get());
+        }
+
+        priorRows.clear();
+
         // this is a bit gross but i can't think of a better way
         for (int i = 1; i < rows.size(); ++i)
         {
@@ -1105,6 +1157,24 @@ struct ModulationListContents : public juce::Component, public Surge::GUI::SkinC
         }
     }
 
+    void updateValuesFor(const std::vector<ModulationEditor::ChangedModulation> &changes,
+                         const SurgeSynthesizer *synth)
+    {
+        for (const auto &r : rows)
+        {
+            for (const auto &c : changes)
+            {
+                if (matches(r->datum, c.ptag, c.source, c.scene, c.index))
+                {
+                    populateDatum(r->datum, synth);
+                    r->muted = r->datum.isMuted;
+                    r->resetValuesFromDatum();
+                    break;
+                }
+            }
+        }
+    }
+
     void onSkinChanged() override
     {
         for (auto c : getChildren())
@@ -1735,21 +1805,32 @@ void ModulationEditor::rebuildContents()
         modContents->rebuildFrom(synth);
 }
 /*
- * At a later date I can make this more efficient but for now if any modulation changes
- * in the main UI just rebuild the table.
+ * Routings which were added or removed need the list re-sorted, but that keeps the row
+ * editors for everything else. Depth and mute changes only repopulate their own rows.
  */
 void ModulationEditor::idle()
 {
-    // fixme compare exchange week
-    if (needsModUpdate)
+    if (needsModUpdate.exchange(false))
     {
-        needsModUpdate = false;
+        {
+            auto lock = std::lock_guard<std::mutex>(changedLock);
+            changedModulations.clear();
+        }
+        needsModValueOnlyUpdate = false;
         modContents->rebuildFrom(synth);
     }
-    if (needsModValueOnlyUpdate)
+    if (needsModValueOnlyUpdate.exchange(false))
     {
-        needsModValueOnlyUpdate = false;
-        modContents->updateAllValues(synth);
+        std::vector<ChangedModulation> changes;
+        {
+            auto lock = std::lock_guard<std::mutex>(changedLock);
+            changes.swap(changedModulations);
+        }
+
+        if (changes.empty() || changes.size() > maxChangedModulations)
+            modContents->updateAllValues(synth);
+        else
+            modContents->updateValuesFor(changes, synth);
     }
 }
 
@@ -1758,6 +1839,19 @@ void ModulationEditor::updateParameterById(const SurgeSynthesizer::ID &pid)
     modContents->updateAllValues(synth);
 }
 
+void ModulationEditor::noteValueChange(long ptag, modsources modsource, int modsourceScene,
+                                       int index)
+{
+    {
+        auto lock = std::lock_guard<std::mutex>(changedLock);
+
+        // past this many it is cheaper to just refresh every row
+        if (changedModulations.size() <= maxChangedModulations)
+            changedModulations.push_back({ptag, (int)modsource, modsourceScene, index});
+    }
+    needsModValueOnlyUpdate = true;
+}
+
 void ModulationEditor::modSet(long ptag, modsources modsource, int modsourceScene, int index,
                               float value, bool isNew)
 {
@@ -1766,14 +1860,14 @@ void ModulationEditor::modSet(long ptag, modsources modsource, int modsourceScen
         if (isNew || value == 0)
             needsModUpdate = true;
         else
-            needsModValueOnlyUpdate = true;
+            noteValueChange(ptag, modsource, modsourceScene, index);
     }
 }
 void ModulationEditor::modMuted(long ptag, modsources modsource, int modsourceScene, int index,
                                 bool mute)
 {
     if (!selfModulation)
-        needsModValueOnlyUpdate = true;
+        noteValueChange(ptag, modsource, modsourceScene, index);
 }
 void ModulationEditor::modCleared(long ptag, modsources modsource, int modsourceScene, int index)
 {
@@ -28,6 +28,9 @@
 #include "SurgeSynthesizer.h"
 #include "SkinSupport.h"
 
+#include <mutex>
+#include <vector>
+
 class SurgeGUIEditor;
 
 namespace Surge
@@ -68,6 +71,17 @@ class ModulationEditor : public OverlayComponent,
                   bool mute) override;
     void modCleared(long ptag, modsources modsource, int modsourceScene, int index) override;
 
+    // Depth and mute changes from outside the editor, applied to just their rows on idle
+    struct ChangedModulation
+    {
+        long ptag;
+        int source, scene, index;
+    };
+    static constexpr size_t maxChangedModulations = 64;
+    std::mutex changedLock;
+    std::vector<ChangedModulation> changedModulations;
+    void noteValueChange(long ptag, modsources modsource, int modsourceScene, int index);
+
     std::unique_ptr<ModulationSideControls> sideControls;
     std::unique_ptr<ModulationListContents> modContents;
     std::unique_ptr<juce::Viewport> viewport;
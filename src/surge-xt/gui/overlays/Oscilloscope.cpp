@@ -89,8 +89,17 @@ const WaveformDisplay::Parameters &WaveformDisplay::getParameters() const { retu
 
 void WaveformDisplay::setParameters(Parameters parameters)
 {
-    std::lock_guard l(lock_);
     params_ = std::move(parameters);
+    publishSetup();
+}
+
+void WaveformDisplay::publishSetup()
+{
+    auto &s = setup_.back();
+    s.params = params_;
+    s.width = getWidth();
+    s.height = getHeight();
+    setup_.publish();
 }
 
 void WaveformDisplay::mouseDown(const juce::MouseEvent &event)
@@ -100,12 +109,19 @@ void WaveformDisplay::mouseDown(const juce::MouseEvent &event)
 
 void WaveformDisplay::paint(juce::Graphics &g)
 {
-    std::lock_guard l(lock_);
+    frames_.update();
+
     auto curveColor = skin->getColor(Colors::MSEGEditor::Curve);
     auto path = juce::Path();
 
-    // waveform
-    std::vector<juce::Point<float>> &points = params_.sync_draw ? copy : peaks;
+    // waveform, as the scope thread last left it (the sync copy, if sync is on)
+    const std::vector<juce::Point<float>> &points = frames_.front();
+
+    if (points.size() < 4)
+    {
+        return;
+    }
+
     float counterSpeedInverse = 1 / params_.counterSpeed();
 
     g.setColour(curveColor);
@@ -122,6 +138,13 @@ void WaveformDisplay::paint(juce::Graphics &g)
         for (std::size_t i = 1; i < getWidth() - 1; i++)
         {
             int index = static_cast<int>(phase);
+
+            // the frame can be a resize behind
+            if ((index + 1) * 2 >= points.size())
+            {
+                break;
+            }
+
             float alpha = phase - static_cast<float>(index);
             float xi = i;
             float yi = (1.0 - alpha) * points[index * 2].y + alpha * points[(index + 1) * 2].y;
@@ -202,21 +225,63 @@ void WaveformDisplay::paint(juce::Graphics &g)
 #endif
 }
 
-void WaveformDisplay::process(std::vector<float> data)
+int WaveformDisplay::wantedDecimation() const
+{
+    // Largest power of two frames which still fit in a pixel; below 4 there is nothing to save
+    auto framesPerPixel = 1.f / procParams_.counterSpeed();
+    int d = 1;
+
+    while (d * 2 <= framesPerPixel && d < 256)
+    {
+        d *= 2;
+    }
+
+    return d < 4 ? 1 : d;
+}
+
+void WaveformDisplay::process(std::vector<float> data, float framesPerValue)
 {
-    std::unique_lock l(lock_);
-    if (params_.freeze)
+    if (setup_.update())
+    {
+        auto &s = setup_.front();
+        procParams_ = s.params;
+
+        if (s.width != procWidth_ || s.height != procHeight_)
+        {
+            procWidth_ = s.width;
+            procHeight_ = s.height;
+
+            peaks.clear();
+            copy.clear();
+
+            for (int j = 0; j < procWidth_; ++j)
+            {
+                juce::Point<float> point;
+                point.x = j;
+                point.y = juce::jmap<float>(0, -1, 1, procHeight_, 0);
+                peaks.push_back(point);
+                peaks.push_back(point);
+                copy.push_back(point);
+                copy.push_back(point);
+            }
+
+            index = 0;
+        }
+    }
+
+    if (procParams_.freeze || procWidth_ <= 0)
     {
         return;
     }
 
-    float gain = params_.gain();
-    float triggerLevel = params_.triggerLevel();
-    int triggerLimit =
-        static_cast<int>(std::pow(10.f, params_.trigger_limit * 4.f)); // 0=>1, 1=>10000
-    float triggerSpeed = std::pow(10.f, 2.5f * params_.trigger_speed - 5.f);
-    float counterSpeed = params_.counterSpeed();
-    float R = 1.f - 250.f / static_cast<float>(storage_->samplerate);
+    // A decimated value stands for several frames, so everything counted in frames scales
+    float gain = procParams_.gain();
+    float triggerLevel = procParams_.triggerLevel();
+    int triggerLimit = static_cast<int>(std::pow(10.f, procParams_.trigger_limit * 4.f) /
+                                        framesPerValue); // 0=>1, 1=>10000
+    float triggerSpeed = std::pow(10.f, 2.5f * procParams_.trigger_speed - 5.f) * framesPerValue;
+    float counterSpeed = procParams_.counterSpeed() * framesPerValue;
+    float R = 1.f - 250.f * framesPerValue / static_cast<float>(storage_->samplerate);
 
     for (float &f : data)
     {
@@ -230,12 +295,12 @@ void WaveformDisplay::process(std::vector<float> data)
         }
 
         // Gain
-        float sample = params_.dc_kill ? static_cast<float>(dcKill) : f;
+        float sample = procParams_.dc_kill ? static_cast<float>(dcKill) : f;
         sample = juce::jlimit(-1.f, 1.f, sample * gain);
 
         // Triggers
         bool trigger = false;
-        switch (params_.trigger_type)
+        switch (procParams_.trigger_type)
         {
         case kTriggerInternal:
             // internal oscillator, nothing fancy
@@ -264,7 +329,7 @@ void WaveformDisplay::process(std::vector<float> data)
             break;
         case kTriggerFree:
             // trigger when we've run out of the screen area
-            if (index >= getWidth())
+            if (index >= procWidth_)
             {
                 trigger = true;
             }
@@ -277,8 +342,9 @@ void WaveformDisplay::process(std::vector<float> data)
 
         // if there's a retrigger, but too fast, kill it
         triggerLimitPhase++;
-        if (trigger && triggerLimitPhase < triggerLimit && params_.trigger_type != kTriggerFree &&
-            params_.trigger_type != kTriggerInternal)
+        if (trigger && triggerLimitPhase < triggerLimit &&
+            procParams_.trigger_type != kTriggerFree &&
+            procParams_.trigger_type != kTriggerInternal)
         {
             trigger = false;
         }
@@ -289,13 +355,13 @@ void WaveformDisplay::process(std::vector<float> data)
             std::size_t j;
 
             // zero peaks after the last one
-            for (j = index * 2; j < getWidth() * 2; j += 2)
+            for (j = index * 2; j < procWidth_ * 2; j += 2)
             {
-                peaks[j].y = peaks[j + 1].y = juce::jmap<float>(0, -1, 1, getHeight(), 0);
+                peaks[j].y = peaks[j + 1].y = juce::jmap<float>(0, -1, 1, procHeight_, 0);
             }
 
             // copy to a buffer for sync drawing
-            for (j = 0; j < getWidth() * 2; j++)
+            for (j = 0; j < procWidth_ * 2; j++)
             {
                 copy[j].y = peaks[j].y;
             }
@@ -334,11 +400,11 @@ void WaveformDisplay::process(std::vector<float> data)
         // instead we squash the data down here with maxes/mins per pixel.
         if (counter >= 1.0)
         {
-            if (index < getWidth())
+            if (index < procWidth_)
             {
                 // Perform scaling here so we don't have to redo it over and over in painting.
-                float max_Y = juce::jmap<float>(max, -1, 1, getHeight(), 0);
-                float min_Y = juce::jmap<float>(min, -1, 1, getHeight(), 0);
+                float max_Y = juce::jmap<float>(max, -1, 1, procHeight_, 0);
+                float min_Y = juce::jmap<float>(min, -1, 1, procHeight_, 0);
 
                 // thanks to David @ Plogue for this interesting hint!
                 peaks[(index << 1)].y = lastIsMax ? min_Y : max_Y;
@@ -355,27 +421,13 @@ void WaveformDisplay::process(std::vector<float> data)
         // store for edge-triggers
         previousSample = sample;
     }
-}
-
-void WaveformDisplay::resized()
-{
-    std::lock_guard l(lock_);
-
-    peaks.clear();
-    copy.clear();
 
-    for (std::size_t j = 0; j < getWidth() * 2; j += 2)
-    {
-        juce::Point<float> point;
-        point.x = j / 2;
-        point.y = juce::jmap<float>(0, -1, 1, getHeight(), 0);
-        peaks.push_back(point);
-        peaks.push_back(point);
-        copy.push_back(point);
-        copy.push_back(point);
-    }
+    frames_.back() = procParams_.sync_draw ? copy : peaks;
+    frames_.publish();
 }
 
+void WaveformDisplay::resized() { publishSetup(); }
+
 SpectrumDisplay::SpectrumDisplay(SurgeGUIEditor *e, SurgeStorage *s)
     : editor_(e), storage_(s), last_updated_time_(std::chrono::steady_clock::now())
 {
@@ -387,12 +439,14 @@ const SpectrumDisplay::Parameters &SpectrumDisplay::getParameters() const { retu
 
 void SpectrumDisplay::setParameters(Parameters parameters)
 {
-    std::lock_guard l(data_lock_);
     // Check if the new params for noise floor/ceiling are different. If they are, consider the
     // display "dirty" (ie, stop interpolating distance, jump right to the new thing).
     bool changedVisible =
         (params_.dbRange() != parameters.dbRange()) || (params_.freeze != parameters.freeze);
     params_ = std::move(parameters);
+    params_in_.back() = params_;
+    params_in_.publish();
+
     if (changedVisible)
     {
         display_dirty_ = true;
@@ -402,7 +456,15 @@ void SpectrumDisplay::setParameters(Parameters parameters)
 
 void SpectrumDisplay::paint(juce::Graphics &g)
 {
-    std::lock_guard l(data_lock_);
+    if (spectra_.update())
+    {
+        last_updated_time_ = std::chrono::steady_clock::now();
+
+        if (!params_.freeze)
+        {
+            recalculateScopeData();
+        }
+    }
 
     if (params_.dbRange() == 0.0f)
         return;
@@ -426,6 +488,38 @@ void SpectrumDisplay::paint(juce::Graphics &g)
     {
         mtbs_ = std::chrono::duration<float>(1.f / binHz);
 
+        // Most bins share a pixel column with others at the top of a log axis, so the path only
+        // gets the highest point of each column
+        int column = std::numeric_limits<int>::min();
+        float columnX = 0.f, columnY = zeroPoint;
+
+        auto addColumn = [&]() {
+            if (column == std::numeric_limits<int>::min())
+            {
+                return;
+            }
+
+            if (columnY >= zeroPoint)
+            {
+                path.lineTo(columnX, zeroPoint);
+                path.closeSubPath();
+                started = false;
+            }
+            else
+            {
+                if (started)
+                {
+                    path.lineTo(columnX, columnY);
+                }
+                else
+                {
+                    path.startNewSubPath(columnX, zeroPoint);
+                    path.lineTo(columnX, columnY);
+                    started = true;
+                }
+            }
+        };
+
         for (int i = 0; i < internal::fftSize / 2; i++)
         {
             const float hz = binHz * static_cast<float>(i);
@@ -442,26 +536,20 @@ void SpectrumDisplay::paint(juce::Graphics &g)
 
             displayed_data_[i] = y;
 
-            if (y >= zeroPoint)
+            if (static_cast<int>(x) != column)
             {
-                path.lineTo(x, zeroPoint);
-                path.closeSubPath();
-                started = false;
+                addColumn();
+                column = static_cast<int>(x);
+                columnX = x;
+                columnY = y;
             }
             else
             {
-                if (started)
-                {
-                    path.lineTo(x, y);
-                }
-                else
-                {
-                    path.startNewSubPath(x, zeroPoint);
-                    path.lineTo(x, y);
-                    started = true;
-                }
+                columnY = std::min(columnY, y);
             }
         }
+
+        addColumn();
     }
     // End path.
 
@@ -479,15 +567,13 @@ void SpectrumDisplay::paint(juce::Graphics &g)
 
 void SpectrumDisplay::recalculateScopeData()
 {
-    // data_lock_ *must* be held by the caller.
     const float dbMin = params_.noiseFloor();
     const float dbMax = params_.maxDb();
     const float offset = juce::Decibels::gainToDecibels((float)internal::fftSize);
-    std::transform(incoming_scope_data_.begin(), incoming_scope_data_.end(),
-                   new_scope_data_.begin(), [=](const float f) {
-                       return juce::jlimit(dbMin, dbMax,
-                                           juce::Decibels::gainToDecibels(f) - offset);
-                   });
+    const auto &incoming = spectra_.front();
+    std::transform(incoming.begin(), incoming.end(), new_scope_data_.begin(), [=](const float f) {
+        return juce::jlimit(dbMin, dbMax, juce::Decibels::gainToDecibels(f) - offset);
+    });
 }
 
 void SpectrumDisplay::resized()
@@ -505,20 +591,19 @@ void SpectrumDisplay::updateScopeData(internal::FftScopeType::iterator begin,
                                       internal::FftScopeType::iterator end)
 {
     // Data comes in as gain.
-    std::lock_guard l(data_lock_);
+    if (params_in_.update())
+    {
+        procParams_ = params_in_.front();
+    }
 
     // Decay existing data, and move new data in if it's larger.
-    const float decay = 1.f - sqrt(params_.decay_rate);
+    const float decay = 1.f - sqrt(procParams_.decay_rate);
 
     std::transform(begin, end, incoming_scope_data_.begin(), incoming_scope_data_.begin(),
                    [decay](const float fn, const float f) { return std::max(f * decay, fn); });
 
-    last_updated_time_ = std::chrono::steady_clock::now();
-
-    if (!params_.freeze)
-    {
-        recalculateScopeData();
-    }
+    spectra_.back() = incoming_scope_data_;
+    spectra_.publish();
 }
 
 float SpectrumDisplay::interpolate(const float y0, const float y1,
@@ -534,8 +619,7 @@ float SpectrumDisplay::interpolate(const float y0, const float y1,
 Oscilloscope::Oscilloscope(SurgeGUIEditor *e, SurgeStorage *s)
     : editor_(e), storage_(s), forward_fft_(internal::fftOrder),
       window_(internal::fftSize, juce::dsp::WindowingFunction<float>::hann), pos_(0),
-      complete_(false), fft_thread_(std::bind(std::mem_fn(&Oscilloscope::pullData), this)),
-      channel_selection_(STEREO), scope_mode_(SPECTRUM), left_chan_button_("L"),
+      complete_(false), channel_selection_(STEREO), scope_mode_(SPECTRUM), left_chan_button_("L"),
       right_chan_button_("R"), scope_mode_button_(*this), background_(s), spectrum_(e, s),
       spectrum_parameters_(e, s, this), waveform_(e, s), waveform_parameters_(e, s, this)
 {
@@ -593,6 +677,9 @@ Oscilloscope::Oscilloscope(SurgeGUIEditor *e, SurgeStorage *s)
     changeScopeType(static_cast<ScopeMode>(mode));
 
     storage_->audioOut.subscribe();
+
+    // Started last, so the displays it feeds are all there
+    fft_thread_ = std::thread(std::bind(std::mem_fn(&Oscilloscope::pullData), this));
 }
 
 Oscilloscope::~Oscilloscope()
@@ -608,6 +695,7 @@ Oscilloscope::~Oscilloscope()
     fft_thread_.join();
     // Data thread can perform subscriptions, so do a final unsubscribe after it's done.
     storage_->audioOut.unsubscribe();
+    storage_->audioOutTap.decimation.store(1);
 }
 
 void Oscilloscope::onSkinChanged()
@@ -1201,7 +1289,6 @@ void Oscilloscope::SpectrumParameters::resized()
 
 void Oscilloscope::updateDrawing()
 {
-    std::lock_guard l(data_lock_);
     if (channel_selection_ != OFF)
     {
         if (scope_mode_ == WAVEFORM)
@@ -1245,7 +1332,7 @@ void Oscilloscope::visibilityChanged()
 
 bool Oscilloscope::wantsInitialKeyboardFocus() { return false; }
 
-// Lock for member variables must be held by the caller.
+// Scope thread only.
 void Oscilloscope::calculateSpectrumData()
 {
     window_.multiplyWithWindowingTable(fft_data_.data(), internal::fftSize);
@@ -1268,7 +1355,6 @@ void Oscilloscope::calculateSpectrumData()
 
 void Oscilloscope::changeScopeType(ScopeMode type)
 {
-    std::unique_lock l(data_lock_);
     bool skipUpdate = false;
 
     switch (type)
@@ -1278,7 +1364,6 @@ void Oscilloscope::changeScopeType(ScopeMode type)
         scope_mode_ = WAVEFORM;
         spectrum_.setVisible(false);
         spectrum_parameters_.setVisible(false);
-        std::fill(scope_data_.begin(), scope_data_.end(), 0.f);
         waveform_.setVisible(true);
         waveform_parameters_.setVisible(true);
 
@@ -1289,7 +1374,6 @@ void Oscilloscope::changeScopeType(ScopeMode type)
         scope_mode_ = SPECTRUM;
         waveform_.setVisible(false);
         waveform_parameters_.setVisible(false);
-        std::fill(scope_data_.begin(), scope_data_.end(), 0.f);
         spectrum_.setVisible(true);
         spectrum_parameters_.setVisible(true);
 
@@ -1302,10 +1386,10 @@ void Oscilloscope::changeScopeType(ScopeMode type)
 
     if (!skipUpdate)
     {
-        background_.updateBackgroundType(scope_mode_);
+        background_.updateBackgroundType(type);
         // Save the scope mode to the DAW state.
         storage_->getPatch().dawExtraState.editor.oscilloscopeOverlayState.mode =
-            static_cast<int>(scope_mode_);
+            static_cast<int>(type);
     }
 }
 
@@ -1322,13 +1406,15 @@ juce::Rectangle<int> Oscilloscope::getScopeRect()
 
 void Oscilloscope::pullData()
 {
+    int decimation = 1;
+
     while (!complete_.load(std::memory_order_seq_cst))
     {
-        std::unique_lock l(data_lock_);
         if (channel_selection_ == OFF)
         {
             // We want to unsubscribe and sleep if we aren't going to be looking at the data, to
             // prevent useless accumulation and CPU usage.
+            std::unique_lock l(data_lock_);
             storage_->audioOut.unsubscribe();
             channels_off_.wait(l, [this]() {
                 return channel_selection_ != OFF || complete_.load(std::memory_order_seq_cst);
@@ -1337,6 +1423,19 @@ void Oscilloscope::pullData()
             continue;
         }
         ChannelSelect cs = channel_selection_;
+        ScopeMode mode = scope_mode_;
+
+        // The spectrum needs every sample; the waveform only the peaks of each pixel
+        int want = mode == WAVEFORM ? waveform_.wantedDecimation() : 1;
+
+        if (want != decimation)
+        {
+            // Whatever is queued was folded the old way, so let it go
+            decimation = want;
+            storage_->audioOutTap.decimation.store(decimation);
+            storage_->audioOut.popall();
+            continue;
+        }
 
         std::pair<std::vector<float>, std::vector<float>> data = storage_->audioOut.popall();
         std::vector<float> &dataL = data.first;
@@ -1345,8 +1444,6 @@ void Oscilloscope::pullData()
         {
             // Sleep for long enough to accumulate about 4096 samples, or half that in waveform
             // mode.
-            ScopeMode mode = scope_mode_;
-            l.unlock();
             std::this_thread::sleep_for(std::chrono::duration<float, std::chrono::seconds::period>(
                 internal::fftSize / (mode == SPECTRUM ? 2.f : 4.f) / storage_->samplerate));
             continue;
@@ -1363,9 +1460,9 @@ void Oscilloscope::pullData()
             dataL = dataR;
         }
 
-        if (scope_mode_ == WAVEFORM)
+        if (mode == WAVEFORM)
         {
-            waveform_.process(std::move(dataL));
+            waveform_.process(std::move(dataL), ScopeTap::framesPerValue(decimation));
         }
         else
         {
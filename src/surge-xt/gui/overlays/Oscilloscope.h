@@ -35,6 +35,7 @@
 #include "SurgeGUICallbackInterfaces.h"
 #include "SurgeGUIEditor.h"
 #include "SurgeStorage.h"
+#include "ScopeTap.h"
 #include "widgets/ModulatableSlider.h"
 #include "widgets/MultiSwitch.h"
 
@@ -102,21 +103,39 @@ class WaveformDisplay : public juce::Component, public Surge::GUI::SkinConsuming
     void mouseDown(const juce::MouseEvent &event) override;
     void paint(juce::Graphics &g) override;
     void resized() override;
-    void process(std::vector<float> data);
+
+    // Called from the scope thread only. Each value in data stands for framesPerValue frames.
+    void process(std::vector<float> data, float framesPerValue = 1.f);
+
+    // The audio tap decimation this display can use without losing a peak; scope thread only.
+    int wantedDecimation() const;
 
   private:
+    // The display size and parameters, handed from the message thread to the scope thread
+    struct Setup
+    {
+        Parameters params;
+        int width{0}, height{0};
+    };
+    void publishSetup();
+
     SurgeGUIEditor *editor_;
     SurgeStorage *storage_;
-    Parameters params_;
+    Parameters params_; // the message thread's copy
 
-    // Global lock for the class.
-    std::mutex lock_;
+    // Nothing is shared between the threads but these two; neither side ever waits.
+    TripleBuffer<Setup> setup_;
+    TripleBuffer<std::vector<juce::Point<float>>> frames_;
+
+    // Everything from here down belongs to the scope thread.
+    Parameters procParams_;
+    int procWidth_{0}, procHeight_{0};
 
     std::vector<juce::Point<float>> peaks;
     std::vector<juce::Point<float>> copy; // Copy of peaks, for sync drawing.
 
     // Index into the peak-array.
-    std::size_t index;
+    std::size_t index{0};
 
     // counter which is used to set the amount of samples/pixel.
     float counter;
@@ -128,16 +147,16 @@ class WaveformDisplay : public juce::Component, public Surge::GUI::SkinConsuming
     bool lastIsMax;
 
     // the previous sample (for edge-triggers)
-    float previousSample;
+    float previousSample{0};
 
     // the internal trigger oscillator
-    float triggerPhase;
+    float triggerPhase{0};
 
     // trigger limiter
-    int triggerLimitPhase;
+    int triggerLimitPhase{0};
 
     // DC killer.
-    float dcKill, dcFilterTemp;
+    float dcKill{0}, dcFilterTemp{0};
 
     // Point that marks where a click happened.
     juce::Point<int> clickPoint;
@@ -177,27 +196,32 @@ class SpectrumDisplay : public juce::Component, public Surge::GUI::SkinConsuming
 
     void paint(juce::Graphics &g) override;
     void resized() override;
+
+    // Called from the scope thread only.
     void updateScopeData(internal::FftScopeType::iterator begin,
                          internal::FftScopeType::iterator end);
 
   private:
     float interpolate(const float y0, const float y1,
                       std::chrono::time_point<std::chrono::steady_clock> t) const;
-    // data_lock_ *must* be held by the caller.
     void recalculateScopeData();
 
     SurgeGUIEditor *editor_;
     SurgeStorage *storage_;
-    Parameters params_;
+    Parameters params_; // the message thread's copy
     std::chrono::duration<float> mtbs_;
     std::chrono::time_point<std::chrono::steady_clock> last_updated_time_;
-    std::mutex data_lock_;
     internal::FftScopeType new_scope_data_;
     internal::FftScopeType displayed_data_;
-    // Why a third array? We calculate into the other two, and if the parameters
-    // change we have to update our calculations from the beginning.
+    bool display_dirty_{true};
+
+    // Parameters go to the scope thread and decayed spectra come back, without either waiting.
+    TripleBuffer<Parameters> params_in_;
+    TripleBuffer<internal::FftScopeType> spectra_;
+
+    // The scope thread's accumulation, with decay applied
+    Parameters procParams_;
     internal::FftScopeType incoming_scope_data_;
-    bool display_dirty_;
 };
 
 class Oscilloscope : public OverlayComponent,
@@ -401,9 +425,9 @@ class Oscilloscope : public OverlayComponent,
     std::array<float, 2 * internal::fftSize> fft_data_;
     int pos_;
     internal::FftScopeType scope_data_;
-    ChannelSelect channel_selection_;
-    ScopeMode scope_mode_;
-    // Global lock for all data members accessed concurrently.
+    std::atomic<ChannelSelect> channel_selection_;
+    std::atomic<ScopeMode> scope_mode_;
+    // Only held to sleep the scope thread while every channel is off.
     std::mutex data_lock_;
 
     // Members for the data-pulling thread.
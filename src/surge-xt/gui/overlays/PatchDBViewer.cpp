@@ -335,7 +335,21 @@ class PatchDBSQLTableModel : public juce::TableListBoxModel
         editor->closeOverlay(SurgeGUIEditor::PATCH_BROWSER);
     }
 
-    void executeQuery(const std::string &n) { data = storage->patchDB->rawQueryForNameLike(n); }
+    // Pages arrive as the reader thread produces them; the first of a new query replaces the rows
+    void receivePage(uint64_t generation,
+                     std::vector<Surge::PatchStorage::PatchDB::patchRecord> &page)
+    {
+        if (generation != dataGeneration)
+        {
+            data.clear();
+            dataGeneration = generation;
+        }
+
+        data.insert(data.end(), std::make_move_iterator(page.begin()),
+                    std::make_move_iterator(page.end()));
+    }
+
+    uint64_t dataGeneration{0};
 
     std::vector<Surge::PatchStorage::PatchDB::patchRecord> data;
     SurgeStorage *storage;
@@ -455,8 +469,24 @@ void PatchDBViewer::checkJobsOverlay()
 }
 void PatchDBViewer::executeQuery()
 {
-    tableModel->executeQuery(nameTypein->getText().toStdString());
-    table->updateContent();
+    using records_t = std::vector<Surge::PatchStorage::PatchDB::patchRecord>;
+
+    auto gen = ++queryGeneration;
+    auto that = juce::Component::SafePointer<PatchDBViewer>(this);
+
+    storage->patchDB->queryForNameLikeAsync(
+        nameTypein->getText().toStdString(), queryPageSize,
+        [that, gen](records_t &&page, bool last) {
+            auto p = std::make_shared<records_t>(std::move(page));
+
+            juce::MessageManager::callAsync([that, gen, p]() {
+                if (!that || that->queryGeneration != gen)
+                    return;
+
+                that->tableModel->receivePage(gen, *p);
+                that->table->updateContent();
+            });
+        });
 }
 void PatchDBViewer::textEditorTextChanged(juce::TextEditor &editor) { executeQuery(); }
 
@@ -46,9 +46,13 @@ class PatchDBViewer : public OverlayComponent,
     PatchDBViewer(SurgeGUIEditor *ed, SurgeStorage *s);
     ~PatchDBViewer();
     void createElements();
+    // Runs on the patch database's reader thread and fills the table a page at a time
     void executeQuery();
     void checkJobsOverlay();
 
+    static constexpr size_t queryPageSize{256};
+    uint64_t queryGeneration{0};
+
     void paint(juce::Graphics &g) override;
 
     void resized() override;
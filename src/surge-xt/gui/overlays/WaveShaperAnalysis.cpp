@@ -186,11 +186,31 @@ void WaveShaperAnalysis::recalcFromSlider()
     auto pfg = powf(2.f, getPFG() / 18.f);
     auto d1 = _mm_set1_ps(amp);
 
-    for (int i = 0; i < npts; i++)
+    /*
+     * The shaper works on four independent lanes, so rather than running the curve through
+     * lane 0 alone, each lane takes a contiguous quarter of it. Lanes past the first start a
+     * few points early, so the stateful shapers have seen the same recent input at the seam
+     * as a single pass would; those lead-in outputs are discarded. Lane 0 runs a little past
+     * its quarter instead, so every lane does the same number of steps.
+     */
+    static constexpr int lanes = 4, quarter = npts / lanes, leadIn = 4;
+    static_assert(npts % lanes == 0);
+
+    float xs alignas(16)[lanes], ins alignas(16)[lanes], outs alignas(16)[lanes];
+
+    sliderDrivenCurve.resize(npts);
+
+    for (int j = 0; j < quarter + leadIn; ++j)
     {
-        float x = i * dx;
-        float inval = pfg * std::sin(x * 4.0 * M_PI);
-        auto ivs = _mm_set1_ps(inval);
+        for (int l = 0; l < lanes; ++l)
+        {
+            int idx = l * quarter + j - (l > 0 ? leadIn : 0);
+
+            xs[l] = idx * dx;
+            ins[l] = pfg * std::sin(xs[l] * 4.0 * M_PI);
+        }
+
+        auto ivs = _mm_load_ps(ins);
         auto ov1 = ivs;
 
         if (wsop)
@@ -198,10 +218,17 @@ void WaveShaperAnalysis::recalcFromSlider()
             ov1 = wsop(&wss, ivs, d1);
         }
 
-        float r alignas(16)[8];
-        _mm_store_ps(r, ov1);
+        _mm_store_ps(outs, ov1);
+
+        for (int l = 0; l < lanes; ++l)
+        {
+            int k = j - (l > 0 ? leadIn : 0);
 
-        sliderDrivenCurve.emplace_back(x, inval, r[0]);
+            if (k >= 0 && k < quarter)
+            {
+                sliderDrivenCurve[l * quarter + k] = {xs[l], ins[l], outs[l]};
+            }
+        }
     }
 }
 
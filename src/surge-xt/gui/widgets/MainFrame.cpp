@@ -39,12 +39,16 @@ MainFrame::MainFrame()
     setAccessible(true);
     setDescription("Surge XT");
     setTitle("Main Frame");
+
+    backgroundLayer = std::make_unique<BackgroundLayer>(this);
+    addAndMakeVisible(*backgroundLayer);
+    backgroundLayer->toBack();
 }
 
-void MainFrame::paint(juce::Graphics &g)
+void MainFrame::BackgroundLayer::paint(juce::Graphics &g)
 {
-    if (bg)
-        bg->draw(g, 1.0);
+    if (frame->bg)
+        frame->bg->draw(g, 1.0);
 
 #if BUILD_IS_DEBUG
     auto r = getLocalBounds().withTrimmedLeft(getWidth() - 150).withTrimmedTop(getHeight() - 45);
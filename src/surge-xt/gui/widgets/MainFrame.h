@@ -44,10 +44,31 @@ struct MainFrame : public juce::Component
     void setBackground(SurgeImage *d)
     {
         bg = d;
+        backgroundLayer->repaint();
         repaint();
     }
 
-    void paint(juce::Graphics &g) override;
+    /*
+     * The skin background lives in its own child at the back of the z-order, buffered to an
+     * image. A slider or meter repainting over it then blits the cached pixels rather than
+     * rendering the whole background SVG again. JUCE rebuilds the buffer when the scale the
+     * layer is drawn at changes, so zoom changes need nothing more than the repaint above.
+     */
+    struct BackgroundLayer : public juce::Component
+    {
+        BackgroundLayer(MainFrame *f) : frame(f)
+        {
+            setInterceptsMouseClicks(false, false);
+            setWantsKeyboardFocus(false);
+            setAccessible(false);
+            setBufferedToImage(true);
+        }
+
+        void paint(juce::Graphics &g) override;
+        MainFrame *frame{nullptr};
+    };
+    std::unique_ptr<BackgroundLayer> backgroundLayer;
+
     bool debugFocus{false};
     juce::Rectangle<int> focusRectangle;
     void paintOverChildren(juce::Graphics &g) override
@@ -68,6 +89,7 @@ struct MainFrame : public juce::Component
 
     void resized() override
     {
+        backgroundLayer->setBounds(getLocalBounds());
         for (auto &c : cgOverlays)
             if (c)
                 c->setBounds(getLocalBounds());
@@ -186,12 +186,10 @@ void ModulatableSlider::paint(juce::Graphics &g)
     // Draw the tray
     {
         juce::Graphics::ScopedSaveState gs(g);
-        auto t = juce::AffineTransform();
-        t = t.translated(-trayTypeX * trayw, -trayTypeY * trayh);
 
         g.addTransform(trayPosition);
-        g.reduceClipRegion(0, 0, trayw, trayh);
-        pTray->draw(g, activationOpacity, t);
+        pTray->drawRegionCached(g, {trayTypeX * trayw, trayTypeY * trayh, trayw, trayh},
+                                activationOpacity);
     }
 
     // Draw the modulation bar
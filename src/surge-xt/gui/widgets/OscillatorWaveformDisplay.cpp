@@ -162,13 +162,6 @@ void OscillatorWaveformDisplay::paint(juce::Graphics &g)
 
     if (!skipEntireOscillator)
     {
-        auto osc = setupOscillator();
-
-        if (!osc)
-        {
-            return;
-        }
-
         int totalSamples = (1 << 4) * (int)getWidth();
         int averagingWindow = 4; // < and Mult of BlockSizeOS
         float disp_pitch_rs = disp_pitch + 12.0 * log2(storage->dsamplerate / 44100.0);
@@ -202,55 +195,78 @@ void OscillatorWaveformDisplay::paint(juce::Graphics &g)
             // That's a strange non-monotonic tuning. Oh well.
         }
 
-        bool use_display = osc->allow_display();
+        auto key = currentPreviewKey(disp_pitch_rs);
 
-        if (use_display)
+        if (!previewValid || !(key == previewKey))
         {
-            osc->init(disp_pitch_rs, true, true);
-        }
+            auto osc = setupOscillator();
 
-        int block_pos = BLOCK_SIZE_OS;
-        juce::Path wavePath;
-
-        for (int i = 0; i < totalSamples; i += averagingWindow)
-        {
-            if (use_display && block_pos >= BLOCK_SIZE_OS)
+            if (!osc)
             {
-                // Lock it even if we aren't wavetable. It's fine.
-                storage->waveTableDataMutex.lock();
-                osc->process_block(disp_pitch_rs);
-                block_pos = 0;
-                storage->waveTableDataMutex.unlock();
+                return;
             }
 
-            float val = 0.f;
+            previewValues.clear();
+
+            bool use_display = osc->allow_display();
 
             if (use_display)
             {
-                for (int j = 0; j < averagingWindow; ++j)
+                osc->init(disp_pitch_rs, true, true);
+            }
+
+            int block_pos = BLOCK_SIZE_OS;
+
+            for (int i = 0; i < totalSamples; i += averagingWindow)
+            {
+                if (use_display && block_pos >= BLOCK_SIZE_OS)
                 {
-                    val += osc->output[block_pos];
-                    block_pos++;
+                    // Lock it even if we aren't wavetable. It's fine.
+                    storage->waveTableDataMutex.lock();
+                    osc->process_block(disp_pitch_rs);
+                    block_pos = 0;
+                    storage->waveTableDataMutex.unlock();
                 }
 
-                val = val / averagingWindow;
+                float val = 0.f;
+
+                if (use_display)
+                {
+                    for (int j = 0; j < averagingWindow; ++j)
+                    {
+                        val += osc->output[block_pos];
+                        block_pos++;
+                    }
+
+                    val = val / averagingWindow;
+                }
+
+                previewValues.push_back(val);
             }
 
-            float xc = 1.f * i / totalSamples;
+            osc->~Oscillator();
+            osc = nullptr;
+
+            previewKey = key;
+            previewValid = true;
+        }
 
-            if (i == 0)
+        juce::Path wavePath;
+
+        for (int k = 0; k < (int)previewValues.size(); ++k)
+        {
+            float xc = 1.f * k * averagingWindow / totalSamples;
+
+            if (k == 0)
             {
-                wavePath.startNewSubPath(xc, val);
+                wavePath.startNewSubPath(xc, previewValues[k]);
             }
             else
             {
-                wavePath.lineTo(xc, val);
+                wavePath.lineTo(xc, previewValues[k]);
             }
         }
 
-        osc->~Oscillator();
-        osc = nullptr;
-
         auto yMargin = 2 * usesWT;
         auto h = getHeight() - usesWT * wtbheight - 2 * yMargin;
         auto xMargin = 2;
@@ -530,6 +546,38 @@ void OscillatorWaveformDisplay::repaintBasedOnOscMuteState()
     }
 }
 
+OscillatorWaveformDisplay::PreviewKey
+OscillatorWaveformDisplay::currentPreviewKey(float displayPitch) const
+{
+    PreviewKey k;
+
+    k.type = oscdata->type.val.i;
+    k.retrigger = oscdata->retrigger.val.b;
+    k.character = storage->getPatch().character.val.i;
+    k.width = getWidth();
+    k.pitch = displayPitch;
+    k.samplerate = storage->dsamplerate;
+    k.standardTuning = storage->isStandardTuning;
+    k.tuningMode = (int)storage->tuningApplicationMode;
+    k.pitchToFreq = storage->note_to_pitch(displayPitch);
+    k.wtRevision = oscdata->wt.dataRevision;
+
+    for (int i = 0; i < n_osc_params; i++)
+    {
+        auto &p = oscdata->p[i];
+
+        k.vals[i] = p.val.i;
+        k.deform[i] = p.deform_type;
+        k.flags[i] = (p.extend_range ? 1 : 0) | (p.absolute ? 2 : 0) | (p.deactivated ? 4 : 0);
+    }
+
+    k.nExtraConfig = oscdata->extraConfig.nData;
+    std::copy(std::begin(oscdata->extraConfig.data), std::end(oscdata->extraConfig.data),
+              k.extraConfig.begin());
+
+    return k;
+}
+
 ::Oscillator *OscillatorWaveformDisplay::setupOscillator()
 {
     tp[oscdata->pitch.param_id_in_scene].f = 0;
@@ -87,6 +87,30 @@ struct OscillatorWaveformDisplay : public juce::Component,
     void resized() override;
 
     pdata tp[n_scene_params];
+
+    /*
+     * Drawing the waveform means running a whole oscillator for a few thousand samples, but
+     * paint gets called for plenty of reasons which have nothing to do with the oscillator
+     * (hovers, the jog buttons, the wavetable name). So we keep the last rendering and only
+     * run the oscillator again when something it depends on has changed.
+     */
+    struct PreviewKey
+    {
+        int type{-1}, character{-1}, width{-1}, tuningMode{-1};
+        bool retrigger{false}, standardTuning{true};
+        float pitch{0.f}, samplerate{0.f}, pitchToFreq{0.f};
+        uint32_t wtRevision{0};
+        std::array<int, n_osc_params> vals{}, deform{};
+        std::array<int, n_osc_params> flags{};
+        int nExtraConfig{0};
+        std::array<float, OscillatorStorage::ExtraConfigurationData::max_config> extraConfig{};
+
+        bool operator==(const PreviewKey &) const = default;
+    };
+    PreviewKey currentPreviewKey(float displayPitch) const;
+    PreviewKey previewKey;
+    std::vector<float> previewValues;
+    bool previewValid{false};
     juce::Rectangle<float> leftJog, rightJog, waveTableName;
 
     void mouseDown(const juce::MouseEvent &event) override;
@@ -986,7 +986,7 @@ bool PatchSelector::populatePatchMenuForCategory(int c, juce::PopupMenu &context
                                                  bool single_category, int &main_e, bool rootCall)
 {
     bool amIChecked = false;
-    PatchCategory cat = storage->patch_category[c];
+    const auto &cat = storage->patch_category[c];
 
     // stop it going in the top menu which is a straight iteration
     if (rootCall && !cat.isRoot)
@@ -1002,17 +1002,10 @@ bool PatchSelector::populatePatchMenuForCategory(int c, juce::PopupMenu &context
 
     int splitcount = 256;
 
-    // Go through the whole patch list in alphabetical order and filter
-    // out only the patches that belong to the current category.
-    std::vector<int> ctge;
-
-    for (auto p : storage->patchOrdering)
-    {
-        if (storage->patch_list[p].category == c)
-        {
-            ctge.push_back(p);
-        }
-    }
+    // The patches of this category, already in alphabetical order
+    static const std::vector<int> noPatches;
+    const auto &ctge =
+        c < storage->patchesInCategory.size() ? storage->patchesInCategory[c] : noPatches;
 
     // Divide categories with more entries than splitcount into subcategories f.ex. bass (1, 2) etc
     int n_subc = 1 + (std::max(2, (int)ctge.size()) - 1) / splitcount;
@@ -1062,7 +1055,7 @@ bool PatchSelector::populatePatchMenuForCategory(int c, juce::PopupMenu &context
                 if (img && img->getDrawableButUseWithCaution())
                     item.setImage(img->getDrawableButUseWithCaution()->createCopy());
             }
-            subMenu->addItem(item);
+            subMenu->addItem(std::move(item));
             sub++;
 
             if (sub != 0 && sub % 32 == 0)
@@ -1076,21 +1069,12 @@ bool PatchSelector::populatePatchMenuForCategory(int c, juce::PopupMenu &context
             }
         }
 
-        for (auto &childcat : cat.children)
-        {
-            // this isn't the best approach but it works
-            int idx = 0;
-
-            for (auto &cc : storage->patch_category)
-            {
-                if (cc.name == childcat.name && cc.internalid == childcat.internalid)
-                {
-                    break;
-                }
-
-                idx++;
-            }
+        static const std::vector<int> noChildren;
+        const auto &kids =
+            c < storage->childCategoriesOf.size() ? storage->childCategoriesOf[c] : noChildren;
 
+        for (auto idx : kids)
+        {
             bool checkedKid = populatePatchMenuForCategory(idx, *subMenu, false, main_e, false);
 
             if (checkedKid)
@@ -1118,11 +1102,12 @@ bool PatchSelector::populatePatchMenuForCategory(int c, juce::PopupMenu &context
 
         if (!single_category)
         {
+            // moved rather than copied, or every level copies the whole tree below it again
             if (amIChecked)
-                contextMenu.addSubMenu(name, *subMenu, true, nullptr, amIChecked,
+                contextMenu.addSubMenu(name, std::move(*subMenu), true, nullptr, amIChecked,
                                        ID_TO_PRESELECT_MENU_ITEMS);
             else
-                contextMenu.addSubMenu(name, *subMenu, true, nullptr, amIChecked);
+                contextMenu.addSubMenu(name, std::move(*subMenu), true, nullptr, amIChecked);
         }
 
         main_e++;
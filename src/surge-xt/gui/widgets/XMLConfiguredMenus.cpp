@@ -89,6 +89,11 @@ void XMLMenuPopulator::scanXMLPresetForType(TiXmlElement *type,
      * If it has children, then the children are snapshots and are entries in my named path
      */
 
+    int ti = 0;
+    if (storage && strcmp(mtype, "fx") == 0 &&
+        type->QueryIntAttribute("i", &ti) == TIXML_SUCCESS && !storage->isFxTypeAvailable(ti))
+        return;
+
     if (type->NoChildren())
     {
         Item it;
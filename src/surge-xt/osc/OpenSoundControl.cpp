@@ -28,6 +28,7 @@
 #include <string>
 #include "UnitConversions.h"
 #include "Tunings.h"
+#include "fmt/core.h"
 
 namespace Surge
 {
@@ -40,6 +41,9 @@ OpenSoundControl::~OpenSoundControl()
 {
     if (listening)
         stopListening();
+
+    if (outputThread)
+        outputThread->stopThread(1000);
 }
 
 void OpenSoundControl::initOSC(SurgeSynthProcessor *ssp,
@@ -123,6 +127,13 @@ int OpenSoundControl::getNoteID(const juce::OSCMessage &om)
 
 void OpenSoundControl::oscMessageReceived(const juce::OSCMessage &message)
 {
+    // batches come in at high rates, so pick them out before any string splitting
+    if (message.getAddressPattern().toString() == "/param_batch")
+    {
+        receiveParamBatch(message);
+        return;
+    }
+
     std::string addr = message.getAddressPattern().toString().toStdString();
     if (addr.at(0) != '/')
     {
@@ -201,7 +212,7 @@ void OpenSoundControl::oscMessageReceived(const juce::OSCMessage &message)
             noteID = int(frequency * 10000);
 
         // queue packet to audio thread
-        sspPtr->oscRingBuf.push(SurgeSynthProcessor::oscToAudio(
+        sspPtr->queueOSCToAudio(SurgeSynthProcessor::oscToAudio(
             frequency, static_cast<char>(velocity), noteon, noteID));
     }
 
@@ -252,7 +263,7 @@ void OpenSoundControl::oscMessageReceived(const juce::OSCMessage &message)
             noteID = int(note);
 
         // Send packet to audio thread
-        sspPtr->oscRingBuf.push(SurgeSynthProcessor::oscToAudio(
+        sspPtr->queueOSCToAudio(SurgeSynthProcessor::oscToAudio(
             static_cast<char>(note), static_cast<char>(velocity), noteon, noteID));
     }
 
@@ -279,7 +290,7 @@ void OpenSoundControl::oscMessageReceived(const juce::OSCMessage &message)
             return;
         }
 
-        sspPtr->oscRingBuf.push(SurgeSynthProcessor::oscToAudio(p, message[0].getFloat32()));
+        sspPtr->queueOSCToAudio(SurgeSynthProcessor::oscToAudio(p, message[0].getFloat32()));
 
 #ifdef DEBUG_VERBOSE
         std::cout << "Parameter OSC name:" << p->get_osc_name() << "  ";
@@ -420,8 +431,170 @@ void OpenSoundControl::oscMessageReceived(const juce::OSCMessage &message)
     {
         OpenSoundControl::sendAllParams();
     }
+
+    else if (address1 == "snapshot")
+    {
+        OpenSoundControl::sendParamSnapshot();
+    }
+
+    else if (address1 == "stats")
+    {
+        /*
+         * The first query turns the profiler on, so the reply to it is mostly zeros. Since
+         * the profiler is cheap we then just leave it running.
+         */
+        synth->blockProfiler.setEnabled(true);
+        OpenSoundControl::sendStats();
+    }
+
+    // /late_blocks reports, /late_blocks/threshold f sets, /late_blocks/clear forgets
+    else if (address1 == "late_blocks")
+    {
+        auto &dm = synth->deadlineMonitor;
+
+        std::getline(split, address2, '/');
+        if (address2 == "threshold")
+        {
+            if (message.size() != 1)
+            {
+                sendDataCountError("late_blocks/threshold", "1");
+                return;
+            }
+            if (!message[0].isFloat32())
+            {
+                sendNotFloatError("late_blocks/threshold", "threshold");
+                return;
+            }
+            dm.setThreshold(std::max(0.f, message[0].getFloat32()));
+        }
+        else if (address2 == "clear")
+        {
+            dm.clear();
+        }
+        else
+        {
+            // as with /stats, what was slow is only known once the profiler runs
+            synth->blockProfiler.setEnabled(true);
+            OpenSoundControl::sendLateBlocks();
+        }
+    }
+}
+
+/*
+ * /param_batch sets many parameters at once, all at the same block boundary. Parameters are
+ * addressed by index, which is their position in a /send_all_parameters dump, and the values
+ * are the same as for /param/... The pairs come either as alternating (index, value) arguments,
+ * or as a single blob of packed big-endian (int32 index, float32 value) pairs.
+ */
+void OpenSoundControl::receiveParamBatch(const juce::OSCMessage &message)
+{
+    auto *batch = acquireParamBatch();
+    if (!batch)
+        return;
+
+    auto &patch = synth->storage.getPatch();
+    int nParams = patch.param_ptr.size();
+
+    auto add = [&](int index, float value) {
+        if (index < 0 || index >= nParams)
+        {
+            sendError("/param_batch index " + std::to_string(index) + " is out of range (0-" +
+                      std::to_string(nParams - 1) + ").");
+            return;
+        }
+
+        addToParamBatch(batch, patch.param_ptr[index], value);
+    };
+
+    if (message.size() == 1 && message[0].isBlob())
+    {
+        const auto &blob = message[0].getBlob();
+        auto *data = static_cast<const uint8_t *>(blob.getData());
+
+        if (blob.getSize() % 8 != 0)
+        {
+            sendError("/param_batch blob size must be a multiple of 8 bytes.");
+        }
+        else
+        {
+            for (size_t i = 0; i < blob.getSize(); i += 8)
+            {
+                auto index = (int32_t)juce::ByteOrder::bigEndianInt(data + i);
+                auto bits = juce::ByteOrder::bigEndianInt(data + i + 4);
+                float value;
+                memcpy(&value, &bits, sizeof(float));
+
+                add(index, value);
+            }
+        }
+    }
+    else if (message.size() % 2 != 0)
+    {
+        sendDataCountError("param_batch", "pairs of index and value");
+    }
+    else
+    {
+        for (int i = 0; i < message.size(); i += 2)
+        {
+            if ((!message[i].isFloat32() && !message[i].isInt32()) || !message[i + 1].isFloat32())
+            {
+                sendNotFloatError("param_batch", "");
+                continue;
+            }
+
+            auto index = message[i].isInt32() ? message[i].getInt32()
+                                              : static_cast<int>(message[i].getFloat32());
+            add(index, message[i + 1].getFloat32());
+        }
+    }
+
+    submitParamBatch(batch);
+}
+
+ParamBatch *OpenSoundControl::acquireParamBatch()
+{
+    for (auto &b : sspPtr->oscParamBatches)
+    {
+        bool expected = false;
+        if (b.inUse.compare_exchange_strong(expected, true))
+        {
+            b.size = 0;
+            b.overflowed = false;
+            return &b;
+        }
+    }
+
+    sendError("Too many OSC parameter batches waiting for the audio thread; dropped one.");
+    return nullptr;
+}
+
+void OpenSoundControl::addToParamBatch(ParamBatch *batch, Parameter *p, float value)
+{
+    if (batch->size == ParamBatch::maxSize)
+    {
+        if (!batch->overflowed)
+            sendError("An OSC parameter batch holds at most " +
+                      std::to_string(ParamBatch::maxSize) + " values; dropped the rest.");
+        batch->overflowed = true;
+        return;
+    }
+
+    batch->items[batch->size++] = {p, value};
 }
 
+void OpenSoundControl::submitParamBatch(ParamBatch *batch)
+{
+    if (batch->size == 0)
+    {
+        batch->inUse = false;
+        return;
+    }
+
+    if (!sspPtr->queueOSCToAudio(SurgeSynthProcessor::oscToAudio(batch)))
+        batch->inUse = false;
+}
+
+// The /param/... messages in a bundle are applied together, at the same block boundary
 void OpenSoundControl::oscBundleReceived(const juce::OSCBundle &bundle)
 {
     std::string msg;
@@ -430,14 +603,38 @@ void OpenSoundControl::oscBundleReceived(const juce::OSCBundle &bundle)
     std::cout << "OSCListener: Got OSC bundle." << msg << std::endl;
 #endif
 
+    ParamBatch *batch{nullptr};
+
     for (int i = 0; i < bundle.size(); ++i)
     {
         auto elem = bundle[i];
         if (elem.isMessage())
-            oscMessageReceived(elem.getMessage());
+        {
+            const auto &message = elem.getMessage();
+            auto addr = message.getAddressPattern().toString();
+
+            if (addr.startsWith("/param/") && message.size() == 1 && message[0].isFloat32())
+            {
+                if (!batch)
+                    batch = acquireParamBatch();
+
+                auto *p = synth->storage.getPatch().parameterFromOSCName(addr.toStdString());
+
+                if (batch && p)
+                {
+                    addToParamBatch(batch, p, message[0].getFloat32());
+                    continue;
+                }
+            }
+
+            oscMessageReceived(message);
+        }
         else if (elem.isBundle())
             oscBundleReceived(elem.getBundle());
     }
+
+    if (batch)
+        submitParamBatch(batch);
 }
 
 /* ----- OSC Sending  ----- */
@@ -453,6 +650,10 @@ bool OpenSoundControl::initOSCOut(int port)
     oportnum = port;
     synth->storage.oscSending = true;
 
+    if (!outputThread)
+        outputThread = std::make_unique<OutputThread>(*this);
+    outputThread->startThread();
+
 #ifdef DEBUG
     std::cout << "SurgeOSC: Sending OSC on port " << port << "." << std::endl;
 #endif
@@ -466,6 +667,15 @@ void OpenSoundControl::stopSending()
 
     sendingOSC = false;
     synth->storage.oscSending = false;
+
+    if (outputThread)
+        outputThread->stopThread(1000);
+
+    {
+        std::lock_guard<std::mutex> g(pendingMutex);
+        pendingParams.clear();
+        paramIsPending.clear();
+    }
 #ifdef DEBUG
     std::cout << "SurgeOSC: Stopped sending OSC." << std::endl;
 #endif
@@ -483,6 +693,90 @@ void OpenSoundControl::send(std::string addr, std::string msg)
     }
 }
 
+void OpenSoundControl::setOutputInterval(int ms) { outputIntervalMs = std::max(1, ms); }
+
+void OpenSoundControl::queueParamChange(Parameter *p)
+{
+    std::lock_guard<std::mutex> g(pendingMutex);
+
+    if (p->id >= (int)paramIsPending.size())
+        paramIsPending.resize(p->id + 1, false);
+
+    if (!paramIsPending[p->id])
+    {
+        paramIsPending[p->id] = true;
+        pendingParams.push_back(p);
+    }
+}
+
+void OpenSoundControl::OutputThread::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(osc.outputIntervalMs);
+        osc.sendPendingParamChanges();
+
+        if (osc.dumpRequested.exchange(false))
+            osc.sendParamDump();
+
+        if (osc.snapshotRequested.exchange(false))
+            osc.sendParamSnapshotNow();
+    }
+}
+
+std::string OpenSoundControl::formatParamValue(const Parameter *p)
+{
+    switch (p->valtype)
+    {
+    case vt_int:
+        return std::to_string(p->val.i);
+
+    case vt_bool:
+        return std::to_string(p->val.b);
+
+    case vt_float:
+        return float_to_clocalestr(p->val.f);
+
+    default:
+        return "";
+    }
+}
+
+// Runs on the OSC out thread; values are read now, so each parameter goes out at its latest value
+void OpenSoundControl::sendPendingParamChanges()
+{
+    std::vector<Parameter *> params;
+
+    {
+        std::lock_guard<std::mutex> g(pendingMutex);
+
+        if (pendingParams.empty())
+            return;
+
+        params.swap(pendingParams);
+        for (auto *p : params)
+            paramIsPending[p->id] = false;
+    }
+
+    juce::OSCBundle bundle;
+    int inBundle = 0;
+
+    for (auto *p : params)
+    {
+        bundle.addElement(
+            juce::OSCMessage(juce::String(p->oscName), juce::String(formatParamValue(p))));
+
+        if (++inBundle == maxMessagesPerBundle || p == params.back())
+        {
+            if (!juceOSCSender.send(bundle))
+                std::cout << "Error: could not send OSC bundle.";
+
+            bundle = juce::OSCBundle();
+            inBundle = 0;
+        }
+    }
+}
+
 void OpenSoundControl::sendError(std::string errorMsg)
 {
     if (sendingOSC)
@@ -504,45 +798,137 @@ void OpenSoundControl::sendDataCountError(std::string addr, std::string count)
                                 count + ".");
 }
 
-// Loop through all params, send them to OSC Out
+// Send the CPU breakdown of the last blocks to OSC Out, one message per section, and the
+// audio thread queue counters: overflows (GUI MIDI, OSC), carried over calls and worst wait
+void OpenSoundControl::sendStats()
+{
+    if (!sendingOSC)
+        return;
+
+    auto &prof = synth->blockProfiler;
+
+    for (int i = 0; i < Surge::Profiling::n_profile_sections; ++i)
+    {
+        send("/stats/" + Surge::Profiling::BlockProfiler::sectionName(i),
+             float_to_clocalestr(prof.getLoad(i)) + " " + float_to_clocalestr(prof.getPeak(i)));
+    }
+
+    send("/stats/total", float_to_clocalestr(prof.getTotalLoad()));
+
+    auto &qs = sspPtr->queueStats;
+    send("/stats/queues", fmt::format("{} {} {} {}", qs.midiFromGUIOverflows.load(),
+                                      qs.oscOverflows.load(), qs.carriedOverProcessCalls.load(),
+                                      qs.maxWaitProcessCalls.load()));
+}
+
+// Send the count of blocks which ran past the deadline monitor's threshold, then the ones it
+// still remembers, oldest first, one message each
+void OpenSoundControl::sendLateBlocks()
+{
+    if (!sendingOSC)
+        return;
+
+    auto &dm = synth->deadlineMonitor;
+
+    send("/late_blocks/count",
+         fmt::format("{} {}", dm.getMissCount(), float_to_clocalestr(dm.getThreshold())));
+
+    for (const auto &m : dm.getHistory())
+        send("/late_blocks/block", m.describe());
+}
+
+// The dump itself runs on the OSC out thread, a bundle at a time; see sendParamDump
 void OpenSoundControl::sendAllParams()
 {
-    if (sendingOSC)
+    if (sendingOSC && outputThread)
     {
-        // Runs on the juce messenger thread
-        juce::MessageManager::getInstance()->callAsync([this]() {
-            // auto timer = new Surge::Debug::TimeBlock("ParameterDump");
-            std::string valStr;
-            int n = synth->storage.getPatch().param_ptr.size();
-            for (int i = 0; i < n; i++)
-            {
-                Parameter p = *synth->storage.getPatch().param_ptr[i];
-                switch (p.valtype)
-                {
-                case vt_int:
-                    valStr = std::to_string(p.val.i);
-                    break;
+        dumpRequested = true;
+        outputThread->notify();
+    }
+}
 
-                case vt_bool:
-                    valStr = std::to_string(p.val.b);
-                    break;
+void OpenSoundControl::sendParamSnapshot()
+{
+    if (sendingOSC && outputThread)
+    {
+        snapshotRequested = true;
+        outputThread->notify();
+    }
+}
 
-                case vt_float:
-                    valStr = float_to_clocalestr(p.val.f);
-                    break;
+// Runs on the OSC out thread
+void OpenSoundControl::sendParamDump()
+{
+    auto &params = synth->storage.getPatch().param_ptr;
+    int n = params.size();
 
-                default:
-                    break;
-                }
+    for (int start = 0; start < n; start += maxMessagesPerBundle)
+    {
+        juce::OSCBundle bundle;
 
-                if (!this->juceOSCSender.send(
-                        juce::OSCMessage(juce::String(p.oscName), juce::String(valStr))))
-                    std::cout << "Error: could not send OSC message.";
-            }
-            // delete timer;    // This prints the elapsed time
-        });
+        for (int i = start; i < std::min(n, start + maxMessagesPerBundle); ++i)
+        {
+            auto *p = params[i];
+            bundle.addElement(
+                juce::OSCMessage(juce::String(p->oscName), juce::String(formatParamValue(p))));
+        }
+
+        if (!juceOSCSender.send(bundle))
+            std::cout << "Error: could not send OSC bundle.";
+
+        // let changes made meanwhile through, and give up if we are being stopped
+        sendPendingParamChanges();
+
+        if (outputThread->threadShouldExit())
+            return;
     }
 }
 
+/*
+ * Runs on the OSC out thread. The whole patch goes out as one /snapshot message holding a blob
+ * in the /param_batch format, so a snapshot sent back as /param_batch restores every value.
+ */
+void OpenSoundControl::sendParamSnapshotNow()
+{
+    auto &params = synth->storage.getPatch().param_ptr;
+    juce::MemoryBlock blob(params.size() * 8);
+    auto *data = static_cast<uint8_t *>(blob.getData());
+
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        auto *p = params[i];
+        float value;
+
+        switch (p->valtype)
+        {
+        case vt_int:
+            value = p->val.i;
+            break;
+
+        case vt_bool:
+            value = p->val.b ? 1.f : 0.f;
+            break;
+
+        default:
+            value = p->get_value_f01();
+            break;
+        }
+
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(float));
+
+        auto index = juce::ByteOrder::swapIfLittleEndian((uint32_t)i);
+        bits = juce::ByteOrder::swapIfLittleEndian(bits);
+        memcpy(data + i * 8, &index, 4);
+        memcpy(data + i * 8 + 4, &bits, 4);
+    }
+
+    juce::OSCMessage message(juce::OSCAddressPattern("/snapshot"));
+    message.addBlob(blob);
+
+    if (!juceOSCSender.send(message))
+        std::cout << "Error: could not send OSC message.";
+}
+
 } // namespace OSC
 } // namespace Surge
\ No newline at end of file
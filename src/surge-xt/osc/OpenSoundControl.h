@@ -40,6 +40,12 @@
 #include "SurgeSynthesizer.h"
 #include "SurgeStorage.h"
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 class SurgeSynthProcessor;
 
 namespace Surge
@@ -47,6 +53,21 @@ namespace Surge
 namespace OSC
 {
 
+/*
+ * Parameter changes decoded on the OSC thread from a /param_batch message or a bundle, handed to
+ * the audio thread as one entry so they all land at the same block boundary. The audio thread
+ * hands the batch back by clearing inUse once the values are applied.
+ */
+struct ParamBatch
+{
+    static constexpr int maxSize = 1024;
+
+    std::atomic<bool> inUse{false};
+    int size{0};
+    bool overflowed{false};
+    std::array<std::pair<Parameter *, float>, maxSize> items;
+};
+
 class OpenSoundControl : public juce::OSCReceiver,
                          juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
 {
@@ -69,18 +90,55 @@ class OpenSoundControl : public juce::OSCReceiver,
 
     void send(std::string addr, std::string msg);
     void sendAllParams();
+    // the whole patch as one /snapshot message, see sendParamSnapshotNow
+    void sendParamSnapshot();
+    void sendStats();
+    void sendLateBlocks();
     void stopSending();
 
+    /*
+     * Parameter changes bound for OSC out are coalesced per parameter and sent as bundles
+     * from outputThread every output interval, so a sweep costs one message per parameter
+     * per interval and nothing gets formatted on the thread which made the change.
+     */
+    void queueParamChange(Parameter *p);
+    void setOutputInterval(int ms);
+
   private:
     SurgeSynthesizer *synth{nullptr};
     SurgeSynthProcessor *sspPtr{nullptr};
     std::string getWholeString(const juce::OSCMessage &message);
     int getNoteID(const juce::OSCMessage &om);
+    void receiveParamBatch(const juce::OSCMessage &message);
+    ParamBatch *acquireParamBatch();
+    void addToParamBatch(ParamBatch *batch, Parameter *p, float value);
+    void submitParamBatch(ParamBatch *batch);
     juce::OSCSender juceOSCSender;
     void sendError(std::string errorMsg);
     void sendNotFloatError(std::string addr, std::string msg);
     void sendDataCountError(std::string addr, std::string count);
 
+    struct OutputThread : juce::Thread
+    {
+        explicit OutputThread(OpenSoundControl &o) : juce::Thread("Surge XT OSC Out"), osc(o) {}
+        void run() override;
+
+        OpenSoundControl &osc;
+    };
+    std::unique_ptr<OutputThread> outputThread;
+    std::atomic<int> outputIntervalMs{DEFAULT_OSC_OUTPUT_INTERVAL_MS};
+
+    static constexpr int maxMessagesPerBundle = 64;
+    std::mutex pendingMutex;
+    std::vector<Parameter *> pendingParams;
+    std::vector<bool> paramIsPending;
+    void sendPendingParamChanges();
+
+    std::atomic<bool> dumpRequested{false}, snapshotRequested{false};
+    void sendParamDump();
+    void sendParamSnapshotNow();
+    static std::string formatParamValue(const Parameter *p);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OpenSoundControl)
 };
 